@@ -62,6 +62,8 @@ void xbBcd::StringToBcd( const xbString &sIn )
   xbInt16  iBytePos = 0;          // next load position in xbs structure
   xbInt16  iBcdDataPos = 0;       // current position in output structure
   xbByteSplit xbs;                // combiner
+  xbs.c1 = 0x00;                  // an odd digit count leaves c1 unset in the last byte
+  xbs.c2 = 0x00;
 
   ctor();
   xbString sNum( sIn );
@@ -0,0 +1,450 @@
+/* xbbitmap.cpp
+
+XBase64 Software Library
+
+Copyright (c) 1997,2003,2014,2022,2023,2024 Gary A Kunkel
+
+The xb64 software library is covered under the terms of the GPL Version 3, 2007 license.
+
+Email Contact:
+
+    XDB-devel@lists.sourceforge.net
+    XDB-users@lists.sourceforge.net
+
+   Compressed bitmap class, used for holding the record numbers that match a filter
+
+*/
+
+#include "xbase.h"
+
+#ifdef XB_FILTER_SUPPORT
+
+namespace xb{
+
+// an array chunk holding more than this many values is larger than a bit set chunk
+static const xbUInt32 xbBitmapArrayMax = 4096;
+
+// number of 32 bit words in a bit set chunk
+static const xbUInt32 xbBitmapWordCnt  = 2048;
+
+/***********************************************************************/
+//! @brief Constructor.
+xbBitmap::xbBitmap(){
+  cpChunks    = NULL;
+  ulChunkCnt  = 0;
+  ulChunkSize = 0;
+  ulCount     = 0;
+}
+/***********************************************************************/
+//! @brief Destructor.
+xbBitmap::~xbBitmap(){
+  Clear();
+  if( cpChunks )
+    free( cpChunks );
+}
+/***********************************************************************/
+//! @brief Remove all values from the set.
+/*!
+  @returns void
+*/
+void xbBitmap::Clear(){
+  for( xbUInt32 i = 0; i < ulChunkCnt; i++ )
+    FreeChunk( cpChunks[i] );
+  ulChunkCnt = 0;
+  ulCount    = 0;
+}
+/***********************************************************************/
+//! @brief Determine if a value is in the set.
+/*!
+  @param ulVal Value to check.
+  @returns xbTrue - Value is in the set.<br>
+           xbFalse - Value is not in the set.
+*/
+xbBool xbBitmap::Contains( xbUInt32 ulVal ) const {
+
+  xbBool   bFound;
+  xbUInt32 ulPos = FindChunk( (xbUInt16) (ulVal >> 16), bFound );
+  if( !bFound )
+    return xbFalse;
+
+  const xbBitmapChunk &c = cpChunks[ulPos];
+  xbUInt32 ulLo = ulVal & 0xFFFF;
+  if( c.ulpBits )
+    return ( c.ulpBits[ulLo >> 5] & ( (xbUInt32) 1 << ( ulLo & 0x1F ))) ? xbTrue : xbFalse;
+
+  xbInt32 lVal = GetNextInChunk( c, ulLo );
+  return ( lVal == (xbInt32) ulLo ) ? xbTrue : xbFalse;
+}
+/***********************************************************************/
+//! @brief Find a chunk.
+/*!
+  @private
+  @param uiKey High sixteen bits of the value.
+  @param bFound Output - xbTrue if the chunk exists.
+  @returns Position of the chunk, or the position it would be inserted at if it doesn't exist.
+*/
+xbUInt32 xbBitmap::FindChunk( xbUInt16 uiKey, xbBool &bFound ) const {
+
+  xbUInt32 ulLo = 0;
+  xbUInt32 ulHi = ulChunkCnt;
+  xbUInt32 ulMid;
+  while( ulLo < ulHi ){
+    ulMid = ulLo + (( ulHi - ulLo ) >> 1 );
+    if( cpChunks[ulMid].uiKey < uiKey )
+      ulLo = ulMid + 1;
+    else
+      ulHi = ulMid;
+  }
+  bFound = ( ulLo < ulChunkCnt && cpChunks[ulLo].uiKey == uiKey ) ? xbTrue : xbFalse;
+  return ulLo;
+}
+/***********************************************************************/
+//! @brief Free the storage for a chunk.
+/*!
+  @private
+  @param c Chunk to free.
+  @returns void
+*/
+void xbBitmap::FreeChunk( xbBitmapChunk &c ){
+  if( c.uipArray )
+    free( c.uipArray );
+  if( c.ulpBits )
+    free( c.ulpBits );
+  c.uipArray = NULL;
+  c.ulpBits  = NULL;
+  c.ulSize   = 0;
+  c.ulCnt    = 0;
+}
+/***********************************************************************/
+//! @brief Get the number of values in the set.
+/*!
+  @returns Value count.
+*/
+xbUInt32 xbBitmap::GetCount() const {
+  return ulCount;
+}
+/***********************************************************************/
+//! @brief Get the memory used by the set.
+/*!
+  @returns Number of bytes allocated for the chunks.
+*/
+xbUInt32 xbBitmap::GetMemSize() const {
+
+  xbUInt32 ulSize = ulChunkSize * (xbUInt32) sizeof( xbBitmapChunk );
+  for( xbUInt32 i = 0; i < ulChunkCnt; i++ ){
+    if( cpChunks[i].ulpBits )
+      ulSize += xbBitmapWordCnt * (xbUInt32) sizeof( xbUInt32 );
+    else
+      ulSize += cpChunks[i].ulSize * (xbUInt32) sizeof( xbUInt16 );
+  }
+  return ulSize;
+}
+/***********************************************************************/
+//! @brief Get the first value in the set at or after a given value.
+/*!
+  @param ulFrom Value to start searching from.
+  @param ulVal Output - Value found.
+  @returns XB_NO_ERROR - Value found.<br>
+           XB_NOT_FOUND - No more values in the set.
+*/
+xbInt16 xbBitmap::GetNext( xbUInt32 ulFrom, xbUInt32 &ulVal ) const {
+
+  xbBool   bFound;
+  xbUInt16 uiKey = (xbUInt16) (ulFrom >> 16);
+  xbInt32  lVal;
+  for( xbUInt32 i = FindChunk( uiKey, bFound ); i < ulChunkCnt; i++ ){
+    lVal = GetNextInChunk( cpChunks[i], ( cpChunks[i].uiKey == uiKey ) ? ulFrom & 0xFFFF : 0 );
+    if( lVal >= 0 ){
+      ulVal = ((xbUInt32) cpChunks[i].uiKey << 16) | (xbUInt32) lVal;
+      return XB_NO_ERROR;
+    }
+  }
+  return XB_NOT_FOUND;
+}
+/***********************************************************************/
+//! @brief Get the first value in a chunk at or after a given low value.
+/*!
+  @private
+  @param c Chunk to search.
+  @param ulLo Low sixteen bits to start searching from.
+  @returns Low sixteen bits of the value found, or -1 if none.
+*/
+xbInt32 xbBitmap::GetNextInChunk( const xbBitmapChunk &c, xbUInt32 ulLo ) const {
+
+  if( c.ulpBits ){
+    xbUInt32 ulWord = ulLo >> 5;
+    xbUInt32 ulBits = c.ulpBits[ulWord] & ( 0xFFFFFFFF << ( ulLo & 0x1F ));
+    while( ulBits == 0 ){
+      if( ++ulWord >= xbBitmapWordCnt )
+        return -1;
+      ulBits = c.ulpBits[ulWord];
+    }
+    xbInt32 lBit = 0;
+    while( !( ulBits & 0x01 )){
+      ulBits >>= 1;
+      lBit++;
+    }
+    return (xbInt32) ( ulWord << 5 ) + lBit;
+  }
+
+  // first array entry >= ulLo
+  xbUInt32 ulFirst = 0;
+  xbUInt32 ulLast  = c.ulCnt;
+  xbUInt32 ulMid;
+  while( ulFirst < ulLast ){
+    ulMid = ulFirst + (( ulLast - ulFirst ) >> 1 );
+    if( c.uipArray[ulMid] < ulLo )
+      ulFirst = ulMid + 1;
+    else
+      ulLast = ulMid;
+  }
+  return ( ulFirst < c.ulCnt ) ? (xbInt32) c.uipArray[ulFirst] : -1;
+}
+/***********************************************************************/
+//! @brief Get the last value in the set at or before a given value.
+/*!
+  @param ulFrom Value to start searching from.
+  @param ulVal Output - Value found.
+  @returns XB_NO_ERROR - Value found.<br>
+           XB_NOT_FOUND - No more values in the set.
+*/
+xbInt16 xbBitmap::GetPrev( xbUInt32 ulFrom, xbUInt32 &ulVal ) const {
+
+  xbBool   bFound;
+  xbUInt16 uiKey = (xbUInt16) (ulFrom >> 16);
+  xbInt32  lPos  = (xbInt32) FindChunk( uiKey, bFound );
+  xbInt32  lVal;
+  if( !bFound )
+    lPos--;
+  for( ; lPos >= 0; lPos-- ){
+    lVal = GetPrevInChunk( cpChunks[lPos], ( cpChunks[lPos].uiKey == uiKey ) ? ulFrom & 0xFFFF : 0xFFFF );
+    if( lVal >= 0 ){
+      ulVal = ((xbUInt32) cpChunks[lPos].uiKey << 16) | (xbUInt32) lVal;
+      return XB_NO_ERROR;
+    }
+  }
+  return XB_NOT_FOUND;
+}
+/***********************************************************************/
+//! @brief Get the last value in a chunk at or before a given low value.
+/*!
+  @private
+  @param c Chunk to search.
+  @param ulHi Low sixteen bits to start searching from.
+  @returns Low sixteen bits of the value found, or -1 if none.
+*/
+xbInt32 xbBitmap::GetPrevInChunk( const xbBitmapChunk &c, xbUInt32 ulHi ) const {
+
+  if( c.ulpBits ){
+    xbUInt32 ulWord = ulHi >> 5;
+    xbUInt32 ulBits = c.ulpBits[ulWord];
+    if(( ulHi & 0x1F ) != 0x1F )
+      ulBits &= ( (xbUInt32) 1 << (( ulHi & 0x1F ) + 1 )) - 1;
+    while( ulBits == 0 ){
+      if( ulWord == 0 )
+        return -1;
+      ulBits = c.ulpBits[--ulWord];
+    }
+    xbInt32 lBit = 31;
+    while( !( ulBits & 0x80000000 )){
+      ulBits <<= 1;
+      lBit--;
+    }
+    return (xbInt32) ( ulWord << 5 ) + lBit;
+  }
+
+  // first array entry > ulHi, then step back one
+  xbUInt32 ulFirst = 0;
+  xbUInt32 ulLast  = c.ulCnt;
+  xbUInt32 ulMid;
+  while( ulFirst < ulLast ){
+    ulMid = ulFirst + (( ulLast - ulFirst ) >> 1 );
+    if( c.uipArray[ulMid] <= ulHi )
+      ulFirst = ulMid + 1;
+    else
+      ulLast = ulMid;
+  }
+  return ( ulFirst > 0 ) ? (xbInt32) c.uipArray[ulFirst-1] : -1;
+}
+/***********************************************************************/
+//! @brief Remove a value from the set.
+/*!
+  Removing a value that is not in the set is not an error.
+  @param ulVal Value to remove.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbBitmap::Remove( xbUInt32 ulVal ){
+
+  xbBool   bFound;
+  xbUInt32 ulPos = FindChunk( (xbUInt16) (ulVal >> 16), bFound );
+  if( !bFound )
+    return XB_NO_ERROR;
+
+  xbBitmapChunk &c = cpChunks[ulPos];
+  xbUInt32 ulLo = ulVal & 0xFFFF;
+  if( c.ulpBits ){
+    xbUInt32 ulBit = (xbUInt32) 1 << ( ulLo & 0x1F );
+    if( !( c.ulpBits[ulLo >> 5] & ulBit ))
+      return XB_NO_ERROR;
+    c.ulpBits[ulLo >> 5] &= ~ulBit;
+    c.ulCnt--;
+    ulCount--;
+    if( c.ulCnt <= xbBitmapArrayMax )
+      return ToArray( c );
+    return XB_NO_ERROR;
+  }
+
+  if( GetNextInChunk( c, ulLo ) != (xbInt32) ulLo )
+    return XB_NO_ERROR;
+  xbUInt32 i = 0;
+  while( c.uipArray[i] != ulLo )
+    i++;
+  memmove( &c.uipArray[i], &c.uipArray[i+1], ( c.ulCnt - i - 1 ) * sizeof( xbUInt16 ));
+  c.ulCnt--;
+  ulCount--;
+
+  if( c.ulCnt == 0 ){
+    FreeChunk( c );
+    memmove( &cpChunks[ulPos], &cpChunks[ulPos+1], ( ulChunkCnt - ulPos - 1 ) * sizeof( xbBitmapChunk ));
+    ulChunkCnt--;
+  }
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Add a value to the set.
+/*!
+  Adding a value that is already in the set is not an error.
+  @param ulVal Value to add.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbBitmap::Set( xbUInt32 ulVal ){
+
+  xbInt16  iRc;
+  xbBool   bFound;
+  xbUInt16 uiKey = (xbUInt16) (ulVal >> 16);
+  xbUInt32 ulPos = FindChunk( uiKey, bFound );
+
+  if( !bFound ){
+    if( ulChunkCnt >= ulChunkSize ){
+      xbUInt32 ulNewSize = ulChunkSize ? ulChunkSize * 2 : 4;
+      xbBitmapChunk *cpNew = (xbBitmapChunk *) realloc( cpChunks, ulNewSize * sizeof( xbBitmapChunk ));
+      if( !cpNew )
+        return XB_NO_MEMORY;
+      cpChunks    = cpNew;
+      ulChunkSize = ulNewSize;
+    }
+    memmove( &cpChunks[ulPos+1], &cpChunks[ulPos], ( ulChunkCnt - ulPos ) * sizeof( xbBitmapChunk ));
+    ulChunkCnt++;
+    cpChunks[ulPos].uiKey    = uiKey;
+    cpChunks[ulPos].ulCnt    = 0;
+    cpChunks[ulPos].ulSize   = 0;
+    cpChunks[ulPos].uipArray = NULL;
+    cpChunks[ulPos].ulpBits  = NULL;
+  }
+
+  xbBitmapChunk &c = cpChunks[ulPos];
+  xbUInt32 ulLo = ulVal & 0xFFFF;
+
+  if( !c.ulpBits ){
+    // first array entry >= ulLo
+    xbUInt32 ulFirst = 0;
+    xbUInt32 ulLast  = c.ulCnt;
+    xbUInt32 ulMid;
+    while( ulFirst < ulLast ){
+      ulMid = ulFirst + (( ulLast - ulFirst ) >> 1 );
+      if( c.uipArray[ulMid] < ulLo )
+        ulFirst = ulMid + 1;
+      else
+        ulLast = ulMid;
+    }
+    if( ulFirst < c.ulCnt && c.uipArray[ulFirst] == ulLo )
+      return XB_NO_ERROR;
+
+    if( c.ulCnt < xbBitmapArrayMax ){
+      if( c.ulCnt >= c.ulSize ){
+        xbUInt32 ulNewSize = c.ulSize ? c.ulSize * 2 : 8;
+        if( ulNewSize > xbBitmapArrayMax )
+          ulNewSize = xbBitmapArrayMax;
+        xbUInt16 *uipNew = (xbUInt16 *) realloc( c.uipArray, ulNewSize * sizeof( xbUInt16 ));
+        if( !uipNew ){
+          if( c.ulCnt == 0 ){
+            memmove( &cpChunks[ulPos], &cpChunks[ulPos+1], ( ulChunkCnt - ulPos - 1 ) * sizeof( xbBitmapChunk ));
+            ulChunkCnt--;
+          }
+          return XB_NO_MEMORY;
+        }
+        c.uipArray = uipNew;
+        c.ulSize   = ulNewSize;
+      }
+      memmove( &c.uipArray[ulFirst+1], &c.uipArray[ulFirst], ( c.ulCnt - ulFirst ) * sizeof( xbUInt16 ));
+      c.uipArray[ulFirst] = (xbUInt16) ulLo;
+      c.ulCnt++;
+      ulCount++;
+      return XB_NO_ERROR;
+    }
+
+    // array is full, switch the chunk to a bit set
+    if(( iRc = ToBits( c )) != XB_NO_ERROR )
+      return iRc;
+  }
+
+  xbUInt32 ulBit = (xbUInt32) 1 << ( ulLo & 0x1F );
+  if( !( c.ulpBits[ulLo >> 5] & ulBit )){
+    c.ulpBits[ulLo >> 5] |= ulBit;
+    c.ulCnt++;
+    ulCount++;
+  }
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Convert a bit set chunk to an array chunk.
+/*!
+  @private
+  @param c Chunk to convert.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbBitmap::ToArray( xbBitmapChunk &c ){
+
+  xbUInt16 *uipNew = (xbUInt16 *) malloc( xbBitmapArrayMax * sizeof( xbUInt16 ));
+  if( !uipNew )
+    return XB_NO_MEMORY;
+
+  xbUInt32 ulCnt = 0;
+  xbUInt32 ulBits;
+  for( xbUInt32 ulWord = 0; ulWord < xbBitmapWordCnt; ulWord++ ){
+    ulBits = c.ulpBits[ulWord];
+    for( xbUInt32 ulBit = 0; ulBits; ulBit++, ulBits >>= 1 )
+      if( ulBits & 0x01 )
+        uipNew[ulCnt++] = (xbUInt16) (( ulWord << 5 ) + ulBit );
+  }
+  free( c.ulpBits );
+  c.ulpBits  = NULL;
+  c.uipArray = uipNew;
+  c.ulSize   = xbBitmapArrayMax;
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Convert an array chunk to a bit set chunk.
+/*!
+  @private
+  @param c Chunk to convert.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbBitmap::ToBits( xbBitmapChunk &c ){
+
+  xbUInt32 *ulpNew = (xbUInt32 *) calloc( xbBitmapWordCnt, sizeof( xbUInt32 ));
+  if( !ulpNew )
+    return XB_NO_MEMORY;
+
+  for( xbUInt32 i = 0; i < c.ulCnt; i++ )
+    ulpNew[c.uipArray[i] >> 5] |= (xbUInt32) 1 << ( c.uipArray[i] & 0x1F );
+  if( c.uipArray )
+    free( c.uipArray );
+  c.uipArray = NULL;
+  c.ulSize   = 0;
+  c.ulpBits  = ulpNew;
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+}              /* namespace       */
+#endif         /*  XB_FILTER_SUPPORT */
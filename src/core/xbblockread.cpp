@@ -93,6 +93,10 @@ xbInt16 xbBlockRead::Init(xbUInt32 ulBlockSize ){
   return iRc;
 }
 /************************************************************************/
+const char *xbBlockRead::GetBlockBuf() const{
+  return pBlock;
+}
+/************************************************************************/
 xbUInt32 xbBlockRead::GetBlockFirstRecNo() const{
   return ulFirstBlkRec;
 }
@@ -135,6 +139,12 @@ xbInt16  xbBlockRead::GetRecord( xbUInt32 ulRecNo ){
   return iRc;
 }
 /************************************************************************/
+xbInt16  xbBlockRead::LoadBlockForRecNo( xbUInt32 ulRecNo ){
+  if( ulRecNo >= ulFirstBlkRec && ulRecNo < (ulFirstBlkRec + ulRecCnt))
+    return XB_NO_ERROR;
+  return GetBlockForRecNo( ulRecNo );
+}
+/************************************************************************/
 void xbBlockRead::SetBlockSize( xbUInt32 ulBlkSize ){
   this->ulBlkSize = ulBlkSize;
 }
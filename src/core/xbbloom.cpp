@@ -0,0 +1,272 @@
+/* xbbloom.cpp
+
+XBase64 Software Library
+
+Copyright (c) 1997,2003,2014,2022,2023,2024 Gary A Kunkel
+
+The xb64 software library is covered under the terms of the GPL Version 3, 2007 license.
+
+Email Contact:
+
+    XDB-devel@lists.sourceforge.net
+    XDB-users@lists.sourceforge.net
+
+   Bloom filter class, used for negative key lookups on unique index tags
+
+*/
+
+#include "xbase.h"
+
+#ifdef XB_INDEX_SUPPORT
+
+namespace xb{
+
+/***********************************************************************/
+//! @brief Constructor.
+xbBloomFilter::xbBloomFilter(){
+  cpBits    = NULL;
+  ulBitCnt  = 0;
+  ulKeyCnt  = 0;
+  iHashCnt  = 7;
+  cSerialNo = 0;
+  bValid    = xbFalse;
+}
+/***********************************************************************/
+//! @brief Destructor.
+xbBloomFilter::~xbBloomFilter(){
+  if( cpBits )
+    free( cpBits );
+}
+/***********************************************************************/
+//! @brief Add a key to the filter.
+/*!
+  @param vpKey Pointer to key.
+  @param lKeyLen Length of key.
+  @returns void
+*/
+void xbBloomFilter::Add( const void *vpKey, size_t lKeyLen ){
+
+  if( !cpBits )
+    return;
+  xbUInt64 ullHash = Hash( vpKey, lKeyLen );
+  xbUInt32 ulH1    = (xbUInt32) ullHash;
+  xbUInt32 ulH2    = (xbUInt32) (ullHash >> 32) | 0x01;
+  xbUInt32 ulMask  = ulBitCnt - 1;
+  xbUInt32 ulBit;
+  for( xbInt16 i = 0; i < iHashCnt; i++ ){
+    ulBit = (ulH1 + (xbUInt32) i * ulH2) & ulMask;
+    cpBits[ulBit >> 3] |= (unsigned char) (1 << (ulBit & 0x07));
+  }
+  ulKeyCnt++;
+}
+/***********************************************************************/
+//! @brief Clear all keys from the filter.
+/*!
+  @returns void
+*/
+void xbBloomFilter::Clear(){
+  if( cpBits )
+    memset( cpBits, 0x00, ulBitCnt / 8 );
+  ulKeyCnt = 0;
+}
+/***********************************************************************/
+//! @brief Get the number of keys the filter is sized for.
+/*!
+  @returns Key capacity.
+*/
+xbUInt32 xbBloomFilter::GetCapacity() const {
+  return ulBitCnt / 10;
+}
+/***********************************************************************/
+//! @brief Get the number of keys added to the filter.
+/*!
+  @returns Key count.
+*/
+xbUInt32 xbBloomFilter::GetKeyCnt() const {
+  return ulKeyCnt;
+}
+/***********************************************************************/
+//! @brief Get the serial number stamp.
+/*!
+  @returns Serial number of the tag the filter was last synchronized with.
+*/
+char xbBloomFilter::GetSerialNo() const {
+  return cSerialNo;
+}
+/***********************************************************************/
+//! @brief Get the valid switch.
+/*!
+  @returns xbTrue - Filter is in sync with the index.<br>
+           xbFalse - Filter is out of sync and can't be used.
+*/
+xbBool xbBloomFilter::GetValid() const {
+  return bValid;
+}
+/***********************************************************************/
+//! @brief Hash a key.
+/*!
+  64 bit FNV-1a hash, the two halves are used for double hashing.
+  @param vpKey Pointer to key.
+  @param lKeyLen Length of key.
+  @returns Hash value.
+*/
+xbUInt64 xbBloomFilter::Hash( const void *vpKey, size_t lKeyLen ) const {
+
+  const unsigned char *p = (const unsigned char *) vpKey;
+  xbUInt64 ullHash = 14695981039346656037ULL;
+  for( size_t i = 0; i < lKeyLen; i++ ){
+    ullHash ^= p[i];
+    ullHash *= 1099511628211ULL;
+  }
+  return ullHash;
+}
+/***********************************************************************/
+//! @brief Initialize the filter.
+/*!
+  Allocate and clear the bit array, sized for the expected key count.
+  @param ulExpectedKeyCnt Number of keys expected to be added to the filter.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbBloomFilter::Init( xbUInt32 ulExpectedKeyCnt ){
+
+  if( ulExpectedKeyCnt < 100 )
+    ulExpectedKeyCnt = 100;
+
+  // round up to a power of two so the bit position can be masked instead of divided
+  xbUInt32 ulNewBitCnt = 1024;
+  while( ulNewBitCnt / 10 < ulExpectedKeyCnt && ulNewBitCnt < 0x80000000 )
+    ulNewBitCnt <<= 1;
+
+  if( ulNewBitCnt != ulBitCnt || !cpBits ){
+    if( cpBits )
+      free( cpBits );
+    if(( cpBits = (unsigned char *) malloc( ulNewBitCnt / 8 )) == NULL ){
+      ulBitCnt = 0;
+      bValid = xbFalse;
+      return XB_NO_MEMORY;
+    }
+    ulBitCnt = ulNewBitCnt;
+  }
+  Clear();
+  bValid = xbTrue;
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Determine if the filter has reached capacity.
+/*!
+  @returns xbTrue - More keys have been added than the filter was sized for.<br>
+           xbFalse - Filter has room.
+*/
+xbBool xbBloomFilter::IsFull() const {
+  return ulKeyCnt > GetCapacity();
+}
+/***********************************************************************/
+//! @brief Determine if a key may be in the filter.
+/*!
+  @param vpKey Pointer to key.
+  @param lKeyLen Length of key.
+  @returns xbTrue - Key may be present, or the filter is not valid.<br>
+           xbFalse - Key is definitely not present.
+*/
+xbBool xbBloomFilter::MayContain( const void *vpKey, size_t lKeyLen ) const {
+
+  if( !bValid || !cpBits )
+    return xbTrue;
+  xbUInt64 ullHash = Hash( vpKey, lKeyLen );
+  xbUInt32 ulH1    = (xbUInt32) ullHash;
+  xbUInt32 ulH2    = (xbUInt32) (ullHash >> 32) | 0x01;
+  xbUInt32 ulMask  = ulBitCnt - 1;
+  xbUInt32 ulBit;
+  for( xbInt16 i = 0; i < iHashCnt; i++ ){
+    ulBit = (ulH1 + (xbUInt32) i * ulH2) & ulMask;
+    if( !(cpBits[ulBit >> 3] & (1 << (ulBit & 0x07))))
+      return xbFalse;
+  }
+  return xbTrue;
+}
+/***********************************************************************/
+//! @brief Read the filter from a file.
+/*!
+  Read the filter from the current position of an open file, in the format written by Write().
+  The serial number and valid switch are managed by the caller, the filter is left invalid.
+  @param f Open file positioned at the start of the filter.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbBloomFilter::Read( xbFile *f ){
+
+  xbInt16 iRc;
+  char    cBuf[10];
+
+  bValid = xbFalse;
+  if(( iRc = f->xbFread( cBuf, 10, 1 )) != XB_NO_ERROR )
+    return iRc;
+
+  xbUInt32 ulNewBitCnt = f->eGetUInt32( cBuf );
+  xbInt16  iNewHashCnt = f->eGetInt16( &cBuf[4] );
+  xbUInt32 ulNewKeyCnt = f->eGetUInt32( &cBuf[6] );
+
+  // bit count must be a power of two
+  if( ulNewBitCnt < 1024 || (ulNewBitCnt & (ulNewBitCnt - 1)) || iNewHashCnt < 1 || iNewHashCnt > 32 )
+    return XB_INVALID_DATA;
+
+  if( ulNewBitCnt != ulBitCnt || !cpBits ){
+    if( cpBits )
+      free( cpBits );
+    if(( cpBits = (unsigned char *) malloc( ulNewBitCnt / 8 )) == NULL ){
+      ulBitCnt = 0;
+      return XB_NO_MEMORY;
+    }
+    ulBitCnt = ulNewBitCnt;
+  }
+  if(( iRc = f->xbFread( cpBits, ulBitCnt / 8, 1 )) != XB_NO_ERROR )
+    return iRc;
+
+  iHashCnt = iNewHashCnt;
+  ulKeyCnt = ulNewKeyCnt;
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Set the serial number stamp.
+/*!
+  @param cSerialNo Serial number of the tag the filter is in sync with.
+  @returns void
+*/
+void xbBloomFilter::SetSerialNo( char cSerialNo ){
+  this->cSerialNo = cSerialNo;
+}
+/***********************************************************************/
+//! @brief Set the valid switch.
+/*!
+  @param bValid xbTrue - Filter is in sync with the index.<br>
+                xbFalse - Filter is out of sync and must not be used.
+  @returns void
+*/
+void xbBloomFilter::SetValid( xbBool bValid ){
+  this->bValid = bValid;
+}
+/***********************************************************************/
+//! @brief Write the filter to a file.
+/*!
+  Write the filter at the current position of an open file.<br>
+  Format: 4 byte bit count, 2 byte hash count, 4 byte key count, followed by the bit array.
+  @param f Open file positioned where the filter is to be written.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbBloomFilter::Write( xbFile *f ) const {
+
+  xbInt16 iRc;
+  char    cBuf[10];
+
+  if( !cpBits )
+    return XB_INVALID_OBJECT;
+
+  f->ePutUInt32( cBuf, ulBitCnt );
+  f->ePutInt16( &cBuf[4], iHashCnt );
+  f->ePutUInt32( &cBuf[6], ulKeyCnt );
+  if(( iRc = f->xbFwrite( cBuf, 10, 1 )) != XB_NO_ERROR )
+    return iRc;
+  return f->xbFwrite( cpBits, ulBitCnt / 8, 1 );
+}
+/***********************************************************************/
+}              /* namespace       */
+#endif         /*  XB_INDEX_SUPPORT */
@@ -58,6 +58,14 @@ xbInt16  xbCore::iCreateMdxBlockSize     = 1024;   // 1024 is dBASE 7 default si
 xbInt16  xbCore::iDefaultIxTagMode       = XB_IX_DBASE_MODE;
 #endif  // defined (XB_NDX_SUPPORT) || defined (XB_MDX_SUPPORT)
 
+#ifdef XB_TDX_SUPPORT
+xbUInt32 xbCore::ulTdxMemLimit           = 16777216;   // 16MB
+#endif  // XB_TDX_SUPPORT
+
+#ifdef XB_SORT_SUPPORT
+xbUInt32 xbCore::ulSortMemLimit          = 16777216;   // 16MB
+#endif  // XB_SORT_SUPPORT
+
 /*************************************************************************/
 //! @brief Class Constructor.
 //xbCore::xbCore(){}
@@ -394,6 +394,27 @@ xbInt32 xbDate::JulianDays() const{
    }
 }
 /*************************************************************************/
+xbInt32 xbDate::JulianDays( const char *cpDate8 ) const{
+
+   // same checks as DateIsValid(), without building a string
+   for( xbInt16 i = 0; i < 8; i++ )
+     if( !isdigit( (unsigned char) cpDate8[i] ))
+       return 0;
+   xbInt32 lYear  = (cpDate8[0]-'0') * 1000 + (cpDate8[1]-'0') * 100 + (cpDate8[2]-'0') * 10 + (cpDate8[3]-'0');
+   xbInt16 iMonth = (xbInt16) ((cpDate8[4]-'0') * 10 + (cpDate8[5]-'0'));
+   xbInt16 iDay   = (xbInt16) ((cpDate8[6]-'0') * 10 + (cpDate8[7]-'0'));
+   if( lYear < 1 || iMonth < 1 || iMonth > 12 || iDay < 1 )
+     return 0;
+   xbInt16 iLeap = IsLeapYear( (xbInt16) lYear ) ? 1 : 0;
+   if( iDay > iDaysInMonths[iLeap][iMonth] )
+     return 0;
+
+   xbInt32 ly = lYear - 1;
+   xbInt32 lDays = ly * 365L + ly / 4L - ly / 100L + ly / 400L;
+   lDays += iAggregatedDaysInMonths[iLeap][iMonth-1] + iDay;
+   return lDays + JUL_OFFSET;
+}
+/*************************************************************************/
 void xbDate::JulToDate8( xbInt32 lJulDays ){
   lJulDays -= JUL_OFFSET;
   // calculate the year
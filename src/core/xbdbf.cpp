@@ -24,6 +24,7 @@ xbDbf::xbDbf( xbXBase * x ) : xbFile( x ){
   SchemaPtr         = NULL;
   RecBuf            = NULL;
   RecBuf2           = NULL;
+  ulChangeSeq       = 0;
 
   #ifdef XB_BLOCKREAD_SUPPORT
   pRb               = NULL;
@@ -52,6 +53,7 @@ void xbDbf::InitVars()
   iFileVersion     = 0;            /* Xbase64 file version */
   iAutoCommit      = -1;
   iMultiUser       = xbSysDflt;
+  ResetChangeLog();
 
   SetFileName  ( "" );
   sAlias.Set   ( "" ); 
@@ -342,8 +344,10 @@ xbInt16 xbDbf::AppendRecord(){
     }
   }
 
-  if( iRc == XB_NO_ERROR )
+  if( iRc == XB_NO_ERROR ){
     iDbfStatus = XB_OPEN;
+    LogRecChange( ulCurRec );
+  }
   return iRc;
 }
 /************************************************************************/
@@ -668,6 +672,11 @@ xbInt16 xbDbf::Close(){
     }
     #endif
 
+    // parsed expressions kept by xbXBase point at this table and its fields
+    #ifdef XB_EXPRESSION_SUPPORT
+    xbase->ClearExpressionCache( this );
+    #endif
+
     // close any open index files, remove from the ix list
     #ifdef XB_INDEX_SUPPORT
     while( ixList ){
@@ -1005,6 +1014,56 @@ xbInt16  xbDbf::CreateTag( const xbString &sIxType, const xbString &sName, const
       }
     #endif
 
+    #ifdef XB_HSH_SUPPORT
+    } else if( sIxType == "HSH" ){
+
+      xbIxHsh *ixHsh;
+      xbString s;
+      //  look through the index list and see if there is a hash index pointer we can grab
+      xbBool bHshFound = xbFalse;
+      xbIxList *ixList = GetIxList();
+      while( ixList && !bHshFound ){
+        s = ixList->sFmt->Str();
+        if( s == "HSH" ){
+          ixHsh = (xbIxHsh *) ixList->ix;
+          bHshFound = xbTrue;
+        }
+        ixList = ixList->next;
+      }
+      if( !bHshFound )
+        ixHsh = new xbIxHsh( this );
+
+      if(( iRc = ixHsh->CreateTag( sName, sKey, sFilter, iDescending, iUnique, iOverLay, vpTagOut )) != XB_NO_ERROR ){
+        if( !bHshFound )
+          delete ixHsh;
+        iErrorStop = 150;
+        throw iRc;
+      }
+      if( !bHshFound ){
+        if(( iRc = AddIndex( ixHsh, "HSH" )) != XB_NO_ERROR ){
+          iErrorStop = 160;
+          throw iRc;
+        }
+      }
+      *pIxOut = ixHsh;
+
+      // hash tags are memory resident, load the new tag from the table
+      // on failure, Reindex deletes the tag
+      if(( iRc = Reindex( 2, pIxOut, vpTagOut )) != XB_NO_ERROR ){
+        *pIxOut = NULL;
+        *vpTagOut = NULL;
+        iErrorStop = 170;
+        throw iRc;
+      }
+
+      // set the current tag if one not already set
+      if( sCurIxType == "" ){
+        sCurIxType = "HSH";
+        pCurIx = ixHsh;
+        vpCurIxTag = ixHsh->GetTag(0);
+      }
+    #endif
+
     } else {
       iErrorStop = 200;
       iRc = XB_INVALID_OPTION;
@@ -1121,13 +1180,15 @@ xbInt16 xbDbf::DeleteAllIndexFiles(){
       // next two lines for debugging
       ixList->ix->GetFileNamePart( sIxName );
       ixList->ix->Close();
-      if(( iRc = ixList->ix->xbRemove()) != XB_NO_ERROR ){
-        iErrorStop = 110;
-        throw iRc;
+      if( *ixList->sFmt != "HSH" ){                             // memory resident, no file to remove
+        if(( iRc = ixList->ix->xbRemove()) != XB_NO_ERROR ){
+          iErrorStop = 110;
+          throw iRc;
+        }
       }
       #ifdef XB_INF_SUPPORT
       // if XB_INF_SUPPORT is enabled, all open non prod indices should be in here
-      if( *ixList->sFmt != "MDX" && *ixList->sFmt != "TDX" ){    // production and temp indices not stored in .INF dataset
+      if( *ixList->sFmt != "MDX" && *ixList->sFmt != "TDX" && *ixList->sFmt != "HSH" ){    // production, temp and memory indices not stored in .INF dataset
         if(( iRc = ixList->ix->GetFileNamePart( sIxName )) != XB_NO_ERROR ){
           iErrorStop = 120;
           throw iRc;
@@ -1455,6 +1516,43 @@ xbInt16 xbDbf::DeleteTag( const xbString &sIxType, const xbString &sName ){
 
     #endif
 
+    #ifdef XB_HSH_SUPPORT
+    } else if( sIxType == "HSH" ){
+      xbIxList *ixl = ixList;
+      xbBool   bDone = xbFalse;
+      xbIxHsh  *pHsh;
+      void     *vpTag;
+      xbString sTagName = sName;
+
+      while( ixl && !bDone ){
+        if( *ixl->sFmt == "HSH" ){
+          pHsh = (xbIxHsh *) ixl->ix;
+          if(( vpTag = pHsh->GetTag( sTagName )) != NULL ){
+            bDone = xbTrue;
+            xbBool bCurTag = ( vpTag == vpCurIxTag );
+            iRc = pHsh->DeleteTag( vpTag );
+            if( iRc > 0 ){
+              // last tag deleted, release the index
+              if(( iRc = RemoveIndex( pHsh )) != XB_NO_ERROR ){
+                iErrorStop = 175;
+                throw iRc;
+              }
+            } else if( iRc < 0 ){
+              iErrorStop = 176;
+              throw iRc;
+            }
+            if( bCurTag )
+              SetCurTag( "", NULL, NULL );
+          }
+        }
+        ixl = ixl->next;
+      }
+
+      if( !bDone )
+        return XB_INVALID_TAG;
+
+    #endif
+
     } else {
       iErrorStop = 180;
       iRc = XB_INVALID_OPTION;
@@ -1822,9 +1920,9 @@ xbInt16 xbDbf::GetFirstKey(){
     return XB_INVALID_TAG;
 }
 /************************************************************************/
-xbInt16 xbDbf::GetFirstKey( xbIx *pIx, void *vpTag ){
+xbInt16 xbDbf::GetFirstKey( xbIx *pIx, void *vpTag, xbInt16 iRetrieveSw ){
   if( pIx )
-    return pIx->GetFirstKey( vpTag, 1 );
+    return pIx->GetFirstKey( vpTag, iRetrieveSw );
   else
     return XB_INVALID_TAG;
 }
@@ -1840,9 +1938,9 @@ xbInt16 xbDbf::GetLastKey(){
     return XB_INVALID_TAG;
 }
 /************************************************************************/
-xbInt16 xbDbf::GetLastKey( xbIx *pIx, void *vpTag ){
+xbInt16 xbDbf::GetLastKey( xbIx *pIx, void *vpTag, xbInt16 iRetrieveSw ){
   if( pIx )
-    return pIx->GetLastKey( vpTag, 1 );
+    return pIx->GetLastKey( vpTag, iRetrieveSw );
   else
     return XB_INVALID_TAG;
 }
@@ -1854,9 +1952,9 @@ xbInt16 xbDbf::GetNextKey(){
     return XB_INVALID_TAG;
 }
 /************************************************************************/
-xbInt16 xbDbf::GetNextKey( xbIx *pIx, void *vpTag ){
+xbInt16 xbDbf::GetNextKey( xbIx *pIx, void *vpTag, xbInt16 iRetrieveSw ){
   if( pIx )
-    return pIx->GetNextKey( vpTag, 1 );
+    return pIx->GetNextKey( vpTag, iRetrieveSw );
   else
     return XB_INVALID_TAG;
 }
@@ -1868,10 +1966,10 @@ xbInt16 xbDbf::GetPrevKey(){
     return XB_INVALID_TAG;
 }
 /************************************************************************/
-xbInt16 xbDbf::GetPrevKey( xbIx *pIx, void *vpTag ){
+xbInt16 xbDbf::GetPrevKey( xbIx *pIx, void *vpTag, xbInt16 iRetrieveSw ){
 
   if( pIx )
-    return pIx->GetPrevKey( vpTag, 1 );
+    return pIx->GetPrevKey( vpTag, iRetrieveSw );
   else
     return XB_INVALID_TAG;
 }
@@ -1897,23 +1995,30 @@ xbInt16 xbDbf::Find( xbDouble &dKey ){
     return XB_INVALID_TAG;
 }
 /************************************************************************/
-xbInt16 xbDbf::Find( xbIx *pIx, void *vpTag, const xbString &sKey ){
+xbInt16 xbDbf::Find( xbIx *pIx, void *vpTag, const xbString &sKey, xbInt16 iRetrieveSw ){
   if( pIx ){
-    return pIx->FindKey( vpTag, sKey.Str(), (xbInt32) sKey.Len(), 1 );
+    return pIx->FindKey( vpTag, sKey.Str(), (xbInt32) sKey.Len(), iRetrieveSw );
   } else
     return XB_INVALID_TAG;
 }
 /************************************************************************/
-xbInt16 xbDbf::Find( xbIx *pIx, void *vpTag, const xbDate &dtKey ){
+xbInt16 xbDbf::Find( xbIx *pIx, void *vpTag, const xbDate &dtKey, xbInt16 iRetrieveSw ){
  if( pIx )
-    return pIx->FindKey( vpTag, dtKey, 1 );
+    return pIx->FindKey( vpTag, dtKey, iRetrieveSw );
   else
     return XB_INVALID_TAG;
 }
 /************************************************************************/
-xbInt16 xbDbf::Find( xbIx *pIx, void *vpTag, const xbDouble &dKey ){
+xbInt16 xbDbf::Find( xbIx *pIx, void *vpTag, const xbDouble &dKey, xbInt16 iRetrieveSw ){
  if( pIx )
-    return pIx->FindKey( vpTag, dKey, 1 );
+    return pIx->FindKey( vpTag, dKey, iRetrieveSw );
+  else
+    return XB_INVALID_TAG;
+}
+/************************************************************************/
+xbInt16 xbDbf::ProbeKey( xbIx *pIx, void *vpTag, const xbString &sKey ){
+  if( pIx )
+    return pIx->ProbeKey( vpTag, sKey.Str(), (xbInt32) sKey.Len());
   else
     return XB_INVALID_TAG;
 }
@@ -1938,6 +2043,18 @@ xbBool xbDbf::GetEof() {
     return xbFalse;
 }
 /************************************************************************/
+xbInt16 xbDbf::GetChangedRecNo( xbUInt32 ulSeq, xbUInt32 &ulRecNo ) const {
+
+  if( ulSeq < ulChangeLogFirst || ulSeq > ulChangeSeq || ulChangeSeq - ulSeq >= XB_DBF_CHANGE_LOG_SIZE )
+    return XB_NOT_FOUND;
+  ulRecNo = ulaChangeLog[ulSeq % XB_DBF_CHANGE_LOG_SIZE];
+  return XB_NO_ERROR;
+}
+/************************************************************************/
+xbUInt32 xbDbf::GetChangeSeq() const {
+  return ulChangeSeq;
+}
+/************************************************************************/
 xbUInt32 xbDbf::GetCurRecNo() const {
   return ulCurRec;
 }
@@ -3025,6 +3142,7 @@ xbInt16 xbDbf::Pack( xbUInt32 &ulDeletedRecCnt )
       cUpdateMM = (char) d.MonthOf();
       cUpdateDD = (char) d.DayOf( XB_FMT_MONTH );
       ulNoOfRecs = ulLastPackedRec;
+      ResetChangeLog();
 
       // rewrite the header record 
       if(( iRc = WriteHeader( 1, 1 )) != XB_NO_ERROR ){
@@ -3217,6 +3335,7 @@ xbInt16 xbDbf::PutRecord(xbUInt32 ulRecNo)
 
     ulCurRec = ulRecNo;
     iDbfStatus = XB_OPEN;
+    LogRecChange( ulRecNo );
   }
 
   catch (xbInt16 iRc ){
@@ -3310,6 +3429,29 @@ xbInt16 xbDbf::RemoveIndex( xbIx * ixIn ){
 }
 #endif // XB_INDEX_SUPPORT
 
+/************************************************************************/
+//! @brief Add a record write to the change log.
+/*!
+  @private
+  @param ulRecNo Record number written.
+  @returns void
+*/
+void xbDbf::LogRecChange( xbUInt32 ulRecNo ){
+  ulChangeSeq++;
+  ulaChangeLog[ulChangeSeq % XB_DBF_CHANGE_LOG_SIZE] = ulRecNo;
+}
+/************************************************************************/
+//! @brief Reset the change log.
+/*!
+  @private
+  The sequence number still moves forward, so anyone holding an older
+  sequence number sees the change and finds the log entries are gone.
+  @returns void
+*/
+void xbDbf::ResetChangeLog(){
+  ulChangeSeq++;
+  ulChangeLogFirst = ulChangeSeq + 1;
+}
 /************************************************************************/
 void xbDbf::ResetNoOfRecords() {
   ulNoOfRecs = 0UL;
@@ -3580,6 +3722,7 @@ xbInt16 xbDbf::Zap(){
     cUpdateMM = (char) d.MonthOf();
     cUpdateDD = (char) d.DayOf( XB_FMT_MONTH );
     ulNoOfRecs = 0;
+    ResetChangeLog();
 
     // rewrite the header record 
     if(( iRc = WriteHeader( 1, 1 )) != XB_NO_ERROR ){
@@ -3652,6 +3795,10 @@ xbBool xbDbf::GetBlockReadStatus() const {
   return bBlockReadEnabled;
 }
 
+xbBlockRead *xbDbf::GetBlockReadPtr() const {
+  return bBlockReadEnabled ? pRb : NULL;
+}
+
 xbInt16 xbDbf::EnableBlockReadProcessing(){
 
   xbInt16  iRc = 0;
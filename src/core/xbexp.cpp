@@ -26,19 +26,69 @@ namespace xb{
 
 /*************************************************************************/
 xbExp::xbExp( xbXBase *x ){
-   xbase   = x;
-   dbf     = NULL;
-   nTree   = NULL;
+   xbase     = x;
+   dbf       = NULL;
+   nTree     = NULL;
+   pProgram  = NULL;
+   iInstrCnt = 0;
+   npRegNode = NULL;
+   ipRegShare = NULL;
+   iSharedCnt = 0;
+   #ifdef XB_DEBUG_SUPPORT
+   ulInstrExecCnt = 0;
+   #endif
+   dReg      = NULL;
+   sReg      = NULL;
+   cpStrReg  = NULL;
+   ulpStrCap = NULL;
+   ulpStrLen = NULL;
+   iRegCnt   = 0;
+   bVmResult = xbFalse;
+   iBatchSts = 0;
+   dBatch    = NULL;
+   sBatch    = NULL;
+   ulpBatchOfs = NULL;
+   ulpBatchLen = NULL;
+   ipFieldDeps = NULL;
+   iFieldDepCnt = 0;
+   iDepFlags = 0;
+   bMsgLogging = xbTrue;
 }
 /*************************************************************************/
 xbExp::xbExp( xbXBase *x, xbDbf *d ){
-   xbase   = x;
-   dbf     = d;
-   nTree   = NULL;
+   xbase     = x;
+   dbf       = d;
+   nTree     = NULL;
+   pProgram  = NULL;
+   iInstrCnt = 0;
+   npRegNode = NULL;
+   ipRegShare = NULL;
+   iSharedCnt = 0;
+   #ifdef XB_DEBUG_SUPPORT
+   ulInstrExecCnt = 0;
+   #endif
+   dReg      = NULL;
+   sReg      = NULL;
+   cpStrReg  = NULL;
+   ulpStrCap = NULL;
+   ulpStrLen = NULL;
+   iRegCnt   = 0;
+   bVmResult = xbFalse;
+   iBatchSts = 0;
+   dBatch    = NULL;
+   sBatch    = NULL;
+   ulpBatchOfs = NULL;
+   ulpBatchLen = NULL;
+   ipFieldDeps = NULL;
+   iFieldDepCnt = 0;
+   iDepFlags = 0;
+   bMsgLogging = xbTrue;
 }
 /*************************************************************************/
 xbExp::~xbExp() {
 
+  FreeProgram();
+  FreeFieldDeps();
   if( nTree )
     delete nTree;
 }
@@ -180,11 +230,395 @@ xbInt16 xbExp::CheckParensAndQuotes( const xbString &sExpression ){
 }
 /*************************************************************************/
 void xbExp::ClearTreeHandle(){
+  FreeProgram();
   if( nTree ){
     nTree = NULL;
   }
 }
 /*************************************************************************/
+xbInt16 xbExp::CompileExpression(){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    FreeProgram();
+    xbExpNode *n;
+    xbInt32 lNodeCnt = 0;
+    n = GetNextNode( NULL );
+    while( n ){
+      lNodeCnt++;
+      n = GetNextNode( n );
+    }
+    if( lNodeCnt == 0 || lNodeCnt > 32767 ){
+      iErrorStop = 100;
+      iRc = XB_PARSE_ERROR;
+      throw iRc;
+    }
+    iRegCnt   = (xbInt16) lNodeCnt;
+    npRegNode = new xbExpNode *[iRegCnt];
+    ipRegShare = new xbInt16[iRegCnt];
+    dReg      = new xbDouble[iRegCnt];
+    sReg      = new xbString[iRegCnt];
+    cpStrReg  = new char *[iRegCnt];
+    ulpStrCap = new xbUInt32[iRegCnt];
+    ulpStrLen = new xbUInt32[iRegCnt];
+    pProgram  = new xbExpInstr[iRegCnt * 2];   // room for a jump per .AND. / .OR.
+
+    xbInt16 i;
+    for( i = 0; i < iRegCnt; i++ ){
+      cpStrReg[i]  = NULL;
+      ulpStrCap[i] = 0;
+      ulpStrLen[i] = 0;
+    }
+
+    // registers are numbered in evaluation order, which leaves the root in the last one
+    // constant registers are loaded once here and have no instruction
+    // character registers get a buffer big enough for the longest result the node can return,
+    // so processing a record doesn't allocate memory
+    xbUInt32 ulLen;
+    i = 0;
+    n = GetNextNode( NULL );
+    while( n ){
+      npRegNode[i] = n;
+      dReg[i]      = n->GetNumericResult();
+      sReg[i]      = n->GetStringResult();
+      if( n->GetReturnType() == XB_EXP_CHAR ){
+        ulLen = sReg[i].Len();
+        if( n->GetResultLen() > ulLen )
+          ulLen = n->GetResultLen();
+        if(( cpStrReg[i] = (char *) calloc( 1, ulLen + 1 )) == NULL ){
+          iErrorStop = 105;
+          iRc = XB_NO_MEMORY;
+          throw iRc;
+        }
+        ulpStrCap[i] = ulLen;
+        ulpStrLen[i] = sReg[i].Len();
+        memcpy( cpStrReg[i], sReg[i].Str(), ulpStrLen[i] );
+      }
+      i++;
+      n = GetNextNode( n );
+    }
+
+    // a subtree identical to one evaluated earlier reads that register instead of being evaluated again
+    // the earlier copy has to be processed whenever the later one would be, so if it is in the right operand
+    // of an .AND. / .OR., the later copy must be in the same operand
+    xbExpNode  *nWork;
+    xbExpNode  *nParent;
+    xbInt16 j;
+    xbInt16 k;
+    for( i = 0; i < iRegCnt; i++ )
+      ipRegShare[i] = i;
+    for( i = 0; i < iRegCnt; i++ ){
+      n = npRegNode[i];
+      if( !IsShareable( n ))
+        continue;
+      for( k = 0; k < i; k++ ){
+        if( ipRegShare[k] != k || !n->IsEqual( npRegNode[k] ))
+          continue;
+        nWork = npRegNode[k];
+        while(( nParent = nWork->GetParent()) != NULL && !( IsShortCircuit( nParent ) && nParent->GetChild( 1 ) == nWork ))
+          nWork = nParent;
+        if( nParent && i > GetRegNo( nWork ))
+          continue;
+        // registers are in evaluation order, so the subtree is the block of registers ending at its top node
+        for( j = GetRegNo( n->GetFirstNode()); j < i; j++ )
+          ipRegShare[j] = -1;
+        ipRegShare[i] = k;
+        break;
+      }
+    }
+    iSharedCnt = 0;
+    for( i = 0; i < iRegCnt; i++ )
+      if( ipRegShare[i] >= 0 && ipRegShare[i] != i )
+        iSharedCnt++;
+
+    xbExpInstr *p;
+    char cType;
+    char cChildType;
+    xbInt16 iOp;
+    xbInt16 iCode;
+    xbInt16 iErr;
+
+    for( i = 0; i < iRegCnt; i++ ){
+      n = npRegNode[i];
+
+      // if this is the first node of the right operand of a logical .AND. / .OR., its leftmost leaf,
+      // emit a jump around the right operand for when the left operand decides the result,
+      // even if the node is in a repeated subtree and has no instruction of its own
+      nWork = n;
+      while(( nParent = nWork->GetParent()) != NULL && nParent->GetChild( 0 ) == nWork )
+        nWork = nParent;
+      if( nParent && n->GetChildCnt() == 0 && IsShortCircuit( nParent )){
+        p = &pProgram[iInstrCnt++];
+        p->iOpCode = ( nParent->GetOpCode() == XB_EXP_OPR_AND ) ? XB_EXPOP_AND_SC : XB_EXPOP_OR_SC;
+        p->iReg    = GetRegNo( nParent );
+        p->iArgCnt = 1;
+        p->iArg[0] = ipRegShare[GetRegNo( nParent->GetChild( 0 ))];
+        p->iArg[1] = iInstrCnt;      // target is set when the operator is compiled
+        p->n       = nParent;
+      }
+
+      // repeated subtrees have no instructions
+      if( ipRegShare[i] != i || n->GetNodeType() == XB_EXP_CONSTANT )
+        continue;
+
+      p = &pProgram[iInstrCnt++];
+      p->iReg    = i;
+      p->n       = n;
+      p->iArgCnt = (xbInt16) n->GetChildCnt();
+      p->ulOfs   = 0;
+      p->ulLen   = 0;
+      if( p->iArgCnt > 4 ){
+        iErrorStop = 110;
+        iRc = XB_PARSE_ERROR;
+        throw iRc;
+      }
+      for( j = 0; j < p->iArgCnt; j++ ){
+        if(( p->iArg[j] = GetRegNo( n->GetChild( (xbUInt32) j ))) < 0 ){
+          iErrorStop = 120;
+          iRc = XB_PARSE_ERROR;
+          throw iRc;
+        }
+        p->iArg[j] = ipRegShare[p->iArg[j]];
+      }
+
+      iOp   = XB_EXPOP_ERROR;
+      iErr  = XB_PARSE_ERROR;
+      cType = n->GetReturnType();
+      iCode = n->GetOpCode();
+
+      switch( n->GetNodeType() ){
+
+        case XB_EXP_FIELD:
+          if( !n->GetDbf() )
+            break;
+          // fields are decoded straight out of the record buffer into the register
+          xbInt16 iFieldLen;
+          if( n->GetDbf()->GetFieldOffset( n->GetFieldNo(), p->ulOfs ) != XB_NO_ERROR ||
+              n->GetDbf()->GetFieldLen( n->GetFieldNo(), iFieldLen ) != XB_NO_ERROR ){
+            iErr = XB_INVALID_FIELD_NO;
+            break;
+          }
+          p->ulLen = (xbUInt32) iFieldLen;
+          if( cType == XB_EXP_CHAR )
+            iOp = XB_EXPOP_FIELD_C;
+          else if( cType == XB_EXP_DATE )
+            iOp = XB_EXPOP_FIELD_D;
+          else if( cType == XB_EXP_LOGICAL )
+            iOp = XB_EXPOP_FIELD_L;
+          else if( cType == XB_EXP_NUMERIC )
+            iOp = XB_EXPOP_FIELD_N;
+          break;
+
+        case XB_EXP_PRE_OPERATOR:
+          if( p->iArgCnt == 1 )
+            iOp = ( iCode == XB_EXP_OPR_INC ) ? XB_EXPOP_PRE_INC : XB_EXPOP_PRE_DEC;
+          break;
+
+        case XB_EXP_POST_OPERATOR:
+          if( p->iArgCnt == 1 )
+            iOp = ( iCode == XB_EXP_OPR_INC ) ? XB_EXPOP_POST_INC : XB_EXPOP_POST_DEC;
+          break;
+
+        case XB_EXP_FUNCTION:
+          iOp = XB_EXPOP_FUNCTION;
+          // the common character functions are processed in the register buffers,
+          // the rest go through ProcessExpressionFunction()
+          if( p->iArgCnt > 0 && n->GetChild( 0 )->GetReturnType() == XB_EXP_CHAR ){
+            if( p->iArgCnt == 1 && ( iCode == XB_EXP_FNC_UPPER || iCode == XB_EXP_FNC_LOWER ||
+                iCode == XB_EXP_FNC_TRIM  || iCode == XB_EXP_FNC_RTRIM || iCode == XB_EXP_FNC_LTRIM ||
+                iCode == XB_EXP_FNC_ALLTRIM || iCode == XB_EXP_FNC_LEN ))
+              iOp = XB_EXPOP_FUNCTION_C;
+            else if( p->iArgCnt == 2 && ( iCode == XB_EXP_FNC_LEFT || iCode == XB_EXP_FNC_RIGHT ) &&
+                n->GetChild( 1 )->GetReturnType() == XB_EXP_NUMERIC )
+              iOp = XB_EXPOP_FUNCTION_C;
+            else if( p->iArgCnt == 3 && iCode == XB_EXP_FNC_SUBSTR &&
+                n->GetChild( 1 )->GetReturnType() == XB_EXP_NUMERIC &&
+                n->GetChild( 2 )->GetReturnType() == XB_EXP_NUMERIC )
+              iOp = XB_EXPOP_FUNCTION_C;
+          } else if( p->iArgCnt == 3 && iCode == XB_EXP_FNC_IIF && cType == XB_EXP_CHAR &&
+                n->GetChild( 0 )->GetReturnType() == XB_EXP_LOGICAL &&
+                n->GetChild( 1 )->GetReturnType() == XB_EXP_CHAR &&
+                n->GetChild( 2 )->GetReturnType() == XB_EXP_CHAR ){
+            iOp = XB_EXPOP_FUNCTION_C;
+          }
+          break;
+
+        case XB_EXP_OPERATOR:
+          if( p->iArgCnt < 1 || ( !n->IsUnaryOperator() && p->iArgCnt < 2 ))
+            break;
+          cChildType = n->GetChild( 0 )->GetReturnType();
+
+          if( cType == XB_EXP_CHAR ){
+            if( iCode == XB_EXP_OPR_ADD )
+              iOp = XB_EXPOP_CAT_C;
+            else if( iCode == XB_EXP_OPR_SUB )
+              iOp = XB_EXPOP_CATTRIM_C;
+
+          } else if( cType == XB_EXP_NUMERIC || cType == XB_EXP_DATE ){
+            if( iCode == XB_EXP_OPR_ADD )
+              iOp = XB_EXPOP_ADD_N;
+            else if( iCode == XB_EXP_OPR_SUB )
+              iOp = XB_EXPOP_SUB_N;
+            else if( iCode == XB_EXP_OPR_ADDASG )
+              iOp = XB_EXPOP_ADDASG_N;
+            else if( iCode == XB_EXP_OPR_SUBASG )
+              iOp = XB_EXPOP_SUBASG_N;
+            else if( cType == XB_EXP_NUMERIC ){
+              if( iCode == XB_EXP_OPR_MUL )
+                iOp = XB_EXPOP_MUL_N;
+              else if( iCode == XB_EXP_OPR_DIV )
+                iOp = XB_EXPOP_DIV_N;
+              else if( iCode == XB_EXP_OPR_POW )
+                iOp = XB_EXPOP_POW_N;
+              else if( iCode == XB_EXP_OPR_MULASG )
+                iOp = XB_EXPOP_MULASG_N;
+              else if( iCode == XB_EXP_OPR_DIVASG )
+                iOp = XB_EXPOP_DIVASG_N;
+            }
+
+          } else if( cType == XB_EXP_LOGICAL ){
+            if( !n->IsUnaryOperator() && cChildType != n->GetChild( 1 )->GetReturnType()){
+              iErr = XB_INCOMPATIBLE_OPERANDS;
+            } else if( iCode == XB_EXP_OPR_AND ){
+              iOp = XB_EXPOP_AND;
+            } else if( iCode == XB_EXP_OPR_OR ){
+              iOp = XB_EXPOP_OR;
+            } else if( iCode == XB_EXP_OPR_NOT ){
+              iOp = XB_EXPOP_NOT;
+            } else if( iCode == XB_EXP_OPR_CONTAINS ){
+              if( cChildType == XB_EXP_CHAR )
+                iOp = XB_EXPOP_CONTAINS_C;
+              else
+                iErr = XB_INCOMPATIBLE_OPERANDS;
+            } else {
+              // compare operators, the op codes for each operand type are laid out in the same order
+              xbInt16 iCmp = -1;
+              if( iCode == XB_EXP_OPR_EQ )
+                iCmp = 0;
+              else if( iCode == XB_EXP_OPR_NE )
+                iCmp = 1;
+              else if( iCode == XB_EXP_OPR_LT )
+                iCmp = 2;
+              else if( iCode == XB_EXP_OPR_LE )
+                iCmp = 3;
+              else if( iCode == XB_EXP_OPR_GT )
+                iCmp = 4;
+              else if( iCode == XB_EXP_OPR_GE )
+                iCmp = 5;
+              if( iCmp >= 0 ){
+                if( cChildType == XB_EXP_CHAR )
+                  iOp = XB_EXPOP_EQ_C + iCmp;
+                else if( cChildType == XB_EXP_NUMERIC )
+                  iOp = XB_EXPOP_EQ_N + iCmp;
+                else if( cChildType == XB_EXP_DATE )
+                  iOp = XB_EXPOP_EQ_D + iCmp;
+              }
+            }
+          }
+          break;
+
+        default:
+          break;
+      }
+
+      // anything that can't be compiled raises its error when the expression is processed,
+      // the same as the tree walk does
+      p->iOpCode = iOp;
+      if( iOp == XB_EXPOP_ERROR )
+        p->iArg[0] = iErr;
+
+      // point the jump for this operator past it
+      if( iOp == XB_EXPOP_AND || iOp == XB_EXPOP_OR ){
+        for( j = (xbInt16) ( iInstrCnt - 2 ); j >= 0; j-- ){
+          if(( pProgram[j].iOpCode == XB_EXPOP_AND_SC || pProgram[j].iOpCode == XB_EXPOP_OR_SC ) && pProgram[j].iReg == i ){
+            pProgram[j].iArg[1] = iInstrCnt;
+            break;
+          }
+        }
+      }
+    }
+  }
+  catch (xbInt16 iRc ){
+    FreeProgram();
+    xbString sMsg;
+    sMsg.Sprintf( "xbexp::CompileExpression() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+  }
+  return iRc;
+}
+/*************************************************************************/
+xbInt16 xbExp::CopyExpression( const xbExp *e ){
+
+  FreeProgram();
+  if( nTree ){
+    delete nTree;
+    nTree = NULL;
+  }
+  dbf = e->dbf;
+  if( e->nTree ){
+    nTree = e->nTree->Clone();
+    CompileExpression();       // if it won't compile, the tree is processed instead
+  }
+  return SetFieldDeps();
+}
+/*************************************************************************/
+xbDouble xbExp::DecodeNumericField( const char *cpField, xbUInt32 ulLen ) const {
+
+  // GetDoubleField() looks at no more than the first 20 bytes
+  if( ulLen > 20 )
+    ulLen = 20;
+
+  // the digits are collected into an integer and scaled once at the end, while there are no more than
+  // 15 digits the integer and power of ten are exact and the division rounds the same as strtod()
+  static const xbDouble dPow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                     1e11, 1e12, 1e13, 1e14, 1e15 };
+  xbUInt32 ul = 0;
+  xbInt64  llValue = 0;
+  xbInt16  iDigits = 0;
+  xbInt16  iDecimals = 0;
+  xbBool   bNeg = xbFalse;
+  xbBool   bFallBack = xbFalse;
+
+  while( ul < ulLen && cpField[ul] == ' ' )
+    ul++;
+  if( ul < ulLen && ( cpField[ul] == '-' || cpField[ul] == '+' )){
+    bNeg = ( cpField[ul] == '-' );
+    ul++;
+  }
+  while( ul < ulLen && isdigit( (unsigned char) cpField[ul] )){
+    llValue = llValue * 10 + ( cpField[ul++] - '0' );
+    iDigits++;
+  }
+  if( ul < ulLen && cpField[ul] == '.' ){
+    ul++;
+    while( ul < ulLen && isdigit( (unsigned char) cpField[ul] )){
+      llValue = llValue * 10 + ( cpField[ul++] - '0' );
+      iDigits++;
+      iDecimals++;
+    }
+  }
+  if( iDigits > 15 )
+    bFallBack = xbTrue;
+  else if( ul < ulLen && cpField[ul] != ' ' && cpField[ul] != 0x00 && ( iDigits == 0 || isalpha( (unsigned char) cpField[ul] )))
+    bFallBack = xbTrue;     // exponents, hex, inf, nan and other text strtod() might accept
+
+  if( bFallBack ){
+    char cBuf[21];
+    memcpy( cBuf, cpField, ulLen );
+    cBuf[ulLen] = 0x00;
+    return strtod( cBuf, NULL );
+  }
+
+  if( iDigits == 0 )
+    return 0;
+  xbDouble d = (xbDouble) llValue;
+  if( iDecimals > 0 )
+    d /= dPow10[iDecimals];
+  return bNeg ? -d : d;
+}
+/*************************************************************************/
 #ifdef XB_DEBUG_SUPPORT
 void xbExp::DumpTree( xbInt16 iOption ){
   nTree->DumpNode( iOption );
@@ -216,10 +650,636 @@ void xbExp::DumpToken( xbExpToken &t, xbInt16 iOption ){
   sMsg.Sprintf( "PrevReturnType = [%c]", t.cPrevReturnType );
   xbase->WriteLogMessage( sMsg.Str(), iOption );
 }
+xbUInt32 xbExp::GetInstrExecCnt() const {
+  return ulInstrExecCnt;
+}
 #endif
 /*************************************************************************/
+xbInt16 xbExp::ExecuteCharFunction( xbExpInstr *p ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    // work out which part of the source string is the result, then copy it once
+    // the edge cases follow the xbXBase versions of the functions
+    xbInt16     iSrc     = p->iArg[0];
+    xbUInt32    ulSrcLen = ulpStrLen[iSrc];
+    xbUInt32    ulStart  = 0;
+    xbUInt32    ulLen    = ulSrcLen;
+    xbUInt32    ulCnt;
+    xbUInt32    ulPos;
+    char       *cpDst;
+    xbInt16     iFunc    = p->n->GetOpCode();
+
+    switch( iFunc ){
+
+      case XB_EXP_FNC_LEN:
+        dReg[p->iReg] = (xbDouble) ulSrcLen;
+        return XB_NO_ERROR;
+
+      case XB_EXP_FNC_UPPER:
+      case XB_EXP_FNC_LOWER:
+        break;
+
+      case XB_EXP_FNC_TRIM:
+      case XB_EXP_FNC_RTRIM:
+        while( ulLen > 0 && cpStrReg[iSrc][ulLen-1] == ' ' )
+          ulLen--;
+        break;
+
+      case XB_EXP_FNC_LTRIM:
+      case XB_EXP_FNC_ALLTRIM:
+        if( iFunc == XB_EXP_FNC_ALLTRIM )
+          while( ulLen > 0 && cpStrReg[iSrc][ulLen-1] == ' ' )
+            ulLen--;
+        while( ulStart < ulLen && cpStrReg[iSrc][ulStart] == ' ' )
+          ulStart++;
+        ulLen -= ulStart;
+        break;
+
+      case XB_EXP_FNC_LEFT:
+        ulCnt = (xbUInt32) dReg[p->iArg[1]];
+        if( ulCnt < ulLen )
+          ulLen = ulCnt;
+        break;
+
+      case XB_EXP_FNC_RIGHT:
+        ulCnt = (xbUInt32) dReg[p->iArg[1]];
+        if( ulCnt <= ulSrcLen ){
+          ulStart = ulSrcLen - ulCnt;
+          ulLen   = ulCnt;
+        }
+        break;
+
+      case XB_EXP_FNC_SUBSTR:
+        // a start position outside the string returns the string unchanged
+        ulPos = (xbUInt32) dReg[p->iArg[1]];
+        ulCnt = (xbUInt32) dReg[p->iArg[2]];
+        if( ulPos > 0 && ulPos <= ulSrcLen ){
+          if( ulCnt == 0 || ulCnt + ulPos > ulSrcLen )
+            ulCnt = ulSrcLen - ulPos + 1;
+          ulStart = ulPos - 1;
+          ulLen   = ulCnt;
+        }
+        break;
+
+      case XB_EXP_FNC_IIF:
+        if( ulpStrLen[p->iArg[1]] != ulpStrLen[p->iArg[2]] ){
+          iErrorStop = 100;
+          iRc = XB_INCONSISTENT_PARM_LENS;
+          throw iRc;
+        }
+        iSrc  = (xbBool) dReg[p->iArg[0]] ? p->iArg[1] : p->iArg[2];
+        ulLen = ulpStrLen[iSrc];
+        break;
+
+      default:
+        iErrorStop = 110;
+        iRc = XB_PARSE_ERROR;
+        throw iRc;
+    }
+
+    if(( cpDst = ReserveStrReg( p->iReg, ulLen )) == NULL ){
+      iErrorStop = 120;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    memcpy( cpDst, cpStrReg[iSrc] + ulStart, ulLen );
+    cpDst[ulLen] = 0x00;
+    if( iFunc == XB_EXP_FNC_UPPER ){
+      for( xbUInt32 ul = 0; ul < ulLen; ul++ )
+        cpDst[ul] = (char) toupper( cpDst[ul] );
+    } else if( iFunc == XB_EXP_FNC_LOWER ){
+      for( xbUInt32 ul = 0; ul < ulLen; ul++ )
+        cpDst[ul] = (char) tolower( cpDst[ul] );
+    }
+    ulpStrLen[p->iReg] = ulLen;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbexp::ExecuteCharFunction() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+  }
+  return iRc;
+}
+/*************************************************************************/
+xbInt16 xbExp::ExecuteProgram( xbInt16 iRecBufSw ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  bVmResult = xbFalse;
+
+  try{
+    xbExpInstr *p    = pProgram;
+    xbExpInstr *pEnd = pProgram + iInstrCnt;
+    xbDouble   *d    = dReg;
+    xbString   *s    = sReg;
+    char      **c    = cpStrReg;
+    xbUInt32   *l    = ulpStrLen;
+    xbExpNode  *nArg;
+    xbString    sWork1;
+    xbDate      dtWork;
+    xbDouble    d1;
+    xbDouble    d2;
+    xbBool      bWork;
+    const char *cpSrc;
+    char       *cpDst;
+    xbUInt32    ul;
+    xbUInt32    ulLen1;
+    xbUInt32    ulLen2;
+
+    #ifdef XB_DEBUG_SUPPORT
+    ulInstrExecCnt = 0;
+    #endif
+
+    for( ; p < pEnd; p++ ){
+      #ifdef XB_DEBUG_SUPPORT
+      ulInstrExecCnt++;
+      #endif
+      switch( p->iOpCode ){
+
+        case XB_EXPOP_FIELD_C:
+          // same as GetField(), stops at a null byte in the field
+          cpSrc = p->n->GetDbf()->GetRecordBuf( iRecBufSw ) + p->ulOfs;
+          for( ul = 0; ul < p->ulLen && cpSrc[ul]; ul++ );
+          if(( cpDst = ReserveStrReg( p->iReg, ul )) == NULL ){
+            iErrorStop = 100;
+            iRc = XB_NO_MEMORY;
+            throw iRc;
+          }
+          memcpy( cpDst, cpSrc, ul );
+          cpDst[ul] = 0x00;
+          l[p->iReg] = ul;
+          break;
+
+        case XB_EXPOP_FIELD_D:
+          // blank dates are null, anything else that isn't a valid date is zero
+          cpSrc = p->n->GetDbf()->GetRecordBuf( iRecBufSw ) + p->ulOfs;
+          if( p->ulLen != 8 )
+            d[p->iReg] = 0;
+          else if( memcmp( cpSrc, "        ", 8 ) == 0 )
+            d[p->iReg] = (xbDouble) XB_NULL_DATE;
+          else
+            d[p->iReg] = (xbDouble) dtWork.JulianDays( cpSrc );
+          break;
+
+        case XB_EXPOP_FIELD_L:
+          cpSrc = p->n->GetDbf()->GetRecordBuf( iRecBufSw ) + p->ulOfs;
+          d[p->iReg] = ( *cpSrc == 'T' || *cpSrc == 't' || *cpSrc == 'Y' || *cpSrc == 'y' ) ? 1 : 0;
+          break;
+
+        case XB_EXPOP_FIELD_N:
+          d[p->iReg] = DecodeNumericField( p->n->GetDbf()->GetRecordBuf( iRecBufSw ) + p->ulOfs, p->ulLen );
+          break;
+
+        case XB_EXPOP_PRE_INC:
+          d[p->iArg[0]] += 1;
+          d[p->iReg] = d[p->iArg[0]];
+          break;
+
+        case XB_EXPOP_PRE_DEC:
+          d[p->iArg[0]] -= 1;
+          d[p->iReg] = d[p->iArg[0]];
+          break;
+
+        case XB_EXPOP_POST_INC:
+          d[p->iReg] = d[p->iArg[0]];
+          d[p->iArg[0]] += 1;
+          break;
+
+        case XB_EXPOP_POST_DEC:
+          d[p->iReg] = d[p->iArg[0]];
+          d[p->iArg[0]] -= 1;
+          break;
+
+        case XB_EXPOP_ADD_N:
+          d[p->iReg] = d[p->iArg[0]] + d[p->iArg[1]];
+          break;
+
+        case XB_EXPOP_SUB_N:
+          d[p->iReg] = d[p->iArg[0]] - d[p->iArg[1]];
+          break;
+
+        case XB_EXPOP_MUL_N:
+          d[p->iReg] = d[p->iArg[0]] * d[p->iArg[1]];
+          break;
+
+        case XB_EXPOP_DIV_N:
+          d[p->iReg] = d[p->iArg[0]] / d[p->iArg[1]];
+          break;
+
+        case XB_EXPOP_POW_N:
+          d[p->iReg] = pow( d[p->iArg[0]], d[p->iArg[1]] );
+          break;
+
+        case XB_EXPOP_ADDASG_N:
+          d[p->iReg] = d[p->iArg[0]] + d[p->iArg[1]];
+          d[p->iArg[0]] = d[p->iReg];
+          break;
+
+        case XB_EXPOP_SUBASG_N:
+          d[p->iReg] = d[p->iArg[0]] - d[p->iArg[1]];
+          d[p->iArg[0]] = d[p->iReg];
+          break;
+
+        case XB_EXPOP_MULASG_N:
+          d[p->iReg] = d[p->iArg[0]] * d[p->iArg[1]];
+          d[p->iArg[0]] = d[p->iReg];
+          break;
+
+        case XB_EXPOP_DIVASG_N:
+          d[p->iReg] = d[p->iArg[0]] / d[p->iArg[1]];
+          d[p->iArg[0]] = d[p->iReg];
+          break;
+
+        case XB_EXPOP_CAT_C:
+        case XB_EXPOP_CATTRIM_C:
+          ulLen1 = l[p->iArg[0]];
+          ulLen2 = l[p->iArg[1]];
+          ul     = ulLen1 + ulLen2;
+          if( p->iOpCode == XB_EXPOP_CATTRIM_C ){
+            // trailing spaces on the left operand move to the end of the result
+            while( ulLen1 > 0 && c[p->iArg[0]][ulLen1-1] == ' ' )
+              ulLen1--;
+            if( ul < p->n->GetResultLen())
+              ul = p->n->GetResultLen();
+          }
+          if(( cpDst = ReserveStrReg( p->iReg, ul )) == NULL ){
+            iErrorStop = 140;
+            iRc = XB_NO_MEMORY;
+            throw iRc;
+          }
+          memcpy( cpDst, c[p->iArg[0]], ulLen1 );
+          memcpy( cpDst + ulLen1, c[p->iArg[1]], ulLen2 );
+          if( ulLen1 + ulLen2 < ul )
+            memset( cpDst + ulLen1 + ulLen2, ' ', ul - ulLen1 - ulLen2 );
+          cpDst[ul] = 0x00;
+          l[p->iReg] = ul;
+          break;
+
+        case XB_EXPOP_AND:
+          d[p->iReg] = (xbBool) ((xbBool) d[p->iArg[0]] && (xbBool) d[p->iArg[1]] );
+          break;
+
+        case XB_EXPOP_OR:
+          d[p->iReg] = (xbBool) ((xbBool) d[p->iArg[0]] || (xbBool) d[p->iArg[1]] );
+          break;
+
+        case XB_EXPOP_NOT:
+          d[p->iReg] = (xbBool) d[p->iArg[0]] ? xbFalse : xbTrue;
+          break;
+
+        case XB_EXPOP_AND_SC:
+          if( !(xbBool) d[p->iArg[0]] ){
+            d[p->iReg] = xbFalse;
+            p = pProgram + p->iArg[1] - 1;
+          }
+          break;
+
+        case XB_EXPOP_OR_SC:
+          if( (xbBool) d[p->iArg[0]] ){
+            d[p->iReg] = xbTrue;
+            p = pProgram + p->iArg[1] - 1;
+          }
+          break;
+
+        case XB_EXPOP_EQ_C:
+          // equal ignores trailing spaces
+          ulLen1 = l[p->iArg[0]];
+          ulLen2 = l[p->iArg[1]];
+          while( ulLen1 > 0 && c[p->iArg[0]][ulLen1-1] == ' ' )
+            ulLen1--;
+          while( ulLen2 > 0 && c[p->iArg[1]][ulLen2-1] == ' ' )
+            ulLen2--;
+          d[p->iReg] = (xbBool) ( ulLen1 == ulLen2 && memcmp( c[p->iArg[0]], c[p->iArg[1]], ulLen1 ) == 0 );
+          break;
+
+        case XB_EXPOP_NE_C:
+          d[p->iReg] = (xbBool) ( strcmp( c[p->iArg[0]], c[p->iArg[1]] ) != 0 );
+          break;
+
+        case XB_EXPOP_LT_C:
+          d[p->iReg] = (xbBool) ( strcmp( c[p->iArg[0]], c[p->iArg[1]] ) < 0 );
+          break;
+
+        case XB_EXPOP_LE_C:
+          d[p->iReg] = (xbBool) ( strcmp( c[p->iArg[0]], c[p->iArg[1]] ) <= 0 );
+          break;
+
+        case XB_EXPOP_GT_C:
+          d[p->iReg] = (xbBool) ( strcmp( c[p->iArg[0]], c[p->iArg[1]] ) > 0 );
+          break;
+
+        case XB_EXPOP_GE_C:
+          d[p->iReg] = (xbBool) ( strcmp( c[p->iArg[0]], c[p->iArg[1]] ) >= 0 );
+          break;
+
+        case XB_EXPOP_CONTAINS_C:
+          d[p->iReg] = (xbBool) ( l[p->iArg[1]] > 0 && strstr( c[p->iArg[1]], c[p->iArg[0]] ) != NULL );
+          break;
+
+        case XB_EXPOP_EQ_N:
+          d[p->iReg] = (xbBool) ( d[p->iArg[0]] == d[p->iArg[1]] );
+          break;
+
+        case XB_EXPOP_NE_N:
+          d[p->iReg] = (xbBool) ( d[p->iArg[0]] != d[p->iArg[1]] );
+          break;
+
+        case XB_EXPOP_LT_N:
+          d[p->iReg] = (xbBool) ( d[p->iArg[0]] < d[p->iArg[1]] );
+          break;
+
+        case XB_EXPOP_LE_N:
+          d[p->iReg] = (xbBool) ( d[p->iArg[0]] <= d[p->iArg[1]] );
+          break;
+
+        case XB_EXPOP_GT_N:
+          d[p->iReg] = (xbBool) ( d[p->iArg[0]] > d[p->iArg[1]] );
+          break;
+
+        case XB_EXPOP_GE_N:
+          d[p->iReg] = (xbBool) ( d[p->iArg[0]] >= d[p->iArg[1]] );
+          break;
+
+        case XB_EXPOP_EQ_D:
+        case XB_EXPOP_NE_D:
+        case XB_EXPOP_LT_D:
+        case XB_EXPOP_LE_D:
+        case XB_EXPOP_GT_D:
+        case XB_EXPOP_GE_D:
+          // null dates compare as zero
+          d1 = d[p->iArg[0]];
+          d2 = d[p->iArg[1]];
+          if( d1 == XB_NULL_DATE ) d1 = 0;
+          if( d2 == XB_NULL_DATE ) d2 = 0;
+          switch( p->iOpCode ){
+            case XB_EXPOP_EQ_D: bWork = ( d1 == d2 ); break;
+            case XB_EXPOP_NE_D: bWork = ( d1 != d2 ); break;
+            case XB_EXPOP_LT_D: bWork = ( d1 <  d2 ); break;
+            case XB_EXPOP_LE_D: bWork = ( d1 <= d2 ); break;
+            case XB_EXPOP_GT_D: bWork = ( d1 >  d2 ); break;
+            default:            bWork = ( d1 >= d2 ); break;
+          }
+          d[p->iReg] = bWork;
+          break;
+
+        case XB_EXPOP_FUNCTION:
+          // functions take their operands from the child nodes
+          for( xbInt16 i = 0; i < p->iArgCnt; i++ ){
+            nArg = p->n->GetChild( (xbUInt32) i );
+            if( nArg->GetReturnType() == XB_EXP_CHAR ){
+              s[p->iArg[i]] = c[p->iArg[i]];
+              nArg->SetResult( s[p->iArg[i]] );
+            } else {
+              nArg->SetResult( d[p->iArg[i]] );
+            }
+          }
+          if(( iRc = ProcessExpressionFunction( p->n, iRecBufSw )) != XB_NO_ERROR ){
+            iErrorStop = 200;
+            throw iRc;
+          }
+          if( p->n->GetReturnType() == XB_EXP_CHAR ){
+            ul = p->n->GetStringResult().Len();
+            if(( cpDst = ReserveStrReg( p->iReg, ul )) == NULL ){
+              iErrorStop = 210;
+              iRc = XB_NO_MEMORY;
+              throw iRc;
+            }
+            memcpy( cpDst, p->n->GetStringResult().Str(), ul );
+            cpDst[ul] = 0x00;
+            l[p->iReg] = ul;
+          } else {
+            d[p->iReg] = p->n->GetNumericResult();
+          }
+          break;
+
+        case XB_EXPOP_FUNCTION_C:
+          if(( iRc = ExecuteCharFunction( p )) != XB_NO_ERROR ){
+            iErrorStop = 220;
+            throw iRc;
+          }
+          break;
+
+        case XB_EXPOP_ERROR:
+        default:
+          iErrorStop = 300;
+          iRc = ( p->iOpCode == XB_EXPOP_ERROR ) ? p->iArg[0] : XB_PARSE_ERROR;
+          throw iRc;
+          // break;
+      }
+    }
+    bVmResult = xbTrue;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbexp::ExecuteProgram() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+  }
+  return iRc;
+}
+/*************************************************************************/
+xbInt16 xbExp::FoldConstants( xbExpNode *n ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    // fold the operands first, an operand can be replaced while it is folded
+    for( xbUInt32 i = 0; i < n->GetChildCnt(); i++ ){
+      if(( iRc = FoldConstants( n->GetChild( i ))) != XB_NO_ERROR ){
+        iErrorStop = 100;
+        throw iRc;
+      }
+    }
+
+    char cNodeType = n->GetNodeType();
+    if( cNodeType != XB_EXP_OPERATOR && cNodeType != XB_EXP_FUNCTION )
+      return XB_NO_ERROR;
+
+    xbInt16  iCode      = n->GetOpCode();
+    xbUInt32 ulChildCnt = n->GetChildCnt();
+    xbUInt32 ulConstCnt = 0;
+    for( xbUInt32 i = 0; i < ulChildCnt; i++ )
+      if( n->GetChild( i )->GetNodeType() == XB_EXP_CONSTANT )
+        ulConstCnt++;
+
+    // functions without operands (DATE, DELETED, RECNO...) depend on the record or the clock,
+    // assignments change their operand, and application functions aren't known to give the same result
+    xbBool bFold = ( ulChildCnt > 0 && ulConstCnt == ulChildCnt );
+    if( cNodeType == XB_EXP_OPERATOR && iCode >= XB_EXP_OPR_ADDASG && iCode <= XB_EXP_OPR_DEC )
+      bFold = xbFalse;
+    else if( cNodeType == XB_EXP_FUNCTION && iCode >= XB_EXP_FNC_USER )
+      bFold = xbFalse;
+
+    xbExpNode *nReplace = NULL;      // operand to put in place of this node
+    xbBool bToConst = xbFalse;
+
+    if( bFold ){
+      if( cNodeType == XB_EXP_OPERATOR )
+        iRc = ProcessExpressionOperator( n );
+      else
+        iRc = ProcessExpressionFunction( n, 0 );
+      // leave an invalid operation in the tree, the error is returned when the expression is processed
+      if( iRc != XB_NO_ERROR )
+        return XB_NO_ERROR;
+      bToConst = xbTrue;
+
+    } else if( cNodeType == XB_EXP_OPERATOR && ulChildCnt == 2 && ulConstCnt == 1 &&
+             ( iCode == XB_EXP_OPR_AND || iCode == XB_EXP_OPR_OR ) &&
+               n->GetChild( 0 )->GetReturnType() == XB_EXP_LOGICAL &&
+               n->GetChild( 1 )->GetReturnType() == XB_EXP_LOGICAL ){
+
+      xbExpNode *nConst = n->GetChild( 0 );
+      xbExpNode *nOther = n->GetChild( 1 );
+      if( nConst->GetNodeType() != XB_EXP_CONSTANT ){
+        nConst = n->GetChild( 1 );
+        nOther = n->GetChild( 0 );
+      }
+      xbBool bConst = nConst->GetBoolResult();
+      if(( iCode == XB_EXP_OPR_AND && bConst ) || ( iCode == XB_EXP_OPR_OR && !bConst )){
+        // .T. .AND. x, .F. .OR. x
+        nReplace = nOther;
+      } else if( !HasSideEffects( nOther )){
+        // .F. .AND. x, .T. .OR. x
+        n->SetResult( bConst );
+        bToConst = xbTrue;
+      }
+
+    } else if( cNodeType == XB_EXP_FUNCTION && iCode == XB_EXP_FNC_IIF && ulChildCnt == 3 &&
+               n->GetChild( 0 )->GetNodeType() == XB_EXP_CONSTANT ){
+
+      // IIF( .T., x, y ) - only when the result is the same as IIF would produce
+      xbExpNode *nTrue  = n->GetChild( 1 );
+      xbExpNode *nFalse = n->GetChild( 2 );
+      if( nTrue->GetReturnType() == n->GetReturnType() && nFalse->GetReturnType() == n->GetReturnType() &&
+          nTrue->GetResultLen() == n->GetResultLen() && nFalse->GetResultLen() == n->GetResultLen() &&
+          !HasSideEffects( nTrue ) && !HasSideEffects( nFalse ))
+        nReplace = n->GetChild( 0 )->GetBoolResult() ? nTrue : nFalse;
+    }
+
+    if( bToConst ){
+      xbExpNode *nChild;
+      while( n->GetChildCnt() > 0 ){
+        nChild = n->GetChild( 0 );
+        n->RemoveChild( nChild );
+        delete nChild;
+      }
+      n->SetNodeType( XB_EXP_CONSTANT );
+
+    } else if( nReplace ){
+      xbExpNode *nParent = n->GetParent();
+      if(( iRc = n->RemoveChild( nReplace )) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+      if( nParent ){
+        if(( iRc = nParent->ReplaceChild( n, nReplace )) != XB_NO_ERROR ){
+          iErrorStop = 120;
+          throw iRc;
+        }
+      } else {
+        nTree = nReplace;
+      }
+      delete n;
+    }
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbexp::FoldConstants() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+  }
+  return iRc;
+}
+/*************************************************************************/
+void xbExp::FreeBatch(){
+
+  if( dBatch ){
+    delete[] dBatch;
+    dBatch = NULL;
+  }
+  if( sBatch ){
+    delete[] sBatch;
+    sBatch = NULL;
+  }
+  if( ulpBatchOfs ){
+    delete[] ulpBatchOfs;
+    ulpBatchOfs = NULL;
+  }
+  if( ulpBatchLen ){
+    delete[] ulpBatchLen;
+    ulpBatchLen = NULL;
+  }
+  iBatchSts = 0;
+}
+/*************************************************************************/
+void xbExp::FreeFieldDeps(){
+
+  if( ipFieldDeps ){
+    free( ipFieldDeps );
+    ipFieldDeps = NULL;
+  }
+  iFieldDepCnt = 0;
+  iDepFlags    = 0;
+}
+/*************************************************************************/
+void xbExp::FreeProgram(){
+
+  FreeBatch();
+  if( pProgram ){
+    delete[] pProgram;
+    pProgram = NULL;
+  }
+  if( npRegNode ){
+    delete[] npRegNode;
+    npRegNode = NULL;
+  }
+  if( ipRegShare ){
+    delete[] ipRegShare;
+    ipRegShare = NULL;
+  }
+  if( dReg ){
+    delete[] dReg;
+    dReg = NULL;
+  }
+  if( sReg ){
+    delete[] sReg;
+    sReg = NULL;
+  }
+  if( cpStrReg ){
+    for( xbInt16 i = 0; i < iRegCnt; i++ )
+      if( cpStrReg[i] )
+        free( cpStrReg[i] );
+    delete[] cpStrReg;
+    cpStrReg = NULL;
+  }
+  if( ulpStrCap ){
+    delete[] ulpStrCap;
+    ulpStrCap = NULL;
+  }
+  if( ulpStrLen ){
+    delete[] ulpStrLen;
+    ulpStrLen = NULL;
+  }
+  iInstrCnt = 0;
+  iRegCnt   = 0;
+  iSharedCnt = 0;
+  bVmResult = xbFalse;
+}
+/*************************************************************************/
+xbBool xbExp::GetBatchSupport(){
+
+  if( iBatchSts == 0 && PrepareBatch() != XB_NO_ERROR )
+    FreeBatch();
+  return ( iBatchSts == 1 );
+}
+/*************************************************************************/
 xbInt16 xbExp::GetDateResult( xbDate &dtResult ){
-  if( nTree ){
+  if( bVmResult ){
+    dtResult.JulToDate8( (xbInt32) dReg[iRegCnt-1] );
+    return XB_NO_ERROR;
+  } else if( nTree ){
     dtResult.JulToDate8( (xbInt32) nTree->GetNumericResult() );
     return XB_NO_ERROR;
   }
@@ -229,8 +1289,25 @@ xbInt16 xbExp::GetDateResult( xbDate &dtResult ){
   }
 }
 /*************************************************************************/
+xbInt16 xbExp::GetDepFlags() const {
+  return iDepFlags;
+}
+/*************************************************************************/
+xbInt16 xbExp::GetFieldDep( xbInt16 iDepNo ) const {
+  if( iDepNo < 0 || iDepNo >= iFieldDepCnt )
+    return -1;
+  return ipFieldDeps[iDepNo];
+}
+/*************************************************************************/
+xbInt16 xbExp::GetFieldDepCnt() const {
+  return iFieldDepCnt;
+}
+/*************************************************************************/
 xbInt16 xbExp::GetBoolResult( xbBool &bResult){
-  if( nTree ){
+  if( bVmResult ){
+    bResult = (xbBool) dReg[iRegCnt-1];
+    return XB_NO_ERROR;
+  } else if( nTree ){
     bResult = nTree->GetBoolResult();
     return XB_NO_ERROR;
   }
@@ -340,7 +1417,10 @@ xbInt16 xbExp::GetNextToken( xbExpToken &t  ){
 
 /*************************************************************************/
 xbInt16 xbExp::GetNumericResult( xbDouble &dResult){
-  if( nTree ){
+  if( bVmResult ){
+    dResult = dReg[iRegCnt-1];
+    return XB_NO_ERROR;
+  } else if( nTree ){
     dResult = nTree->GetNumericResult();
     return XB_NO_ERROR;
   }
@@ -350,6 +1430,13 @@ xbInt16 xbExp::GetNumericResult( xbDouble &dResult){
   }
 }
 /*************************************************************************/
+xbInt16 xbExp::GetRegNo( xbExpNode *n ) const {
+  for( xbInt16 i = 0; i < iRegCnt; i++ )
+    if( npRegNode[i] == n )
+      return i;
+  return -1;
+}
+/*************************************************************************/
 xbInt16 xbExp::GetResultLen() const{
   if( nTree )
     return nTree->GetResultLen();
@@ -364,8 +1451,15 @@ char xbExp::GetReturnType() const{
     return ' ';
 }
 /*************************************************************************/
+xbInt16 xbExp::GetSharedNodeCnt() const {
+  return iSharedCnt;
+}
+/*************************************************************************/
 xbInt16 xbExp::GetStringResult( xbString &sResult){
-  if( nTree ){
+  if( bVmResult ){
+    sResult = cpStrReg[iRegCnt-1];
+    return XB_NO_ERROR;
+  } else if( nTree ){
     sResult = nTree->GetStringResult();
     return XB_NO_ERROR;
   }
@@ -376,7 +1470,12 @@ xbInt16 xbExp::GetStringResult( xbString &sResult){
 }
 /*************************************************************************/
 xbInt16 xbExp::GetStringResult( char * vpResult, xbUInt32 ulLen ){
-  if( nTree ){
+  if( bVmResult ){
+    // copied straight from the register, index keys are built without allocating memory
+    if( cpStrReg[iRegCnt-1] )
+      memcpy( vpResult, cpStrReg[iRegCnt-1], ulpStrLen[iRegCnt-1] < ulLen ? ulpStrLen[iRegCnt-1] : ulLen );
+    return XB_NO_ERROR;
+  } else if( nTree ){
     nTree->GetStringResult().strncpy((char *) vpResult, ulLen );
     return XB_NO_ERROR;
   }
@@ -756,6 +1855,36 @@ xbExpNode *xbExp::GetTreeHandle(){
   return nTree;
 }
 /*************************************************************************/
+xbBool xbExp::HasSideEffects( xbExpNode *n ) const {
+
+  char cNodeType = n->GetNodeType();
+  if( cNodeType == XB_EXP_PRE_OPERATOR || cNodeType == XB_EXP_POST_OPERATOR )
+    return xbTrue;
+  if( cNodeType == XB_EXP_OPERATOR && n->GetOpCode() >= XB_EXP_OPR_ADDASG && n->GetOpCode() <= XB_EXP_OPR_DEC )
+    return xbTrue;
+  for( xbUInt32 i = 0; i < n->GetChildCnt(); i++ )
+    if( HasSideEffects( n->GetChild( i )))
+      return xbTrue;
+  return xbFalse;
+}
+/*************************************************************************/
+xbBool xbExp::IsFieldDep( xbInt16 iFieldNo ) const {
+
+  xbInt16 iLo = 0;
+  xbInt16 iHi = iFieldDepCnt - 1;
+  xbInt16 iMid;
+  while( iLo <= iHi ){
+    iMid = (xbInt16) (( iLo + iHi ) / 2 );
+    if( ipFieldDeps[iMid] == iFieldNo )
+      return xbTrue;
+    else if( ipFieldDeps[iMid] < iFieldNo )
+      iLo = iMid + 1;
+    else
+      iHi = iMid - 1;
+  }
+  return xbFalse;
+}
+/*************************************************************************/
 xbBool xbExp::IsFunction( const xbString & sExpression, char &cReturnType ){
 
   xbInt16 i = 0;
@@ -825,6 +1954,31 @@ char xbExp::IsTokenSeparator( char c ){
       return 0;
 }
 /*************************************************************************/
+xbBool xbExp::IsShareable( xbExpNode *n ) const {
+
+  if( n->GetNodeType() == XB_EXP_CONSTANT || HasSideEffects( n ))
+    return xbFalse;
+  // application functions may not return the same value twice
+  if( n->GetNodeType() == XB_EXP_FUNCTION && ( n->GetOpCode() == 0 || n->GetOpCode() >= XB_EXP_FNC_USER ))
+    return xbFalse;
+  xbExpNode *nChild;
+  for( xbUInt32 i = 0; i < n->GetChildCnt(); i++ ){
+    nChild = n->GetChild( i );
+    if( nChild->GetNodeType() != XB_EXP_CONSTANT && !IsShareable( nChild ))
+      return xbFalse;
+  }
+  return xbTrue;
+}
+/*************************************************************************/
+xbBool xbExp::IsShortCircuit( xbExpNode *n ) const {
+
+  return( n->GetNodeType() == XB_EXP_OPERATOR && n->GetChildCnt() == 2 &&
+          ( n->GetOpCode() == XB_EXP_OPR_AND || n->GetOpCode() == XB_EXP_OPR_OR ) &&
+          n->GetReturnType() == XB_EXP_LOGICAL &&
+          n->GetChild( 0 )->GetReturnType() == XB_EXP_LOGICAL &&
+          n->GetChild( 1 )->GetReturnType() == XB_EXP_LOGICAL );
+}
+/*************************************************************************/
 xbBool xbExp::IsWhiteSpace( char c ){
    return(( c == 0x20 )? 1 : 0 );
 }
@@ -858,12 +2012,33 @@ xbInt16 xbExp::OperatorWeight( const xbString &sOper ){
 }
 /*************************************************************************/
 xbInt16 xbExp::ParseExpression( const xbString &sExpression ){
-  return ParseExpression( sExpression, (xbInt16) 0 );
+  xbInt16 iRc;
+
+  // an expression already parsed against the same table is copied from the cache
+  xbExp *eCached = xbase->GetCachedExpression( dbf, sExpression );
+  if( eCached )
+    return CopyExpression( eCached );
+
+  FreeFieldDeps();
+  if(( iRc = ParseExpression( sExpression, (xbInt16) 0 )) != XB_NO_ERROR )
+    return iRc;
+  if( nTree && ( iRc = FoldConstants( nTree )) != XB_NO_ERROR )
+    return iRc;
+  CompileExpression();       // if it won't compile, the tree is processed instead
+  if(( iRc = SetFieldDeps()) != XB_NO_ERROR )
+    return iRc;
+
+  if( nTree && xbase->GetExpressionCacheSize() > 0 ){
+    xbExp *eNew = new xbExp( xbase, dbf );
+    eNew->CopyExpression( this );
+    xbase->AddCachedExpression( dbf, sExpression, eNew );
+  }
+  return XB_NO_ERROR;
 }
 /*************************************************************************/
 xbInt16 xbExp::ParseExpression( xbDbf *dbf, const xbString &sExpression  ){
   this->dbf = dbf;
-  return ParseExpression( sExpression, (xbInt16) 0 );
+  return ParseExpression( sExpression );
 }
 /*************************************************************************/
 xbInt16 xbExp::ParseExpression( const xbString &sExpression, xbInt16 iWeight ){
@@ -877,8 +2052,11 @@ xbInt16 xbExp::ParseExpression( const xbString &sExpression, xbInt16 iWeight ){
   xbBool     bNewNode = xbFalse;
 
   try {
-    if( nTree )
+    FreeProgram();
+    if( nTree ){
       delete nTree;
+      nTree = NULL;
+    }
 
     if(( iRc = CheckParensAndQuotes( sExpression )) != XB_NO_ERROR ){
       iErrorStop = 100;
@@ -1240,11 +2418,13 @@ xbInt16 xbExp::ParseExpressionFunction( xbExpToken &t, xbExpNode *n, xbInt16 iWe
     char cReturnType;
     xbInt16 i = 0;
     xbInt32 l = 0;
-    if(( iRc = xbase->GetFunctionInfo( sFunc, cReturnType, i, l )) != XB_NO_ERROR ){
+    xbInt16 iFuncNo = 0;
+    if(( iRc = xbase->GetFunctionInfo( sFunc, cReturnType, i, l, iFuncNo )) != XB_NO_ERROR ){
       iErrorStop = 110;
       throw iRc;
     }
     n->SetNodeText( sFunc );
+    n->SetOpCode( iFuncNo );
 
     // Get the function parms
     xbString sParms = t.sToken;
@@ -1380,6 +2560,52 @@ xbInt16 xbExp::ParseExpressionOperator( xbExpToken &t, xbExpNode *n, xbInt16 iWe
   n->SetResult( t.sToken );
   n->SetWeight( iWeight + OperatorWeight( t.sToken) );
 
+  // resolve the operator once here, so processing doesn't need to compare the operator text
+  if( t.sToken == "+" )
+    n->SetOpCode( XB_EXP_OPR_ADD );
+  else if( t.sToken == "-" )
+    n->SetOpCode( XB_EXP_OPR_SUB );
+  else if( t.sToken == "*" )
+    n->SetOpCode( XB_EXP_OPR_MUL );
+  else if( t.sToken == "/" )
+    n->SetOpCode( XB_EXP_OPR_DIV );
+  else if( t.sToken == "^" || t.sToken == "**" )
+    n->SetOpCode( XB_EXP_OPR_POW );
+  else if( t.sToken == "%" )
+    n->SetOpCode( XB_EXP_OPR_MOD );
+  else if( t.sToken == "+=" )
+    n->SetOpCode( XB_EXP_OPR_ADDASG );
+  else if( t.sToken == "-=" )
+    n->SetOpCode( XB_EXP_OPR_SUBASG );
+  else if( t.sToken == "*=" )
+    n->SetOpCode( XB_EXP_OPR_MULASG );
+  else if( t.sToken == "/=" )
+    n->SetOpCode( XB_EXP_OPR_DIVASG );
+  else if( t.sToken == "++" )
+    n->SetOpCode( XB_EXP_OPR_INC );
+  else if( t.sToken == "--" )
+    n->SetOpCode( XB_EXP_OPR_DEC );
+  else if( t.sToken == ".AND." || t.sToken == "AND" )
+    n->SetOpCode( XB_EXP_OPR_AND );
+  else if( t.sToken == ".OR." || t.sToken == "OR" )
+    n->SetOpCode( XB_EXP_OPR_OR );
+  else if( t.sToken == ".NOT." || t.sToken == "NOT" )
+    n->SetOpCode( XB_EXP_OPR_NOT );
+  else if( t.sToken == "=" )
+    n->SetOpCode( XB_EXP_OPR_EQ );
+  else if( t.sToken == "<>" || t.sToken == "#" || t.sToken == "!=" )
+    n->SetOpCode( XB_EXP_OPR_NE );
+  else if( t.sToken == "<" )
+    n->SetOpCode( XB_EXP_OPR_LT );
+  else if( t.sToken == "<=" )
+    n->SetOpCode( XB_EXP_OPR_LE );
+  else if( t.sToken == ">" )
+    n->SetOpCode( XB_EXP_OPR_GT );
+  else if( t.sToken == ">=" )
+    n->SetOpCode( XB_EXP_OPR_GE );
+  else if( t.sToken == "$" )
+    n->SetOpCode( XB_EXP_OPR_CONTAINS );
+
   if( t.sToken == "**" || t.sToken == "^"   ||
       t.sToken == "*"   || t.sToken == "/"   || t.sToken == "%"  || t.sToken == "*="  || t.sToken == "/=" )
     n->SetReturnType( XB_EXP_NUMERIC );
@@ -1409,6 +2635,99 @@ xbInt16 xbExp::ParseExpressionOperator( xbExpToken &t, xbExpNode *n, xbInt16 iWe
   return XB_NO_ERROR;
 }
 /************************************************************************/
+xbInt16 xbExp::PrepareBatch(){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    if( iBatchSts != 0 )
+      return XB_NO_ERROR;
+    iBatchSts = -1;
+    if( !pProgram || !dbf || GetReturnType() == XB_EXP_CHAR )
+      return XB_NO_ERROR;
+
+    // every instruction must give the same answer whether run a record at a time or down a column
+    xbExpInstr *p;
+    char cFieldType;
+    for( xbInt16 i = 0; i < iInstrCnt; i++ ){
+      p = &pProgram[i];
+      switch( p->iOpCode ){
+        case XB_EXPOP_FIELD_C:
+        case XB_EXPOP_FIELD_D:
+        case XB_EXPOP_FIELD_L:
+        case XB_EXPOP_FIELD_N:
+          if( p->n->GetDbf() != dbf )
+            return XB_NO_ERROR;
+          if(( iRc = dbf->GetFieldType( p->n->GetFieldNo(), cFieldType )) != XB_NO_ERROR ){
+            iErrorStop = 100;
+            throw iRc;
+          }
+          if( cFieldType != 'C' && cFieldType != 'D' && cFieldType != 'L' && cFieldType != 'N' && cFieldType != 'F' )
+            return XB_NO_ERROR;
+          break;
+
+        case XB_EXPOP_FUNCTION:
+        case XB_EXPOP_FUNCTION_C:
+          // functions without parameters read the table state, such as RECNO() and DELETED()
+          if( p->iArgCnt == 0 || p->n->GetOpCode() >= XB_EXP_FNC_USER )
+            return XB_NO_ERROR;
+          break;
+
+        case XB_EXPOP_ERROR:
+        case XB_EXPOP_PRE_INC:
+        case XB_EXPOP_PRE_DEC:
+        case XB_EXPOP_POST_INC:
+        case XB_EXPOP_POST_DEC:
+        case XB_EXPOP_ADDASG_N:
+        case XB_EXPOP_SUBASG_N:
+        case XB_EXPOP_MULASG_N:
+        case XB_EXPOP_DIVASG_N:
+          return XB_NO_ERROR;
+
+        default:
+          break;
+      }
+    }
+
+    xbInt32 lSize = (xbInt32) iRegCnt * XB_EXP_BATCH_SIZE;
+    dBatch      = new xbDouble[(size_t) lSize];
+    sBatch      = new xbString[(size_t) lSize];
+    ulpBatchOfs = new xbUInt32[(size_t) iRegCnt];
+    ulpBatchLen = new xbUInt32[(size_t) iRegCnt];
+
+    // constants are the same for every record, copy them down the column once
+    xbInt16 iFieldLen;
+    for( xbInt16 i = 0; i < iRegCnt; i++ ){
+      ulpBatchOfs[i] = 0;
+      ulpBatchLen[i] = 0;
+      if( npRegNode[i]->GetNodeType() == XB_EXP_CONSTANT ){
+        for( xbInt32 l = 0; l < XB_EXP_BATCH_SIZE; l++ ){
+          dBatch[i * XB_EXP_BATCH_SIZE + l] = dReg[i];
+          sBatch[i * XB_EXP_BATCH_SIZE + l] = sReg[i];
+        }
+      } else if( npRegNode[i]->GetNodeType() == XB_EXP_FIELD ){
+        if(( iRc = dbf->GetFieldOffset( npRegNode[i]->GetFieldNo(), ulpBatchOfs[i] )) != XB_NO_ERROR ){
+          iErrorStop = 110;
+          throw iRc;
+        }
+        if(( iRc = dbf->GetFieldLen( npRegNode[i]->GetFieldNo(), iFieldLen )) != XB_NO_ERROR ){
+          iErrorStop = 120;
+          throw iRc;
+        }
+        ulpBatchLen[i] = (xbUInt32) iFieldLen;
+      }
+    }
+    iBatchSts = 1;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbexp::PrepareBatch() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+  }
+  return iRc;
+}
+/************************************************************************/
 xbInt16 xbExp::ProcessExpression(){
   return ProcessExpression( 0 );
 }
@@ -1418,8 +2737,277 @@ xbInt16 xbExp::ProcessExpression( xbInt16 iRecBufSw ){
 // iRecBufSw 0 - Record Buffer
 //           1 - Original Record Buffer
 
+  if( pProgram )
+    return ExecuteProgram( iRecBufSw );
+  else
+    return ProcessExpressionTree( iRecBufSw );
+}
+/************************************************************************/
+xbInt16 xbExp::ProcessExpressionBatch( const char *cpRecs, xbUInt32 ulRecCnt, xbDouble *dpResults ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    if( !GetBatchSupport()){
+      iErrorStop = 100;
+      iRc = XB_INVALID_EXPRESSION;
+      throw iRc;
+    }
+
+    xbUInt32    ulRecLen = dbf->GetRecordLen();
+    xbUInt32    ulDone   = 0;
+    xbUInt32    ulCnt;
+    xbUInt32    ulLen;
+    xbUInt32    l;
+    const char *cpFirst;
+    const char *cp;
+    xbExpInstr *p;
+    xbExpInstr *pEnd = pProgram + iInstrCnt;
+    xbDouble   *dR;
+    xbDouble   *dA;
+    xbDouble   *dB;
+    xbString   *sR;
+    xbString   *sA;
+    xbString   *sB;
+    xbExpNode  *nArg;
+    xbString    sWork1;
+    xbString    sWork2;
+    xbDate      dtWork;
+
+    while( ulDone < ulRecCnt ){
+      ulCnt   = ulRecCnt - ulDone;
+      if( ulCnt > XB_EXP_BATCH_SIZE )
+        ulCnt = XB_EXP_BATCH_SIZE;
+      cpFirst = cpRecs + ulDone * ulRecLen;
+
+      for( p = pProgram; p < pEnd; p++ ){
+        dR = dBatch + p->iReg * XB_EXP_BATCH_SIZE;
+        sR = sBatch + p->iReg * XB_EXP_BATCH_SIZE;
+        dA = ( p->iArgCnt > 0 ) ? dBatch + p->iArg[0] * XB_EXP_BATCH_SIZE : dR;
+        sA = ( p->iArgCnt > 0 ) ? sBatch + p->iArg[0] * XB_EXP_BATCH_SIZE : sR;
+        dB = ( p->iArgCnt > 1 ) ? dBatch + p->iArg[1] * XB_EXP_BATCH_SIZE : dA;
+        sB = ( p->iArgCnt > 1 ) ? sBatch + p->iArg[1] * XB_EXP_BATCH_SIZE : sA;
+        cp = cpFirst + ulpBatchOfs[p->iReg];
+        ulLen = ulpBatchLen[p->iReg];
+
+        switch( p->iOpCode ){
+
+          case XB_EXPOP_FIELD_C:
+            for( l = 0; l < ulCnt; l++, cp += ulRecLen )
+              sR[l].Set( cp, ulLen );
+            break;
+
+          case XB_EXPOP_FIELD_D:
+            for( l = 0; l < ulCnt; l++, cp += ulRecLen ){
+              if( ulLen != 8 )
+                dR[l] = 0;
+              else if( memcmp( cp, "        ", 8 ) == 0 )
+                dR[l] = (xbDouble) XB_NULL_DATE;
+              else
+                dR[l] = (xbDouble) dtWork.JulianDays( cp );
+            }
+            break;
+
+          case XB_EXPOP_FIELD_L:
+            for( l = 0; l < ulCnt; l++, cp += ulRecLen )
+              dR[l] = ( *cp == 'T' || *cp == 't' || *cp == 'Y' || *cp == 'y' ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_FIELD_N:
+            for( l = 0; l < ulCnt; l++, cp += ulRecLen )
+              dR[l] = DecodeNumericField( cp, ulLen );
+            break;
+
+          case XB_EXPOP_ADD_N:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = dA[l] + dB[l];
+            break;
+
+          case XB_EXPOP_SUB_N:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = dA[l] - dB[l];
+            break;
+
+          case XB_EXPOP_MUL_N:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = dA[l] * dB[l];
+            break;
+
+          case XB_EXPOP_DIV_N:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = dA[l] / dB[l];
+            break;
+
+          case XB_EXPOP_POW_N:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = pow( dA[l], dB[l] );
+            break;
+
+          case XB_EXPOP_CAT_C:
+            for( l = 0; l < ulCnt; l++ ){
+              sR[l] = sA[l];
+              sR[l] += sB[l];
+            }
+            break;
+
+          case XB_EXPOP_CATTRIM_C:
+            for( l = 0; l < ulCnt; l++ ){
+              sR[l] = sA[l];
+              sR[l].Rtrim();
+              sR[l] += sB[l];
+              sR[l].PadRight( ' ', p->n->GetResultLen());
+            }
+            break;
+
+          case XB_EXPOP_AND:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( dA[l] != 0 && dB[l] != 0 ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_OR:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( dA[l] != 0 || dB[l] != 0 ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_NOT:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( dA[l] != 0 ) ? 0 : 1;
+            break;
+
+          case XB_EXPOP_AND_SC:
+          case XB_EXPOP_OR_SC:
+            // both operands are evaluated for the whole column, nothing to skip
+            break;
+
+          case XB_EXPOP_EQ_C:
+            for( l = 0; l < ulCnt; l++ ){
+              sWork1 = sA[l];
+              sWork2 = sB[l];
+              sWork1.Rtrim();
+              sWork2.Rtrim();
+              dR[l] = ( sWork1 == sWork2 ) ? 1 : 0;
+            }
+            break;
+
+          case XB_EXPOP_NE_C:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( sA[l] != sB[l] ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_LT_C:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( sA[l] < sB[l] ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_LE_C:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( sA[l] <= sB[l] ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_GT_C:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( sA[l] > sB[l] ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_GE_C:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( sA[l] >= sB[l] ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_CONTAINS_C:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( sB[l].Pos( sA[l] ) > 0 ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_EQ_N:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( dA[l] == dB[l] ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_NE_N:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( dA[l] != dB[l] ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_LT_N:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( dA[l] < dB[l] ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_LE_N:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( dA[l] <= dB[l] ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_GT_N:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( dA[l] > dB[l] ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_GE_N:
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( dA[l] >= dB[l] ) ? 1 : 0;
+            break;
+
+          case XB_EXPOP_EQ_D:
+          case XB_EXPOP_NE_D:
+          case XB_EXPOP_LT_D:
+          case XB_EXPOP_LE_D:
+          case XB_EXPOP_GT_D:
+          case XB_EXPOP_GE_D:
+            // null dates compare as zero, clear them in the result column first then compare in place
+            for( l = 0; l < ulCnt; l++ ) dR[l] = ( dA[l] == XB_NULL_DATE ) ? 0 : dA[l];
+            switch( p->iOpCode ){
+              case XB_EXPOP_EQ_D:
+                for( l = 0; l < ulCnt; l++ ) dR[l] = ( dR[l] == (( dB[l] == XB_NULL_DATE ) ? 0 : dB[l] )) ? 1 : 0;
+                break;
+              case XB_EXPOP_NE_D:
+                for( l = 0; l < ulCnt; l++ ) dR[l] = ( dR[l] != (( dB[l] == XB_NULL_DATE ) ? 0 : dB[l] )) ? 1 : 0;
+                break;
+              case XB_EXPOP_LT_D:
+                for( l = 0; l < ulCnt; l++ ) dR[l] = ( dR[l] <  (( dB[l] == XB_NULL_DATE ) ? 0 : dB[l] )) ? 1 : 0;
+                break;
+              case XB_EXPOP_LE_D:
+                for( l = 0; l < ulCnt; l++ ) dR[l] = ( dR[l] <= (( dB[l] == XB_NULL_DATE ) ? 0 : dB[l] )) ? 1 : 0;
+                break;
+              case XB_EXPOP_GT_D:
+                for( l = 0; l < ulCnt; l++ ) dR[l] = ( dR[l] >  (( dB[l] == XB_NULL_DATE ) ? 0 : dB[l] )) ? 1 : 0;
+                break;
+              default:
+                for( l = 0; l < ulCnt; l++ ) dR[l] = ( dR[l] >= (( dB[l] == XB_NULL_DATE ) ? 0 : dB[l] )) ? 1 : 0;
+                break;
+            }
+            break;
+
+          case XB_EXPOP_FUNCTION:
+          case XB_EXPOP_FUNCTION_C:
+            // functions are run a record at a time, taking their operands from the child nodes
+            for( l = 0; l < ulCnt; l++ ){
+              for( xbInt16 i = 0; i < p->iArgCnt; i++ ){
+                nArg = p->n->GetChild( (xbUInt32) i );
+                if( nArg->GetReturnType() == XB_EXP_CHAR )
+                  nArg->SetResult( sBatch[(xbUInt32) p->iArg[i] * XB_EXP_BATCH_SIZE + l] );
+                else
+                  nArg->SetResult( dBatch[(xbUInt32) p->iArg[i] * XB_EXP_BATCH_SIZE + l] );
+              }
+              if(( iRc = ProcessExpressionFunction( p->n, 0 )) != XB_NO_ERROR ){
+                iErrorStop = 110;
+                throw iRc;
+              }
+              if( p->n->GetReturnType() == XB_EXP_CHAR )
+                sR[l] = p->n->GetStringResult();
+              else
+                dR[l] = p->n->GetNumericResult();
+            }
+            break;
+
+          default:
+            iErrorStop = 120;
+            iRc = XB_PARSE_ERROR;
+            throw iRc;
+            // break;
+        }
+      }
+      memcpy( dpResults + ulDone, dBatch + ( iRegCnt - 1 ) * XB_EXP_BATCH_SIZE, ulCnt * sizeof( xbDouble ));
+      ulDone += ulCnt;
+    }
+  }
+  catch (xbInt16 iRc ){
+    if( bMsgLogging ){
+      xbString sMsg;
+      sMsg.Sprintf( "xbexp::ProcessExpressionBatch() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+      xbase->WriteLogMessage( sMsg.Str() );
+    }
+  }
+  return iRc;
+}
+/************************************************************************/
+xbInt16 xbExp::ProcessExpressionTree( xbInt16 iRecBufSw ){
+
   xbInt16 iRc = XB_NO_ERROR;
   xbInt16 iErrorStop = 0;
+  bVmResult = xbFalse;
 
   try{
     xbExpNode * nWork = GetNextNode( NULL );
@@ -1427,7 +3015,6 @@ xbInt16 xbExp::ProcessExpression( xbInt16 iRecBufSw ){
     xbDbf     * dbf;
     xbString    sWork1;
     xbString    sWork2;
-    xbString    sOperator;
     xbDate      dtWork1;
 
     xbBool      bWork;
@@ -1449,8 +3036,7 @@ xbInt16 xbExp::ProcessExpression( xbInt16 iRecBufSw ){
           //if( nChild1->GetReturnType() == XB_EXP_DATE )
           //    nChild1->SetResult( (xbDouble) nChild1->GetDateResult().JulianDays());
 
-          nWork->GetNodeText( sWork1 );
-          if( sWork1 == "++" )
+          if( nWork->GetOpCode() == XB_EXP_OPR_INC )
             nChild1->SetResult( nChild1->GetNumericResult() + 1 );
           else
             nChild1->SetResult( nChild1->GetNumericResult() - 1 );
@@ -1478,8 +3064,7 @@ xbInt16 xbExp::ProcessExpression( xbInt16 iRecBufSw ){
           //else
           nWork->SetResult( nChild1->GetNumericResult());
 
-          nWork->GetNodeText( sWork1 );
-          if( sWork1 == "++" )
+          if( nWork->GetOpCode() == XB_EXP_OPR_INC )
             nChild1->SetResult( nChild1->GetNumericResult() + 1 );
           else
             nChild1->SetResult( nChild1->GetNumericResult() - 1 );
@@ -1573,7 +3158,7 @@ xbInt16 xbExp::ProcessExpression( xbInt16 iRecBufSw ){
   }
   catch (xbInt16 iRc ){
     xbString sMsg;
-    sMsg.Sprintf( "xbexp::ProcessExpression() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    sMsg.Sprintf( "xbexp::ProcessExpressionTree() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
     xbase->WriteLogMessage( sMsg.Str() );
   }
   return iRc;
@@ -1586,42 +3171,55 @@ xbInt16 xbExp::ProcessExpressionFunction( xbExpNode * n, xbInt16 iRecBufSw ){
 
   try{
 
-    xbString sFunction;
     xbString sResult;
     xbDouble dResult;
     xbDate   dtResult;
     xbBool   bResult;
-
-    n->GetNodeText( sFunction );
+    xbInt16  iFunc = n->GetOpCode();
+
+    // application registered functions
+    if( iFunc >= XB_EXP_FNC_USER ){
+      xbExpFunction pFunc = xbase->GetUserFunction( iFunc );
+      if( !pFunc ){
+        iErrorStop = 10;
+        iRc = XB_INVALID_FUNCTION;
+        throw iRc;
+      }
+      if(( iRc = pFunc( xbase, dbf, n, iRecBufSw )) != XB_NO_ERROR ){
+        iErrorStop = 20;
+        throw iRc;
+      }
+      return XB_NO_ERROR;
+    }
 
     // process functions with no children first
     xbExpNode * nChild1;
     if( n->GetChildCnt() == 0 ){
-      if( sFunction == "DATE" ){
+      if( iFunc == XB_EXP_FNC_DATE ){
         if(( iRc = xbase->DATE( dtResult )) != XB_NO_ERROR ){
           iErrorStop = 100;
           throw iRc;
         }
         n->SetResult( dtResult );
-      } else if( sFunction == "DEL" ){
+      } else if( iFunc == XB_EXP_FNC_DEL ){
         if(( iRc = xbase->DEL( dbf, sResult, iRecBufSw )) != XB_NO_ERROR ){
           iErrorStop = 110;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "DELETED" ){
+      } else if( iFunc == XB_EXP_FNC_DELETED ){
         if(( iRc = xbase->DELETED( dbf, bResult, iRecBufSw )) != XB_NO_ERROR ){
           iErrorStop = 120;
           throw iRc;
         }
         n->SetResult( bResult );
-      } else if( sFunction == "RECCOUNT" ){
+      } else if( iFunc == XB_EXP_FNC_RECCOUNT ){
         if(( iRc = xbase->RECCOUNT( dbf, dResult )) != XB_NO_ERROR ){
           iErrorStop = 130;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "RECNO" ){
+      } else if( iFunc == XB_EXP_FNC_RECNO ){
         if(( iRc = xbase->RECNO( dbf, dResult )) != XB_NO_ERROR ){
           iErrorStop = 140;
           throw iRc;
@@ -1633,58 +3231,58 @@ xbInt16 xbExp::ProcessExpressionFunction( xbExpNode * n, xbInt16 iRecBufSw ){
 
       nChild1 = n->GetChild( 0 );
 
-      if( sFunction == "ABS" ){
+      if( iFunc == XB_EXP_FNC_ABS ){
         if(( iRc = xbase->ABS( nChild1->GetNumericResult(), dResult )) != XB_NO_ERROR ){
           iErrorStop = 200;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "ALLTRIM" ){
+      } else if( iFunc == XB_EXP_FNC_ALLTRIM ){
         if(( iRc = xbase->ALLTRIM( nChild1->GetStringResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 210;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "ASC" ){
+      } else if( iFunc == XB_EXP_FNC_ASC ){
         if(( iRc = xbase->ASC( nChild1->GetStringResult(), dResult )) != XB_NO_ERROR ){
           iErrorStop = 220;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "CDOW" ){
+      } else if( iFunc == XB_EXP_FNC_CDOW ){
         xbDate d( (xbInt32) nChild1->GetNumericResult());
         if(( iRc = xbase->CDOW( d, sResult )) != XB_NO_ERROR ){
           iErrorStop = 230;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "CHR" ){
+      } else if( iFunc == XB_EXP_FNC_CHR ){
         if(( iRc = xbase->CHR( nChild1->GetNumericResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 240;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "CMONTH" ){
+      } else if( iFunc == XB_EXP_FNC_CMONTH ){
         xbDate d( (xbInt32) nChild1->GetNumericResult());
         if(( iRc = xbase->CMONTH( d, sResult )) != XB_NO_ERROR ){
           iErrorStop = 250;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "CTOD" ){
+      } else if( iFunc == XB_EXP_FNC_CTOD ){
         if(( iRc = xbase->CTOD( nChild1->GetStringResult(), dtResult )) != XB_NO_ERROR ){
           iErrorStop = 260;
           throw iRc;
         }
         n->SetResult( dtResult );
-      } else if( sFunction == "DAY" ){
+      } else if( iFunc == XB_EXP_FNC_DAY ){
         xbDate d( (xbInt32) nChild1->GetNumericResult());
         if(( iRc = xbase->DAY( d, dResult )) != XB_NO_ERROR ){
           iErrorStop = 270;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "DESCEND" ){
+      } else if( iFunc == XB_EXP_FNC_DESCEND ){
 
         if( n->GetReturnType() == XB_EXP_CHAR ){
            if(( iRc = xbase->DESCEND( nChild1->GetStringResult(), sResult )) != XB_NO_ERROR ){
@@ -1714,137 +3312,137 @@ xbInt16 xbExp::ProcessExpressionFunction( xbExpNode * n, xbInt16 iRecBufSw ){
            throw iRc;
         }
 
-      } else if( sFunction == "DOW" ){
+      } else if( iFunc == XB_EXP_FNC_DOW ){
         xbDate d( (xbInt32) nChild1->GetNumericResult());
         if(( iRc = xbase->DOW( d, dResult )) != XB_NO_ERROR ){
           iErrorStop = 320;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "DTOC" ){
+      } else if( iFunc == XB_EXP_FNC_DTOC ){
         xbDate d( (xbInt32) nChild1->GetNumericResult());
         if(( iRc = xbase->DTOC( d, sResult )) != XB_NO_ERROR ){
           iErrorStop = 330;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "DTOS" ){
+      } else if( iFunc == XB_EXP_FNC_DTOS ){
         xbDate d( (xbInt32) nChild1->GetNumericResult());
         if(( iRc = xbase->DTOS( d, sResult )) != XB_NO_ERROR ){
           iErrorStop = 340;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "EXP" ){
+      } else if( iFunc == XB_EXP_FNC_EXP ){
         if(( iRc = xbase->EXP( nChild1->GetNumericResult(), dResult )) != XB_NO_ERROR ){
           iErrorStop = 350;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "INT" ){
+      } else if( iFunc == XB_EXP_FNC_INT ){
         if(( iRc = xbase->INT( nChild1->GetNumericResult(), dResult )) != XB_NO_ERROR ){
           iErrorStop = 360;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "ISALPHA" ){
+      } else if( iFunc == XB_EXP_FNC_ISALPHA ){
         if(( iRc = xbase->ISALPHA( nChild1->GetStringResult(), bResult )) != XB_NO_ERROR ){
           iErrorStop = 370;
           throw iRc;
         }
         n->SetResult( bResult );
-      } else if( sFunction == "ISLOWER" ){
+      } else if( iFunc == XB_EXP_FNC_ISLOWER ){
         if(( iRc = xbase->ISLOWER( nChild1->GetStringResult(), bResult )) != XB_NO_ERROR ){
           iErrorStop = 380;
           throw iRc;
         }
         n->SetResult( bResult );
-      } else if( sFunction == "ISUPPER" ){
+      } else if( iFunc == XB_EXP_FNC_ISUPPER ){
         if(( iRc = xbase->ISUPPER( nChild1->GetStringResult(), bResult )) != XB_NO_ERROR ){
           iErrorStop = 390;
           throw iRc;
         }
         n->SetResult( bResult );
-      } else if( sFunction == "LEN" ){
+      } else if( iFunc == XB_EXP_FNC_LEN ){
         if(( iRc = xbase->LEN( nChild1->GetStringResult(), dResult )) != XB_NO_ERROR ){
           iErrorStop = 400;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "LOG" ){
+      } else if( iFunc == XB_EXP_FNC_LOG ){
         if(( iRc = xbase->LOG( nChild1->GetNumericResult(), dResult )) != XB_NO_ERROR ){
           iErrorStop = 410;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "LTRIM" ){
+      } else if( iFunc == XB_EXP_FNC_LTRIM ){
         if(( iRc = xbase->LTRIM( nChild1->GetStringResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 420;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "LOWER" ){
+      } else if( iFunc == XB_EXP_FNC_LOWER ){
         if(( iRc = xbase->LOWER( nChild1->GetStringResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 430;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "MONTH" ){
+      } else if( iFunc == XB_EXP_FNC_MONTH ){
         xbDate d( (xbInt32) nChild1->GetNumericResult());
         if(( iRc = xbase->MONTH( d, dResult )) != XB_NO_ERROR ){
           iErrorStop = 440;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "RTRIM" ){
+      } else if( iFunc == XB_EXP_FNC_RTRIM ){
         if(( iRc = xbase->RTRIM( nChild1->GetStringResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 450;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "STOD" ){
+      } else if( iFunc == XB_EXP_FNC_STOD ){
         if(( iRc = xbase->STOD( nChild1->GetStringResult(), dtResult )) != XB_NO_ERROR ){
           iErrorStop = 460;
           throw iRc;
         }
         n->SetResult( dtResult );
-      } else if( sFunction == "SPACE" ){
+      } else if( iFunc == XB_EXP_FNC_SPACE ){
         if(( iRc = xbase->SPACE( (xbInt32) nChild1->GetNumericResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 470;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "SQRT" ){
+      } else if( iFunc == XB_EXP_FNC_SQRT ){
         if(( iRc = xbase->SQRT( nChild1->GetNumericResult(), dResult )) != XB_NO_ERROR ){
           iErrorStop = 480;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "STR" ){
+      } else if( iFunc == XB_EXP_FNC_STR ){
         if(( iRc = xbase->STR( nChild1->GetNumericResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 490;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "TRIM" ){
+      } else if( iFunc == XB_EXP_FNC_TRIM ){
         if(( iRc = xbase->TRIM( nChild1->GetStringResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 500;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "UPPER" ){
+      } else if( iFunc == XB_EXP_FNC_UPPER ){
         if(( iRc = xbase->UPPER( nChild1->GetStringResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 510;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "VAL" ){
+      } else if( iFunc == XB_EXP_FNC_VAL ){
         if(( iRc = xbase->VAL( nChild1->GetStringResult(), dResult )) != XB_NO_ERROR ){
           iErrorStop = 520;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "YEAR" ){
+      } else if( iFunc == XB_EXP_FNC_YEAR ){
         xbDate d( (xbInt32) nChild1->GetNumericResult());
         if(( iRc = xbase->YEAR( d, dResult )) != XB_NO_ERROR ){
           iErrorStop = 530;
@@ -1861,44 +3459,44 @@ xbInt16 xbExp::ProcessExpressionFunction( xbExpNode * n, xbInt16 iRecBufSw ){
       nChild1 = n->GetChild( 0 );
       nChild2 = n->GetChild( 1 );
 
-      if( sFunction == "AT" ){
+      if( iFunc == XB_EXP_FNC_AT ){
         if(( iRc = xbase->AT( nChild1->GetStringResult(), nChild2->GetStringResult(), dResult )) != XB_NO_ERROR ){
           iErrorStop = 700;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "LEFT" ){
+      } else if( iFunc == XB_EXP_FNC_LEFT ){
         if(( iRc = xbase->LEFT( nChild1->GetStringResult(), (xbUInt32) nChild2->GetNumericResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 710;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "MAX" ){
+      } else if( iFunc == XB_EXP_FNC_MAX ){
         if(( iRc = xbase->MAX( nChild1->GetNumericResult(), nChild2->GetNumericResult(), dResult )) != XB_NO_ERROR ){
           iErrorStop = 720;
           throw iRc;
         }
         n->SetResult( dResult );
-      } else if( sFunction == "MIN" ){
+      } else if( iFunc == XB_EXP_FNC_MIN ){
         if(( iRc = xbase->MIN( nChild1->GetNumericResult(), nChild2->GetNumericResult(), dResult )) != XB_NO_ERROR ){
           iErrorStop = 730;
           throw iRc;
         }
         n->SetResult( dResult );
       }
-      else if( sFunction == "REPLICATE" ){
+      else if( iFunc == XB_EXP_FNC_REPLICATE ){
         if(( iRc = xbase->REPLICATE( nChild1->GetStringResult(), (xbUInt32) nChild2->GetNumericResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 800;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "RIGHT" ){
+      } else if( iFunc == XB_EXP_FNC_RIGHT ){
         if(( iRc = xbase->RIGHT( nChild1->GetStringResult(), (xbUInt32) nChild2->GetNumericResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 810;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "STR" ){
+      } else if( iFunc == XB_EXP_FNC_STR ){
         if(( iRc = xbase->STR( nChild1->GetNumericResult(), (xbUInt32) nChild2->GetNumericResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 820;
           throw iRc;
@@ -1916,25 +3514,25 @@ xbInt16 xbExp::ProcessExpressionFunction( xbExpNode * n, xbInt16 iRecBufSw ){
       nChild2 = n->GetChild( 1 );
       nChild3 = n->GetChild( 2 );
 
-      if( sFunction == "IIF" ){
+      if( iFunc == XB_EXP_FNC_IIF ){
         if(( iRc = xbase->IIF( nChild1->GetBoolResult(), nChild2->GetStringResult(), nChild3->GetStringResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 900;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "STR" ){
+      } else if( iFunc == XB_EXP_FNC_STR ){
         if(( iRc = xbase->STR( nChild1->GetNumericResult(), (xbUInt32) nChild2->GetNumericResult(), (xbUInt32) nChild3->GetNumericResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 910;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "STRZERO" ){
+      } else if( iFunc == XB_EXP_FNC_STRZERO ){
         if(( iRc = xbase->STRZERO( nChild1->GetNumericResult(), (xbUInt32) nChild2->GetNumericResult(), (xbUInt32) nChild3->GetNumericResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 920;
           throw iRc;
         }
         n->SetResult( sResult );
-      } else if( sFunction == "SUBSTR" ){
+      } else if( iFunc == XB_EXP_FNC_SUBSTR ){
         if(( iRc = xbase->SUBSTR( nChild1->GetStringResult(), (xbUInt32) nChild2->GetNumericResult(), (xbUInt32) nChild3->GetNumericResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 930;
           throw iRc;
@@ -1954,7 +3552,7 @@ xbInt16 xbExp::ProcessExpressionFunction( xbExpNode * n, xbInt16 iRecBufSw ){
       nChild3 = n->GetChild( 2 );
       nChild4 = n->GetChild( 3 );
 
-      if( sFunction == "STR" ){
+      if( iFunc == XB_EXP_FNC_STR ){
         if(( iRc = xbase->STR( nChild1->GetNumericResult(), (xbUInt32) nChild2->GetNumericResult(), 
                                (xbUInt32) nChild3->GetNumericResult(), nChild4->GetStringResult(), sResult )) != XB_NO_ERROR ){
           iErrorStop = 1000;
@@ -1975,9 +3573,11 @@ xbInt16 xbExp::ProcessExpressionFunction( xbExpNode * n, xbInt16 iRecBufSw ){
 
   }
   catch (xbInt16 iRc ){
-    xbString sMsg;
-    sMsg.Sprintf( "xbexp::ProcessExpressionFunction() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
-    xbase->WriteLogMessage( sMsg.Str() );
+    if( bMsgLogging ){
+      xbString sMsg;
+      sMsg.Sprintf( "xbexp::ProcessExpressionFunction() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+      xbase->WriteLogMessage( sMsg.Str() );
+    }
   }
   return iRc;
 }
@@ -1989,7 +3589,6 @@ xbInt16 xbExp::ProcessExpressionOperator( xbExpNode * n ){
 
   xbExpNode * nChild1 = NULL;
   xbExpNode * nChild2 = NULL;
-  xbString    sOperator;
   xbString    sWork1;
   xbString    sWork2;
   xbDate      dtWork1;
@@ -1997,18 +3596,18 @@ xbInt16 xbExp::ProcessExpressionOperator( xbExpNode * n ){
   xbString sMsg;
 
   try{
-    n->GetNodeText( sOperator );
+    xbInt16 iOp = n->GetOpCode();
     nChild1 = n->GetChild( 0 );
     if( !n->IsUnaryOperator())
       nChild2 = n->GetChild( 1 );
 
     switch( n->GetReturnType()){
       case XB_EXP_CHAR:
-        if( sOperator == "+" ){
+        if( iOp == XB_EXP_OPR_ADD ){
           sWork1 = nChild1->GetStringResult();
           sWork1 += nChild2->GetStringResult();
           n->SetResult( sWork1 );
-        } else if( sOperator == "-" ){
+        } else if( iOp == XB_EXP_OPR_SUB ){
           sWork1 = nChild1->GetStringResult();
           sWork1.Rtrim();
           sWork1 += nChild2->GetStringResult();
@@ -2022,31 +3621,31 @@ xbInt16 xbExp::ProcessExpressionOperator( xbExpNode * n ){
         break;
 
       case XB_EXP_NUMERIC:
-        if( sOperator == "+" )
+        if( iOp == XB_EXP_OPR_ADD )
           n->SetResult( nChild1->GetNumericResult() + nChild2->GetNumericResult());
-        else if( sOperator == "-" ){
+        else if( iOp == XB_EXP_OPR_SUB ){
           n->SetResult( nChild1->GetNumericResult() - nChild2->GetNumericResult());
 
         }
-        else if( sOperator == "*" )
+        else if( iOp == XB_EXP_OPR_MUL )
           n->SetResult( nChild1->GetNumericResult() * nChild2->GetNumericResult());
-        else if( sOperator == "/" )
+        else if( iOp == XB_EXP_OPR_DIV )
           n->SetResult( nChild1->GetNumericResult() / nChild2->GetNumericResult());
-        else if( sOperator == "^" || sOperator == "**" )
+        else if( iOp == XB_EXP_OPR_POW )
           n->SetResult( pow( nChild1->GetNumericResult(), nChild2->GetNumericResult()));
-        else if( sOperator == "+=" ){
+        else if( iOp == XB_EXP_OPR_ADDASG ){
           n->SetResult( nChild1->GetNumericResult() + nChild2->GetNumericResult());
           nChild1->SetResult( n->GetNumericResult() );
         }
-        else if( sOperator == "-=" ){
+        else if( iOp == XB_EXP_OPR_SUBASG ){
           n->SetResult( nChild1->GetNumericResult() - nChild2->GetNumericResult());
           nChild1->SetResult( n->GetNumericResult() );
         }
-        else if( sOperator == "*=" ){
+        else if( iOp == XB_EXP_OPR_MULASG ){
           n->SetResult( nChild1->GetNumericResult() * nChild2->GetNumericResult());
           nChild1->SetResult( n->GetNumericResult() );
         }
-        else if( sOperator == "/=" ){
+        else if( iOp == XB_EXP_OPR_DIVASG ){
           n->SetResult( nChild1->GetNumericResult() / nChild2->GetNumericResult());
           nChild1->SetResult( n->GetNumericResult() );
         } else {
@@ -2059,17 +3658,17 @@ xbInt16 xbExp::ProcessExpressionOperator( xbExpNode * n ){
       case XB_EXP_DATE:
         // if date values in the leaf nodes, convert to numeric for operator logic
 
-        if( sOperator == "+" )
+        if( iOp == XB_EXP_OPR_ADD )
           n->SetResult( nChild1->GetNumericResult() + nChild2->GetNumericResult());
-        else if( sOperator == "-" ){
+        else if( iOp == XB_EXP_OPR_SUB ){
           n->SetResult( nChild1->GetNumericResult() - nChild2->GetNumericResult());
           xbDate d( (xbInt32) n->GetNumericResult());
         }
-        else if( sOperator == "+=" ){
+        else if( iOp == XB_EXP_OPR_ADDASG ){
           n->SetResult( nChild1->GetNumericResult() + nChild2->GetNumericResult());
           nChild1->SetResult( n->GetNumericResult() );
         }
-        else if( sOperator == "-=" ){
+        else if( iOp == XB_EXP_OPR_SUBASG ){
           n->SetResult( nChild1->GetNumericResult() - nChild2->GetNumericResult());
           nChild1->SetResult( n->GetNumericResult() );
         } else {
@@ -2087,20 +3686,20 @@ xbInt16 xbExp::ProcessExpressionOperator( xbExpNode * n ){
             throw iRc;
         }
 
-        if( sOperator == ".AND." || sOperator == "AND" )
+        if( iOp == XB_EXP_OPR_AND )
           n->SetResult((xbBool) (nChild1->GetBoolResult() && nChild2->GetBoolResult()) );
 
-        else if( sOperator == ".OR." || sOperator == "OR" )
+        else if( iOp == XB_EXP_OPR_OR )
           n->SetResult((xbBool) (nChild1->GetBoolResult() || nChild2->GetBoolResult()) );
 
-        else if( sOperator == ".NOT." || sOperator == "NOT" ){
+        else if( iOp == XB_EXP_OPR_NOT ){
           if( nChild1->GetBoolResult())
             n->SetResult((xbBool) xbFalse );
           else
             n->SetResult((xbBool) xbTrue );
         }
 
-        else if( sOperator == ">" ){
+        else if( iOp == XB_EXP_OPR_GT ){
 
           if( nChild1->GetReturnType() == XB_EXP_CHAR )
             n->SetResult((xbBool)(nChild1->GetStringResult() > nChild2->GetStringResult()));
@@ -2123,7 +3722,7 @@ xbInt16 xbExp::ProcessExpressionOperator( xbExpNode * n ){
           }
         }
 
-        else if( sOperator == ">=" ){
+        else if( iOp == XB_EXP_OPR_GE ){
           if( nChild1->GetReturnType() == XB_EXP_CHAR )
             n->SetResult((xbBool)(nChild1->GetStringResult() >= nChild2->GetStringResult()));
 
@@ -2145,7 +3744,7 @@ xbInt16 xbExp::ProcessExpressionOperator( xbExpNode * n ){
           }
         }
 
-        else if( sOperator == "<" ){
+        else if( iOp == XB_EXP_OPR_LT ){
 
           if( nChild1->GetReturnType() == XB_EXP_CHAR ){
             n->SetResult((xbBool)( nChild1->GetStringResult() < nChild2->GetStringResult()));
@@ -2170,7 +3769,7 @@ xbInt16 xbExp::ProcessExpressionOperator( xbExpNode * n ){
           }
         }
 
-        else if( sOperator == "<=" ){
+        else if( iOp == XB_EXP_OPR_LE ){
 
           if( nChild1->GetReturnType() == XB_EXP_CHAR )
             n->SetResult((xbBool)( nChild1->GetStringResult() <= nChild2->GetStringResult()));
@@ -2193,7 +3792,7 @@ xbInt16 xbExp::ProcessExpressionOperator( xbExpNode * n ){
           }
         }
 
-        else if( sOperator == "<>" || sOperator == "#" || sOperator == "!=" ){
+        else if( iOp == XB_EXP_OPR_NE ){
 
           if( nChild1->GetReturnType() == XB_EXP_CHAR )
             n->SetResult((xbBool)( nChild1->GetStringResult() != nChild2->GetStringResult()));
@@ -2216,7 +3815,7 @@ xbInt16 xbExp::ProcessExpressionOperator( xbExpNode * n ){
           }
         }
 
-        else if( sOperator == "$" ){
+        else if( iOp == XB_EXP_OPR_CONTAINS ){
           if( nChild1->GetReturnType() == XB_EXP_CHAR )
             if( nChild2->GetStringResult().Pos( nChild1->GetStringResult()) > 0 )
               n->SetResult((xbBool) xbTrue );
@@ -2229,7 +3828,7 @@ xbInt16 xbExp::ProcessExpressionOperator( xbExpNode * n ){
           }
         }
 
-        else if( sOperator == "=" ){
+        else if( iOp == XB_EXP_OPR_EQ ){
 
           if( nChild1->GetReturnType() == XB_EXP_CHAR ){
             xbString sChld1 = nChild1->GetStringResult();
@@ -2277,7 +3876,79 @@ xbInt16 xbExp::ProcessExpressionOperator( xbExpNode * n ){
   }
   return iRc;
 }
+/*************************************************************************/
+char *xbExp::ReserveStrReg( xbInt16 iReg, xbUInt32 ulLen ){
+
+  if( ulLen > ulpStrCap[iReg] || !cpStrReg[iReg] ){
+    char *cpNew = (char *) realloc( cpStrReg[iReg], ulLen + 1 );
+    if( !cpNew )
+      return NULL;
+    cpStrReg[iReg]  = cpNew;
+    ulpStrCap[iReg] = ulLen;
+  }
+  return cpStrReg[iReg];
+}
+/*************************************************************************/
+void xbExp::SetMsgLogging( xbBool bMsgLogging ){
+  this->bMsgLogging = bMsgLogging;
+}
+/*************************************************************************/
+xbInt16 xbExp::SetFieldDeps(){
 
+  FreeFieldDeps();
+  if( !nTree )
+    return XB_NO_ERROR;
+
+  xbExpNode *n;
+  xbInt16   iNodeCnt = 0;
+  for( n = GetNextNode( NULL ); n; n = GetNextNode( n ))
+    if( n->GetNodeType() == XB_EXP_FIELD )
+      iNodeCnt++;
+
+  if( iNodeCnt > 0 && ( ipFieldDeps = (xbInt16 *) malloc( (size_t) iNodeCnt * sizeof( xbInt16 ))) == NULL )
+    return XB_NO_MEMORY;
+
+  xbInt16 iFieldNo;
+  xbInt16 i;
+  for( n = GetNextNode( NULL ); n; n = GetNextNode( n )){
+    if( n->GetNodeType() == XB_EXP_FIELD ){
+      if( n->GetDbf() != dbf ){
+        iDepFlags |= XB_EXP_DEP_EXTERNAL;
+        continue;
+      }
+      // insertion sort, expressions only reference a handful of fields
+      iFieldNo = n->GetFieldNo();
+      if( IsFieldDep( iFieldNo ))
+        continue;
+      for( i = iFieldDepCnt; i > 0 && ipFieldDeps[i-1] > iFieldNo; i-- )
+        ipFieldDeps[i] = ipFieldDeps[i-1];
+      ipFieldDeps[i] = iFieldNo;
+      iFieldDepCnt++;
+
+    } else if( n->GetNodeType() == XB_EXP_FUNCTION ){
+      switch( n->GetOpCode()){
+        case XB_EXP_FNC_RECNO:
+          iDepFlags |= XB_EXP_DEP_RECNO;
+          break;
+        case XB_EXP_FNC_DEL:
+        case XB_EXP_FNC_DELETED:
+          iDepFlags |= XB_EXP_DEP_DELETED;
+          break;
+        case XB_EXP_FNC_DATE:
+          iDepFlags |= XB_EXP_DEP_DATE;
+          break;
+        case XB_EXP_FNC_RECCOUNT:
+          iDepFlags |= XB_EXP_DEP_EXTERNAL;
+          break;
+        default:
+          if( n->GetOpCode() >= XB_EXP_FNC_USER || n->GetOpCode() == 0 )
+            iDepFlags |= XB_EXP_DEP_EXTERNAL;
+          break;
+      }
+    }
+  }
+  return XB_NO_ERROR;
+}
 /*************************************************************************/
 };     // namespace
 #endif     // XB_EXPRESSION_SUPPORT
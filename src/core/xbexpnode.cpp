@@ -28,6 +28,7 @@ xbExpNode::xbExpNode(){
   iFieldNo       = 0;
   ulResultLen    = 0;
   iWeight        = 0;
+  iOpCode        = 0;
   nParent        = NULL;
   dbf            = NULL;
 }
@@ -40,6 +41,7 @@ xbExpNode::xbExpNode( xbString &sNodeText, char cReturnType, char cNodeType ){
   iFieldNo          = 0;
   ulResultLen       = 0;
   iWeight           = 0;
+  iOpCode           = 0;
   nParent           = NULL;
   dbf               = NULL;
 }
@@ -52,6 +54,7 @@ xbExpNode::xbExpNode( xbString &sNodeText, char cNodeType ){
   iFieldNo          = 0;
   ulResultLen       = 0;
   iWeight           = 0;
+  iOpCode           = 0;
   nParent           = NULL;
   dbf               = NULL;
 }
@@ -63,6 +66,7 @@ xbExpNode::xbExpNode( char cNodeType ){
   iFieldNo          = 0;
   ulResultLen       = 0;
   iWeight           = 0;
+  iOpCode           = 0;
   nParent           = NULL;
   dbf               = NULL;
 }
@@ -80,6 +84,23 @@ xbInt16 xbExpNode::AddChild( xbExpNode *n ){
   return llChildren.InsertAtEnd( n );
 }
 /************************************************************************/
+xbExpNode *xbExpNode::Clone() const {
+  xbExpNode *n   = new xbExpNode();
+  n->sNodeText   = sNodeText;
+  n->cReturnType = cReturnType;
+  n->cNodeType   = cNodeType;
+  n->sResult     = sResult;
+  n->dResult     = dResult;
+  n->dbf         = dbf;
+  n->iFieldNo    = iFieldNo;
+  n->ulResultLen = ulResultLen;
+  n->iOpCode     = iOpCode;
+  n->iWeight     = iWeight;
+  for( xbUInt32 i = 0; i < GetChildCnt(); i++ )
+    n->AddChild( GetChild( i )->Clone());
+  return n;
+}
+/************************************************************************/
 #ifdef XB_DEBUG_SUPPORT
 void xbExpNode::DumpNode( xbInt16 iOption ) const {
   xbString sMsg;
@@ -195,6 +216,10 @@ xbDouble xbExpNode::GetNumericResult() const {
   return dResult;
 }
 /************************************************************************/
+xbInt16 xbExpNode::GetOpCode() const {
+  return iOpCode;
+}
+/************************************************************************/
 xbExpNode *xbExpNode::GetParent() const{
   return nParent;
 }
@@ -244,6 +269,31 @@ xbBool xbExpNode::HasRightSibling() const {
     return xbFalse;
 }
 /*************************************************************************/
+xbBool xbExpNode::IsEqual( const xbExpNode *n ) const {
+
+  if( !n || n->cNodeType != cNodeType || n->cReturnType != cReturnType || n->iOpCode != iOpCode )
+    return xbFalse;
+  if( cNodeType == XB_EXP_FIELD && ( n->dbf != dbf || n->iFieldNo != iFieldNo ))
+    return xbFalse;
+  if( cNodeType == XB_EXP_CONSTANT ){
+    if( cReturnType == XB_EXP_CHAR ){
+      if( n->sResult != sResult )
+        return xbFalse;
+    } else if( n->dResult != dResult ){
+      return xbFalse;
+    }
+  }
+  // operators and functions without a resolved code are told apart by their text
+  if(( cNodeType == XB_EXP_OPERATOR || cNodeType == XB_EXP_FUNCTION ) && iOpCode == 0 && n->sNodeText != sNodeText )
+    return xbFalse;
+  if( n->GetChildCnt() != GetChildCnt())
+    return xbFalse;
+  for( xbUInt32 i = 0; i < GetChildCnt(); i++ )
+    if( !GetChild( i )->IsEqual( n->GetChild( i )))
+      return xbFalse;
+  return xbTrue;
+}
+/*************************************************************************/
 xbBool xbExpNode::IsOperator() const {
 
   if( cNodeType == XB_EXP_OPERATOR )
@@ -256,17 +306,52 @@ xbBool xbExpNode::IsUnaryOperator() const {
 
   if( cNodeType == XB_EXP_PRE_OPERATOR || cNodeType == XB_EXP_POST_OPERATOR )
     return xbTrue;
-  else if( cNodeType == XB_EXP_OPERATOR && (sNodeText == ".NOT." || sNodeText == "NOT" ))
+  else if( cNodeType == XB_EXP_OPERATOR && iOpCode == XB_EXP_OPR_NOT )
+    return xbTrue;
+  else if( cNodeType == XB_EXP_OPERATOR && iOpCode == 0 && (sNodeText == ".NOT." || sNodeText == "NOT" ))
     return xbTrue;
   else
     return xbFalse;
 }
 /************************************************************************/
+xbInt16 xbExpNode::RemoveChild( xbExpNode *n ){
+  xbInt16 iRc;
+  if(( iRc = llChildren.RemoveByVal( n )) != XB_NO_ERROR )
+    return iRc;
+  n->SetParent( NULL );
+  return XB_NO_ERROR;
+}
+/************************************************************************/
 void xbExpNode::RemoveLastChild(){
   xbExpNode *n;
   llChildren.RemoveFromEnd( n );
 }
 /************************************************************************/
+xbInt16 xbExpNode::ReplaceChild( xbExpNode *nOld, xbExpNode *nNew ){
+
+  // rebuild the child list in the same order, with the new node in place of the old one
+  xbLinkList<xbExpNode *> llWork;
+  xbExpNode *n;
+  xbBool bFound = xbFalse;
+  while( llChildren.GetNodeCnt() > 0 ){
+    llChildren.RemoveFromFront( n );
+    if( n == nOld ){
+      n = nNew;
+      bFound = xbTrue;
+    }
+    llWork.InsertAtEnd( n );
+  }
+  while( llWork.GetNodeCnt() > 0 ){
+    llWork.RemoveFromFront( n );
+    llChildren.InsertAtEnd( n );
+  }
+  if( !bFound )
+    return XB_NOT_FOUND;
+  nOld->SetParent( NULL );
+  nNew->SetParent( this );
+  return XB_NO_ERROR;
+}
+/************************************************************************/
 void xbExpNode::SetDbfInfo( xbDbf *dbf, xbInt16 iFieldNo ){
   this->dbf      = dbf;
   this->iFieldNo = iFieldNo;
@@ -285,6 +370,10 @@ void xbExpNode::SetNodeType( char cNodeType ){
   this->cNodeType = cNodeType;
 }
 /************************************************************************/
+void xbExpNode::SetOpCode( xbInt16 iOpCode ){
+  this->iOpCode = iOpCode;
+}
+/************************************************************************/
 void xbExpNode::SetParent( xbExpNode *n ){
   this->nParent = n;
 }
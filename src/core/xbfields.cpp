@@ -111,6 +111,14 @@ xbInt16 xbDbf::GetFieldLen( xbInt16 iFieldNo, xbInt16 &iFieldLen ) const {
     return XB_INVALID_FIELD_NO;
 }
 /************************************************************************/
+xbInt16 xbDbf::GetFieldOffset( xbInt16 iFieldNo, xbUInt32 &ulOffset ) const {
+  if( iFieldNo >= 0 && iFieldNo < iNoOfFields ){
+    ulOffset = (xbUInt32) ( SchemaPtr[iFieldNo].pAddress - RecBuf );
+    return XB_NO_ERROR;
+  } else
+    return XB_INVALID_FIELD_NO;
+}
+/************************************************************************/
 xbInt16 xbDbf::GetFieldNo( const xbString & sFieldName, xbInt16 &iFieldNo ) const
 {
   int i;
@@ -27,6 +27,12 @@ xbFile::xbFile( xbXBase * x ){
   bFileOpen    = xbFalse;
   ulBlockSize  = 0;
   iFileNo      = 0;
+  cpMemBuf     = NULL;
+  stMemAlloc   = 0;
+  stMemLen     = 0;
+  stMemPos     = 0;
+  ullMemLimit  = 0;
+  bMemResident = xbFalse;
   xbase        = x;
   if( xbase->GetMultiUser() == xbTrue )
     iShareMode = XB_MULTI_USER;
@@ -44,6 +50,8 @@ xbFile::xbFile( xbXBase * x ){
 xbFile::~xbFile(){
   if( bFileOpen )
     xbFclose();
+  if( cpMemBuf )
+    free( cpMemBuf );
 }
 /************************************************************************/
 xbInt16 xbFile::CreateUniqueFileName( const xbString & sDirIn, const xbString & sExtIn, xbString &sFqnOut, xbInt16 iOption ){
@@ -331,6 +339,10 @@ xbInt16 xbFile::GetFileExtPart( xbString & sFileNameExtOut ) const {
 }
 /************************************************************************/
 xbInt16 xbFile::GetFileMtime( time_t &mtime ){
+  if( bMemResident ){     // never written to disk, can't be changed by another process
+    mtime = 0;
+    return XB_NO_ERROR;
+  }
   struct stat buffer;
   if( stat( sFqFileName.Str(), &buffer ))
     return XB_FILE_NOT_FOUND;
@@ -396,6 +408,10 @@ FILE * xbFile::GetFp(){
   return fp;
 }
 /************************************************************************/
+xbBool xbFile::GetMemoryResident() const {
+  return bMemResident;
+}
+/************************************************************************/
 xbInt16 xbFile::GetOpenMode() const {
   return iOpenMode;
 }
@@ -467,6 +483,114 @@ xbInt16  xbFile::GetXbaseFileTypeByte( const xbString &sFileName, xbInt16 &iVers
   return GetXbaseFileTypeByte( sFileName, cFileTypeByte, iVersion );
 }
 /************************************************************************/
+xbInt16 xbFile::MemReserve( size_t stNewLen ){
+
+  // grow the memory buffer to hold at least stNewLen bytes
+  if( stNewLen <= stMemAlloc )
+    return XB_NO_ERROR;
+
+  size_t stNewAlloc = stMemAlloc ? stMemAlloc : 8192;
+  while( stNewAlloc < stNewLen )
+    stNewAlloc <<= 1;
+  if( stNewAlloc > ullMemLimit && stNewLen <= ullMemLimit )
+    stNewAlloc = (size_t) ullMemLimit;
+
+  char *cpNewBuf;
+  if(( cpNewBuf = (char *) realloc( cpMemBuf, stNewAlloc )) == NULL )
+    return XB_NO_MEMORY;
+  cpMemBuf   = cpNewBuf;
+  stMemAlloc = stNewAlloc;
+  return XB_NO_ERROR;
+}
+/************************************************************************/
+xbInt16 xbFile::MemSpill(){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    // another memory resident file may have been given the same temporary name and spilled first
+    if( FileExists()){
+      xbString sDir;
+      xbString sExt;
+      xbString sNewName;
+      GetFileDirPart( sDir );
+      GetFileExtPart( sExt );
+      if(( iRc = CreateUniqueFileName( sDir, sExt, sNewName )) != XB_NO_ERROR ){
+        iErrorStop = 100;
+        throw iRc;
+      }
+      SetFileName( sNewName );
+    }
+
+    if(( fp = fopen( sFqFileName.Str(), "w+b" )) == NULL ){
+      iErrorStop = 110;
+      iRc = XB_OPEN_ERROR;
+      throw iRc;
+    }
+    #ifdef HAVE__FILENO_F
+    iFileNo = _fileno( fp );
+    #else
+    iFileNo = fileno( fp );
+    #endif
+    #ifdef HAVE_SETENDOFFILE_F
+    fHandle = (HANDLE) _get_osfhandle( iFileNo );
+    #endif
+    bMemResident = xbFalse;
+
+    if(( iRc = xbSetVbuf( iShareMode )) != XB_NO_ERROR ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+    if( stMemLen > 0 && fwrite( cpMemBuf, stMemLen, 1, fp ) != 1 ){
+      iErrorStop = 130;
+      iRc = XB_WRITE_ERROR;
+      throw iRc;
+    }
+    if(( iRc = xbFseek( (xbInt64) stMemPos, SEEK_SET )) != XB_NO_ERROR ){
+      iErrorStop = 140;
+      throw iRc;
+    }
+    free( cpMemBuf );
+    cpMemBuf   = NULL;
+    stMemAlloc = 0;
+    stMemLen   = 0;
+    stMemPos   = 0;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbFile::MemSpill() Exception Caught. Error Stop = [%d] iRc = [%d] File = [%s]", iErrorStop, iRc, sFqFileName.Str() );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/************************************************************************/
+xbInt16 xbFile::MemWrite( const void *p, size_t stLen ){
+
+  xbInt16 iRc;
+  size_t stNewLen = stMemPos + stLen;
+
+  if( stNewLen > ullMemLimit ){
+    if(( iRc = MemSpill()) != XB_NO_ERROR )
+      return iRc;
+    if( fwrite( p, stLen, 1, fp ) != 1 )
+      return XB_WRITE_ERROR;
+    return XB_NO_ERROR;
+  }
+  if(( iRc = MemReserve( stNewLen )) != XB_NO_ERROR )
+    return iRc;
+
+  // writing past the end leaves a gap, fill it with zeros the same as a disk file
+  if( stMemPos > stMemLen )
+    memset( cpMemBuf + stMemLen, 0x00, stMemPos - stMemLen );
+  memcpy( cpMemBuf + stMemPos, p, stLen );
+  stMemPos += stLen;
+  if( stMemPos > stMemLen )
+    stMemLen = stMemPos;
+  return XB_NO_ERROR;
+}
+/************************************************************************/
 xbInt16 xbFile::NameSuffixMissing( const xbString & sFileName, xbInt16 iOption ) const {
   xbUInt32 ulLen = sFileName.Len();
   if( ulLen <= 4 )
@@ -598,6 +722,10 @@ void xbFile::SetFileName( const xbString & sFileName ){
   #endif
 }
 /************************************************************************/
+void xbFile::SetMemoryResident( xbUInt64 ullMemLimit ){
+  this->ullMemLimit = ullMemLimit;
+}
+/************************************************************************/
 void xbFile::SetFqFileName( const xbString & sFqFileName ){
   this->sFqFileName  = sFqFileName;
   xbString sDir;
@@ -755,6 +883,15 @@ xbInt16 xbFile::WriteBlock( xbUInt32 ulBlockNo, size_t lWriteSize, void * buf ){
 /************************************************************************/
 xbInt16 xbFile::xbFclose(){
   int iRc = 0;
+  if( bFileOpen && bMemResident ){
+    free( cpMemBuf );
+    cpMemBuf   = NULL;
+    stMemAlloc = 0;
+    stMemLen   = 0;
+    stMemPos   = 0;
+    bFileOpen  = xbFalse;
+    return XB_NO_ERROR;
+  }
   if( bFileOpen ){
     iRc = fclose( fp );
     if( iRc != 0 ){
@@ -774,10 +911,14 @@ xbInt16 xbFile::xbFclose(){
 }
 /************************************************************************/
 xbInt16 xbFile::xbFeof(){
+  if( bMemResident )
+    return stMemPos >= stMemLen;
   return feof( fp );
 }
 /************************************************************************/
 xbInt16 xbFile::xbFflush() {
+  if( bMemResident )
+    return XB_NO_ERROR;
   if( fflush( fp ) )
     return XB_WRITE_ERROR;
   else
@@ -785,6 +926,12 @@ xbInt16 xbFile::xbFflush() {
 }
 /************************************************************************/
 xbInt16 xbFile::xbFgetc( char &c ) {
+  if( bMemResident ){
+    if( stMemPos >= stMemLen )
+      return XB_EOF;
+    c = cpMemBuf[stMemPos++];
+    return XB_NO_ERROR;
+  }
   int i;
   i = fgetc( fp );
   if( i == EOF )
@@ -795,6 +942,12 @@ xbInt16 xbFile::xbFgetc( char &c ) {
 }
 /************************************************************************/
 xbInt16 xbFile::xbFgetc( xbInt32 &c ) {
+  if( bMemResident ){
+    if( stMemPos >= stMemLen )
+      return XB_EOF;
+    c = (unsigned char) cpMemBuf[stMemPos++];
+    return XB_NO_ERROR;
+  }
   int i;
   i = fgetc( fp );
   if( i == EOF )
@@ -805,6 +958,17 @@ xbInt16 xbFile::xbFgetc( xbInt32 &c ) {
 /************************************************************************/
 xbInt16 xbFile::xbFgets( size_t lSize, xbString &s ) {
   s = "";
+  if( bMemResident ){
+    if( stMemPos >= stMemLen )
+      return XB_EOF;
+    size_t stStart = stMemPos;
+    while( stMemPos < stMemLen && stMemPos - stStart + 1 < lSize ){
+      if( cpMemBuf[stMemPos++] == '\n' )
+        break;
+    }
+    s.Set( cpMemBuf + stStart, (xbUInt32) (stMemPos - stStart));
+    return XB_NO_ERROR;
+  }
   if( feof( fp ))
     return XB_EOF;
   char *sBuf = (char *) malloc( lSize + 1 );
@@ -830,6 +994,18 @@ xbInt16 xbFile::xbFopen( const xbString & sOpenMode, xbInt16 iMultiUser ) {
 
   try{
 
+    // new files can be held in memory, existing files are always opened from disk
+    bMemResident = xbFalse;
+    if( ullMemLimit > 0 && sOpenMode[1] == 'w' ){
+      iOpenMode    = XB_READ_WRITE;
+      bFileOpen    = xbTrue;
+      bMemResident = xbTrue;
+      this->iShareMode = iMultiUser;
+      stMemLen     = 0;
+      stMemPos     = 0;
+      return XB_NO_ERROR;
+    }
+
     #ifdef HAVE__FSOPEN_F
     if(( fp = _fsopen( sFqFileName.Str(), sOpenMode.Str(), 0x40 )) != NULL ){
     #else
@@ -900,6 +1076,14 @@ xbInt16 xbFile::xbFputc( xbInt32 c ) {
 }
 /************************************************************************/
 xbInt16 xbFile::xbFputc( xbInt32 c, xbInt32 iNoOfTimes ) {
+  if( bMemResident ){
+    char cc = (char) c;
+    xbInt16 iRc;
+    for( xbInt32 l = 0; l < iNoOfTimes; l++ )
+      if(( iRc = xbFwrite( &cc, 1, 1 )) != XB_NO_ERROR )
+        return iRc;
+    return XB_NO_ERROR;
+  }
   for( xbInt32 l = 0; l < iNoOfTimes; l++ )
     if( fputc( c, fp ) != (int) c )
       return XB_WRITE_ERROR;
@@ -907,6 +1091,8 @@ xbInt16 xbFile::xbFputc( xbInt32 c, xbInt32 iNoOfTimes ) {
 }
 /************************************************************************/
 xbInt16 xbFile::xbFputs( const xbString & s ){
+  if( bMemResident )
+    return xbFwrite( s.Str(), s.Len(), 1 );
   if( fputs( s.Str(), fp ) < 0 )
     return XB_WRITE_ERROR;
   else
@@ -920,7 +1106,18 @@ xbInt16 xbFile::xbFread( void *p, size_t size, size_t nmemb ) {
   size_t  stRc = 0;
 
   try {
-    stRc = fread( p, size, nmemb, fp );
+    if( bMemResident ){
+      // same as fread, a short read is an error and the position moves past the data read
+      size_t stAvail = stMemPos < stMemLen ? stMemLen - stMemPos : 0;
+      size_t stWant  = size * nmemb;
+      size_t stCopy  = stWant < stAvail ? stWant : stAvail;
+      if( stCopy > 0 )
+        memcpy( p, cpMemBuf + stMemPos, stCopy );
+      stMemPos += stCopy;
+      stRc = size ? stCopy / size : 0;
+    } else {
+      stRc = fread( p, size, nmemb, fp );
+    }
     if( stRc != nmemb ){
       iRc = XB_READ_ERROR;
       iErrorStop = 100;
@@ -941,6 +1138,20 @@ xbInt16 xbFile::xbFseek( xbInt64 llOffset, xbInt32 iWhence ) {
   xbInt16 iErrorStop = 0;
   xbInt16 iRc2;
   try {
+    if( bMemResident ){
+      xbInt64 llNewPos = llOffset;
+      if( iWhence == SEEK_CUR )
+        llNewPos += (xbInt64) stMemPos;
+      else if( iWhence == SEEK_END )
+        llNewPos += (xbInt64) stMemLen;
+      if( llNewPos < 0 ){
+        iRc2 = XB_SEEK_ERROR;
+        iErrorStop = 90;
+        throw iRc2;
+      }
+      stMemPos = (size_t) llNewPos;
+      return XB_NO_ERROR;
+    }
     #if defined(HAVE_FSEEKO_F)
     iRc = fseeko( fp, llOffset, iWhence );
     if( iRc != 0 ){
@@ -992,6 +1203,8 @@ xbInt16 xbFile::xbFseek( xbInt64 llOffset, xbInt32 iWhence ) {
 }
 /************************************************************************/
 size_t xbFile::xbFtell() {
+  if( bMemResident )
+    return stMemPos;
   return (size_t) ftell( fp );
 }
 
@@ -1041,6 +1254,8 @@ void xbFile::xbFTurnOffFileBuffering() {
 /************************************************************************/
 xbInt16 xbFile::xbFwrite( const void *p, size_t size, size_t nmemb ) {
 
+  if( bMemResident )
+    return MemWrite( p, size * nmemb );
   size_t iRc;
   iRc = fwrite( p, size, nmemb, fp );
   if( iRc == nmemb )
@@ -1079,6 +1294,8 @@ xbInt16 xbFile::xbReadUntil( const char cDelim, xbString &sOut ){
 
 /************************************************************************/
 xbInt16 xbFile::xbRemove() {
+  if( bMemResident )      // never written to disk
+    return XB_NO_ERROR;
   return xbRemove( sFqFileName.Str(), 0 );
 }
 /************************************************************************/
@@ -1112,6 +1329,10 @@ xbInt16 xbFile::xbRename( const xbString & sOldName, const xbString & sNewName )
 }
 /************************************************************************/
 void xbFile::xbRewind() {
+  if( bMemResident ){
+    stMemPos = 0;
+    return;
+  }
   rewind( fp );
 }
 /************************************************************************/
@@ -1119,6 +1340,29 @@ xbInt16 xbFile::xbTruncate( xbInt64 llSize ) {
   xbInt16 iRc = 0;
   xbInt16 iErrorStop = 0;
   try{
+    if( bMemResident ){
+      if( llSize < 0 ){
+        iErrorStop = 90;
+        iRc = XB_WRITE_ERROR;
+        throw iRc;
+      }
+      if( (xbUInt64) llSize > ullMemLimit ){
+        if(( iRc = MemSpill()) != XB_NO_ERROR ){
+          iErrorStop = 95;
+          throw iRc;
+        }
+        return xbTruncate( llSize );
+      }
+      if( (size_t) llSize > stMemLen ){
+        if(( iRc = MemReserve( (size_t) llSize )) != XB_NO_ERROR ){
+          iErrorStop = 96;
+          throw iRc;
+        }
+        memset( cpMemBuf + stMemLen, 0x00, (size_t) llSize - stMemLen );
+      }
+      stMemLen = (size_t) llSize;
+      return XB_NO_ERROR;
+    }
     #ifdef HAVE_FTRUNCATE_F
     if(( iRc = ftruncate( iFileNo, llSize )) != 0 ){
       iErrorStop = 100;
@@ -1170,6 +1414,8 @@ xbInt16 xbFile::xbLock( xbInt16 iFunction, xbInt64 lOffset, size_t stLen ){
   xbInt16 iRc = 0;
   xbInt16 iErrorStop = 0;
   xbInt16 iTries = 0;
+  if( bMemResident )     // not visible to other processes, nothing to lock
+    return XB_NO_ERROR;
   try{
     #ifdef HAVE_FCNTL_F
       /* Unix lock function, Mac OS doesn't work very well, problematic */
@@ -20,6 +20,13 @@ This module handles uda (user data area) methods
 
 #ifdef XB_FILTER_SUPPORT
 
+#ifdef XB_PARALLEL_SUPPORT
+#include <atomic>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#endif  // XB_PARALLEL_SUPPORT
+
 namespace xb{
 
 /************************************************************************/
@@ -29,23 +36,67 @@ xbFilter::xbFilter( xbDbf *dbf ) {
   lLimit       = 0;       // max number of responses
   lCurQryCnt   = 0;       // current number, this query  + = moving fwd
                           //                             - = moving backwards
+  bMaterialize   = xbFalse;
+  bBitmapSts     = xbFalse;
+  ulBitmapSeq    = 0;
+  ulBitmapRecCnt = 0;
 
   #ifdef XB_INDEX_SUPPORT
   pIx          = NULL;    // if index is set, the class uses the index tag, otherwise table
   vpTag        = NULL;
+  ulpRangeRecs  = NULL;
+  ulRangeSize   = 0;
+  ulRangeRecCnt = 0;
+  bRangeSts     = xbFalse;
+  cRangeMode     = 'A';
+  pRangeModeIx   = NULL;
+  vpRangeModeTag = NULL;
   #endif  // XB_INDEX_SUPPORT
 
+  #ifdef XB_BLOCKREAD_SUPPORT
+  dpBatch         = NULL;
+  ulBatchSize     = 0;
+  ulBatchFirstRec = 0;
+  ulBatchRecCnt   = 0;
+  #endif  // XB_BLOCKREAD_SUPPORT
+
+  #ifdef XB_PARALLEL_SUPPORT
+  iParThreadCnt = 1;
+  bParOrdered   = xbTrue;
+  ulpParRecs    = NULL;
+  ulParRecCnt   = 0;
+  lParPos       = -1;
+  iParDirection = 1;
+  bParSts       = xbFalse;
+  #endif  // XB_PARALLEL_SUPPORT
+
 }
 /************************************************************************/
 xbFilter::~xbFilter() {
   if( exp )
     delete exp;
+  #ifdef XB_INDEX_SUPPORT
+  if( ulpRangeRecs )
+    free( ulpRangeRecs );
+  #endif  // XB_INDEX_SUPPORT
+  #ifdef XB_BLOCKREAD_SUPPORT
+  if( dpBatch )
+    free( dpBatch );
+  #endif  // XB_BLOCKREAD_SUPPORT
+  #ifdef XB_PARALLEL_SUPPORT
+  if( ulpParRecs )
+    free( ulpParRecs );
+  #endif  // XB_PARALLEL_SUPPORT
 }
 /************************************************************************/
 xbInt32 xbFilter::GetLimit() const {
   return lLimit;
 }
 /************************************************************************/
+xbBool xbFilter::GetMaterialize() const {
+  return bMaterialize;
+}
+/************************************************************************/
 xbInt32 xbFilter::GetQryCnt() const {
   return lCurQryCnt;
 }
@@ -58,6 +109,28 @@ void xbFilter::ResetQryCnt(){
   this->lCurQryCnt = 0;
 }
 /************************************************************************/
+void xbFilter::SetMaterialize( xbBool bMaterialize ){
+  this->bMaterialize = bMaterialize;
+  bBitmapSts = xbFalse;
+  bmMatch.Clear();
+  bmDeleted.Clear();
+}
+/************************************************************************/
+#ifdef XB_PARALLEL_SUPPORT
+xbBool xbFilter::GetParallelStatus() const {
+  return bParSts;
+}
+/************************************************************************/
+xbInt16 xbFilter::SetParallel( xbInt16 iThreadCnt, xbBool bOrdered ){
+  if( iThreadCnt < 0 )
+    return XB_INVALID_OPTION;
+  iParThreadCnt = iThreadCnt;
+  bParOrdered   = bOrdered;
+  bParSts       = xbFalse;
+  return XB_NO_ERROR;
+}
+#endif  // XB_PARALLEL_SUPPORT
+/************************************************************************/
 xbInt16 xbFilter::Set( const xbString &sFilter, xbIx *pIx, void *vpTag ) {
   this->pIx   = pIx;
   this->vpTag = vpTag;
@@ -95,6 +168,18 @@ xbInt16 xbFilter::Set( const xbString &sFilter ) {
 
     if( exp )
       delete exp;
+    bBitmapSts    = xbFalse;
+    #ifdef XB_INDEX_SUPPORT
+    bRangeSts     = xbFalse;
+    ulRangeRecCnt = 0;
+    #endif  // XB_INDEX_SUPPORT
+    #ifdef XB_BLOCKREAD_SUPPORT
+    ulBatchRecCnt = 0;
+    #endif  // XB_BLOCKREAD_SUPPORT
+    #ifdef XB_PARALLEL_SUPPORT
+    bParSts       = xbFalse;
+    sFilterExp    = sFilter;
+    #endif  // XB_PARALLEL_SUPPORT
 
     exp = new xbExp( dbf->GetXbasePtr(), dbf );
     if(( iRc = exp->ParseExpression( sFilter.Str() )) != XB_NO_ERROR ){
@@ -122,6 +207,19 @@ xbInt16 xbFilter::Set( const xbString &sFilter ) {
   return iRc;
 }
 /************************************************************************/
+xbInt16 xbFilter::SetIxRange( char cRangeMode, xbIx *pIx, void *vpTag ){
+
+  if( cRangeMode != 'A' && cRangeMode != 'N' && cRangeMode != 'T' )
+    return XB_INVALID_OPTION;
+  if( cRangeMode == 'T' && ( !pIx || !vpTag ))
+    return XB_INVALID_TAG;
+
+  this->cRangeMode = cRangeMode;
+  pRangeModeIx     = ( cRangeMode == 'T' ) ? pIx   : NULL;
+  vpRangeModeTag   = ( cRangeMode == 'T' ) ? vpTag : NULL;
+  return XB_NO_ERROR;
+}
+/************************************************************************/
 xbInt16 xbFilter::SetIxTag( xbIx *pIx, void *vpTag ) {
   this->pIx   = pIx;
   this->vpTag = vpTag;
@@ -158,6 +256,75 @@ xbInt16 xbFilter::GetFirstRecord( xbInt16 iOption ) {
       throw iRc;
     }
     lCurQryCnt = 0;
+    #ifdef XB_PARALLEL_SUPPORT
+    bParSts = xbFalse;
+    #endif  // XB_PARALLEL_SUPPORT
+
+    if( bMaterialize ){
+      if(( iRc = RefreshBitmap()) != XB_NO_ERROR ){
+        iErrorStop = 101;
+        throw iRc;
+      }
+      if( GetBitmapStatus()){
+        if(( iRc = GetNextBitmapRecord( 1, 1, iOption )) != XB_NO_ERROR ){
+          if( iRc == XB_EOF )
+            return iRc;
+          iErrorStop = 103;
+          throw iRc;
+        }
+        lCurQryCnt++;
+        return iRc;
+      }
+    }
+
+    #ifdef XB_INDEX_SUPPORT
+    if(( iRc = BuildIxRange()) != XB_NO_ERROR ){
+      iErrorStop = 102;
+      throw iRc;
+    }
+    if( bRangeSts ){
+      if(( iRc = GetNextIxRangeRecord( 1, 1, iOption )) != XB_NO_ERROR ){
+        if( iRc == XB_EOF )
+          return iRc;
+        iErrorStop = 104;
+        throw iRc;
+      }
+      lCurQryCnt++;
+      return iRc;
+    }
+    #endif  // XB_INDEX_SUPPORT
+
+    #ifdef XB_PARALLEL_SUPPORT
+    if(( iRc = RunParScan( 1, iOption )) != XB_NO_ERROR ){
+      iErrorStop = 106;
+      throw iRc;
+    }
+    if( bParSts ){
+      if(( iRc = GetNextParRecord( 1, iOption )) != XB_NO_ERROR ){
+        if( iRc == XB_EOF )
+          return iRc;
+        iErrorStop = 107;
+        throw iRc;
+      }
+      lCurQryCnt++;
+      return iRc;
+    }
+    #endif  // XB_PARALLEL_SUPPORT
+
+    #ifdef XB_BLOCKREAD_SUPPORT
+    if( GetBatchStatus()){
+      ulBatchRecCnt = 0;
+      if(( iRc = GetNextBatchRecord( 1, iOption )) != XB_NO_ERROR ){
+        if( iRc == XB_EMPTY || iRc == XB_EOF )
+          return iRc;
+        iErrorStop = 105;
+        throw iRc;
+      }
+      lCurQryCnt++;
+      return iRc;
+    }
+    #endif  // XB_BLOCKREAD_SUPPORT
+
     if(( iRc = dbf->GetFirstRecord( iOption )) != XB_NO_ERROR ){
       if( iRc == XB_EMPTY || iRc == XB_EOF )
         return iRc;
@@ -210,6 +377,63 @@ xbInt16 xbFilter::GetNextRecord( xbInt16 iOption ){
     if( lLimit != 0 && abs( lCurQryCnt ) >= lLimit )
       return XB_LIMIT_REACHED;
 
+    if( bMaterialize ){
+      xbUInt32 ulRecNo = dbf->GetCurRecNo();
+      if(( iRc = RefreshBitmap()) != XB_NO_ERROR ){
+        iErrorStop = 101;
+        throw iRc;
+      }
+      if( GetBitmapStatus()){
+        if(( iRc = GetNextBitmapRecord( ulRecNo + 1, 1, iOption )) != XB_NO_ERROR ){
+          if( iRc == XB_EOF )
+            return iRc;
+          iErrorStop = 103;
+          throw iRc;
+        }
+        lCurQryCnt++;
+        return iRc;
+      }
+    }
+
+    #ifdef XB_INDEX_SUPPORT
+    if( bRangeSts ){
+      if(( iRc = GetNextIxRangeRecord( dbf->GetCurRecNo() + 1, 1, iOption )) != XB_NO_ERROR ){
+        if( iRc == XB_EOF )
+          return iRc;
+        iErrorStop = 104;
+        throw iRc;
+      }
+      lCurQryCnt++;
+      return iRc;
+    }
+    #endif  // XB_INDEX_SUPPORT
+
+    #ifdef XB_PARALLEL_SUPPORT
+    if( bParSts ){
+      if(( iRc = GetNextParRecord( 1, iOption )) != XB_NO_ERROR ){
+        if( iRc == XB_EOF )
+          return iRc;
+        iErrorStop = 107;
+        throw iRc;
+      }
+      lCurQryCnt++;
+      return iRc;
+    }
+    #endif  // XB_PARALLEL_SUPPORT
+
+    #ifdef XB_BLOCKREAD_SUPPORT
+    if( GetBatchStatus()){
+      if(( iRc = GetNextBatchRecord( dbf->GetCurRecNo() + 1, iOption )) != XB_NO_ERROR ){
+        if( iRc == XB_EMPTY || iRc == XB_EOF )
+          return XB_EOF;
+        iErrorStop = 105;
+        throw iRc;
+      }
+      lCurQryCnt++;
+      return iRc;
+    }
+    #endif  // XB_BLOCKREAD_SUPPORT
+
     if(( iRc = dbf->GetNextRecord( iOption )) != XB_NO_ERROR ){
       if( iRc == XB_EOF )
         return iRc;
@@ -250,70 +474,1627 @@ xbInt16 xbFilter::GetNextRecord( xbInt16 iOption ){
   return iRc;
 }
 /************************************************************************/
-xbInt16 xbFilter::GetPrevRecord( xbInt16 iOption ){ 
+//! @brief Build the bitmap of matching records.
+/*!
+  @private
+  The table is read with the regular first / next logic, so the index key range and
+  block read paths are used when they are available.
+
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbFilter::BuildBitmap(){
 
   xbInt16 iRc = XB_NO_ERROR;
   xbInt16 iErrorStop = 0;
   try{
-
-    if( !exp ){
+    xbUInt32 ulRecCnt;
+    if(( iRc = dbf->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
       iErrorStop = 100;
       throw iRc;
     }
-    if( lLimit != 0 && abs( lCurQryCnt ) >= lLimit )
-      return XB_LIMIT_REACHED;
+    xbUInt32 ulSeq     = dbf->GetChangeSeq();
+    xbUInt32 ulSaveRec = dbf->GetCurRecNo();
+    xbInt32  lSaveLim  = lLimit;
+    xbInt32  lSaveCnt  = lCurQryCnt;
 
-    if(( iRc = dbf->GetPrevRecord( iOption )) != XB_NO_ERROR ){
-      if( iRc == XB_BOF )
-        return iRc;
-      else{
-        iErrorStop = 110;
+    bBitmapSts = xbFalse;
+    bmMatch.Clear();
+    bmDeleted.Clear();
+
+    // switch off the bitmap and the limit while the table is read
+    bMaterialize = xbFalse;
+    lLimit       = 0;
+    iRc = GetFirstRecord( XB_ALL_RECS );
+    while( iRc == XB_NO_ERROR ){
+      if(( iRc = bmMatch.Set( dbf->GetCurRecNo())) == XB_NO_ERROR && dbf->RecordDeleted())
+        iRc = bmDeleted.Set( dbf->GetCurRecNo());
+      if( iRc == XB_NO_ERROR )
+        iRc = GetNextRecord( XB_ALL_RECS );
+    }
+    bMaterialize = xbTrue;
+    lLimit       = lSaveLim;
+    lCurQryCnt   = lSaveCnt;
+    #ifdef XB_INDEX_SUPPORT
+    bRangeSts    = xbFalse;
+    #endif  // XB_INDEX_SUPPORT
+
+    if( iRc != XB_EOF && iRc != XB_EMPTY ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    iRc = XB_NO_ERROR;
+    if( ulSaveRec != 0 && ulSaveRec <= ulRecCnt && ulSaveRec != dbf->GetCurRecNo()){
+      if(( iRc = dbf->GetRecord( ulSaveRec )) != XB_NO_ERROR ){
+        iErrorStop = 120;
         throw iRc;
       }
     }
-    xbBool bFound = xbFalse;
-    while( !bFound && iRc == XB_NO_ERROR ){
-      if(( iRc = exp->ProcessExpression()) != XB_NO_ERROR ){
+    ulBitmapSeq    = ulSeq;
+    ulBitmapRecCnt = ulRecCnt;
+    bBitmapSts     = xbTrue;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbFilter::BuildBitmap() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    dbf->GetXbasePtr()->WriteLogMessage( sMsg.Str() );
+    dbf->GetXbasePtr()->WriteLogMessage( dbf->GetXbasePtr()->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/************************************************************************/
+xbInt16 xbFilter::Count( xbUInt32 &ulCount, xbInt16 iOption ){
+  return CountRecords( ulCount, iOption, 0 );
+}
+/************************************************************************/
+//! @brief Count the filtered records.
+/*!
+  @private
+  Records are read through a private block reader where the filter allows it, so the
+  record buffer and the table position are not touched.  Otherwise the records are read
+  into the record buffer and the current record is restored afterwards, a table with no
+  current record is left blank.  Index ranges leave the tag on the key it was on.  A current
+  record with pending updates is rejected, reading another record would commit or discard them.
+
+  @param ulCount Output - Number of matching records.
+  @param iOption XB_ALL_RECS, XB_ACTIVE_RECS or XB_DELETED_RECS
+  @param ulMax Stop counting at this many records, zero for no maximum.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbFilter::CountRecords( xbUInt32 &ulCount, xbInt16 iOption, xbUInt32 ulMax ){
+
+  xbInt16  iRc = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbUInt32 ulSaveRec = dbf->GetCurRecNo();
+  xbUInt32 ulRecCnt  = 0;
+  xbBool   bMoved    = xbFalse;
+
+  #ifdef XB_INDEX_SUPPORT
+  xbBool   bSaveRangeSts = bRangeSts;
+  #endif  // XB_INDEX_SUPPORT
+
+  #ifdef XB_BLOCKREAD_SUPPORT
+  xbBlockRead rb( dbf );
+  xbDouble *dpResults = NULL;
+  #endif  // XB_BLOCKREAD_SUPPORT
+
+  ulCount = 0;
+  try{
+    if( !exp ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_EXPRESSION;
+      throw iRc;
+    }
+    if( dbf->GetDbfStatus() == XB_UPDATED )
+      return XB_INVALID_RECORD;
+    if(( iRc = dbf->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+
+    if( bMaterialize && ulRecCnt > 0 ){
+      if(( iRc = RefreshBitmap()) != XB_NO_ERROR ){
         iErrorStop = 120;
         throw iRc;
       }
-      if(( iRc = exp->GetBoolResult( bFound )) != XB_NO_ERROR ){
+      if( GetBitmapStatus()){
+        if( iOption == XB_ALL_RECS )
+          ulCount = bmMatch.GetCount();
+        else if( iOption == XB_DELETED_RECS )
+          ulCount = bmDeleted.GetCount();
+        else
+          ulCount = bmMatch.GetCount() - bmDeleted.GetCount();
+        if( ulMax && ulCount > ulMax )
+          ulCount = ulMax;
+        ulRecCnt = 0;
+      }
+    }
+
+    #ifdef XB_BLOCKREAD_SUPPORT
+    // a DELETED() filter only needs the deleted flag, other filters need batch support to skip the record buffer
+    xbInt16  iDelOpt  = GetDeletedFilterOption();
+    xbBool   bBlock   = ( iDelOpt != XB_ALL_RECS || exp->GetBatchSupport()) ? xbTrue : xbFalse;
+    xbUInt32 ulRecLen = dbf->GetRecordLen();
+    xbUInt32 ulResFirst = 0;
+    xbUInt32 ulResCnt   = 0;
+    xbUInt32 ulRow;
+    xbDouble d;
+    const char *cp;
+
+    if( iDelOpt != XB_ALL_RECS && iOption != XB_ALL_RECS && iOption != iDelOpt )
+      ulRecCnt = 0;
+    if( bBlock && ulRecCnt > 0 ){
+      if(( iRc = rb.Init()) != XB_NO_ERROR ){
         iErrorStop = 130;
         throw iRc;
       }
-      if( !bFound ){
-        if(( iRc = dbf->GetPrevRecord( iOption )) != XB_NO_ERROR ){
-          if( iRc == XB_BOF ){
-            return iRc;
-          } else {
-            iErrorStop = 140;
+      if( iDelOpt == XB_ALL_RECS ){
+        if(( dpResults = (xbDouble *) malloc(( rb.GetBlockSize() / ulRecLen ) * sizeof( xbDouble ))) == NULL ){
+          iErrorStop = 140;
+          iRc = XB_NO_MEMORY;
+          throw iRc;
+        }
+      }
+    }
+    #endif  // XB_BLOCKREAD_SUPPORT
+
+    xbBool bRange = xbFalse;
+    #ifdef XB_INDEX_SUPPORT
+    if( ulRecCnt > 0 ){
+      if(( iRc = BuildIxRange()) != XB_NO_ERROR ){
+        iErrorStop = 150;
+        throw iRc;
+      }
+      bRange = bRangeSts;
+    }
+    #endif  // XB_INDEX_SUPPORT
+
+    xbUInt32 ulPos = 0;
+    xbUInt32 ulRecNo;
+    xbBool   bFound;
+    while( ulRecCnt > 0 && ( ulMax == 0 || ulCount < ulMax )){
+
+      // next candidate record
+      #ifdef XB_INDEX_SUPPORT
+      if( bRange ){
+        if( ulPos >= ulRangeRecCnt )
+          break;
+        ulRecNo = ulpRangeRecs[ulPos++];
+        if( ulRecNo > ulRecCnt )
+          continue;
+      } else
+      #endif  // XB_INDEX_SUPPORT
+      {
+        if( ulPos >= ulRecCnt )
+          break;
+        ulRecNo = ++ulPos;
+      }
+
+      #ifdef XB_BLOCKREAD_SUPPORT
+      if( bBlock ){
+        if(( iRc = rb.LoadBlockForRecNo( ulRecNo )) != XB_NO_ERROR ){
+          iErrorStop = 160;
+          throw iRc;
+        }
+        ulRow = ulRecNo - rb.GetBlockFirstRecNo();
+        cp    = rb.GetBlockBuf() + ulRow * ulRecLen;
+        if(( iOption == XB_ACTIVE_RECS && *cp == '*' ) || ( iOption == XB_DELETED_RECS && *cp != '*' ))
+          continue;
+
+        if( iDelOpt != XB_ALL_RECS ){
+          bFound = (( *cp == '*' ) == ( iDelOpt == XB_DELETED_RECS )) ? xbTrue : xbFalse;
+        } else if( bRange ){
+          if(( iRc = exp->ProcessExpressionBatch( cp, 1, &d )) != XB_NO_ERROR ){
+            iErrorStop = 170;
             throw iRc;
           }
+          bFound = ( d != 0 ) ? xbTrue : xbFalse;
+        } else {
+          // whole table, evaluate a block at a time
+          if( ulResCnt == 0 || ulResFirst != rb.GetBlockFirstRecNo()){
+            if(( iRc = exp->ProcessExpressionBatch( rb.GetBlockBuf(), rb.GetBlockRecCnt(), dpResults )) != XB_NO_ERROR ){
+              iErrorStop = 180;
+              throw iRc;
+            }
+            ulResFirst = rb.GetBlockFirstRecNo();
+            ulResCnt   = rb.GetBlockRecCnt();
+          }
+          bFound = ( dpResults[ulRow] != 0 ) ? xbTrue : xbFalse;
         }
+        if( bFound )
+          ulCount++;
+        continue;
+      }
+      #endif  // XB_BLOCKREAD_SUPPORT
+
+      if(( iRc = dbf->GetRecord( ulRecNo )) != XB_NO_ERROR ){
+        iErrorStop = 190;
+        throw iRc;
+      }
+      bMoved = xbTrue;
+      if(( iOption == XB_ACTIVE_RECS && dbf->RecordDeleted()) || ( iOption == XB_DELETED_RECS && !dbf->RecordDeleted()))
+        continue;
+      if(( iRc = exp->ProcessExpression()) != XB_NO_ERROR ){
+        iErrorStop = 200;
+        throw iRc;
+      }
+      if(( iRc = exp->GetBoolResult( bFound )) != XB_NO_ERROR ){
+        iErrorStop = 210;
+        throw iRc;
       }
+      if( bFound )
+        ulCount++;
     }
-    lCurQryCnt--;
   }
   catch (xbInt16 iRc ){
     xbString sMsg;
-    sMsg.Sprintf( "xbFilter::GetPrevRecord() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    sMsg.Sprintf( "xbFilter::CountRecords() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
     dbf->GetXbasePtr()->WriteLogMessage( sMsg.Str() );
     dbf->GetXbasePtr()->WriteLogMessage( dbf->GetXbasePtr()->GetErrorMessage( iRc ));
   }
+
+  #ifdef XB_BLOCKREAD_SUPPORT
+  if( dpResults )
+    free( dpResults );
+  #endif  // XB_BLOCKREAD_SUPPORT
+  #ifdef XB_INDEX_SUPPORT
+  bRangeSts = bSaveRangeSts;
+  #endif  // XB_INDEX_SUPPORT
+
+  if( bMoved && ulSaveRec != dbf->GetCurRecNo()){
+    xbInt16 iRc2 = ( ulSaveRec == 0 ) ? dbf->BlankRecord() : dbf->GetRecord( ulSaveRec );
+    if( iRc == XB_NO_ERROR )
+      iRc = iRc2;
+  }
   return iRc;
 }
 /************************************************************************/
-xbInt16 xbFilter::GetLastRecord( xbInt16 iOption ){
+xbInt16 xbFilter::Exists( xbBool &bExists, xbInt16 iOption ){
+
+  xbUInt32 ulCount;
+  xbInt16  iRc = CountRecords( ulCount, iOption, 1 );
+  bExists = ( iRc == XB_NO_ERROR && ulCount > 0 ) ? xbTrue : xbFalse;
+  return iRc;
+}
+/************************************************************************/
+xbInt16 xbFilter::GetEstimatedRecCnt( xbUInt32 &ulRecCnt ){
+
+  xbInt16 iRc   = XB_NO_ERROR;
+  xbBool  bDone = xbFalse;
+  ulRecCnt = 0;
+
+  if( GetBitmapStatus()){
+    ulRecCnt = bmMatch.GetCount();
+    bDone    = xbTrue;
+  }
+  #ifdef XB_INDEX_SUPPORT
+  if( !bDone && bRangeSts ){
+    ulRecCnt = ulRangeRecCnt;
+    bDone    = xbTrue;
+  }
+  #endif  // XB_INDEX_SUPPORT
+  #ifdef XB_PARALLEL_SUPPORT
+  if( !bDone && bParSts ){
+    ulRecCnt = ulParRecCnt;
+    bDone    = xbTrue;
+  }
+  #endif  // XB_PARALLEL_SUPPORT
+  if( !bDone && ( iRc = dbf->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR )
+    return iRc;
+
+  if( lLimit > 0 && ulRecCnt > (xbUInt32) lLimit )
+    ulRecCnt = (xbUInt32) lLimit;
+  return XB_NO_ERROR;
+}
+/************************************************************************/
+xbBool xbFilter::GetBitmapStatus() const {
+
+  // a record with pending updates has to go through the regular path so it is committed or aborted first
+  return ( bMaterialize && bBitmapSts && dbf->GetDbfStatus() != XB_UPDATED ) ? xbTrue : xbFalse;
+}
+/************************************************************************/
+//! @brief Determine if the filter only checks the deleted flag.
+/*!
+  @private
+  DEL() compared to a "*" or " " constant is treated the same as DELETED().
+
+  @returns XB_DELETED_RECS - The filter is <em>DELETED()</em> or <em>DEL() = "*"</em>.<br>
+           XB_ACTIVE_RECS - The filter is <em>.NOT. DELETED()</em> or <em>DEL() = " "</em>.<br>
+           XB_ALL_RECS - The filter reads more than the deleted flag.
+*/
+xbInt16 xbFilter::GetDeletedFilterOption(){
+
+  xbExpNode *n = exp->GetTreeHandle();
+  xbBool bDeleted = xbTrue;
+  if( n && n->GetNodeType() == XB_EXP_OPERATOR && n->GetOpCode() == XB_EXP_OPR_NOT && n->GetChildCnt() == 1 ){
+    n = n->GetChild( 0 );
+    bDeleted = xbFalse;
+  }
+  if( !n )
+    return XB_ALL_RECS;
+  if( n->GetNodeType() == XB_EXP_FUNCTION && n->GetOpCode() == XB_EXP_FNC_DELETED )
+    return bDeleted ? XB_DELETED_RECS : XB_ACTIVE_RECS;
+
+  // DEL() = "*", DEL() <> " " and the like
+  if( n->GetNodeType() != XB_EXP_OPERATOR || n->GetChildCnt() != 2 ||
+     ( n->GetOpCode() != XB_EXP_OPR_EQ && n->GetOpCode() != XB_EXP_OPR_NE ))
+    return XB_ALL_RECS;
+  xbExpNode *nFunc  = n->GetChild( 0 );
+  xbExpNode *nConst = n->GetChild( 1 );
+  if( nFunc->GetNodeType() == XB_EXP_CONSTANT ){
+    nFunc  = n->GetChild( 1 );
+    nConst = n->GetChild( 0 );
+  }
+  if( nFunc->GetNodeType() != XB_EXP_FUNCTION || nFunc->GetOpCode() != XB_EXP_FNC_DEL ||
+      nConst->GetNodeType() != XB_EXP_CONSTANT || nConst->GetReturnType() != XB_EXP_CHAR )
+    return XB_ALL_RECS;
+  xbString &sConst = nConst->GetStringResult();
+  if( sConst == "*" ){
+    // deleted as is
+  } else if( sConst == " " ){
+    bDeleted = !bDeleted;
+  } else {
+    return XB_ALL_RECS;
+  }
+  if( n->GetOpCode() == XB_EXP_OPR_NE )
+    bDeleted = !bDeleted;
+  return bDeleted ? XB_DELETED_RECS : XB_ACTIVE_RECS;
+}
+/************************************************************************/
+//! @brief Get the next filtered record from the bitmap.
+/*!
+  @private
+  @param ulRecNo First record number to check.
+  @param iDirection 1 - Move forward through the table.<br>
+                   -1 - Move backward through the table.
+  @param iOption XB_ALL_RECS, XB_ACTIVE_RECS or XB_DELETED_RECS
+  @returns XB_EOF moving forward or XB_BOF moving backward when no more records are found.<br>
+           <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbFilter::GetNextBitmapRecord( xbUInt32 ulRecNo, xbInt16 iDirection, xbInt16 iOption ){
 
   xbInt16 iRc = XB_NO_ERROR;
   xbInt16 iErrorStop = 0;
   try{
+    // deleted matches are a subset, step through them directly
+    xbBitmap *bm = ( iOption == XB_DELETED_RECS ) ? &bmDeleted : &bmMatch;
+    xbUInt32 ulFound;
 
-    if( !exp ){
+    while( xbTrue ){
+      if( iDirection > 0 )
+        iRc = bm->GetNext( ulRecNo, ulFound );
+      else
+        iRc = bm->GetPrev( ulRecNo, ulFound );
+      if( iRc == XB_NOT_FOUND || ulFound == 0 )
+        return ( iDirection > 0 ) ? XB_EOF : XB_BOF;
+
+      if( iOption != XB_ACTIVE_RECS || !bmDeleted.Contains( ulFound )){
+        if(( iRc = dbf->GetRecord( ulFound )) != XB_NO_ERROR ){
+          iErrorStop = 100;
+          throw iRc;
+        }
+        return XB_NO_ERROR;
+      }
+      if( iDirection > 0 ){
+        if( ulFound == 0xFFFFFFFF )
+          return XB_EOF;
+        ulRecNo = ulFound + 1;
+      } else {
+        ulRecNo = ulFound - 1;
+      }
+    }
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbFilter::GetNextBitmapRecord() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    dbf->GetXbasePtr()->WriteLogMessage( sMsg.Str() );
+    dbf->GetXbasePtr()->WriteLogMessage( dbf->GetXbasePtr()->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/************************************************************************/
+//! @brief Bring the bitmap of matching records up to date.
+/*!
+  @private
+  If the bitmap has not been built, or the table change log no longer covers every change
+  since it was, the bitmap is built from scratch.  Otherwise only the records written since
+  the last refresh, and any records appended by others, are evaluated again.<br>
+
+  The bitmap is left alone while the current record has pending updates.
+
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbFilter::RefreshBitmap(){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  try{
+    if( dbf->GetDbfStatus() == XB_UPDATED )
+      return XB_NO_ERROR;
+
+    xbUInt32 ulRecCnt;
+    if(( iRc = dbf->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
       iErrorStop = 100;
       throw iRc;
     }
-    lCurQryCnt = 0;
+    xbUInt32 ulSeq = dbf->GetChangeSeq();
+    if( bBitmapSts && ulSeq == ulBitmapSeq && ulRecCnt == ulBitmapRecCnt )
+      return XB_NO_ERROR;
+
+    xbUInt32 ulRecNo;
+    if( !bBitmapSts || ulRecCnt < ulBitmapRecCnt ||
+        ( ulSeq != ulBitmapSeq && dbf->GetChangedRecNo( ulBitmapSeq + 1, ulRecNo ) != XB_NO_ERROR )){
+      if(( iRc = BuildBitmap()) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+      return iRc;
+    }
+
+    xbUInt32 ulSaveRec = dbf->GetCurRecNo();
+    for( xbUInt32 ulChg = ulBitmapSeq + 1; ulChg <= ulSeq && ulChg != 0; ulChg++ ){
+      if(( iRc = dbf->GetChangedRecNo( ulChg, ulRecNo )) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+      if(( iRc = RefreshBitmapRecord( ulRecNo, ulRecCnt )) != XB_NO_ERROR ){
+        iErrorStop = 130;
+        throw iRc;
+      }
+    }
+    for( ulRecNo = ulBitmapRecCnt + 1; ulRecNo <= ulRecCnt; ulRecNo++ ){
+      if(( iRc = RefreshBitmapRecord( ulRecNo, ulRecCnt )) != XB_NO_ERROR ){
+        iErrorStop = 140;
+        throw iRc;
+      }
+    }
+    ulBitmapSeq    = ulSeq;
+    ulBitmapRecCnt = ulRecCnt;
+
+    if( ulSaveRec != 0 && ulSaveRec <= ulRecCnt && ulSaveRec != dbf->GetCurRecNo()){
+      if(( iRc = dbf->GetRecord( ulSaveRec )) != XB_NO_ERROR ){
+        iErrorStop = 150;
+        throw iRc;
+      }
+    }
+  }
+  catch (xbInt16 iRc ){
+    bBitmapSts = xbFalse;
+    xbString sMsg;
+    sMsg.Sprintf( "xbFilter::RefreshBitmap() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    dbf->GetXbasePtr()->WriteLogMessage( sMsg.Str() );
+    dbf->GetXbasePtr()->WriteLogMessage( dbf->GetXbasePtr()->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/************************************************************************/
+//! @brief Evaluate the filter for one record and update the bitmap.
+/*!
+  @private
+  @param ulRecNo Record number to evaluate.
+  @param ulRecCnt Number of records in the table, records past the end are removed from the bitmap.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbFilter::RefreshBitmapRecord( xbUInt32 ulRecNo, xbUInt32 ulRecCnt ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  try{
+    xbBool bFound = xbFalse;
+    if( ulRecNo == 0 )
+      return XB_NO_ERROR;
+
+    if( ulRecNo <= ulRecCnt ){
+      if(( iRc = dbf->GetRecord( ulRecNo )) != XB_NO_ERROR ){
+        iErrorStop = 100;
+        throw iRc;
+      }
+      if(( iRc = exp->ProcessExpression()) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+      if(( iRc = exp->GetBoolResult( bFound )) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+    }
+    if( bFound ){
+      if(( iRc = bmMatch.Set( ulRecNo )) != XB_NO_ERROR ){
+        iErrorStop = 130;
+        throw iRc;
+      }
+      if( dbf->RecordDeleted())
+        iRc = bmDeleted.Set( ulRecNo );
+      else
+        iRc = bmDeleted.Remove( ulRecNo );
+    } else {
+      if(( iRc = bmMatch.Remove( ulRecNo )) != XB_NO_ERROR ){
+        iErrorStop = 140;
+        throw iRc;
+      }
+      iRc = bmDeleted.Remove( ulRecNo );
+    }
+    if( iRc != XB_NO_ERROR ){
+      iErrorStop = 150;
+      throw iRc;
+    }
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbFilter::RefreshBitmapRecord() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    dbf->GetXbasePtr()->WriteLogMessage( sMsg.Str() );
+    dbf->GetXbasePtr()->WriteLogMessage( dbf->GetXbasePtr()->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/************************************************************************/
+#ifdef XB_BLOCKREAD_SUPPORT
+//! @brief Determine if the filter can be evaluated a block at a time.
+/*!
+  @private
+  @returns xbTrue - Block reads are on and the filter expression supports batch processing.<br>
+           xbFalse - Evaluate the filter a record at a time.
+*/
+xbBool xbFilter::GetBatchStatus() const {
+
+  // a record with pending updates has to go through the regular path so it is committed or aborted first
+  if( !dbf->GetBlockReadPtr() || dbf->GetDbfStatus() == XB_UPDATED )
+    return xbFalse;
+  return exp->GetBatchSupport();
+}
+/************************************************************************/
+//! @brief Get the next filtered record using block evaluation.
+/*!
+  @private
+  The filter is evaluated for all the records in the read block at once, then the results are
+  used to step through the block.
+
+  @param ulRecNo First record number to check.
+  @param iOption XB_ALL_RECS, XB_ACTIVE_RECS or XB_DELETED_RECS
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbFilter::GetNextBatchRecord( xbUInt32 ulRecNo, xbInt16 iOption ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  try{
+    xbUInt32 ulRecCnt;
+    if(( iRc = dbf->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    if( ulRecCnt == 0 )
+      return XB_EMPTY;
+
+    xbBlockRead *pRb     = dbf->GetBlockReadPtr();
+    xbUInt32    ulRecLen = dbf->GetRecordLen();
+    xbUInt32    ulRow;
+    char        cDelFlag;
+
+    while( ulRecNo <= ulRecCnt ){
+      // the results are only good while the block they were built from is still loaded
+      if( ulRecNo < ulBatchFirstRec || ulRecNo >= ulBatchFirstRec + ulBatchRecCnt ||
+          pRb->GetBlockFirstRecNo() != ulBatchFirstRec || pRb->GetBlockRecCnt() != ulBatchRecCnt ){
+        ulBatchRecCnt = 0;
+        if(( iRc = pRb->LoadBlockForRecNo( ulRecNo )) != XB_NO_ERROR ){
+          iErrorStop = 110;
+          throw iRc;
+        }
+        if( pRb->GetBlockRecCnt() > ulBatchSize ){
+          if( dpBatch )
+            free( dpBatch );
+          if(( dpBatch = (xbDouble *) malloc( pRb->GetBlockRecCnt() * sizeof( xbDouble ))) == NULL ){
+            ulBatchSize = 0;
+            iErrorStop = 120;
+            iRc = XB_NO_MEMORY;
+            throw iRc;
+          }
+          ulBatchSize = pRb->GetBlockRecCnt();
+        }
+        if(( iRc = exp->ProcessExpressionBatch( pRb->GetBlockBuf(), pRb->GetBlockRecCnt(), dpBatch )) != XB_NO_ERROR ){
+          iErrorStop = 130;
+          throw iRc;
+        }
+        ulBatchFirstRec = pRb->GetBlockFirstRecNo();
+        ulBatchRecCnt   = pRb->GetBlockRecCnt();
+      }
+
+      ulRow = ulRecNo - ulBatchFirstRec;
+      if( dpBatch[ulRow] != 0 ){
+        cDelFlag = pRb->GetBlockBuf()[ulRow * ulRecLen];
+        if( iOption == XB_ALL_RECS || ( iOption == XB_ACTIVE_RECS && cDelFlag != '*' ) ||
+                                      ( iOption == XB_DELETED_RECS && cDelFlag == '*' )){
+          if(( iRc = dbf->GetRecord( ulRecNo )) != XB_NO_ERROR ){
+            iErrorStop = 140;
+            throw iRc;
+          }
+          return XB_NO_ERROR;
+        }
+      }
+      ulRecNo++;
+    }
+    iRc = XB_EOF;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbFilter::GetNextBatchRecord() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    dbf->GetXbasePtr()->WriteLogMessage( sMsg.Str() );
+    dbf->GetXbasePtr()->WriteLogMessage( dbf->GetXbasePtr()->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+#endif  // XB_BLOCKREAD_SUPPORT
+/************************************************************************/
+#ifdef XB_PARALLEL_SUPPORT
+///@cond DOXYOFF
+// target size of the record ranges handed out to the worker threads
+#define XB_FILTER_PAR_CHUNK_SIZE 262144
+
+// state shared by the worker threads of one parallel scan
+struct xbFilterParScan {
+  xbUInt32 ulRecCnt;                  // records in the table when the scan started
+  xbUInt32 ulHeaderLen;
+  xbUInt32 ulRecLen;
+  xbUInt32 ulChunkRecs;               // records in each range
+  xbUInt32 ulChunkCnt;                // number of ranges
+  xbInt16  iDirection;                // 1 - ranges are handed out from the top of the table, -1 from the bottom
+  xbInt16  iOption;                   // XB_ALL_RECS, XB_ACTIVE_RECS or XB_DELETED_RECS
+  xbInt32  lLimit;                    // stop once this many records are found, zero for no limit
+  xbBool   bOrdered;                  // xbTrue to keep the matches for each range apart, so they can be put in table order
+
+  std::atomic<xbUInt32> ulNextChunk;  // next range to hand out, in scan order
+  std::atomic<bool>     bStop;        // set to stop handing out ranges
+  std::mutex mtx;                     // guards everything below
+
+  xbInt16  iRc;                       // first error from a worker
+  xbUInt32 **ulppChunkRecs;           // ordered - matches in each range, in scan order
+  xbUInt32 *ulpChunkRecCnt;           // ordered - number of matches in each range
+  xbBool   *bpChunkDone;              // ordered - range has been evaluated
+  xbUInt32 ulDoneChunkCnt;            // ordered - ranges evaluated from the start of the scan, without gaps
+  xbUInt32 ulDoneRecCnt;              // ordered - matches in those ranges
+  xbUInt32 *ulpFoundRecs;             // as found - matches
+  xbUInt32 ulFoundRecCnt;
+  xbUInt32 ulFoundSize;               // allocated entries in ulpFoundRecs
+};
+///@endcond DOXYOFF
+/************************************************************************/
+//! @brief Worker thread for a parallel scan.
+/*!
+  @private
+  Takes record ranges from the shared scan state until there are none left or the scan is stopped,
+  reads each range with one read, evaluates the filter for the whole range and hands in the matches.<br>
+
+  Errors are handed back in the scan state for the calling thread to log, the log is not written
+  from here.
+
+  @param ps Shared scan state.
+  @param f Read only file handle for the table, used only by this worker.
+  @param e Copy of the filter expression, used only by this worker.
+*/
+static void xbFilterParWorker( xbFilterParScan *ps, xbFile *f, xbExp *e ){
+
+  xbInt16  iRc      = XB_NO_ERROR;
+  char     *cpBuf   = (char *)     malloc( (size_t) ps->ulChunkRecs * ps->ulRecLen );
+  xbDouble *dpRes   = (xbDouble *) malloc( ps->ulChunkRecs * sizeof( xbDouble ));
+  xbUInt32 *ulpHits = (xbUInt32 *) malloc( ps->ulChunkRecs * sizeof( xbUInt32 ));
+
+  try{
+    if( !cpBuf || !dpRes || !ulpHits ){
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    xbUInt32 ulSeq;
+    xbUInt32 ulChunk;
+    xbUInt32 ulFirst;
+    xbUInt32 ulCnt;
+    xbUInt32 ulHits;
+    xbUInt32 ulRow;
+    xbUInt32 ul;
+    char     cDelFlag;
+
+    while( !ps->bStop ){
+      if(( ulSeq = ps->ulNextChunk++ ) >= ps->ulChunkCnt )
+        break;
+      ulChunk = ( ps->iDirection > 0 ) ? ulSeq : ps->ulChunkCnt - 1 - ulSeq;
+      ulFirst = ulChunk * ps->ulChunkRecs + 1;
+      ulCnt   = ps->ulRecCnt - ulFirst + 1;
+      if( ulCnt > ps->ulChunkRecs )
+        ulCnt = ps->ulChunkRecs;
+
+      if(( iRc = f->xbFseek( (xbInt64) ps->ulHeaderLen + (xbInt64) ( ulFirst - 1 ) * ps->ulRecLen, SEEK_SET )) != XB_NO_ERROR )
+        throw iRc;
+      if(( iRc = f->xbFread( cpBuf, (size_t) ulCnt * ps->ulRecLen, 1 )) != XB_NO_ERROR )
+        throw iRc;
+      if(( iRc = e->ProcessExpressionBatch( cpBuf, ulCnt, dpRes )) != XB_NO_ERROR )
+        throw iRc;
+
+      // matches are kept in scan order, so a range scanned from the bottom is stepped through backward
+      ulHits = 0;
+      for( ul = 0; ul < ulCnt; ul++ ){
+        ulRow = ( ps->iDirection > 0 ) ? ul : ulCnt - 1 - ul;
+        if( dpRes[ulRow] != 0 ){
+          cDelFlag = cpBuf[ulRow * ps->ulRecLen];
+          if( ps->iOption == XB_ALL_RECS || ( ps->iOption == XB_ACTIVE_RECS && cDelFlag != '*' ) ||
+                                            ( ps->iOption == XB_DELETED_RECS && cDelFlag == '*' ))
+            ulpHits[ulHits++] = ulFirst + ulRow;
+        }
+      }
+
+      std::lock_guard<std::mutex> lock( ps->mtx );
+      if( ps->bOrdered ){
+        if( ulHits > 0 ){
+          if(( ps->ulppChunkRecs[ulSeq] = (xbUInt32 *) malloc( ulHits * sizeof( xbUInt32 ))) == NULL ){
+            iRc = XB_NO_MEMORY;
+            throw iRc;
+          }
+          memcpy( ps->ulppChunkRecs[ulSeq], ulpHits, ulHits * sizeof( xbUInt32 ));
+        }
+        ps->ulpChunkRecCnt[ulSeq] = ulHits;
+        ps->bpChunkDone[ulSeq]    = xbTrue;
+        while( ps->ulDoneChunkCnt < ps->ulChunkCnt && ps->bpChunkDone[ps->ulDoneChunkCnt] ){
+          ps->ulDoneRecCnt += ps->ulpChunkRecCnt[ps->ulDoneChunkCnt];
+          ps->ulDoneChunkCnt++;
+        }
+        // the ranges ahead of the first gap already hold enough records
+        if( ps->lLimit > 0 && ps->ulDoneRecCnt >= (xbUInt32) ps->lLimit )
+          ps->bStop = true;
+      } else if( ulHits > 0 ){
+        if( ps->ulFoundRecCnt + ulHits > ps->ulFoundSize ){
+          xbUInt32 ulNewSize = ( ps->ulFoundSize * 2 > ps->ulFoundRecCnt + ulHits ) ? ps->ulFoundSize * 2 : ps->ulFoundRecCnt + ulHits;
+          xbUInt32 *ulpNew;
+          if(( ulpNew = (xbUInt32 *) realloc( ps->ulpFoundRecs, ulNewSize * sizeof( xbUInt32 ))) == NULL ){
+            iRc = XB_NO_MEMORY;
+            throw iRc;
+          }
+          ps->ulpFoundRecs = ulpNew;
+          ps->ulFoundSize  = ulNewSize;
+        }
+        memcpy( ps->ulpFoundRecs + ps->ulFoundRecCnt, ulpHits, ulHits * sizeof( xbUInt32 ));
+        ps->ulFoundRecCnt += ulHits;
+        if( ps->lLimit > 0 && ps->ulFoundRecCnt >= (xbUInt32) ps->lLimit )
+          ps->bStop = true;
+      }
+    }
+  }
+  catch (xbInt16 iRc ){
+    // the range lock, if held, was released on the way out of the loop
+    std::lock_guard<std::mutex> lock( ps->mtx );
+    if( ps->iRc == XB_NO_ERROR )
+      ps->iRc = iRc;
+    ps->bStop = true;
+  }
+  if( cpBuf )
+    free( cpBuf );
+  if( dpRes )
+    free( dpRes );
+  if( ulpHits )
+    free( ulpHits );
+}
+/************************************************************************/
+//! @brief Get the next filtered record from the last parallel scan.
+/*!
+  @private
+  Each record is read and checked against the filter again before it is returned, records
+  changed or removed since the scan are skipped.
+
+  @param iDirection 1 - Move toward the end of the table.<br>
+                   -1 - Move toward the top of the table.
+  @param iOption XB_ALL_RECS, XB_ACTIVE_RECS or XB_DELETED_RECS
+  @returns XB_EOF moving forward or XB_BOF moving backward when no more records are found.<br>
+           <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbFilter::GetNextParRecord( xbInt16 iDirection, xbInt16 iOption ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  try{
+    xbUInt32 ulRecCnt;
+    if(( iRc = dbf->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+
+    // ulpParRecs runs in the direction the scan started from
+    xbInt32 lStep = ( iDirection == iParDirection ) ? 1 : -1;
+    xbInt32 lPos  = lParPos + lStep;
+    xbBool  bFound;
+    while( lPos >= 0 && lPos < (xbInt32) ulParRecCnt ){
+      if( ulpParRecs[lPos] <= ulRecCnt ){
+        if(( iRc = dbf->GetRecord( ulpParRecs[lPos] )) != XB_NO_ERROR ){
+          iErrorStop = 110;
+          throw iRc;
+        }
+        if( iOption == XB_ALL_RECS || ( iOption == XB_ACTIVE_RECS && !dbf->RecordDeleted()) ||
+                                      ( iOption == XB_DELETED_RECS && dbf->RecordDeleted())){
+          if(( iRc = exp->ProcessExpression()) != XB_NO_ERROR ){
+            iErrorStop = 120;
+            throw iRc;
+          }
+          if(( iRc = exp->GetBoolResult( bFound )) != XB_NO_ERROR ){
+            iErrorStop = 130;
+            throw iRc;
+          }
+          if( bFound ){
+            lParPos = lPos;
+            return XB_NO_ERROR;
+          }
+        }
+      }
+      lPos += lStep;
+    }
+    iRc = ( iDirection > 0 ) ? XB_EOF : XB_BOF;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbFilter::GetNextParRecord() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    dbf->GetXbasePtr()->WriteLogMessage( sMsg.Str() );
+    dbf->GetXbasePtr()->WriteLogMessage( dbf->GetXbasePtr()->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/************************************************************************/
+//! @brief Run a parallel scan of the table.
+/*!
+  @private
+  If a parallel scan can be used, the table is split into record ranges which are handed out
+  to the worker threads, and the matching record numbers are loaded into ulpParRecs.  The calling
+  thread works as one of the workers.  If the scan can't be used, bParSts is left off.
+
+  @param iDirection 1 - Scan from the top of the table.<br>
+                   -1 - Scan from the bottom of the table.
+  @param iOption XB_ALL_RECS, XB_ACTIVE_RECS or XB_DELETED_RECS
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbFilter::RunParScan( xbInt16 iDirection, xbInt16 iOption ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  bParSts     = xbFalse;
+  ulParRecCnt = 0;
+  if( iParThreadCnt == 1 || !exp->GetBatchSupport() ||
+      dbf->GetDbfStatus() == XB_UPDATED || dbf->GetMemoryResident())
+    return XB_NO_ERROR;
+
+  xbFilterParScan ps;
+  xbInt16  iThreadCnt   = iParThreadCnt;
+  xbInt16  iStarted     = 0;
+  xbInt16  i;
+  xbFile   **fpFiles    = NULL;
+  xbExp    **epExps     = NULL;
+  std::thread *tpThreads = NULL;
+
+  ps.ulppChunkRecs  = NULL;
+  ps.ulpChunkRecCnt = NULL;
+  ps.bpChunkDone    = NULL;
+  ps.ulpFoundRecs   = NULL;
+
+  try{
+    if(( iRc = dbf->GetRecordCnt( ps.ulRecCnt )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    if( iThreadCnt == 0 ){
+      iThreadCnt = (xbInt16) std::thread::hardware_concurrency();
+      if( iThreadCnt < 1 )
+        iThreadCnt = 1;
+    }
+
+    // several ranges per thread keeps the threads busy when the matches are bunched up,
+    // but each range is kept small enough to read in one piece
+    ps.ulHeaderLen = dbf->GetHeaderLen();
+    ps.ulRecLen    = dbf->GetRecordLen();
+    xbUInt32 ulMaxRecs = XB_FILTER_PAR_CHUNK_SIZE / ps.ulRecLen;
+    if( ulMaxRecs == 0 )
+      ulMaxRecs = 1;
+    xbUInt32 ulParts = (xbUInt32) iThreadCnt * 8;
+    ps.ulChunkRecs = ( ps.ulRecCnt + ulParts - 1 ) / ulParts;
+    if( ps.ulChunkRecs > ulMaxRecs )
+      ps.ulChunkRecs = ulMaxRecs;
+    if( ps.ulChunkRecs == 0 )
+      ps.ulChunkRecs = 1;
+    ps.ulChunkCnt = ( ps.ulRecCnt + ps.ulChunkRecs - 1 ) / ps.ulChunkRecs;
+    if( (xbUInt32) iThreadCnt > ps.ulChunkCnt )
+      iThreadCnt = (xbInt16) ps.ulChunkCnt;
+    if( iThreadCnt < 2 )
+      return XB_NO_ERROR;
+
+    ps.iDirection     = iDirection;
+    ps.iOption        = iOption;
+    ps.lLimit         = lLimit;
+    ps.bOrdered       = bParOrdered;
+    ps.ulNextChunk    = 0;
+    ps.bStop          = false;
+    ps.iRc            = XB_NO_ERROR;
+    ps.ulDoneChunkCnt = 0;
+    ps.ulDoneRecCnt   = 0;
+    ps.ulFoundRecCnt  = 0;
+    ps.ulFoundSize    = 0;
+    if( bParOrdered ){
+      ps.ulppChunkRecs  = (xbUInt32 **) calloc( ps.ulChunkCnt, sizeof( xbUInt32 * ));
+      ps.ulpChunkRecCnt = (xbUInt32 *)  calloc( ps.ulChunkCnt, sizeof( xbUInt32 ));
+      ps.bpChunkDone    = (xbBool *)    calloc( ps.ulChunkCnt, sizeof( xbBool ));
+      if( !ps.ulppChunkRecs || !ps.ulpChunkRecCnt || !ps.bpChunkDone ){
+        iErrorStop = 110;
+        iRc = XB_NO_MEMORY;
+        throw iRc;
+      }
+    }
+
+    // the workers read the table from disk, so anything still sitting in the write buffer goes first
+    if(( iRc = dbf->xbFflush()) != XB_NO_ERROR ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+
+    // file handles and expressions are set up here, the workers only read and evaluate
+    fpFiles = (xbFile **) calloc( (size_t) iThreadCnt, sizeof( xbFile * ));
+    epExps  = (xbExp **)  calloc( (size_t) iThreadCnt, sizeof( xbExp * ));
+    if( !fpFiles || !epExps ){
+      iErrorStop = 130;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    for( i = 0; i < iThreadCnt; i++ ){
+      fpFiles[i] = new xbFile( dbf->GetXbasePtr());
+      if(( iRc = fpFiles[i]->xbFopen( "rb", dbf->GetFqFileName(), XB_SINGLE_USER )) != XB_NO_ERROR ){
+        iErrorStop = 140;
+        throw iRc;
+      }
+      epExps[i] = new xbExp( dbf->GetXbasePtr(), dbf );
+      // the log isn't thread safe, worker errors are logged here once the workers are done
+      epExps[i]->SetMsgLogging( xbFalse );
+      if(( iRc = epExps[i]->ParseExpression( sFilterExp.Str() )) != XB_NO_ERROR ){
+        iErrorStop = 150;
+        throw iRc;
+      }
+      if( !epExps[i]->GetBatchSupport()){
+        iErrorStop = 160;
+        iRc = XB_INVALID_EXPRESSION;
+        throw iRc;
+      }
+    }
+
+    // the calling thread takes the last slot, if a thread can't be started its ranges go to the others
+    tpThreads = new std::thread[iThreadCnt - 1];
+    try{
+      for( iStarted = 0; iStarted < iThreadCnt - 1; iStarted++ )
+        tpThreads[iStarted] = std::thread( xbFilterParWorker, &ps, fpFiles[iStarted], epExps[iStarted] );
+    }
+    catch( std::system_error & ){}
+    xbFilterParWorker( &ps, fpFiles[iThreadCnt-1], epExps[iThreadCnt-1] );
+    for( i = 0; i < iStarted; i++ )
+      tpThreads[i].join();
+    iStarted = 0;
+
+    if( ps.iRc != XB_NO_ERROR ){
+      iErrorStop = 170;
+      iRc = ps.iRc;
+      throw iRc;
+    }
+
+    xbUInt32 ulCnt = bParOrdered ? ps.ulDoneRecCnt : ps.ulFoundRecCnt;
+    if( lLimit > 0 && ulCnt > (xbUInt32) lLimit )
+      ulCnt = (xbUInt32) lLimit;
+    if( ulpParRecs )
+      free( ulpParRecs );
+    ulpParRecs = NULL;
+    if( bParOrdered ){
+      // the ranges are put together in scan order, up to the first one not evaluated
+      if( ulCnt > 0 && ( ulpParRecs = (xbUInt32 *) malloc( ulCnt * sizeof( xbUInt32 ))) == NULL ){
+        iErrorStop = 180;
+        iRc = XB_NO_MEMORY;
+        throw iRc;
+      }
+      xbUInt32 ulPos = 0;
+      xbUInt32 ulTake;
+      for( xbUInt32 ul = 0; ul < ps.ulDoneChunkCnt && ulPos < ulCnt; ul++ ){
+        ulTake = ps.ulpChunkRecCnt[ul];
+        if( ulTake > ulCnt - ulPos )
+          ulTake = ulCnt - ulPos;
+        if( ulTake > 0 )
+          memcpy( ulpParRecs + ulPos, ps.ulppChunkRecs[ul], ulTake * sizeof( xbUInt32 ));
+        ulPos += ulTake;
+      }
+    } else {
+      ulpParRecs = ps.ulpFoundRecs;
+      ps.ulpFoundRecs = NULL;
+    }
+    ulParRecCnt   = ulCnt;
+    lParPos       = -1;
+    iParDirection = iDirection;
+    bParSts       = xbTrue;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbFilter::RunParScan() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    dbf->GetXbasePtr()->WriteLogMessage( sMsg.Str() );
+    dbf->GetXbasePtr()->WriteLogMessage( dbf->GetXbasePtr()->GetErrorMessage( iRc ));
+  }
+
+  if( tpThreads ){
+    for( i = 0; i < iStarted; i++ )
+      tpThreads[i].join();
+    delete [] tpThreads;
+  }
+  if( fpFiles ){
+    for( i = 0; i < iThreadCnt; i++ ){
+      if( fpFiles[i] ){
+        fpFiles[i]->xbFclose();
+        delete fpFiles[i];
+      }
+    }
+    free( fpFiles );
+  }
+  if( epExps ){
+    for( i = 0; i < iThreadCnt; i++ )
+      if( epExps[i] )
+        delete epExps[i];
+    free( epExps );
+  }
+  if( ps.ulppChunkRecs ){
+    for( xbUInt32 ul = 0; ul < ps.ulChunkCnt; ul++ )
+      if( ps.ulppChunkRecs[ul] )
+        free( ps.ulppChunkRecs[ul] );
+    free( ps.ulppChunkRecs );
+  }
+  if( ps.ulpChunkRecCnt )
+    free( ps.ulpChunkRecCnt );
+  if( ps.bpChunkDone )
+    free( ps.bpChunkDone );
+  if( ps.ulpFoundRecs )
+    free( ps.ulpFoundRecs );
+  return iRc;
+}
+#endif  // XB_PARALLEL_SUPPORT
+/************************************************************************/
+#ifdef XB_INDEX_SUPPORT
+//! @brief Compare two record numbers for qsort.
+static int xbFilterCompareRecNo( const void *p1, const void *p2 ){
+  xbUInt32 ul1 = *(const xbUInt32 *) p1;
+  xbUInt32 ul2 = *(const xbUInt32 *) p2;
+  return ul1 < ul2 ? -1 : ( ul1 > ul2 ? 1 : 0 );
+}
+/************************************************************************/
+//! @brief Build the list of records inside an index key range.
+/*!
+  @private
+  The open index tags are checked for a key expression that is restricted by the
+  top level .AND. conditions of the filter, for example <em>KEYFLD = 'ABC'</em>,
+  <em>KEYFLD >= 10 .AND. KEYFLD < 20</em> or <em>LEFT( KEYFLD, 2 ) = 'AB'</em>.
+  If one is found, the record numbers for the keys in the range are loaded and sorted
+  so the query can visit only those records, in table order.  The tag is put back on
+  the key it was on before the range was read.<br>
+
+  The range is always a superset of the matching records, each record is still checked
+  against the whole filter expression.  If no tag can be used, or the range covers most
+  of the table, bRangeSts is left off and the table is read.  SetIxRange() can turn the
+  range off or limit it to one tag.
+
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbFilter::BuildIxRange(){
+
+  xbInt16  iRc = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbIx     *pRangeIx    = NULL;
+  void     *vpRangeTag  = NULL;
+  char     *cpSaveKey   = NULL;
+  xbUInt32 ulSaveRecNo  = 0;
+  bRangeSts     = xbFalse;
+  ulRangeRecCnt = 0;
+
+  try{
+    // a record with pending updates has to go through the regular path so it is committed or aborted first
+    if( !exp || !exp->GetTreeHandle() || dbf->GetDbfStatus() == XB_UPDATED || cRangeMode == 'N' )
+      return XB_NO_ERROR;
+
+    xbUInt32 ulRecCnt;
+    if(( iRc = dbf->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    if( ulRecCnt == 0 )
+      return XB_NO_ERROR;
+
+    // pick the tag with the most bounds
+    xbInt16  iBestScore   = 0;
+    xbInt16  iScore;
+    xbFilterRange rBest;
+    xbFilterRange r;
+    void     *vpCurTag;
+
+    for( xbIxList *ixl = dbf->GetIxList(); ixl; ixl = ixl->next ){
+      xbIx *ix = ixl->ix;
+      if( !ix )
+        continue;
+      for( xbInt16 i = 0; i < ix->GetTagCount(); i++ ){
+        vpCurTag = ix->GetTag( i );
+        if( !vpCurTag || ( cRangeMode == 'T' && ( ix != pRangeModeIx || vpCurTag != vpRangeModeTag )))
+          continue;
+        if( !GetIxRangeBounds( ix, vpCurTag, r ))
+          continue;
+        iScore = ( r.bLo ? 1 : 0 ) + ( r.bHi ? 1 : 0 );
+        if( iScore > iBestScore ){
+          iBestScore = iScore;
+          pRangeIx   = ix;
+          vpRangeTag = vpCurTag;
+          rBest      = r;
+        }
+      }
+    }
+    if( !pRangeIx )
+      return XB_NO_ERROR;
+
+    xbUInt32 ulRecNo;
+    xbBool   bUseRange = xbTrue;
+
+    // the caller's position on the tag is put back once the range is read
+    cpSaveKey = pRangeIx->SaveTagPos( vpRangeTag, ulSaveRecNo );
+
+    // position on the first key in the range
+    if( rBest.bLo ){
+      if( rBest.cKeyType == 'C' )
+        iRc = pRangeIx->FindKey( vpRangeTag, rBest.sLo.Str(), (xbInt32) rBest.sLo.Len(), 0 );
+      else
+        iRc = pRangeIx->FindKey( vpRangeTag, rBest.dLo, 0 );
+      // not found is positioned on the next key, or past the last key when the bound is above all of them
+      if( iRc == XB_NOT_FOUND )
+        iRc = ( pRangeIx->GetCurKeyRecNo( vpRangeTag, ulRecNo ) == XB_NO_ERROR ) ? XB_NO_ERROR : XB_EOF;
+    } else {
+      iRc = pRangeIx->GetFirstKey( vpRangeTag, 0 );
+    }
+
+    // more than half the table is cheaper to read in order
+    xbUInt32 ulMaxRecs = ulRecCnt / 2 + 1;
+    xbString sKey;
+    xbDouble dKey;
+
+    while( iRc == XB_NO_ERROR ){
+      if( rBest.bHi ){
+        if( rBest.cKeyType == 'C' ){
+          if(( iRc = pRangeIx->GetCurKeyVal( vpRangeTag, sKey )) != XB_NO_ERROR ){
+            iErrorStop = 110;
+            throw iRc;
+          }
+          if( memcmp( sKey.Str(), rBest.sHi.Str(), rBest.sHi.Len()) > 0 )
+            break;
+        } else {
+          if(( iRc = pRangeIx->GetCurKeyVal( vpRangeTag, dKey )) != XB_NO_ERROR ){
+            iErrorStop = 120;
+            throw iRc;
+          }
+          if( dKey > rBest.dHi )
+            break;
+        }
+      }
+      if( ulRangeRecCnt >= ulMaxRecs || pRangeIx->GetCurKeyRecNo( vpRangeTag, ulRecNo ) != XB_NO_ERROR ){
+        bUseRange = xbFalse;
+        iRc = XB_NO_ERROR;
+        break;
+      }
+      if( ulRangeRecCnt >= ulRangeSize ){
+        xbUInt32 ulNewSize = ulRangeSize ? ulRangeSize * 2 : 64;
+        xbUInt32 *ulpNew;
+        if(( ulpNew = (xbUInt32 *) realloc( ulpRangeRecs, ulNewSize * sizeof( xbUInt32 ))) == NULL ){
+          iErrorStop = 130;
+          iRc = XB_NO_MEMORY;
+          throw iRc;
+        }
+        ulpRangeRecs = ulpNew;
+        ulRangeSize  = ulNewSize;
+      }
+      ulpRangeRecs[ulRangeRecCnt++] = ulRecNo;
+      iRc = pRangeIx->GetNextKey( vpRangeTag, 0 );
+    }
+    if( iRc != XB_NO_ERROR && iRc != XB_EOF && iRc != XB_EMPTY ){
+      iErrorStop = 140;
+      throw iRc;
+    }
+    iRc = pRangeIx->RestoreTagPos( vpRangeTag, cpSaveKey, ulSaveRecNo );
+    cpSaveKey = NULL;
+    if( iRc != XB_NO_ERROR ){
+      iErrorStop = 150;
+      throw iRc;
+    }
+    if( !bUseRange ){
+      ulRangeRecCnt = 0;
+      return XB_NO_ERROR;
+    }
+    if( ulRangeRecCnt > 1 )
+      qsort( ulpRangeRecs, ulRangeRecCnt, sizeof( xbUInt32 ), xbFilterCompareRecNo );
+    bRangeSts = xbTrue;
+  }
+  catch (xbInt16 iRc ){
+    ulRangeRecCnt = 0;
+    if( cpSaveKey )
+      pRangeIx->RestoreTagPos( vpRangeTag, cpSaveKey, ulSaveRecNo );
+    xbString sMsg;
+    sMsg.Sprintf( "xbFilter::BuildIxRange() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    dbf->GetXbasePtr()->WriteLogMessage( sMsg.Str() );
+    dbf->GetXbasePtr()->WriteLogMessage( dbf->GetXbasePtr()->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/************************************************************************/
+//! @brief Collect the index key bounds from a filter expression.
+/*!
+  @private
+  Walks the top level .AND. conditions of the filter and tightens the range for each
+  comparison of the key expression, or a leading part of it, with a constant.
+  Strict comparisons are treated as inclusive.
+
+  @param n Filter expression node.
+  @param nKey Root node of the tag key expression.
+  @param r Range to update.
+  @returns xbTrue - A bound was found.<br>
+           xbFalse - No bound was found.
+*/
+xbBool xbFilter::GetIxRangeBounds( xbExpNode *n, xbExpNode *nKey, xbFilterRange &r ) const {
+
+  if( !n || n->GetNodeType() != XB_EXP_OPERATOR || n->GetChildCnt() != 2 )
+    return xbFalse;
+
+  xbInt16 iOpCode = n->GetOpCode();
+  if( iOpCode == XB_EXP_OPR_AND ){
+    xbBool bLeft  = GetIxRangeBounds( n->GetChild( 0 ), nKey, r );
+    xbBool bRight = GetIxRangeBounds( n->GetChild( 1 ), nKey, r );
+    return bLeft || bRight;
+  }
+  if( iOpCode != XB_EXP_OPR_EQ && iOpCode != XB_EXP_OPR_GE && iOpCode != XB_EXP_OPR_GT &&
+      iOpCode != XB_EXP_OPR_LE && iOpCode != XB_EXP_OPR_LT )
+    return xbFalse;
+
+  // put the constant on the right
+  xbExpNode *nExp   = n->GetChild( 0 );
+  xbExpNode *nConst = n->GetChild( 1 );
+  if( nExp->GetNodeType() == XB_EXP_CONSTANT ){
+    nExp   = n->GetChild( 1 );
+    nConst = n->GetChild( 0 );
+    if( iOpCode == XB_EXP_OPR_GE )      iOpCode = XB_EXP_OPR_LE;
+    else if( iOpCode == XB_EXP_OPR_GT ) iOpCode = XB_EXP_OPR_LT;
+    else if( iOpCode == XB_EXP_OPR_LE ) iOpCode = XB_EXP_OPR_GE;
+    else if( iOpCode == XB_EXP_OPR_LT ) iOpCode = XB_EXP_OPR_GT;
+  }
+  if( nConst->GetNodeType() != XB_EXP_CONSTANT || nConst->GetReturnType() != r.cKeyType )
+    return xbFalse;
+
+  xbBool bLo = ( iOpCode == XB_EXP_OPR_EQ || iOpCode == XB_EXP_OPR_GE || iOpCode == XB_EXP_OPR_GT );
+  xbBool bHi = ( iOpCode == XB_EXP_OPR_EQ || iOpCode == XB_EXP_OPR_LE || iOpCode == XB_EXP_OPR_LT );
+
+  if( r.cKeyType == 'C' ){
+    // the key, or LEFT( key, n ) or SUBSTR( key, 1, n )
+    xbInt32 lPrefixLen = r.lKeyLen;
+    if( !nExp->IsEqual( nKey )){
+      if( nExp->GetNodeType() != XB_EXP_FUNCTION || !nExp->GetChild( 0 ) || !nExp->GetChild( 0 )->IsEqual( nKey ))
+        return xbFalse;
+      if( nExp->GetOpCode() == XB_EXP_FNC_LEFT && nExp->GetChildCnt() == 2 &&
+          nExp->GetChild( 1 )->GetNodeType() == XB_EXP_CONSTANT )
+        lPrefixLen = (xbInt32) nExp->GetChild( 1 )->GetNumericResult();
+      else if( nExp->GetOpCode() == XB_EXP_FNC_SUBSTR && nExp->GetChildCnt() == 3 &&
+               nExp->GetChild( 1 )->GetNodeType() == XB_EXP_CONSTANT &&
+               nExp->GetChild( 1 )->GetNumericResult() == 1 &&
+               nExp->GetChild( 2 )->GetNodeType() == XB_EXP_CONSTANT )
+        lPrefixLen = (xbInt32) nExp->GetChild( 2 )->GetNumericResult();
+      else
+        return xbFalse;
+    }
+
+    if( lPrefixLen <= 0 )
+      return xbFalse;
+
+    // trailing blanks only make the bound tighter, leave them off
+    xbString sBound( nConst->GetStringResult());
+    sBound.Rtrim();
+    if( lPrefixLen > r.lKeyLen )
+      lPrefixLen = r.lKeyLen;
+    if( (xbInt32) sBound.Len() > lPrefixLen )
+      sBound.Left( (xbUInt32) lPrefixLen );
+    if( sBound.Len() == 0 )
+      return xbFalse;
+
+    if( bLo && ( !r.bLo || strcmp( sBound.Str(), r.sLo.Str()) > 0 )){
+      r.sLo = sBound;
+      r.bLo = xbTrue;
+    }
+    if( bHi && ( !r.bHi || strcmp( sBound.Str(), r.sHi.Str()) < 0 )){
+      r.sHi = sBound;
+      r.bHi = xbTrue;
+    }
+    return xbTrue;
+
+  } else {
+    if( !nExp->IsEqual( nKey ))
+      return xbFalse;
+    xbDouble d = nConst->GetNumericResult();
+    if( r.cKeyType == 'D' && d <= 0 )
+      return xbFalse;
+    if( bLo && ( !r.bLo || d > r.dLo )){
+      r.dLo = d;
+      r.bLo = xbTrue;
+    }
+    if( bHi && ( !r.bHi || d < r.dHi )){
+      r.dHi = d;
+      r.bHi = xbTrue;
+    }
+    return xbTrue;
+  }
+}
+/************************************************************************/
+xbBool xbFilter::GetIxRangeBounds( xbIx *ix, void *vpTag, xbFilterRange &r ) const {
+
+  r.bLo = xbFalse;
+  r.bHi = xbFalse;
+  if( !exp || !exp->GetTreeHandle() || !ix || !vpTag )
+    return xbFalse;
+  if( ix->GetType() != "NDX" && ix->GetType() != "MDX" && ix->GetType() != "TDX" )
+    return xbFalse;
+
+  // descending tags, filtered tags and dBASE style unique tags don't hold a key for every record in order
+  char cKeyType = ix->GetKeyType( vpTag );
+  if(( cKeyType != 'C' && cKeyType != 'N' && cKeyType != 'D' ) || ix->GetSortOrder( vpTag ) ||
+      ix->GetKeyFilter( vpTag ) != "" ||
+      ( ix->GetUnique( vpTag ) && ix->GetIxTagMode( vpTag ) == XB_IX_DBASE_MODE ))
+    return xbFalse;
+
+  xbExp expKey( dbf->GetXbasePtr(), dbf );
+  if( expKey.ParseExpression( ix->GetKeyExpression( vpTag )) != XB_NO_ERROR || !expKey.GetTreeHandle())
+    return xbFalse;
+
+  r.cKeyType = cKeyType;
+  r.lKeyLen  = ix->GetKeyLen( vpTag );
+  GetIxRangeBounds( exp->GetTreeHandle(), expKey.GetTreeHandle(), r );
+
+  // null dates are keyed ahead of all other dates but don't compare that way, only use an upper bound with a lower one
+  if( cKeyType == 'D' && !r.bLo )
+    r.bHi = xbFalse;
+
+  return r.bLo || r.bHi;
+}
+/************************************************************************/
+xbBool xbFilter::GetIxRangeStatus() const {
+  return bRangeSts;
+}
+/************************************************************************/
+//! @brief Get the next filtered record from the index key range.
+/*!
+  @private
+  @param ulRecNo First record number to check.
+  @param iDirection 1 - Move forward through the table.<br>
+                   -1 - Move backward through the table.
+  @param iOption XB_ALL_RECS, XB_ACTIVE_RECS or XB_DELETED_RECS
+  @returns XB_EOF moving forward or XB_BOF moving backward when no more records are found.<br>
+           <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbFilter::GetNextIxRangeRecord( xbUInt32 ulRecNo, xbInt16 iDirection, xbInt16 iOption ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  try{
+    xbUInt32 ulRecCnt;
+    if(( iRc = dbf->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+
+    // first entry >= ulRecNo
+    xbUInt32 ulLo = 0;
+    xbUInt32 ulHi = ulRangeRecCnt;
+    xbUInt32 ulMid;
+    while( ulLo < ulHi ){
+      ulMid = ulLo + (( ulHi - ulLo ) >> 1 );
+      if( ulpRangeRecs[ulMid] < ulRecNo )
+        ulLo = ulMid + 1;
+      else
+        ulHi = ulMid;
+    }
+    // moving backward, start on the last entry <= ulRecNo
+    xbInt32 lPos = (xbInt32) ulLo;
+    if( iDirection < 0 && ( ulLo >= ulRangeRecCnt || ulpRangeRecs[ulLo] > ulRecNo ))
+      lPos--;
+
+    xbBool bFound;
+    while( lPos >= 0 && lPos < (xbInt32) ulRangeRecCnt ){
+      // records removed since the range was built
+      if( ulpRangeRecs[lPos] <= ulRecCnt ){
+        if(( iRc = dbf->GetRecord( ulpRangeRecs[lPos] )) != XB_NO_ERROR ){
+          iErrorStop = 110;
+          throw iRc;
+        }
+        if( iOption == XB_ALL_RECS || ( iOption == XB_ACTIVE_RECS && !dbf->RecordDeleted()) ||
+                                      ( iOption == XB_DELETED_RECS && dbf->RecordDeleted())){
+          if(( iRc = exp->ProcessExpression()) != XB_NO_ERROR ){
+            iErrorStop = 120;
+            throw iRc;
+          }
+          if(( iRc = exp->GetBoolResult( bFound )) != XB_NO_ERROR ){
+            iErrorStop = 130;
+            throw iRc;
+          }
+          if( bFound )
+            return XB_NO_ERROR;
+        }
+      }
+      lPos += iDirection;
+    }
+    iRc = ( iDirection > 0 ) ? XB_EOF : XB_BOF;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbFilter::GetNextIxRangeRecord() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    dbf->GetXbasePtr()->WriteLogMessage( sMsg.Str() );
+    dbf->GetXbasePtr()->WriteLogMessage( dbf->GetXbasePtr()->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+#endif  // XB_INDEX_SUPPORT
+/************************************************************************/
+xbInt16 xbFilter::GetPrevRecord( xbInt16 iOption ){ 
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  try{
+
+    if( !exp ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    if( lLimit != 0 && abs( lCurQryCnt ) >= lLimit )
+      return XB_LIMIT_REACHED;
+
+    if( bMaterialize ){
+      xbUInt32 ulRecNo = dbf->GetCurRecNo();
+      if(( iRc = RefreshBitmap()) != XB_NO_ERROR ){
+        iErrorStop = 101;
+        throw iRc;
+      }
+      if( GetBitmapStatus()){
+        if( ulRecNo <= 1 )
+          return XB_BOF;
+        if(( iRc = GetNextBitmapRecord( ulRecNo - 1, -1, iOption )) != XB_NO_ERROR ){
+          if( iRc == XB_BOF )
+            return iRc;
+          iErrorStop = 103;
+          throw iRc;
+        }
+        lCurQryCnt--;
+        return iRc;
+      }
+    }
+
+    #ifdef XB_INDEX_SUPPORT
+    if( bRangeSts ){
+      if( dbf->GetCurRecNo() <= 1 )
+        return XB_BOF;
+      if(( iRc = GetNextIxRangeRecord( dbf->GetCurRecNo() - 1, -1, iOption )) != XB_NO_ERROR ){
+        if( iRc == XB_BOF )
+          return iRc;
+        iErrorStop = 104;
+        throw iRc;
+      }
+      lCurQryCnt--;
+      return iRc;
+    }
+    #endif  // XB_INDEX_SUPPORT
+
+    #ifdef XB_PARALLEL_SUPPORT
+    if( bParSts ){
+      if(( iRc = GetNextParRecord( -1, iOption )) != XB_NO_ERROR ){
+        if( iRc == XB_BOF )
+          return iRc;
+        iErrorStop = 107;
+        throw iRc;
+      }
+      lCurQryCnt--;
+      return iRc;
+    }
+    #endif  // XB_PARALLEL_SUPPORT
+
+    if(( iRc = dbf->GetPrevRecord( iOption )) != XB_NO_ERROR ){
+      if( iRc == XB_BOF )
+        return iRc;
+      else{
+        iErrorStop = 110;
+        throw iRc;
+      }
+    }
+    xbBool bFound = xbFalse;
+    while( !bFound && iRc == XB_NO_ERROR ){
+      if(( iRc = exp->ProcessExpression()) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+      if(( iRc = exp->GetBoolResult( bFound )) != XB_NO_ERROR ){
+        iErrorStop = 130;
+        throw iRc;
+      }
+      if( !bFound ){
+        if(( iRc = dbf->GetPrevRecord( iOption )) != XB_NO_ERROR ){
+          if( iRc == XB_BOF ){
+            return iRc;
+          } else {
+            iErrorStop = 140;
+            throw iRc;
+          }
+        }
+      }
+    }
+    lCurQryCnt--;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbFilter::GetPrevRecord() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    dbf->GetXbasePtr()->WriteLogMessage( sMsg.Str() );
+    dbf->GetXbasePtr()->WriteLogMessage( dbf->GetXbasePtr()->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/************************************************************************/
+xbInt16 xbFilter::GetLastRecord( xbInt16 iOption ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  try{
+
+    if( !exp ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    lCurQryCnt = 0;
+    #ifdef XB_PARALLEL_SUPPORT
+    bParSts = xbFalse;
+    #endif  // XB_PARALLEL_SUPPORT
+
+    if( bMaterialize ){
+      if(( iRc = RefreshBitmap()) != XB_NO_ERROR ){
+        iErrorStop = 101;
+        throw iRc;
+      }
+      if( GetBitmapStatus()){
+        if(( iRc = GetNextBitmapRecord( 0xFFFFFFFF, -1, iOption )) != XB_NO_ERROR ){
+          if( iRc == XB_BOF )
+            return iRc;
+          iErrorStop = 103;
+          throw iRc;
+        }
+        lCurQryCnt--;
+        return iRc;
+      }
+    }
+
+    #ifdef XB_INDEX_SUPPORT
+    if(( iRc = BuildIxRange()) != XB_NO_ERROR ){
+      iErrorStop = 102;
+      throw iRc;
+    }
+    if( bRangeSts ){
+      if(( iRc = GetNextIxRangeRecord( 0xFFFFFFFF, -1, iOption )) != XB_NO_ERROR ){
+        if( iRc == XB_BOF )
+          return iRc;
+        iErrorStop = 104;
+        throw iRc;
+      }
+      lCurQryCnt--;
+      return iRc;
+    }
+    #endif  // XB_INDEX_SUPPORT
+
+    #ifdef XB_PARALLEL_SUPPORT
+    if(( iRc = RunParScan( -1, iOption )) != XB_NO_ERROR ){
+      iErrorStop = 106;
+      throw iRc;
+    }
+    if( bParSts ){
+      if(( iRc = GetNextParRecord( -1, iOption )) != XB_NO_ERROR ){
+        if( iRc == XB_BOF )
+          return iRc;
+        iErrorStop = 107;
+        throw iRc;
+      }
+      lCurQryCnt--;
+      return iRc;
+    }
+    #endif  // XB_PARALLEL_SUPPORT
+
     if(( iRc = dbf->GetLastRecord( iOption )) != XB_NO_ERROR ){
       if( iRc == XB_EOF )
         return iRc;
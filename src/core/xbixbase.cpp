@@ -31,6 +31,7 @@ xbIx::xbIx( xbDbf *dbf ) : xbFile( dbf->GetXbasePtr()) {
   vpCurTag  = NULL;
   cNodeBuf  = NULL;
   bLocked   = xbFalse;
+  ulNodeReads = 0;
 }
 /***********************************************************************/
 //! @brief Class Destructor.
@@ -148,35 +149,22 @@ xbInt16 xbIx::BSearchBlock( char cKeyType, xbIxNode *npNode, xbInt32 lKeyItemLen
   xbInt32 lKeyCnt = GetKeyCount( npNode );
 
   if( !bDescending ){
-    lHi = lKeyCnt - 1;
 
-    while( lLo <= lHi ){
-      lMid = (lLo + lHi) / 2;
-      iCompRc = CompareKey( cKeyType, GetKeyData( npNode, lMid, lKeyItemLen ), vpKey, (size_t) lSearchKeyLen );
-      if( iCompRc > 0 ) 
-        lHi = lMid - 1;
-      else if( iCompRc < 0 )
-        lLo = lMid + 1; 
-      else{  // found  match, look for leftmost occurrence
-
-        xbInt32 lFoundPos = lMid;
-        lMid--;
-        while( lMid >= 0 && CompareKey( cKeyType, GetKeyData( npNode, lMid, lKeyItemLen ), vpKey, (size_t) lSearchKeyLen ) == 0 ){
-          lFoundPos = lMid;
-          lMid--;
-        }
-        iCompRc = 0;
-        lLo = lFoundPos;
-        lHi = -1;
-      }
-    }
-    // update the compare key results
-    if( lMid != lLo ){
-      if( lLo >= lKeyCnt )
-        iCompRc = 1;
+    // lower bound search, lands on the leftmost occurrence of a duplicate key
+    // without walking back through the duplicates one at a time
+    lHi = lKeyCnt;
+    while( lLo < lHi ){
+      lMid = lLo + ((lHi - lLo) >> 1);
+      if( CompareKey( cKeyType, GetKeyData( npNode, lMid, lKeyItemLen ), vpKey, (size_t) lSearchKeyLen ) < 0 )
+        lLo = lMid + 1;
       else
-        iCompRc = CompareKey( cKeyType, GetKeyData( npNode, lLo, lKeyItemLen ), vpKey, (size_t) lSearchKeyLen );
+        lHi = lMid;
     }
+    // update the compare key results
+    if( lLo >= lKeyCnt )
+      iCompRc = 1;
+    else
+      iCompRc = CompareKey( cKeyType, GetKeyData( npNode, lLo, lKeyItemLen ), vpKey, (size_t) lSearchKeyLen );
     return (xbInt16) lLo;
 
   }  else {   // descending key
@@ -192,13 +180,15 @@ xbInt16 xbIx::BSearchBlock( char cKeyType, xbIxNode *npNode, xbInt32 lKeyItemLen
       else if( iCompRc < 0) {
         lLo = lMid - 1;
       }
-      else{  // found  match, look for leftmost occurrence
+      else{  // found  match, binary search lHi..lMid for leftmost occurrence
 
         xbInt32 lFoundPos = lMid;
-        lMid--;
-        while( lMid >= 0 && CompareKey( cKeyType, GetKeyData( npNode, lMid, lKeyItemLen ), vpKey, (size_t) lSearchKeyLen ) == 0 ){
-          lFoundPos = lMid;
-          lMid--;
+        while( lHi < lFoundPos ){
+          lMid = lHi + ((lFoundPos - lHi) >> 1);
+          if( CompareKey( cKeyType, GetKeyData( npNode, lMid, lKeyItemLen ), vpKey, (size_t) lSearchKeyLen ) == 0 )
+            lFoundPos = lMid;
+          else
+            lHi = lMid + 1;
         }
         iCompRc = 0;
         lHi = lFoundPos;
@@ -278,6 +268,21 @@ xbInt16 xbIx::Close(){
   return iRc;
 }
 
+/***********************************************************************/
+//! @brief Byte swap a character key prefix.
+/*!
+  @param ull Eight byte key prefix, as loaded on a little endian platform.
+  @returns Prefix in byte order, so unsigned compare matches memcmp.
+*/
+static inline xbUInt64 SwapKeyPrefix( xbUInt64 ull ){
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_bswap64( ull );
+#else
+  ull = ((ull & 0x00FF00FF00FF00FFULL) << 8)  | ((ull >> 8)  & 0x00FF00FF00FF00FFULL);
+  ull = ((ull & 0x0000FFFF0000FFFFULL) << 16) | ((ull >> 16) & 0x0000FFFF0000FFFFULL);
+  return (ull << 32) | (ull >> 32);
+#endif
+}
 /***********************************************************************/
 //! @brief Compare keys.
 /*!
@@ -293,6 +298,22 @@ xbInt16 xbIx::Close(){
 */
 inline xbInt16 xbIx::CompareKey( char cKeyType, const void *v1, const void *v2, size_t iSearchKeyLen ) const{
   if( cKeyType == 'C' ){                // character compare
+    if( iSearchKeyLen >= 8 ){
+      // compare the first eight bytes as one big endian word, only fall through
+      // to memcmp when the prefixes tie, as they do across a run of duplicate keys
+      xbUInt64 ull1;
+      xbUInt64 ull2;
+      memcpy( &ull1, v1, 8 );
+      memcpy( &ull2, v2, 8 );
+      if( ull1 != ull2 ){
+        if( iEndianType == 'L' ){
+          ull1 = SwapKeyPrefix( ull1 );
+          ull2 = SwapKeyPrefix( ull2 );
+        }
+        return ull1 < ull2 ? -1 : 1;
+      }
+      return memcmp( (const char *) v1 + 8, (const char *) v2 + 8, iSearchKeyLen - 8 );
+    }
     return memcmp( v1, v2, iSearchKeyLen );
   } else if( cKeyType == 'N' ){         // numeric bcd compare, mdx bcd numeric indices
     xbBcd bcdk1( v1 );
@@ -314,6 +335,9 @@ inline xbInt16 xbIx::CompareKey( char cKeyType, const void *v1, const void *v2,
 /***********************************************************************/
 //! @brief Create Keys for record number
 /*!
+  In update mode, tags whose key and filter expressions don't read any of the changed
+  fields are skipped, see KeyUpdated().
+
   @param iOpt 0 Build a key for FindKey usage, only rec buf 0.<br>
               1 Append Mode, Create key for an append, only use rec buf 0, set updated switch.<br>
               2 Update Mode, Create old version and new version keys, check if different, set update switch appropriately.
@@ -330,6 +354,10 @@ xbInt16 xbIx::CreateKeys( xbInt16 iOpt ) {
 
     for( i = 0; i < iTagCount; i++ ){
       vpTag = GetTag( i );
+      if( iOpt == 2 && !KeyUpdated( vpTag )){
+        SetKeySts( vpTag, 0 );
+        continue;
+      }
       if(( iRc = CreateKey( vpTag, iOpt )) < XB_NO_ERROR ){
         iErrorStop = 100;
         throw iRc;
@@ -559,6 +587,7 @@ xbInt16 xbIx::GetBlock( void *vpTag, xbUInt32 ulBlockNo, xbInt16 iOpt, xbUInt32
       iErrorStop = 120;
       throw iRc;
     }
+    ulNodeReads++;
     if( iOpt == 0 )
       return iRc;
     np->ulBlockNo = ulBlockNo;
@@ -583,6 +612,15 @@ xbInt16 xbIx::GetBlock( void *vpTag, xbUInt32 ulBlockNo, xbInt16 iOpt, xbUInt32
   return iRc;
 }
 /***********************************************************************/
+//! @brief Get the bloom filter status for a tag.
+/*!
+  Bloom filters are not supported for this index type.
+  @returns xbFalse
+*/
+xbBool xbIx::GetBloomFilter( const void * ) const {
+  return xbFalse;
+}
+/***********************************************************************/
 //! @brief Get pointer to current tag.
 /*!
   @returns Pointer to current tag.
@@ -600,6 +638,65 @@ xbDbf *xbIx::GetDbf() const {
   return this->dbf;
 }
 /***********************************************************************/
+//! @brief Get the dbf record number for the current key.
+/*!
+  Index types that can't report the record number for a positioned key return XB_INVALID_INDEX.
+
+  @param vpTag Tag to retrieve the record number from.
+  @param ulRecNo Output - Record number the current key points to.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIx::GetCurKeyRecNo( void *, xbUInt32 &ulRecNo ){
+  ulRecNo = 0;
+  return XB_INVALID_INDEX;
+}
+/***********************************************************************/
+//! @brief Get the number of distinct keys for a given tag.
+/*!
+  The count is calculated from the index leaf nodes only, the dbf file is not read.
+  Leaf nodes made up entirely of one key value are skipped over in a single step.
+
+  @param vpTag Tag to count keys on.
+  @param ulKeyCnt Output - Number of distinct keys in the tag.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIx::GetDistinctKeyCnt( void *vpTag, xbUInt32 &ulKeyCnt ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  ulKeyCnt = 0;
+
+  try{
+    if( !vpTag ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+    if(( iRc = GetFirstKey( vpTag, 0 )) == XB_EMPTY )
+      return XB_NO_ERROR;
+    else if( iRc != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    while( iRc == XB_NO_ERROR ){
+      ulKeyCnt++;
+      iRc = GetNextDistinctKey( vpTag );
+    }
+    if( iRc != XB_EOF ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+    iRc = XB_NO_ERROR;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbIx::GetDistinctKeyCnt() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
 //! @brief Get the first key for the current tag.
 /*!
   @returns <a href="xbretcod_8h.html">Return Codes</a>
@@ -643,7 +740,205 @@ xbInt16 xbIx::GetLastKey( void *vpTag ){
 xbBool xbIx::GetLocked() const {
   return bLocked;
 }
+/***********************************************************************/
+//! @brief Get the number of index nodes read from the file.
+/*!
+  Counts the nodes read by GetBlock() since the index was opened.
+
+  @returns Number of nodes read.
+*/
+xbUInt32 xbIx::GetNodeReadCnt() const {
+  return ulNodeReads;
+}
+
+/***********************************************************************/
+//! @brief Get the number of keys for a given tag.
+/*!
+  The count is calculated from the index leaf nodes only, the dbf file is not read.
+  Each leaf node is counted in one step using the key count stored on the node.
+
+  @param vpTag Tag to count keys on.
+  @param ulKeyCnt Output - Number of keys in the tag.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIx::GetKeyCnt( void *vpTag, xbUInt32 &ulKeyCnt ){
 
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  ulKeyCnt = 0;
+
+  try{
+    if( !vpTag ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+    if(( iRc = GetFirstKey( vpTag, 0 )) == XB_EMPTY )
+      return XB_NO_ERROR;
+    else if( iRc != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+
+    xbIxNode *np;
+    xbUInt32 ulLeafKeyCnt;
+    while( iRc == XB_NO_ERROR ){
+      // count the rest of the leaf, then position on its last key so the next call moves to the next leaf
+      np = GetCurNode( vpTag );
+      ulLeafKeyCnt = (xbUInt32) GetKeyCount( np );
+      if( ulLeafKeyCnt > np->iCurKeyNo ){
+        ulKeyCnt += ulLeafKeyCnt - np->iCurKeyNo;
+        np->iCurKeyNo = ulLeafKeyCnt - 1;
+      }
+      iRc = GetNextKey( vpTag, 0 );
+    }
+    if( iRc != XB_EOF ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+    iRc = XB_NO_ERROR;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbIx::GetKeyCnt() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Get the number of keys beginning with a given prefix.
+/*!
+  The count is calculated from the index leaf nodes only, the dbf file is not read.
+  Applies to character tags only.
+
+  @param vpTag Tag to count keys on.
+  @param sKeyPrefix Leading characters of the keys to count.  An empty prefix counts all keys.
+  @param ulKeyCnt Output - Number of keys matching the prefix.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIx::GetKeyCnt( void *vpTag, const xbString &sKeyPrefix, xbUInt32 &ulKeyCnt ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  ulKeyCnt = 0;
+
+  try{
+    if( !vpTag ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+    if( GetKeyType( vpTag ) != 'C' ){
+      iErrorStop = 110;
+      iRc = XB_INVALID_PARAMETER;
+      throw iRc;
+    }
+    size_t lPrefixLen = sKeyPrefix.Len();
+    if( lPrefixLen == 0 )
+      return GetKeyCnt( vpTag, ulKeyCnt );
+    if( lPrefixLen > (size_t) GetKeyLen( vpTag ))
+      return XB_NO_ERROR;
+
+    iRc = FindKey( vpTag, sKeyPrefix.Str(), (xbInt32) lPrefixLen, 0 );
+    if( iRc == XB_NOT_FOUND || iRc == XB_EMPTY || iRc == XB_EOF )
+      return XB_NO_ERROR;
+    else if( iRc != XB_NO_ERROR ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+
+    // FindKey positions to the leftmost match, matching keys are contiguous from there
+    xbIxNode *np;
+    xbUInt32 ulLeafKeyCnt;
+    xbInt16  iKeyItemLen = GetKeyItemLen( vpTag );
+    xbBool   bDone = xbFalse;
+    while( !bDone && iRc == XB_NO_ERROR ){
+      np = GetCurNode( vpTag );
+      ulLeafKeyCnt = (xbUInt32) GetKeyCount( np );
+      if( ulLeafKeyCnt > 0 && memcmp( GetKeyData( np, (xbInt16) (ulLeafKeyCnt - 1), iKeyItemLen ), sKeyPrefix.Str(), lPrefixLen ) == 0 ){
+        ulKeyCnt += ulLeafKeyCnt - np->iCurKeyNo;
+        np->iCurKeyNo = ulLeafKeyCnt - 1;
+        iRc = GetNextKey( vpTag, 0 );
+      } else {
+        while( np->iCurKeyNo < ulLeafKeyCnt && memcmp( GetKeyData( np, (xbInt16) np->iCurKeyNo, iKeyItemLen ), sKeyPrefix.Str(), lPrefixLen ) == 0 ){
+          ulKeyCnt++;
+          np->iCurKeyNo++;
+        }
+        bDone = xbTrue;
+      }
+    }
+    if( iRc != XB_NO_ERROR && iRc != XB_EOF ){
+      iErrorStop = 130;
+      throw iRc;
+    }
+    iRc = XB_NO_ERROR;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbIx::GetKeyCnt() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Get the number of node levels for a given tag.
+/*!
+  The depth is the number of nodes read to reach a leaf from the root, counted on the
+  node chain left by positioning to the first key.  The tag is moved back to its current
+  key afterwards.  An empty tag has a depth of one.
+
+  @param vpTag Tag to get the depth of.
+  @param iDepth Output - Number of node levels in the tag.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIx::GetTagDepth( void *vpTag, xbInt16 &iDepth ){
+
+  xbInt16  iRc = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbUInt32 ulSaveRecNo = 0;
+  char     *cpSaveKey = NULL;
+  iDepth = 1;
+
+  try{
+    if( !vpTag ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+    cpSaveKey = SaveTagPos( vpTag, ulSaveRecNo );
+    if(( iRc = GetFirstKey( vpTag, 0 )) == XB_EMPTY ){
+      iRc = XB_NO_ERROR;
+    } else if( iRc != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    } else {
+      xbIxNode *np = GetCurNode( vpTag );
+      if( np ){
+        while( np->npPrev ){
+          iDepth++;
+          np = np->npPrev;
+        }
+      }
+    }
+    iRc = RestoreTagPos( vpTag, cpSaveKey, ulSaveRecNo );
+    cpSaveKey = NULL;
+    if( iRc != XB_NO_ERROR ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+  }
+  catch (xbInt16 iRc ){
+    if( cpSaveKey )
+      free( cpSaveKey );
+    xbString sMsg;
+    sMsg.Sprintf( "xbIx::GetTagDepth() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
 /***********************************************************************/
 //! @brief Get the key count for number of keys on a node.
 /*!
@@ -673,6 +968,24 @@ char * xbIx::GetKeyData( xbIxNode *np, xbInt16 iKeyNo, xbInt16 iKeyItemLen ) con
   return p;
 }
 /***********************************************************************/
+//! @brief Get the key expression for a given tag.
+/*!
+  @param vpTag Tag to retrieve the expression for.
+  @returns Pointer to the key expression, NULL if not available.
+*/
+xbExp *xbIx::GetKeyExp( const void * ) const {
+  return NULL;
+}
+/***********************************************************************/
+//! @brief Get the filter expression for a given tag.
+/*!
+  @param vpTag Tag to retrieve the expression for.
+  @returns Pointer to the filter expression, NULL if the tag is not filtered.
+*/
+xbExp *xbIx::GetKeyFilterExp( const void * ) const {
+  return NULL;
+}
+/***********************************************************************/
 //! @brief Get the next key for the current tag.
 /*!
   @returns <a href="xbretcod_8h.html">Return Codes</a>
@@ -690,6 +1003,74 @@ xbInt16 xbIx::GetNextKey( void *vpTag ){
   return GetNextKey( vpTag, 0 );
 }
 /***********************************************************************/
+//! @brief Get the next distinct key for the given tag.
+/*!
+  Position to the next key with a value different from the current key, without
+  retrieving the record.  If there is no current position, position to the first key.<br>
+  Use GetCurKeyVal to retrieve the key value.
+
+  @param vpTag Tag for next distinct key operation.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIx::GetNextDistinctKey( void *vpTag ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  char    *cpCurKey = NULL;
+
+  try{
+    if( !vpTag ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+    xbIxNode *np = GetCurNode( vpTag );
+    if( !np )
+      return GetFirstKey( vpTag, 0 );
+
+    char     cKeyType    = GetKeyType( vpTag );
+    size_t   lKeyLen     = (size_t) GetKeyLen( vpTag );
+    xbInt16  iKeyItemLen = GetKeyItemLen( vpTag );
+    xbUInt32 ulLeafKeyCnt;
+
+    if(( cpCurKey = (char *) malloc( lKeyLen )) == NULL ){
+      iErrorStop = 110;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    memcpy( cpCurKey, GetKeyData( np, (xbInt16) np->iCurKeyNo, iKeyItemLen ), lKeyLen );
+
+    xbBool bDone = xbFalse;
+    while( !bDone ){
+      // if the last key on the leaf is the same value, skip the rest of the leaf
+      ulLeafKeyCnt = (xbUInt32) GetKeyCount( np );
+      if( ulLeafKeyCnt > 0 && CompareKey( cKeyType, GetKeyData( np, (xbInt16) (ulLeafKeyCnt - 1), iKeyItemLen ), cpCurKey, lKeyLen ) == 0 )
+        np->iCurKeyNo = ulLeafKeyCnt - 1;
+
+      if(( iRc = GetNextKey( vpTag, 0 )) != XB_NO_ERROR ){
+        bDone = xbTrue;
+      } else {
+        np = GetCurNode( vpTag );
+        if( CompareKey( cKeyType, GetKeyData( np, (xbInt16) np->iCurKeyNo, iKeyItemLen ), cpCurKey, lKeyLen ) != 0 )
+          bDone = xbTrue;
+      }
+    }
+    if( iRc != XB_NO_ERROR && iRc != XB_EOF ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbIx::GetNextDistinctKey() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  if( cpCurKey )
+    free( cpCurKey );
+  return iRc;
+}
+/***********************************************************************/
 //! @brief Get the prev key for the current tag.
 /*!
   @returns <a href="xbretcod_8h.html">Return Codes</a>
@@ -719,6 +1100,52 @@ const xbString &xbIx::GetType() const {
 }
 
 
+/***********************************************************************/
+//! @brief Determine if a record update can change the key for a tag.
+/*!
+  Compares the fields read by the tag's key and filter expressions in the updated
+  record buffer against the original record buffer. Keys that read DATE(),
+  another table or an application function are always rebuilt.
+
+  @param vpTag Tag to check.
+  @returns xbTrue - The key has to be rebuilt.<br>
+           xbFalse - None of the fields the key depends on changed.
+*/
+xbBool xbIx::KeyUpdated( void *vpTag ) const {
+
+  xbExp *exp = GetKeyExp( vpTag );
+  if( !exp )
+    return xbTrue;
+
+  const char *cpBuf  = dbf->GetRecordBuf( 0 );
+  const char *cpBuf2 = dbf->GetRecordBuf( 1 );
+
+  // the delete flag decides if a key is kept in xbase mode
+  if( cpBuf[0] != cpBuf2[0] )
+    return xbTrue;
+
+  xbExp    *expFilter = GetKeyFilterExp( vpTag );
+  xbInt16  iFieldNo;
+  xbInt16  iFieldLen;
+  xbUInt32 ulOffset;
+  char     cFieldType;
+
+  for( xbInt16 i = 0; i < 2; i++ ){
+    if( i == 1 && !( exp = expFilter ))
+      break;
+    if( exp->GetDepFlags() & ( XB_EXP_DEP_EXTERNAL | XB_EXP_DEP_DATE ))
+      return xbTrue;
+    for( xbInt16 j = 0; j < exp->GetFieldDepCnt(); j++ ){
+      iFieldNo = exp->GetFieldDep( j );
+      if( dbf->GetFieldOffset( iFieldNo, ulOffset ) != XB_NO_ERROR || dbf->GetFieldLen( iFieldNo, iFieldLen ) != XB_NO_ERROR ||
+          dbf->GetFieldType( iFieldNo, cFieldType ) != XB_NO_ERROR || cFieldType == 'M' )
+        return xbTrue;
+      if( memcmp( cpBuf + ulOffset, cpBuf2 + ulOffset, (size_t) iFieldLen ))
+        return xbTrue;
+    }
+  }
+  return xbFalse;
+}
 /***********************************************************************/
 //! @brief Free an index node
 /*!
@@ -781,6 +1208,127 @@ xbInt16 xbIx::Open( const xbString & sFileName ){
   return iRc;
 }
 /***********************************************************************/
+//! @brief Check if a key is in a tag.
+/*!
+  Index only existence check, the table is not positioned and the tag is left on the
+  key it was on before the call.  Use this instead of FindKey() when the caller only
+  needs to know if the key exists, such as a duplicate check before an insert.
+
+  @param vpTag Tag to search.
+  @param vpKey Key to search for.
+  @param lKeyLen Length of the key.
+  @returns XB_NO_ERROR - Key found.<br>
+           XB_NOT_FOUND - Key not found.<br>
+           <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIx::ProbeKey( void *vpTag, const void *vpKey, xbInt32 lKeyLen ){
+
+  xbInt16  iRc = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbUInt32 ulSaveRecNo = 0;
+  char     *cpSaveKey = NULL;
+
+  try{
+    if( !vpTag ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+    cpSaveKey = SaveTagPos( vpTag, ulSaveRecNo );
+    xbInt16 iFindRc = FindKey( vpTag, vpKey, lKeyLen, 0 );
+    if( iFindRc != XB_NO_ERROR && iFindRc != XB_NOT_FOUND && iFindRc != XB_EOF ){
+      iErrorStop = 110;
+      iRc = iFindRc;
+      throw iRc;
+    }
+    iRc = RestoreTagPos( vpTag, cpSaveKey, ulSaveRecNo );
+    cpSaveKey = NULL;
+    if( iRc != XB_NO_ERROR ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+    iRc = ( iFindRc == XB_NO_ERROR ) ? XB_NO_ERROR : XB_NOT_FOUND;
+  }
+  catch (xbInt16 iRc ){
+    if( cpSaveKey )
+      free( cpSaveKey );
+    xbString sMsg;
+    sMsg.Sprintf( "xbIx::ProbeKey() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg );
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Restore a tag position saved with SaveTagPos().
+/*!
+  @private
+  The tag is positioned back on the saved key and record number.  If the key is no longer
+  in the tag, the tag is left where FindKey() positions it.
+
+  @param vpTag Tag to reposition.
+  @param cpSaveKey Key returned by SaveTagPos(), freed here.  NULL if the tag had no position.
+  @param ulSaveRecNo Record number returned by SaveTagPos().
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIx::RestoreTagPos( void *vpTag, char *cpSaveKey, xbUInt32 ulSaveRecNo ){
+
+  if( !cpSaveKey )
+    return XB_NO_ERROR;
+
+  xbInt16  iKeyItemLen = GetKeyItemLen( vpTag );
+  xbInt32  lKeyLen     = GetKeyLen( vpTag );
+  xbUInt32 ulRecNo;
+  xbIxNode *np;
+
+  // duplicate keys are in sequence, step through them to the saved record
+  xbInt16 iRc = FindKey( vpTag, (const void *) cpSaveKey, lKeyLen, 0 );
+  while( iRc == XB_NO_ERROR ){
+    if(( iRc = GetCurKeyRecNo( vpTag, ulRecNo )) != XB_NO_ERROR || ulRecNo == ulSaveRecNo )
+      break;
+    if(( iRc = GetNextKey( vpTag, 0 )) == XB_NO_ERROR ){
+      np = GetCurNode( vpTag );
+      if( !np || memcmp( GetKeyData( np, (xbInt16) np->iCurKeyNo, iKeyItemLen ), cpSaveKey, (size_t) lKeyLen ) != 0 )
+        break;
+    }
+  }
+  free( cpSaveKey );
+  return ( iRc == XB_NOT_FOUND || iRc == XB_EOF ) ? XB_NO_ERROR : iRc;
+}
+/***********************************************************************/
+//! @brief Save the current tag position.
+/*!
+  @private
+  Used by functions that walk a tag for statistics, so the caller's position is kept.
+
+  @param vpTag Tag to save the position of.
+  @param ulSaveRecNo Output - Record number of the current key.
+  @returns Copy of the current key, to be passed to RestoreTagPos().<br>
+           NULL if the tag is not positioned on a key.
+*/
+char *xbIx::SaveTagPos( void *vpTag, xbUInt32 &ulSaveRecNo ){
+
+  ulSaveRecNo = 0;
+  xbIxNode *np = GetCurNode( vpTag );
+  if( !np || np->iCurKeyNo >= (xbUInt32) GetKeyCount( np ) || !IsLeaf( vpTag, np ) ||
+      GetCurKeyRecNo( vpTag, ulSaveRecNo ) != XB_NO_ERROR )
+    return NULL;
+
+  xbInt32 lKeyLen = GetKeyLen( vpTag );
+  char *cpSaveKey = (char *) malloc( (size_t) lKeyLen );
+  if( cpSaveKey )
+    memcpy( cpSaveKey, GetKeyData( np, (xbInt16) np->iCurKeyNo, GetKeyItemLen( vpTag )), (size_t) lKeyLen );
+  return cpSaveKey;
+}
+/***********************************************************************/
+//! @brief Enable or disable the bloom filter for a tag.
+/*!
+  Bloom filters are not supported for this index type.
+  @returns XB_INVALID_OPTION
+*/
+xbInt16 xbIx::SetBloomFilter( void *, xbBool ){
+  return XB_INVALID_OPTION;
+}
+/***********************************************************************/
 //! @brief Set the current tag.
 /*!
   @param vpCurTag Pointer to tag to set as current.
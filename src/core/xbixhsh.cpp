@@ -0,0 +1,1558 @@
+/*  xbixhsh.cpp
+
+XBase64 Software Library
+
+Copyright (c) 1997,2003,2014,2022,2023,2024 Gary A Kunkel
+
+The xb64 software library is covered under the terms of the GPL Version 3, 2007 license.
+
+Email Contact:
+
+    XDB-devel@lists.sourceforge.net
+    XDB-users@lists.sourceforge.net
+
+   This module handles memory resident hash index logic.
+   Each tag is a chained hash table of key / record number entries.
+   Entries with the same key value are kept adjacent in the chain, in record number order.
+
+*/
+
+#include "xbase.h"
+
+#ifdef XB_HSH_SUPPORT
+
+namespace xb{
+
+/***********************************************************************/
+//! @brief Class constructor.
+/*!
+  @param dbf Pointer to dbf instance.
+*/
+xbIxHsh::xbIxHsh( xbDbf *dbf ) : xbIx( dbf ){
+  hshTagTbl  = NULL;
+  iTagUseCnt = 0;
+  sIxType    = "HSH";
+}
+/***********************************************************************/
+//! @brief Class destructor.
+xbIxHsh::~xbIxHsh(){
+  Close();
+}
+/***********************************************************************/
+//! @brief Add key.
+/*!
+  Add the key in the key buffer for the given record number.
+  If this is a unique index, this logic assumes the duplicate check logic was already done.
+
+  @param vpTag Tag to update.
+  @param ulRecNo Record number to add key for.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::AddKey( void *vpTag, xbUInt32 ulRecNo ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+
+  if( hpTag->iIxTagMode == XB_IX_DBASE_MODE && hpTag->bFoundSts )
+    return XB_NO_ERROR;
+
+  try{
+    xbHshEntry *npEntry;
+    if(( npEntry = (xbHshEntry *) malloc( sizeof( xbHshEntry ) + (size_t) hpTag->iKeyLen )) == NULL ){
+      iErrorStop = 100;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    npEntry->cpKey   = (char *) (npEntry + 1);
+    memcpy( npEntry->cpKey, hpTag->cpKeyBuf, (size_t) hpTag->iKeyLen );
+    npEntry->ulHash  = Hash( hpTag->cpKeyBuf, hpTag->iKeyLen );
+    npEntry->ulRecNo = ulRecNo;
+
+    // a new key value goes at the head of the chain
+    // an existing key value is inserted into its group of entries, by record number
+    xbHshEntry **npp = &hpTag->npBuckets[npEntry->ulHash & (hpTag->ulBucketCnt - 1)];
+    xbHshEntry **nppIns = npp;
+    while( *npp && ((*npp)->ulHash != npEntry->ulHash || memcmp( (*npp)->cpKey, npEntry->cpKey, (size_t) hpTag->iKeyLen )))
+      npp = &(*npp)->npNext;
+    if( *npp ){
+      while( *npp && (*npp)->ulHash == npEntry->ulHash && !memcmp( (*npp)->cpKey, npEntry->cpKey, (size_t) hpTag->iKeyLen ) && (*npp)->ulRecNo < ulRecNo )
+        npp = &(*npp)->npNext;
+      nppIns = npp;
+    }
+    npEntry->npNext = *nppIns;
+    *nppIns = npEntry;
+    hpTag->ulKeyCnt++;
+
+    // keep the load factor at or below one, if the table can't grow the chains get longer but still work
+    if( hpTag->ulKeyCnt > hpTag->ulBucketCnt && hpTag->ulBucketCnt < 0x40000000 )
+      Resize( hpTag, hpTag->ulBucketCnt << 1 );
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbIxHsh::AddKey() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Append node chain.
+/*!
+  Not used by hash indices, there are no nodes.
+  @returns void
+*/
+void xbIxHsh::AppendNodeChain( void *, xbIxNode * ){
+  return;
+}
+/***********************************************************************/
+//! @brief Build a key from the key expression.
+/*!
+  Copy the result of the last ProcessExpression call on the key expression into a key buffer.
+  Numeric and date keys are stored as xbDouble.
+
+  @param hpTag Tag to build key for.
+  @param cpKeyBuf Output - Key buffer, at least key length bytes.
+  @returns void
+*/
+void xbIxHsh::BuildKey( xbHshTag *hpTag, char *cpKeyBuf ){
+
+  if( hpTag->cKeyType == 'C' ){
+    hpTag->exp->GetStringResult( cpKeyBuf, (xbUInt32) hpTag->iKeyLen );
+  } else {
+    xbDouble d;
+    hpTag->exp->GetNumericResult( d );
+    if( d == 0 )        // negative zero must hash the same as zero
+      d = 0;
+    memcpy( cpKeyBuf, &d, 8 );
+  }
+}
+/***********************************************************************/
+//! @brief Check for duplicate key.
+/*!
+  @param vpTag Tag to check.
+  @returns XB_KEY_NOT_UNIQUE<br>XB_NO_ERROR
+*/
+xbInt16 xbIxHsh::CheckForDupKey( void *vpTag ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  hpTag->bFoundSts = xbFalse;
+
+  if( hpTag->bUnique && ( hpTag->iKeySts == XB_ADD_KEY || hpTag->iKeySts == XB_UPD_KEY )){
+    if( KeyExists( hpTag )){
+      if( hpTag->iIxTagMode == XB_IX_DBASE_MODE )
+        hpTag->bFoundSts = xbTrue;
+      else
+        return XB_KEY_NOT_UNIQUE;
+    }
+  }
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Check tag integrity.
+/*!
+  Check each record in the table has a corresponding entry in the tag, and the tag
+  has no extra entries.
+
+  @param vpTag Tag to check.
+  @param iOpt Output message destination<br>
+              0 = stdout<br>
+              1 = Syslog<br>
+              2 = Both<br>
+  @returns 1 - Unique Index - DBF records exist without corresponding index entries.<br>
+           <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::CheckTagIntegrity( void *vpTag, xbInt16 iOpt ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iRc2 = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  xbString sMsg;
+
+  try{
+    if( !hpTag ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+    xbUInt32 ulRecCnt = 0;
+    if(( iRc = dbf->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+
+    xbUInt32 ulFoundCnt   = 0;
+    xbUInt32 ulMissingCnt = 0;
+    xbBool   bFilter;
+    for( xbUInt32 ulRec = 1; ulRec <= ulRecCnt; ulRec++ ){
+      if(( iRc = dbf->GetRecord( ulRec )) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+      bFilter = xbTrue;
+      if( hpTag->filter ){
+        if(( iRc = hpTag->filter->ProcessExpression( 0 )) != XB_NO_ERROR ){
+          iErrorStop = 130;
+          throw iRc;
+        }
+        if(( iRc = hpTag->filter->GetBoolResult( bFilter )) != XB_NO_ERROR ){
+          iErrorStop = 140;
+          throw iRc;
+        }
+      }
+      if( !bFilter || ( hpTag->iIxTagMode == XB_IX_XBASE_MODE && dbf->RecordDeleted()))
+        continue;
+
+      if(( iRc = hpTag->exp->ProcessExpression( 0 )) != XB_NO_ERROR ){
+        iErrorStop = 150;
+        throw iRc;
+      }
+      BuildKey( hpTag, hpTag->cpKeyBuf );
+      if( FindEntry( hpTag, hpTag->cpKeyBuf, ulRec )){
+        ulFoundCnt++;
+      } else if( hpTag->bUnique && FindEntry( hpTag, hpTag->cpKeyBuf, 0 )){
+        iRc2 = 1;            // duplicate key not indexed, dBASE mode
+      } else {
+        ulMissingCnt++;
+        sMsg.Sprintf( "Tag [%s] missing entry for record [%ld]", hpTag->sTagName->Str(), ulRec );
+        xbase->WriteLogMessage( sMsg, iOpt );
+      }
+    }
+
+    sMsg.Sprintf( "Tag [%s] records checked [%ld] entries [%ld] missing [%ld]", hpTag->sTagName->Str(), ulRecCnt, hpTag->ulKeyCnt, ulMissingCnt );
+    xbase->WriteLogMessage( sMsg, iOpt );
+
+    if( ulMissingCnt > 0 || ulFoundCnt != hpTag->ulKeyCnt ){
+      iErrorStop = 160;
+      iRc = XB_INVALID_INDEX;
+      throw iRc;
+    }
+    iRc = iRc2;
+  }
+  catch (xbInt16 iRc ){
+    sMsg.Sprintf( "xbIxHsh::CheckTagIntegrity() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Remove all entries from a tag.
+/*!
+  The bucket array is kept, all buckets are set empty.
+  @param hpTag Tag to clear.
+  @returns void
+*/
+void xbIxHsh::ClearEntries( xbHshTag *hpTag ){
+
+  xbHshEntry *npEntry;
+  xbHshEntry *npNext;
+  for( xbUInt32 ul = 0; ul < hpTag->ulBucketCnt; ul++ ){
+    npEntry = hpTag->npBuckets[ul];
+    while( npEntry ){
+      npNext = npEntry->npNext;
+      free( npEntry );
+      npEntry = npNext;
+    }
+    hpTag->npBuckets[ul] = NULL;
+  }
+  hpTag->ulKeyCnt   = 0;
+  hpTag->npCurEntry = NULL;
+}
+/***********************************************************************/
+//! @brief Close the index.
+/*!
+  Release all tags.  There is no file to close, memory resident tags are discarded.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::Close(){
+
+  xbHshTag *hpNext;
+  while( hshTagTbl ){
+    hpNext = hshTagTbl->next;
+    FreeTag( hshTagTbl );
+    hshTagTbl = hpNext;
+  }
+  iTagUseCnt = 0;
+  xbIx::SetCurTag( (void *) NULL );
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Create key for a tag.
+/*!
+  @param vpTag Tag to create key for.
+  @param iOpt 0 Build a key for FindKey usage, only rec buf 0.<br>
+              1 Append Mode, Create key for an append, only use rec buf 0, set updated switch.<br>
+              2 Update Mode, Create old version and new version keys, check if different, set update switch appropriately.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::CreateKey( void *vpTag, xbInt16 iOpt ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  xbBool  bFilter0 = xbFalse;   // filter against RecBuf,  updated record buffer
+  xbBool  bFilter1 = xbFalse;   // filter against RecBuf2, original record buffer
+
+  try{
+    xbHshTag *hpTag = (xbHshTag *) vpTag;
+    hpTag->iKeySts = 0;
+
+    if( hpTag->filter ){
+      if(( iRc = hpTag->filter->ProcessExpression( 0 )) != XB_NO_ERROR ){
+        iErrorStop = 100;
+        throw iRc;
+      }
+      if(( iRc = hpTag->filter->GetBoolResult( bFilter0 )) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+    } else {
+      bFilter0 = xbTrue;
+    }
+
+    // if add request and filtered out, we're done
+    if( iOpt == 1 && !bFilter0 )
+      return XB_NO_ERROR;
+
+    if(( iRc = hpTag->exp->ProcessExpression( 0 )) != XB_NO_ERROR ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+    BuildKey( hpTag, hpTag->cpKeyBuf );
+
+    if( iOpt == 1 ){                 // Append
+      if( !( hpTag->iIxTagMode == XB_IX_XBASE_MODE && dbf->RecordDeleted()))
+        hpTag->iKeySts = XB_ADD_KEY;
+
+    } else if( iOpt == 2 ){          // Update
+
+      if( hpTag->filter ){
+        if(( iRc = hpTag->filter->ProcessExpression( 1 )) != XB_NO_ERROR ){
+          iErrorStop = 130;
+          throw iRc;
+        }
+        if(( iRc = hpTag->filter->GetBoolResult( bFilter1 )) != XB_NO_ERROR ){
+          iErrorStop = 140;
+          throw iRc;
+        }
+      } else {
+        bFilter1 = xbTrue;
+      }
+
+      if(( iRc = hpTag->exp->ProcessExpression( 1 )) != XB_NO_ERROR ){
+        iErrorStop = 150;
+        throw iRc;
+      }
+      BuildKey( hpTag, hpTag->cpKeyBuf2 );
+
+      // in xbase mode, deleted records are not indexed, verify the original key is present
+      if( hpTag->iIxTagMode == XB_IX_XBASE_MODE && bFilter1 && !FindEntry( hpTag, hpTag->cpKeyBuf2, dbf->GetCurRecNo()))
+        bFilter1 = xbFalse;
+
+      if( bFilter1 ){     // original key was indexed
+        if( !bFilter0 || ( hpTag->iIxTagMode == XB_IX_XBASE_MODE && dbf->RecordDeleted()))
+          hpTag->iKeySts = XB_DEL_KEY;
+        else if( memcmp( hpTag->cpKeyBuf, hpTag->cpKeyBuf2, (size_t) hpTag->iKeyLen ))
+          hpTag->iKeySts = XB_UPD_KEY;
+      } else {            // original key not indexed
+        if( bFilter0 && !( hpTag->iIxTagMode == XB_IX_XBASE_MODE && dbf->RecordDeleted()))
+          hpTag->iKeySts = XB_ADD_KEY;
+      }
+    }
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbIxHsh::CreateKey() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Create new tag.
+/*!
+  This routine creates a new, empty tag.  When complete, sets the cur tag pointer to
+  the newly created tag.  The dbf class loads the tag from the table with ReindexTag.
+
+  @param sName Tag Name.
+  @param sKey Key Expression.
+  @param sFilter Filter expression.
+  @param iDescending Not used, hash tags are not ordered.
+  @param iUnique xbTrue - Unique.<br>xbFalse - Not unique.
+  @param iOverlay Not used, there is no index file.
+  @param vpTag Output from method Pointer to vptag pointer.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::CreateTag( const xbString &sName, const xbString &sKey, const xbString &sFilter, xbInt16, xbInt16 iUnique, xbInt16, void **vpTag ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  xbHshTag *hpTag = NULL;
+
+  try{
+    // verify valid tag name
+    xbString sWorker = sName;
+    sWorker.Trim();
+    if( sWorker.Len() == 0 || sWorker.Len() > 10 ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+
+    // verify tag not already defined
+    if( iTagUseCnt > 0 && GetTag( sWorker )){
+      iErrorStop = 110;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+
+    if(( hpTag = (xbHshTag *) calloc( 1, sizeof( xbHshTag ))) == NULL ){
+      iErrorStop = 120;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    hpTag->sTagName = new xbString( sWorker );
+
+    // set up the filter expression
+    sWorker = sFilter;
+    sWorker.Trim();
+    if( sWorker.Len() > 0 ){
+      hpTag->sFiltExp = new xbString( sWorker );
+      hpTag->filter = new xbExp( dbf->GetXbasePtr());
+      if(( iRc = hpTag->filter->ParseExpression( dbf, sWorker )) != XB_NO_ERROR ){
+        iErrorStop = 130;
+        throw iRc;
+      }
+      if( hpTag->filter->GetReturnType() != 'L' ){
+        iErrorStop = 140;
+        iRc = XB_INVALID_TAG;
+        throw iRc;
+      }
+    }
+
+    // set up the key expression
+    sWorker = sKey;
+    sWorker.Trim();
+    if( sWorker.Len() == 0 ){
+      iErrorStop = 150;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+    hpTag->sKeyExp = new xbString( sWorker );
+    hpTag->exp = new xbExp( dbf->GetXbasePtr());
+    if(( iRc = hpTag->exp->ParseExpression( dbf, sWorker )) != XB_NO_ERROR ){
+      iErrorStop = 160;
+      throw iRc;
+    }
+
+    switch( hpTag->exp->GetReturnType()){
+      case XB_EXP_CHAR:
+        hpTag->cKeyType = 'C';
+        hpTag->iKeyLen  = (xbInt16) hpTag->exp->GetResultLen();
+        break;
+      case XB_EXP_NUMERIC:
+        hpTag->cKeyType = 'F';
+        hpTag->iKeyLen  = 8;
+        break;
+      case XB_EXP_DATE:
+        hpTag->cKeyType = 'D';
+        hpTag->iKeyLen  = 8;
+        break;
+      default:
+        iErrorStop = 170;
+        iRc = XB_INVALID_TAG;
+        throw iRc;
+    }
+    if( hpTag->iKeyLen < 1 ){
+      iErrorStop = 180;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+
+    hpTag->bUnique    = iUnique ? xbTrue : xbFalse;
+    hpTag->iIxTagMode = xbase->GetDefaultIxTagMode();
+
+    if(( hpTag->cpKeyBuf    = (char *) calloc( 1, (size_t) hpTag->iKeyLen + 1 )) == NULL ||
+       ( hpTag->cpKeyBuf2   = (char *) calloc( 1, (size_t) hpTag->iKeyLen + 1 )) == NULL ||
+       ( hpTag->cpSearchBuf = (char *) calloc( 1, (size_t) hpTag->iKeyLen + 1 )) == NULL ){
+      iErrorStop = 190;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    if(( iRc = Resize( hpTag, 64 )) != XB_NO_ERROR ){
+      iErrorStop = 200;
+      throw iRc;
+    }
+
+    // add to the end of the tag list
+    if( hshTagTbl ){
+      xbHshTag *hpLast = hshTagTbl;
+      while( hpLast->next )
+        hpLast = hpLast->next;
+      hpLast->next = hpTag;
+    } else {
+      hshTagTbl = hpTag;
+    }
+    iTagUseCnt++;
+    *vpTag = hpTag;
+    xbIx::SetCurTag( (void *) hpTag );
+  }
+  catch (xbInt16 iRc ){
+    if( hpTag )
+      FreeTag( hpTag );
+    xbString sMsg;
+    sMsg.Sprintf( "xbIxHsh::CreateTag() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Delete from node.
+/*!
+  Not used by hash indices, there are no nodes.
+  @returns XB_INVALID_OPTION
+*/
+xbInt16 xbIxHsh::DeleteFromNode( void *, xbIxNode *, xbInt16 ){
+  return XB_INVALID_OPTION;
+}
+/***********************************************************************/
+//! @brief Delete key.
+/*!
+  Delete the entry for the original key, in the second key buffer, and the current record.
+  If the entry is not in the tag, there is nothing to delete.
+
+  @param vpTag Tag to update.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::DeleteKey( void *vpTag ){
+
+  xbHshTag *hpTag  = (xbHshTag *) vpTag;
+  xbUInt32 ulRecNo = dbf->GetCurRecNo();
+  xbUInt32 ulHash  = Hash( hpTag->cpKeyBuf2, hpTag->iKeyLen );
+
+  xbHshEntry **npp = &hpTag->npBuckets[ulHash & (hpTag->ulBucketCnt - 1)];
+  while( *npp ){
+    if( (*npp)->ulRecNo == ulRecNo && (*npp)->ulHash == ulHash && !memcmp( (*npp)->cpKey, hpTag->cpKeyBuf2, (size_t) hpTag->iKeyLen )){
+      xbHshEntry *npEntry = *npp;
+      *npp = npEntry->npNext;
+      if( hpTag->npCurEntry == npEntry )
+        hpTag->npCurEntry = NULL;
+      free( npEntry );
+      hpTag->ulKeyCnt--;
+      return XB_NO_ERROR;
+    }
+    npp = &(*npp)->npNext;
+  }
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Delete a tag.
+/*!
+  @param vpTag Tag to delete.
+  @returns 1 - Last tag deleted, the index can be released.<br>
+           <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::DeleteTag( void *vpTag ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  xbHshTag *hpPrev = NULL;
+  xbHshTag *hp = hshTagTbl;
+
+  while( hp && hp != hpTag ){
+    hpPrev = hp;
+    hp = hp->next;
+  }
+  if( !hp )
+    return XB_INVALID_TAG;
+
+  if( hpPrev )
+    hpPrev->next = hp->next;
+  else
+    hshTagTbl = hp->next;
+  iTagUseCnt--;
+
+  if( GetCurTag() == vpTag )
+    xbIx::SetCurTag( (void *) hshTagTbl );
+  FreeTag( hp );
+
+  if( iTagUseCnt == 0 )
+    return 1;
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+#ifdef XB_DEBUG_SUPPORT
+//! @brief Dump the tag statistics.
+/*!
+  Dump the key and bucket counts for each tag, for debugging purposes.
+  @param iOpt Output message destination<br>
+              0 = stdout<br>
+              1 = Syslog<br>
+              2 = Both<br>
+  @returns XB_NO_ERROR
+*/
+xbInt16 xbIxHsh::DumpHeader( xbInt16 iOpt, xbInt16 ){
+
+  xbString s;
+  xbHshTag *hpTag = hshTagTbl;
+  xbHshEntry *npEntry;
+  xbUInt32 ulUsed;
+  xbUInt32 ulChainLen;
+  xbUInt32 ulMaxChainLen;
+
+  s.Sprintf( "Hash Index for %s, Tag Count = %d", dbf->GetTblAlias().Str(), iTagUseCnt );
+  xbase->WriteLogMessage( s, iOpt );
+  while( hpTag ){
+    ulUsed = 0;
+    ulMaxChainLen = 0;
+    for( xbUInt32 ul = 0; ul < hpTag->ulBucketCnt; ul++ ){
+      if(( npEntry = hpTag->npBuckets[ul] ) != NULL ){
+        ulUsed++;
+        ulChainLen = 0;
+        while( npEntry ){
+          ulChainLen++;
+          npEntry = npEntry->npNext;
+        }
+        if( ulChainLen > ulMaxChainLen )
+          ulMaxChainLen = ulChainLen;
+      }
+    }
+    s.Sprintf( "Tag [%s] Key [%s] Type [%c] Len [%d] Unique [%d] Keys [%ld] Buckets [%ld] Used [%ld] Max Chain [%ld]",
+               hpTag->sTagName->Str(), hpTag->sKeyExp->Str(), hpTag->cKeyType, hpTag->iKeyLen, hpTag->bUnique,
+               hpTag->ulKeyCnt, hpTag->ulBucketCnt, ulUsed, ulMaxChainLen );
+    xbase->WriteLogMessage( s, iOpt );
+    hpTag = hpTag->next;
+  }
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Dump the entries for a tag.
+/*!
+  @param vpTag Tag to dump.
+  @param iOutputOpt Output message destination<br>
+              0 = stdout<br>
+              1 = Syslog<br>
+              2 = Both<br>
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::DumpIxForTag( void *vpTag, xbInt16 iOutputOpt ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  if( !hpTag )
+    return XB_INVALID_TAG;
+
+  xbString s;
+  xbString sKey;
+  xbDouble d;
+  xbHshEntry *npEntry;
+  for( xbUInt32 ul = 0; ul < hpTag->ulBucketCnt; ul++ ){
+    npEntry = hpTag->npBuckets[ul];
+    while( npEntry ){
+      if( hpTag->cKeyType == 'C' ){
+        sKey.Set( npEntry->cpKey, (xbUInt32) hpTag->iKeyLen );
+      } else {
+        memcpy( &d, npEntry->cpKey, 8 );
+        sKey.Sprintf( "%f", d );
+      }
+      s.Sprintf( "Bucket [%ld] Rec [%ld] Key [%s]", ul, npEntry->ulRecNo, sKey.Str());
+      xbase->WriteLogMessage( s, iOutputOpt );
+      npEntry = npEntry->npNext;
+    }
+  }
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Dump the index node chain.
+/*!
+  Stub, there are no nodes.
+  @returns void
+*/
+void xbIxHsh::DumpIxNodeChain( void *, xbInt16 ) const {
+  return;
+}
+/***********************************************************************/
+//! @brief Dump the tag blocks.
+/*!
+  Stub, there are no blocks.
+  @returns XB_NO_ERROR
+*/
+xbInt16 xbIxHsh::DumpTagBlocks( xbInt16, void * ){
+  return XB_NO_ERROR;
+}
+#endif   // XB_DEBUG_SUPPORT
+/***********************************************************************/
+//! @brief Find an entry.
+/*!
+  @param hpTag Tag to search.
+  @param cpKey Full length key to search for.
+  @param ulRecNo Record number to match, or 0 for the first entry with the key.
+  @returns Pointer to the entry, NULL if not found.
+*/
+xbHshEntry *xbIxHsh::FindEntry( xbHshTag *hpTag, const char *cpKey, xbUInt32 ulRecNo ) const {
+
+  xbUInt32 ulHash = Hash( cpKey, hpTag->iKeyLen );
+  xbHshEntry *npEntry = hpTag->npBuckets[ulHash & (hpTag->ulBucketCnt - 1)];
+  while( npEntry ){
+    if( npEntry->ulHash == ulHash && !memcmp( npEntry->cpKey, cpKey, (size_t) hpTag->iKeyLen ) &&
+      ( ulRecNo == 0 || npEntry->ulRecNo == ulRecNo ))
+      return npEntry;
+    npEntry = npEntry->npNext;
+  }
+  return NULL;
+}
+/***********************************************************************/
+//! @brief Find key.
+/*!
+  Exact match lookup.  Character keys shorter than the key length are padded with spaces.
+  Numeric and date keys are passed as an eight byte xbDouble, or a twelve byte xbBcd.<br>
+  On success the tag is positioned to the first entry for the key.  If the key is not found,
+  the tag position is not changed.
+
+  @param vpTag Tag to search.
+  @param vpKey Key to search for.
+  @param lKeyLen Length of the search key.
+  @param iRetrieveSw xbTrue - Retrieve the record if key found.<br>
+                     xbFalse - Don't retrieve record, check for key existence only.
+  @returns XB_NO_ERROR - Key found.<br>
+           XB_NOT_FOUND - Key not found.<br>
+           <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::FindKey( void *vpTag, const void *vpKey, xbInt32 lKeyLen, xbInt16 iRetrieveSw ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  if( !hpTag )
+    return XB_INVALID_TAG;
+
+  const char *cpKey = (const char *) vpKey;
+  if( hpTag->cKeyType == 'C' ){
+    if( lKeyLen > hpTag->iKeyLen )
+      return XB_NOT_FOUND;
+    if( lKeyLen < hpTag->iKeyLen ){
+      memcpy( hpTag->cpSearchBuf, vpKey, (size_t) lKeyLen );
+      memset( hpTag->cpSearchBuf + lKeyLen, 0x20, (size_t) (hpTag->iKeyLen - lKeyLen));
+      cpKey = hpTag->cpSearchBuf;
+    }
+  } else {
+    xbDouble d;
+    if( lKeyLen == 8 ){
+      memcpy( &d, vpKey, 8 );
+    } else if( lKeyLen == 12 ){
+      xbBcd bcd( vpKey );
+      bcd.ToDouble( d );
+    } else {
+      return XB_INVALID_PARAMETER;
+    }
+    if( d == 0 )
+      d = 0;
+    memcpy( hpTag->cpSearchBuf, &d, 8 );
+    cpKey = hpTag->cpSearchBuf;
+  }
+
+  xbHshEntry *npEntry = FindEntry( hpTag, cpKey, 0 );
+  if( !npEntry )
+    return XB_NOT_FOUND;
+  return PositionTo( hpTag, npEntry, iRetrieveSw );
+}
+/***********************************************************************/
+//! @brief Find the key for the current record.
+/*!
+  @param vpTag Tag to search.
+  @param iRetrieveSw xbTrue - Retrieve the record if found.<br>
+                     xbFalse - Don't retrieve the record.
+  @returns XB_NO_ERROR - Entry found.<br>
+           XB_NOT_FOUND - Entry not found.<br>
+           <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::FindKeyForCurRec( void *vpTag, xbInt16 iRetrieveSw ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+
+  if(( iRc = CreateKey( vpTag, 0 )) < XB_NO_ERROR )
+    return iRc;
+
+  xbHshEntry *npEntry = FindEntry( hpTag, hpTag->cpKeyBuf, dbf->GetCurRecNo());
+  if( !npEntry )
+    return XB_NOT_FOUND;
+  return PositionTo( hpTag, npEntry, iRetrieveSw );
+}
+/***********************************************************************/
+//! @brief Release a tag and all its entries.
+/*!
+  The tag must already be removed from the tag list.
+  @param hpTag Tag to free.
+  @returns void
+*/
+void xbIxHsh::FreeTag( xbHshTag *hpTag ){
+
+  if( hpTag->npBuckets ){
+    ClearEntries( hpTag );
+    free( hpTag->npBuckets );
+  }
+  if( hpTag->cpKeyBuf )
+    free( hpTag->cpKeyBuf );
+  if( hpTag->cpKeyBuf2 )
+    free( hpTag->cpKeyBuf2 );
+  if( hpTag->cpSearchBuf )
+    free( hpTag->cpSearchBuf );
+  if( hpTag->exp )
+    delete hpTag->exp;
+  if( hpTag->filter )
+    delete hpTag->filter;
+  if( hpTag->sTagName )
+    delete hpTag->sTagName;
+  if( hpTag->sKeyExp )
+    delete hpTag->sKeyExp;
+  if( hpTag->sFiltExp )
+    delete hpTag->sFiltExp;
+  free( hpTag );
+}
+/***********************************************************************/
+xbInt16 xbIxHsh::GetCurKeyVal( void *vpTag, xbString &s ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  if( !hpTag )
+    return XB_INVALID_TAG;
+  if( !hpTag->npCurEntry )
+    return XB_INVALID_KEYNO;
+  s.Set( hpTag->npCurEntry->cpKey, (xbUInt32) hpTag->iKeyLen );
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+xbInt16 xbIxHsh::GetCurKeyVal( void *vpTag, xbDouble &d ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  if( !hpTag )
+    return XB_INVALID_TAG;
+  if( !hpTag->npCurEntry )
+    return XB_INVALID_KEYNO;
+  if( hpTag->cKeyType == 'C' )
+    return XB_INVALID_PARAMETER;
+  memcpy( &d, hpTag->npCurEntry->cpKey, 8 );
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+xbInt16 xbIxHsh::GetCurKeyVal( void *vpTag, xbDate &dt ){
+
+  xbDouble d;
+  xbInt16 iRc;
+  if(( iRc = GetCurKeyVal( vpTag, d )) != XB_NO_ERROR )
+    return iRc;
+  dt.JulToDate8( (xbInt32) d );
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Get the current node.
+/*!
+  @returns NULL, hash indices have no nodes.
+*/
+xbIxNode *xbIxHsh::GetCurNode( void * ) const {
+  return NULL;
+}
+/***********************************************************************/
+//! @brief Get the number of distinct keys for a given tag.
+/*!
+  Entries with the same key are adjacent, one pass over the buckets counts the distinct keys.
+  @param vpTag Tag to count keys on.
+  @param ulKeyCnt Output - Number of distinct keys in the tag.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::GetDistinctKeyCnt( void *vpTag, xbUInt32 &ulKeyCnt ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  ulKeyCnt = 0;
+  if( !hpTag )
+    return XB_INVALID_TAG;
+
+  xbHshEntry *npEntry;
+  for( xbUInt32 ul = 0; ul < hpTag->ulBucketCnt; ul++ ){
+    npEntry = hpTag->npBuckets[ul];
+    while( npEntry ){
+      if( !npEntry->npNext || npEntry->npNext->ulHash != npEntry->ulHash ||
+           memcmp( npEntry->npNext->cpKey, npEntry->cpKey, (size_t) hpTag->iKeyLen ))
+        ulKeyCnt++;
+      npEntry = npEntry->npNext;
+    }
+  }
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Get the first key for the given tag.
+/*!
+  Hash tags are not ordered, the first key is the first entry in the first non empty bucket.
+  @param vpTag Tag to retrieve first key on.
+  @param iRetrieveSw xbTrue - Retrieve the record on success.<br>
+                     xbFalse - Don't retrieve record.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::GetFirstKey( void *vpTag, xbInt16 iRetrieveSw ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  if( !hpTag )
+    return XB_INVALID_TAG;
+
+  for( xbUInt32 ul = 0; ul < hpTag->ulBucketCnt; ul++ ){
+    if( hpTag->npBuckets[ul] )
+      return PositionTo( hpTag, hpTag->npBuckets[ul], iRetrieveSw );
+  }
+  hpTag->npCurEntry = NULL;
+  return XB_EMPTY;
+}
+/***********************************************************************/
+//! @brief Get the mode for the given tag.
+/*!
+  @param vpTag Tag to retrieve mode from.
+  @returns One of XB_IX_DBASE_MODE or XB_IX_XBASE_MODE
+*/
+xbInt16 xbIxHsh::GetIxTagMode( const void *vpTag ) const {
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  return hpTag->iIxTagMode;
+}
+/***********************************************************************/
+//! @brief Get the number of keys for a given tag.
+/*!
+  @param vpTag Tag to count keys on.
+  @param ulKeyCnt Output - Number of keys in the tag.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::GetKeyCnt( void *vpTag, xbUInt32 &ulKeyCnt ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  if( !hpTag ){
+    ulKeyCnt = 0;
+    return XB_INVALID_TAG;
+  }
+  ulKeyCnt = hpTag->ulKeyCnt;
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Get the number of keys beginning with a given prefix.
+/*!
+  Hash tags are not ordered, all entries are compared.  Applies to character tags only.
+  @param vpTag Tag to count keys on.
+  @param sKeyPrefix Leading characters of the keys to count.  An empty prefix counts all keys.
+  @param ulKeyCnt Output - Number of keys matching the prefix.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::GetKeyCnt( void *vpTag, const xbString &sKeyPrefix, xbUInt32 &ulKeyCnt ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  ulKeyCnt = 0;
+  if( !hpTag )
+    return XB_INVALID_TAG;
+  if( hpTag->cKeyType != 'C' )
+    return XB_INVALID_PARAMETER;
+
+  size_t lPrefixLen = sKeyPrefix.Len();
+  if( lPrefixLen == 0 )
+    return GetKeyCnt( vpTag, ulKeyCnt );
+  if( lPrefixLen > (size_t) hpTag->iKeyLen )
+    return XB_NO_ERROR;
+
+  xbHshEntry *npEntry;
+  for( xbUInt32 ul = 0; ul < hpTag->ulBucketCnt; ul++ ){
+    npEntry = hpTag->npBuckets[ul];
+    while( npEntry ){
+      if( !memcmp( npEntry->cpKey, sKeyPrefix.Str(), lPrefixLen ))
+        ulKeyCnt++;
+      npEntry = npEntry->npNext;
+    }
+  }
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Get the key expression for the given tag.
+/*!
+  @param vpTag Tag to retrieve key expression from tag.
+  @returns Key expression.
+*/
+xbString &xbIxHsh::GetKeyExpression( const void *vpTag ) const {
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  return *hpTag->sKeyExp;
+}
+/***********************************************************************/
+//! @brief Get the key filter for the given tag.
+/*!
+  @param vpTag Tag to retrieve filter expression from tag (if it exists).
+  @returns Key filter.
+*/
+xbString &xbIxHsh::GetKeyFilter( const void *vpTag ) const {
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  if( hpTag->sFiltExp )
+    return *hpTag->sFiltExp;
+  else
+    return sNullString;
+}
+/***********************************************************************/
+//! @brief Get the key item length for the given tag.
+/*!
+  @param vpTag Tag to retrieve key item length for.
+  @returns Key length, there are no pointers stored with the key.
+*/
+xbInt16 xbIxHsh::GetKeyItemLen( const void *vpTag ) const {
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  return hpTag->iKeyLen;
+}
+/***********************************************************************/
+//! @brief Get the key length for the given tag.
+/*!
+  @param vpTag Tag to retrieve key length for.
+  @returns Key length.
+*/
+xbInt32 xbIxHsh::GetKeyLen( const void *vpTag ) const {
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  return hpTag->iKeyLen;
+}
+/***********************************************************************/
+//! @brief Get key pointer.
+/*!
+  Not used by hash indices, there are no nodes.
+  @returns XB_INVALID_OPTION
+*/
+xbInt16 xbIxHsh::GetKeyPtr( void *, xbInt16, xbIxNode *, xbUInt32 &ulKeyPtr ) const {
+  ulKeyPtr = 0;
+  return XB_INVALID_OPTION;
+}
+/***********************************************************************/
+//! @brief Get the key expression for a given tag.
+/*!
+  @param vpTag Tag to retrieve the expression for.
+  @returns Pointer to the key expression.
+*/
+xbExp *xbIxHsh::GetKeyExp( const void *vpTag ) const {
+  return ((const xbHshTag *) vpTag)->exp;
+}
+/***********************************************************************/
+//! @brief Get the filter expression for a given tag.
+/*!
+  @param vpTag Tag to retrieve the expression for.
+  @returns Pointer to the filter expression, NULL if the tag is not filtered.
+*/
+xbExp *xbIxHsh::GetKeyFilterExp( const void *vpTag ) const {
+  const xbHshTag *hpTag = (const xbHshTag *) vpTag;
+  return hpTag->filter;
+}
+/***********************************************************************/
+//! @brief Returns key update status.
+/*!
+  @param vpTag Tag to check status on.
+  @returns XB_UPD_KEY  Key updated.<br>
+           XB_DEL_KEY  Key deleted.<br>
+           XB_ADD_KEY  Key added.<br>
+           0           No key updates
+*/
+xbInt16 xbIxHsh::GetKeySts( void *vpTag ) const {
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  return hpTag->iKeySts;
+}
+/***********************************************************************/
+char xbIxHsh::GetKeyType( const void *vpTag ) const {
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  return hpTag->cKeyType;
+}
+/***********************************************************************/
+//! @brief Get the last key for the given tag.
+/*!
+  @param vpTag Tag to retrieve last key on.
+  @param iRetrieveSw xbTrue - Retrieve the record on success.<br>
+                     xbFalse - Don't retrieve record.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::GetLastKey( void *vpTag, xbInt16 iRetrieveSw ){
+  return GetLastKey( 0, vpTag, iRetrieveSw );
+}
+/***********************************************************************/
+//! @brief Get the last key for the given tag.
+/*!
+  Hash tags are not ordered, the last key is the last entry in the last non empty bucket.
+  @param vpTag Tag to retrieve last key on.
+  @param iRetrieveSw xbTrue - Retrieve the record on success.<br>
+                     xbFalse - Don't retrieve record.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::GetLastKey( xbUInt32, void *vpTag, xbInt16 iRetrieveSw ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  if( !hpTag )
+    return XB_INVALID_TAG;
+
+  xbUInt32 ul = hpTag->ulBucketCnt;
+  xbHshEntry *npEntry;
+  while( ul > 0 ){
+    ul--;
+    if(( npEntry = hpTag->npBuckets[ul] ) != NULL ){
+      while( npEntry->npNext )
+        npEntry = npEntry->npNext;
+      return PositionTo( hpTag, npEntry, iRetrieveSw );
+    }
+  }
+  hpTag->npCurEntry = NULL;
+  return XB_EMPTY;
+}
+/***********************************************************************/
+//! @brief Get the next distinct key for the given tag.
+/*!
+  Position to the next key with a value different from the current key, without
+  retrieving the record.  If there is no current position, position to the first key.
+
+  @param vpTag Tag for next distinct key operation.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::GetNextDistinctKey( void *vpTag ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  if( !hpTag )
+    return XB_INVALID_TAG;
+  if( !hpTag->npCurEntry )
+    return GetFirstKey( vpTag, 0 );
+
+  // skip to the last entry of the current key group
+  xbHshEntry *npEntry = hpTag->npCurEntry;
+  while( npEntry->npNext && npEntry->npNext->ulHash == npEntry->ulHash &&
+        !memcmp( npEntry->npNext->cpKey, npEntry->cpKey, (size_t) hpTag->iKeyLen ))
+    npEntry = npEntry->npNext;
+  hpTag->npCurEntry = npEntry;
+  return GetNextKey( vpTag, 0 );
+}
+/***********************************************************************/
+//! @brief Get the next key for the given tag.
+/*!
+  If there is no current position, position to the first key.
+  @param vpTag Tag to retrieve next key on.
+  @param iRetrieveSw xbTrue - Retrieve the record on success.<br>
+                     xbFalse - Don't retrieve record.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::GetNextKey( void *vpTag, xbInt16 iRetrieveSw ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  if( !hpTag )
+    return XB_INVALID_TAG;
+  if( !hpTag->npCurEntry )
+    return GetFirstKey( vpTag, iRetrieveSw );
+
+  if( hpTag->npCurEntry->npNext )
+    return PositionTo( hpTag, hpTag->npCurEntry->npNext, iRetrieveSw );
+
+  for( xbUInt32 ul = (hpTag->npCurEntry->ulHash & (hpTag->ulBucketCnt - 1)) + 1; ul < hpTag->ulBucketCnt; ul++ ){
+    if( hpTag->npBuckets[ul] )
+      return PositionTo( hpTag, hpTag->npBuckets[ul], iRetrieveSw );
+  }
+  return XB_EOF;
+}
+/***********************************************************************/
+//! @brief Get the previous key for the given tag.
+/*!
+  If there is no current position, position to the last key.
+  @param vpTag Tag to retrieve previous key on.
+  @param iRetrieveSw xbTrue - Retrieve the record on success.<br>
+                     xbFalse - Don't retrieve record.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::GetPrevKey( void *vpTag, xbInt16 iRetrieveSw ){
+
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  if( !hpTag )
+    return XB_INVALID_TAG;
+  if( !hpTag->npCurEntry )
+    return GetLastKey( 0, vpTag, iRetrieveSw );
+
+  xbUInt32 ul = hpTag->npCurEntry->ulHash & (hpTag->ulBucketCnt - 1);
+  xbHshEntry *npEntry = hpTag->npBuckets[ul];
+  if( npEntry != hpTag->npCurEntry ){
+    while( npEntry->npNext != hpTag->npCurEntry )
+      npEntry = npEntry->npNext;
+    return PositionTo( hpTag, npEntry, iRetrieveSw );
+  }
+  while( ul > 0 ){
+    ul--;
+    if(( npEntry = hpTag->npBuckets[ul] ) != NULL ){
+      while( npEntry->npNext )
+        npEntry = npEntry->npNext;
+      return PositionTo( hpTag, npEntry, iRetrieveSw );
+    }
+  }
+  return XB_BOF;
+}
+/***********************************************************************/
+//! @brief Get the sort order for the given tag.
+/*!
+  @returns xbFalse, hash tags are not ordered.
+*/
+xbBool xbIxHsh::GetSortOrder( void * ) const {
+  return xbFalse;
+}
+/***********************************************************************/
+//! @brief Get tag for tag number.
+/*!
+  @param iTagNo - Zero based, which tag to retrieve.
+  @returns Pointer to hash tag for a given tag number, NULL if not found.
+*/
+void *xbIxHsh::GetTag( xbInt16 iTagNo ) const {
+
+  xbHshTag *hpTag = hshTagTbl;
+  xbInt16 i = 0;
+  while( hpTag && i < iTagNo ){
+    hpTag = hpTag->next;
+    i++;
+  }
+  return (void *) hpTag;
+}
+/***********************************************************************/
+//! @brief Get tag for tag name.
+/*!
+  @param sTagName - Tag name to retrieve.
+  @returns Pointer to hash tag for a given tag name, NULL if not found.
+*/
+void *xbIxHsh::GetTag( xbString &sTagName ) const {
+
+  xbHshTag *hpTag = hshTagTbl;
+  while( hpTag && *hpTag->sTagName != sTagName )
+    hpTag = hpTag->next;
+  return (void *) hpTag;
+}
+/***********************************************************************/
+xbInt16 xbIxHsh::GetTagCount() const {
+  return iTagUseCnt;
+}
+/***********************************************************************/
+xbString &xbIxHsh::GetTagName( void *vpTag ) const {
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  return *hpTag->sTagName;
+}
+/***********************************************************************/
+const char *xbIxHsh::GetTagName( void *vpTag, xbInt16 ) const {
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  return hpTag->sTagName->Str();
+}
+/***********************************************************************/
+void xbIxHsh::GetTagName( void *vpTag, xbString &sTagName ){
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  sTagName = hpTag->sTagName->Str();
+}
+/***********************************************************************/
+//! @brief Determine unique setting for given tag.
+/*!
+  @param vpTag Tag to check.
+  @returns xbTrue if unique key.
+*/
+xbBool xbIxHsh::GetUnique( void *vpTag ) const {
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  return hpTag->bUnique;
+}
+/***********************************************************************/
+//! @brief Hash a key.
+/*!
+  32 bit FNV-1a hash.
+  @param cpKey Pointer to key.
+  @param iKeyLen Length of key.
+  @returns Hash value.
+*/
+xbUInt32 xbIxHsh::Hash( const char *cpKey, xbInt16 iKeyLen ) const {
+
+  const unsigned char *p = (const unsigned char *) cpKey;
+  xbUInt32 ulHash = 2166136261U;
+  for( xbInt16 i = 0; i < iKeyLen; i++ ){
+    ulHash ^= p[i];
+    ulHash *= 16777619U;
+  }
+  return ulHash;
+}
+/***********************************************************************/
+//! @brief Insert interior node.
+/*!
+  Not used by hash indices, there are no nodes.
+  @returns XB_INVALID_OPTION
+*/
+xbInt16 xbIxHsh::InsertNodeI( void *, xbIxNode *, xbInt16, xbUInt32 ){
+  return XB_INVALID_OPTION;
+}
+/***********************************************************************/
+//! @brief Insert leaf node.
+/*!
+  Not used by hash indices, there are no nodes.
+  @returns XB_INVALID_OPTION
+*/
+xbInt16 xbIxHsh::InsertNodeL( void *, xbIxNode *, xbInt16, char *, xbUInt32 ){
+  return XB_INVALID_OPTION;
+}
+/***********************************************************************/
+//! @brief Determine if node is a leaf.
+/*!
+  @returns xbTrue, entries are all at one level.
+*/
+xbBool xbIxHsh::IsLeaf( void *, xbIxNode * ) const {
+  return xbTrue;
+}
+/***********************************************************************/
+//! @brief Determine if the key in the key buffer exists.
+/*!
+  This method assumes the key has already been built.
+  @param vpTag Tag to check.
+  @returns 1 - Key exists.<br>0 - Key does not exist.
+*/
+xbInt16 xbIxHsh::KeyExists( void *vpTag ){
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  return FindEntry( hpTag, hpTag->cpKeyBuf, 0 ) ? 1 : 0;
+}
+/***********************************************************************/
+//! @brief Position the tag to an entry.
+/*!
+  @param hpTag Tag to position.
+  @param npEntry Entry to position to.
+  @param iRetrieveSw xbTrue - Retrieve the record.<br>
+                     xbFalse - Don't retrieve record.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::PositionTo( xbHshTag *hpTag, xbHshEntry *npEntry, xbInt16 iRetrieveSw ){
+  hpTag->npCurEntry = npEntry;
+  if( iRetrieveSw )
+    return dbf->GetRecord( npEntry->ulRecNo );
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Read head block.
+/*!
+  Stub, there is no index file.
+  @returns XB_NO_ERROR
+*/
+xbInt16 xbIxHsh::ReadHeadBlock( xbInt16 ){
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Reindex a tag.
+/*!
+  Discard all entries and reload the tag from the table.
+  The bucket array is sized for the record count up front, so the table is not resized during the load.
+
+  @param vpTag Pointer to tag pointer.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::ReindexTag( void **vpTag ){
+
+  xbInt16  iRc = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbHshTag *hpTag = NULL;
+  xbString sMsg;
+
+  try{
+    if( !vpTag || !*vpTag )
+      return XB_INVALID_TAG;
+    hpTag = (xbHshTag *) *vpTag;
+
+    sMsg.Sprintf( "Reindex Tag for Table [%s] Tag [%s]", dbf->GetTblAlias().Str(), hpTag->sTagName->Str());
+    xbase->WriteLogMessage( sMsg.Str());
+
+    xbUInt32 ulRecCnt = 0;
+    if(( iRc = dbf->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+
+    ClearEntries( hpTag );
+    xbUInt32 ulNewBucketCnt = 64;
+    while( ulNewBucketCnt < ulRecCnt && ulNewBucketCnt < 0x40000000 )
+      ulNewBucketCnt <<= 1;
+    if( ulNewBucketCnt != hpTag->ulBucketCnt ){
+      if(( iRc = Resize( hpTag, ulNewBucketCnt )) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+    }
+
+    xbBool bAddKey;
+    for( xbUInt32 ulRec = 1; ulRec <= ulRecCnt; ulRec++ ){
+      if(( iRc = dbf->GetRecord( ulRec )) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+      if(( iRc = CreateKey( hpTag, 1 )) != XB_NO_ERROR ){
+        iErrorStop = 130;
+        throw iRc;
+      }
+      if( hpTag->iKeySts == XB_ADD_KEY ){
+        bAddKey = xbTrue;
+        if( hpTag->bUnique ){
+          iRc = CheckForDupKey( hpTag );
+          if( hpTag->iIxTagMode == XB_IX_DBASE_MODE && hpTag->bFoundSts ){
+            bAddKey = xbFalse;
+          } else if( iRc == XB_KEY_NOT_UNIQUE ){
+            iErrorStop = 140;
+            throw iRc;
+          }
+        }
+        if( bAddKey ){
+          if(( iRc = AddKey( hpTag, ulRec )) != XB_NO_ERROR ){
+            iErrorStop = 150;
+            throw iRc;
+          }
+        }
+      }
+    }
+  }
+  catch (xbInt16 iRc ){
+    sMsg.Sprintf( "xbIxHsh::ReindexTag() Exception Caught. Error Stop = [%d] iRc = [%d] Tag: [%s] Rec No: [%ld]",
+      iErrorStop, iRc, hpTag ? hpTag->sTagName->Str() : "", dbf->GetCurRecNo());
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Resize the bucket array.
+/*!
+  Entries are moved to the new array in chain order, so entries with the same key stay adjacent
+  and in record number order.  On failure the tag is left unchanged.
+
+  @param hpTag Tag to resize.
+  @param ulNewBucketCnt New number of buckets, must be a power of two.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::Resize( xbHshTag *hpTag, xbUInt32 ulNewBucketCnt ){
+
+  xbHshEntry **npNewBuckets;
+  xbHshEntry **npTails;
+  if(( npNewBuckets = (xbHshEntry **) calloc( ulNewBucketCnt, sizeof( xbHshEntry * ))) == NULL )
+    return XB_NO_MEMORY;
+
+  if( hpTag->npBuckets ){
+    if(( npTails = (xbHshEntry **) calloc( ulNewBucketCnt, sizeof( xbHshEntry * ))) == NULL ){
+      free( npNewBuckets );
+      return XB_NO_MEMORY;
+    }
+    xbHshEntry *npEntry;
+    xbHshEntry *npNext;
+    xbUInt32   ulBucket;
+    for( xbUInt32 ul = 0; ul < hpTag->ulBucketCnt; ul++ ){
+      npEntry = hpTag->npBuckets[ul];
+      while( npEntry ){
+        npNext = npEntry->npNext;
+        npEntry->npNext = NULL;
+        ulBucket = npEntry->ulHash & (ulNewBucketCnt - 1);
+        if( npTails[ulBucket] )
+          npTails[ulBucket]->npNext = npEntry;
+        else
+          npNewBuckets[ulBucket] = npEntry;
+        npTails[ulBucket] = npEntry;
+        npEntry = npNext;
+      }
+    }
+    free( npTails );
+    free( hpTag->npBuckets );
+  }
+  hpTag->npBuckets   = npNewBuckets;
+  hpTag->ulBucketCnt = ulNewBucketCnt;
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+xbInt16 xbIxHsh::SetCurTag( xbString &sTagName ){
+
+  xbHshTag *hpTag = (xbHshTag *) GetTag( sTagName );
+  if( hpTag ){
+    xbIx::SetCurTag( (void *) hpTag );
+    return XB_NO_ERROR;
+  } else
+    return XB_INVALID_TAG;
+}
+/***********************************************************************/
+xbInt16 xbIxHsh::SetCurTag( xbInt16 iTagNo ){
+
+  xbHshTag *hpTag = (xbHshTag *) GetTag( iTagNo );
+  if( hpTag ){
+    xbIx::SetCurTag( (void *) hpTag );
+    return XB_NO_ERROR;
+  } else
+    return XB_INVALID_TAG;
+}
+/***********************************************************************/
+//! @brief Set the mode for the given tag.
+/*!
+  @param vpTag Tag to set mode for.
+  @param iMode One of XB_IX_DBASE_MODE or XB_IX_XBASE_MODE
+  @returns XB_INVALID_OPTION or XB_NO_ERROR
+*/
+xbInt16 xbIxHsh::SetIxTagMode( void *vpTag, xbInt16 iMode ){
+  if( iMode != XB_IX_DBASE_MODE && iMode != XB_IX_XBASE_MODE )
+    return XB_INVALID_OPTION;
+  xbHshTag *hpTag = (xbHshTag *) vpTag;
+  hpTag->iIxTagMode = iMode;
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Set the key update status for a given tag.
+/*!
+  @param vpTag Tag to set the status for.
+  @param iKeySts New key status.
+  @returns void
+*/
+void xbIxHsh::SetKeySts( void *vpTag, xbInt16 iKeySts ){
+  ((xbHshTag *) vpTag)->iKeySts = iKeySts;
+}
+/***********************************************************************/
+//! @brief Split interior node.
+/*!
+  Not used by hash indices, there are no nodes.
+  @returns XB_INVALID_OPTION
+*/
+xbInt16 xbIxHsh::SplitNodeI( void *, xbIxNode *, xbIxNode *, xbInt16, xbUInt32 ){
+  return XB_INVALID_OPTION;
+}
+/***********************************************************************/
+//! @brief Split leaf node.
+/*!
+  Not used by hash indices, there are no nodes.
+  @returns XB_INVALID_OPTION
+*/
+xbInt16 xbIxHsh::SplitNodeL( void *, xbIxNode *, xbIxNode *, xbInt16, char *, xbUInt32 ){
+  return XB_INVALID_OPTION;
+}
+/***********************************************************************/
+//! @brief Update tag key.
+/*!
+  @param cAction A - Add a key.<br>
+                 D - Delete a key.<br>
+                 R - Revise a key.<br>
+  @param vpTag Pointer to tag.
+  @param ulRecNo Record number association with the action.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxHsh::UpdateTagKey( char cAction, void *vpTag, xbUInt32 ulRecNo ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    if( cAction == 'D' || cAction == 'R' ){
+      if(( iRc = DeleteKey( vpTag )) != XB_NO_ERROR ){
+        iErrorStop = 100;
+        throw iRc;
+      }
+    }
+    if( cAction == 'A' || cAction == 'R' ){
+      if(( iRc = AddKey( vpTag, ulRecNo )) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+    }
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbIxHsh::UpdateTagKey() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Write head block.
+/*!
+  Stub, there is no index file.
+  @returns XB_NO_ERROR
+*/
+xbInt16 xbIxHsh::WriteHeadBlock( xbInt16 ){
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+}              /* namespace       */
+#endif         /*  XB_HSH_SUPPORT */
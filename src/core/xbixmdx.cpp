@@ -90,6 +90,10 @@ xbInt16 xbIxMdx::AddKey( void * vpTag, xbUInt32 ulRecNo ){
   if( npTag->iIxTagMode == XB_IX_DBASE_MODE && npTag->bFoundSts )
     return XB_NO_ERROR;
 
+  // add to the bloom filter first, so the filter is never missing a key that is in the tag
+  if( npTag->bloom && npTag->bloom->GetValid())
+    npTag->bloom->Add( npTag->cpKeyBuf, (size_t) npTag->iKeyLen );
+
   xbInt16 iRc = XB_NO_ERROR;
   xbInt16 iErrorStop = 0;
   xbInt16 iHeadNodeUpdateOpt = 2;
@@ -385,6 +389,546 @@ xbIxNode * xbIxMdx::AllocateIxNode( xbMdxTag * mpTag, xbUInt32 ulBufSize, xbUInt
   return n;
 }
 /***********************************************************************/
+//! @brief Build the bloom filter for a tag.
+/*!
+  Load the bloom filter with every key in the tag, sized at twice the current
+  key count to leave room for additions before the filter needs rebuilt.
+  The keys are read from the index only, the dbf file is not read.
+
+  @param mpTag Tag to build the bloom filter for.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxMdx::BloomBuild( xbMdxTag *mpTag ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    // sync the serial number with the file, another process may have updated the tag
+    if(( iRc = TagSerialNo( 1, mpTag )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    xbUInt32 ulKeyCnt = 0;
+    if(( iRc = GetKeyCnt( mpTag, ulKeyCnt )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    if(( iRc = mpTag->bloom->Init( ulKeyCnt * 2 )) != XB_NO_ERROR ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+    iRc = GetFirstKey( mpTag, 0 );
+    while( iRc == XB_NO_ERROR ){
+      mpTag->bloom->Add( GetKeyData( mpTag->npCurNode, (xbInt16) mpTag->npCurNode->iCurKeyNo, mpTag->iKeyItemLen ), (size_t) mpTag->iKeyLen );
+      iRc = GetNextKey( mpTag, 0 );
+    }
+    if( iRc != XB_EOF && iRc != XB_EMPTY ){
+      iErrorStop = 130;
+      throw iRc;
+    }
+    mpTag->bloom->SetSerialNo( mpTag->cSerialNo );
+    iRc = XB_NO_ERROR;
+  }
+  catch (xbInt16 iRc ){
+    mpTag->bloom->SetValid( xbFalse );
+    xbString sMsg;
+    sMsg.Sprintf( "xbIxMdx::BloomBuild() Exception Caught. Error Stop = [%d] iRc = [%d] Tag = [%s]", iErrorStop, iRc, mpTag->cTagName );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Check the bloom filter for a key.
+/*!
+  In multi user mode, the filter is only used while the index file is locked.  The tag serial
+  number is read from the file and compared to the filter's stamp.  If another process updated
+  the tag, the filter is invalidated.
+
+  @param mpTag Tag to check.
+  @param vpKey Key to check for.
+  @param lKeyLen Length of key, partial keys are not checked.
+  @returns xbTrue - Key may be in the tag, the index needs searched.<br>
+           xbFalse - Key is not in the tag.
+*/
+xbBool xbIxMdx::BloomCheck( xbMdxTag *mpTag, const void *vpKey, xbInt32 lKeyLen ){
+
+  if( !mpTag->bloom || !mpTag->bloom->GetValid() || lKeyLen != mpTag->iKeyLen )
+    return xbTrue;
+
+  if( dbf->GetMultiUser() == xbOn ){
+    // without the index lock the serial number can change under the check, search the index
+    if( !GetLocked())
+      return xbTrue;
+    char c;
+    xbInt64 lPos = (mpTag->ulTagHdrPageNo * 512) + 20;
+    if( xbFseek( lPos, SEEK_SET ) != XB_NO_ERROR || xbFgetc( c ) != XB_NO_ERROR || c != mpTag->bloom->GetSerialNo()){
+      mpTag->bloom->SetValid( xbFalse );
+      return xbTrue;
+    }
+  }
+  return mpTag->bloom->MayContain( vpKey, (size_t) lKeyLen );
+}
+/***********************************************************************/
+//! @brief Load bloom filters from the sidecar file.
+/*!
+  Called when the mdx file is opened.  Filters are loaded for each tag found in the sidecar file.
+  If the serial number or root page stamp does not match the tag, the filter is rebuilt from the index.
+  A missing or unreadable sidecar file is not an error, the tags are left without filters.
+
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxMdx::BloomLoad(){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  xbBloomFilter *bf = NULL;
+  xbFile f( xbase );
+
+  try{
+    xbString sBloomFileName;
+    GetBloomFileName( sBloomFileName );
+    if( !f.FileExists( sBloomFileName ))
+      return XB_NO_ERROR;
+
+    f.SetFqFileName( sBloomFileName );
+    if(( iRc = f.xbFopen( "rb", XB_SINGLE_USER )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    char cBuf[18];
+    if(( iRc = f.xbFread( cBuf, 8, 1 )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    if( memcmp( cBuf, "XBBLM", 5 ) != 0 || cBuf[5] != 0x01 ){
+      iErrorStop = 120;
+      iRc = XB_INVALID_DATA;
+      throw iRc;
+    }
+    xbInt16 iEntryCnt = f.eGetInt16( &cBuf[6] );
+
+    xbMdxTag *mpTag;
+    for( xbInt16 i = 0; i < iEntryCnt; i++ ){
+      // entry stamp: 11 byte tag name, serial number, valid switch, 4 byte root page
+      if(( iRc = f.xbFread( cBuf, 17, 1 )) != XB_NO_ERROR ){
+        iErrorStop = 130;
+        throw iRc;
+      }
+      if(( bf = new xbBloomFilter()) == NULL ){
+        iErrorStop = 140;
+        iRc = XB_NO_MEMORY;
+        throw iRc;
+      }
+      if(( iRc = bf->Read( &f )) != XB_NO_ERROR ){
+        iErrorStop = 150;
+        throw iRc;
+      }
+      mpTag = mdxTagTbl;
+      while( mpTag && strncmp( mpTag->cTagName, cBuf, 10 ) != 0 )
+        mpTag = mpTag->next;
+
+      if( mpTag && mpTag->cUnique && !mpTag->bloom ){
+        mpTag->bloom = bf;
+        bf = NULL;
+        if( cBuf[12] && cBuf[11] == mpTag->cSerialNo && f.eGetUInt32( &cBuf[13] ) == mpTag->ulRootPage ){
+          mpTag->bloom->SetSerialNo( cBuf[11] );
+          mpTag->bloom->SetValid( xbTrue );
+        } else {
+          // stale, the tag was updated without the filter
+          BloomBuild( mpTag );
+        }
+      } else {
+        delete bf;
+        bf = NULL;
+      }
+    }
+    f.xbFclose();
+  }
+  catch (xbInt16 iRc ){
+    if( bf )
+      delete bf;
+    if( f.FileIsOpen())
+      f.xbFclose();
+    xbString sMsg;
+    sMsg.Sprintf( "xbIxMdx::BloomLoad() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Save bloom filters to the sidecar file.
+/*!
+  Called when the mdx file is closed.  The sidecar file is written with each tag's filter
+  stamped with the tag serial number and root page.  If no tags have filters, any existing
+  sidecar file is removed.
+
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxMdx::BloomSave(){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  xbFile f( xbase );
+
+  try{
+    xbString sBloomFileName;
+    GetBloomFileName( sBloomFileName );
+
+    xbInt16  iEntryCnt = 0;
+    xbMdxTag *mpTag = mdxTagTbl;
+    while( mpTag ){
+      if( mpTag->bloom )
+        iEntryCnt++;
+      mpTag = mpTag->next;
+    }
+    if( iEntryCnt == 0 ){
+      if( f.FileExists( sBloomFileName ))
+        f.xbRemove( sBloomFileName );
+      return XB_NO_ERROR;
+    }
+
+    f.SetFqFileName( sBloomFileName );
+    if(( iRc = f.xbFopen( "w+b", XB_SINGLE_USER )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    char cBuf[18];
+    memcpy( cBuf, "XBBLM", 5 );
+    cBuf[5] = 0x01;              // version
+    f.ePutInt16( &cBuf[6], iEntryCnt );
+    if(( iRc = f.xbFwrite( cBuf, 8, 1 )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+
+    mpTag = mdxTagTbl;
+    while( mpTag ){
+      if( mpTag->bloom ){
+        memcpy( cBuf, mpTag->cTagName, 11 );
+        cBuf[11] = mpTag->bloom->GetSerialNo();
+        cBuf[12] = mpTag->bloom->GetValid() ? 0x01 : 0x00;
+        f.ePutUInt32( &cBuf[13], mpTag->ulRootPage );
+        if(( iRc = f.xbFwrite( cBuf, 17, 1 )) != XB_NO_ERROR ){
+          iErrorStop = 120;
+          throw iRc;
+        }
+        if(( iRc = mpTag->bloom->Write( &f )) != XB_NO_ERROR ){
+          iErrorStop = 130;
+          throw iRc;
+        }
+      }
+      mpTag = mpTag->next;
+    }
+    if(( iRc = f.xbFclose()) != XB_NO_ERROR ){
+      iErrorStop = 140;
+      throw iRc;
+    }
+  }
+  catch (xbInt16 iRc ){
+    // don't leave a partial file behind
+    if( f.FileIsOpen()){
+      f.xbFclose();
+      f.xbRemove();
+    }
+    xbString sMsg;
+    sMsg.Sprintf( "xbIxMdx::BloomSave() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+#ifdef XB_SORT_SUPPORT
+//! @brief Build a tag from sorted keys.
+/*!
+  Used by ReindexTag() for temporary tags.  The tag is built bottom up, instead of adding
+  the keys one at a time.  Leaf nodes are filled in key order and written once, then each
+  interior level is built from the last keys of the level below it, until the top level
+  fits in the root node.  The root node stays on the same page.<br>
+
+  Each sort record is the sort key from GetSortKey() with the record number appended,
+  followed by the tag key.  For a unique tag, only the lowest record number for a key is
+  kept in dBASE mode, and a duplicate key is an error in XBase mode, same as the key by
+  key reindex.
+
+  @param mpTag Tag to build, emptied by HarvestTagNodes().
+  @param pSort Sort holding a record for each key, not yet sorted.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxMdx::BulkLoadTag( xbMdxTag *mpTag, xbSort *pSort ){
+
+  xbInt16    iRc = XB_NO_ERROR;
+  xbInt16    iErrorStop = 0;
+  xbUInt32   ulBlockSize   = GetBlockSize();
+  xbInt32    lKeysPerBlock = mpTag->iKeysPerBlock;
+  xbInt32    lItemLen      = mpTag->iKeyItemLen;
+  size_t     stKeyLen      = (size_t) mpTag->iKeyLen;
+  size_t     stEntLen      = stKeyLen + 4;       // level entry, page number and the last key under it
+  xbUInt32   ulSortKeyLen  = GetSortKeyLen( mpTag );
+  xbUInt32   ulTagSizeSave = mpTag->ulTagSize;
+  char       *cpBlock      = NULL;
+  char       *cpLevel      = NULL;
+  char       *cpUpper      = NULL;
+  char       *cpPrevKey    = NULL;
+  char       *cpTemp;
+  xbUInt32   ulLevelCnt    = 0;
+  xbUInt32   ulLevelMax    = 0;
+  xbUInt32   ulUpperCnt;
+  xbInt32    lLeafCnt      = 0;
+  xbUInt32   ulLeftLeaf    = 0;
+  xbUInt32   ulRightLeaf   = 0;
+  xbUInt32   ulPage        = 0;
+  xbUInt32   ulPrevPage    = 0;
+  xbUInt32   ulRecNo;
+  xbBool     bHaveKey      = xbFalse;
+  const char *cpRec;
+  const char *cpKey;
+
+  try{
+    if(( iRc = pSort->Sort()) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    cpBlock   = (char *) calloc( 1, (size_t) ulBlockSize );
+    cpPrevKey = (char *) malloc( (size_t) ulSortKeyLen );
+    if( !cpBlock || !cpPrevKey ){
+      iErrorStop = 110;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+
+    // fill the leaf nodes, a full leaf is written when the next key arrives
+    while(( iRc = pSort->GetNext( &cpRec )) == XB_NO_ERROR ){
+      if( mpTag->cUnique && bHaveKey && memcmp( cpRec, cpPrevKey, (size_t) ulSortKeyLen ) == 0 ){
+        if( mpTag->iIxTagMode == XB_IX_XBASE_MODE ){
+          iErrorStop = 120;
+          iRc = XB_KEY_NOT_UNIQUE;
+          throw iRc;
+        }
+        continue;
+      }
+      memcpy( cpPrevKey, cpRec, (size_t) ulSortKeyLen );
+      bHaveKey = xbTrue;
+      cpKey = cpRec + ulSortKeyLen + 4;
+      ulRecNo = 0;
+      for( xbUInt32 i = 0; i < 4; i++ )          // big endian, after the sort key
+        ulRecNo = ( ulRecNo << 8 ) | (unsigned char) cpRec[ulSortKeyLen + i];
+
+      if( mpTag->bloom && mpTag->bloom->GetValid())
+        mpTag->bloom->Add( cpKey, stKeyLen );
+
+      if( lLeafCnt == lKeysPerBlock ){
+        if(( iRc = BulkWriteNode( mpTag, cpBlock, lLeafCnt, ulPrevPage, ulPage )) != XB_NO_ERROR ){
+          iErrorStop = 130;
+          throw iRc;
+        }
+        if( ulLevelCnt == ulLevelMax ){
+          ulLevelMax = ulLevelMax ? ulLevelMax * 2 : 256;
+          if(( cpTemp = (char *) realloc( cpLevel, ulLevelMax * stEntLen )) == NULL ){
+            iErrorStop = 140;
+            iRc = XB_NO_MEMORY;
+            throw iRc;
+          }
+          cpLevel = cpTemp;
+        }
+        ePutUInt32( cpLevel + ulLevelCnt * stEntLen, ulPage );
+        memcpy( cpLevel + ulLevelCnt * stEntLen + 4, cpBlock + 12 + ( lLeafCnt - 1 ) * lItemLen, stKeyLen );
+        ulLevelCnt++;
+        if( ulLeftLeaf == 0 )
+          ulLeftLeaf = ulPage;
+        ulPrevPage = ulPage;
+        lLeafCnt = 0;
+      }
+      ePutUInt32( cpBlock + 8 + lLeafCnt * lItemLen, ulRecNo );
+      memcpy( cpBlock + 12 + lLeafCnt * lItemLen, cpKey, stKeyLen );
+      lLeafCnt++;
+    }
+    if( iRc != XB_EOF ){
+      iErrorStop = 150;
+      throw iRc;
+    }
+    iRc = XB_NO_ERROR;
+
+    if( lLeafCnt > 0 ){
+      if( ulLevelCnt == 0 ){
+        // one leaf, it is the root
+        memset( cpBlock + 8 + lLeafCnt * lItemLen, 0x00, ulBlockSize - 8 - (xbUInt32) ( lLeafCnt * lItemLen ));
+        ePutInt32( cpBlock, lLeafCnt );
+        ePutUInt32( cpBlock + 4, 0 );
+        if(( iRc = WriteBlock( PageToBlock( mpTag->ulRootPage ), ulBlockSize, cpBlock )) != XB_NO_ERROR ){
+          iErrorStop = 160;
+          throw iRc;
+        }
+        ulLeftLeaf  = mpTag->ulRootPage;
+        ulRightLeaf = mpTag->ulRootPage;
+      } else {
+        if(( iRc = BulkWriteNode( mpTag, cpBlock, lLeafCnt, ulPrevPage, ulPage )) != XB_NO_ERROR ){
+          iErrorStop = 170;
+          throw iRc;
+        }
+        if( ulLevelCnt == ulLevelMax ){
+          if(( cpTemp = (char *) realloc( cpLevel, ( ulLevelMax + 1 ) * stEntLen )) == NULL ){
+            iErrorStop = 180;
+            iRc = XB_NO_MEMORY;
+            throw iRc;
+          }
+          cpLevel = cpTemp;
+          ulLevelMax++;
+        }
+        ePutUInt32( cpLevel + ulLevelCnt * stEntLen, ulPage );
+        memcpy( cpLevel + ulLevelCnt * stEntLen + 4, cpBlock + 12 + ( lLeafCnt - 1 ) * lItemLen, stKeyLen );
+        ulLevelCnt++;
+        ulRightLeaf = ulPage;
+      }
+    }
+
+    // build the interior levels, the children of a node are spread evenly so none are left with a single child
+    while( ulLevelCnt > 1 ){
+      xbUInt32 ulNodeCnt = ( ulLevelCnt + (xbUInt32) lKeysPerBlock ) / (xbUInt32) ( lKeysPerBlock + 1 );
+      if(( cpUpper = (char *) malloc( ulNodeCnt * stEntLen )) == NULL ){
+        iErrorStop = 190;
+        iRc = XB_NO_MEMORY;
+        throw iRc;
+      }
+      ulUpperCnt = 0;
+      ulPrevPage = 0;
+      xbUInt32 ulFirst = 0;
+      for( xbUInt32 ulNode = 0; ulNode < ulNodeCnt; ulNode++ ){
+        xbUInt32 ulLast = (xbUInt32) ((( (xbUInt64) ulNode + 1 ) * ulLevelCnt ) / ulNodeCnt );
+        xbUInt32 ulChildCnt = ulLast - ulFirst;
+        memset( cpBlock, 0x00, ulBlockSize );
+        ePutInt32( cpBlock, (xbInt32) ulChildCnt - 1 );
+        for( xbUInt32 i = 0; i < ulChildCnt; i++ ){
+          const char *cpEnt = cpLevel + ( ulFirst + i ) * stEntLen;
+          memcpy( cpBlock + 8 + i * (xbUInt32) lItemLen, cpEnt, 4 );
+          if( i < ulChildCnt - 1 )
+            memcpy( cpBlock + 12 + i * (xbUInt32) lItemLen, cpEnt + 4, stKeyLen );
+        }
+        if( ulNodeCnt == 1 ){
+          if(( iRc = WriteBlock( PageToBlock( mpTag->ulRootPage ), ulBlockSize, cpBlock )) != XB_NO_ERROR ){
+            iErrorStop = 200;
+            throw iRc;
+          }
+        } else {
+          if(( iRc = BulkWriteNode( mpTag, cpBlock, -1, ulPrevPage, ulPage )) != XB_NO_ERROR ){
+            iErrorStop = 210;
+            throw iRc;
+          }
+          ePutUInt32( cpUpper + ulUpperCnt * stEntLen, ulPage );
+          memcpy( cpUpper + ulUpperCnt * stEntLen + 4, cpLevel + ( ulLast - 1 ) * stEntLen + 4, stKeyLen );
+          ulUpperCnt++;
+          ulPrevPage = ulPage;
+        }
+        ulFirst = ulLast;
+      }
+      free( cpLevel );
+      cpLevel    = cpUpper;
+      cpUpper    = NULL;
+      ulLevelCnt = ( ulNodeCnt == 1 ) ? 1 : ulUpperCnt;
+    }
+
+    // update the tag header, has keys flag and the left and right leaf nodes
+    if( ulRightLeaf > 0 ){
+      char cBuf[8];
+      mpTag->cHasKeys     = 0x01;
+      mpTag->ulLeftChild  = ulLeftLeaf;
+      mpTag->ulRightChild = ulRightLeaf;
+      if(( iRc = xbFseek( ((mpTag->ulTagHdrPageNo * 512) + 246), SEEK_SET )) != XB_NO_ERROR ){
+        iErrorStop = 220;
+        throw iRc;
+      }
+      if(( iRc = xbFwrite( &mpTag->cHasKeys, 1, 1 )) != XB_NO_ERROR ){
+        iErrorStop = 230;
+        throw iRc;
+      }
+      ePutUInt32( cBuf, ulLeftLeaf );
+      ePutUInt32( &cBuf[4], ulRightLeaf );
+      if(( iRc = xbFseek( ((mpTag->ulTagHdrPageNo * 512) + 248), SEEK_SET )) != XB_NO_ERROR ){
+        iErrorStop = 240;
+        throw iRc;
+      }
+      if(( iRc = xbFwrite( cBuf, 8, 1 )) != XB_NO_ERROR ){
+        iErrorStop = 250;
+        throw iRc;
+      }
+    }
+    if(( iRc = WriteHeadBlock( 2 )) != XB_NO_ERROR ){
+      iErrorStop = 260;
+      throw iRc;
+    }
+    if( ulTagSizeSave != mpTag->ulTagSize ){
+      if(( iRc = UpdateTagSize( mpTag, mpTag->ulTagSize )) != XB_NO_ERROR ){
+        iErrorStop = 270;
+        throw iRc;
+      }
+    }
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbIxMdx::BulkLoadTag() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  if( cpBlock )
+    free( cpBlock );
+  if( cpPrevKey )
+    free( cpPrevKey );
+  if( cpLevel )
+    free( cpLevel );
+  if( cpUpper )
+    free( cpUpper );
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Write a node built by BulkLoadTag() to a newly allocated block.
+/*!
+  @param mpTag Tag being built.
+  @param cpBlock Node data.  Bytes 4-7 are set here.
+  @param lLeafCnt Number of keys for a leaf node, the space after the keys is cleared.<br>
+                  -1 for an interior node, which is already complete.
+  @param ulPrevPage Page of the node before this one on the same level, saved in bytes 4-7
+                    the same as for a node split off from it.  0 for the first node.
+  @param ulPage Output - page number the node was written to.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxMdx::BulkWriteNode( xbMdxTag *mpTag, char *cpBlock, xbInt32 lLeafCnt, xbUInt32 ulPrevPage, xbUInt32 &ulPage ){
+
+  xbInt16  iRc = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbIxNode *n = NULL;
+
+  try{
+    if(( n = AllocateIxNode( mpTag, GetBlockSize(), 0 )) == NULL ){
+      iErrorStop = 100;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    if( lLeafCnt >= 0 ){
+      ePutInt32( cpBlock, lLeafCnt );
+      memset( cpBlock + 8 + lLeafCnt * mpTag->iKeyItemLen, 0x00, GetBlockSize() - 8 - (xbUInt32) ( lLeafCnt * mpTag->iKeyItemLen ));
+    }
+    ePutUInt32( cpBlock + 4, ulPrevPage );
+    if(( iRc = WriteBlock( n->ulBlockNo, GetBlockSize(), cpBlock )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    ulPage = BlockToPage( n->ulBlockNo );
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbIxMdx::BulkWriteNode() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  if( n )
+    FreeNodeChain( n );
+  return iRc;
+}
+#endif   // XB_SORT_SUPPORT
+/***********************************************************************/
 //! @brief Calculate B-tree pointers.
 /*!
   Set binary tree pointer value.  The MDX tags are stored with binary 
@@ -492,7 +1036,13 @@ xbInt16 xbIxMdx::CheckForDupKey( void *vpTag )
   mpTag->bFoundSts = xbFalse;
   try{
     if( GetUnique( mpTag )){
-      if( mpTag->iKeySts == XB_ADD_KEY || mpTag->iKeySts == XB_UPD_KEY )
+      if( mpTag->iKeySts == XB_ADD_KEY || mpTag->iKeySts == XB_UPD_KEY ){
+        // rebuild the bloom filter if it is full or out of sync with the file
+        // if the rebuild fails, the filter is left invalid and the index is searched
+        if( mpTag->bloom && ( mpTag->bloom->IsFull() || !mpTag->bloom->GetValid()))
+          BloomBuild( mpTag );
+        if( !BloomCheck( mpTag, mpTag->cpKeyBuf, mpTag->iKeyLen ))
+          return 0;
         if( KeyExists( mpTag )){
           //if( GetUniqueKeyOpt() == XB_EMULATE_DBASE ){
           if( mpTag->iIxTagMode == XB_IX_DBASE_MODE ){
@@ -502,6 +1052,7 @@ xbInt16 xbIxMdx::CheckForDupKey( void *vpTag )
             return XB_KEY_NOT_UNIQUE;
           }
         }
+      }
      }
      return 0;
   }
@@ -822,6 +1373,8 @@ xbMdxTag *xbIxMdx::ClearTagTable(){
       delete tt2->sTagName;
     if( tt2->sFiltExp )
       delete tt2->sFiltExp;
+    if( tt2->bloom )
+      delete tt2->bloom;
     free( tt2 );
   }
   return NULL;
@@ -833,6 +1386,9 @@ xbInt16 xbIxMdx::Close(){
   xbInt16 iErrorStop = 0;
 
   try{
+    // a failed sidecar save is not fatal, the filters are rebuilt on the next open
+    if( FileIsOpen())
+      BloomSave();
     mdxTagTbl = ClearTagTable();
     if(( iRc = xbIx::Close()) != XB_NO_ERROR ){
       iErrorStop = 100;
@@ -1676,6 +2232,12 @@ xbInt16 xbIxMdx::DeleteTag( void *vpTag ){
     char cSaveKeyFmt3   = mpTag->cKeyFmt3;
     xbString sSaveKey   = mpTag->sKeyExp->Str();
 
+    // drop the bloom filter, it is not written to the sidecar file on close
+    if( mpTag->bloom ){
+      delete mpTag->bloom;
+      mpTag->bloom = NULL;
+    }
+
     if( iTagUseCnt == 1 ){
       // std::cout << "xbIxMdx::DeleteTag - one tag found, delete the mdx file\n";
 
@@ -2736,12 +3298,64 @@ xbInt16 xbIxMdx::FindKeyForCurRec( void * vpTag, xbInt16 iRetrieveSw )
   return XB_NO_ERROR;
 }
 
+/***********************************************************************/
+//! @brief Get the bloom filter sidecar file name.
+/*!
+  The sidecar file is stored alongside the mdx file, with a BLM extension.
+  @param sBloomFileName Output - Fully qualified sidecar file name.
+  @returns void
+*/
+void xbIxMdx::GetBloomFileName( xbString &sBloomFileName ) const {
+
+  const xbString &sMdxFileName = GetFqFileName();
+  xbUInt32 ulLen = sMdxFileName.Len();
+
+  // match the case of the mdx file extension
+  xbBool bLower = ( ulLen > 0 && islower( sMdxFileName[ulLen] ));
+
+  sBloomFileName = sMdxFileName;
+  if( ulLen > 4 && sMdxFileName[ulLen-3] == '.' )
+    sBloomFileName.Left( ulLen - 3 );
+  else
+    sBloomFileName += ".";
+  sBloomFileName += bLower ? "blm" : "BLM";
+}
+/***********************************************************************/
+//! @brief Get the bloom filter status for a tag.
+/*!
+  @param vpTag Tag to check.
+  @returns xbTrue - Bloom filter enabled for the tag.<br>
+           xbFalse - Bloom filter not enabled for the tag.
+*/
+xbBool xbIxMdx::GetBloomFilter( const void *vpTag ) const {
+  if( !vpTag )
+    return xbFalse;
+  return ((xbMdxTag *) vpTag)->bloom ? xbTrue : xbFalse;
+}
+/***********************************************************************/
+//! @brief Get the dbf record number for the current key.
+/*!
+  @param vpTag Tag to retrieve the record number from.
+  @param ulRecNo Output - Record number the current key points to.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxMdx::GetCurKeyRecNo( void *vpTag, xbUInt32 &ulRecNo ){
+
+  if( !vpTag )
+    return XB_INVALID_TAG;
+  xbMdxTag * mpTag = (xbMdxTag *) vpTag;
+  if( !mpTag->npCurNode || mpTag->npCurNode->iCurKeyNo >= (xbUInt32) GetKeyCount( mpTag->npCurNode ))
+    return XB_INVALID_KEYNO;
+  return GetKeyPtr( vpTag, (xbInt16) mpTag->npCurNode->iCurKeyNo, mpTag->npCurNode, ulRecNo );
+}
 /***********************************************************************/
 xbInt16 xbIxMdx::GetCurKeyVal( void *vpTag, xbString &s ){
 
   if( !vpTag )
     return XB_INVALID_TAG;
   xbMdxTag * mpTag = (xbMdxTag *) vpTag;
+  if( !mpTag->npCurNode )
+    return XB_INVALID_KEYNO;
   s.Set( GetKeyData( mpTag->npCurNode, mpTag->npCurNode->iCurKeyNo, mpTag->iKeyItemLen ), (xbUInt16) mpTag->iKeyLen );
   return XB_NO_ERROR;
 }
@@ -2751,8 +3365,14 @@ xbInt16 xbIxMdx::GetCurKeyVal( void *vpTag, xbDouble &d ){
   if( !vpTag )
     return XB_INVALID_TAG;
   xbMdxTag * mpTag = (xbMdxTag *) vpTag;
-  xbBcd bcd( GetKeyData( mpTag->npCurNode, mpTag->npCurNode->iCurKeyNo, mpTag->iKeyItemLen ));
-  bcd.ToDouble( d );
+  if( !mpTag->npCurNode )
+    return XB_INVALID_KEYNO;
+  if( mpTag->cKeyType == 'D' ){     // date keys are stored as julian doubles, not bcd
+    d = eGetDouble( GetKeyData( mpTag->npCurNode, mpTag->npCurNode->iCurKeyNo, mpTag->iKeyItemLen ));
+  } else {
+    xbBcd bcd( GetKeyData( mpTag->npCurNode, mpTag->npCurNode->iCurKeyNo, mpTag->iKeyItemLen ));
+    bcd.ToDouble( d );
+  }
   return XB_NO_ERROR;
 }
 /***********************************************************************/
@@ -2762,11 +3382,23 @@ xbInt16 xbIxMdx::GetCurKeyVal( void *vpTag, xbDate &dt ){
     return XB_INVALID_TAG;
 
   xbMdxTag * mpTag = (xbMdxTag *) vpTag;
+  if( !mpTag->npCurNode )
+    return XB_INVALID_KEYNO;
   xbDouble d = eGetDouble( GetKeyData( mpTag->npCurNode, mpTag->npCurNode->iCurKeyNo, mpTag->iKeyItemLen ));
   dt.JulToDate8( (xbInt32) d );
   return XB_NO_ERROR;
 }
 /***********************************************************************/
+//! @brief Get the current node for the given tag.
+/*!
+  @param vpTag Tag to retrieve current node for.
+  @returns Pointer to the current node, NULL if not positioned.
+*/
+xbIxNode *xbIxMdx::GetCurNode( void *vpTag ) const {
+  xbMdxTag * mpTag = (xbMdxTag *) vpTag;
+  return mpTag->npCurNode;
+}
+/***********************************************************************/
 //! @brief Get dbf record number for given key number.
 /*!
   @param vpTag Tag to retrieve dbf rec number on.
@@ -2964,6 +3596,26 @@ xbString &xbIxMdx::GetKeyFilter( const void * vpTag ) const{
     return sNullString;
 
 }
+/***********************************************************************/
+//! @brief Get the key item length for the given tag.
+/*!
+  @param vpTag Tag to retrieve key item length for.
+  @returns Length of key plus pointer value.
+*/
+xbInt16 xbIxMdx::GetKeyItemLen( const void *vpTag ) const {
+  xbMdxTag * mpTag = (xbMdxTag *) vpTag;
+  return mpTag->iKeyItemLen;
+}
+/***********************************************************************/
+//! @brief Get the key length for the given tag.
+/*!
+  @param vpTag Tag to retrieve key length for.
+  @returns Key length.
+*/
+xbInt32 xbIxMdx::GetKeyLen( const void *vpTag ) const {
+  xbMdxTag * mpTag = (xbMdxTag *) vpTag;
+  return mpTag->iKeyLen;
+}
 /**************************************************************************************************/
 xbInt16 xbIxMdx::GetKeyPtr( void *vpTag, xbInt16 iKeyNo, xbIxNode *np, xbUInt32 &ulKeyPtr ) const {
 
@@ -2993,6 +3645,25 @@ xbInt16 xbIxMdx::GetKeyPtr( void *vpTag, xbInt16 iKeyNo, xbIxNode *np, xbUInt32
   return iRc;
 }
 /***********************************************************************/
+//! @brief Get the key expression for a given tag.
+/*!
+  @param vpTag Tag to retrieve the expression for.
+  @returns Pointer to the key expression.
+*/
+xbExp *xbIxMdx::GetKeyExp( const void *vpTag ) const {
+  return ((const xbMdxTag *) vpTag)->exp;
+}
+/***********************************************************************/
+//! @brief Get the filter expression for a given tag.
+/*!
+  @param vpTag Tag to retrieve the expression for.
+  @returns Pointer to the filter expression, NULL if the tag is not filtered.
+*/
+xbExp *xbIxMdx::GetKeyFilterExp( const void *vpTag ) const {
+  const xbMdxTag *mpTag = (const xbMdxTag *) vpTag;
+  return mpTag->cHasFilter ? mpTag->filter : NULL;
+}
+/***********************************************************************/
 //! @brief Returns key update status.
 /*!
   @param vpTag Tag to check status on.
@@ -3418,6 +4089,60 @@ xbBool xbIxMdx::GetReuseEmptyNodesSw() const {
   return bReuseEmptyNodes;
 }
 /***********************************************************************/
+#ifdef XB_SORT_SUPPORT
+//! @brief Build the sort key for the current key.
+/*!
+  Encodes the key in the tag key buffer so the keys sort in tag order with a byte compare,
+  then appends the record number, big endian, so duplicate keys sort by record number.<br>
+  Character keys are used as is.  Numeric keys are bcd, encoded as the sign followed by the
+  significant digit count and the digits, all complemented for negative values.  Date keys
+  are doubles.  For descending tags, the key part is complemented.
+
+  @param mpTag Tag.
+  @param ulRecNo Record number for the key.
+  @param cpSortKey Output - GetSortKeyLen() + 4 bytes.
+  @returns void
+*/
+void xbIxMdx::GetSortKey( xbMdxTag *mpTag, xbUInt32 ulRecNo, char *cpSortKey ) const {
+
+  xbUInt32 ulLen = GetSortKeyLen( mpTag );
+  if( mpTag->cKeyType2 == 'N' ){
+    const char *p = mpTag->cpKeyBuf;
+    xbBool bNegative = ( (unsigned char) p[1] ) >> 7;
+    cpSortKey[0] = bNegative ? 0x00 : 0x01;
+    cpSortKey[1] = p[0];
+    memcpy( cpSortKey + 2, p + 2, 10 );
+    if( bNegative )
+      for( xbUInt32 i = 1; i < ulLen; i++ )
+        cpSortKey[i] = (char) ~cpSortKey[i];
+  } else if( mpTag->cKeyType2 == 'D' ){
+    xbDouble d;
+    memcpy( &d, mpTag->cpKeyBuf, sizeof( xbDouble ));
+    xbSort::PutKeyDouble( cpSortKey, d );
+  } else {
+    memcpy( cpSortKey, mpTag->cpKeyBuf, ulLen );
+  }
+  if( mpTag->cKeyFmt2 & 0x08 )
+    for( xbUInt32 i = 0; i < ulLen; i++ )
+      cpSortKey[i] = (char) ~cpSortKey[i];
+  xbSort::PutKeyUInt32( cpSortKey + ulLen, ulRecNo );
+}
+/***********************************************************************/
+//! @brief Get the length of the sort key built by GetSortKey().
+/*!
+  @param mpTag Tag.
+  @returns Sort key length, not counting the record number.
+*/
+xbUInt32 xbIxMdx::GetSortKeyLen( xbMdxTag *mpTag ) const {
+  if( mpTag->cKeyType2 == 'N' )
+    return 12;
+  else if( mpTag->cKeyType2 == 'D' )
+    return sizeof( xbDouble );
+  else
+    return (xbUInt32) mpTag->iKeyLen;
+}
+#endif   // XB_SORT_SUPPORT
+/***********************************************************************/
 xbBool xbIxMdx::GetSortOrder( void *vpTag ) const {
 
   // return true if descending
@@ -4428,6 +5153,26 @@ xbInt16 xbIxMdx::PrintKey( void *vpTag, xbIxNode *npNode, xbInt16 iKeyNo, xbInt1
 }
 #endif
 
+/***********************************************************************/
+//! @brief Check if a key is in a tag.
+/*!
+  If the tag has a bloom filter and the filter rules the key out, XB_NOT_FOUND is
+  returned without reading any index nodes.  Otherwise the tag is searched as in
+  xbIx::ProbeKey() and left on the key it was on before the call.
+
+  @param vpTag Tag to search.
+  @param vpKey Key to search for.
+  @param lKeyLen Length of the key.
+  @returns XB_NO_ERROR - Key found.<br>
+           XB_NOT_FOUND - Key not found.<br>
+           <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxMdx::ProbeKey( void *vpTag, const void *vpKey, xbInt32 lKeyLen ){
+
+  if( vpTag && !BloomCheck( (xbMdxTag *) vpTag, vpKey, lKeyLen ))
+    return XB_NOT_FOUND;
+  return xbIx::ProbeKey( vpTag, vpKey, lKeyLen );
+}
 /***********************************************************************/
 //! @brief ReadHeadBlock.
 /*!
@@ -4521,6 +5266,8 @@ xbInt16 xbIxMdx::ReadHeadBlock( xbInt16 iOpt )
         iErrorStop = 160;
         throw iRc;
       }
+      // a missing or invalid sidecar file is not fatal, tags are left without bloom filters
+      BloomLoad();
 
     } else {
       iTagUseCnt       = eGetInt16( p );
@@ -4731,6 +5478,15 @@ xbInt16 xbIxMdx::ReindexTag( void **vpTag ){
   xbMdxTag * mpTag    = NULL;
   xbString sMsg;
 
+  #ifdef XB_BLOCKREAD_SUPPORT
+  xbDouble *dpFilt = NULL;      // tag filter results for the current read block
+  #endif  // XB_BLOCKREAD_SUPPORT
+
+  #ifdef XB_SORT_SUPPORT
+  xbSort   *pSort    = NULL;    // temporary tags are sorted and built bottom up
+  char     *cpSortKey = NULL;
+  #endif  // XB_SORT_SUPPORT
+
   try{
 
     if( !vpTag )
@@ -4756,9 +5512,77 @@ xbInt16 xbIxMdx::ReindexTag( void **vpTag ){
       throw iRc;
     }
 
+    // reload the bloom filter as the keys are added
+    if( mpTag->bloom ){
+      if(( iRc = TagSerialNo( 1, mpTag )) != XB_NO_ERROR ){
+        iErrorStop = 112;
+        throw iRc;
+      }
+      if(( iRc = mpTag->bloom->Init( ulRecCnt * 2 )) != XB_NO_ERROR ){
+        iErrorStop = 114;
+        throw iRc;
+      }
+      mpTag->bloom->SetSerialNo( mpTag->cSerialNo );
+    }
+
+    #ifdef XB_BLOCKREAD_SUPPORT
+    // with block reads on, the tag filter is evaluated a block at a time
+    // and filtered out records are skipped without loading them into the record buffer
+    xbBlockRead *pRb = NULL;
+    xbUInt32 ulFiltSize     = 0;
+    xbUInt32 ulFiltFirstRec = 0;
+    xbUInt32 ulFiltRecCnt   = 0;
+    if( mpTag->cHasFilter && mpTag->filter->GetBatchSupport())
+      pRb = dbf->GetBlockReadPtr();
+    #endif  // XB_BLOCKREAD_SUPPORT
+
+    #ifdef XB_SORT_SUPPORT
+    if( sIxType == "TDX" ){
+      pSort = new xbSort( xbase );
+      if(( cpSortKey = (char *) malloc( GetSortKeyLen( mpTag ) + 4 )) == NULL ){
+        iErrorStop = 170;
+        iRc = XB_NO_MEMORY;
+        throw iRc;
+      }
+      if(( iRc = pSort->Init( GetSortKeyLen( mpTag ) + 4, (xbUInt32) mpTag->iKeyLen )) != XB_NO_ERROR ){
+        iErrorStop = 180;
+        throw iRc;
+      }
+    }
+    #endif  // XB_SORT_SUPPORT
 
     xbBool bAddKey;
     for( xbUInt32 ulRec = 1; ulRec <= ulRecCnt; ulRec++ ){
+
+      #ifdef XB_BLOCKREAD_SUPPORT
+      if( pRb ){
+        if( ulRec >= ulFiltFirstRec + ulFiltRecCnt ){
+          if(( iRc = pRb->LoadBlockForRecNo( ulRec )) != XB_NO_ERROR ){
+            iErrorStop = 116;
+            throw iRc;
+          }
+          if( pRb->GetBlockRecCnt() > ulFiltSize ){
+            if( dpFilt )
+              free( dpFilt );
+            if(( dpFilt = (xbDouble *) malloc( pRb->GetBlockRecCnt() * sizeof( xbDouble ))) == NULL ){
+              iErrorStop = 117;
+              iRc = XB_NO_MEMORY;
+              throw iRc;
+            }
+            ulFiltSize = pRb->GetBlockRecCnt();
+          }
+          if(( iRc = mpTag->filter->ProcessExpressionBatch( pRb->GetBlockBuf(), pRb->GetBlockRecCnt(), dpFilt )) != XB_NO_ERROR ){
+            iErrorStop = 118;
+            throw iRc;
+          }
+          ulFiltFirstRec = pRb->GetBlockFirstRecNo();
+          ulFiltRecCnt   = pRb->GetBlockRecCnt();
+        }
+        if( dpFilt[ulRec - ulFiltFirstRec] == 0 )
+          continue;
+      }
+      #endif  // XB_BLOCKREAD_SUPPORT
+
       if(( iRc = dbf->GetRecord( ulRec )) != XB_NO_ERROR ){
         iErrorStop = 120;
         throw iRc;
@@ -4772,6 +5596,16 @@ xbInt16 xbIxMdx::ReindexTag( void **vpTag ){
       }
 
       if( mpTag->iKeySts == XB_ADD_KEY ){
+        #ifdef XB_SORT_SUPPORT
+        if( pSort ){
+          GetSortKey( mpTag, ulRec, cpSortKey );
+          if(( iRc = pSort->Add( cpSortKey, mpTag->cpKeyBuf )) != XB_NO_ERROR ){
+            iErrorStop = 190;
+            throw iRc;
+          }
+          continue;
+        }
+        #endif  // XB_SORT_SUPPORT
         bAddKey = xbTrue;
         if( mpTag->cUnique ){
 
@@ -4793,6 +5627,18 @@ xbInt16 xbIxMdx::ReindexTag( void **vpTag ){
         }
       }
     }
+    #ifdef XB_SORT_SUPPORT
+    if( pSort && ( iRc = BulkLoadTag( mpTag, pSort )) != XB_NO_ERROR ){
+      iErrorStop = 200;
+      throw iRc;
+    }
+    #endif  // XB_SORT_SUPPORT
+
+    // update the serial number, invalidates any bloom filter sidecar stamped before the reindex
+    if(( iRc = TagSerialNo( 3, mpTag )) != XB_NO_ERROR ){
+      iErrorStop = 160;
+      throw iRc;
+    }
   }
   catch (xbInt16 iRc ){
     // xbString sMsg;
@@ -4801,9 +5647,100 @@ xbInt16 xbIxMdx::ReindexTag( void **vpTag ){
     xbase->WriteLogMessage( sMsg.Str() );
     xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
   }
+  #ifdef XB_BLOCKREAD_SUPPORT
+  if( dpFilt )
+    free( dpFilt );
+  #endif  // XB_BLOCKREAD_SUPPORT
+  #ifdef XB_SORT_SUPPORT
+  if( pSort )
+    delete pSort;
+  if( cpSortKey )
+    free( cpSortKey );
+  #endif  // XB_SORT_SUPPORT
   return iRc;
 }
 /***********************************************************************/
+//! @brief Enable or disable the bloom filter for a tag.
+/*!
+  A bloom filter lets lookups for keys not in the tag be answered from memory, without
+  searching the index.  It is used by the duplicate key check when adding or updating
+  records.  FindKey always searches the index, as callers rely on the tag being positioned
+  on the next key when the key is not found.<br>
+
+  The filter is built from the index when enabled, maintained as keys are added, and saved in a
+  sidecar file (BLM extension) when the index is closed.  When the index is reopened, the
+  filter is reloaded if the tag serial number matches, otherwise it is rebuilt from the index.<br>
+
+  Available for unique tags with character or date keys.<br>
+  In multi user mode the filter is invalidated and rebuilt when another process updates the tag,
+  so it is best suited to tables with a single updating process.
+
+  @param vpTag Tag to enable or disable the bloom filter for.
+  @param bEnable xbTrue - Enable the bloom filter.<br>
+                 xbFalse - Disable the bloom filter.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxMdx::SetBloomFilter( void *vpTag, xbBool bEnable ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  xbMdxTag *mpTag = (xbMdxTag *) vpTag;
+
+  try{
+    if( !mpTag ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+    if( !bEnable ){
+      if( mpTag->bloom ){
+        delete mpTag->bloom;
+        mpTag->bloom = NULL;
+      }
+      return XB_NO_ERROR;
+    }
+    if( mpTag->bloom )
+      return XB_NO_ERROR;
+
+    // numeric keys are excluded, bcd values that compare equal are not guaranteed to be byte for byte equal
+    if( !mpTag->cUnique || ( mpTag->cKeyType2 != 'C' && mpTag->cKeyType2 != 'D' )){
+      iErrorStop = 110;
+      iRc = XB_INVALID_OPTION;
+      throw iRc;
+    }
+    if(( mpTag->bloom = new xbBloomFilter()) == NULL ){
+      iErrorStop = 120;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    if(( iRc = BloomBuild( mpTag )) != XB_NO_ERROR ){
+      iErrorStop = 130;
+      throw iRc;
+    }
+  }
+  catch (xbInt16 iRc ){
+    if( mpTag && mpTag->bloom ){
+      delete mpTag->bloom;
+      mpTag->bloom = NULL;
+    }
+    xbString sMsg;
+    sMsg.Sprintf( "xbIxMdx::SetBloomFilter() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Set the key update status for a given tag.
+/*!
+  @param vpTag Tag to set the status for.
+  @param iKeySts New key status.
+  @returns void
+*/
+void xbIxMdx::SetKeySts( void *vpTag, xbInt16 iKeySts ){
+  ((xbMdxTag *) vpTag)->iKeySts = iKeySts;
+}
+/***********************************************************************/
 xbInt16 xbIxMdx::SetCurTag( xbString &sTagName ) {
 
   xbMdxTag *tt = (xbMdxTag *) GetTag( sTagName );
@@ -5054,8 +5991,14 @@ xbInt16 xbIxMdx::TagSerialNo( xbInt16 iOption, xbMdxTag * mpTag ){
       }
     }
 
-    if( iOption == 3 )
+    if( iOption == 3 ){
+      // keep the bloom filter stamp in step, unless another process updated the tag since it was synced
+      if( mpTag->bloom && mpTag->bloom->GetSerialNo() != mpTag->cSerialNo )
+        mpTag->bloom->SetValid( xbFalse );
       mpTag->cSerialNo++;
+      if( mpTag->bloom )
+        mpTag->bloom->SetSerialNo( mpTag->cSerialNo );
+    }
 
     if( iOption != 1 ){
       if(( iRc = xbFseek( lPos, SEEK_SET )) != XB_NO_ERROR ){
@@ -1582,12 +1582,30 @@ xbInt16 xbIxNdx::FindKeyForCurRec( void * vpTag, xbInt16 iRetrieveSw )
 }
 
 
+/***********************************************************************/
+//! @brief Get the dbf record number for the current key.
+/*!
+  @param vpTag Tag to retrieve the record number from.
+  @param ulRecNo Output - Record number the current key points to.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbIxNdx::GetCurKeyRecNo( void *vpTag, xbUInt32 &ulRecNo ){
+
+  if( !vpTag )
+    return XB_INVALID_TAG;
+  xbNdxTag * npTag = (xbNdxTag *) vpTag;
+  if( !npTag->npNodeChain || !npTag->npCurNode || npTag->npCurNode->iCurKeyNo >= (xbUInt32) GetKeyCount( npTag->npCurNode ))
+    return XB_INVALID_KEYNO;
+  return GetDbfPtr( npTag, (xbInt16) npTag->npCurNode->iCurKeyNo, npTag->npCurNode, ulRecNo );
+}
 /***********************************************************************/
 xbInt16 xbIxNdx::GetCurKeyVal( void *vpTag, xbString &s ){
 
   if( !vpTag )
     return XB_INVALID_TAG;
   xbNdxTag * npTag = (xbNdxTag *) vpTag;
+  if( !npTag->npNodeChain )
+    return XB_INVALID_KEYNO;
   s.Set( GetKeyData( npTag->npCurNode, npTag->npCurNode->iCurKeyNo, npTag->iKeyItemLen ), (xbUInt16) npTag->iKeyLen );
   return XB_NO_ERROR;
 }
@@ -1598,6 +1616,8 @@ xbInt16 xbIxNdx::GetCurKeyVal( void *vpTag, xbDouble &d ){
   if( !vpTag )
     return XB_INVALID_TAG;
   xbNdxTag * npTag = (xbNdxTag *) vpTag;
+  if( !npTag->npNodeChain )
+    return XB_INVALID_KEYNO;
   d = eGetDouble( GetKeyData( npTag->npCurNode, npTag->npCurNode->iCurKeyNo, npTag->iKeyItemLen ));
   return XB_NO_ERROR;
 }
@@ -1608,11 +1628,26 @@ xbInt16 xbIxNdx::GetCurKeyVal( void *vpTag, xbDate &dt ){
   if( !vpTag )
     return XB_INVALID_TAG;
   xbNdxTag * npTag = (xbNdxTag *) vpTag;
+  if( !npTag->npNodeChain )
+    return XB_INVALID_KEYNO;
   xbDouble d = eGetDouble( GetKeyData( npTag->npCurNode, npTag->npCurNode->iCurKeyNo, npTag->iKeyItemLen ));
   dt.JulToDate8( (xbInt32) d );
   return XB_NO_ERROR;
 }
 
+/***********************************************************************/
+//! @brief Get the current node for the given tag.
+/*!
+  @param vpTag Tag to retrieve current node for.
+  @returns Pointer to the current node, NULL if not positioned.
+*/
+xbIxNode *xbIxNdx::GetCurNode( void *vpTag ) const {
+  xbNdxTag * npTag;
+  vpTag ? npTag = (xbNdxTag *) vpTag : npTag = ndxTag;
+  if( !npTag->npNodeChain )
+    return NULL;
+  return npTag->npCurNode;
+}
 /***********************************************************************/
 //! @brief Get dbf record number for given key number.
 /*!
@@ -1756,6 +1791,17 @@ xbString &xbIxNdx::GetKeyFilter( const void * ) const{
   return sNullString;
 }
 /***********************************************************************/
+//! @brief Get the key item length for the given tag.
+/*!
+  @param vpTag Tag to retrieve key item length for.
+  @returns Length of key plus pointer values.
+*/
+xbInt16 xbIxNdx::GetKeyItemLen( const void * vpTag ) const{
+  xbNdxTag * npTag;
+  vpTag ? npTag = (xbNdxTag *) vpTag : npTag = ndxTag;
+  return npTag->iKeyItemLen;
+}
+/***********************************************************************/
 //! @brief Get the key length for the given tag.
 /*!
   @param vpTag Tag to retrieve key length for.
@@ -1804,6 +1850,17 @@ xbInt16 xbIxNdx::GetKeyPtr( void *vpTag, xbInt16 iKeyNo, xbIxNode *np, xbUInt32
   return iRc;
 }
 
+/***********************************************************************/
+//! @brief Get the key expression for a given tag.
+/*!
+  @param vpTag Tag to retrieve the expression for.
+  @returns Pointer to the key expression.
+*/
+xbExp *xbIxNdx::GetKeyExp( const void *vpTag ) const {
+  const xbNdxTag * npTag;
+  vpTag ? npTag = (const xbNdxTag *) vpTag : npTag = ndxTag;
+  return npTag->exp;
+}
 /***********************************************************************/
 //! @brief Returns key update status.
 /*!
@@ -2747,6 +2804,18 @@ xbInt16 xbIxNdx::ReindexTag( void **vpTag ){
   return iRc;
 }
 /***********************************************************************/
+//! @brief Set the key update status for a given tag.
+/*!
+  @param vpTag Tag to set the status for.
+  @param iKeySts New key status.
+  @returns void
+*/
+void xbIxNdx::SetKeySts( void *vpTag, xbInt16 iKeySts ){
+  xbNdxTag * npTag;
+  vpTag ? npTag = (xbNdxTag *) vpTag : npTag = ndxTag;
+  npTag->iKeySts = iKeySts;
+}
+/***********************************************************************/
 //! @brief Set current tag.
 /*!
   For ndx indices, there is only one tag.
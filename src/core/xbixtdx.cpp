@@ -191,6 +191,8 @@ xbInt16  xbIxTdx::CreateTag( const xbString &sName, const xbString &sKey, const
       }
 
       // first tag, need to create the file
+      // the file is held in memory, and only written to the temp directory if it grows past the limit
+      SetMemoryResident( xbase->GetTdxMemoryLimit());
       if(( iRc = xbFopen( "w+b", dbf->GetShareMode())) != XB_NO_ERROR ){
         iErrorStop = 210;
         throw iRc;
@@ -22,6 +22,9 @@ namespace xb{
 /************************************************************************/
 xbRelate::xbRelate( xbXBase *x ) {
   this->xbase = x;
+  cJoinMode   = 'A';
+  iCacheSize  = XB_REL_CACHE_SIZE;
+  iPrefetchWindow = XB_REL_PREFETCH_WINDOW;
 }
 /************************************************************************/
 xbRelate::~xbRelate() {
@@ -48,6 +51,21 @@ xbRelate::~xbRelate() {
       if( pRel->pFilt )
         delete pRel->pFilt;
 
+      if( pRel->sChildExpression )
+        delete pRel->sChildExpression;
+
+      if( pRel->sMrgKey )
+        delete pRel->sMrgKey;
+      if( pRel->dtMrgKey )
+        delete pRel->dtMrgKey;
+
+      CacheFree( pRel );
+
+      #ifdef XB_HSH_SUPPORT
+      if( pRel->pHshIx )
+        delete pRel->pHshIx;
+      #endif  // XB_HSH_SUPPORT
+
       if( pRel->pParent ){
         pRel->pParent->llChildren.RemoveFromEnd( pRel );
         free( pRel );
@@ -97,6 +115,22 @@ xbInt16 xbRelate::AddRelation( xbDbf *dParent, const xbString &sParentExpression
 xbInt16 xbRelate::AddRelation( xbDbf *dParent, const xbString &sParentExpression,
   xbDbf *dChild, xbIx * pChildIx, void *pChildTag, char cType, const xbString &sFilter ){
 
+  return AddRelationNode( dParent, sParentExpression, dChild, pChildIx, pChildTag, "", cType, sFilter );
+}
+/************************************************************************/
+#ifdef XB_HSH_SUPPORT
+xbInt16 xbRelate::AddRelationExp( xbDbf *dParent, const xbString &sParentExpression,
+  xbDbf *dChild, const xbString &sChildExpression, char cType, const xbString &sFilter ){
+
+  if( sChildExpression.Len() == 0 )
+    return XB_INVALID_OPTION;
+  return AddRelationNode( dParent, sParentExpression, dChild, NULL, NULL, sChildExpression, cType, sFilter );
+}
+#endif  // XB_HSH_SUPPORT
+/************************************************************************/
+xbInt16 xbRelate::AddRelationNode( xbDbf *dParent, const xbString &sParentExpression, xbDbf *dChild,
+  xbIx * pChildIx, void *pChildTag, const xbString &sChildExpression, char cType, const xbString &sFilter ){
+
   xbInt16    iRc              = XB_NO_ERROR;
   xbInt16    iErrorStop       = 0;
   xbRelation *pChildRelation  = NULL;
@@ -124,12 +158,12 @@ xbInt16 xbRelate::AddRelation( xbDbf *dParent, const xbString &sParentExpression
       iErrorStop = 130;
       throw iRc;
     }
-    if( !pChildIx ){
+    if( !pChildIx && sChildExpression.Len() == 0 ){
       iRc = XB_INVALID_INDEX;
       iErrorStop = 140;
       throw iRc;
     }
-    if( !pChildTag ){
+    if( !pChildTag && sChildExpression.Len() == 0 ){
       iRc = XB_INVALID_TAG;
       iErrorStop = 150;
       throw iRc;
@@ -160,9 +194,26 @@ xbInt16 xbRelate::AddRelation( xbDbf *dParent, const xbString &sParentExpression
       throw iRc;
     }
 
+    if( sChildExpression.Len() > 0 ){
+      // the child key expression needs to parse, and match the parent key type
+      xbExp eChild( xbase );
+      if(( iRc = eChild.ParseExpression( dChild, sChildExpression )) != XB_NO_ERROR ){
+        iErrorStop = 195;
+        throw iRc;
+      }
+      if( eChild.GetReturnType() != pChildRelation->pParentExp->GetReturnType()){
+        iRc = XB_INCOMPATIBLE_OPERANDS;
+        iErrorStop = 196;
+        throw iRc;
+      }
+      pChildRelation->sChildExpression = new xbString( sChildExpression );
+    }
+
     pChildRelation->dDbf              = dChild;
     pChildRelation->pIx               = pChildIx;
     pChildRelation->pTag              = pChildTag;
+    pChildRelation->pKeyIx            = pChildIx;
+    pChildRelation->pKeyTag           = pChildTag;
     pChildRelation->cType             = cType;
     pChildRelation->pParent           = pParentRelation;
     pChildRelation->pParentNp         = pNode;
@@ -180,12 +231,14 @@ xbInt16 xbRelate::AddRelation( xbDbf *dParent, const xbString &sParentExpression
   }
   catch (xbInt16 iRc ){
     xbString sMsg;
-    sMsg.Sprintf( "xbRelate::AddRelation(2) Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    sMsg.Sprintf( "xbRelate::AddRelationNode() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
     xbase->WriteLogMessage( sMsg.Str() );
     xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
     if( pChildRelation && pChildRelation->pParentExp )
       delete pChildRelation->pParentExp;
     if( pChildRelation ){
+      if( pChildRelation->sChildExpression )
+        delete pChildRelation->sChildExpression;
       if( pChildRelation->sFilter )
         delete pChildRelation->sFilter;
       if( pChildRelation->pFilt )
@@ -196,6 +249,287 @@ xbInt16 xbRelate::AddRelation( xbDbf *dParent, const xbString &sParentExpression
   return iRc;
 }
 
+/************************************************************************/
+#ifdef XB_HSH_SUPPORT
+// build the child key hash, bRebuild reads the child table again at the start of each query
+// because it may have been changed through another table object or by another process,
+// otherwise it is only rebuilt if the child table changed through this table object since
+
+xbInt16 xbRelate::BuildJoinHash( xbRelation *pRel, xbBool bRebuild ){
+
+  xbInt16  iRc        = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbUInt32 ulRecCnt   = 0;
+
+  try{
+    if(( iRc = pRel->dDbf->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    if( pRel->pHshIx ){
+      if( !bRebuild && pRel->ulHshSeq == pRel->dDbf->GetChangeSeq() && pRel->ulHshRecCnt == ulRecCnt )
+        return XB_NO_ERROR;
+    } else {
+      xbString sKey;
+      xbString sFilter;
+      xbInt16  iUnique = 0;
+      if( pRel->sChildExpression ){
+        sKey = *pRel->sChildExpression;
+      } else {
+        sKey    = pRel->pKeyIx->GetKeyExpression( pRel->pKeyTag );
+        sFilter = pRel->pKeyIx->GetKeyFilter( pRel->pKeyTag );
+        iUnique = pRel->pKeyIx->GetUnique( pRel->pKeyTag ) ? 1 : 0;
+      }
+      // the hash tag is owned by the relation, it is not added to the table's index list
+      pRel->pHshIx = new xbIxHsh( pRel->dDbf );
+      if(( iRc = pRel->pHshIx->CreateTag( "XBRELHSH", sKey, sFilter, 0, iUnique, 0, &pRel->pHshTag )) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+      if( pRel->pKeyIx ){
+        if(( iRc = ((xbIxHsh *) pRel->pHshIx)->SetIxTagMode( pRel->pHshTag, pRel->pKeyIx->GetIxTagMode( pRel->pKeyTag ))) != XB_NO_ERROR ){
+          iErrorStop = 120;
+          throw iRc;
+        }
+      }
+    }
+    if(( iRc = pRel->dDbf->Reindex( 2, &pRel->pHshIx, &pRel->pHshTag )) != XB_NO_ERROR ){
+      iErrorStop = 130;
+      throw iRc;
+    }
+    pRel->ulHshSeq    = pRel->dDbf->GetChangeSeq();
+    pRel->ulHshRecCnt = ulRecCnt;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbRelate::BuildJoinHash() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+    if( pRel->pHshIx ){
+      delete pRel->pHshIx;
+      pRel->pHshIx  = NULL;
+      pRel->pHshTag = NULL;
+    }
+  }
+  return iRc;
+}
+#endif  // XB_HSH_SUPPORT
+/************************************************************************/
+// CacheFill adds the current child record to the cache entry being filled, after each step
+// through the child tag.  When the step finds no more child records for the key, the entry
+// is complete and can answer later lookups for the key.
+
+void xbRelate::CacheFill( xbRelation *pRel, char cFL ){
+
+  xbRelCacheEntry *e = pRel->cpCacheFill;
+  if( !e )
+    return;
+
+  if( pRel->cCacheFill != cFL || pRel->ulCacheSeq != pRel->dDbf->GetChangeSeq()){
+    pRel->cpCacheFill = NULL;
+    return;
+  }
+
+  if( pRel->iStatus == XB_NO_ERROR ){
+    if( e->ulRecCnt >= XB_REL_CACHE_MAX_RECS ){
+      pRel->cpCacheFill = NULL;
+      return;
+    }
+    if( e->ulRecCnt == e->ulRecSize ){
+      xbUInt32 ulNewSize = e->ulRecSize ? e->ulRecSize * 2 : 8;
+      xbUInt32 *ulpNew = (xbUInt32 *) realloc( e->ulpRecs, sizeof( xbUInt32 ) * ulNewSize );
+      if( !ulpNew ){
+        pRel->cpCacheFill = NULL;
+        return;
+      }
+      e->ulpRecs   = ulpNew;
+      e->ulRecSize = ulNewSize;
+    }
+    e->ulpRecs[e->ulRecCnt++] = pRel->dDbf->GetCurRecNo();
+
+  } else {
+    // records were added last to first on a backward fill, put them in key order
+    if( cFL == 'L' && e->ulRecCnt > 1 ){
+      for( xbUInt32 ulLo = 0, ulHi = e->ulRecCnt - 1; ulLo < ulHi; ulLo++, ulHi-- ){
+        xbUInt32 ulSave  = e->ulpRecs[ulLo];
+        e->ulpRecs[ulLo] = e->ulpRecs[ulHi];
+        e->ulpRecs[ulHi] = ulSave;
+      }
+    }
+    e->bValid = xbTrue;
+    pRel->cpCacheFill = NULL;
+  }
+}
+/************************************************************************/
+// CacheFillStart starts a cache entry for a key just looked up in the child tag,
+// replacing the least recently used entry
+
+void xbRelate::CacheFillStart( xbRelation *pRel, char cFL, xbString &sKey, xbDouble &dKey, xbDate &dtKey ){
+
+  if( !pRel->cpCache )
+    return;
+  if( pRel->iStatus != XB_NO_ERROR && pRel->iStatus != XB_NOT_FOUND )
+    return;
+
+  xbRelCacheEntry *e = &pRel->cpCache[0];
+  for( xbInt16 i = 0; i < pRel->iCacheCnt && e->bValid; i++ ){
+    if( !pRel->cpCache[i].bValid || pRel->cpCache[i].ulUseSeq < e->ulUseSeq )
+      e = &pRel->cpCache[i];
+  }
+
+  e->bValid    = xbFalse;
+  e->ulRecCnt  = 0;
+  e->ulDataCnt = 0;
+  e->ulUseSeq  = ++pRel->ulCacheUse;
+  if( pRel->pParentExp->GetReturnType() == XB_EXP_CHAR ){
+    if( !e->sKey )
+      e->sKey = new xbString();
+    *e->sKey = sKey;
+  } else if( pRel->pParentExp->GetReturnType() == XB_EXP_DATE ){
+    e->dKey = dtKey.JulianDays();
+  } else {
+    e->dKey = dKey;
+  }
+
+  pRel->cpCacheFill = e;
+  pRel->cCacheFill  = cFL;
+  CacheFill( pRel, cFL );
+}
+/************************************************************************/
+void xbRelate::CacheFree( xbRelation *pRel ){
+
+  if( pRel->cpCache ){
+    for( xbInt16 i = 0; i < pRel->iCacheCnt; i++ ){
+      if( pRel->cpCache[i].sKey )
+        delete pRel->cpCache[i].sKey;
+      if( pRel->cpCache[i].ulpRecs )
+        free( pRel->cpCache[i].ulpRecs );
+      if( pRel->cpCache[i].cpRecData )
+        free( pRel->cpCache[i].cpRecData );
+    }
+    free( pRel->cpCache );
+  }
+  pRel->cpCache     = NULL;
+  pRel->iCacheCnt   = 0;
+  pRel->cpCacheHit  = NULL;
+  pRel->cpCacheFill = NULL;
+}
+/************************************************************************/
+// CacheLookup checks the child lookup cache for a parent key
+// on a hit, the first (cFL = F) or last (cFL = L) child record is read and pRel->iStatus is set
+
+xbInt16 xbRelate::CacheLookup( xbRelation *pRel, char cFL, xbString &sKey, xbDouble &dKey, xbDate &dtKey, xbBool &bHit ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  bHit = xbFalse;
+  pRel->cpCacheHit  = NULL;
+  pRel->cpCacheFill = NULL;
+  if( iCacheSize == 0 )
+    return XB_NO_ERROR;
+
+  try{
+    if( !pRel->cpCache ){
+      if(( pRel->cpCache = (xbRelCacheEntry *) calloc( (size_t) iCacheSize, sizeof( xbRelCacheEntry ))) == NULL ){
+        iErrorStop = 100;
+        iRc = XB_NO_MEMORY;
+        throw iRc;
+      }
+      pRel->iCacheCnt  = iCacheSize;
+      pRel->ulCacheSeq = pRel->dDbf->GetChangeSeq();
+    }
+    if( pRel->ulCacheSeq != pRel->dDbf->GetChangeSeq()){
+      for( xbInt16 i = 0; i < pRel->iCacheCnt; i++ )
+        pRel->cpCache[i].bValid = xbFalse;
+      pRel->ulCacheSeq = pRel->dDbf->GetChangeSeq();
+    }
+    pRel->ullCacheLookups++;
+
+    char cParType = pRel->pParentExp->GetReturnType();
+    xbDouble dThisKey = ( cParType == XB_EXP_DATE ) ? (xbDouble) dtKey.JulianDays() : dKey;
+    xbRelCacheEntry *e = NULL;
+    for( xbInt16 i = 0; i < pRel->iCacheCnt && !e; i++ ){
+      if( pRel->cpCache[i].bValid ){
+        if( cParType == XB_EXP_CHAR ? *pRel->cpCache[i].sKey == sKey : pRel->cpCache[i].dKey == dThisKey )
+          e = &pRel->cpCache[i];
+      }
+    }
+    if( !e )
+      return XB_NO_ERROR;
+
+    pRel->ullCacheHits++;
+    e->ulUseSeq = ++pRel->ulCacheUse;
+    pRel->cpCacheHit = e;
+    bHit = xbTrue;
+    if( e->ulRecCnt == 0 ){
+      pRel->iStatus = XB_NOT_FOUND;
+    } else {
+      pRel->ulCachePos = ( cFL == 'F' ) ? 0 : e->ulRecCnt - 1;
+      if(( iRc = CacheRead( pRel )) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+      pRel->iStatus = XB_NO_ERROR;
+    }
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    pRel->cpCacheHit = NULL;
+    bHit = xbFalse;
+    sMsg.Sprintf( "xbRelate::CacheLookup() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/************************************************************************/
+// CacheRead reads the child record at the current position of a cache hit, from the
+// prefetched record image if there is one
+
+xbInt16 xbRelate::CacheRead( xbRelation *pRel ){
+
+  xbRelCacheEntry *e = pRel->cpCacheHit;
+  xbDbf *d = pRel->dDbf;
+
+  if( pRel->ulCachePos < e->ulDataCnt && d->iDbfStatus == XB_OPEN ){
+    memcpy( d->RecBuf, e->cpRecData + (size_t) pRel->ulCachePos * d->uiRecordLen, d->uiRecordLen );
+    d->ulCurRec = e->ulpRecs[pRel->ulCachePos];
+    return XB_NO_ERROR;
+  }
+  return d->GetRecord( e->ulpRecs[pRel->ulCachePos] );
+}
+/************************************************************************/
+// CacheStep moves to the next (cDir = N) or previous (cDir = P) child record of a cache hit
+
+xbInt16 xbRelate::CacheStep( xbRelation *pRel, char cDir ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbRelCacheEntry *e = pRel->cpCacheHit;
+
+  if( cDir == 'N' ){
+    if( pRel->ulCachePos + 1 >= e->ulRecCnt ){
+      pRel->iStatus = XB_NOT_FOUND;
+      return XB_NO_ERROR;
+    }
+    pRel->ulCachePos++;
+  } else {
+    if( pRel->ulCachePos == 0 ){
+      pRel->iStatus = XB_NOT_FOUND;
+      return XB_NO_ERROR;
+    }
+    pRel->ulCachePos--;
+  }
+  if(( iRc = CacheRead( pRel )) != XB_NO_ERROR ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbRelate::CacheStep() Exception Caught. Error Stop = [100] rc = [%d]", iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+    return iRc;
+  }
+  pRel->iStatus = XB_NO_ERROR;
+  return XB_NO_ERROR;
+}
 /************************************************************************/
 xbInt16 xbRelate::CheckTblSts( xbDbf *d ){
   // returns XB_ALREADY_DEFINED if the table has already been assigned to a relation in list
@@ -344,7 +678,10 @@ void xbRelate::DumpRelationList(){
 
     } else {
       pRelation->pParent->dDbf->GetFileNamePart( sParentFileName );
-      sTagName = pRelation->pIx->GetTagName( pRelation->pTag );
+      if( pRelation->pIx )
+        sTagName = pRelation->pIx->GetTagName( pRelation->pTag );
+      else
+        sTagName = "N/A";
     }
     sTagName.PadRight( ' ', 10 );
     sMsg.Sprintf( "%d\t%c\t%d\t%d\t%d\t%d\t%-8s\t%-12s \t%-8s \t%s \n",
@@ -371,7 +708,7 @@ void xbRelate::DumpRelationNode( const xbString &sTitle, xbRelation *pRel ){
   xbString sMdxFileName;
   xbString sTagName;
 
-  if( pRel->pTag )
+  if( pRel->pIx && pRel->pTag )
     sTagName = pRel->pIx->GetTagName( pRel->pTag );
   else
     sTagName = "No Tag";
@@ -423,7 +760,10 @@ void xbRelate::DumpRelationTree(){
       sTagName = "N/A";
     } else {
       pRelation->pParent->dDbf->GetFileNamePart( sParentFileName );
-      sTagName = pRelation->pIx->GetTagName( pRelation->pTag );
+      if( pRelation->pIx )
+        sTagName = pRelation->pIx->GetTagName( pRelation->pTag );
+      else
+        sTagName = "N/A";
     }
 
     sTagName.PadRight( ' ', 10 );
@@ -462,6 +802,36 @@ xbLinkListNode<xbRelation *> *xbRelate::FindNodeForDbf( xbDbf * d ){
   return pNode;
 }
 
+/************************************************************************/
+xbInt16 xbRelate::GetCacheSize() const {
+  return iCacheSize;
+}
+/************************************************************************/
+xbInt16 xbRelate::GetCacheStats( xbDbf *dChild, xbUInt64 &ullLookups, xbUInt64 &ullHits ){
+
+  ullLookups = 0;
+  ullHits    = 0;
+
+  if( dChild ){
+    xbLinkListNode<xbRelation *> *lln = FindNodeForDbf( dChild );
+    if( !lln )
+      return XB_NOT_FOUND;
+    ullLookups = lln->GetKey()->ullCacheLookups;
+    ullHits    = lln->GetKey()->ullCacheHits;
+  } else {
+    xbLinkListNode<xbRelation *> *lln = GetNextTreeNode( NULL );
+    while( lln ){
+      ullLookups += lln->GetKey()->ullCacheLookups;
+      ullHits    += lln->GetKey()->ullCacheHits;
+      lln = GetNextTreeNode( lln );
+    }
+  }
+  return XB_NO_ERROR;
+}
+/************************************************************************/
+xbInt16 xbRelate::GetPrefetchWindow() const {
+  return iPrefetchWindow;
+}
 /************************************************************************/
 xbInt16 xbRelate::GetFirstRecForNode( xbLinkListNode<xbRelation *> *lln ){
 
@@ -556,6 +926,12 @@ xbInt16 xbRelate::GetFirstRelRecord(){
       pRel->ulSaveParRecNo = 0;
       pRel->iStatus  = 0;
       pRel->ulRecPos = 0;
+      pRel->cJoin    = 0;
+      pRel->ulMrgRecNo = 0;
+      pRel->ulPfchRecNo = 0;
+      // child records cached by an earlier query may have been changed through another
+      // table object or by another process since, each query starts with an empty cache
+      CacheFree( pRel );
       lln = lln->GetNextNode();
     }
 
@@ -609,6 +985,18 @@ xbInt16 xbRelate::GetFirstRelRecord(){
   return iRc;
 }
 
+/************************************************************************/
+char xbRelate::GetJoinMode() const {
+  return cJoinMode;
+}
+/************************************************************************/
+char xbRelate::GetJoinType( xbDbf *dChild ){
+
+  xbLinkListNode<xbRelation *> *lln = FindNodeForDbf( dChild );
+  if( !lln || lln->GetKey()->cType == 'M' )
+    return 0;
+  return lln->GetKey()->cJoin;
+}
 /************************************************************************/
 xbInt16 xbRelate::GetLastRecForNode( xbLinkListNode<xbRelation *> *lln ){
 
@@ -754,8 +1142,57 @@ xbInt16 xbRelate::GetNextRecForNode( xbLinkListNode<xbRelation *> *lln ){
         if( bFirstKeyLookup ){
 
           pRel->ulSaveParRecNo = pRel->pParent->dDbf->GetCurRecNo();
-          if(( iRc = RelKeySearch( pRel, 'F', sParentKey, dParentKey, dtParentKey )) != XB_NO_ERROR ){
-            iErrorStop = 140;
+
+          if( pRel->cJoin == 0 ){
+            if(( iRc = SetJoinType( pRel )) != XB_NO_ERROR ){
+              iErrorStop = 131;
+              throw iRc;
+            }
+          }
+          xbBool bHit = xbFalse;
+          if(( iRc = CacheLookup( pRel, 'F', sParentKey, dParentKey, dtParentKey, bHit )) != XB_NO_ERROR ){
+            iErrorStop = 132;
+            throw iRc;
+          }
+
+          // read ahead the master table and cache the child records for the coming parent keys
+          if( !bHit && iPrefetchWindow > 0 && pRel->cpCache && pRel->cJoin == 'I' && !pRel->pFilt &&
+              pRel->pParent->cType == 'M' && !pRel->pParent->pFilt &&
+              pRel->pParent->dDbf->GetCurRecNo() > pRel->ulPfchRecNo &&
+              pRel->pParent->dDbf->GetDbfStatus() == XB_OPEN && pRel->dDbf->GetDbfStatus() == XB_OPEN ){
+            if(( iRc = PrefetchChildKeys( pRel, sParentKey, dParentKey, dtParentKey )) != XB_NO_ERROR ){
+              iErrorStop = 133;
+              throw iRc;
+            }
+          }
+
+          // step the child tag forward from the previous parent's position if possible
+          xbBool bMerged = xbFalse;
+          if( !bHit ){
+            if(( iRc = MergeKeySearch( pRel, sParentKey, dParentKey, dtParentKey, bMerged )) != XB_NO_ERROR ){
+              iErrorStop = 135;
+              throw iRc;
+            }
+          }
+          if( !bHit && !bMerged ){
+            if(( iRc = RelKeySearch( pRel, 'F', sParentKey, dParentKey, dtParentKey )) != XB_NO_ERROR ){
+              iErrorStop = 140;
+              throw iRc;
+            }
+            if( pRel->iStatus == XB_NO_ERROR && pRel->cJoin == 'I' ){
+              pRel->ulMrgRecNo = pRel->dDbf->GetCurRecNo();
+              pRel->ulMrgSeq   = pRel->dDbf->GetChangeSeq();
+              SetMergeKey( pRel, sParentKey, dParentKey, dtParentKey );
+            }
+          }
+          if( !bHit )
+            CacheFillStart( pRel, 'F', sParentKey, dParentKey, dtParentKey );
+
+        } else if( pRel->cpCacheHit ){
+
+          // child records for this key come from the cache
+          if(( iRc = CacheStep( pRel, 'N' )) != XB_NO_ERROR ){
+            iErrorStop = 145;
             throw iRc;
           }
 
@@ -768,6 +1205,11 @@ xbInt16 xbRelate::GetNextRecForNode( xbLinkListNode<xbRelation *> *lln ){
             iRc = pRel->dDbf->GetNextKey( pRel->pIx, pRel->pTag );   // pulls next key and corresponding record
           }
 
+          if( iRc == XB_NO_ERROR && pRel->ulMrgRecNo != 0 )
+            pRel->ulMrgRecNo = pRel->dDbf->GetCurRecNo();
+          else
+            pRel->ulMrgRecNo = 0;
+
           if( iRc != XB_NO_ERROR ){
             pRel->iStatus = XB_NOT_FOUND;
             if( iRc != XB_EOF && iRc != XB_EMPTY && iRc != XB_NOT_FOUND ){
@@ -797,6 +1239,7 @@ xbInt16 xbRelate::GetNextRecForNode( xbLinkListNode<xbRelation *> *lln ){
               }
             }
           }
+          CacheFill( pRel, 'F' );
         }
       }
       if( pRel->iStatus == 0 )
@@ -885,6 +1328,9 @@ xbInt16 xbRelate::GetPrevRecForNode( xbLinkListNode<xbRelation *> *lln ){
 
     } else {   // child relation
 
+      // the child tag is moved backwards, merge lookups restart with a key search
+      pRel->ulMrgRecNo = 0;
+
       if( pRel->pParent->dDbf->GetCurRecNo() == 0 ){
         pRel->iStatus = XB_NOT_FOUND;
 
@@ -907,8 +1353,31 @@ xbInt16 xbRelate::GetPrevRecForNode( xbLinkListNode<xbRelation *> *lln ){
           // std::cout << "gprfn firstkey lookup [" << pRel->dDbf->GetFileName().Str() << "] pa key = [" << sParentKey << "]\n";
 
           pRel->ulSaveParRecNo = pRel->pParent->dDbf->GetCurRecNo();
-          if(( iRc = RelKeySearch( pRel, 'L', sParentKey, dParentKey, dtParentKey )) != XB_NO_ERROR ){
-            iErrorStop = 140;
+
+          if( pRel->cJoin == 0 ){
+            if(( iRc = SetJoinType( pRel )) != XB_NO_ERROR ){
+              iErrorStop = 134;
+              throw iRc;
+            }
+          }
+          xbBool bHit = xbFalse;
+          if(( iRc = CacheLookup( pRel, 'L', sParentKey, dParentKey, dtParentKey, bHit )) != XB_NO_ERROR ){
+            iErrorStop = 135;
+            throw iRc;
+          }
+          if( !bHit ){
+            if(( iRc = RelKeySearch( pRel, 'L', sParentKey, dParentKey, dtParentKey )) != XB_NO_ERROR ){
+              iErrorStop = 140;
+              throw iRc;
+            }
+            CacheFillStart( pRel, 'L', sParentKey, dParentKey, dtParentKey );
+          }
+
+        } else if( pRel->cpCacheHit ){
+
+          // child records for this key come from the cache
+          if(( iRc = CacheStep( pRel, 'P' )) != XB_NO_ERROR ){
+            iErrorStop = 145;
             throw iRc;
           }
 
@@ -951,6 +1420,7 @@ xbInt16 xbRelate::GetPrevRecForNode( xbLinkListNode<xbRelation *> *lln ){
               }
             }
           }
+          CacheFill( pRel, 'L' );
         }
       }
       if( pRel->iStatus == 0 )
@@ -1115,6 +1585,409 @@ xbInt16 xbRelate::InitQuery(){
   return iRc;
 }
 /************************************************************************/
+// MergeKeySearch positions the child tag for a parent key by stepping forward from where
+// the previous parent key left the tag cursor, rather than searching the tag.
+//
+// Everything ahead of the cursor has a key no greater than the last parent key looked up,
+// so if the new parent key is past it, any matches are at or after the cursor.  A repeat
+// lookup of a last key that had no matches is answered without moving the cursor.
+//
+// bDone = xbTrue   lookup done, pRel->iStatus is 0 or XB_NOT_FOUND
+// bDone = xbFalse  parent key is not past the last one, or too far ahead, caller searches the tag
+
+xbInt16 xbRelate::MergeKeySearch( xbRelation *pRel, xbString &sKey, xbDouble &dKey, xbDate &dtKey, xbBool &bDone ){
+
+  xbInt16  iRc = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbString sThisKey;
+  xbDouble dThisKey;
+  xbDate   dtThisKey;
+
+  bDone = xbFalse;
+  try{
+    if( pRel->ulMrgRecNo == 0 || pRel->cJoin != 'I' || pRel->ulMrgSeq != pRel->dDbf->GetChangeSeq())
+      return XB_NO_ERROR;
+    if( pRel->pIx->GetSortOrder( pRel->pTag ))
+      return XB_NO_ERROR;
+    xbInt16 iCmp = OrderKeys( pRel, sKey, *pRel->sMrgKey, dKey, pRel->dMrgKey, dtKey, *pRel->dtMrgKey );
+    if( iCmp < 0 || ( iCmp == 0 && pRel->iMrgKeySts == XB_NO_ERROR ))
+      return XB_NO_ERROR;
+    if( iCmp == 0 ){
+      // same key as the last lookup, which found no child records
+      pRel->iStatus = XB_NOT_FOUND;
+      bDone = xbTrue;
+      return XB_NO_ERROR;
+    }
+
+    if(( iRc = GetChildRelKeys( pRel, sThisKey, dThisKey, dtThisKey )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    iCmp = OrderKeys( pRel, sThisKey, sKey, dThisKey, dKey, dtThisKey, dtKey );
+    xbInt16 iSteps = 0;
+    while( iCmp < 0 && iSteps < XB_REL_MERGE_MAX_STEPS ){
+      if( pRel->pFilt )
+        iRc = pRel->pFilt->GetNextRecordIx();
+      else
+        iRc = pRel->dDbf->GetNextKey( pRel->pIx, pRel->pTag );
+
+      if( iRc == XB_EOF ){
+        // no child keys past this parent key
+        pRel->ulMrgRecNo = 0;
+        pRel->iStatus = XB_NOT_FOUND;
+        bDone = xbTrue;
+        return XB_NO_ERROR;
+      } else if( iRc != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+      pRel->ulMrgRecNo = pRel->dDbf->GetCurRecNo();
+      if(( iRc = GetChildRelKeys( pRel, sThisKey, dThisKey, dtThisKey )) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+      iCmp = OrderKeys( pRel, sThisKey, sKey, dThisKey, dKey, dtThisKey, dtKey );
+      iSteps++;
+    }
+    if( iCmp < 0 )
+      return XB_NO_ERROR;
+
+    if( iCmp == 0 ){
+      if( pRel->dDbf->GetCurRecNo() != pRel->ulMrgRecNo ){
+        if(( iRc = pRel->dDbf->GetRecord( pRel->ulMrgRecNo )) != XB_NO_ERROR ){
+          iErrorStop = 130;
+          throw iRc;
+        }
+      }
+      pRel->iStatus = XB_NO_ERROR;
+    } else {
+      pRel->iStatus = XB_NOT_FOUND;
+    }
+    SetMergeKey( pRel, sKey, dKey, dtKey );
+    bDone = xbTrue;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    pRel->ulMrgRecNo = 0;
+    sMsg.Sprintf( "xbRelate::MergeKeySearch() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/************************************************************************/
+// OrderKeys compares two keys in index order, returns -1, 0 or 1
+// character keys are compared space padded to the same length, the same as the index keys
+
+xbInt16 xbRelate::OrderKeys( xbRelation *pRel, xbString &s1, xbString &s2, xbDouble &d1, xbDouble &d2, xbDate &dt1, xbDate &dt2 ){
+
+  char cParType = pRel->pParentExp->GetReturnType();
+  if( cParType == XB_EXP_CHAR ){
+    xbUInt32 ulLen1 = s1.Len();
+    xbUInt32 ulLen2 = s2.Len();
+    xbUInt32 ulLen  = ulLen1 < ulLen2 ? ulLen1 : ulLen2;
+    int i = memcmp( s1.Str(), s2.Str(), ulLen );
+    if( i == 0 ){
+      const unsigned char *p = (const unsigned char *) ( ulLen1 > ulLen2 ? s1.Str() : s2.Str());
+      xbUInt32 ulMax = ulLen1 > ulLen2 ? ulLen1 : ulLen2;
+      for( xbUInt32 ul = ulLen; ul < ulMax && i == 0; ul++ ){
+        if( p[ul] != ' ' )
+          i = ( p[ul] > ' ' ) ? 1 : -1;
+      }
+      if( ulLen1 < ulLen2 )
+        i = -i;
+    }
+    return ( i < 0 ) ? -1 : ( i > 0 ) ? 1 : 0;
+  } else if( cParType == XB_EXP_NUMERIC ){
+    return ( d1 < d2 ) ? -1 : ( d1 > d2 ) ? 1 : 0;
+  } else {
+    return ( dt1 < dt2 ) ? -1 : ( dt1 > dt2 ) ? 1 : 0;
+  }
+}
+/************************************************************************/
+// child record to read for a prefetch, and where its image goes in the cache entry
+struct xbRelPrefetchRec {
+  xbUInt32 ulRecNo;
+  char     *cpBuf;
+};
+
+//! @brief Compare two prefetch records by record number for qsort.
+static int xbRelComparePrefetchRec( const void *p1, const void *p2 ){
+  xbUInt32 ul1 = ((const xbRelPrefetchRec *) p1)->ulRecNo;
+  xbUInt32 ul2 = ((const xbRelPrefetchRec *) p2)->ulRecNo;
+  return ul1 < ul2 ? -1 : ( ul1 > ul2 ? 1 : 0 );
+}
+/************************************************************************/
+// PrefetchChildKeys reads ahead up to iPrefetchWindow master records past the current one and
+// fills a cache entry for each new parent key found.  The keys are searched in child tag order
+// without reading the child records, then the child records for all the keys are read in record
+// number order, with block reads, and kept with the cache entries.
+
+// Keys equal to the current parent key, which is looked up by the caller, and keys already
+// cached are skipped.  At most iCacheCnt - 1 keys are fetched, so the caller's own entry does
+// not replace one of them.  The master table is left on its current record and the child tag
+// position is lost.
+
+xbInt16 xbRelate::PrefetchChildKeys( xbRelation *pRel, xbString &sKey, xbDouble &dKey, xbDate &dtKey ){
+
+  xbInt16  iRc = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbDbf    *dMaster = pRel->pParent->dDbf;
+  xbUInt32 ulSaveRecNo = dMaster->GetCurRecNo();
+  xbUInt32 ulBatchSeq = pRel->ulCacheUse;
+  xbRelCacheEntry **epBatch = NULL;
+  xbInt16  iBatchCnt = 0;
+  xbRelPrefetchRec *rpRecs = NULL;
+  #ifdef XB_BLOCKREAD_SUPPORT
+  xbBool   bBlockRead = pRel->dDbf->GetBlockReadStatus();
+  #endif // XB_BLOCKREAD_SUPPORT
+
+  try{
+    char     cParType = pRel->pParentExp->GetReturnType();
+    xbDouble dCurKey  = ( cParType == XB_EXP_DATE ) ? (xbDouble) dtKey.JulianDays() : dKey;
+    xbString sThisKey;
+    xbDouble dThisKey;
+    xbDate   dtThisKey;
+    xbDate   dtEntryKey;
+    xbUInt32 ulMasterCnt;
+
+    if(( iRc = dMaster->GetRecordCnt( ulMasterCnt )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    if(( epBatch = (xbRelCacheEntry **) calloc( (size_t) pRel->iCacheCnt, sizeof( xbRelCacheEntry * ))) == NULL ){
+      iErrorStop = 110;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+
+    // collect the new keys from the next master records
+    xbUInt32 ulRecNo = ulSaveRecNo;
+    xbUInt32 ulLastRecNo = ulSaveRecNo + (xbUInt32) iPrefetchWindow;
+    if( ulLastRecNo > ulMasterCnt )
+      ulLastRecNo = ulMasterCnt;
+
+    while( ulRecNo < ulLastRecNo && iBatchCnt < pRel->iCacheCnt - 1 ){
+      ulRecNo++;
+      if(( iRc = dMaster->GetRecord( ulRecNo )) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+      if( dMaster->RecordDeleted())
+        continue;
+      if(( iRc = GetParentRelKeys( pRel, sThisKey, dThisKey, dtThisKey )) != XB_NO_ERROR ){
+        iErrorStop = 130;
+        throw iRc;
+      }
+      xbDouble dKeyVal = ( cParType == XB_EXP_DATE ) ? (xbDouble) dtThisKey.JulianDays() : dThisKey;
+      if( cParType == XB_EXP_CHAR ? sThisKey == sKey : dKeyVal == dCurKey )
+        continue;
+
+      // skip keys already cached or already in this batch, and find the entry to replace
+      xbBool bCached = xbFalse;
+      xbRelCacheEntry *e = NULL;
+      for( xbInt16 i = 0; i < pRel->iCacheCnt && !bCached; i++ ){
+        xbRelCacheEntry *c = &pRel->cpCache[i];
+        xbBool bInBatch = ( c->ulUseSeq > ulBatchSeq );
+        if( c->bValid || bInBatch )
+          bCached = ( cParType == XB_EXP_CHAR ) ? *c->sKey == sThisKey : c->dKey == dKeyVal;
+        if( !bInBatch && ( !e || ( e->bValid && ( !c->bValid || c->ulUseSeq < e->ulUseSeq ))))
+          e = c;
+      }
+      if( bCached )
+        continue;
+
+      e->bValid    = xbFalse;
+      e->ulRecCnt  = 0;
+      e->ulDataCnt = 0;
+      e->ulUseSeq  = ++pRel->ulCacheUse;
+      if( cParType == XB_EXP_CHAR ){
+        if( !e->sKey )
+          e->sKey = new xbString();
+        *e->sKey = sThisKey;
+      } else {
+        e->dKey = dKeyVal;
+      }
+      epBatch[iBatchCnt++] = e;
+    }
+    pRel->ulPfchRecNo = ulRecNo;
+
+    // put the keys in child tag order
+    xbBool bDescending = pRel->pIx->GetSortOrder( pRel->pTag );
+    for( xbInt16 i = 1; i < iBatchCnt; i++ ){
+      xbRelCacheEntry *e = epBatch[i];
+      xbInt16 j = i;
+      while( j > 0 ){
+        xbRelCacheEntry *p = epBatch[j-1];
+        xbInt16 iCmp;
+        if( cParType == XB_EXP_CHAR )
+          iCmp = OrderKeys( pRel, *p->sKey, *e->sKey, dThisKey, dThisKey, dtThisKey, dtThisKey );
+        else
+          iCmp = ( p->dKey < e->dKey ) ? -1 : ( p->dKey > e->dKey ) ? 1 : 0;
+        if( bDescending ? iCmp >= 0 : iCmp <= 0 )
+          break;
+        epBatch[j] = p;
+        j--;
+      }
+      epBatch[j] = e;
+    }
+
+    // search the child tag for each key, collecting record numbers without reading the records
+    xbUInt32 ulTotRecs = 0;
+    for( xbInt16 i = 0; i < iBatchCnt; i++ ){
+      xbRelCacheEntry *e = epBatch[i];
+      if( cParType == XB_EXP_CHAR ){
+        iRc = pRel->dDbf->Find( pRel->pIx, pRel->pTag, *e->sKey, 0 );
+      } else if( cParType == XB_EXP_NUMERIC ){
+        iRc = pRel->dDbf->Find( pRel->pIx, pRel->pTag, e->dKey, 0 );
+      } else {
+        dtEntryKey.JulToDate8( (xbInt32) e->dKey );
+        iRc = pRel->dDbf->Find( pRel->pIx, pRel->pTag, dtEntryKey, 0 );
+      }
+      xbBool bMatch = ( iRc == XB_NO_ERROR );
+      if( iRc != XB_NO_ERROR && iRc != XB_NOT_FOUND && iRc != XB_BOF && iRc != XB_EOF && iRc != XB_EMPTY ){
+        iErrorStop = 140;
+        throw iRc;
+      }
+      iRc = XB_NO_ERROR;
+      e->bValid = xbTrue;
+
+      while( bMatch ){
+        xbUInt32 ulChildRecNo;
+        if(( iRc = pRel->pIx->GetCurKeyRecNo( pRel->pTag, ulChildRecNo )) != XB_NO_ERROR ){
+          iErrorStop = 150;
+          throw iRc;
+        }
+        if( e->ulRecCnt >= XB_REL_CACHE_MAX_RECS ){
+          e->bValid = xbFalse;
+          break;
+        }
+        if( e->ulRecCnt == e->ulRecSize ){
+          xbUInt32 ulNewSize = e->ulRecSize ? e->ulRecSize * 2 : 8;
+          xbUInt32 *ulpNew = (xbUInt32 *) realloc( e->ulpRecs, sizeof( xbUInt32 ) * ulNewSize );
+          if( !ulpNew ){
+            iErrorStop = 160;
+            iRc = XB_NO_MEMORY;
+            throw iRc;
+          }
+          e->ulpRecs   = ulpNew;
+          e->ulRecSize = ulNewSize;
+        }
+        e->ulpRecs[e->ulRecCnt++] = ulChildRecNo;
+
+        if(( iRc = pRel->pIx->GetNextKey( pRel->pTag, 0 )) != XB_NO_ERROR ){
+          if( iRc != XB_EOF ){
+            iErrorStop = 170;
+            throw iRc;
+          }
+          iRc = XB_NO_ERROR;
+          break;
+        }
+        if(( iRc = GetChildRelKeys( pRel, sThisKey, dThisKey, dtThisKey )) != XB_NO_ERROR ){
+          iErrorStop = 180;
+          throw iRc;
+        }
+        xbString &sEntryKey = ( cParType == XB_EXP_CHAR ) ? *e->sKey : sThisKey;
+        if(( iRc = CompareKeys( pRel, sThisKey, sEntryKey, dThisKey, e->dKey, dtThisKey, dtEntryKey )) != XB_NO_ERROR ){
+          if( iRc != XB_NOT_FOUND ){
+            iErrorStop = 190;
+            throw iRc;
+          }
+          iRc = XB_NO_ERROR;
+          bMatch = xbFalse;
+        }
+      }
+      if( e->bValid )
+        ulTotRecs += e->ulRecCnt;
+    }
+
+    // read the child records in record number order into the cache entries
+    if( ulTotRecs > 0 && pRel->dDbf->GetMultiUser() != xbOn ){
+      if(( rpRecs = (xbRelPrefetchRec *) calloc( (size_t) ulTotRecs, sizeof( xbRelPrefetchRec ))) == NULL ){
+        iErrorStop = 200;
+        iRc = XB_NO_MEMORY;
+        throw iRc;
+      }
+      xbUInt32 ulRecLen  = pRel->dDbf->GetRecordLen();
+      xbUInt32 ulBytes   = 0;
+      xbUInt32 ulReadCnt = 0;
+      for( xbInt16 i = 0; i < iBatchCnt; i++ ){
+        xbRelCacheEntry *e = epBatch[i];
+        xbUInt32 ulSize = e->ulRecCnt * ulRecLen;
+        if( !e->bValid || ulSize == 0 || ulBytes + ulSize > XB_REL_PREFETCH_MAX_BYTES )
+          continue;
+        if( e->ulDataSize < ulSize ){
+          char *cpNew = (char *) realloc( e->cpRecData, ulSize );
+          if( !cpNew )
+            continue;
+          e->cpRecData  = cpNew;
+          e->ulDataSize = ulSize;
+        }
+        for( xbUInt32 ul = 0; ul < e->ulRecCnt; ul++ ){
+          rpRecs[ulReadCnt].ulRecNo = e->ulpRecs[ul];
+          rpRecs[ulReadCnt].cpBuf   = e->cpRecData + ul * ulRecLen;
+          ulReadCnt++;
+        }
+        e->ulDataCnt = e->ulRecCnt;
+        ulBytes += ulSize;
+      }
+      qsort( rpRecs, ulReadCnt, sizeof( xbRelPrefetchRec ), xbRelComparePrefetchRec );
+
+      #ifdef XB_BLOCKREAD_SUPPORT
+      if( ulReadCnt > 1 && !bBlockRead ){
+        if(( iRc = pRel->dDbf->EnableBlockReadProcessing()) != XB_NO_ERROR ){
+          iErrorStop = 210;
+          throw iRc;
+        }
+      }
+      #endif // XB_BLOCKREAD_SUPPORT
+
+      for( xbUInt32 ul = 0; ul < ulReadCnt; ul++ ){
+        if(( iRc = pRel->dDbf->GetRecord( rpRecs[ul].ulRecNo )) != XB_NO_ERROR ){
+          iErrorStop = 220;
+          throw iRc;
+        }
+        memcpy( rpRecs[ul].cpBuf, pRel->dDbf->RecBuf, ulRecLen );
+      }
+    }
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    for( xbInt16 i = 0; i < iBatchCnt; i++ ){
+      epBatch[i]->bValid    = xbFalse;
+      epBatch[i]->ulDataCnt = 0;
+    }
+    sMsg.Sprintf( "xbRelate::PrefetchChildKeys() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+
+  #ifdef XB_BLOCKREAD_SUPPORT
+  if( !bBlockRead && pRel->dDbf->GetBlockReadStatus())
+    pRel->dDbf->DisableBlockReadProcessing();
+  #endif // XB_BLOCKREAD_SUPPORT
+
+  // the child tag was moved, the next key search can't step forward from it
+  pRel->ulMrgRecNo = 0;
+
+  if( dMaster->GetCurRecNo() != ulSaveRecNo ){
+    xbInt16 iRc2;
+    if(( iRc2 = dMaster->GetRecord( ulSaveRecNo )) != XB_NO_ERROR ){
+      xbString sMsg;
+      sMsg.Sprintf( "xbRelate::PrefetchChildKeys() Exception Caught. Error Stop = [500] rc = [%d]", iRc2 );
+      xbase->WriteLogMessage( sMsg.Str() );
+      xbase->WriteLogMessage( xbase->GetErrorMessage( iRc2 ));
+      if( iRc == XB_NO_ERROR )
+        iRc = iRc2;
+    }
+  }
+  if( epBatch )
+    free( epBatch );
+  if( rpRecs )
+    free( rpRecs );
+  return iRc;
+}
+/************************************************************************/
 // This routine does a first key lookup or a last key lookup depending on cFL
 //     for key value in one of sKey, dKey or dtKey depending on key type
 
@@ -1139,6 +2012,9 @@ xbInt16 xbRelate::RelKeySearch( xbRelation *pRel, const char cFL, xbString &sKey
 
     char cParType = pRel->pParentExp->GetReturnType();
     pRel->iStatus = XB_NO_ERROR;
+    pRel->ulMrgRecNo  = 0;
+    pRel->cpCacheHit  = NULL;
+    pRel->cpCacheFill = NULL;
 
     if( cParType == 'M' ){
       iErrorStop = 100;
@@ -1146,6 +2022,21 @@ xbInt16 xbRelate::RelKeySearch( xbRelation *pRel, const char cFL, xbString &sKey
       throw iRc;
     }
 
+    if( pRel->cJoin == 0 ){
+      if(( iRc = SetJoinType( pRel )) != XB_NO_ERROR ){
+        iErrorStop = 102;
+        throw iRc;
+      }
+    }
+    #ifdef XB_HSH_SUPPORT
+    else if( pRel->cJoin == 'H' ){
+      if(( iRc = BuildJoinHash( pRel, xbFalse )) != XB_NO_ERROR ){
+        iErrorStop = 104;
+        throw iRc;
+      }
+    }
+    #endif  // XB_HSH_SUPPORT
+
     if( cParType == XB_EXP_CHAR ){
       if( pRel->pFilt )
         iRc = pRel->pFilt->Find( sKey );
@@ -1254,6 +2145,16 @@ xbInt16 xbRelate::RelKeySearch( xbRelation *pRel, const char cFL, xbString &sKey
   return iRc;
 }
 /************************************************************************/
+void xbRelate::ResetCacheStats(){
+
+  xbLinkListNode<xbRelation *> *lln = GetNextTreeNode( NULL );
+  while( lln ){
+    lln->GetKey()->ullCacheLookups = 0;
+    lln->GetKey()->ullCacheHits    = 0;
+    lln = GetNextTreeNode( lln );
+  }
+}
+/************************************************************************/
 xbLinkListNode<xbRelation *> *xbRelate::GetLastTreeNode( xbLinkListNode<xbRelation *> *lln ){
 
   xbLinkListNode<xbRelation *> *llnWork = NULL;
@@ -1337,6 +2238,12 @@ xbInt16 xbRelate::GetLastRelRecord(){
       pRel->ulSaveParRecNo = 0;
       pRel->iStatus  = 0;
       pRel->ulRecPos = 0;
+      pRel->cJoin    = 0;
+      pRel->ulMrgRecNo = 0;
+      pRel->ulPfchRecNo = 0;
+      // child records cached by an earlier query may have been changed through another
+      // table object or by another process since, each query starts with an empty cache
+      CacheFree( pRel );
       lln = lln->GetNextNode();
     }
 
@@ -1474,6 +2381,143 @@ xbInt16 xbRelate::GetRelRecord( const char cDirection ){
   return iRc;
 }
 /************************************************************************/
+xbInt16 xbRelate::SetCacheSize( xbInt16 iEntries ){
+
+  if( iEntries < 0 )
+    return XB_INVALID_OPTION;
+  iCacheSize = iEntries;
+  return XB_NO_ERROR;
+}
+/************************************************************************/
+#ifdef XB_INDEX_SUPPORT
+xbInt16 xbRelate::SetMasterIxRange( char cRangeMode, xbIx *pIx, void *vpTag ){
+
+  xbLinkListNode<xbRelation *> *lln = llQryTree.GetHeadNode();
+  if( !lln || !lln->GetKey()->pFilt )
+    return XB_NOT_OPEN;
+  return lln->GetKey()->pFilt->SetIxRange( cRangeMode, pIx, vpTag );
+}
+#endif  // XB_INDEX_SUPPORT
+/************************************************************************/
+xbInt16 xbRelate::SetPrefetchWindow( xbInt16 iRecs ){
+
+  if( iRecs < 0 )
+    return XB_INVALID_OPTION;
+  iPrefetchWindow = iRecs;
+  return XB_NO_ERROR;
+}
+/************************************************************************/
+xbInt16 xbRelate::SetJoinMode( char cJoinMode ){
+
+  #ifdef XB_HSH_SUPPORT
+  if( cJoinMode != 'A' && cJoinMode != 'I' && cJoinMode != 'H' )
+    return XB_INVALID_OPTION;
+  #else
+  if( cJoinMode != 'A' && cJoinMode != 'I' )
+    return XB_INVALID_OPTION;
+  #endif  // XB_HSH_SUPPORT
+
+  this->cJoinMode = cJoinMode;
+  return XB_NO_ERROR;
+}
+/************************************************************************/
+xbInt16 xbRelate::SetJoinMode( xbDbf *dChild, char cJoinMode ){
+
+  #ifdef XB_HSH_SUPPORT
+  if( cJoinMode != 0 && cJoinMode != 'A' && cJoinMode != 'I' && cJoinMode != 'H' )
+    return XB_INVALID_OPTION;
+  #else
+  if( cJoinMode != 0 && cJoinMode != 'A' && cJoinMode != 'I' )
+    return XB_INVALID_OPTION;
+  #endif  // XB_HSH_SUPPORT
+
+  xbLinkListNode<xbRelation *> *lln = FindNodeForDbf( dChild );
+  if( !lln || lln->GetKey()->cType == 'M' )
+    return XB_INVALID_TABLE_NAME;
+  lln->GetKey()->cJoinMode = cJoinMode;
+  return XB_NO_ERROR;
+}
+/************************************************************************/
+// choose index or hash lookups for a child node, called on the first key search in a query
+
+xbInt16 xbRelate::SetJoinType( xbRelation *pRel ){
+
+  xbInt16  iRc        = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  char     cJoin      = 'I';
+  char     cMode      = pRel->cJoinMode ? pRel->cJoinMode : cJoinMode;
+
+  try{
+    #ifdef XB_HSH_SUPPORT
+    if( !pRel->pKeyIx || cMode == 'H' ){
+      cJoin = 'H';
+
+    } else if( cMode == 'A' && !pRel->pKeyIx->GetUnique( pRel->pKeyTag )){
+      // a small child table read once is cheaper than an index search for each parent record,
+      // a filtered parent is compared by the records its query is estimated to return
+      xbUInt32 ulChildCnt  = 0;
+      xbUInt32 ulParentCnt = 0;
+      if(( iRc = pRel->dDbf->GetRecordCnt( ulChildCnt )) != XB_NO_ERROR ){
+        iErrorStop = 100;
+        throw iRc;
+      }
+      if( pRel->pParent->pFilt ){
+        if(( iRc = pRel->pParent->pFilt->GetEstimatedRecCnt( ulParentCnt )) != XB_NO_ERROR ){
+          iErrorStop = 110;
+          throw iRc;
+        }
+      } else if(( iRc = pRel->pParent->dDbf->GetRecordCnt( ulParentCnt )) != XB_NO_ERROR ){
+        iErrorStop = 115;
+        throw iRc;
+      }
+      if( ulChildCnt > 0 && ulChildCnt <= ulParentCnt && ulChildCnt <= XB_REL_HASH_MAX_RECS )
+        cJoin = 'H';
+    }
+    #endif  // XB_HSH_SUPPORT
+
+    pRel->pIx  = pRel->pKeyIx;
+    pRel->pTag = pRel->pKeyTag;
+
+    #ifdef XB_HSH_SUPPORT
+    if( cJoin == 'H' ){
+      if(( iRc = BuildJoinHash( pRel, xbTrue )) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+      pRel->pIx  = pRel->pHshIx;
+      pRel->pTag = pRel->pHshTag;
+    } else if( pRel->pHshIx ){
+      delete pRel->pHshIx;
+      pRel->pHshIx  = NULL;
+      pRel->pHshTag = NULL;
+    }
+    #endif  // XB_HSH_SUPPORT
+
+    if( pRel->pFilt )
+      pRel->pFilt->SetIxTag( pRel->pIx, pRel->pTag );
+    pRel->cJoin = cJoin;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbRelate::SetJoinType() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/************************************************************************/
+void xbRelate::SetMergeKey( xbRelation *pRel, xbString &sKey, xbDouble &dKey, xbDate &dtKey ){
+
+  if( !pRel->sMrgKey )
+    pRel->sMrgKey = new xbString();
+  if( !pRel->dtMrgKey )
+    pRel->dtMrgKey = new xbDate();
+  *pRel->sMrgKey   = sKey;
+  pRel->dMrgKey    = dKey;
+  *pRel->dtMrgKey  = dtKey;
+  pRel->iMrgKeySts = pRel->iStatus;
+}
+/************************************************************************/
 xbInt16 xbRelate::SetMaster( xbDbf * d, const xbString &sFilter ) {
 
   xbInt16    iRc        = XB_NO_ERROR;
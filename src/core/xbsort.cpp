@@ -0,0 +1,1156 @@
+/* xbsort.cpp
+
+XBase64 Software Library
+
+Copyright (c) 1997,2003,2014,2022,2023,2024 Gary A Kunkel
+
+The xb64 software library is covered under the terms of the GPL Version 3, 2007 license.
+
+Email Contact:
+
+    XDB-devel@lists.sourceforge.net
+    XDB-users@lists.sourceforge.net
+
+   External sort class, sorts fixed length records in memory and merges sorted runs from temp files
+
+*/
+
+#include "xbase.h"
+
+#ifdef XB_SORT_SUPPORT
+
+namespace xb{
+
+// the record buffer starts at this many records and doubles as needed, up to the memory limit
+static const xbUInt32 xbSortInitRecs  = 1024;
+
+// bytes staged between the sorted records and a run file
+static const xbUInt32 xbSortWriteSize = 65536;
+
+/***********************************************************************/
+//! @brief Constructor.
+/*!
+  @param x Pointer to xbXBase instance.
+*/
+xbSort::xbSort( xbXBase *x ){
+  xbase         = x;
+  ulKeyLen      = 0;
+  ulRecLen      = 0;
+  bUnique       = xbFalse;
+  ulMemLimit    = x->GetSortMemoryLimit();
+  cStatus       = ' ';
+  cpRecBuf      = NULL;
+  cpRecs        = NULL;
+  cpTemp        = NULL;
+  ulBufMax      = 0;
+  ulBufSize     = 0;
+  ulBufCnt      = 0;
+  ulSortCnt     = 0;
+  fRuns         = NULL;
+  ullRunFileCnt = 0;
+  rRuns         = NULL;
+  rLastRun      = NULL;
+  ulRunCnt      = 0;
+  ulRunsWritten = 0;
+  ullRecCnt     = 0;
+  rMerge        = NULL;
+  lpTree        = NULL;
+  lMergeCnt     = 0;
+  lLastWinner   = -1;
+  cpLastKey     = NULL;
+  bHaveLastKey  = xbFalse;
+  bRandomAccess = xbFalse;
+  rOut          = NULL;
+  ullPos        = 0;
+}
+/***********************************************************************/
+//! @brief Destructor.
+xbSort::~xbSort(){
+  Close();
+}
+/***********************************************************************/
+//! @brief Add a record.
+/*!
+  @param cpKey Key, the length given to Init().
+  @param cpData Data to carry with the key, the length given to Init().  NULL for no data.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::Add( const char *cpKey, const char *cpData ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    if( cStatus != 'A' ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_OPTION;
+      throw iRc;
+    }
+    if( ulBufCnt >= ulBufSize ){
+      if( ulBufSize < ulBufMax ){
+        // grow the buffer, the record pointers aren't set until the buffer is sorted
+        xbUInt32 ulNewSize = ulBufSize ? ulBufSize * 2 : xbSortInitRecs;
+        if( ulNewSize > ulBufMax )
+          ulNewSize = ulBufMax;
+        char *p = (char *) realloc( cpRecBuf, (size_t) ulNewSize * ulRecLen );
+        if( !p ){
+          iErrorStop = 110;
+          iRc = XB_NO_MEMORY;
+          throw iRc;
+        }
+        cpRecBuf  = p;
+        ulBufSize = ulNewSize;
+      } else {
+        if(( iRc = WriteRun()) != XB_NO_ERROR ){
+          iErrorStop = 120;
+          throw iRc;
+        }
+      }
+    }
+    char *p = cpRecBuf + (size_t) ulBufCnt * ulRecLen;
+    memcpy( p, cpKey, ulKeyLen );
+    if( ulRecLen > ulKeyLen ){
+      if( cpData )
+        memcpy( p + ulKeyLen, cpData, ulRecLen - ulKeyLen );
+      else
+        memset( p + ulKeyLen, 0x00, ulRecLen - ulKeyLen );
+    }
+    ulBufCnt++;
+    ullRecCnt++;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbSort::Add() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Add a run to the end of the run list.
+/*!
+  @private
+  The records of the run were just written to the end of the run file.
+  @param ullCnt Number of records in the run.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::AddRun( xbUInt64 ullCnt ){
+
+  xbSortRun *r = (xbSortRun *) calloc( 1, sizeof( xbSortRun ));
+  if( !r )
+    return XB_NO_MEMORY;
+  r->ullStart   = ullRunFileCnt;
+  r->ullRecCnt  = ullCnt;
+  ullRunFileCnt += ullCnt;
+
+  if( !rRuns )
+    rRuns = r;
+  else
+    rLastRun->next = r;
+  rLastRun = r;
+  ulRunCnt++;
+  ulRunsWritten++;
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Release all memory and remove any temp files.
+/*!
+  The object can be reused with another call to Init().
+  @returns void
+*/
+void xbSort::Close(){
+
+  MergeTerm();
+  xbSortRun *r;
+  while( rRuns ){
+    r = rRuns->next;
+    FreeRun( rRuns );
+    rRuns = r;
+  }
+  rLastRun = NULL;
+  if( rOut ){
+    FreeRun( rOut );
+    rOut = NULL;
+  }
+  if( fRuns ){
+    fRuns->xbFclose();
+    fRuns->xbRemove();
+    delete fRuns;
+    fRuns = NULL;
+  }
+  if( cpRecBuf ){
+    free( cpRecBuf );
+    cpRecBuf = NULL;
+  }
+  if( cpRecs ){
+    free( cpRecs );
+    cpRecs = NULL;
+  }
+  if( cpTemp ){
+    free( cpTemp );
+    cpTemp = NULL;
+  }
+  if( cpLastKey ){
+    free( cpLastKey );
+    cpLastKey = NULL;
+  }
+  ulBufSize     = 0;
+  ulBufCnt      = 0;
+  ulSortCnt     = 0;
+  ulRunCnt      = 0;
+  ulRunsWritten = 0;
+  ullRunFileCnt = 0;
+  ullRecCnt     = 0;
+  ullPos        = 0;
+  bRandomAccess = xbFalse;
+  cStatus       = ' ';
+}
+/***********************************************************************/
+//! @brief Load the read buffer for a run.
+/*!
+  @private
+  Reads the next buffer full of records for the run from the run file.
+  @param r Run to load.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::FillRunBuf( xbSortRun *r ){
+
+  xbUInt64 ullLeft = r->ullRecCnt - r->ullRecsRead;
+  xbUInt32 ulCnt   = ullLeft < (xbUInt64) r->ulBufMax ? (xbUInt32) ullLeft : r->ulBufMax;
+  r->ulBufPos = 0;
+  r->ulBufCnt = 0;
+  if( ulCnt == 0 )
+    return XB_NO_ERROR;
+
+  // the runs being merged share the file, so always seek
+  xbInt16 iRc = fRuns->xbFseek( (xbInt64) (( r->ullStart + r->ullRecsRead ) * ulRecLen ), SEEK_SET );
+  if( iRc == XB_NO_ERROR )
+    iRc = fRuns->xbFread( r->cpBuf, ulRecLen, ulCnt );
+  if( iRc == XB_NO_ERROR ){
+    r->ulBufCnt     = ulCnt;
+    r->ullRecsRead += ulCnt;
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Free a run.
+/*!
+  @private
+  @param r Run to free.
+  @returns void
+*/
+void xbSort::FreeRun( xbSortRun *r ){
+  if( r->cpBuf )
+    free( r->cpBuf );
+  free( r );
+}
+/***********************************************************************/
+//! @brief Get the memory limit.
+/*!
+  @returns Bytes of memory used for holding records before they are written to a run file.
+*/
+xbUInt32 xbSort::GetMemoryLimit() const {
+  return ulMemLimit;
+}
+/***********************************************************************/
+//! @brief Get the next record in key order.
+/*!
+  @param cpRec Output - pointer to the record, key followed by data.  The record is only valid
+               until the next call to GetNext(), GetRec() or Rewind().
+  @returns XB_NO_ERROR<br>XB_EOF - no more records.<br>
+           <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::GetNext( const char **cpRec ){
+
+  if( cStatus != 'S' )
+    return XB_INVALID_OPTION;
+
+  if( cpRecs ){
+    if( ullPos >= ulSortCnt )
+      return XB_EOF;
+    *cpRec = cpRecs[ullPos++];
+    return XB_NO_ERROR;
+  }
+  if( rOut ){
+    if( ullPos >= ullRecCnt )
+      return XB_EOF;
+    return GetRec( ullPos++, cpRec );
+  }
+  return MergeNext( cpRec );
+}
+/***********************************************************************/
+//! @brief Get a record by position.
+/*!
+  Available if the sort was done with random access turned on.
+  @param ullRecNo Position of the record in key order, starting at zero.
+  @param cpRec Output - pointer to the record, key followed by data.  The record is only valid
+               until the next call to GetNext(), GetRec() or Rewind().
+  @returns XB_NO_ERROR<br>XB_INVALID_RECORD - position out of range.<br>
+           <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::GetRec( xbUInt64 ullRecNo, const char **cpRec ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    if( cStatus != 'S' || !bRandomAccess ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_OPTION;
+      throw iRc;
+    }
+    if( ullRecNo >= ullRecCnt ){
+      iErrorStop = 110;
+      iRc = XB_INVALID_RECORD;
+      throw iRc;
+    }
+    if( cpRecs ){
+      *cpRec = cpRecs[ullRecNo];
+      return XB_NO_ERROR;
+    }
+
+    // the buffer holds the records just before ullRecsRead
+    xbUInt64 ullFirst = rOut->ullRecsRead - rOut->ulBufCnt;
+    if( ullRecNo < ullFirst || ullRecNo >= rOut->ullRecsRead ){
+      // reading backwards, load the buffer so it ends on the record
+      if( ullRecNo < ullFirst )
+        ullFirst = ( ullRecNo + 1 > rOut->ulBufMax ) ? ullRecNo + 1 - rOut->ulBufMax : 0;
+      else
+        ullFirst = ullRecNo;
+      rOut->ullRecsRead = ullFirst;
+      if(( iRc = FillRunBuf( rOut )) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+    }
+    *cpRec = rOut->cpBuf + (size_t) ( ullRecNo - ullFirst ) * ulRecLen;
+  }
+  catch (xbInt16 iRc ){
+    if( iRc != XB_INVALID_RECORD ){
+      xbString sMsg;
+      sMsg.Sprintf( "xbSort::GetRec() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+      xbase->WriteLogMessage( sMsg.Str() );
+      xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+    }
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Get the record count.
+/*!
+  @returns Before the sort, the number of records added.<br>
+           After the sort, the number of records in the output.  For a unique sort merged
+           on the fly by GetNext(), duplicates across runs are dropped as they are read, and
+           are still in the count.
+*/
+xbUInt64 xbSort::GetRecCnt() const {
+  return ullRecCnt;
+}
+/***********************************************************************/
+//! @brief Get the number of run files written.
+/*!
+  @returns Number of sorted runs written to disk, including the runs written by
+           intermediate merge passes.  Zero if the sort was done in memory.
+*/
+xbUInt32 xbSort::GetRunCnt() const {
+  return ulRunsWritten;
+}
+/***********************************************************************/
+//! @brief Initialize the sort.
+/*!
+  Clears any records from a prior sort.
+  @param ulKeyLenIn Key length, the leading bytes of each record.
+  @param ulDataLenIn Length of the data carried with each key, can be zero.
+  @param bUniqueIn xbTrue - Only keep the first record added for each key.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::Init( xbUInt32 ulKeyLenIn, xbUInt32 ulDataLenIn, xbBool bUniqueIn ){
+
+  Close();
+  if( ulKeyLenIn == 0 )
+    return XB_INVALID_OPTION;
+
+  ulKeyLen = ulKeyLenIn;
+  ulRecLen = ulKeyLenIn + ulDataLenIn;
+  bUnique  = bUniqueIn;
+
+  // each record in memory needs the record, and two pointers for the radix sort
+  ulBufMax = ulMemLimit / ( ulRecLen + 2 * (xbUInt32) sizeof( char * ));
+  if( ulBufMax < 2 )
+    ulBufMax = 2;
+
+  cStatus = 'A';
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Insertion sort a small group of records.
+/*!
+  @private
+  Records with equal keys keep their order.
+  @param cpRecsIn Record pointers to sort.
+  @param ulCnt Number of records.
+  @param ulOffset Key bytes before this offset are known to be equal.
+  @returns void
+*/
+void xbSort::InsertionSort( char **cpRecsIn, xbUInt32 ulCnt, xbUInt32 ulOffset ){
+
+  size_t stLen = ulKeyLen - ulOffset;
+  char *p;
+  xbUInt32 j;
+  for( xbUInt32 i = 1; i < ulCnt; i++ ){
+    p = cpRecsIn[i];
+    for( j = i; j > 0 && memcmp( cpRecsIn[j-1] + ulOffset, p + ulOffset, stLen ) > 0; j-- )
+      cpRecsIn[j] = cpRecsIn[j-1];
+    cpRecsIn[j] = p;
+  }
+}
+/***********************************************************************/
+//! @brief Replay the loser tree from a run up to the root.
+/*!
+  @private
+  While the tree is being built, a run stops at the first empty node and waits there
+  for the winner of the other side.
+  @param lRun Run whose current record changed.
+  @returns void
+*/
+void xbSort::LtAdjust( xbInt32 lRun ){
+
+  xbInt32 lWinner = lRun;
+  xbInt32 lTemp;
+  for( xbInt32 t = ( lRun + lMergeCnt ) >> 1; t > 0; t >>= 1 ){
+    if( lpTree[t] < 0 ){
+      lpTree[t] = lWinner;
+      return;
+    }
+    if( LtBeats( lpTree[t], lWinner )){
+      lTemp      = lpTree[t];
+      lpTree[t]  = lWinner;
+      lWinner    = lTemp;
+    }
+  }
+  lpTree[0] = lWinner;
+}
+/***********************************************************************/
+//! @brief Compare the current records of two runs.
+/*!
+  @private
+  An exhausted run loses to everything.  Equal keys go to the lower run, which
+  was written first, to keep the sort stable.
+  @param lRun1 First run.
+  @param lRun2 Second run.
+  @returns xbTrue if lRun1 comes first.
+*/
+xbBool xbSort::LtBeats( xbInt32 lRun1, xbInt32 lRun2 ) const {
+
+  const xbSortRun *r1 = rMerge[lRun1];
+  const xbSortRun *r2 = rMerge[lRun2];
+  xbBool b1 = r1->ulBufPos < r1->ulBufCnt;
+  xbBool b2 = r2->ulBufPos < r2->ulBufCnt;
+  if( !b1 || !b2 )
+    return b1 || ( !b2 && lRun1 < lRun2 );
+
+  int i = memcmp( r1->cpBuf + (size_t) r1->ulBufPos * ulRecLen, r2->cpBuf + (size_t) r2->ulBufPos * ulRecLen, ulKeyLen );
+  return ( i < 0 || ( i == 0 && lRun1 < lRun2 ));
+}
+/***********************************************************************/
+//! @brief Start merging runs.
+/*!
+  @private
+  @param rFirst First run to merge, the runs are taken in list order.
+  @param ulCnt Number of runs to merge.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::MergeInit( xbSortRun *rFirst, xbUInt32 ulCnt ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    MergeTerm();
+    rMerge = (xbSortRun **) calloc( ulCnt, sizeof( xbSortRun * ));
+    lpTree = (xbInt32 *) malloc( ulCnt * sizeof( xbInt32 ));
+    if( !cpLastKey )
+      cpLastKey = (char *) malloc( ulKeyLen );
+    if( !rMerge || !lpTree || !cpLastKey ){
+      iErrorStop = 100;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    lMergeCnt = (xbInt32) ulCnt;
+
+    // split the memory limit between the runs, leave a share for the merge output
+    xbUInt32 ulRecs = ulMemLimit / ( ulCnt + 1 ) / ulRecLen;
+    if( ulRecs == 0 )
+      ulRecs = 1;
+
+    xbSortRun *r = rFirst;
+    for( xbUInt32 i = 0; i < ulCnt; i++, r = r->next ){
+      rMerge[i] = r;
+      if(( r->cpBuf = (char *) malloc( (size_t) ulRecs * ulRecLen )) == NULL ){
+        iErrorStop = 110;
+        iRc = XB_NO_MEMORY;
+        throw iRc;
+      }
+      r->ulBufMax    = ulRecs;
+      r->ullRecsRead = 0;
+      if(( iRc = FillRunBuf( r )) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+      lpTree[i] = -1;
+    }
+    for( xbInt32 l = lMergeCnt - 1; l >= 0; l-- )
+      LtAdjust( l );
+    lLastWinner  = -1;
+    bHaveLastKey = xbFalse;
+  }
+  catch (xbInt16 iRc ){
+    MergeTerm();
+    xbString sMsg;
+    sMsg.Sprintf( "xbSort::MergeInit() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Get the next record from the merge.
+/*!
+  @private
+  The winning run is not moved forward until the next call, so the returned
+  record stays in the run buffer until then.
+  @param cpRec Output - pointer to the record.
+  @returns XB_NO_ERROR<br>XB_EOF<br><a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::MergeNext( const char **cpRec ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+  xbSortRun *r;
+  const char *p;
+
+  try{
+    if( !lpTree ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_OPTION;
+      throw iRc;
+    }
+    for( ;; ){
+      if( lLastWinner >= 0 ){
+        r = rMerge[lLastWinner];
+        if( ++r->ulBufPos >= r->ulBufCnt ){
+          if(( iRc = FillRunBuf( r )) != XB_NO_ERROR ){
+            iErrorStop = 110;
+            throw iRc;
+          }
+        }
+        LtAdjust( lLastWinner );
+      }
+      lLastWinner = lpTree[0];
+      r = rMerge[lLastWinner];
+      if( r->ulBufPos >= r->ulBufCnt ){
+        lLastWinner = -1;
+        return XB_EOF;
+      }
+      p = r->cpBuf + (size_t) r->ulBufPos * ulRecLen;
+      if( bUnique ){
+        if( bHaveLastKey && memcmp( p, cpLastKey, ulKeyLen ) == 0 )
+          continue;
+        memcpy( cpLastKey, p, ulKeyLen );
+        bHaveLastKey = xbTrue;
+      }
+      *cpRec = p;
+      return XB_NO_ERROR;
+    }
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbSort::MergeNext() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Merge the runs in groups of XB_SORT_MERGE_ORDER.
+/*!
+  @private
+  The merged runs are written to a new run file, in the same order as the groups
+  they came from, so records with equal keys stay in the order they were added.
+  The old run file is then removed.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::MergePass(){
+
+  xbInt16   iRc = XB_NO_ERROR;
+  xbInt16   iErrorStop = 0;
+  xbFile    *fNew      = NULL;
+  xbFile    *fOld      = NULL;
+  xbSortRun *rOld      = NULL;
+  xbSortRun *r;
+  xbUInt32  ulCnt;
+  xbUInt64  ullCnt;
+  char      *cpStage   = NULL;
+  xbUInt32  ulStageMax;
+  xbUInt32  ulStageCnt;
+  const char *p;
+
+  try{
+    ulStageMax = xbSortWriteSize / ulRecLen;
+    if( ulStageMax == 0 )
+      ulStageMax = 1;
+    if(( cpStage = (char *) malloc( (size_t) ulStageMax * ulRecLen )) == NULL ){
+      iErrorStop = 100;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    if(( iRc = OpenRunFile( &fNew )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+
+    // the old runs are merged from the old file, the new runs are added to the new file
+    fOld          = fRuns;
+    rOld          = rRuns;
+    rRuns         = NULL;
+    rLastRun      = NULL;
+    ulRunCnt      = 0;
+    ullRunFileCnt = 0;
+
+    r = rOld;
+    while( r ){
+      ulCnt = 0;
+      xbSortRun *rFirst = r;
+      for( ; r && ulCnt < XB_SORT_MERGE_ORDER; r = r->next )
+        ulCnt++;
+
+      fRuns = fOld;
+      if(( iRc = MergeInit( rFirst, ulCnt )) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+      ullCnt     = 0;
+      ulStageCnt = 0;
+      while(( iRc = MergeNext( &p )) == XB_NO_ERROR ){
+        memcpy( cpStage + (size_t) ulStageCnt * ulRecLen, p, ulRecLen );
+        if( ++ulStageCnt == ulStageMax ){
+          if(( iRc = fNew->xbFwrite( cpStage, ulRecLen, ulStageCnt )) != XB_NO_ERROR ){
+            iErrorStop = 130;
+            throw iRc;
+          }
+          ulStageCnt = 0;
+        }
+        ullCnt++;
+      }
+      if( iRc != XB_EOF ){
+        iErrorStop = 140;
+        throw iRc;
+      }
+      iRc = XB_NO_ERROR;
+      if( ulStageCnt > 0 && ( iRc = fNew->xbFwrite( cpStage, ulRecLen, ulStageCnt )) != XB_NO_ERROR ){
+        iErrorStop = 150;
+        throw iRc;
+      }
+      MergeTerm();
+      fRuns = fNew;
+      if(( iRc = AddRun( ullCnt )) != XB_NO_ERROR ){
+        iErrorStop = 160;
+        throw iRc;
+      }
+    }
+    free( cpStage );
+    cpStage = NULL;
+
+    // drop the old runs and their file
+    while( rOld ){
+      r = rOld->next;
+      FreeRun( rOld );
+      rOld = r;
+    }
+    fOld->xbFclose();
+    fOld->xbRemove();
+    delete fOld;
+  }
+  catch (xbInt16 iRc ){
+    MergeTerm();
+    // keep the old runs, Close() cleans up
+    if( fOld ){
+      while( rRuns ){
+        r = rRuns->next;
+        FreeRun( rRuns );
+        rRuns = r;
+      }
+      rRuns = rOld;
+      fRuns = fOld;
+    }
+    if( fNew ){
+      fNew->xbFclose();
+      fNew->xbRemove();
+      delete fNew;
+    }
+    if( cpStage )
+      free( cpStage );
+    xbString sMsg;
+    sMsg.Sprintf( "xbSort::MergePass() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief End a merge, release the loser tree.
+/*!
+  @private
+  The read buffers of the merged runs are released.
+  @returns void
+*/
+void xbSort::MergeTerm(){
+  if( rMerge ){
+    for( xbInt32 l = 0; l < lMergeCnt; l++ ){
+      if( rMerge[l] && rMerge[l]->cpBuf ){
+        free( rMerge[l]->cpBuf );
+        rMerge[l]->cpBuf    = NULL;
+        rMerge[l]->ulBufMax = 0;
+        rMerge[l]->ulBufCnt = 0;
+        rMerge[l]->ulBufPos = 0;
+      }
+    }
+    free( rMerge );
+    rMerge = NULL;
+  }
+  if( lpTree ){
+    free( lpTree );
+    lpTree = NULL;
+  }
+  lMergeCnt   = 0;
+  lLastWinner = -1;
+}
+/***********************************************************************/
+//! @brief Create a run file in the temp directory.
+/*!
+  @private
+  @param fOut Output - the new file, open for reading and writing.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::OpenRunFile( xbFile **fOut ){
+
+  xbInt16  iRc = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbString sFqn;
+  xbFile   *f = new xbFile( xbase );
+
+  try{
+    if(( iRc = f->CreateUniqueFileName( xbase->GetTempDirectory(), "SRT", sFqn )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    // the name is only unique until the file exists, open it right away
+    if(( iRc = f->xbFopen( "w+b", sFqn, XB_SINGLE_USER )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    *fOut = f;
+  }
+  catch (xbInt16 iRc ){
+    delete f;
+    *fOut = NULL;
+    xbString sMsg;
+    sMsg.Sprintf( "xbSort::OpenRunFile() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Encode a character value as a key.
+/*!
+  @param cpTrg Output - key bytes.
+  @param cpSrc Character value, ulLen bytes.
+  @param ulLen Length of the value.
+  @param bDescending xbTrue - Key sorts in descending order.
+  @returns void
+*/
+void xbSort::PutKeyChar( char *cpTrg, const char *cpSrc, xbUInt32 ulLen, xbBool bDescending ){
+  if( bDescending ){
+    for( xbUInt32 i = 0; i < ulLen; i++ )
+      cpTrg[i] = (char) ~cpSrc[i];
+  } else {
+    memcpy( cpTrg, cpSrc, ulLen );
+  }
+}
+/***********************************************************************/
+//! @brief Encode a numeric value as a key.
+/*!
+  The double is stored big endian, with the sign bit flipped for positive values
+  and all bits flipped for negative values, so the bytes sort in numeric order.
+  @param cpTrg Output - eight key bytes.
+  @param d Value.
+  @param bDescending xbTrue - Key sorts in descending order.
+  @returns void
+*/
+void xbSort::PutKeyDouble( char *cpTrg, xbDouble d, xbBool bDescending ){
+
+  xbUInt64 ull;
+  if( d == 0 )
+    d = 0;                     // negative zero sorts as zero
+  memcpy( &ull, &d, 8 );
+  if( ull >> 63 )
+    ull = ~ull;
+  else
+    ull |= (xbUInt64) 1 << 63;
+  if( bDescending )
+    ull = ~ull;
+  for( xbInt16 i = 7; i >= 0; i-- ){
+    cpTrg[i] = (char) ( ull & 0xFF );
+    ull >>= 8;
+  }
+}
+/***********************************************************************/
+//! @brief Encode an unsigned value as a key.
+/*!
+  @param cpTrg Output - four key bytes, big endian.
+  @param ul Value.
+  @param bDescending xbTrue - Key sorts in descending order.
+  @returns void
+*/
+void xbSort::PutKeyUInt32( char *cpTrg, xbUInt32 ul, xbBool bDescending ){
+  if( bDescending )
+    ul = ~ul;
+  cpTrg[0] = (char) ( ul >> 24 );
+  cpTrg[1] = (char) ( ul >> 16 );
+  cpTrg[2] = (char) ( ul >> 8 );
+  cpTrg[3] = (char) ul;
+}
+/***********************************************************************/
+//! @brief Sort record pointers on the key.
+/*!
+  @private
+  Most significant byte first radix sort.  Each pass distributes a group of records
+  into 256 buckets on one key byte, in a stable manner, and the buckets are then sorted
+  on the following bytes.  Groups where every record has the same byte skip straight to the
+  next byte, and small groups are finished with an insertion sort.<br>
+  Pending groups are kept on a heap allocated stack, long keys don't use up the call stack.
+
+  @param cpRecsIn Record pointers to sort.
+  @param cpTempIn Work area, room for ulCnt pointers.
+  @param ulCnt Number of records.
+  @param ulOffset Key bytes before this offset are known to be equal.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::RadixSort( char **cpRecsIn, char **cpTempIn, xbUInt32 ulCnt, xbUInt32 ulOffset ){
+
+  struct xbSortGroup {
+    xbUInt32 ulFirst;
+    xbUInt32 ulCnt;
+    xbUInt32 ulOffset;
+  };
+
+  xbUInt32    ulBucket[256];
+  xbUInt32    ulStackSize = 256;
+  xbUInt32    ulStackCnt  = 0;
+  xbSortGroup g;
+  xbSortGroup *gStack = (xbSortGroup *) malloc( ulStackSize * sizeof( xbSortGroup ));
+  if( !gStack )
+    return XB_NO_MEMORY;
+
+  gStack[ulStackCnt].ulFirst  = 0;
+  gStack[ulStackCnt].ulCnt    = ulCnt;
+  gStack[ulStackCnt].ulOffset = ulOffset;
+  ulStackCnt++;
+
+  while( ulStackCnt > 0 ){
+    g = gStack[--ulStackCnt];
+    char **cpGrp = cpRecsIn + g.ulFirst;
+
+    while( g.ulCnt >= XB_SORT_SMALL_CNT && g.ulOffset < ulKeyLen ){
+      memset( ulBucket, 0x00, sizeof( ulBucket ));
+      for( xbUInt32 i = 0; i < g.ulCnt; i++ )
+        ulBucket[(unsigned char) cpGrp[i][g.ulOffset]]++;
+
+      if( ulBucket[(unsigned char) cpGrp[0][g.ulOffset]] == g.ulCnt ){
+        g.ulOffset++;
+        continue;
+      }
+
+      // bucket counts to starting positions, then distribute
+      xbUInt32 ulPos = 0;
+      xbUInt32 ulTemp;
+      for( xbUInt32 b = 0; b < 256; b++ ){
+        ulTemp = ulBucket[b];
+        ulBucket[b] = ulPos;
+        ulPos += ulTemp;
+      }
+      for( xbUInt32 i = 0; i < g.ulCnt; i++ )
+        cpTempIn[ulBucket[(unsigned char) cpGrp[i][g.ulOffset]]++] = cpGrp[i];
+      memcpy( cpGrp, cpTempIn, g.ulCnt * sizeof( char * ));
+
+      // ulBucket now holds the end of each bucket, stack the buckets with more than one record
+      if( ulStackCnt + 256 > ulStackSize ){
+        ulStackSize *= 2;
+        xbSortGroup *gNew = (xbSortGroup *) realloc( gStack, ulStackSize * sizeof( xbSortGroup ));
+        if( !gNew ){
+          free( gStack );
+          return XB_NO_MEMORY;
+        }
+        gStack = gNew;
+      }
+      ulPos = 0;
+      for( xbUInt32 b = 0; b < 256; b++ ){
+        if( ulBucket[b] - ulPos > 1 ){
+          gStack[ulStackCnt].ulFirst  = g.ulFirst + ulPos;
+          gStack[ulStackCnt].ulCnt    = ulBucket[b] - ulPos;
+          gStack[ulStackCnt].ulOffset = g.ulOffset + 1;
+          ulStackCnt++;
+        }
+        ulPos = ulBucket[b];
+      }
+      g.ulCnt = 0;
+    }
+    if( g.ulCnt > 1 && g.ulOffset < ulKeyLen )
+      InsertionSort( cpGrp, g.ulCnt, g.ulOffset );
+  }
+  free( gStack );
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Restart reading the sorted records from the first one.
+/*!
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::Rewind(){
+
+  if( cStatus != 'S' )
+    return XB_INVALID_OPTION;
+  ullPos = 0;
+  if( !cpRecs && !rOut )
+    return MergeInit( rRuns, ulRunCnt );
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+//! @brief Set the memory limit.
+/*!
+  Takes effect at the next call to Init().  The default is set with xbXBase::SetSortMemoryLimit().
+  @param ulMemLimitIn Bytes of memory to hold records in before writing a sorted run to disk.
+  @returns void
+*/
+void xbSort::SetMemoryLimit( xbUInt32 ulMemLimitIn ){
+  ulMemLimit = ulMemLimitIn;
+}
+/***********************************************************************/
+//! @brief Sort the records.
+/*!
+  No more records can be added after the sort.
+  @param bRandomAccessIn xbTrue - Allow reading records by position with GetRec().  If the records
+                         didn't fit in memory, the runs are merged into one temp file.<br>
+                         xbFalse - Records are only read in order with GetNext(), the last merge
+                         is done as the records are read.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::Sort( xbBool bRandomAccessIn ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    if( cStatus != 'A' ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_OPTION;
+      throw iRc;
+    }
+    bRandomAccess = bRandomAccessIn;
+    ullPos = 0;
+
+    if( !rRuns ){
+      // everything fit in memory
+      if(( iRc = SortBuf()) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+      ullRecCnt = ulSortCnt;
+      cStatus = 'S';
+      return XB_NO_ERROR;
+    }
+
+    if( ulBufCnt > 0 && ( iRc = WriteRun()) != XB_NO_ERROR ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+    // the record buffer isn't needed for the merge
+    free( cpRecBuf );
+    cpRecBuf  = NULL;
+    ulBufSize = 0;
+    if( cpTemp ){
+      free( cpTemp );
+      cpTemp = NULL;
+    }
+    if( cpRecs ){
+      free( cpRecs );
+      cpRecs = NULL;
+    }
+
+    while( ulRunCnt > XB_SORT_MERGE_ORDER ){
+      if(( iRc = MergePass()) != XB_NO_ERROR ){
+        iErrorStop = 130;
+        throw iRc;
+      }
+    }
+    if( bRandomAccess && ulRunCnt > 1 && ( iRc = MergePass()) != XB_NO_ERROR ){
+      iErrorStop = 140;
+      throw iRc;
+    }
+
+    if( bRandomAccess ){
+      // one run left, read it by position
+      rOut     = rRuns;
+      rRuns    = NULL;
+      rLastRun = NULL;
+      ulRunCnt = 0;
+      ullRecCnt = rOut->ullRecCnt;
+      xbUInt32 ulRecs = ulMemLimit / ulRecLen;
+      if( ulRecs == 0 )
+        ulRecs = 1;
+      if( ulRecs > rOut->ullRecCnt )
+        ulRecs = (xbUInt32) rOut->ullRecCnt;
+      if( rOut->cpBuf )
+        free( rOut->cpBuf );
+      if(( rOut->cpBuf = (char *) malloc( (size_t) ulRecs * ulRecLen )) == NULL ){
+        iErrorStop = 150;
+        iRc = XB_NO_MEMORY;
+        throw iRc;
+      }
+      rOut->ulBufMax    = ulRecs;
+      rOut->ulBufCnt    = 0;
+      rOut->ulBufPos    = 0;
+      rOut->ullRecsRead = 0;
+    } else {
+      if(( iRc = MergeInit( rRuns, ulRunCnt )) != XB_NO_ERROR ){
+        iErrorStop = 160;
+        throw iRc;
+      }
+    }
+    cStatus = 'S';
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbSort::Sort() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Sort the records in the record buffer.
+/*!
+  @private
+  Sets cpRecs to the records in key order.  For a unique sort, records with the
+  same key as the record before them are dropped.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::SortBuf(){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    if( cpRecs )
+      free( cpRecs );
+    if( cpTemp )
+      free( cpTemp );
+    cpRecs = (char **) malloc(( ulBufCnt ? ulBufCnt : 1 ) * sizeof( char * ));
+    cpTemp = (char **) malloc(( ulBufCnt ? ulBufCnt : 1 ) * sizeof( char * ));
+    if( !cpRecs || !cpTemp ){
+      iErrorStop = 100;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    for( xbUInt32 i = 0; i < ulBufCnt; i++ )
+      cpRecs[i] = cpRecBuf + (size_t) i * ulRecLen;
+
+    if(( iRc = RadixSort( cpRecs, cpTemp, ulBufCnt, 0 )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    ulSortCnt = ulBufCnt;
+    if( bUnique && ulBufCnt > 1 ){
+      ulSortCnt = 1;
+      for( xbUInt32 i = 1; i < ulBufCnt; i++ )
+        if( memcmp( cpRecs[i], cpRecs[ulSortCnt-1], ulKeyLen ) != 0 )
+          cpRecs[ulSortCnt++] = cpRecs[i];
+    }
+    free( cpTemp );
+    cpTemp = NULL;
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbSort::SortBuf() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+//! @brief Sort the record buffer and write it to the run file as a new run.
+/*!
+  @private
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+xbInt16 xbSort::WriteRun(){
+
+  xbInt16   iRc = XB_NO_ERROR;
+  xbInt16   iErrorStop = 0;
+  char      *cpStage = NULL;
+  xbUInt32  ulStageMax;
+  xbUInt32  ulStageCnt = 0;
+
+  try{
+    if(( iRc = SortBuf()) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    if( !fRuns && ( iRc = OpenRunFile( &fRuns )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+
+    // gather the records in key order, and write them out in large pieces
+    ulStageMax = xbSortWriteSize / ulRecLen;
+    if( ulStageMax == 0 )
+      ulStageMax = 1;
+    if(( cpStage = (char *) malloc( (size_t) ulStageMax * ulRecLen )) == NULL ){
+      iErrorStop = 120;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+    for( xbUInt32 i = 0; i < ulSortCnt; i++ ){
+      memcpy( cpStage + (size_t) ulStageCnt * ulRecLen, cpRecs[i], ulRecLen );
+      if( ++ulStageCnt == ulStageMax || i == ulSortCnt - 1 ){
+        if(( iRc = fRuns->xbFwrite( cpStage, ulRecLen, ulStageCnt )) != XB_NO_ERROR ){
+          iErrorStop = 130;
+          throw iRc;
+        }
+        ulStageCnt = 0;
+      }
+    }
+    free( cpStage );
+    cpStage = NULL;
+
+    if(( iRc = AddRun( ulSortCnt )) != XB_NO_ERROR ){
+      iErrorStop = 140;
+      throw iRc;
+    }
+    ulBufCnt  = 0;
+    ulSortCnt = 0;
+  }
+  catch (xbInt16 iRc ){
+    if( cpStage )
+      free( cpStage );
+    xbString sMsg;
+    sMsg.Sprintf( "xbSort::WriteRun() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+}        /* namespace xb    */
+#endif   /* XB_SORT_SUPPORT */
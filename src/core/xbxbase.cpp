@@ -30,6 +30,19 @@ xbXBase::xbXBase() {
   xLog = new xbLog();
   #endif
 
+  #ifdef XB_FUNCTION_SUPPORT
+  pUserFuncs   = NULL;
+  iUserFuncCnt = 0;
+  #endif
+
+  #ifdef XB_EXPRESSION_SUPPORT
+  pExpCache       = NULL;
+  iExpCacheCnt    = 0;
+  iExpCacheSize   = XB_EXP_CACHE_SIZE;
+  ulExpCacheClock = 0;
+  ulExpCacheHits  = 0;
+  #endif
+
   #ifdef XB_LOCKING_SUPPORT
     SetMultiUser( xbOn );
   #else
@@ -39,9 +52,18 @@ xbXBase::xbXBase() {
 /*************************************************************************/
 xbXBase::~xbXBase(){
   CloseAllTables();
+  #ifdef XB_EXPRESSION_SUPPORT
+  SetExpressionCacheSize( 0 );
+  #endif
   #ifdef XB_LOGGING_SUPPORT
   delete xLog;
   #endif
+  #ifdef XB_FUNCTION_SUPPORT
+  for( xbInt16 i = 0; i < iUserFuncCnt; i++ )
+    delete pUserFuncs[i];
+  if( pUserFuncs )
+    free( pUserFuncs );
+  #endif
 }
 /*************************************************************************/
 xbInt16 xbXBase::CloseAllTables(){
@@ -52,7 +74,8 @@ xbInt16 xbXBase::CloseAllTables(){
   try{
     xbDbf *d;
     for( xbInt16 i = 0; i < iOpenTableCnt; i++ ){
-      d = (xbDbf *) GetDbfPtr( i+1 );
+      // Close removes the table from the list, the next table is always first
+      d = (xbDbf *) GetDbfPtr( 1 );
       if( d ){
         if(( iRc = d->Close()) != XB_NO_ERROR ){
           iErrorStop = 100;
@@ -229,6 +252,13 @@ void xbXBase::SetLogSize( size_t lSize ) {
 #ifdef XB_FUNCTION_SUPPORT
 xbInt16 xbXBase::GetFunctionInfo( const xbString &sExpLine, char &cReturnType, xbInt16 &iCalc, xbInt32 &lReturnLenVal ) const{
 
+  xbInt16 iFuncNo;
+  return GetFunctionInfo( sExpLine, cReturnType, iCalc, lReturnLenVal, iFuncNo );
+}
+/*************************************************************************/
+xbInt16 xbXBase::GetFunctionInfo( const xbString &sExpLine, char &cReturnType, xbInt16 &iCalc,
+                                  xbInt32 &lReturnLenVal, xbInt16 &iFuncNo ) const{
+
   xbUInt32 iLen;
   const   char *s;
   if( sExpLine.Len() == 0 )
@@ -239,6 +269,7 @@ xbInt16 xbXBase::GetFunctionInfo( const xbString &sExpLine, char &cReturnType, x
   while( *s && *s != '(' && *s != ' ' ) { s++; iLen++; }
   xbString sFunction( sExpLine, iLen );
   cReturnType = 0x00;
+  iFuncNo     = 0;
   char cFunc1 = sFunction[1];
 
   if( cFunc1 < 'L' ){
@@ -247,41 +278,49 @@ xbInt16 xbXBase::GetFunctionInfo( const xbString &sExpLine, char &cReturnType, x
        // std::cout << "less than D\n";
       if( sFunction == "ABS" ){
          // { "ABS",       'N',      1,   4 },
+         iFuncNo       = XB_EXP_FNC_ABS;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "ALLTRIM" ){
         // { "ALLTRIM",   'C',      2,   1 },
+        iFuncNo       = XB_EXP_FNC_ALLTRIM;
         cReturnType   = 'C';
         iCalc         = 2;
         lReturnLenVal = 1;
       } else if( sFunction == "ASC" ){
         // { "ASC",       'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_ASC;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "AT" ){
         // { "AT",        'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_AT;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "CDOW" ){
         // { "CDOW",      'C',      1,   9 },
+        iFuncNo       = XB_EXP_FNC_CDOW;
         cReturnType   = 'C';
         iCalc         = 1;
         lReturnLenVal = 9;
       } else if( sFunction == "CHR" ){
         // { "CHR",       'C',      1,   1 },
+        iFuncNo       = XB_EXP_FNC_CHR;
         cReturnType   = 'C';
         iCalc         = 1;
         lReturnLenVal = 1;
       } else if( sFunction == "CMONTH" ){
         // { "CMONTH",    'C',      1,   9 },
+        iFuncNo       = XB_EXP_FNC_CMONTH;
         cReturnType   = 'C';
         iCalc         = 1;
         lReturnLenVal = 9;
       } else if( sFunction == "CTOD" ){
         // { "CTOD",      'D',      1,   8 },
+        iFuncNo       = XB_EXP_FNC_CTOD;
         cReturnType   = 'D';
         iCalc         = 1;
         lReturnLenVal = 8;
@@ -290,71 +329,85 @@ xbInt16 xbXBase::GetFunctionInfo( const xbString &sExpLine, char &cReturnType, x
       // std::cout << ">= D\n";
       if( sFunction == "DATE" ){
         // { "DATE",      'D',      1,   8 },
+        iFuncNo       = XB_EXP_FNC_DATE;
         cReturnType   = 'D';
         iCalc         = 1;
         lReturnLenVal = 8;
       } else if( sFunction == "DAY" ){
         // { "DAY",       'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_DAY;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "DEL" ){
         // { "DEL",       'C',      1,   1 },
+        iFuncNo       = XB_EXP_FNC_DEL;
         cReturnType   = 'C';
         iCalc         = 1;
         lReturnLenVal = 1;
       } else if( sFunction == "DELETED" ){
         //  { "DELETED",   'L',      1,   1 },
+        iFuncNo       = XB_EXP_FNC_DELETED;
         cReturnType   = 'L';
         iCalc         = 1;
         lReturnLenVal = 1;
       } else if( sFunction == "DESCEND" ){
         // { "DESCEND",   '1',      2,   1 },
+        iFuncNo       = XB_EXP_FNC_DESCEND;
         cReturnType   = '1';
         iCalc         = 2;
         lReturnLenVal = 1;
       } else if( sFunction == "DOW" ){
         // { "DOW",       'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_DOW;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "DTOC" ){
         //   { "DTOC",      'C',      1,   8 },
+        iFuncNo       = XB_EXP_FNC_DTOC;
         cReturnType   = 'C';
         iCalc         = 1;
         lReturnLenVal = 8;
       } else if( sFunction == "DTOS" ){
         // { "DTOS",      'C',      1,   8 },
+        iFuncNo       = XB_EXP_FNC_DTOS;
         cReturnType   = 'C';
         iCalc         = 1;
         lReturnLenVal = 8;
       } else if( sFunction == "EXP" ){
         // { "EXP",       'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_EXP;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "IIF" ){
         // { "IIF",       'C',      5,   0 },
+        iFuncNo       = XB_EXP_FNC_IIF;
         cReturnType   = 'C';
         iCalc         = 5;
         lReturnLenVal = 0;
       } else if( sFunction == "INT" ){
         // { "INT",       'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_INT;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "ISALPHA" ){
         // { "ISALPHA",   'L',      1,   1 },
+        iFuncNo       = XB_EXP_FNC_ISALPHA;
         cReturnType   = 'L';
         iCalc         = 1;
         lReturnLenVal = 1;
       } else if( sFunction == "ISLOWER" ){
         // { "ISLOWER",   'L',      1,   1 },
+        iFuncNo       = XB_EXP_FNC_ISLOWER;
         cReturnType   = 'L';
         iCalc         = 1;
         lReturnLenVal = 1;
       } else if( sFunction == "ISUPPER" ){
         // { "ISUPPER",   'L',      1,   1 },
+        iFuncNo       = XB_EXP_FNC_ISUPPER;
         cReturnType   = 'L';
         iCalc         = 1;
         lReturnLenVal = 1;
@@ -366,41 +419,49 @@ xbInt16 xbXBase::GetFunctionInfo( const xbString &sExpLine, char &cReturnType, x
       // std::cout << " < R\n";
       if( sFunction == "LEFT" ){
       // { "LEFT",      'C',      3,   2 },
+      iFuncNo       = XB_EXP_FNC_LEFT;
         cReturnType   = 'C';
         iCalc         = 3;
         lReturnLenVal = 2;
       } else if( sFunction == "LEN" ){
         // { "LEN",       'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_LEN;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 3;
       } else if( sFunction == "LOG" ){
         // { "LOG",       'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_LOG;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "LOWER" ){
         //  { "LOWER",     'C',      2,   1 },
+        iFuncNo       = XB_EXP_FNC_LOWER;
         cReturnType   = 'C';
         iCalc         = 2;
         lReturnLenVal = 1;
       } else if( sFunction == "LTRIM" ){
         //   { "LTRIM",     'C',      2,   1 },
+        iFuncNo       = XB_EXP_FNC_LTRIM;
         cReturnType   = 'C';
         iCalc         = 2;
         lReturnLenVal = 1;
       } else if( sFunction == "MAX" ){
         // { "MAX",       'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_MAX;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "MIN" ){
         //   { "MIN",       'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_MIN;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "MONTH" ){
         // { "MONTH",     'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_MONTH;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
@@ -409,26 +470,31 @@ xbInt16 xbXBase::GetFunctionInfo( const xbString &sExpLine, char &cReturnType, x
       // std::cout << "==R\n";
       if( sFunction == "RECNO" ){
         //   { "RECNO",     'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_RECNO;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "RECCOUNT" ){
         //  { "RECCOUNT",  'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_RECCOUNT;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "REPLICATE" ){
         // { "REPLICATE", 'C',      4,   0 },
+        iFuncNo       = XB_EXP_FNC_REPLICATE;
         cReturnType   = 'C';
         iCalc         = 4;
         lReturnLenVal = 0;
       } else if( sFunction == "RIGHT" ){
         // { "RIGHT",     'C',      3,   2 },
+        iFuncNo       = XB_EXP_FNC_RIGHT;
         cReturnType   = 'C';
         iCalc         = 3;
         lReturnLenVal = 2;
       } else if( sFunction == "RTRIM" ){
         //  { "RTRIM",     'C',      2,   1 },
+        iFuncNo       = XB_EXP_FNC_RTRIM;
         cReturnType   = 'C';
         iCalc         = 2;
         lReturnLenVal = 1;
@@ -437,31 +503,37 @@ xbInt16 xbXBase::GetFunctionInfo( const xbString &sExpLine, char &cReturnType, x
       // std::cout << "==S\n";
       if( sFunction == "SPACE" ){
         // { "SPACE",     'C',      3,   1 },
+        iFuncNo       = XB_EXP_FNC_SPACE;
         cReturnType   = 'C';
         iCalc         = 3;
         lReturnLenVal = 1;
       } else if( sFunction == "SQRT" ){
         //  { "SQRT",      'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_SQRT;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       } else if( sFunction == "STOD" ){
         // { "STOD",      'D',      1,   8 },
+        iFuncNo       = XB_EXP_FNC_STOD;
         cReturnType   = 'D';
         iCalc         = 1;
         lReturnLenVal = 8;
       } else if( sFunction == "STR" ){
         //  { "STR",       'C',      6,  10 },
+        iFuncNo       = XB_EXP_FNC_STR;
         cReturnType   = 'C';
         iCalc         = 6;
         lReturnLenVal = 10;
       } else if( sFunction == "STRZERO" ){
         // { "STRZERO",   'C',      3,   2 },
+        iFuncNo       = XB_EXP_FNC_STRZERO;
         cReturnType   = 'C';
         iCalc         = 3;
         lReturnLenVal = 2;
       } else if( sFunction == "SUBSTR" ){
         //  { "SUBSTR",    'C',      3,   3 },
+        iFuncNo       = XB_EXP_FNC_SUBSTR;
         cReturnType   = 'C';
         iCalc         = 3;
         lReturnLenVal = 3;
@@ -470,34 +542,220 @@ xbInt16 xbXBase::GetFunctionInfo( const xbString &sExpLine, char &cReturnType, x
       //  std::cout << ">S\n";
       if( sFunction == "TRIM" ){
         //  { "TRIM",      'C',      2,   1 },
+        iFuncNo       = XB_EXP_FNC_TRIM;
         cReturnType   = 'C';
         iCalc         = 2;
         lReturnLenVal = 1;
       } else if( sFunction == "UPPER" ){
         // { "UPPER",     'C',      2,   1 },
+        iFuncNo       = XB_EXP_FNC_UPPER;
         cReturnType   = 'C';
         iCalc         = 2;
         lReturnLenVal = 1;
       } else if( sFunction == "VAL" ){
         // { "VAL",       'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_VAL;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 3;
       } else if( sFunction == "YEAR" ){
         //  { "YEAR",      'N',      1,   4 },
+        iFuncNo       = XB_EXP_FNC_YEAR;
         cReturnType   = 'N';
         iCalc         = 1;
         lReturnLenVal = 4;
       }
     }
   }
+
+  // application registered functions
+  if( cReturnType == 0x00 ){
+    for( xbInt16 i = 0; i < iUserFuncCnt; i++ ){
+      if( pUserFuncs[i]->sFuncName == sFunction ){
+        cReturnType   = pUserFuncs[i]->cReturnType;
+        iCalc         = pUserFuncs[i]->iReturnLenCalc;
+        lReturnLenVal = pUserFuncs[i]->lReturnLenVal;
+        iFuncNo       = XB_EXP_FNC_USER + i;
+        break;
+      }
+    }
+  }
+
   if( cReturnType == 0x00 )
     return XB_INVALID_FUNCTION;
   else
     return XB_NO_ERROR;
 }
+/*************************************************************************/
+xbExpFunction xbXBase::GetUserFunction( xbInt16 iFuncNo ) const{
+
+  iFuncNo -= XB_EXP_FNC_USER;
+  if( iFuncNo < 0 || iFuncNo >= iUserFuncCnt )
+    return NULL;
+  return pUserFuncs[iFuncNo]->pFunc;
+}
+/*************************************************************************/
+xbInt16 xbXBase::RegisterFunction( const xbString &sFuncName, char cReturnType, xbInt16 iReturnLenCalc,
+                                   xbInt32 lReturnLenVal, xbExpFunction pFunc ){
+
+  xbInt16 iRc = XB_NO_ERROR;
+  xbInt16 iErrorStop = 0;
+
+  try{
+    xbString sName( sFuncName );
+    sName.Trim().ToUpperCase();
+    if( sName.Len() == 0 || !pFunc || !isalpha( (unsigned char) sName[1] ) ||
+        ( cReturnType != 'C' && cReturnType != 'D' && cReturnType != 'L' && cReturnType != 'N' ) ||
+        iReturnLenCalc < 1 || iReturnLenCalc > 6 ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_PARAMETER;
+      throw iRc;
+    }
+
+    // built in function names can't be replaced
+    char    cType;
+    xbInt16 iCalc;
+    xbInt32 lLenVal;
+    xbInt16 iFuncNo;
+    if( GetFunctionInfo( sName, cType, iCalc, lLenVal, iFuncNo ) == XB_NO_ERROR && iFuncNo < XB_EXP_FNC_USER ){
+      iErrorStop = 110;
+      iRc = XB_ALREADY_DEFINED;
+      throw iRc;
+    }
+
+    xbUserFunction *uf = NULL;
+    for( xbInt16 i = 0; i < iUserFuncCnt && !uf; i++ )
+      if( pUserFuncs[i]->sFuncName == sName )
+        uf = pUserFuncs[i];
+
+    if( !uf ){
+      xbUserFunction **pNew = (xbUserFunction **) realloc( pUserFuncs, sizeof( xbUserFunction * ) * (size_t) (iUserFuncCnt + 1));
+      if( !pNew ){
+        iErrorStop = 120;
+        iRc = XB_NO_MEMORY;
+        throw iRc;
+      }
+      pUserFuncs = pNew;
+      uf = new xbUserFunction;
+      uf->sFuncName = sName;
+      pUserFuncs[iUserFuncCnt++] = uf;
+    }
+    uf->cReturnType    = cReturnType;
+    uf->iReturnLenCalc = iReturnLenCalc;
+    uf->lReturnLenVal  = lReturnLenVal;
+    uf->pFunc          = pFunc;
+
+    // cached expressions may have been parsed with the earlier registration
+    #ifdef XB_EXPRESSION_SUPPORT
+    ClearExpressionCache();
+    #endif
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbXBase::RegisterFunction() Exception Caught. Error Stop = [%d] iRc = [%d]", iErrorStop, iRc );
+    WriteLogMessage( sMsg.Str() );
+  }
+  return iRc;
+}
 #endif
 /*************************************************************************/
+#ifdef XB_EXPRESSION_SUPPORT
+void xbXBase::AddCachedExpression( xbDbf *dbf, const xbString &sExpression, xbExp *exp ){
+
+  if( iExpCacheSize <= 0 ){
+    delete exp;
+    return;
+  }
+  if( !pExpCache )
+    pExpCache = new xbExpCacheEntry[(size_t) iExpCacheSize];
+
+  // use a free slot, or replace the least recently used entry
+  xbExpCacheEntry *e;
+  if( iExpCacheCnt < iExpCacheSize ){
+    e = &pExpCache[iExpCacheCnt++];
+  } else {
+    e = &pExpCache[0];
+    for( xbInt16 i = 1; i < iExpCacheCnt; i++ )
+      if( pExpCache[i].ulLastUsed < e->ulLastUsed )
+        e = &pExpCache[i];
+    delete e->exp;
+  }
+  e->sExpression = sExpression;
+  e->dbf         = dbf;
+  e->exp         = exp;
+  e->ulLastUsed  = ++ulExpCacheClock;
+}
+/*************************************************************************/
+void xbXBase::ClearExpressionCache(){
+
+  for( xbInt16 i = 0; i < iExpCacheCnt; i++ )
+    delete pExpCache[i].exp;
+  iExpCacheCnt = 0;
+}
+/*************************************************************************/
+void xbXBase::ClearExpressionCache( xbDbf *dbf ){
+
+  xbInt16    i = 0;
+  xbBool     bDrop;
+  xbExpNode *n;
+  while( i < iExpCacheCnt ){
+    // the expression may refer to the table by alias as well as being parsed against it
+    bDrop = ( pExpCache[i].dbf == dbf );
+    if( !bDrop && pExpCache[i].exp->GetTreeHandle()){
+      n = pExpCache[i].exp->GetTreeHandle()->GetFirstNode();
+      while( n && !bDrop ){
+        if( n->GetDbf() == dbf )
+          bDrop = xbTrue;
+        n = n->GetNextNode();
+      }
+    }
+    if( bDrop ){
+      // move the last entry into this slot
+      delete pExpCache[i].exp;
+      iExpCacheCnt--;
+      if( i < iExpCacheCnt ){
+        pExpCache[i].sExpression = pExpCache[iExpCacheCnt].sExpression;
+        pExpCache[i].dbf         = pExpCache[iExpCacheCnt].dbf;
+        pExpCache[i].exp         = pExpCache[iExpCacheCnt].exp;
+        pExpCache[i].ulLastUsed  = pExpCache[iExpCacheCnt].ulLastUsed;
+      }
+    } else {
+      i++;
+    }
+  }
+}
+/*************************************************************************/
+xbExp *xbXBase::GetCachedExpression( xbDbf *dbf, const xbString &sExpression ){
+
+  for( xbInt16 i = 0; i < iExpCacheCnt; i++ ){
+    if( pExpCache[i].dbf == dbf && pExpCache[i].sExpression == sExpression ){
+      pExpCache[i].ulLastUsed = ++ulExpCacheClock;
+      ulExpCacheHits++;
+      return pExpCache[i].exp;
+    }
+  }
+  return NULL;
+}
+/*************************************************************************/
+xbUInt32 xbXBase::GetExpressionCacheHits() const {
+  return ulExpCacheHits;
+}
+/*************************************************************************/
+xbInt16 xbXBase::GetExpressionCacheSize() const {
+  return iExpCacheSize;
+}
+/*************************************************************************/
+void xbXBase::SetExpressionCacheSize( xbInt16 iCacheSize ){
+
+  ClearExpressionCache();
+  if( pExpCache ){
+    delete[] pExpCache;
+    pExpCache = NULL;
+  }
+  iExpCacheSize = ( iCacheSize > 0 ) ? iCacheSize : 0;
+}
+#endif   // XB_EXPRESSION_SUPPORT
+/*************************************************************************/
 void xbXBase::xbSleep( xbInt32 lMillisecs ){
   #ifdef WIN32
   Sleep( (xbUInt32) lMillisecs );
@@ -842,6 +1100,9 @@ char xbXBase::GetPathSeparator() const {
 /*************************************************************************/
 void xbXBase::SetDefaultDateFormat( const xbString &sDefaultDateFormat ) {
   this->sDefaultDateFormat = sDefaultDateFormat;
+  #ifdef XB_EXPRESSION_SUPPORT
+  ClearExpressionCache();      // CTOD() and DTOC() constants are folded with the date format
+  #endif
 }
 /*************************************************************************/
 xbString &xbXBase::GetTempDirectory() const {
@@ -883,6 +1144,26 @@ xbInt16 xbXBase::SetDefaultIxTagMode( xbInt16 iMode ){
 
 #endif  // defined (XB_NDX_SUPPORT) || defined (XB_MDX_SUPPORT)
 /*************************************************************************/
+#ifdef XB_TDX_SUPPORT
+xbUInt32 xbXBase::GetTdxMemoryLimit() const {
+  return ulTdxMemLimit;
+}
+/*************************************************************************/
+void xbXBase::SetTdxMemoryLimit( xbUInt32 ulMemLimit ){
+  ulTdxMemLimit = ulMemLimit;
+}
+#endif  // XB_TDX_SUPPORT
+/*************************************************************************/
+#ifdef XB_SORT_SUPPORT
+xbUInt32 xbXBase::GetSortMemoryLimit() const {
+  return ulSortMemLimit;
+}
+/*************************************************************************/
+void xbXBase::SetSortMemoryLimit( xbUInt32 ulMemLimit ){
+  ulSortMemLimit = ulMemLimit;
+}
+#endif  // XB_SORT_SUPPORT
+/*************************************************************************/
 void xbXBase::SetEndianType() {
   xbInt16 e = 1;
   iEndianType = *(char *) &e;
@@ -0,0 +1,125 @@
+/* xb_ex_sort.cpp
+
+XBase64 Software Library
+
+Copyright (c) 1997,2003,2014,2020,2022,2023,2024 Gary A Kunkel
+
+The xb64 software library is covered under the terms of the GPL Version 3, 2007 license.
+
+Email Contact:
+
+    XDB-devel@lists.sourceforge.net
+    XDB-users@lists.sourceforge.net
+
+*/
+
+// This program demonstrates usage of the xbSort class, and times the sort of a large
+// number of records on a composite character key.
+//
+// Usage: xb_ex_sort [record count] [memory limit in MB]
+//   record count defaults to 10,000,000, memory limit defaults to the library default of 16MB
+//
+// Each record has a key of three character columns, state (2), city (18) and name (20),
+// and carries a four byte record number as data.  The sorted output is checked for order.
+
+
+#include "xbase.h"
+#include <time.h>
+
+using namespace xb;
+
+static const char *cpStates[] = { "AK", "AZ", "CA", "CO", "FL", "GA", "IA", "IL", "MN", "NY", "OH", "TX", "WA", "WI" };
+static const char *cpSyl[]    = { "AN", "BER", "CO", "DEL", "EL", "FOR", "GRA", "HAR", "IN", "KEN", "LIN", "MAR", "NOR", "OAK", "PAR", "RID", "SAN", "TON", "VIL", "WES" };
+
+// simple generator, so each run sorts the same data
+static xbUInt32 NextRand( xbUInt32 &ulSeed ){
+  ulSeed = ulSeed * 1103515245 + 12345;
+  return ulSeed >> 8;
+}
+
+// fill a blank padded column with random syllables
+static void PutWord( char *p, xbUInt32 ulLen, xbUInt32 &ulSeed ){
+  memset( p, ' ', ulLen );
+  xbUInt32 ulSyls = 2 + NextRand( ulSeed ) % 3;
+  xbUInt32 ulPos  = 0;
+  for( xbUInt32 i = 0; i < ulSyls; i++ ){
+    const char *s = cpSyl[NextRand( ulSeed ) % 20];
+    for( ; *s && ulPos < ulLen; s++ )
+      p[ulPos++] = *s;
+  }
+}
+
+
+int main( int argCnt, char **av )
+{
+  xbInt16  iRc = 0;
+  xbUInt32 ulRecCnt = 10000000;
+  xbUInt32 ulSeed   = 1;
+  char     cKey[40];
+  char     cData[4];
+  char     cLastKey[40];
+  const char *p;
+
+  if( argCnt > 1 )
+    ulRecCnt = (xbUInt32) atol( av[1] );
+
+  xbXBase x;
+  x.EnableMsgLogging();
+  x.SetLogSize( 1000000L );
+
+  xbSort s( &x );
+  if( argCnt > 2 )
+    s.SetMemoryLimit( (xbUInt32) atol( av[2] ) * 1048576 );
+
+  // key is state, city and name, data is the record number
+  if(( iRc = s.Init( 40, 4 )) != XB_NO_ERROR ){
+    x.DisplayError( iRc );
+    return 1;
+  }
+
+  std::cout << "Sorting " << ulRecCnt << " records on a 40 byte key, memory limit " << s.GetMemoryLimit() << " bytes\n";
+  clock_t tStart = clock();
+  for( xbUInt32 ul = 1; ul <= ulRecCnt; ul++ ){
+    memcpy( cKey, cpStates[NextRand( ulSeed ) % 14], 2 );
+    PutWord( cKey + 2,  18, ulSeed );
+    PutWord( cKey + 20, 20, ulSeed );
+    xbSort::PutKeyUInt32( cData, ul );
+    if(( iRc = s.Add( cKey, cData )) != XB_NO_ERROR ){
+      x.DisplayError( iRc );
+      return 1;
+    }
+  }
+  double dAddTime = (double) ( clock() - tStart ) / CLOCKS_PER_SEC;
+
+  tStart = clock();
+  if(( iRc = s.Sort()) != XB_NO_ERROR ){
+    x.DisplayError( iRc );
+    return 1;
+  }
+  double dSortTime = (double) ( clock() - tStart ) / CLOCKS_PER_SEC;
+
+  // read the records back, and make sure they are in order
+  tStart = clock();
+  xbUInt32 ulOutCnt = 0;
+  xbUInt32 ulErrCnt = 0;
+  while(( iRc = s.GetNext( &p )) == XB_NO_ERROR ){
+    if( ulOutCnt > 0 && memcmp( cLastKey, p, 40 ) > 0 )
+      ulErrCnt++;
+    memcpy( cLastKey, p, 40 );
+    ulOutCnt++;
+  }
+  double dReadTime = (double) ( clock() - tStart ) / CLOCKS_PER_SEC;
+
+  std::cout << "Add and run generation  " << dAddTime  << " seconds\n";
+  std::cout << "Sort                    " << dSortTime << " seconds\n";
+  std::cout << "Merge and read          " << dReadTime << " seconds\n";
+  std::cout << "Sorted runs written     " << s.GetRunCnt() << "\n";
+  std::cout << "Records read            " << ulOutCnt << "\n";
+
+  s.Close();
+  if( iRc != XB_EOF || ulOutCnt != ulRecCnt || ulErrCnt > 0 ){
+    std::cout << "Sort failed, " << ulErrCnt << " records out of order\n";
+    return 1;
+  }
+  return 0;
+}
@@ -90,6 +90,9 @@ Email Contact:
 #include <xblog.h>
 #include <xbmemo.h>
 #include <xbbcd.h>
+#include <xbbloom.h>
+#include <xbbitmap.h>
+#include <xbsort.h>
 #include <xbuda.h>
 #include <xbexpnode.h>
 #include <xbexp.h>
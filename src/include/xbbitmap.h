@@ -0,0 +1,74 @@
+/*  xbbitmap.h
+
+XBase64 Software Library
+
+Copyright (c) 1997,2003,2014,2022,2023,2024 Gary A Kunkel
+
+The xb64 software library is covered under the terms of the GPL Version 3, 2007 license.
+
+Email Contact:
+
+    XDB-devel@lists.sourceforge.net
+    XDB-users@lists.sourceforge.net
+
+*/
+
+#ifndef __XB_BITMAP_H__
+#define __XB_BITMAP_H__
+#ifdef XB_FILTER_SUPPORT
+
+namespace xb{
+
+//! @brief Class for handling an in memory compressed set of record numbers.
+/*!
+  The set is split into chunks of 65536 values, keyed on the high sixteen bits of the value.
+  Chunks that have no values are not allocated.<br>
+
+  A sparse chunk holds a sorted array of the low sixteen bits of its values.  When a chunk
+  grows past 4096 values, the array would be larger than a plain bit set for the chunk, so it
+  is converted to an 8K bit set.  If values are removed and the count drops back to 4096, the
+  chunk is converted back to an array.<br>
+
+  This keeps a set of scattered record numbers small, and a set that covers most of a large
+  table at one bit per record.
+*/
+
+class XBDLLEXPORT xbBitmap {
+ public:
+   xbBitmap();
+   ~xbBitmap();
+
+   void     Clear();
+   xbBool   Contains( xbUInt32 ulVal ) const;
+   xbUInt32 GetCount() const;
+   xbUInt32 GetMemSize() const;
+   xbInt16  GetNext( xbUInt32 ulFrom, xbUInt32 &ulVal ) const;
+   xbInt16  GetPrev( xbUInt32 ulFrom, xbUInt32 &ulVal ) const;
+   xbInt16  Remove( xbUInt32 ulVal );
+   xbInt16  Set( xbUInt32 ulVal );
+
+ private:
+   struct xbBitmapChunk {
+     xbUInt16 uiKey;          // high sixteen bits of the values in the chunk
+     xbUInt32 ulCnt;          // number of values in the chunk
+     xbUInt32 ulSize;         // allocated entries in uipArray
+     xbUInt16 *uipArray;      // sorted low sixteen bits, NULL if the chunk is a bit set
+     xbUInt32 *ulpBits;       // 65536 bit set, NULL if the chunk is an array
+   };
+
+   xbUInt32 FindChunk( xbUInt16 uiKey, xbBool &bFound ) const;
+   void     FreeChunk( xbBitmapChunk &c );
+   xbInt32  GetNextInChunk( const xbBitmapChunk &c, xbUInt32 ulLo ) const;
+   xbInt32  GetPrevInChunk( const xbBitmapChunk &c, xbUInt32 ulHi ) const;
+   xbInt16  ToArray( xbBitmapChunk &c );
+   xbInt16  ToBits( xbBitmapChunk &c );
+
+   xbBitmapChunk *cpChunks;   // chunks in key order
+   xbUInt32 ulChunkCnt;       // number of chunks in use
+   xbUInt32 ulChunkSize;      // allocated entries in cpChunks
+   xbUInt32 ulCount;          // number of values in the set
+};
+
+}        /* namespace xb    */
+#endif   /* XB_FILTER_SUPPORT */
+#endif   /* __XB_BITMAP_H__ */
@@ -52,6 +52,12 @@ class XBDLLEXPORT xbBlockRead {
     void     DumpReadBlockInternals();
     #endif
 
+    /** @brief Retrieve the current block buffer.
+      The first record in the buffer is GetBlockFirstRecNo(), records are GetRecordLen() bytes apart.
+      @returns Pointer to the block buffer.
+    */
+    const char *GetBlockBuf() const;
+
     /** @brief Retrieve the first record number in the current block.
       @returns First record number in the current block.
     */
@@ -80,6 +86,15 @@ class XBDLLEXPORT xbBlockRead {
     */
     xbInt16  GetRecord( xbUInt32 ulRecNo );
 
+    /** @brief Load the block containing a record.
+
+      If the record is already in the current block, nothing is read.
+
+      @param ulRecNo - Record number.
+      @return XB_NO_ERROR, XB_SEEK_ERROR or XB_READ_ERROR
+    */
+    xbInt16  LoadBlockForRecNo( xbUInt32 ulRecNo );
+
     /** @brief Init the block processing for a given DBF file.
       This routine may adjust the block size as needed to eliminate unused
       memory or adjust it bigger if too small.
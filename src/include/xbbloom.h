@@ -0,0 +1,72 @@
+/*  xbbloom.h
+
+XBase64 Software Library
+
+Copyright (c) 1997,2003,2014,2022,2023,2024 Gary A Kunkel
+
+The xb64 software library is covered under the terms of the GPL Version 3, 2007 license.
+
+Email Contact:
+
+    XDB-devel@lists.sourceforge.net
+    XDB-users@lists.sourceforge.net
+
+*/
+
+#ifndef __XB_BLOOM_H__
+#define __XB_BLOOM_H__
+#ifdef XB_INDEX_SUPPORT
+
+namespace xb{
+
+//! @brief Class for handling an in memory bloom filter over index keys.
+/*!
+  A bloom filter answers the question "could this key be in the index?".<br>
+  A false answer is definite, the key is not in the index.<br>
+  A true answer means the key may be in the index and the index must be searched to confirm.
+
+  Keys can be added to the filter, but not removed.  Keys deleted from the index
+  remain in the filter and are reported as possibly present until the filter is rebuilt.
+
+  The filter is sized for roughly ten bits per key with seven hash probes per key, which
+  yields a false positive rate of about one percent at capacity.  When the number of keys
+  added exceeds the capacity, IsFull() returns xbTrue and the owner should rebuild the
+  filter with a larger key count.
+
+  The serial number is a validity stamp maintained by the owning index, used to determine
+  if the filter is in sync with the index file.
+*/
+
+class XBDLLEXPORT xbBloomFilter {
+ public:
+   xbBloomFilter();
+   ~xbBloomFilter();
+
+   void     Add( const void *vpKey, size_t lKeyLen );
+   void     Clear();
+   xbUInt32 GetCapacity() const;
+   xbUInt32 GetKeyCnt() const;
+   char     GetSerialNo() const;
+   xbBool   GetValid() const;
+   xbInt16  Init( xbUInt32 ulExpectedKeyCnt );
+   xbBool   IsFull() const;
+   xbBool   MayContain( const void *vpKey, size_t lKeyLen ) const;
+   xbInt16  Read( xbFile *f );
+   void     SetSerialNo( char cSerialNo );
+   void     SetValid( xbBool bValid );
+   xbInt16  Write( xbFile *f ) const;
+
+ private:
+   xbUInt64 Hash( const void *vpKey, size_t lKeyLen ) const;
+
+   unsigned char *cpBits;     // bit array
+   xbUInt32 ulBitCnt;         // number of bits in the array, always a power of two
+   xbUInt32 ulKeyCnt;         // number of keys added since the last Init
+   xbInt16  iHashCnt;         // number of probes per key
+   char     cSerialNo;        // tag serial number the filter is in sync with
+   xbBool   bValid;           // xbFalse if the filter is out of sync with the index and can't be used
+};
+
+}        /* namespace xb    */
+#endif   /* XB_INDEX_SUPPORT */
+#endif   /* __XB_BLOOM_H__ */
@@ -111,6 +111,14 @@ class XBDLLEXPORT xbCore{
   static xbInt16 iDefaultIxTagMode;
   #endif
 
+  #ifdef XB_TDX_SUPPORT
+  static xbUInt32 ulTdxMemLimit;           // Bytes a temp index holds in memory before spilling to disk
+  #endif
+
+  #ifdef XB_SORT_SUPPORT
+  static xbUInt32 ulSortMemLimit;          // Bytes a sort holds in memory before writing sorted runs to disk
+  #endif
+
   #ifdef XB_LOGGING_SUPPORT
   static xbString sLogDirectory;           //Default location to store log files
   static xbString sLogFileName;            //Default LogFileName
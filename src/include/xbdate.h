@@ -240,6 +240,13 @@ class XBDLLEXPORT xbDate : public xbCore {
   xbInt32     JulianDays() const;
 
 
+  /*! @brief Calculate julian days for a date in CCYYMMDD format, without setting the date object.
+    @param cpDate8 - Pointer to eight characters in CCYYMMDD format, need not be null terminated.
+    @returns The number of days since 01/01/0001 + JUL_OFFSET (1721425L), or 0 if the date is not valid.
+  */
+  xbInt32     JulianDays( const char *cpDate8 ) const;
+
+
   /*! @brief Convert julian days to gregorian date.
     @param lJulDate - Julian days.
   */
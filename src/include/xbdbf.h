@@ -40,6 +40,11 @@ namespace xb{
 #define XB_OPEN    1
 #define XB_UPDATED 2
 
+/*****************************/
+/* Record Change Log         */
+
+#define XB_DBF_CHANGE_LOG_SIZE 256    // number of record updates kept for GetChangedRecNo()
+
 
 /*****************************/
 /* File Access Modes         */
@@ -383,6 +388,34 @@ class XBDLLEXPORT xbDbf : public xbFile {
   */
   virtual xbBool GetBof();
 
+  //! @brief Return the record change sequence number.
+  /*!
+    The sequence number is bumped every time a record is written through this
+    table object by AppendRecord() or PutRecord(), which includes Commit().  It is
+    also bumped when the change log is reset by Zap(), Pack() or Close(), so a
+    saved sequence number can't be used to pick up changes after those.<br>
+
+    Changes made by other table objects or other processes are not counted.
+
+    @returns Current change sequence number.
+  */
+  xbUInt32 GetChangeSeq() const;
+
+  //! @brief Return the record number written by a given change.
+  /*!
+    The last XB_DBF_CHANGE_LOG_SIZE record writes are kept.  A caller that saved
+    GetChangeSeq() can ask for each change after it, and only revisit the records
+    that were written.
+
+    @param ulSeq Change sequence number, greater than the saved sequence number and not
+                 greater than GetChangeSeq().
+    @param ulRecNo Output - Record number written by change ulSeq.
+    @returns XB_NO_ERROR - Record number found.<br>
+             XB_NOT_FOUND - The change is no longer in the log, or was reset.  The caller
+             has to treat every record as changed.
+  */
+  xbInt16  GetChangedRecNo( xbUInt32 ulSeq, xbUInt32 &ulRecNo ) const;
+
   //! @brief Return the current record number. 
   /*!
     @returns Returns the current record number.
@@ -760,6 +793,17 @@ class XBDLLEXPORT xbDbf : public xbFile {
   */
   virtual xbInt16  GetFieldLen( const xbString &sFieldName, xbInt16 &iFieldLen ) const;
 
+  //! @brief Get field offset for field number.
+  /*!
+    This function retrieves the position of a field from the start of the record, the first byte
+    of the record is the deleted flag.
+
+    @param iFieldNo Number of field.
+    @param ulOffset Output field offset.
+    @returns XB_NO_ERROR<br>XB_INVALID_FIELD_NO
+  */
+  virtual xbInt16  GetFieldOffset( xbInt16 iFieldNo, xbUInt32 &ulOffset ) const;
+
   //! @brief Returns the name of the specified field.
   /*! Returns name for the field specified by iFieldNo.
 
@@ -1482,9 +1526,11 @@ class XBDLLEXPORT xbDbf : public xbFile {
     @param pIx   Pointer to index file
     @param vpTag Pointer to index tag
     @param sKey  String key to find
+    @param iRetrieveSw xbTrue - Retrieve the record if key found.<br>
+                       xbFalse - Index only lookup, don't retrieve the record.
     @returns <a href="xbretcod_8h.html">Return Codes</a>
   */
-  virtual xbInt16 Find( xbIx *pIx, void *vpTag, const xbString &sKey );
+  virtual xbInt16 Find( xbIx *pIx, void *vpTag, const xbString &sKey, xbInt16 iRetrieveSw = xbTrue );
 
   //! @brief Find record for date key for given tag.
   /*!
@@ -1494,9 +1540,11 @@ class XBDLLEXPORT xbDbf : public xbFile {
     @param pIx   Pointer to index file
     @param vpTag Pointer to index tag
     @param dtKey Date key to find
+    @param iRetrieveSw xbTrue - Retrieve the record if key found.<br>
+                       xbFalse - Index only lookup, don't retrieve the record.
     @returns <a href="xbretcod_8h.html">Return Codes</a>
   */
-  virtual xbInt16 Find( xbIx *pIx, void *vpTag, const xbDate &dtKey );
+  virtual xbInt16 Find( xbIx *pIx, void *vpTag, const xbDate &dtKey, xbInt16 iRetrieveSw = xbTrue );
 
   //! @brief Find record for numeric key for given tag.
   /*!
@@ -1506,9 +1554,26 @@ class XBDLLEXPORT xbDbf : public xbFile {
     @param pIx   Pointer to index file
     @param vpTag Pointer to index tag
     @param dKey  Numeric key to find
+    @param iRetrieveSw xbTrue - Retrieve the record if key found.<br>
+                       xbFalse - Index only lookup, don't retrieve the record.
     @returns <a href="xbretcod_8h.html">Return Codes</a>
   */
-  virtual xbInt16 Find( xbIx *pIx, void *vpTag, const xbDouble &dKey );
+  virtual xbInt16 Find( xbIx *pIx, void *vpTag, const xbDouble &dKey, xbInt16 iRetrieveSw = xbTrue );
+
+  //! @brief Check if a string key is in a given tag.
+  /*!
+
+    Index only existence check.  The record and the tag position are not changed, and
+    tags with a bloom filter answer most misses without reading the index.
+
+    @param pIx   Pointer to index file
+    @param vpTag Pointer to index tag
+    @param sKey  String key to check for
+    @returns XB_NO_ERROR - Key found.<br>
+             XB_NOT_FOUND - Key not found.<br>
+             <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  virtual xbInt16 ProbeKey( xbIx *pIx, void *vpTag, const xbString &sKey );
 
 
   //! @brief Get a pointer to the current index object.
@@ -1578,37 +1643,45 @@ class XBDLLEXPORT xbDbf : public xbFile {
     Position to the first key for the specified tag
     @param pIx Pointer to index file instance
     @param vpTag Pointer to tag instance
+    @param iRetrieveSw xbTrue - Retrieve the record.<br>
+                       xbFalse - Index only, position the tag without retrieving the record.
     @returns <a href="xbretcod_8h.html">Return Codes</a>
   */
-  virtual xbInt16 GetFirstKey( xbIx *pIx, void *vpTag );
+  virtual xbInt16 GetFirstKey( xbIx *pIx, void *vpTag, xbInt16 iRetrieveSw = xbTrue );
 
   //! @brief GetNextKey for specified tag.
   /*!
     Position to the next key for the specified tag
     @param pIx Pointer to index file instance
     @param vpTag Pointer to tag instance
+    @param iRetrieveSw xbTrue - Retrieve the record.<br>
+                       xbFalse - Index only, position the tag without retrieving the record.
     @returns <a href="xbretcod_8h.html">Return Codes</a>
   */
-  virtual xbInt16 GetNextKey( xbIx *pIx, void *vpTag );
+  virtual xbInt16 GetNextKey( xbIx *pIx, void *vpTag, xbInt16 iRetrieveSw = xbTrue );
 
   //! @brief GetPrevKey for specified tag.
   /*!
     Position to the prev key for the specified tag
     @param pIx Pointer to index file instance
     @param vpTag Pointer to tag instance
+    @param iRetrieveSw xbTrue - Retrieve the record.<br>
+                       xbFalse - Index only, position the tag without retrieving the record.
     @returns <a href="xbretcod_8h.html">Return Codes</a>
   */
-  virtual xbInt16 GetPrevKey( xbIx *pIx, void *vpTag );
+  virtual xbInt16 GetPrevKey( xbIx *pIx, void *vpTag, xbInt16 iRetrieveSw = xbTrue );
 
   //! @brief GetLastKey for given tag.
   /*!
     Position to the last key for the specified tag
     @param pIx Pointer to index file instance
     @param vpTag Pointer to tag instance
+    @param iRetrieveSw xbTrue - Retrieve the record.<br>
+                       xbFalse - Index only, position the tag without retrieving the record.
     @returns <a href="xbretcod_8h.html">Return Codes</a>
   */
 
-  virtual xbInt16 GetLastKey( xbIx *pIx, void *vpTag );
+  virtual xbInt16 GetLastKey( xbIx *pIx, void *vpTag, xbInt16 iRetrieveSw = xbTrue );
 
   virtual const xbString &GetCurIxType() const;
 
@@ -1768,6 +1841,12 @@ class XBDLLEXPORT xbDbf : public xbFile {
       <a href="../include/BlockRead.html">Block Read Info</a>
   */
   xbBool  GetBlockReadStatus() const;
+
+  //! @brief Get block read object
+  /*!
+      @returns Pointer to the block read object for this table, or NULL if block read is disabled.
+  */
+  xbBlockRead *GetBlockReadPtr() const;
   #endif  // XB_BLOCKREAD_SUPPORT
 
  protected:
@@ -1830,6 +1909,10 @@ class XBDLLEXPORT xbDbf : public xbFile {
   friend class xbBlockRead;
   #endif // XB_BLOCKREAD_SUPPORT
 
+  #ifdef XB_RELATE_SUPPORT
+  friend class xbRelate;
+  #endif // XB_RELATE_SUPPORT
+
 
   //! @brief Get raw field data for field number.
   /*!
@@ -2007,6 +2090,13 @@ class XBDLLEXPORT xbDbf : public xbFile {
   */
   void     ResetNoOfRecords(); 
 
+  void     LogRecChange( xbUInt32 ulRecNo );
+  void     ResetChangeLog();
+
+  xbUInt32 ulChangeSeq;                   // sequence number of the last record change
+  xbUInt32 ulChangeLogFirst;              // first sequence number still available in ulaChangeLog
+  xbUInt32 ulaChangeLog[XB_DBF_CHANGE_LOG_SIZE];   // record numbers written, indexed by sequence number
+
   xbInt16  iMultiUser;                    //  xbOn      - table is shared
                                           //  xbOff     - table not shared
                                           //  xbSysDflt - table status determined by ssytem default setting
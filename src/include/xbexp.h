@@ -31,6 +31,54 @@ Email Contact:
 #define XB_EXP_LOGICAL   'L'
 #define XB_EXP_NUMERIC   'N'
 #define XB_EXP_UNKNOWN   'U'
+
+// function codes, resolved when the expression is parsed
+#define XB_EXP_FNC_ABS          1
+#define XB_EXP_FNC_ALLTRIM      2
+#define XB_EXP_FNC_ASC          3
+#define XB_EXP_FNC_AT           4
+#define XB_EXP_FNC_CDOW         5
+#define XB_EXP_FNC_CHR          6
+#define XB_EXP_FNC_CMONTH       7
+#define XB_EXP_FNC_CTOD         8
+#define XB_EXP_FNC_DATE         9
+#define XB_EXP_FNC_DAY         10
+#define XB_EXP_FNC_DEL         11
+#define XB_EXP_FNC_DELETED     12
+#define XB_EXP_FNC_DESCEND     13
+#define XB_EXP_FNC_DOW         14
+#define XB_EXP_FNC_DTOC        15
+#define XB_EXP_FNC_DTOS        16
+#define XB_EXP_FNC_EXP         17
+#define XB_EXP_FNC_IIF         18
+#define XB_EXP_FNC_INT         19
+#define XB_EXP_FNC_ISALPHA     20
+#define XB_EXP_FNC_ISLOWER     21
+#define XB_EXP_FNC_ISUPPER     22
+#define XB_EXP_FNC_LEFT        23
+#define XB_EXP_FNC_LEN         24
+#define XB_EXP_FNC_LOG         25
+#define XB_EXP_FNC_LOWER       26
+#define XB_EXP_FNC_LTRIM       27
+#define XB_EXP_FNC_MAX         28
+#define XB_EXP_FNC_MIN         29
+#define XB_EXP_FNC_MONTH       30
+#define XB_EXP_FNC_RECNO       31
+#define XB_EXP_FNC_RECCOUNT    32
+#define XB_EXP_FNC_REPLICATE   33
+#define XB_EXP_FNC_RIGHT       34
+#define XB_EXP_FNC_RTRIM       35
+#define XB_EXP_FNC_SPACE       36
+#define XB_EXP_FNC_SQRT        37
+#define XB_EXP_FNC_STOD        38
+#define XB_EXP_FNC_STR         39
+#define XB_EXP_FNC_STRZERO     40
+#define XB_EXP_FNC_SUBSTR      41
+#define XB_EXP_FNC_TRIM        42
+#define XB_EXP_FNC_UPPER       43
+#define XB_EXP_FNC_VAL         44
+#define XB_EXP_FNC_YEAR        45
+#define XB_EXP_FNC_USER      1000     // first application registered function, see xbXBase::RegisterFunction()
 #endif
 
 #ifdef XB_EXPRESSION_SUPPORT
@@ -48,6 +96,86 @@ Email Contact:
 // #define XB_UNBALANCED_PARENS -101
 // #define XB_UNBALANCED_QUOTES -102
 
+// operator codes, resolved when the expression is parsed
+#define XB_EXP_OPR_ADD         1    // +
+#define XB_EXP_OPR_SUB         2    // -
+#define XB_EXP_OPR_MUL         3    // *
+#define XB_EXP_OPR_DIV         4    // /
+#define XB_EXP_OPR_POW         5    // ^ **
+#define XB_EXP_OPR_MOD         6    // %
+#define XB_EXP_OPR_ADDASG      7    // +=
+#define XB_EXP_OPR_SUBASG      8    // -=
+#define XB_EXP_OPR_MULASG      9    // *=
+#define XB_EXP_OPR_DIVASG     10    // /=
+#define XB_EXP_OPR_INC        11    // ++
+#define XB_EXP_OPR_DEC        12    // --
+#define XB_EXP_OPR_AND        13    // .AND. AND
+#define XB_EXP_OPR_OR         14    // .OR. OR
+#define XB_EXP_OPR_NOT        15    // .NOT. NOT
+#define XB_EXP_OPR_EQ         16    // =
+#define XB_EXP_OPR_NE         17    // <> # !=
+#define XB_EXP_OPR_LT         18    // <
+#define XB_EXP_OPR_LE         19    // <=
+#define XB_EXP_OPR_GT         20    // >
+#define XB_EXP_OPR_GE         21    // >=
+#define XB_EXP_OPR_CONTAINS   22    // $
+
+// compiled expression op codes
+#define XB_EXPOP_ERROR       0      // raise the error code in iArg[0]
+#define XB_EXPOP_FIELD_C     1      // load field into register
+#define XB_EXPOP_FIELD_D     2
+#define XB_EXPOP_FIELD_L     3
+#define XB_EXPOP_FIELD_N     4
+#define XB_EXPOP_PRE_INC     5      // ++x
+#define XB_EXPOP_PRE_DEC     6      // --x
+#define XB_EXPOP_POST_INC    7      // x++
+#define XB_EXPOP_POST_DEC    8      // x--
+#define XB_EXPOP_ADD_N      10      // numeric and date arithmetic
+#define XB_EXPOP_SUB_N      11
+#define XB_EXPOP_MUL_N      12
+#define XB_EXPOP_DIV_N      13
+#define XB_EXPOP_POW_N      14
+#define XB_EXPOP_ADDASG_N   15      // +=
+#define XB_EXPOP_SUBASG_N   16      // -=
+#define XB_EXPOP_MULASG_N   17      // *=
+#define XB_EXPOP_DIVASG_N   18      // /=
+#define XB_EXPOP_CAT_C      20      // char +
+#define XB_EXPOP_CATTRIM_C  21      // char -
+#define XB_EXPOP_AND        30
+#define XB_EXPOP_OR         31
+#define XB_EXPOP_NOT        32
+#define XB_EXPOP_AND_SC     33      // .AND. left operand false, set result and jump past the right operand
+#define XB_EXPOP_OR_SC      34      // .OR. left operand true, set result and jump past the right operand
+#define XB_EXPOP_EQ_C       40      // compares, char
+#define XB_EXPOP_NE_C       41
+#define XB_EXPOP_LT_C       42
+#define XB_EXPOP_LE_C       43
+#define XB_EXPOP_GT_C       44
+#define XB_EXPOP_GE_C       45
+#define XB_EXPOP_CONTAINS_C 46      // $
+#define XB_EXPOP_EQ_N       50      // compares, numeric
+#define XB_EXPOP_NE_N       51
+#define XB_EXPOP_LT_N       52
+#define XB_EXPOP_LE_N       53
+#define XB_EXPOP_GT_N       54
+#define XB_EXPOP_GE_N       55
+#define XB_EXPOP_EQ_D       60      // compares, date
+#define XB_EXPOP_NE_D       61
+#define XB_EXPOP_LT_D       62
+#define XB_EXPOP_LE_D       63
+#define XB_EXPOP_GT_D       64
+#define XB_EXPOP_GE_D       65
+#define XB_EXPOP_FUNCTION   70      // function call
+#define XB_EXPOP_FUNCTION_C 71      // character function evaluated in the register buffers
+
+#define XB_EXP_BATCH_SIZE  256      // records evaluated per pass in ProcessExpressionBatch()
+
+// record dependencies other than fields, see xbExp::GetDepFlags()
+#define XB_EXP_DEP_RECNO     0x01   // RECNO()
+#define XB_EXP_DEP_DELETED   0x02   // DEL(), DELETED()
+#define XB_EXP_DEP_DATE      0x04   // DATE()
+#define XB_EXP_DEP_EXTERNAL  0x08   // fields in another table, RECCOUNT(), application functions
+
 
 namespace xb{
 
@@ -69,6 +197,16 @@ struct XBDLLEXPORT xbExpToken {
   // constructor
   xbExpToken() { cNodeType = 0; cReturnType = 0; iSts = 0; cPrevNodeType = 0; cPrevReturnType = 0; }
 };
+
+struct XBDLLEXPORT xbExpInstr {
+  xbInt16    iOpCode;        // one of the XB_EXPOP_ op codes
+  xbInt16    iReg;           // result register
+  xbInt16    iArgCnt;        // number of operand registers
+  xbInt16    iArg[4];        // operand registers, or error code for XB_EXPOP_ERROR, or jump target
+  xbExpNode  *n;             // node the instruction was compiled from
+  xbUInt32   ulOfs;          // field offset in the record, for the XB_EXPOP_FIELD_* instructions
+  xbUInt32   ulLen;          // field length, for the XB_EXPOP_FIELD_* instructions
+};
 ///@endcond DOXYOFF
 
 
@@ -99,6 +237,21 @@ expression tree created by ParseExpression().  The routine parses each
 node in the expression tree, executing functions, processing operands 
 and manipulating data to produce the desired result.<br>
 
+After the tree is built, ParseExpression also compiles it into a flat postfix
+program.  Each node gets a register, and each instruction reads its operands
+from and writes its result to those registers.  ProcessExpression runs the
+program in a single loop instead of walking the tree, the tree itself is kept
+for DumpTree.<br>
+
+Before the tree is compiled, subtrees that don't depend on the record are
+evaluated once and replaced with constants, and .AND., .OR. and IIF with a
+constant operand are simplified.  The right operand of .AND. and .OR. is
+skipped at run time when the left operand decides the result.<br>
+
+Repeated subtrees, such as UPPER( CITY ) compared more than once in a filter, are
+compiled once.  Later copies read the register of the first copy instead of being
+evaluated again, as long as the first copy can't be skipped by a short circuit.<br>
+
 If an expression will be processed repeatedly, it is best to pre-parse the
 tree using <em>ParseExpression</em>, then for each new call to the expression,
 execute method <em>ProcessExpression</em> which processes the tree.<br><br>
@@ -186,6 +339,15 @@ class XBDLLEXPORT xbExp{
        @note Available if XB_DEBUG_SUPPORT option compiled into the library.
     */
     void      DumpToken( xbExpToken &pNode, xbInt16 iOption = 0 );
+
+    //! @brief Get the number of program instructions run.
+    /*!
+       @returns Number of compiled instructions run by the last ProcessExpression(), one for each
+                node evaluated and one for each .AND. / .OR. jump checked.
+
+       @note Available if XB_DEBUG_SUPPORT option compiled into the library.
+    */
+    xbUInt32  GetInstrExecCnt() const;
     #endif
 
     //! @brief Get result length.
@@ -285,6 +447,76 @@ class XBDLLEXPORT xbExp{
     */
     xbInt16   ProcessExpression( xbInt16 iRecBufSw );
 
+    //! @brief Process expression for a batch of records.
+    /*!
+       Evaluate the expression for a run of contiguous records, such as a block loaded by xbBlockRead,
+       without moving each record into the record buffer.  Each instruction is run down the column of
+       records before the next one, so the inner loops are simple enough for the compiler to vectorize.<br>
+       Only available when GetBatchSupport() returns xbTrue.  Logical results are returned as 1 or 0, date
+       results as julian days.
+
+       @param cpRecs Pointer to the first record.
+       @param ulRecCnt Number of records.
+       @param dpResults Output - one result per record.
+       @returns <a href="xbretcod_8h.html">Return Codes</a>
+    */
+    xbInt16   ProcessExpressionBatch( const char *cpRecs, xbUInt32 ulRecCnt, xbDouble *dpResults );
+
+    //! @brief Determine if the expression can be processed in batches.
+    /*!
+       @returns xbTrue - ProcessExpressionBatch() can be used.<br>
+                xbFalse - The expression is a character expression, changes a value, calls a function without
+                          parameters or an application function, or refers to a field in another table.
+    */
+    xbBool    GetBatchSupport();
+
+    //! @brief Get the record dependencies other than fields.
+    /*!
+       Set when the expression is parsed.
+       @returns Zero or more of XB_EXP_DEP_RECNO, XB_EXP_DEP_DELETED, XB_EXP_DEP_DATE and XB_EXP_DEP_EXTERNAL.<br>
+                If XB_EXP_DEP_EXTERNAL is set, the result can change when none of the fields change.
+    */
+    xbInt16   GetDepFlags() const;
+
+    //! @brief Get a field the expression reads.
+    /*!
+       @param iDepNo Entry number, 0 to GetFieldDepCnt() - 1.
+       @returns Field number, fields are returned in ascending order.  -1 if iDepNo is out of range.
+    */
+    xbInt16   GetFieldDep( xbInt16 iDepNo ) const;
+
+    //! @brief Get the number of fields the expression reads.
+    /*!
+       Only fields in the expression's table are counted, see GetDepFlags().
+       @returns Number of distinct fields.
+    */
+    xbInt16   GetFieldDepCnt() const;
+
+    //! @brief Get the number of repeated subtrees.
+    /*!
+       Set when the expression is parsed.
+       @returns Number of subtrees that use the result of an identical subtree evaluated earlier
+                in the same record, instead of being evaluated again.
+    */
+    xbInt16   GetSharedNodeCnt() const;
+
+    //! @brief Determine if the expression reads a field.
+    /*!
+       @param iFieldNo Field number.
+       @returns xbTrue - Field is used in the expression.<br>
+                xbFalse - Field is not used in the expression.
+    */
+    xbBool    IsFieldDep( xbInt16 iFieldNo ) const;
+
+    //! @brief Turn error logging on or off.
+    /*!
+       The log is shared by all threads.  An expression evaluated with ProcessExpressionBatch()
+       on a worker thread has logging turned off, errors are only returned to the caller.
+       @param bMsgLogging xbTrue - Write errors to the log, the default.<br>
+                          xbFalse - Only return error codes.
+    */
+    void      SetMsgLogging( xbBool bMsgLogging );
+
   protected:
 
 
@@ -327,6 +559,19 @@ class XBDLLEXPORT xbExp{
 
     xbExpNode *GetNextNode( xbExpNode * n ) const;  // traverses the tree from bottom left node, right, then up
 
+    //! @brief Process expression tree.
+    /*!
+       @private
+       Evaluate the expression by walking the tree of nodes, leaving the result in the root node.
+       Used when the expression could not be compiled.
+
+       @param iRecBufSw Record buffer to use when evaluating expression.<br>
+                   0 - Current record buffer.<br>
+                   1 - Original record buffer.
+       @returns <a href="xbretcod_8h.html">Return Codes</a>
+    */
+    xbInt16   ProcessExpressionTree( xbInt16 iRecBufSw );
+
   private:    // methods
 
     // xbInt16 CalcExpressionResultLen();
@@ -353,8 +598,116 @@ class XBDLLEXPORT xbExp{
        @returns <a href="xbretcod_8h.html">Return Codes</a>
     */
     xbInt16 CheckParensAndQuotes( const xbString &sExpression );
+
+    //! @brief Compile expression.
+    /*!
+       @private
+       Compile the parsed tree into a flat postfix program with one register per node.
+       @returns <a href="xbretcod_8h.html">Return Codes</a>
+    */
+    xbInt16 CompileExpression();
+
+    //! @brief Copy a parsed expression.
+    /*!
+       @private
+       Copy the tree from another expression and compile it.
+       @param e Expression to copy.
+       @returns <a href="xbretcod_8h.html">Return Codes</a>
+    */
+    xbInt16 CopyExpression( const xbExp *e );
+
+    //! @brief Decode a numeric field.
+    /*!
+       @private
+       Convert a numeric field straight from the record buffer, without copying it to a string first.
+       Gives the same result as xbDbf::GetDoubleField().
+       @param cpField Pointer to the field in the record buffer.
+       @param ulLen Field length.
+       @returns Field value.
+    */
+    xbDouble DecodeNumericField( const char *cpField, xbUInt32 ulLen ) const;
+
+    //! @brief Execute a character function in the register buffers.
+    /*!
+       @private
+       @param p Instruction.
+       @returns <a href="xbretcod_8h.html">Return Codes</a>
+    */
+    xbInt16 ExecuteCharFunction( xbExpInstr *p );
+
+    //! @brief Execute compiled expression.
+    /*!
+       @private
+       @param iRecBufSw Record buffer to use when evaluating expression.
+       @returns <a href="xbretcod_8h.html">Return Codes</a>
+    */
+    xbInt16 ExecuteProgram( xbInt16 iRecBufSw );
+
+    //! @brief Fold constant subtrees.
+    /*!
+       @private
+       Evaluate operators and functions whose operands are all constants and replace them with
+       the result.  Simplify .AND., .OR. and IIF when an operand is constant.
+       @param n Node to start at.
+       @returns <a href="xbretcod_8h.html">Return Codes</a>
+    */
+    xbInt16 FoldConstants( xbExpNode *n );
+
+    //! @brief Free batch work areas.
+    /*!
+       @private
+    */
+    void    FreeBatch();
+
+    //! @brief Free field dependency list.
+    /*!
+       @private
+    */
+    void    FreeFieldDeps();
+
+    //! @brief Free compiled expression.
+    /*!
+       @private
+    */
+    void    FreeProgram();
+
     xbInt16 GetExpressionResultLen() const;
 
+    //! @brief Get register number for a node.
+    /*!
+       @private
+       @param n Node.
+       @returns Register number, or -1 if not found.
+    */
+    xbInt16 GetRegNo( xbExpNode *n ) const;
+
+    //! @brief Determine if a subtree changes a value when processed.
+    /*!
+       @private
+       @param n Node at the top of the subtree.
+       @returns xbTrue - Subtree contains an increment, decrement or assignment operator.<br>
+                xbFalse - Subtree can be dropped without changing the result.
+    */
+    xbBool  HasSideEffects( xbExpNode *n ) const;
+
+    //! @brief Determine if a subtree can share its result with an identical subtree.
+    /*!
+       @private
+       @param n Node at the top of the subtree.
+       @returns xbTrue - Subtree gives the same result every time it is processed for a record.<br>
+                xbFalse - Subtree is a constant, changes a value or calls an application function.
+    */
+    xbBool  IsShareable( xbExpNode *n ) const;
+
+    //! @brief Determine if an operator skips its right operand when the left operand decides the result.
+    /*!
+       @private
+       @param n Node.
+       @returns xbTrue - Node is a logical .AND. / .OR. compiled with a jump around its right operand.<br>
+                xbFalse - Both operands are always processed.
+    */
+    xbBool  IsShortCircuit( xbExpNode *n ) const;
+
     //! @brief GetTokenCharConstant
     /*! @private
         This method returns the character constant in a pair of quotes
@@ -596,6 +949,14 @@ class XBDLLEXPORT xbExp{
     xbInt16 ProcessExpressionFunction( xbExpNode *n, xbInt16 iRecBufSw = 0 );
 
 
+    //! @brief Prepare batch processing.
+    /*!
+       @private
+       Check the compiled program can be run over a batch of records and set up the column registers.
+       @returns <a href="xbretcod_8h.html">Return Codes</a>
+    */
+    xbInt16 PrepareBatch();
+
     //! @brief Process Expression Operator
     /*! This method processes an expression operator for a given node.
       @returns XB_NO_ERROR<br>
@@ -604,10 +965,54 @@ class XBDLLEXPORT xbExp{
     */
     xbInt16 ProcessExpressionOperator( xbExpNode *n );
 
+    //! @brief Reserve a character register.
+    /*!
+       @private
+       Make sure a character register buffer can hold a result, only grows the buffer
+       if the result is longer than the size calculated when the expression was parsed.
+       @param iReg Register number.
+       @param ulLen Length of the result, not counting the null terminator.
+       @returns Pointer to the register buffer, or NULL if out of memory.
+    */
+    char   *ReserveStrReg( xbInt16 iReg, xbUInt32 ulLen );
+
+    //! @brief Set the field dependency list.
+    /*!
+       @private
+       Walk the parsed tree and record the fields and record values the expression reads.
+       @returns <a href="xbretcod_8h.html">Return Codes</a>
+    */
+    xbInt16 SetFieldDeps();
+
   private:   // fields
     xbXBase   *xbase;
     xbDbf     *dbf;
     xbExpNode *nTree;        // pointer to tree of expNodes
+
+    xbExpInstr *pProgram;    // compiled program, one instruction per non constant node plus the .AND. / .OR. jumps
+    xbInt16   iInstrCnt;     // number of instructions
+    xbExpNode **npRegNode;   // node for each register
+    xbInt16   *ipRegShare;   // register each node's result is read from, -1 if the node is inside a repeated subtree
+    xbInt16   iSharedCnt;    // number of repeated subtrees
+    #ifdef XB_DEBUG_SUPPORT
+    xbUInt32  ulInstrExecCnt;// instructions run by the last ExecuteProgram()
+    #endif
+    xbDouble  *dReg;         // numeric, date and logical registers
+    xbString  *sReg;         // constant values, and arguments staged for functions without a buffer version
+    char      **cpStrReg;    // character registers, sized from the node result length when compiled
+    xbUInt32  *ulpStrCap;    // size of each character register buffer, not counting the null terminator
+    xbUInt32  *ulpStrLen;    // length of the value in each character register
+    xbInt16   iRegCnt;       // number of registers, the root node's register is last
+    xbBool    bVmResult;     // xbTrue if the last result is in the registers, not the tree
+    xbInt16   iBatchSts;     // 0 - not checked, 1 - batch capable, -1 - not batch capable
+    xbDouble  *dBatch;       // column registers, XB_EXP_BATCH_SIZE entries per register
+    xbString  *sBatch;
+    xbUInt32  *ulpBatchOfs;  // offset of the field in the record, for field registers
+    xbUInt32  *ulpBatchLen;  // length of the field, for field registers
+    xbInt16   *ipFieldDeps;  // fields read by the expression, ascending
+    xbInt16   iFieldDepCnt;  // number of entries in ipFieldDeps
+    xbInt16   iDepFlags;     // XB_EXP_DEP_* flags
+    xbBool    bMsgLogging;   // xbFalse - errors are returned without writing to the log
     // xbInt16   iExpLen;       // size of expression result
 
 
@@ -78,6 +78,12 @@ class XBDLLEXPORT xbExpNode {
    */
    xbInt16   AddChild( xbExpNode *n );
 
+   /*!
+      Copy the node and all of its descendants. The copy has no parent.
+      @returns Pointer to the new node.
+   */
+   xbExpNode *Clone() const;
+
 
    //! @brief Get pointer to child.
    /*!
@@ -135,6 +141,12 @@ class XBDLLEXPORT xbExpNode {
    */
    char      GetNodeType() const;
 
+   //! @brief Get the operator or function code.
+   /*!
+      @returns One of the XB_EXP_OPR_ codes for operator nodes, or one of the XB_EXP_FNC_ codes for function nodes.
+   */
+   xbInt16   GetOpCode() const;
+
    //! @brief Get parent.
    /*!
       @returns Pointer to parent node.
@@ -191,6 +203,15 @@ class XBDLLEXPORT xbExpNode {
    */
    xbBool    HasRightSibling() const;
 
+   //! @brief Determine if two node trees are the same.
+   /*!
+      Compares the node types, operations, fields and constants of both trees.
+      @param n Root of tree to compare with.
+      @returns xbTrue - Trees are the same.<br>
+               xbFalse - Trees are different.
+   */
+   xbBool    IsEqual( const xbExpNode *n ) const;
+
    //! @brief Determine if node is an operator.
    /*!
       @returns xbTrue - Node is an operator.<br>
@@ -205,9 +226,26 @@ class XBDLLEXPORT xbExpNode {
    */
    xbBool    IsUnaryOperator() const;
 
+   //! @brief Remove child from node.
+   /*!
+      The child is unlinked from the node, not deleted.
+      @param n Child to remove.
+      @returns <a href="xbretcod_8h.html">Return Codes</a>
+   */
+   xbInt16   RemoveChild( xbExpNode *n );
+
    //! @brief Remove last child from node.
    void      RemoveLastChild();
 
+   //! @brief Replace child.
+   /*!
+      Put a new node in the position of an existing child. The existing child is unlinked, not deleted.
+      @param nOld Child to replace.
+      @param nNew Replacement node.
+      @returns <a href="xbretcod_8h.html">Return Codes</a>
+   */
+   xbInt16   ReplaceChild( xbExpNode *nOld, xbExpNode *nNew );
+
    //! @brief Set result length.
    /*!
       @param ulResultLen Set result length.
@@ -244,6 +282,13 @@ class XBDLLEXPORT xbExpNode {
    */
    void      SetNodeType( char cNodeType );
 
+   //! @brief Set the operator or function code.
+   /*!
+      @param iOpCode Operator or function code, resolved when the expression is parsed.
+      @returns void.
+   */
+   void      SetOpCode( xbInt16 iOpCode );
+
    //! @brief Set parent.
    /*!
       @param n Pointer to parent.
@@ -315,6 +360,7 @@ class XBDLLEXPORT xbExpNode {
    xbUInt32  ulResultLen;               // for string results, accumulated length of character operations
                                         // includes the sum of all nodes under this + this
                                         // date = 8, numeric = 4, logical = 1
+   xbInt16   iOpCode;                   // operator or function code
    xbInt16   iWeight;                   // used for building the tree of nodes, assigned to operators
                                         // the higher the number, the lower it goes on the tree
 
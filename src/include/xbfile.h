@@ -375,6 +375,12 @@ class XBDLLEXPORT xbFile : public xbCore {
     */
     FILE * GetFp();
 
+    /** @brief Determine if the file contents are held in memory.
+      @returns xbTrue - File is memory resident, nothing has been written to disk.<br>
+               xbFalse - File is on disk.
+    */
+    xbBool GetMemoryResident() const;
+
 
     /** @brief Get the open mode of the file.
       @returns XB_READ - Read Only Mode<br>
@@ -493,6 +499,17 @@ class XBDLLEXPORT xbFile : public xbCore {
    */
    xbInt16 SetHomeFolders();
 
+   /** @brief Set memory resident mode.
+
+     When set before the file is created with one of the "w" open modes, the file contents
+     are kept in a memory buffer instead of on disk.  If the file grows beyond ullMemLimit bytes,
+     the contents are written to disk and the file continues as a normal disk file.<br>
+     Intended for temporary files that are removed when closed.
+
+     @param ullMemLimit - Maximum number of bytes to hold in memory, 0 to turn off memory resident mode.
+   */
+   void SetMemoryResident( xbUInt64 ullMemLimit );
+
    /** @brief Write a block of data to file.
      @param ulBlockNo - block number to write
      @param lWriteSize - size of data to write, set to 0 to write blocksize
@@ -789,6 +806,10 @@ class XBDLLEXPORT xbFile : public xbCore {
 
   private:
 
+    xbInt16 MemReserve( size_t stNewLen );
+    xbInt16 MemSpill();
+    xbInt16 MemWrite( const void *p, size_t stLen );
+
     FILE     *fp;
     char     *pFileBuffer;       /* file buffer set with setvbuf                         */
     xbString sFqFileName;        /* fully qualified file name                            */
@@ -801,6 +822,13 @@ class XBDLLEXPORT xbFile : public xbCore {
     xbInt16  iShareMode;         /* XB_SINGLE_USER || XB_MULTI_USER - set file buffering */
     xbInt32  iFileNo;            /* Library File No                                      */
 
+    char     *cpMemBuf;          /* file contents, if memory resident                    */
+    size_t   stMemAlloc;         /* allocated size of cpMemBuf                           */
+    size_t   stMemLen;           /* logical file size, if memory resident                */
+    size_t   stMemPos;           /* current file position, if memory resident            */
+    xbUInt64 ullMemLimit;        /* memory resident limit, 0 if not memory resident      */
+    xbBool   bMemResident;       /* xbTrue if the file contents have not been written to disk */
+
     #ifdef XB_LOCKING_SUPPORT
     xbInt16  iLockRetries;       /* file override number of lock attempts                */
     #endif
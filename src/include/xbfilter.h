@@ -29,6 +29,22 @@ This class manages the user data area (UDA)
 
 namespace xb{
 
+///@cond DOXYOFF
+#ifdef XB_INDEX_SUPPORT
+// index key range derived from the filter expression, bounds are inclusive
+struct XBDLLEXPORT xbFilterRange {
+  char     cKeyType;         // C, N or D
+  xbInt32  lKeyLen;
+  xbBool   bLo;              // lower bound set
+  xbBool   bHi;              // upper bound set
+  xbString sLo;              // char bounds, compared against the leading bytes of the key
+  xbString sHi;
+  xbDouble dLo;              // numeric and date bounds
+  xbDouble dHi;
+};
+#endif // XB_INDEX_SUPPORT
+///@endcond DOXYOFF
+
 
 //! @brief xbFilter class.
 /*!
@@ -145,6 +161,57 @@ class XBDLLEXPORT xbFilter {
   */
   xbInt16 GetPrevRecord ( xbInt16 iOption = XB_ACTIVE_RECS );
 
+  //! @brief Count the filtered records
+  /*!
+    Count the records matching the filter without stepping through them with
+    GetFirstRecord() and GetNextRecord().  The cheapest available method is used:
+    <ol>
+    <li>The materialized bitmap, see SetMaterialize().
+    <li>The records inside an index key range, see GetIxRangeStatus().
+    <li>The deleted flag alone, for <em>DELETED()</em>, <em>.NOT. DELETED()</em> and <em>DEL() = "*"</em> filters.
+    <li>Block evaluation of the whole table.
+    <li>Reading the table a record at a time.
+    </ol>
+    The current record is left as it was, and the limit and query count are not used or changed.
+    If the current record has pending updates, XB_INVALID_RECORD is returned, commit or abort
+    them first.
+
+    @param ulCount Output - Number of matching records.
+    @param iOption XB_ALL_RECS - Count filtered records, deleted or not.<br>
+                   XB_ACTIVE_RECS - Count active filtered records. Default setting.<br>
+                   XB_DELETED_RECS - Count deleted filtered records.<br>
+    @returns XB_INVALID_RECORD - The current record has pending updates.<br>
+             <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 Count( xbUInt32 &ulCount, xbInt16 iOption = XB_ACTIVE_RECS );
+
+  //! @brief Determine if any records match the filter
+  /*!
+    Same as Count(), but stops at the first matching record.
+
+    @param bExists Output - xbTrue if at least one record matches the filter.
+    @param iOption XB_ALL_RECS - Check filtered records, deleted or not.<br>
+                   XB_ACTIVE_RECS - Check active filtered records. Default setting.<br>
+                   XB_DELETED_RECS - Check deleted filtered records.<br>
+    @returns <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 Exists( xbBool &bExists, xbInt16 iOption = XB_ACTIVE_RECS );
+
+  //! @brief Estimate the filtered record count
+  /*!
+    Returns an upper bound for the number of records the current query can return, without
+    reading the table.  The bitmap count is used when the matches are materialized, the number
+    of records inside the index key range when the query uses one, and the parallel scan match
+    count when the query is returned from a parallel scan.  Otherwise the table record count is
+    used.  The result is capped by the limit, if one is set.<br>
+
+    The estimate is for the query started by the last GetFirstRecord() or GetLastRecord().
+
+    @param ulRecCnt Output - Estimated number of records.
+    @returns <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 GetEstimatedRecCnt( xbUInt32 &ulRecCnt );
+
   //! @brief Get last record for filter
   /*!
     @param iOption XB_ALL_RECS - Get the last filtered record, deleted or not.<br>
@@ -185,6 +252,78 @@ class XBDLLEXPORT xbFilter {
   */
   xbInt32 GetQryCnt() const;
 
+  //! @brief Set materialize switch
+  /*!
+    When materialize is on, the first GetFirstRecord() or GetLastRecord() call evaluates
+    the filter against the whole table and keeps the matching record numbers in a compressed
+    bitmap.  From then on, navigation steps through the bitmap and only reads the records
+    it returns.<br>
+
+    Records written through the same xbDbf object with AppendRecord(), PutRecord() or
+    Commit() are tracked by the table change log, and only those records are evaluated
+    again before the next move.  If more records were written than the change log holds,
+    or the table was packed or zapped, the bitmap is rebuilt.  Records appended by other
+    table objects or processes are picked up, but updates made by them are not seen until
+    the bitmap is rebuilt by calling SetMaterialize() again.<br>
+
+    This is worth switching on when the same filter is run over the table several times.
+
+    @param bMaterialize xbTrue - Keep a bitmap of the matching records.<br>
+                        xbFalse - Evaluate the filter on every pass.  Default setting.
+  */
+  void    SetMaterialize( xbBool bMaterialize );
+
+  //! @brief Get materialize switch
+  /*!
+    @returns Current materialize setting.
+  */
+  xbBool  GetMaterialize() const;
+
+  //! @brief Get bitmap status
+  /*!
+    @returns xbTrue - The matching records are materialized and in sync with the table as of the last move.<br>
+             xbFalse - The filter is evaluated from the table.
+  */
+  xbBool  GetBitmapStatus() const;
+
+  #ifdef XB_PARALLEL_SUPPORT
+  //! @brief Set parallel scan options
+  /*!
+    When parallel scans are on, GetFirstRecord() and GetLastRecord() split the table into
+    record ranges and evaluate the filter on several worker threads at once.  Each worker reads
+    the table through its own read only file handle and its own copy of the filter expression.
+    The matching record numbers are collected before the first record is returned, and
+    GetNextRecord() and GetPrevRecord() step through them.  If a limit is set, the workers stop
+    once enough records have been found.<br>
+
+    A parallel scan is only used when the filter expression can be evaluated a block at a time,
+    the current record has no pending updates, the table is not memory resident, and no index key
+    range or materialized bitmap applies.  Otherwise the table is read as usual.<br>
+
+    The matches are a snapshot taken when the scan runs.  Each record is checked against the
+    filter again as it is returned, so records that were changed since then are skipped, but
+    records that start to match after the scan are not picked up until the next
+    GetFirstRecord() or GetLastRecord().
+
+    @param iThreadCnt Number of worker threads.  Zero uses one thread per processor, one turns
+                      parallel scans off.  Default setting is one.
+    @param bOrdered xbTrue - Return the records in table order.  Default setting.<br>
+                    xbFalse - Return the records in the order the workers find them.  With a limit set,
+                    this returns the first records found anywhere in the table, instead of the first
+                    ones in table order.  Delivery is not streamed, the scan still finishes before
+                    the first record is returned.
+    @returns <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 SetParallel( xbInt16 iThreadCnt, xbBool bOrdered = xbTrue );
+
+  //! @brief Get parallel scan status
+  /*!
+    @returns xbTrue - The current query is being returned from a parallel scan.<br>
+             xbFalse - The current query reads the table.
+  */
+  xbBool  GetParallelStatus() const;
+  #endif  // XB_PARALLEL_SUPPORT
+
   #ifdef XB_INDEX_SUPPORT
 
   //! @brief Find a filtered record for a given xbString key.
@@ -269,6 +408,42 @@ class XBDLLEXPORT xbFilter {
     @returns <a href="xbretcod_8h.html">Return Codes</a>
   */
   xbInt16 GetLastRecordIx ( xbInt16 iOpt = XB_ACTIVE_RECS );
+
+  //! @brief Get index range status
+  /*!
+    GetFirstRecord() and GetLastRecord() look for an open index tag whose key is restricted
+    by the filter expression, such as <em>KEYFLD >= 'A' .AND. KEYFLD <= 'C'</em>.  If one
+    is found, only the records inside the key range are read.  The records are still returned
+    in record number order, and the whole filter expression is checked for each of them.
+
+    @returns xbTrue - The current query is being resolved from an index key range.<br>
+             xbFalse - The current query reads the table.
+  */
+  xbBool  GetIxRangeStatus() const;
+
+  //! @brief Get index range bounds for a tag
+  /*!
+    Check whether the filter expression restricts the key of a given tag, the same check
+    GetFirstRecord() makes when it looks for an index key range.
+
+    @param pIx Pointer to index file.
+    @param vpTag Pointer to tag.
+    @param r Output - the key range, bounds are inclusive.
+    @returns xbTrue - The tag can be used for an index key range.<br>
+             xbFalse - The filter expression does not restrict the key, or the tag can't be used.
+  */
+  xbBool  GetIxRangeBounds( xbIx *pIx, void *vpTag, xbFilterRange &r ) const;
+
+  //! @brief Set index range option
+  /*!
+    @param cRangeMode A - Automatic, use the tag with the most bounds.  Default setting.<br>
+                      N - Don't use an index key range, read the table.<br>
+                      T - Only use the given tag for an index key range.
+    @param pIx Pointer to index file, for option T.
+    @param vpTag Pointer to tag, for option T.
+    @returns <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 SetIxRange( char cRangeMode, xbIx *pIx = NULL, void *vpTag = NULL );
   #endif  // XB_INDEX_SUPPORT
 
  private:
@@ -279,11 +454,61 @@ class XBDLLEXPORT xbFilter {
   xbInt32  lCurQryCnt;       // current count of rows returned, neg# is moving from bottom to top
                              //                                 pos# is moving from top to bottom
 
+  xbBool   bMaterialize;     // xbTrue to keep the matching records in bmMatch
+  xbBool   bBitmapSts;       // xbTrue if bmMatch has been built and can be refreshed from the change log
+  xbUInt32 ulBitmapSeq;      // table change sequence bmMatch is in sync with
+  xbUInt32 ulBitmapRecCnt;   // table record count bmMatch is in sync with
+  xbBitmap bmMatch;          // records matching the filter expression
+  xbBitmap bmDeleted;        // matching records flagged for deletion
+
+  xbInt16 BuildBitmap();
+  xbInt16 CountRecords( xbUInt32 &ulCount, xbInt16 iOption, xbUInt32 ulMax );
+  xbInt16 GetDeletedFilterOption();
+  xbInt16 GetNextBitmapRecord( xbUInt32 ulRecNo, xbInt16 iDirection, xbInt16 iOption );
+  xbInt16 RefreshBitmap();
+  xbInt16 RefreshBitmapRecord( xbUInt32 ulRecNo, xbUInt32 ulRecCnt );
+
   #ifdef XB_INDEX_SUPPORT
   xbIx     *pIx;             // optional index tag
   void     *vpTag;
+
+  xbUInt32 *ulpRangeRecs;    // sorted record numbers inside the index key range
+  xbUInt32 ulRangeSize;      // allocated entries in ulpRangeRecs
+  xbUInt32 ulRangeRecCnt;    // number of records in ulpRangeRecs
+  xbBool   bRangeSts;        // xbTrue if the current query uses ulpRangeRecs
+  char     cRangeMode;       // A - automatic, N - no index key range, T - only pRangeModeIx / vpRangeModeTag
+  xbIx     *pRangeModeIx;
+  void     *vpRangeModeTag;
+
+  xbInt16 BuildIxRange();
+  xbBool  GetIxRangeBounds( xbExpNode *n, xbExpNode *nKey, xbFilterRange &r ) const;
+  xbInt16 GetNextIxRangeRecord( xbUInt32 ulRecNo, xbInt16 iDirection, xbInt16 iOption );
   #endif  // XB_INDEX_SUPPORT
 
+  #ifdef XB_PARALLEL_SUPPORT
+  xbString sFilterExp;       // filter expression, parsed again for each worker thread
+  xbInt16  iParThreadCnt;    // worker threads for a parallel scan, one for none
+  xbBool   bParOrdered;      // xbTrue to return parallel matches in table order, xbFalse as found
+  xbUInt32 *ulpParRecs;      // matching records from the last parallel scan, in delivery order
+  xbUInt32 ulParRecCnt;      // number of records in ulpParRecs
+  xbInt32  lParPos;          // entry in ulpParRecs for the current record, -1 before the first
+  xbInt16  iParDirection;    // 1 - the scan started at the top of the table, -1 at the bottom
+  xbBool   bParSts;          // xbTrue if the current query uses ulpParRecs
+
+  xbInt16 GetNextParRecord( xbInt16 iDirection, xbInt16 iOption );
+  xbInt16 RunParScan( xbInt16 iDirection, xbInt16 iOption );
+  #endif  // XB_PARALLEL_SUPPORT
+
+  #ifdef XB_BLOCKREAD_SUPPORT
+  xbDouble *dpBatch;         // filter results for the records in the current read block
+  xbUInt32 ulBatchSize;      // allocated entries in dpBatch
+  xbUInt32 ulBatchFirstRec;  // first record number in dpBatch
+  xbUInt32 ulBatchRecCnt;    // number of records in dpBatch, zero if none
+
+  xbBool  GetBatchStatus() const;
+  xbInt16 GetNextBatchRecord( xbUInt32 ulRecNo, xbInt16 iOption );
+  #endif  // XB_BLOCKREAD_SUPPORT
+
 };
 }        /* namespace */
 #endif   /* XB_FILTER_SUPPORT */
@@ -69,6 +69,7 @@ The xbDbf class (and derived classes) perform the needed calls to the index rout
 See the following for examples on how to start on this:<br>
 xbIxNdx is a derived class and supports a single tag.<br>
 xbIxMdx is a derived class and supports multiple tags.<br>
+xbIxHsh is a derived class and supports multiple memory resident tags, with no index file.<br>
 
 
 
@@ -131,20 +132,28 @@ class XBDLLEXPORT xbIx : public xbFile {
    virtual xbInt16  FindKey( void *vpTag, const xbDate &dtKey, xbInt16 iRetrieveSw );
    virtual xbInt16  FindKey( void *vpTag, xbDouble dKey, xbInt16 iRetrieveSw );
    virtual xbInt16  FindKey( void *vpTag, const void *vKey, xbInt32 lKeyLen, xbInt16 iRetrieveSw ) = 0;
+   virtual xbBool   GetBloomFilter( const void *vpTag ) const;
    virtual void     *GetCurTag() const;
 
+   virtual xbInt16  GetCurKeyRecNo( void *vpTag, xbUInt32 &ulRecNo );
    virtual xbInt16  GetCurKeyVal( void *vpTag, xbString &s ) = 0;
    virtual xbInt16  GetCurKeyVal( void *vpTag, xbDouble &d ) = 0;
    virtual xbInt16  GetCurKeyVal( void *vpTag, xbDate &dt ) = 0;
 
    virtual xbDbf    *GetDbf() const;
 
+   virtual xbInt16  GetDistinctKeyCnt( void *vpTag, xbUInt32 &ulKeyCnt );
+
    virtual xbInt16  GetIxTagMode( const void *vpTag ) const = 0;
 
+   virtual xbInt16  GetKeyCnt( void *vpTag, xbUInt32 &ulKeyCnt );
+   virtual xbInt16  GetKeyCnt( void *vpTag, const xbString &sKeyPrefix, xbUInt32 &ulKeyCnt );
    virtual xbString &GetKeyExpression( const void *vpTag ) const = 0;
    virtual xbString &GetKeyFilter( const void *vpTag ) const = 0;
+   virtual xbInt32  GetKeyLen( const void *vpTag ) const = 0;
    virtual char     GetKeyType( const void *vpTag ) const = 0;
    virtual xbBool   GetLocked() const;
+   virtual xbUInt32 GetNodeReadCnt() const;
 
    virtual xbInt16  GetFirstKey( void *vpTag, xbInt16 iRetrieveSw ) = 0;
    virtual xbInt16  GetFirstKey( void *vpTag );
@@ -157,11 +166,13 @@ class XBDLLEXPORT xbIx : public xbFile {
    virtual xbInt16  GetNextKey( void *vpTag, xbInt16 iRetrieveSw ) = 0;
    virtual xbInt16  GetNextKey( void *vpTag );
    virtual xbInt16  GetNextKey();
+   virtual xbInt16  GetNextDistinctKey( void *vpTag );
 
    virtual xbInt16  GetPrevKey( void *vpTag, xbInt16 iRetrieveSw ) = 0;
    virtual xbInt16  GetPrevKey( void *vpTag );
    virtual xbInt16  GetPrevKey();
 
+   virtual xbInt16  GetTagDepth( void *vpTag, xbInt16 &iDepth );
    virtual void     *GetTag( xbInt16 iTagNo ) const = 0;
    virtual void     *GetTag( xbString &sTagName ) const = 0;
    virtual xbInt16  GetTagCount() const = 0;
@@ -175,6 +186,8 @@ class XBDLLEXPORT xbIx : public xbFile {
    virtual xbBool   GetSortOrder( void *vpTag ) const = 0;
 
    virtual xbInt16  Open( const xbString &sFileName );
+   virtual xbInt16  ProbeKey( void *vpTag, const void *vpKey, xbInt32 lKeyLen );
+   virtual xbInt16  SetBloomFilter( void *vpTag, xbBool bEnable );
    virtual xbInt16  SetCurTag( xbInt16 iTagNo ) = 0;
    virtual xbInt16  SetCurTag( xbString &sTagName ) = 0;
    virtual void     SetCurTag( void * vpCurTag );
@@ -195,6 +208,12 @@ class XBDLLEXPORT xbIx : public xbFile {
 
  protected:
    friend  class    xbDbf;
+   #ifdef XB_SQL_SUPPORT
+   friend  class    xbQryPlan;
+   #endif  // XB_SQL_SUPPORT
+   #ifdef XB_FILTER_SUPPORT
+   friend  class    xbFilter;
+   #endif  // XB_FILTER_SUPPORT
 
    virtual xbInt16  AddKey( void *vpTag, xbUInt32 ulRecNo ) = 0;
    virtual xbInt16  AddKeys( xbUInt32 ulRecNo );
@@ -215,15 +234,21 @@ class XBDLLEXPORT xbIx : public xbFile {
    virtual xbInt16  GetBlock( void *vpTag, xbUInt32 ulBlockNo, xbInt16 iOpt, xbUInt32 ulAddlBuf = 0 );
    virtual xbInt32  GetKeyCount( xbIxNode *npNode ) const;
    virtual char     *GetKeyData( xbIxNode *npNode, xbInt16 iKeyNo, xbInt16 iKeyItemLen ) const;
+   virtual xbExp    *GetKeyExp( const void *vpTag ) const;
+   virtual xbExp    *GetKeyFilterExp( const void *vpTag ) const;
    virtual xbInt16  GetKeySts( void *vpTag ) const = 0;
    virtual xbInt16  GetLastKey( xbUInt32 ulNodeNo, void *vpTag, xbInt16 lRetrieveSw ) = 0;
    virtual xbInt16  InsertNodeL( void *vpTag, xbIxNode * npNode, xbInt16 iSlotNo, char * cpKeyBuf, xbUInt32 uiPtr ) = 0;
    virtual xbInt16  InsertNodeI( void *vpTag, xbIxNode * npNode, xbInt16 iSlotNo, xbUInt32 uiPtr ) = 0;
    virtual xbInt16  KeyExists( void * ) = 0;
+   virtual xbBool   KeyUpdated( void *vpTag ) const;
    virtual void     NodeFree( xbIxNode * ixNode );
    virtual xbInt16  ReadHeadBlock( xbInt16 iOpt = 0 ) = 0;
    virtual xbInt16  ReindexTag( void **vpTag ) = 0;
+           xbInt16  RestoreTagPos( void *vpTag, char *cpSaveKey, xbUInt32 ulSaveRecNo );
+           char     *SaveTagPos( void *vpTag, xbUInt32 &ulSaveRecNo );
    virtual void     SetDbf( xbDbf *dbf );
+   virtual void     SetKeySts( void *vpTag, xbInt16 iKeySts ) = 0;
    virtual xbInt16  SetIxTagMode( void *vpTag, xbInt16 iMode ) = 0;
    virtual xbInt16  SplitNodeL( void *vpTag, xbIxNode * npLeft, xbIxNode *npRight, xbInt16 iSlotNo, char *cpKeyBuf, xbUInt32 uiPtr ) = 0;
    virtual xbInt16  SplitNodeI( void *vpTag, xbIxNode * npLeft, xbIxNode *npRight, xbInt16 iSlotNo, xbUInt32 uiPtr ) = 0;
@@ -238,11 +263,14 @@ class XBDLLEXPORT xbIx : public xbFile {
 
  private:
    virtual void     AppendNodeChain( void *vpTag, xbIxNode *npNode ) = 0;
+   virtual xbIxNode *GetCurNode( void *vpTag ) const = 0;
+   virtual xbInt16  GetKeyItemLen( const void *vpTag ) const = 0;
    virtual xbInt16  GetKeyPtr( void *vpTag, xbInt16 iKeyNo, xbIxNode *npNode, xbUInt32 &ulKeyPtr ) const = 0;
    virtual xbBool   IsLeaf( void *vpTag, xbIxNode *npNode ) const = 0;
    // virtual void     SetCurNode( void *vpTag, xbIxNode *npNode ) = 0;
 
    xbBool   bLocked;               // index file locked?
+   xbUInt32 ulNodeReads;           // nodes read from the file by GetBlock()
 };
 
 #ifdef XB_NDX_SUPPORT
@@ -316,6 +344,7 @@ class XBDLLEXPORT xbIxNdx : public xbIx {
    xbInt16  CreateTag( const xbString &sName, const xbString &sKey, const xbString &sFilter, xbInt16 iDescending, xbInt16 iUnique, xbInt16 iOverlay, void **vpTag );
    xbInt16  FindKey( void *vpTag, const void *vpKey, xbInt32 lKeyLen, xbInt16 iRetrieveSw );
 
+   xbInt16  GetCurKeyRecNo( void *vpTag, xbUInt32 &ulRecNo );
    xbInt16  GetCurKeyVal( void *vpTag, xbString &s );
    xbInt16  GetCurKeyVal( void *vpTag, xbDouble &d );
    xbInt16  GetCurKeyVal( void *vpTag, xbDate &dt );
@@ -366,6 +395,7 @@ class XBDLLEXPORT xbIxNdx : public xbIx {
    xbInt16  DeleteTag( void *vpTag );
    xbInt16  FindKeyForCurRec( void *vpTag, xbInt16 iRetrieveSw = 0 );
    xbInt16  GetKeyTypeN( const void *vpTag ) const;
+   xbExp    *GetKeyExp( const void *vpTag ) const;
    xbInt16  GetKeySts( void *vpTag ) const;
    xbInt16  GetLastKey( xbUInt32 ulNodeNo, void *vpTag, xbInt16 iRetrieveSw = 1 );
    xbInt16  InsertNodeI( void *vpTag, xbIxNode * npNode, xbInt16 iSlotNo, xbUInt32 uiPtr );
@@ -373,6 +403,7 @@ class XBDLLEXPORT xbIxNdx : public xbIx {
    xbInt16  KeyExists( void *vpTag = NULL );
    xbInt16  ReadHeadBlock(xbInt16 iOpt);   // read the header node of the disk NDX file
    xbInt16  ReindexTag( void **vpTag );
+   void     SetKeySts( void *vpTag, xbInt16 iKeySts );
    xbInt16  SplitNodeI( void *vpTag, xbIxNode * npLeft, xbIxNode *npRight, xbInt16 iSlotNo, xbUInt32 uiPtr );
    xbInt16  SplitNodeL( void *vpTag, xbIxNode * npLeft, xbIxNode *npRight, xbInt16 iSlotNo, char *cpKeyBuf, xbUInt32 uiPtr );
    xbInt16  UpdateTagKey( char cAction, void *vpTag, xbUInt32 ulRecNo = 0 );
@@ -381,7 +412,9 @@ class XBDLLEXPORT xbIxNdx : public xbIx {
  private:
    xbInt16  AddKeyNewRoot( xbNdxTag *npTag, xbIxNode *npLeft, xbIxNode *npRight );
    void     AppendNodeChain( void *vpTag, xbIxNode *npNode );
+   xbIxNode *GetCurNode( void *vpTag ) const;
    xbInt16  GetDbfPtr( void *vpTag, xbInt16 iKeyNo, xbIxNode *npNode, xbUInt32 &ulDbfPtr ) const;
+   xbInt16  GetKeyItemLen( const void *vpTag ) const;
    xbInt16  GetKeyPtr( void *vpTag, xbInt16 iKeyNo, xbIxNode *npNode, xbUInt32 &ulKeyPtr ) const;
    xbInt16  GetLastKeyForBlockNo( void *vpTag, xbUInt32 ulBlockNo, char *cpKeyBuf );
    xbBool   IsLeaf( void *vpTag, xbIxNode *npNode ) const;
@@ -464,6 +497,7 @@ struct XBDLLEXPORT xbMdxTag {
 
   xbInt16       iIxTagMode;    //  XB_IX_DBASE_MODE or XB_IX_XBASE_MODE
 
+  xbBloomFilter *bloom;        // bloom filter for negative lookups on unique tags, NULL if not enabled
 
 };
 
@@ -476,7 +510,10 @@ class XBDLLEXPORT xbIxMdx : public xbIx {
    virtual xbInt16  CreateTag( const xbString &sName, const xbString &sKey, const xbString &sFilter, xbInt16 iDescending, xbInt16 iUnique, xbInt16 iOverlay, void **vpTag );
    virtual xbInt16  FindKey( void *vpTag, const void *vKey, xbInt32 lKeyLen, xbInt16 iRetrieveSw );
    virtual xbInt16  FindKey( void *vpTag, xbDouble dKey, xbInt16 iRetrieveSw );
+   virtual xbBool   GetBloomFilter( const void *vpTag ) const;
+   virtual xbInt16  ProbeKey( void *vpTag, const void *vpKey, xbInt32 lKeyLen );
 
+   virtual xbInt16  GetCurKeyRecNo( void *vpTag, xbUInt32 &ulRecNo );
    virtual xbInt16  GetCurKeyVal( void *vpTag, xbString &s );
    virtual xbInt16  GetCurKeyVal( void *vpTag, xbDouble &d );
    virtual xbInt16  GetCurKeyVal( void *vpTag, xbDate &dt );
@@ -486,6 +523,7 @@ class XBDLLEXPORT xbIxMdx : public xbIx {
 
    virtual xbString &GetKeyExpression( const void *vpTag ) const;
    virtual xbString &GetKeyFilter( const void *vpTag ) const;
+   virtual xbInt32  GetKeyLen( const void *vpTag ) const;
    virtual char     GetKeyType( const void *vpTag ) const;
    virtual xbInt16  GetLastKey( void *vpTag, xbInt16 lRetrieveSw );
    virtual xbInt16  GetNextKey( void *vpTag, xbInt16 lRetrieveSw );
@@ -501,6 +539,7 @@ class XBDLLEXPORT xbIxMdx : public xbIx {
    virtual void     GetTagName( void *vpTag, xbString &sTagName );
 
    virtual xbInt16  GetUnique( void *vpTag ) const;
+   virtual xbInt16  SetBloomFilter( void *vpTag, xbBool bEnable );
    virtual xbInt16  SetCurTag( xbInt16 iTagNo );
    virtual xbInt16  SetCurTag( xbString &sTagName );
            void     SetReuseEmptyNodesSw( xbBool bReuse );
@@ -525,6 +564,8 @@ class XBDLLEXPORT xbIxMdx : public xbIx {
    virtual  xbInt16  DeleteTag( void *vpTag );
 
    xbInt16  FindKeyForCurRec( void *vpTag, xbInt16 iRetrieveSw = 0 );
+   xbExp    *GetKeyExp( const void *vpTag ) const;
+   xbExp    *GetKeyFilterExp( const void *vpTag ) const;
    xbInt16  GetKeySts( void *vpTag ) const;
    xbInt16  GetLastKey( xbUInt32 ulBlockNo, void *vpTag, xbInt16 lRetrieveSw );
    void     *GetTagTblPtr() const;
@@ -537,6 +578,7 @@ class XBDLLEXPORT xbIxMdx : public xbIx {
    xbInt16  LoadTagTable();
    xbInt16  ReadHeadBlock(xbInt16 iOpt);   // read the header node of the disk file
    virtual  xbInt16  ReindexTag( void **vpTag );
+   void     SetKeySts( void *vpTag, xbInt16 iKeySts );
    xbInt16  SplitNodeI( void *vpTag, xbIxNode * npLeft, xbIxNode *npRight, xbInt16 iSlotNo, xbUInt32 uiPtr );
    xbInt16  SplitNodeL( void *vpTag, xbIxNode * npLeft, xbIxNode *npRight, xbInt16 iSlotNo, char *cpKeyBuf, xbUInt32 uiPtr );
    xbInt16  UpdateTagKey( char cAction, void *vpTag, xbUInt32 ulRecNo = 0 );
@@ -589,11 +631,26 @@ class XBDLLEXPORT xbIxMdx : public xbIx {
    xbInt16  AddKeyNewRoot( xbMdxTag *npTag, xbIxNode *npLeft, xbIxNode *npRight );
    void     AppendNodeChain( void *vpTag, xbIxNode *npNode );
    xbUInt32 BlockToPage( xbUInt32 ulBlockNo );
+   xbInt16  BloomBuild( xbMdxTag *mpTag );
+   xbBool   BloomCheck( xbMdxTag *mpTag, const void *vpKey, xbInt32 lKeyLen );
+   xbInt16  BloomLoad();
+   xbInt16  BloomSave();
+   #ifdef XB_SORT_SUPPORT
+   xbInt16  BulkLoadTag( xbMdxTag *mpTag, xbSort *pSort );
+   xbInt16  BulkWriteNode( xbMdxTag *mpTag, char *cpBlock, xbInt32 lLeafCnt, xbUInt32 ulPrevPage, xbUInt32 &ulPage );
+   #endif   // XB_SORT_SUPPORT
    xbMdxTag *ClearTagTable();
    xbInt16  DumpBlock( xbInt16 iOpt, xbUInt32 ulBlockNo, xbMdxTag * mpTag );
+   void     GetBloomFileName( xbString &sBloomFileName ) const;
+   xbIxNode *GetCurNode( void *vpTag ) const;
    xbInt16  GetDbfPtr( void *vpTag, xbInt16 iKeyNo, xbIxNode *npNode, xbUInt32 &ulDbfPtr ) const;
+   xbInt16  GetKeyItemLen( const void *vpTag ) const;
    xbInt16  GetKeyPtr( void *vpTag, xbInt16 iKeyNo, xbIxNode *npNode, xbUInt32 &ulKeyPtr ) const;
    xbInt16  GetLastKeyForBlockNo( void *vpTag, xbUInt32 ulBlockNo, char *cpKeyBuf );
+   #ifdef XB_SORT_SUPPORT
+   void     GetSortKey( xbMdxTag *mpTag, xbUInt32 ulRecNo, char *cpSortKey ) const;
+   xbUInt32 GetSortKeyLen( xbMdxTag *mpTag ) const;
+   #endif   // XB_SORT_SUPPORT
    xbInt16  HarvestEmptyNode( xbMdxTag *mpTag, xbIxNode *npNode, xbInt16 iOpt, xbBool bHarvestRoot = xbFalse );
    xbBool   IsLeaf( void *vpTag, xbIxNode *npNode ) const;
    xbInt16  KeySetPosAdd( xbMdxTag *mpTag, xbUInt32 ulAddKeyRecNo );
@@ -614,6 +671,15 @@ class XBDLLEXPORT xbIxMdx : public xbIx {
 
 #ifdef XB_TDX_SUPPORT
 
+//! @brief Class for handling temporary indices.
+/*!
+The xbIxTdx class is derived from the xbIxMdx class and uses the MDX file format for
+temporary tags, which are removed when the index is closed.<br>
+
+The index is built in memory.  It is only written to a file in the temp directory if it
+grows beyond the limit set with xbXBase::SetTdxMemoryLimit().
+*/
+
 class XBDLLEXPORT xbIxTdx : public xbIxMdx {
  public:
    xbIxTdx( xbDbf * d );
@@ -632,6 +698,153 @@ class XBDLLEXPORT xbIxTdx : public xbIxMdx {
 #endif   /* XB_TDX_SUPPORT  */
 
 
+#ifdef XB_HSH_SUPPORT
+
+///@cond DOXYOFF
+struct XBDLLEXPORT xbHshEntry {
+  xbHshEntry *npNext;        // next entry in the bucket chain
+  xbUInt32   ulHash;         // hash value of the key
+  xbUInt32   ulRecNo;        // dbf record number
+  char       *cpKey;         // key data, allocated in the same block as the entry
+};
+
+struct XBDLLEXPORT xbHshTag {
+  xbString   *sTagName;      // tag name
+  xbString   *sKeyExp;       // key expression
+  xbString   *sFiltExp;      // filter expression, NULL if no filter
+  xbExp      *exp;           // pointer to expression for expression keys
+  xbExp      *filter;        // pointer to expression for index filter
+  char       cKeyType;       // C = Char, F = Numeric, D = Date
+  xbInt16    iKeyLen;        // length of key data
+  xbBool     bUnique;        // xbTrue if unique
+  xbInt16    iIxTagMode;     // XB_IX_DBASE_MODE or XB_IX_XBASE_MODE
+  char       *cpKeyBuf;      // key buffer, for searches and adds
+  char       *cpKeyBuf2;     // key buffer, for deletes
+  char       *cpSearchBuf;   // key buffer, for padding short search keys
+  xbInt16    iKeySts;        // key updated?  set in method CreateKey, checked in AddKeys and DeleteKeys
+  xbBool     bFoundSts;      // key found?  used to determine if new key should be added in XB_IX_DBASE_MODE in AddKey
+
+  xbHshEntry **npBuckets;    // bucket array
+  xbUInt32   ulBucketCnt;    // number of buckets, always a power of two
+  xbUInt32   ulKeyCnt;       // number of entries in the tag
+  xbHshEntry *npCurEntry;    // current position, NULL if not positioned
+  xbHshTag   *next;
+};
+///@endcond DOXYOFF
+
+
+//! @brief Class for handling memory resident hash indices.
+/*!
+
+The xbIxHsh class is derived from the xbIx base class and keeps one or more tags in memory, with
+no associated file.  Each tag is a chained hash table of key / record number entries, built from
+the table when the tag is created and maintained by the dbf class as records are added and updated,
+in the same manner as the disk based indices.<br>
+
+Key lookups are exact match only and run in constant time.  Character search keys shorter than the
+key length are padded with spaces.  Numeric keys are stored as xbDouble and date keys as julian xbDouble.<br>
+
+Keys can be traversed with the GetFirstKey, GetNextKey, GetPrevKey and GetLastKey methods.
+Entries with the same key value are adjacent, in record number order, but the order of distinct
+key values is not defined.<br>
+
+The tags are lost when the table is closed.  Updates made by other processes are not seen, so
+hash tags are intended for single user tables, or tables not updated while the tag is in use.
+
+*/
+
+class XBDLLEXPORT xbIxHsh : public xbIx {
+ public:
+   xbIxHsh( xbDbf * d );
+   ~xbIxHsh();
+
+   xbInt16  CheckTagIntegrity( void *vpTag, xbInt16 iOpt );
+   xbInt16  Close();
+   xbInt16  CreateTag( const xbString &sName, const xbString &sKey, const xbString &sFilter, xbInt16 iDescending, xbInt16 iUnique, xbInt16 iOverlay, void **vpTag );
+   xbInt16  FindKey( void *vpTag, const void *vpKey, xbInt32 lKeyLen, xbInt16 iRetrieveSw );
+
+   xbInt16  GetCurKeyVal( void *vpTag, xbString &s );
+   xbInt16  GetCurKeyVal( void *vpTag, xbDouble &d );
+   xbInt16  GetCurKeyVal( void *vpTag, xbDate &dt );
+
+   xbInt16  GetDistinctKeyCnt( void *vpTag, xbUInt32 &ulKeyCnt );
+   xbInt16  GetFirstKey( void *vpTag, xbInt16 iRetrieveSw );
+   xbInt16  GetIxTagMode( const void *vpTag ) const;
+   xbInt16  GetKeyCnt( void *vpTag, xbUInt32 &ulKeyCnt );
+   xbInt16  GetKeyCnt( void *vpTag, const xbString &sKeyPrefix, xbUInt32 &ulKeyCnt );
+   xbString &GetKeyExpression( const void *vpTag ) const;
+   xbString &GetKeyFilter( const void *vpTag ) const;
+   xbInt32  GetKeyLen( const void *vpTag ) const;
+   char     GetKeyType( const void *vpTag ) const;
+   xbInt16  GetLastKey( void *vpTag, xbInt16 iRetrieveSw );
+   xbInt16  GetNextDistinctKey( void *vpTag );
+   xbInt16  GetNextKey( void *vpTag, xbInt16 iRetrieveSw );
+   xbInt16  GetPrevKey( void *vpTag, xbInt16 iRetrieveSw );
+   xbBool   GetSortOrder( void *vpTag ) const;
+   void     *GetTag( xbInt16 iTagNo ) const;
+   void     *GetTag( xbString &sTagName ) const;
+   xbInt16  GetTagCount() const;
+   xbString &GetTagName( void *vpTag ) const;
+   const char * GetTagName( void *vpTag, xbInt16 iOpt ) const;
+   void     GetTagName( void *vpTag, xbString &sTagName );
+   xbBool   GetUnique( void *vpTag ) const;
+
+   xbInt16  SetCurTag( xbInt16 iTagNo );
+   xbInt16  SetCurTag( xbString &sTagName );
+   xbInt16  SetIxTagMode( void *vpTag, xbInt16 iMode );
+
+   #ifdef XB_DEBUG_SUPPORT
+   xbInt16  DumpHeader( xbInt16 iOpt = 0, xbInt16 iFmtOpt = 0 );
+   xbInt16  DumpIxForTag( void *vpTag, xbInt16 iOutputOpt );
+   void     DumpIxNodeChain( void *vpTag, xbInt16 iOutputOpt ) const;
+   xbInt16  DumpTagBlocks( xbInt16 iOpt = 1, void *vpTag = NULL );
+   #endif
+
+ protected:
+   friend   class xbDbf;
+   xbInt16  AddKey( void *vpTag, xbUInt32 ulRecNo );
+   xbInt16  CheckForDupKey( void *vpTag );
+   xbInt16  CreateKey( void *vpTag, xbInt16 iOpt );
+   xbInt16  DeleteFromNode( void *vpTag, xbIxNode *npNode, xbInt16 iSlotNo );
+   xbInt16  DeleteKey( void *vpTag );
+   xbInt16  DeleteTag( void *vpTag );
+   xbInt16  FindKeyForCurRec( void *vpTag, xbInt16 iRetrieveSw = 0 );
+   xbExp    *GetKeyExp( const void *vpTag ) const;
+   xbExp    *GetKeyFilterExp( const void *vpTag ) const;
+   xbInt16  GetKeySts( void *vpTag ) const;
+   xbInt16  GetLastKey( xbUInt32 ulNodeNo, void *vpTag, xbInt16 iRetrieveSw );
+   xbInt16  InsertNodeI( void *vpTag, xbIxNode *npNode, xbInt16 iSlotNo, xbUInt32 uiPtr );
+   xbInt16  InsertNodeL( void *vpTag, xbIxNode *npNode, xbInt16 iSlotNo, char *cpKeyBuf, xbUInt32 uiPtr );
+   xbInt16  KeyExists( void *vpTag );
+   xbInt16  ReadHeadBlock( xbInt16 iOpt );
+   xbInt16  ReindexTag( void **vpTag );
+   void     SetKeySts( void *vpTag, xbInt16 iKeySts );
+   xbInt16  SplitNodeI( void *vpTag, xbIxNode *npLeft, xbIxNode *npRight, xbInt16 iSlotNo, xbUInt32 uiPtr );
+   xbInt16  SplitNodeL( void *vpTag, xbIxNode *npLeft, xbIxNode *npRight, xbInt16 iSlotNo, char *cpKeyBuf, xbUInt32 uiPtr );
+   xbInt16  UpdateTagKey( char cAction, void *vpTag, xbUInt32 ulRecNo = 0 );
+   xbInt16  WriteHeadBlock( xbInt16 iOption );
+
+ private:
+   void     AppendNodeChain( void *vpTag, xbIxNode *npNode );
+   void     BuildKey( xbHshTag *hpTag, char *cpKeyBuf );
+   void     ClearEntries( xbHshTag *hpTag );
+   xbHshEntry *FindEntry( xbHshTag *hpTag, const char *cpKey, xbUInt32 ulRecNo ) const;
+   void     FreeTag( xbHshTag *hpTag );
+   xbIxNode *GetCurNode( void *vpTag ) const;
+   xbInt16  GetKeyItemLen( const void *vpTag ) const;
+   xbInt16  GetKeyPtr( void *vpTag, xbInt16 iKeyNo, xbIxNode *npNode, xbUInt32 &ulKeyPtr ) const;
+   xbUInt32 Hash( const char *cpKey, xbInt16 iKeyLen ) const;
+   xbBool   IsLeaf( void *vpTag, xbIxNode *npNode ) const;
+   xbInt16  PositionTo( xbHshTag *hpTag, xbHshEntry *npEntry, xbInt16 iRetrieveSw );
+   xbInt16  Resize( xbHshTag *hpTag, xbUInt32 ulNewBucketCnt );
+
+   xbHshTag *hshTagTbl;
+   xbInt16  iTagUseCnt;
+};
+
+#endif   /* XB_HSH_SUPPORT  */
+
+
   }         /* namespace xb     */
  #endif     /* XB_INDEX_SUPPORT */
 #endif      /* __XB_INDEX_H__   */
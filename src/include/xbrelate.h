@@ -28,8 +28,39 @@ namespace xb{
 //#define XB_REL_NF_OPT 2
 //#define XB_REL_NF_REQ 3
 
+// largest child table hashed when the join type is chosen automatically
+#define XB_REL_HASH_MAX_RECS 1000000
+
+// child tag keys stepped over to reach the next parent key, before falling back to a key search
+#define XB_REL_MERGE_MAX_STEPS 32
+
+// default number of parent keys held in each child lookup cache, see SetCacheSize()
+#define XB_REL_CACHE_SIZE 16
+
+// keys with more child records than this are not cached
+#define XB_REL_CACHE_MAX_RECS 256
+
+// default number of master records read ahead for child key prefetch, see SetPrefetchWindow()
+#define XB_REL_PREFETCH_WINDOW 64
+
+// most child record bytes held in the cache from one prefetch, for each child table
+#define XB_REL_PREFETCH_MAX_BYTES 1048576
+
 ///@cond DOXYOFF
 
+struct XBDLLEXPORT xbRelCacheEntry {
+  xbBool       bValid;
+  xbString   * sKey;        // character key
+  xbDouble     dKey;        // numeric key, or julian date for date keys
+  xbUInt32   * ulpRecs;     // child record numbers in key order
+  xbUInt32     ulRecCnt;
+  xbUInt32     ulRecSize;   // allocated entries in ulpRecs
+  xbUInt32     ulUseSeq;    // last use, least recently used entry is replaced
+  char       * cpRecData;   // prefetched child record images, in ulpRecs order
+  xbUInt32     ulDataCnt;   // records in cpRecData, 0 or ulRecCnt
+  xbUInt32     ulDataSize;  // allocated bytes in cpRecData
+};
+
 struct XBDLLEXPORT xbRelation{
 
   xbRelation * pParent;
@@ -43,8 +74,60 @@ struct XBDLLEXPORT xbRelation{
   xbUInt32     ulSaveParRecNo;
 
   xbDbf      * dDbf;
+
+  //! Index tag used for child key lookups, either pKeyIx / pKeyTag or pHshIx / pHshTag
   xbIx       * pIx;
   void       * pTag;
+
+  //! Index tag the relation was added with, NULL if linked on sChildExpression
+  xbIx       * pKeyIx;
+  void       * pKeyTag;
+
+  //! Child key expression, for relations added without an index tag
+  xbString   * sChildExpression;
+
+  //! Join type for the current query, I - index lookup, H - hash lookup, 0 - not chosen yet
+  char         cJoin;
+
+  //! Join mode for this child table, A - automatic, I - index join, H - hash join, 0 - use the xbRelate join mode
+  char         cJoinMode;
+
+  #ifdef XB_HSH_SUPPORT
+  //! Memory resident hash of the child keys, for hash joins
+  xbIx       * pHshIx;
+  void       * pHshTag;
+
+  //! Child table change sequence and record count the hash was built at
+  xbUInt32     ulHshSeq;
+  xbUInt32     ulHshRecCnt;
+  #endif  // XB_HSH_SUPPORT
+
+  //! Merge join state, the child tag cursor record and the child table change sequence
+  //! it was positioned at.  ulMrgRecNo is 0 when the cursor position is not known.
+  xbUInt32     ulMrgRecNo;
+  xbUInt32     ulMrgSeq;
+
+  //! Last parent key the child tag cursor was positioned for, and the lookup status for it
+  xbString   * sMrgKey;
+  xbDouble     dMrgKey;
+  xbDate     * dtMrgKey;
+  xbInt16      iMrgKeySts;
+
+  //! Child lookup cache, the last parent keys looked up and their child record numbers
+  xbRelCacheEntry * cpCache;
+  xbInt16      iCacheCnt;       // allocated entries in cpCache
+  xbUInt32     ulCacheSeq;      // child table change sequence the entries are valid for
+  xbUInt32     ulCacheUse;      // use counter for ulUseSeq
+  xbRelCacheEntry * cpCacheHit; // entry the current child records are read from
+  xbUInt32     ulCachePos;      // position in cpCacheHit
+  xbRelCacheEntry * cpCacheFill;// entry being filled from the child tag
+  char         cCacheFill;      // F - filling forward, L - filling backward
+  xbUInt64     ullCacheLookups;
+  xbUInt64     ullCacheHits;
+
+  //! Last master record read ahead for child key prefetch
+  xbUInt32     ulPfchRecNo;
+
   xbString   * sFilter;
   char         cType;     // M - Master
                           // O - Optional
@@ -81,6 +164,16 @@ The xbRelate class is used define master / slave relationships between tables
 <li>There is a one to many relationship between master and slave relationships.
 <li>After the relationships are established, using the GetFirstRelRecord(), GetNextRelRecord(), GetLastRelRecord() and GetPrevRelRecord() 
 are used to navigate thtough the data.
+<li>Child records are found either with an index lookup on the child tag for each parent record, or with a memory resident
+hash of the child keys built in one pass through the child table.  See SetJoinMode().
+<li>With index lookups, when GetNextRelRecord() moves to a parent key past the previous one, the child tag is stepped forward
+from where the last parent's child records ended instead of searched from the top.  When parent and child tables are in the
+same key order, the relation is read in one pass through both.
+<li>The child record numbers for the last few parent keys are cached for each child table, so consecutive parent records
+with the same key don't repeat the child lookup.  See SetCacheSize() and GetCacheStats().
+<li>When GetNextRelRecord() walks the master table, the child keys of the next few master records are read ahead and
+looked up together in child tag order, then their child records are read in record number order and held in the cache.
+See SetPrefetchWindow().
 
 </ul>
 
@@ -140,6 +233,31 @@ class XBDLLEXPORT xbRelate {
       const xbString &sFilter = ""        // optional child record filter
   );
 
+  #ifdef XB_HSH_SUPPORT
+  //! @brief Add a relationship linked on a child key expression.
+  /*!
+    Same as AddRelation(), for a child table with no index tag on the link key.
+    The child records are always found with a hash join, see SetJoinMode().
+
+    @param dParent Pointer to parent/master table.
+    @param sParentExpression Parent table expression that links to the child table.
+    @param dChild Pointer to child/slave table.
+    @param sChildExpression Child table expression that links to the parent table.
+           Must return the same type as sParentExpression.
+    @param cType O = Optional (left join)<br>R = Required (inner join)
+    @param sFilter Optional child record filter.
+    @returns <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 AddRelationExp( 
+      xbDbf *dParent,                     // parent table
+      const xbString &sParentExpression,  // parent expression, needs to match sChildExpression
+      xbDbf *dChild,                      // child table 
+      const xbString &sChildExpression,   // child key expression
+      char cType = 'O',                   // O = Optional, R = required
+      const xbString &sFilter = ""        // optional child record filter
+  );
+  #endif  // XB_HSH_SUPPORT
+
   //! @brief Check Table Status.
   /*!
     @private
@@ -200,6 +318,92 @@ class XBDLLEXPORT xbRelate {
   */
   xbInt16 GetPrevRelRecord();
 
+  //! @brief Get child lookup cache size.
+  /*!
+    @returns Number of parent keys cached for each child table.
+  */
+  xbInt16 GetCacheSize() const;
+
+  //! @brief Get child lookup cache statistics.
+  /*!
+    @param dChild Pointer to child/slave table, or NULL for the totals of all child tables.
+    @param ullLookups Output - number of child key lookups.
+    @param ullHits Output - number of child key lookups answered from the cache.
+    @returns <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 GetCacheStats( xbDbf *dChild, xbUInt64 &ullLookups, xbUInt64 &ullHits );
+
+  //! @brief Get join mode.
+  /*!
+    @returns Current join mode, see SetJoinMode().
+  */
+  char    GetJoinMode() const;
+
+  //! @brief Get the join type used for a child table.
+  /*!
+    @param dChild Pointer to child/slave table.
+    @returns I - Child records are found with an index lookup.<br>
+             H - Child records are found with a hash lookup.<br>
+             0 - Not a child table in this relation, or no lookup made yet in the current query.
+  */
+  char    GetJoinType( xbDbf *dChild );
+
+  //! @brief Get child key prefetch window.
+  /*!
+    @returns Number of master records read ahead, see SetPrefetchWindow().
+  */
+  xbInt16 GetPrefetchWindow() const;
+
+  //! @brief Reset child lookup cache statistics.
+  void    ResetCacheStats();
+
+  //! @brief Set child lookup cache size.
+  /*!
+    Each child table keeps the child record numbers for the last iEntries parent keys looked up.
+    Keys with more than XB_REL_CACHE_MAX_RECS child records are not cached.  The cache for a child
+    table is cleared when the child table is updated through the same table object, and at each
+    GetFirstRelRecord() or GetLastRelRecord(), so updates made between queries through another table
+    object or by another process are seen by the next query.<br>
+    A new size takes effect at the next GetFirstRelRecord() or GetLastRelRecord().
+
+    @param iEntries Number of parent keys to cache, 0 turns the cache off.  Default is XB_REL_CACHE_SIZE.
+    @returns <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 SetCacheSize( xbInt16 iEntries );
+
+  //! @brief Set join mode.
+  /*!
+    Sets how child records are found for each parent record.  The join type is chosen for each child
+    table at the first lookup after GetFirstRelRecord() or GetLastRelRecord().<br>
+
+    An index join does an index key search on the child tag for each parent record.<br>
+
+    A hash join reads the child table once per query and keeps a memory resident hash of the child keys,
+    which is then probed for each parent record.  The hash is built again at the first lookup after
+    GetFirstRelRecord() or GetLastRelRecord(), and at the next lookup after the child table is updated
+    through the same table object.  Child tables added with AddRelationExp() are always hash joined.
+
+    @param cJoinMode A - Automatic.  Hash join a child table when it has no more records than its parent table,
+                         up to XB_REL_HASH_MAX_RECS records, and the child tag is not unique.  For a parent
+                         table with a filter, the child table is compared with the number of records the
+                         filter is estimated to return, see xbFilter::GetEstimatedRecCnt().  Default setting.<br>
+                     I - Index join every child table added with an index tag.<br>
+                     H - Hash join every child table.
+    @returns <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 SetJoinMode( char cJoinMode );
+
+  //! @brief Set join mode for one child table.
+  /*!
+    Overrides the join mode set with SetJoinMode( char ) for a single child table.
+
+    @param dChild Pointer to child/slave table.
+    @param cJoinMode A - Automatic, I - Index join, H - Hash join, see SetJoinMode( char ).<br>
+                     0 - Use the join mode for the relation.
+    @returns <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 SetJoinMode( xbDbf *dChild, char cJoinMode );
+
   //! @brief Set Master Table for an xbRelation.
   /*!
 
@@ -212,6 +416,34 @@ class XBDLLEXPORT xbRelate {
   */
   xbInt16 SetMaster( xbDbf * dTbl, const xbString &sFilter = "" );
 
+  #ifdef XB_INDEX_SUPPORT
+  //! @brief Set index range option for the master table filter.
+  /*!
+    @param cRangeMode A - Automatic, N - No index key range, T - Only the given tag, see xbFilter::SetIxRange().
+    @param pIx Pointer to index file, for option T.
+    @param vpTag Pointer to tag, for option T.
+    @returns <a href="xbretcod_8h.html">Return Codes</a><br>
+             XB_NOT_OPEN - SetMaster() has not been called with a filter.
+  */
+  xbInt16 SetMasterIxRange( char cRangeMode, xbIx *pIx = NULL, void *vpTag = NULL );
+  #endif  // XB_INDEX_SUPPORT
+
+  //! @brief Set child key prefetch window.
+  /*!
+    When a child key lookup under an unfiltered master table is not found in the child lookup cache,
+    the keys of up to iRecs master records past the current one are read ahead.  Keys not already
+    cached are looked up in child tag order, one cache entry each, and the child records found
+    are read in record number order and kept with the cache entry, up to XB_REL_PREFETCH_MAX_BYTES.
+    Later master records with those keys then read their child records from memory.<br>
+
+    Prefetch is used for index joined child tables with no child filter, and needs the child lookup
+    cache, see SetCacheSize().  Child record images are not kept for tables opened in multi user mode.
+
+    @param iRecs Number of master records to read ahead, 0 turns prefetch off.  Default is XB_REL_PREFETCH_WINDOW.
+    @returns <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 SetPrefetchWindow( xbInt16 iRecs );
+
   #ifdef XB_DEBUG_SUPPORT
 
   ///@cond
@@ -228,6 +460,17 @@ class XBDLLEXPORT xbRelate {
  protected:
 
   ///@cond
+  void    CacheFill( xbRelation *pRel, char cFL );
+  void    CacheFillStart( xbRelation *pRel, char cFL, xbString &s, xbDouble &d, xbDate &dt );
+  void    CacheFree( xbRelation *pRel );
+  xbInt16 CacheLookup( xbRelation *pRel, char cFL, xbString &s, xbDouble &d, xbDate &dt, xbBool &bHit );
+  xbInt16 CacheRead( xbRelation *pRel );
+  xbInt16 CacheStep( xbRelation *pRel, char cDir );
+  xbInt16 AddRelationNode( xbDbf *dParent, const xbString &sParentExpression, xbDbf *dChild, xbIx *pChildIx, void *pChildTag,
+                           const xbString &sChildExpression, char cType, const xbString &sFilter );
+  #ifdef XB_HSH_SUPPORT
+  xbInt16 BuildJoinHash( xbRelation *pRel, xbBool bRebuild );
+  #endif  // XB_HSH_SUPPORT
   xbInt16 CompareKeys( xbRelation *pRel, xbString &s1, xbString &s2, xbDouble &d1, xbDouble &d2, xbDate &dt1, xbDate &dt2 );
   xbLinkListNode<xbRelation *> *FindNodeForDbf( xbDbf * d );
   xbLinkListNode<xbRelation *> *GetLastTreeNode( xbLinkListNode<xbRelation *> *lln );
@@ -240,11 +483,19 @@ class XBDLLEXPORT xbRelate {
   xbInt16 GetParentRelKeys( xbRelation *pRel, xbString &s, xbDouble &d, xbDate &dt );
   xbInt16 GetChildRelKeys( xbRelation *pRel, xbString &s, xbDouble &d, xbDate &dt );
   xbInt16 InitQuery();
+  xbInt16 MergeKeySearch( xbRelation *pRel, xbString &s, xbDouble &d, xbDate &dt, xbBool &bDone );
+  xbInt16 OrderKeys( xbRelation *pRel, xbString &s1, xbString &s2, xbDouble &d1, xbDouble &d2, xbDate &dt1, xbDate &dt2 );
+  xbInt16 PrefetchChildKeys( xbRelation *pRel, xbString &s, xbDouble &d, xbDate &dt );
   xbInt16 RelKeySearch( xbRelation *pRel, const char cFL,  xbString &s, xbDouble &d, xbDate &dt );
+  xbInt16 SetJoinType( xbRelation *pRel );
+  void    SetMergeKey( xbRelation *pRel, xbString &s, xbDouble &d, xbDate &dt );
   ///@endcond
 
  private:
   xbXBase    *xbase;       // pointer to main structures
+  char       cJoinMode;    // A - automatic, I - index join, H - hash join
+  xbInt16    iCacheSize;   // parent keys cached for each child table
+  xbInt16    iPrefetchWindow;  // master records read ahead for child key prefetch
 
   xbLinkList<xbRelation *> llQryTree;   // pointer to structured tree of linked lists
   xbLinkList<xbRelation *> llQryList;   // linked list of relations used by the query routines
@@ -0,0 +1,131 @@
+/*  xbsort.h
+
+XBase64 Software Library
+
+Copyright (c) 1997,2003,2014,2022,2023,2024 Gary A Kunkel
+
+The xb64 software library is covered under the terms of the GPL Version 3, 2007 license.
+
+Email Contact:
+
+    XDB-devel@lists.sourceforge.net
+    XDB-users@lists.sourceforge.net
+
+*/
+
+#ifndef __XB_SORT_H__
+#define __XB_SORT_H__
+#ifdef XB_SORT_SUPPORT
+
+namespace xb{
+
+#define XB_SORT_MERGE_ORDER    64      // maximum number of runs merged in one pass
+#define XB_SORT_SMALL_CNT      24      // buckets smaller than this are insertion sorted
+
+
+//! @brief Class for sorting fixed length records, in memory or with temp files.
+/*!
+  Each record is a key, compared byte for byte, followed by an optional data area that
+  is carried along with the key.  The key encoding routines turn numeric, date and character
+  values into keys that sort correctly with a byte compare, so a multi column sort is a
+  series of encoded values laid end to end.<br>
+
+  Records are collected in memory until the memory limit is reached.  The buffer is then
+  sorted with a most significant byte first radix sort, and appended to a temp file as a sorted run.
+  When all records are in, the runs are merged with a loser tree, up to XB_SORT_MERGE_ORDER
+  runs at a time.  If the records fit in memory, nothing is written to disk.<br>
+
+  The sort is stable, records with equal keys come out in the order they were added.  In unique
+  mode, only the first record added for each key is kept.<br>
+
+  After the sort, the records are read back in order with GetNext().  If the sort is done with
+  random access turned on, any record can be read by position with GetRec().  A sort with more
+  than one run is merged down to a single run to allow that.
+*/
+
+class XBDLLEXPORT xbSort {
+ public:
+   xbSort( xbXBase *x );
+   ~xbSort();
+
+   xbInt16  Add( const char *cpKey, const char *cpData = NULL );
+   void     Close();
+   xbUInt32 GetMemoryLimit() const;
+   xbInt16  GetNext( const char **cpRec );
+   xbInt16  GetRec( xbUInt64 ullRecNo, const char **cpRec );
+   xbUInt64 GetRecCnt() const;
+   xbUInt32 GetRunCnt() const;
+   xbInt16  Init( xbUInt32 ulKeyLen, xbUInt32 ulDataLen, xbBool bUnique = xbFalse );
+   xbInt16  Rewind();
+   void     SetMemoryLimit( xbUInt32 ulMemLimit );
+   xbInt16  Sort( xbBool bRandomAccess = xbFalse );
+
+   static void PutKeyChar  ( char *cpTrg, const char *cpSrc, xbUInt32 ulLen, xbBool bDescending = xbFalse );
+   static void PutKeyDouble( char *cpTrg, xbDouble d, xbBool bDescending = xbFalse );
+   static void PutKeyUInt32( char *cpTrg, xbUInt32 ul, xbBool bDescending = xbFalse );
+
+ private:
+   struct xbSortRun {
+     xbUInt64 ullStart;       // first record of the run in the run file
+     xbUInt64 ullRecCnt;      // records in the run
+     xbUInt64 ullRecsRead;    // records of the run read so far
+     char     *cpBuf;         // read buffer
+     xbUInt32 ulBufMax;       // records the read buffer holds
+     xbUInt32 ulBufCnt;       // records in the read buffer
+     xbUInt32 ulBufPos;       // next record in the read buffer
+     xbSortRun *next;
+   };
+
+   xbInt16  AddRun( xbUInt64 ullRecCnt );
+   xbInt16  FillRunBuf( xbSortRun *r );
+   void     FreeRun( xbSortRun *r );
+   void     InsertionSort( char **cpRecs, xbUInt32 ulCnt, xbUInt32 ulOffset );
+   xbBool   LtBeats( xbInt32 lRun1, xbInt32 lRun2 ) const;
+   void     LtAdjust( xbInt32 lRun );
+   xbInt16  MergeInit( xbSortRun *rFirst, xbUInt32 ulRunCnt );
+   xbInt16  MergeNext( const char **cpRec );
+   xbInt16  MergePass();
+   void     MergeTerm();
+   xbInt16  OpenRunFile( xbFile **fOut );
+   xbInt16  RadixSort( char **cpRecs, char **cpTemp, xbUInt32 ulCnt, xbUInt32 ulOffset );
+   xbInt16  SortBuf();
+   xbInt16  WriteRun();
+
+   xbXBase  *xbase;
+   xbUInt32 ulKeyLen;         // bytes of key at the front of each record
+   xbUInt32 ulRecLen;         // key plus data bytes
+   xbBool   bUnique;          // keep only the first record for each key
+   xbUInt32 ulMemLimit;       // bytes of memory for the record buffer
+   char     cStatus;          // ' ' - not initialized, 'A' - adding records, 'S' - sorted
+
+   char     *cpRecBuf;        // records as added
+   char     **cpRecs;         // record pointers, in key order after SortBuf()
+   char     **cpTemp;         // work area for the radix sort
+   xbUInt32 ulBufMax;         // records that fit in the memory limit
+   xbUInt32 ulBufSize;        // records the record buffer holds now
+   xbUInt32 ulBufCnt;         // records in the record buffer
+   xbUInt32 ulSortCnt;        // records in cpRecs, less any unique duplicates
+
+   xbFile   *fRuns;           // temp file holding the sorted runs, end to end
+   xbUInt64 ullRunFileCnt;    // records in the run file
+   xbSortRun *rRuns;          // sorted runs in the run file, in the order written
+   xbSortRun *rLastRun;       // end of the run list
+   xbUInt32 ulRunCnt;         // number of runs in rRuns
+   xbUInt32 ulRunsWritten;    // total runs written, including the runs of any merge passes
+   xbUInt64 ullRecCnt;        // records added, or records in the output once sorted
+
+   xbSortRun **rMerge;        // runs being merged
+   xbInt32  *lpTree;          // loser tree, lpTree[0] is the current winner
+   xbInt32  lMergeCnt;        // number of runs being merged
+   xbInt32  lLastWinner;      // run of the last record returned, moved forward on the next call
+   char     *cpLastKey;       // last key returned from a unique merge
+   xbBool   bHaveLastKey;
+
+   xbBool   bRandomAccess;    // sorted output can be read by position
+   xbSortRun *rOut;           // the one run left, for random access to a multi run sort
+   xbUInt64 ullPos;           // next record for GetNext()
+};
+
+}        /* namespace xb    */
+#endif   /* XB_SORT_SUPPORT */
+#endif   /* __XB_SORT_H__ */
@@ -28,6 +28,20 @@ This class manages a list of open tables, open indices are connected to the open
 
 namespace xb{
 
+// records read from a table to estimate the selectivity of a where clause, a key range or a join key
+#define XB_PLAN_SAMPLE_RECS 256
+
+// planner costs, in units of one record read in record number order
+#define XB_PLAN_COST_SCAN        1.0     // read the next record in the table
+#define XB_PLAN_COST_FETCH       3.0     // read a record by record number, out of order
+#define XB_PLAN_COST_NODE        2.0     // read an index node on the way to a key
+#define XB_PLAN_COST_KEY         0.1     // step to the next key on an index leaf
+#define XB_PLAN_COST_HASH_BUILD  0.5     // add a child key to the join hash
+#define XB_PLAN_COST_HASH_PROBE  0.2     // look up a parent key in the join hash
+
+// selectivity used for a where clause that can't be estimated from the master table
+#define XB_PLAN_DEFAULT_SEL      0.33
+
 ///@cond
 
 struct XBDLLEXPORT xbSqlFld{
@@ -40,10 +54,21 @@ struct XBDLLEXPORT xbSqlFld{
   xbExp *  pExp;       // If cType=E, pointer to parsed expression
   xbString sFldAlias;  // Alias name for query display
   xbString sLiteral;   // For type L - Literal value
+  xbString sExp;       // For type E - dBASE expression, used to sort on the column
   xbSqlFld * Next;     // Next field in list
 };
 
+#ifdef XB_SORT_SUPPORT
+struct XBDLLEXPORT xbSqlSortCol{        // one column of the sort key for ORDER BY and DISTINCT
+  xbExp    *pExp;      // expression evaluated for each row
+  xbBool   bDescending;
+  xbSqlSortCol *Next;
+};
+#endif  // XB_SORT_SUPPORT
+
 class xbStmt;
+struct xbTblJoin;
+class xbQryPlan;
 
 class XBDLLEXPORT xbCursor : public xbCore {
 
@@ -51,10 +76,33 @@ class XBDLLEXPORT xbCursor : public xbCore {
              xbCursor( xbXBase * x );
              ~xbCursor();
 
+    xbInt16  Close();
+    xbInt16  Fetch( char cDirection );   // F - First, N - Next, P - Prev, L - Last
+    xbBool   GetWherePushed() const;
+    xbInt16  Open( xbTblJoin *pTblList, const xbString &sWhere, const xbQryPlan *pPlan = NULL );
+    #ifdef XB_SORT_SUPPORT
+    xbInt16  SortRows( const xbSqlSortCol *pCols, xbBool bDistinct );
+    #endif  // XB_SORT_SUPPORT
+
   protected:
     xbXBase *xbase;              /* pointer to the main structures                       */
 
   private:
+    xbBool   WhereIsMasterOnly() const;
+    #ifdef XB_SORT_SUPPORT
+    xbInt16  FetchSorted( char cDirection );
+
+    xbTblJoin *pTbls;            // table list, to position each table to a sorted row
+    xbSort   *pSort;             // sorted rows, NULL until SortRows() is done
+    xbUInt32 ulSortKeyLen;       // sort key bytes in front of the record numbers in each sorted row
+    xbUInt64 ullRow;             // current sorted row
+    #endif  // XB_SORT_SUPPORT
+
+    xbDbf    *dMaster;           // master table, first entry in the table list
+    xbRelate *pRel;              // relation built from the join list, master first
+    xbExp    *pWhere;            // where clause checked per row, NULL if none or pushed to the master filter
+    xbBool   bWherePushed;       // where clause is handled by the master table filter
+    char     cPos;               // ' ' - not positioned, 'R' - on a row
 };
 
 
@@ -64,9 +112,10 @@ struct XBDLLEXPORT xbTblJoin {            //  structure for defining joined tabl
   xbString sTableName;
   xbString sAlias;
   xbString sJoinExp;                      // table join expression
+  xbString sParentExp;                    // parent side of the join expression
+  xbString sChildExp;                     // this table's side of the join expression
   xbDbf    *pDbf;                         // pointer the the dbf structure for this table
   xbTag    *pTag;                         // pointer to relevant tag for this table, null for record order
-  xbExp    *pLinkExp;                     // pointer to parsed linkage expression
   char     cJoinType;                     // M - Master
                                           // L - Left   or Full Left
                                           // R - Right  or Full Right
@@ -80,6 +129,71 @@ struct XBDLLEXPORT xbTblJoin {            //  structure for defining joined tabl
 };
 
 
+struct XBDLLEXPORT xbPlanStep {          //  access path chosen for one table in the query
+
+  xbTblJoin *pTj;                         // table for this step
+  char      cAccess;                      // S - full scan
+                                          // R - index range scan
+                                          // I - index nested loop join
+                                          // H - hash join
+  xbIx      *pIx;                         // tag used by the step, NULL for a full scan or a hash join without a tag
+  void      *vpTag;
+  xbString  sTagName;
+  xbDouble  dLookups;                     // parent rows this table is joined for, 0 for the master table
+  xbDouble  dRows;                        // estimated rows after this step
+  xbDouble  dCost;                        // estimated cost of this step
+};
+
+
+struct XBDLLEXPORT xbPlanTagStats {       //  tag statistics, kept until the table changes
+
+  xbIx      *pIx;
+  void      *vpTag;
+  xbUInt32  ulChangeSeq;                  // table change sequence and record count the counts were taken at
+  xbUInt32  ulRecCnt;
+  xbUInt32  ulKeyCnt;
+  xbUInt32  ulDistinctCnt;
+  xbInt16   iDepth;
+  xbPlanTagStats *next;
+};
+
+
+class XBDLLEXPORT xbQryPlan : public xbCore {
+
+  public:
+             xbQryPlan( xbXBase * x );
+             ~xbQryPlan();
+
+    xbInt16  Build( xbTblJoin *pTblList, const xbString &sWhere );
+    void     Clear();
+    xbDouble GetCost() const;
+    void     GetPlanText( xbString &sPlan ) const;
+    xbDouble GetRows() const;
+    const xbPlanStep *GetStep( const xbTblJoin *pTj ) const;
+    xbInt16  GetStepCnt() const;
+    xbBool   GetWherePushed() const;
+
+  protected:
+    xbXBase *xbase;              /* pointer to the main structures                       */
+
+  private:
+    xbInt16  GetSample( xbDbf *d, xbExp *e, char cStat, xbDouble &dResult, const xbFilterRange *r = NULL,
+                        xbIx *pIx = NULL, void *vpTag = NULL );
+    xbInt16  GetTagStats( xbDbf *d, xbIx *pIx, void *vpTag, xbPlanTagStats **pStatsOut );
+    xbInt16  PlanJoin( xbPlanStep *pStep, xbDouble dLookups );
+    xbInt16  PlanMaster( xbPlanStep *pStep, const xbString &sWhere );
+
+    xbPlanStep *pSteps;          // one step for each table, in table list order
+    xbInt16  iStepCnt;
+    xbBool   bWherePushed;       // where clause only references the master table
+    xbDouble dWhereSel;          // estimated fraction of the rows the where clause keeps
+    xbDouble dRows;              // estimated rows returned
+    xbDouble dCost;              // estimated cost of the query
+    xbPlanTagStats *pTagStats;   // tag statistics from earlier plans
+};
+
+
+
 class XBDLLEXPORT xbStmt : public xbCore{
 
  public:
@@ -91,35 +205,59 @@ class XBDLLEXPORT xbStmt : public xbCore{
   xbInt16 Test();
   #endif
 
-  xbInt16 ExecuteQuery( const xbString &sCmdLine ); 
+  xbInt16 ExecuteQuery( const xbString &sCmdLine );
 
-//  xbInt16 FetchFirst();
-//  xbInt16 FetchNext();
-//  xbInt16 FetchPrev();
-//  xbInt16 FetchLast();
-//  xbString &GetField( const xbString sFldName );
+  xbInt16 FetchFirst();
+  xbInt16 FetchNext();
+  xbInt16 FetchPrev();
+  xbInt16 FetchLast();
 
+  xbInt16 GetColCount() const;
+  xbInt16 GetColName( xbInt16 iColNo, xbString &sColName ) const;
+  xbInt16 GetField( xbInt16 iColNo, xbString &sValue );
+  xbInt16 GetField( const xbString &sColName, xbString &sValue );
+  xbInt16 GetPlan( xbString &sPlan ) const;
 
 
  protected:
 
  private:
 
+  xbInt16  AddFld( char cType, xbDbf *d, xbInt16 iFldNo, xbExp *e, const xbString &sFldAlias, const xbString &sExp = "" );
+  #ifdef XB_SORT_SUPPORT
+  xbInt16  AddSortCol( const xbString &sExp, xbBool bDescending );
+  #endif  // XB_SORT_SUPPORT
   xbInt16  AddQryTbl( const xbString &sTable, const xbString &sAlias, const xbString &sExpression, const char cJoinType );
+  xbInt16  BuildFieldList();
+  #ifdef XB_SORT_SUPPORT
+  xbInt16  BuildSortList();
+  #endif  // XB_SORT_SUPPORT
   xbInt16  CvtSqlExp2DbaseExp( const xbString &sExpIn, xbString &sExpOut );
+  xbTblJoin *FindQryTbl( const xbString &sQualifier ) const;
+  void     GetColExp( const xbSqlFld *f, xbString &sExp ) const;
   xbInt16  GetNextFromSeg( const xbString &sLineIn, xbString &sFromSegOut );
   xbUInt32 GetNextToken( const xbString &sCmdLineIn, xbString &sTokenOut, xbUInt32 ulStartPos );
+  void     GetTblRef( const xbTblJoin *pTj, xbString &sTblRef ) const;
   xbInt16  GetParenCnt( const xbString &sToken );
   xbInt16  ParseFromStmt( const xbString &sFromLine );
   xbInt16  ParseStmt( const xbString &sCmdLine );
   xbInt16  ProcessFromSeg( const xbString &sFromStmtSeg );
-  xbInt16  UpdateJoinList( char cType, const xbString &sTableName, const xbString &sAlias, const xbString &sExp, xbDbf *d, xbExp *e  );   //, xbTag *t);
+  void     Reset();
+  xbInt16  SplitJoinExp( xbTblJoin *pTj );
+  xbInt16  UpdateJoinList( char cType, const xbString &sTableName, const xbString &sAlias, xbDbf *d, xbTblJoin **pTjOut );
 
   xbXBase  *xbase;    // pointer to xbase structure
 
 
   xbTblJoin * pTblList;
+  xbCursor *pCursor;  // row source for the select statement
+  xbQryPlan *pPlan;   // access paths chosen for the select statement
   xbSqlFld *fl;       // field list in sql select statement
+  xbInt16  iColCnt;   // number of entries in the field list
+  xbBool   bDistinct; // SELECT DISTINCT
+  #ifdef XB_SORT_SUPPORT
+  xbSqlSortCol *pSortCols;  // sort key for ORDER BY and DISTINCT
+  #endif  // XB_SORT_SUPPORT
   xbString sStmt;     // complete query statment
   xbString sFields;   // list of fields
   xbString sFrom;     // from statment
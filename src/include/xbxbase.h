@@ -24,6 +24,9 @@ Email Contact:
 namespace xb{
 
 class XBDLLEXPORT xbLog;
+class XBDLLEXPORT xbDbf;
+class XBDLLEXPORT xbExpNode;
+class XBDLLEXPORT xbExp;
 
 /************************************************************************/
 /* 
@@ -111,6 +114,47 @@ static xbFunctionInfo FunctionList[] =
    { 0, 0, 0, 0 },
 };
 */
+
+//! @brief Application defined expression function.
+/*!
+  Called when an expression containing a function registered with xbXBase::RegisterFunction() is processed.<br>
+  The function parameters are the child nodes of n, which have already been evaluated. The function
+  stores its result in n with one of the xbExpNode::SetResult() methods.<br>
+  Logical and date results are stored as numeric values, the same as the built in functions.
+
+  @param xbase Pointer to xbXBase.
+  @param dbf Pointer to the table the expression was parsed against, or NULL.
+  @param n Function node.
+  @param iRecBufSw 0 - Current record buffer.<br>1 - Original record buffer.
+  @returns <a href="xbretcod_8h.html">Return Codes</a>
+*/
+typedef xbInt16 (*xbExpFunction)( xbXBase *xbase, xbDbf *dbf, xbExpNode *n, xbInt16 iRecBufSw );
+
+///@cond DOXYOFF
+struct XBDLLEXPORT xbUserFunction {
+  xbString      sFuncName;          // function name, upper case
+  char          cReturnType;        // return type of function
+  xbInt16       iReturnLenCalc;     // see GetFunctionInfo
+  xbInt32       lReturnLenVal;      // used in combination with iReturnLenCalc
+  xbExpFunction pFunc;              // function to call
+};
+///@endcond DOXYOFF
+
+#endif
+
+#ifdef XB_EXPRESSION_SUPPORT
+
+#define XB_EXP_CACHE_SIZE 64        // default number of parsed expressions kept by xbXBase
+
+///@cond DOXYOFF
+struct XBDLLEXPORT xbExpCacheEntry {
+  xbString      sExpression;        // expression text as passed to ParseExpression()
+  xbDbf         *dbf;               // default table the expression was parsed against
+  xbExp         *exp;               // parsed expression, copied out on a hit
+  xbUInt32      ulLastUsed;         // use stamp for least recently used replacement
+};
+///@endcond DOXYOFF
+
 #endif
 
 
@@ -489,6 +533,41 @@ class XBDLLEXPORT xbXBase : public xbTblMgr{
   xbInt16 SetDefaultIxTagMode( xbInt16 iIndexMode = XB_IX_DBASE_MODE );
   #endif  // (XB_NDX_SUPPORT) || defined (XB_MDX_SUPPORT)
 
+  #ifdef XB_TDX_SUPPORT
+  //! @brief Get the temporary index memory limit.
+  /*!
+    @returns Maximum number of bytes a temporary index holds in memory before it is written to disk.
+  */
+  xbUInt32 GetTdxMemoryLimit() const;
+
+  //! @brief Set the temporary index memory limit.
+  /*!
+    Temporary (TDX) indices are built in memory and only written to the temp directory
+    if they grow beyond this limit.  The limit applies to each temporary index, and
+    takes effect for temporary indices created after it is set.
+
+    @param ulMemLimit - Maximum number of bytes to hold in memory, 0 to always build temporary indices on disk.
+  */
+  void SetTdxMemoryLimit( xbUInt32 ulMemLimit );
+  #endif  // XB_TDX_SUPPORT
+
+  #ifdef XB_SORT_SUPPORT
+  //! @brief Get the sort memory limit.
+  /*!
+    @returns Number of bytes a sort holds in memory before it writes sorted runs to disk.
+  */
+  xbUInt32 GetSortMemoryLimit() const;
+
+  //! @brief Set the sort memory limit.
+  /*!
+    Used by xbSort for ORDER BY and DISTINCT, and for building temporary indices.
+    Takes effect for sorts started after it is set.
+
+    @param ulMemLimit - Number of bytes to hold in memory.
+  */
+  void SetSortMemoryLimit( xbUInt32 ulMemLimit );
+  #endif  // XB_SORT_SUPPORT
+
 
   #ifdef XB_DBF5_SUPPORT
   //! @brief Get the default time format.  Available if XB_DBF5_SUPPORT is on.
@@ -1085,13 +1164,60 @@ class XBDLLEXPORT xbXBase : public xbTblMgr{
     @returns XB_NO_ERROR.<br>XB_PARSE_ERROR.
   */
   xbInt16 YEAR( xbDate &dInDate, xbDouble &dOutYear );
+
+  //! @brief Register an application defined expression function.
+  /*!
+    Registered functions can be used in expressions the same as the built in functions,
+    including index tag and filter expressions. The function is resolved when the expression is parsed,
+    expressions must be parsed after the function is registered.<br>
+    Registering a function name a second time replaces the earlier registration.
+
+    @param sFuncName Function name.
+    @param cReturnType Return type of function, one of C, D, L or N.
+    @param iReturnLenCalc How the function return length is calculated, see GetFunctionInfo().
+    @param lReturnLenVal Used in combination with iReturnLenCalc.
+    @param pFunc Function to call.
+    @returns <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 RegisterFunction( const xbString &sFuncName, char cReturnType, xbInt16 iReturnLenCalc,
+                            xbInt32 lReturnLenVal, xbExpFunction pFunc );
   #endif
 
+  #ifdef XB_EXPRESSION_SUPPORT
+  //! @brief Clear the parsed expression cache.
+  /*!
+    Parsed expressions are kept by expression text and table, so parsing the same expression
+    again is a copy instead of a full parse.  The cache is cleared automatically when a function is
+    registered or the default date format changes, and entries for a table are dropped when it is closed.
+  */
+  void ClearExpressionCache();
+
+  //! @brief Get the number of parse requests satisfied from the expression cache.
+  /*!
+    @returns Cache hit count.
+  */
+  xbUInt32 GetExpressionCacheHits() const;
+
+  //! @brief Get the expression cache size.
+  /*!
+    @returns Max number of parsed expressions kept.
+  */
+  xbInt16 GetExpressionCacheSize() const;
+
+  //! @brief Set the expression cache size.
+  /*!
+    @param iCacheSize Max number of parsed expressions kept, the least recently used is dropped
+                      when full.  Zero turns the cache off.
+  */
+  void SetExpressionCacheSize( xbInt16 iCacheSize );
+  #endif // XB_EXPRESSION_SUPPORT
+
  protected:
 
   ///@cond
   friend class xbBcd;
   friend class xbExp;
+  friend class xbDbf;
 
   #ifdef XB_BLOCKREAD_SUPPORT
   friend class xbBlockRead;
@@ -1113,6 +1239,51 @@ class XBDLLEXPORT xbXBase : public xbTblMgr{
   */
   xbInt16 GetFunctionInfo( const xbString &sExpLine, char &cReturnType, xbInt16 &iReturnLenCalc, xbInt32 &lReturnLenVal ) const;
 
+  //! @brief Get information regarding expression functions.
+  /*!
+    Same as above, also returns the function code.
+    @param sExpLine An expression beginning with function name.
+    @param cReturnType Output - return type of function.
+    @param iReturnLenCalc Output - how the function return length is calculated.
+    @param lReturnLenVal Output - used in combination with iReturnLenCalc.
+    @param iFuncNo Output - one of the XB_EXP_FNC_ codes, or XB_EXP_FNC_USER plus the registration slot.
+    @returns <a href="xbretcod_8h.html">Return Codes</a>
+  */
+  xbInt16 GetFunctionInfo( const xbString &sExpLine, char &cReturnType, xbInt16 &iReturnLenCalc, xbInt32 &lReturnLenVal, xbInt16 &iFuncNo ) const;
+
+  //! @brief Get a registered function.
+  /*!
+    @param iFuncNo Function code returned by GetFunctionInfo().
+    @returns Pointer to the function, or NULL if not registered.
+  */
+  xbExpFunction GetUserFunction( xbInt16 iFuncNo ) const;
+
+  #ifdef XB_EXPRESSION_SUPPORT
+  //! @brief Add a parsed expression to the cache.
+  /*!
+    @param dbf Default table the expression was parsed against.
+    @param sExpression Expression text.
+    @param exp Parsed expression, owned by the cache from this point on.
+  */
+  void    AddCachedExpression( xbDbf *dbf, const xbString &sExpression, xbExp *exp );
+
+  //! @brief Drop cached expressions which refer to a table.
+  /*!
+    Called when a table is closed, as the parsed expressions point at the table and its fields.
+    @param dbf Table being closed.
+  */
+  void    ClearExpressionCache( xbDbf *dbf );
+
+  //! @brief Find a parsed expression in the cache.
+  /*!
+    @param dbf Default table for the expression.
+    @param sExpression Expression text.
+    @returns Pointer to the cached expression, or NULL if not found.  The caller copies it, the
+             cache keeps ownership.
+  */
+  xbExp   *GetCachedExpression( xbDbf *dbf, const xbString &sExpression );
+  #endif // XB_EXPRESSION_SUPPORT
+
   //! @brief Set the endian type
   /*!
     This routine determines the Endian-ness at run time instead of
@@ -1141,6 +1312,19 @@ class XBDLLEXPORT xbXBase : public xbTblMgr{
   xbLog *xLog;
   #endif
 
+  #ifdef XB_FUNCTION_SUPPORT
+  xbUserFunction **pUserFuncs;      // application registered expression functions
+  xbInt16          iUserFuncCnt;
+  #endif
+
+  #ifdef XB_EXPRESSION_SUPPORT
+  xbExpCacheEntry *pExpCache;       // parsed expressions
+  xbInt16          iExpCacheCnt;    // entries in use
+  xbInt16          iExpCacheSize;   // max entries
+  xbUInt32         ulExpCacheClock; // bumped on each use, stamps the entries
+  xbUInt32         ulExpCacheHits;
+  #endif
+
 };
 
 }        /* namespace xb    */
@@ -0,0 +1,541 @@
+/* xbcursor.cpp
+
+XBase64 Software Library
+
+Copyright (c) 1997,2003,2014,2022,2023,2024 Gary A Kunkel
+
+The xb64 software library is covered under the terms of the GPL Version 3, 2007 license.
+
+Email Contact:
+
+    XDB-devel@lists.sourceforge.net
+    XDB-users@lists.sourceforge.net
+
+The cursor is the row source for a SELECT statement.  The table list is turned into an
+xbRelate, and each fetch positions every table in the query to the next composite row.
+Rows are not materialized, only the current record of each table is held, unless the rows
+are sorted for ORDER BY or DISTINCT.  Sorted rows hold the sort key and the record number
+of each table, and a fetch reads each table's record back by record number.
+
+*/
+
+#include "xbase.h"
+
+#ifdef XB_SQL_SUPPORT
+
+namespace xb{
+
+/***********************************************************************/
+xbCursor::xbCursor( xbXBase *x ){
+  xbase        = x;
+  dMaster      = NULL;
+  pRel         = NULL;
+  pWhere       = NULL;
+  bWherePushed = xbFalse;
+  cPos         = ' ';
+  #ifdef XB_SORT_SUPPORT
+  pTbls        = NULL;
+  pSort        = NULL;
+  ulSortKeyLen = 0;
+  ullRow       = 0;
+  #endif  // XB_SORT_SUPPORT
+}
+/***********************************************************************/
+xbCursor::~xbCursor(){
+  Close();
+}
+/***********************************************************************/
+xbInt16 xbCursor::Close(){
+
+  if( pRel ){
+    delete pRel;
+    pRel = NULL;
+  }
+  if( pWhere ){
+    delete pWhere;
+    pWhere = NULL;
+  }
+  #ifdef XB_SORT_SUPPORT
+  if( pSort ){
+    delete pSort;
+    pSort = NULL;
+  }
+  pTbls = NULL;
+  #endif  // XB_SORT_SUPPORT
+  dMaster = NULL;
+  bWherePushed = xbFalse;
+  cPos = ' ';
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+xbInt16 xbCursor::Fetch( char cDirection ){
+
+  // cDirection
+  //   F - first row, N - next row, P - previous row, L - last row
+  //
+  // cPos tracks where the cursor is, so a next fetch after end of file does not
+  // start over, and a next fetch before any other fetch returns the first row
+  //   ' ' - not positioned
+  //   'R' - on a row
+  //   'E' - past the last row
+  //   'B' - before the first row
+
+  xbInt16  iRc        = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbBool   bMatch     = xbFalse;
+  xbBool   bForward;
+
+  try{
+    if( !pRel ){
+      iErrorStop = 100;
+      iRc = XB_NOT_OPEN;
+      throw iRc;
+    }
+    #ifdef XB_SORT_SUPPORT
+    if( pSort )
+      return FetchSorted( cDirection );
+    #endif  // XB_SORT_SUPPORT
+    if( cDirection == 'N' ){
+      if( cPos == 'E' )
+        return XB_EOF;
+      else if( cPos != 'R' )
+        cDirection = 'F';
+    } else if( cDirection == 'P' ){
+      if( cPos == 'B' )
+        return XB_BOF;
+      else if( cPos != 'R' )
+        cDirection = 'L';
+    }
+    bForward = ( cDirection == 'F' || cDirection == 'N' );
+
+    switch( cDirection ){
+      case 'F': iRc = pRel->GetFirstRelRecord(); break;
+      case 'N': iRc = pRel->GetNextRelRecord();  break;
+      case 'P': iRc = pRel->GetPrevRelRecord();  break;
+      case 'L': iRc = pRel->GetLastRelRecord();  break;
+      default:
+        iErrorStop = 110;
+        iRc = XB_INVALID_OPTION;
+        throw iRc;
+    }
+
+    // an empty master leaves the tables on blank record 0
+    if( iRc == XB_NO_ERROR && dMaster->GetCurRecNo() == 0 )
+      iRc = bForward ? XB_EOF : XB_BOF;
+
+    while( iRc == XB_NO_ERROR && pWhere ){
+      if(( iRc = pWhere->ProcessExpression()) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+      if(( iRc = pWhere->GetBoolResult( bMatch )) != XB_NO_ERROR ){
+        iErrorStop = 130;
+        throw iRc;
+      }
+      if( bMatch )
+        break;
+      if( bForward )
+        iRc = pRel->GetNextRelRecord();
+      else
+        iRc = pRel->GetPrevRelRecord();
+    }
+
+    if( iRc == XB_NO_ERROR )
+      cPos = 'R';
+    else if( iRc == XB_EOF || iRc == XB_BOF || iRc == XB_EMPTY || iRc == XB_NOT_FOUND ){
+      cPos = bForward ? 'E' : 'B';
+      iRc  = bForward ? XB_EOF : XB_BOF;
+    } else {
+      iErrorStop = 140;
+      throw iRc;
+    }
+  }
+  catch (xbInt16 iRc ){
+    cPos = ' ';
+    xbString sMsg;
+    sMsg.Sprintf( "xbCursor::Fetch() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+#ifdef XB_SORT_SUPPORT
+xbInt16 xbCursor::FetchSorted( char cDirection ){
+
+  // same as Fetch, for rows sorted by SortRows
+  // each table is read by the record number saved with the row, 0 is a blank row from an outer join
+
+  xbInt16  iRc        = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbUInt64 ullRowCnt  = pSort->GetRecCnt();
+  xbUInt32 ulRecNo;
+  xbUInt32 ul         = 0;
+  const char *p;
+
+  try{
+    if( cDirection == 'N' ){
+      if( cPos == 'E' )
+        return XB_EOF;
+      else if( cPos != 'R' )
+        cDirection = 'F';
+    } else if( cDirection == 'P' ){
+      if( cPos == 'B' )
+        return XB_BOF;
+      else if( cPos != 'R' )
+        cDirection = 'L';
+    }
+
+    switch( cDirection ){
+      case 'F':
+        if( ullRowCnt == 0 ){
+          cPos = 'E';
+          return XB_EOF;
+        }
+        ullRow = 0;
+        break;
+      case 'N':
+        if( ullRow + 1 >= ullRowCnt ){
+          cPos = 'E';
+          return XB_EOF;
+        }
+        ullRow++;
+        break;
+      case 'P':
+        if( ullRow == 0 ){
+          cPos = 'B';
+          return XB_BOF;
+        }
+        ullRow--;
+        break;
+      case 'L':
+        if( ullRowCnt == 0 ){
+          cPos = 'B';
+          return XB_BOF;
+        }
+        ullRow = ullRowCnt - 1;
+        break;
+      default:
+        iErrorStop = 100;
+        iRc = XB_INVALID_OPTION;
+        throw iRc;
+    }
+
+    if(( iRc = pSort->GetRec( ullRow, &p )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    for( xbTblJoin *t = pTbls; t; t = t->next, ul++ ){
+      memcpy( &ulRecNo, p + ulSortKeyLen + ul * 4, 4 );
+      if( ulRecNo == 0 )
+        iRc = t->pDbf->BlankRecord();
+      else
+        iRc = t->pDbf->GetRecord( ulRecNo );
+      if( iRc != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+    }
+    cPos = 'R';
+  }
+  catch (xbInt16 iRc ){
+    cPos = ' ';
+    xbString sMsg;
+    sMsg.Sprintf( "xbCursor::FetchSorted() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+#endif  // XB_SORT_SUPPORT
+/***********************************************************************/
+xbBool xbCursor::GetWherePushed() const {
+  return bWherePushed;
+}
+/***********************************************************************/
+xbInt16 xbCursor::Open( xbTblJoin *pTblList, const xbString &sWhere, const xbQryPlan *pPlan ){
+
+  // pTblList - parsed table list, the first entry is the master table
+  // sWhere   - dBASE style where expression, empty for all rows
+  // pPlan    - access paths to use, NULL to let the master filter and the relation choose
+  //
+  // A where clause that only references the master table is handed to the master
+  // filter, so it can be answered from an index range and the joins are only done
+  // for qualifying master records.  Any other where clause is checked for each
+  // composite row as it is fetched.
+
+  xbInt16   iRc        = XB_NO_ERROR;
+  xbInt16   iErrorStop = 0;
+  xbString  sMasterFilter;
+  xbTblJoin *p;
+  char      cType;
+  const xbPlanStep *ps;
+
+  try{
+    Close();
+    if( !pTblList || !pTblList->pDbf ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_OBJECT;
+      throw iRc;
+    }
+    dMaster = pTblList->pDbf;
+    #ifdef XB_SORT_SUPPORT
+    pTbls   = pTblList;
+    #endif  // XB_SORT_SUPPORT
+
+    if( sWhere.Len() > 0 ){
+      pWhere = new xbExp( xbase );
+      if(( iRc = pWhere->ParseExpression( dMaster, sWhere )) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+      if( pWhere->GetReturnType() != XB_EXP_LOGICAL ){
+        iErrorStop = 120;
+        iRc = XB_INVALID_EXPRESSION;
+        throw iRc;
+      }
+      if( WhereIsMasterOnly()){
+        sMasterFilter = sWhere;
+        bWherePushed  = xbTrue;
+        delete pWhere;
+        pWhere = NULL;
+      }
+    }
+
+    pRel = new xbRelate( xbase );
+    if(( iRc = pRel->SetMaster( dMaster, sMasterFilter )) != XB_NO_ERROR ){
+      iErrorStop = 130;
+      throw iRc;
+    }
+    #ifdef XB_INDEX_SUPPORT
+    if( pPlan && bWherePushed && ( ps = pPlan->GetStep( pTblList )) != NULL ){
+      if( ps->cAccess == 'R' )
+        iRc = pRel->SetMasterIxRange( 'T', ps->pIx, ps->vpTag );
+      else
+        iRc = pRel->SetMasterIxRange( 'N' );
+      if( iRc != XB_NO_ERROR ){
+        iErrorStop = 190;
+        throw iRc;
+      }
+    }
+    #endif  // XB_INDEX_SUPPORT
+
+    for( p = pTblList->next; p; p = p->next ){
+      if( !p->pMaster || !p->pDbf ){
+        iErrorStop = 140;
+        iRc = XB_INVALID_OBJECT;
+        throw iRc;
+      }
+      if( p->cJoinType == 'I' )
+        cType = 'R';
+      else if( p->cJoinType == 'L' )
+        cType = 'O';
+      else {
+        iErrorStop = 150;
+        iRc = XB_INVALID_OPTION;
+        throw iRc;
+      }
+
+      if( p->pTag ){
+        if(( iRc = pRel->AddRelation( p->pMaster->pDbf, p->sParentExp, p->pDbf, p->pTag->GetIx(), p->pTag->GetVpTag(), cType )) != XB_NO_ERROR ){
+          iErrorStop = 160;
+          throw iRc;
+        }
+      } else {
+        #ifdef XB_HSH_SUPPORT
+        if(( iRc = pRel->AddRelationExp( p->pMaster->pDbf, p->sParentExp, p->pDbf, p->sChildExp, cType )) != XB_NO_ERROR ){
+          iErrorStop = 170;
+          throw iRc;
+        }
+        #else
+        iErrorStop = 180;
+        iRc = XB_INVALID_TAG;
+        throw iRc;
+        #endif  // XB_HSH_SUPPORT
+      }
+      if( pPlan && ( ps = pPlan->GetStep( p )) != NULL ){
+        if(( iRc = pRel->SetJoinMode( p->pDbf, ps->cAccess )) != XB_NO_ERROR ){
+          iErrorStop = 200;
+          throw iRc;
+        }
+      }
+    }
+  }
+  catch (xbInt16 iRc ){
+    Close();
+    xbString sMsg;
+    sMsg.Sprintf( "xbCursor::Open() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+#ifdef XB_SORT_SUPPORT
+xbInt16 xbCursor::SortRows( const xbSqlSortCol *pCols, xbBool bDistinct ){
+
+  // pCols     - sort key columns, most significant first
+  // bDistinct - keep only the first row for each sort key
+  //
+  // Reads every row from the open cursor and sorts them with an xbSort, which spills
+  // to temp files once the sort memory limit is reached.  Each column is encoded so the
+  // rows sort with a byte compare, character columns are padded to the expression length,
+  // numeric columns are doubles, dates are CCYYMMDD and logicals are T or F.  After the
+  // sort, fetches return the rows in sort key order.
+
+  xbInt16  iRc        = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbUInt32 ulTblCnt   = 0;
+  xbUInt32 ulKeyLen   = 0;
+  xbUInt32 ulLen;
+  xbUInt32 ulRecNo;
+  xbDouble d;
+  xbDate   dt;
+  xbBool   b;
+  xbString s;
+  char     *cpRec     = NULL;
+  char     *cp;
+  xbSort   *pRows     = NULL;
+  const xbSqlSortCol *c;
+  xbTblJoin *t;
+
+  try{
+    if( !pRel ){
+      iErrorStop = 100;
+      iRc = XB_NOT_OPEN;
+      throw iRc;
+    }
+    if( pSort ){
+      delete pSort;
+      pSort = NULL;
+    }
+    for( c = pCols; c; c = c->Next ){
+      switch( c->pExp->GetReturnType()){
+        case XB_EXP_CHAR:    ulKeyLen += (xbUInt32) c->pExp->GetResultLen(); break;
+        case XB_EXP_NUMERIC: ulKeyLen += 8; break;
+        case XB_EXP_DATE:    ulKeyLen += 8; break;
+        case XB_EXP_LOGICAL: ulKeyLen += 1; break;
+        default:
+          iErrorStop = 110;
+          iRc = XB_INVALID_EXPRESSION;
+          throw iRc;
+      }
+    }
+    for( t = pTbls; t; t = t->next )
+      ulTblCnt++;
+    if( ulKeyLen == 0 ){
+      iErrorStop = 120;
+      iRc = XB_INVALID_OPTION;
+      throw iRc;
+    }
+
+    pRows = new xbSort( xbase );
+    if(( iRc = pRows->Init( ulKeyLen, ulTblCnt * 4, bDistinct )) != XB_NO_ERROR ){
+      iErrorStop = 130;
+      throw iRc;
+    }
+    if(( cpRec = (char *) malloc( ulKeyLen + ulTblCnt * 4 )) == NULL ){
+      iErrorStop = 140;
+      iRc = XB_NO_MEMORY;
+      throw iRc;
+    }
+
+    iRc = Fetch( 'F' );
+    while( iRc == XB_NO_ERROR ){
+      cp = cpRec;
+      for( c = pCols; c; c = c->Next ){
+        if(( iRc = c->pExp->ProcessExpression()) != XB_NO_ERROR ){
+          iErrorStop = 150;
+          throw iRc;
+        }
+        switch( c->pExp->GetReturnType()){
+          case XB_EXP_CHAR:
+            ulLen = (xbUInt32) c->pExp->GetResultLen();
+            iRc = c->pExp->GetStringResult( s );
+            memset( cp, ' ', ulLen );
+            memcpy( cp, s.Str(), s.Len() < ulLen ? s.Len() : ulLen );
+            if( c->bDescending )
+              xbSort::PutKeyChar( cp, cp, ulLen, xbTrue );
+            break;
+          case XB_EXP_NUMERIC:
+            ulLen = 8;
+            if(( iRc = c->pExp->GetNumericResult( d )) == XB_NO_ERROR )
+              xbSort::PutKeyDouble( cp, d, c->bDescending );
+            break;
+          case XB_EXP_DATE:
+            ulLen = 8;
+            if(( iRc = c->pExp->GetDateResult( dt )) == XB_NO_ERROR ){
+              s = dt.Str();
+              memset( cp, ' ', ulLen );
+              memcpy( cp, s.Str(), s.Len() < ulLen ? s.Len() : ulLen );
+              if( c->bDescending )
+                xbSort::PutKeyChar( cp, cp, ulLen, xbTrue );
+            }
+            break;
+          default:
+            ulLen = 1;
+            if(( iRc = c->pExp->GetBoolResult( b )) == XB_NO_ERROR )
+              xbSort::PutKeyChar( cp, b ? "T" : "F", ulLen, c->bDescending );
+            break;
+        }
+        if( iRc != XB_NO_ERROR ){
+          iErrorStop = 160;
+          throw iRc;
+        }
+        cp += ulLen;
+      }
+      for( t = pTbls; t; t = t->next, cp += 4 ){
+        ulRecNo = t->pDbf->GetCurRecNo();
+        memcpy( cp, &ulRecNo, 4 );
+      }
+      if(( iRc = pRows->Add( cpRec, cpRec + ulKeyLen )) != XB_NO_ERROR ){
+        iErrorStop = 170;
+        throw iRc;
+      }
+      iRc = Fetch( 'N' );
+    }
+    if( iRc != XB_EOF ){
+      iErrorStop = 180;
+      throw iRc;
+    }
+    if(( iRc = pRows->Sort( xbTrue )) != XB_NO_ERROR ){
+      iErrorStop = 190;
+      throw iRc;
+    }
+    pSort        = pRows;
+    pRows        = NULL;
+    ulSortKeyLen = ulKeyLen;
+    ullRow       = 0;
+    cPos         = ' ';
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbCursor::SortRows() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  if( pRows )
+    delete pRows;
+  if( cpRec )
+    free( cpRec );
+  return iRc;
+}
+#endif  // XB_SORT_SUPPORT
+/***********************************************************************/
+xbBool xbCursor::WhereIsMasterOnly() const {
+
+  // true if every field in the parsed where clause belongs to the master table
+  if( !pWhere || !pWhere->GetTreeHandle())
+    return xbFalse;
+
+  xbExpNode *n = pWhere->GetTreeHandle()->GetFirstNode();
+  while( n ){
+    if( n->GetNodeType() == XB_EXP_FIELD && n->GetDbf() != dMaster )
+      return xbFalse;
+    n = n->GetNextNode();
+  }
+  return xbTrue;
+}
+/***********************************************************************/
+}              /* namespace       */
+#endif         /*  XB_SQL_SUPPORT */
@@ -0,0 +1,679 @@
+/* xbplan.cpp
+
+XBase64 Software Library
+
+Copyright (c) 1997,2003,2014,2022,2023,2024 Gary A Kunkel
+
+The xb64 software library is covered under the terms of the GPL Version 3, 2007 license.
+
+Email Contact:
+
+    XDB-devel@lists.sourceforge.net
+    XDB-users@lists.sourceforge.net
+
+The query plan picks the access path for each table in a SELECT statement.  The master table
+is read with a full scan or an index range scan, each joined table with an index nested loop
+or a hash join.  The choice is made on estimated costs from the table record counts, the key
+count, distinct key count and depth of the open tags, and from records sampled out of the
+tables for the selectivity of the where clause, key ranges and join keys.
+
+*/
+
+#include "xbase.h"
+
+#ifdef XB_SQL_SUPPORT
+
+namespace xb{
+
+/***********************************************************************/
+xbQryPlan::xbQryPlan( xbXBase *x ){
+  xbase        = x;
+  pSteps       = NULL;
+  iStepCnt     = 0;
+  bWherePushed = xbFalse;
+  dWhereSel    = 1.0;
+  dRows        = 0;
+  dCost        = 0;
+  pTagStats    = NULL;
+}
+/***********************************************************************/
+xbQryPlan::~xbQryPlan(){
+  Clear();
+  xbPlanTagStats *p;
+  while( pTagStats ){
+    p = pTagStats->next;
+    delete pTagStats;
+    pTagStats = p;
+  }
+}
+/***********************************************************************/
+xbInt16 xbQryPlan::Build( xbTblJoin *pTblList, const xbString &sWhere ){
+
+  // pTblList - parsed table list, the first entry is the master table
+  // sWhere   - dBASE style where expression, empty for all rows
+
+  xbInt16   iRc        = XB_NO_ERROR;
+  xbInt16   iErrorStop = 0;
+  xbTblJoin *p;
+  xbInt16   i;
+
+  try{
+    Clear();
+    if( !pTblList || !pTblList->pDbf ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_OBJECT;
+      throw iRc;
+    }
+    for( p = pTblList; p; p = p->next )
+      iStepCnt++;
+    pSteps = new xbPlanStep[iStepCnt];
+    for( p = pTblList, i = 0; p; p = p->next, i++ ){
+      pSteps[i].pTj      = p;
+      pSteps[i].cAccess  = 'S';
+      pSteps[i].pIx      = NULL;
+      pSteps[i].vpTag    = NULL;
+      pSteps[i].dLookups = 0;
+      pSteps[i].dRows    = 0;
+      pSteps[i].dCost    = 0;
+    }
+
+    if(( iRc = PlanMaster( &pSteps[0], sWhere )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    // each joined table is looked up once for every composite row built so far
+    for( i = 1; i < iStepCnt; i++ ){
+      if(( iRc = PlanJoin( &pSteps[i], pSteps[i-1].dRows )) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+    }
+
+    dRows = pSteps[iStepCnt-1].dRows;
+    if( sWhere.Len() > 0 && !bWherePushed ){
+      dWhereSel = XB_PLAN_DEFAULT_SEL;
+      dRows *= dWhereSel;
+    }
+    for( i = 0; i < iStepCnt; i++ )
+      dCost += pSteps[i].dCost;
+  }
+  catch (xbInt16 iRc ){
+    Clear();
+    xbString sMsg;
+    sMsg.Sprintf( "xbQryPlan::Build() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+void xbQryPlan::Clear(){
+
+  // the tag statistics are kept for the next plan
+  if( pSteps ){
+    delete [] pSteps;
+    pSteps = NULL;
+  }
+  iStepCnt     = 0;
+  bWherePushed = xbFalse;
+  dWhereSel    = 1.0;
+  dRows        = 0;
+  dCost        = 0;
+}
+/***********************************************************************/
+xbDouble xbQryPlan::GetCost() const {
+  return dCost;
+}
+/***********************************************************************/
+void xbQryPlan::GetPlanText( xbString &sPlan ) const {
+
+  xbString sLine;
+  xbString sTable;
+  xbString sUpper;
+  const char *sJoin;
+  const char *sAccess;
+
+  sPlan = "";
+  if( !pSteps )
+    return;
+
+  sLine.Sprintf( "%-5s %-20s %-6s %-18s %-12s %12s %12s\n", "Step", "Table", "Join", "Access", "Tag", "Rows", "Cost" );
+  sPlan += sLine;
+  for( xbInt16 i = 0; i < iStepCnt; i++ ){
+    const xbPlanStep &s = pSteps[i];
+    sTable = s.pTj->sAlias.Len() > 0 ? s.pTj->sAlias : s.pTj->sTableName;
+    sUpper = sTable;
+    sUpper.ToUpperCase();
+    if( sUpper.Len() > 4 && sUpper.Pos( ".DBF" ) == sUpper.Len() - 3 )
+      sTable.Resize( sTable.Len() - 3 );
+    switch( s.pTj->cJoinType ){
+      case 'I': sJoin = "INNER"; break;
+      case 'L': sJoin = "LEFT";  break;
+      default:  sJoin = "";      break;
+    }
+    switch( s.cAccess ){
+      case 'R': sAccess = "INDEX RANGE SCAN";  break;
+      case 'I': sAccess = "INDEX NESTED LOOP"; break;
+      case 'H': sAccess = "HASH JOIN";         break;
+      default:  sAccess = "FULL SCAN";         break;
+    }
+    sLine.Sprintf( "%-5d %-20s %-6s %-18s %-12s %12.0f %12.0f\n", i + 1, sTable.Str(), sJoin, sAccess,
+                   s.sTagName.Str(), s.dRows, s.dCost );
+    sPlan += sLine;
+  }
+  if( bWherePushed ){
+    sLine.Sprintf( "Where clause checked by the master table filter, estimated selectivity %.3f\n", dWhereSel );
+    sPlan += sLine;
+  } else if( dWhereSel < 1.0 ){
+    sLine.Sprintf( "Where clause checked for each row, estimated selectivity %.3f\n", dWhereSel );
+    sPlan += sLine;
+  }
+  sLine.Sprintf( "Estimated rows %.0f, estimated cost %.0f\n", dRows, dCost );
+  sPlan += sLine;
+}
+/***********************************************************************/
+xbDouble xbQryPlan::GetRows() const {
+  return dRows;
+}
+/***********************************************************************/
+xbInt16 xbQryPlan::GetSample( xbDbf *d, xbExp *e, char cStat, xbDouble &dResult, const xbFilterRange *r,
+                               xbIx *pIx, void *vpTag ){
+
+  // Read up to XB_PLAN_SAMPLE_RECS records, evenly spaced through the table, and evaluate e for each
+  //
+  // cStat
+  //   T - fraction of the records where logical expression e is true
+  //   R - fraction of the records where key expression e is inside key range r
+  //   D - estimated number of distinct values of e in the table
+  //   M - fraction of the records where the value of e is a key in tag pIx / vpTag
+  //
+  // dResult is set to -1 when the table can't be sampled, the current record is restored after the sample
+
+  xbInt16  iRc        = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbUInt32 ulRecCnt   = 0;
+  xbUInt32 ulSaveRecNo;
+  xbUInt32 ulSampleCnt;
+  xbUInt32 ulHits     = 0;
+  xbUInt32 ul;
+  xbString *sVals     = NULL;
+  xbString sKey;
+  xbDouble dKey;
+  xbDate   dtKey;
+  xbBool   bKey;
+  xbBool   bHit;
+
+  dResult = -1;
+  try{
+    // a record with pending updates would have to be committed or aborted first
+    if( !d || !e || d->GetDbfStatus() == XB_UPDATED || ( cStat == 'R' && !r ) || ( cStat == 'M' && ( !pIx || !vpTag )))
+      return XB_NO_ERROR;
+    if(( iRc = d->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    if( ulRecCnt == 0 )
+      return XB_NO_ERROR;
+
+    ulSampleCnt = ulRecCnt < XB_PLAN_SAMPLE_RECS ? ulRecCnt : XB_PLAN_SAMPLE_RECS;
+    ulSaveRecNo = d->GetCurRecNo();
+    if( cStat == 'D' )
+      sVals = new xbString[ulSampleCnt];
+
+    for( ul = 0; ul < ulSampleCnt; ul++ ){
+      if(( iRc = d->GetRecord( 1 + (xbUInt32) (((xbUInt64) ul * ulRecCnt ) / ulSampleCnt ))) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+      if(( iRc = e->ProcessExpression()) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+      switch( e->GetReturnType()){
+        case XB_EXP_CHAR:      iRc = e->GetStringResult( sKey ); break;
+        case XB_EXP_NUMERIC:   iRc = e->GetNumericResult( dKey ); sKey.Sprintf( "%f", dKey ); break;
+        case XB_EXP_DATE:      iRc = e->GetDateResult( dtKey ); sKey = dtKey.Str(); break;
+        case XB_EXP_LOGICAL:   iRc = e->GetBoolResult( bKey ); sKey = bKey ? "T" : "F"; break;
+        default:               iRc = XB_INVALID_EXPRESSION; break;
+      }
+      if( iRc != XB_NO_ERROR ){
+        iErrorStop = 130;
+        throw iRc;
+      }
+
+      if( cStat == 'T' ){
+        if( e->GetReturnType() == XB_EXP_LOGICAL && bKey )
+          ulHits++;
+
+      } else if( cStat == 'R' ){
+        bHit = xbTrue;
+        if( r->cKeyType == 'C' ){
+          // char bounds are compared against the leading bytes of the key
+          if( r->bLo && strncmp( sKey.Str(), r->sLo.Str(), r->sLo.Len()) < 0 )
+            bHit = xbFalse;
+          if( r->bHi && strncmp( sKey.Str(), r->sHi.Str(), r->sHi.Len()) > 0 )
+            bHit = xbFalse;
+        } else {
+          if( r->cKeyType == 'D' ){
+            if( dtKey.IsNull())
+              bHit = xbFalse;
+            dKey = dtKey.IsNull() ? 0 : (xbDouble) dtKey.JulianDays();
+          }
+          if(( r->bLo && dKey < r->dLo ) || ( r->bHi && dKey > r->dHi ))
+            bHit = xbFalse;
+        }
+        if( bHit )
+          ulHits++;
+
+      } else if( cStat == 'M' ){
+        #ifdef XB_INDEX_SUPPORT
+        switch( e->GetReturnType()){
+          case XB_EXP_CHAR:    iRc = pIx->FindKey( vpTag, sKey, 0 );  break;
+          case XB_EXP_NUMERIC: iRc = pIx->FindKey( vpTag, dKey, 0 );  break;
+          case XB_EXP_DATE:    iRc = pIx->FindKey( vpTag, dtKey, 0 ); break;
+          default:             iRc = XB_INVALID_EXPRESSION;           break;
+        }
+        if( iRc == XB_NO_ERROR )
+          ulHits++;
+        else if( iRc != XB_NOT_FOUND && iRc != XB_EMPTY ){
+          iErrorStop = 140;
+          throw iRc;
+        }
+        iRc = XB_NO_ERROR;
+        #endif  // XB_INDEX_SUPPORT
+
+      } else {
+        sVals[ul] = sKey;
+      }
+    }
+    if( ulSaveRecNo > 0 && ulSaveRecNo <= ulRecCnt && ( iRc = d->GetRecord( ulSaveRecNo )) != XB_NO_ERROR ){
+      iErrorStop = 150;
+      throw iRc;
+    }
+
+    if( cStat == 'D' ){
+      // distinct values seen, and values seen only once, scaled up to the table size
+      // an estimator that assumes unseen values are as rare as the ones seen once
+      xbUInt32 ulDistinct = 0;
+      xbUInt32 ulOnce     = 0;
+      xbUInt32 ulCnt;
+      xbUInt32 ul2;
+      for( ul = 0; ul < ulSampleCnt; ul++ ){
+        for( ul2 = 0; ul2 < ul && sVals[ul2] != sVals[ul]; ul2++ )
+          ;
+        if( ul2 < ul )
+          continue;
+        ulDistinct++;
+        for( ulCnt = 0, ul2 = ul; ul2 < ulSampleCnt; ul2++ )
+          if( sVals[ul2] == sVals[ul] )
+            ulCnt++;
+        if( ulCnt == 1 )
+          ulOnce++;
+      }
+      dResult = (xbDouble) ulDistinct;
+      if( ulSampleCnt < ulRecCnt ){
+        dResult = sqrt((xbDouble) ulRecCnt / ulSampleCnt ) * ulOnce + ( ulDistinct - ulOnce );
+        if( ulOnce == ulSampleCnt )
+          dResult = (xbDouble) ulRecCnt;
+        if( dResult < ulDistinct )
+          dResult = ulDistinct;
+        if( dResult > ulRecCnt )
+          dResult = ulRecCnt;
+      }
+      delete [] sVals;
+      sVals = NULL;
+    } else {
+      dResult = (xbDouble) ulHits / ulSampleCnt;
+    }
+  }
+  catch (xbInt16 iRc ){
+    if( sVals )
+      delete [] sVals;
+    dResult = -1;
+    xbString sMsg;
+    sMsg.Sprintf( "xbQryPlan::GetSample() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+const xbPlanStep *xbQryPlan::GetStep( const xbTblJoin *pTj ) const {
+  for( xbInt16 i = 0; i < iStepCnt; i++ )
+    if( pSteps[i].pTj == pTj )
+      return &pSteps[i];
+  return NULL;
+}
+/***********************************************************************/
+xbInt16 xbQryPlan::GetStepCnt() const {
+  return iStepCnt;
+}
+/***********************************************************************/
+xbInt16 xbQryPlan::GetTagStats( xbDbf *d, xbIx *pIx, void *vpTag, xbPlanTagStats **pStatsOut ){
+
+  // key count, distinct key count and depth for a tag
+  // the counts walk the whole tag, they are kept and reused until the table changes
+  // the tag is moved back to its current key afterwards, planning doesn't move the caller's position
+
+  xbInt16  iRc         = XB_NO_ERROR;
+  xbInt16  iErrorStop  = 0;
+  xbUInt32 ulRecCnt    = 0;
+  xbUInt32 ulSaveRecNo = 0;
+  char     *cpSaveKey  = NULL;
+  xbPlanTagStats *p    = NULL;
+
+  *pStatsOut = NULL;
+  try{
+    if(( iRc = d->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    for( p = pTagStats; p && ( p->pIx != pIx || p->vpTag != vpTag ); p = p->next )
+      ;
+    if( p && p->ulChangeSeq == d->GetChangeSeq() && p->ulRecCnt == ulRecCnt ){
+      *pStatsOut = p;
+      return XB_NO_ERROR;
+    }
+    if( !p ){
+      p = new xbPlanTagStats;
+      p->pIx    = pIx;
+      p->vpTag  = vpTag;
+      p->next   = pTagStats;
+      pTagStats = p;
+    }
+    p->ulChangeSeq = d->GetChangeSeq();
+    p->ulRecCnt    = ulRecCnt;
+    cpSaveKey = pIx->SaveTagPos( vpTag, ulSaveRecNo );
+    if(( iRc = pIx->GetKeyCnt( vpTag, p->ulKeyCnt )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    if(( iRc = pIx->GetDistinctKeyCnt( vpTag, p->ulDistinctCnt )) != XB_NO_ERROR ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+    if(( iRc = pIx->GetTagDepth( vpTag, p->iDepth )) != XB_NO_ERROR ){
+      iErrorStop = 130;
+      throw iRc;
+    }
+    iRc = pIx->RestoreTagPos( vpTag, cpSaveKey, ulSaveRecNo );
+    cpSaveKey = NULL;
+    if( iRc != XB_NO_ERROR ){
+      iErrorStop = 140;
+      throw iRc;
+    }
+    *pStatsOut = p;
+  }
+  catch (xbInt16 iRc ){
+    if( cpSaveKey )
+      pIx->RestoreTagPos( vpTag, cpSaveKey, ulSaveRecNo );
+    // force a recount next time
+    if( p )
+      p->ulRecCnt = 0xffffffff;
+    xbString sMsg;
+    sMsg.Sprintf( "xbQryPlan::GetTagStats() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+xbBool xbQryPlan::GetWherePushed() const {
+  return bWherePushed;
+}
+/***********************************************************************/
+xbInt16 xbQryPlan::PlanJoin( xbPlanStep *pStep, xbDouble dLookups ){
+
+  // index nested loop - search the child tag for each parent row
+  //     dLookups * depth * NODE + matched * ( KEY + FETCH )
+  // hash join - read the child table once into a hash, probe it for each parent row
+  //     Nc * ( SCAN + HASH_BUILD ) + dLookups * HASH_PROBE + matched * FETCH
+  //
+  // matched child rows come from the distinct keys on each side of the join
+  //     f       - fraction of the parent keys found in the child, distinct child / distinct parent keys
+  //     dPerKey - child rows for each child key
+
+  xbInt16  iRc        = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbTblJoin *pTj      = pStep->pTj;
+  xbDbf    *dChild    = pTj->pDbf;
+  xbDbf    *dParent   = pTj->pMaster ? pTj->pMaster->pDbf : NULL;
+  xbUInt32 ulChildCnt = 0;
+  xbDouble dNdvChild  = -1;
+  xbDouble dNdvParent = -1;
+  xbDouble dPerKey    = 1;
+  xbDouble dMatch     = 1;
+  xbDouble dMatched;
+  xbDouble dCostI     = -1;
+  xbDouble dCostH     = -1;
+  xbPlanTagStats *ts  = NULL;
+
+  try{
+    if( !dChild || !dParent ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_OBJECT;
+      throw iRc;
+    }
+    if(( iRc = dChild->GetRecordCnt( ulChildCnt )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    pStep->dLookups = dLookups;
+
+    #ifdef XB_INDEX_SUPPORT
+    if( pTj->pTag ){
+      if(( iRc = GetTagStats( dChild, pTj->pTag->GetIx(), pTj->pTag->GetVpTag(), &ts )) != XB_NO_ERROR ){
+        iErrorStop = 120;
+        throw iRc;
+      }
+      dNdvChild = ts->ulDistinctCnt;
+      if( ts->ulDistinctCnt > 0 )
+        dPerKey = (xbDouble) ts->ulKeyCnt / ts->ulDistinctCnt;
+    }
+    #endif  // XB_INDEX_SUPPORT
+
+    if( !ts && ulChildCnt > 0 ){
+      xbExp eChild( xbase );
+      if(( iRc = eChild.ParseExpression( dChild, pTj->sChildExp )) != XB_NO_ERROR ){
+        iErrorStop = 130;
+        throw iRc;
+      }
+      if(( iRc = GetSample( dChild, &eChild, 'D', dNdvChild )) != XB_NO_ERROR ){
+        iErrorStop = 140;
+        throw iRc;
+      }
+      if( dNdvChild <= 0 )
+        dNdvChild = ulChildCnt;
+      dPerKey = ulChildCnt / dNdvChild;
+    }
+
+    if( ulChildCnt == 0 || dNdvChild <= 0 ){
+      dMatch = 0;
+    } else {
+      xbExp eParent( xbase );
+      if(( iRc = eParent.ParseExpression( dParent, pTj->sParentExp )) != XB_NO_ERROR ){
+        iErrorStop = 150;
+        throw iRc;
+      }
+      // with a child tag the sampled parent keys are looked up in it, otherwise the distinct key counts are compared
+      #ifdef XB_INDEX_SUPPORT
+      if( ts ){
+        if(( iRc = GetSample( dParent, &eParent, 'M', dMatch, NULL, pTj->pTag->GetIx(), pTj->pTag->GetVpTag())) != XB_NO_ERROR ){
+          iErrorStop = 160;
+          throw iRc;
+        }
+      } else
+      #endif  // XB_INDEX_SUPPORT
+      {
+        if(( iRc = GetSample( dParent, &eParent, 'D', dNdvParent )) != XB_NO_ERROR ){
+          iErrorStop = 170;
+          throw iRc;
+        }
+        if( dNdvParent > 0 && dNdvChild < dNdvParent )
+          dMatch = dNdvChild / dNdvParent;
+      }
+      if( dMatch < 0 )
+        dMatch = 1;
+    }
+
+    dMatched = dLookups * dMatch * dPerKey;
+    if( pTj->cJoinType == 'L' )
+      pStep->dRows = dLookups * ( 1 - dMatch ) + dMatched;
+    else
+      pStep->dRows = dMatched;
+
+    #ifdef XB_INDEX_SUPPORT
+    if( ts )
+      dCostI = dLookups * ts->iDepth * XB_PLAN_COST_NODE + dMatched * ( XB_PLAN_COST_KEY + XB_PLAN_COST_FETCH );
+    #endif  // XB_INDEX_SUPPORT
+
+    #ifdef XB_HSH_SUPPORT
+    // an automatic join hashes at most XB_REL_HASH_MAX_RECS records, the planner keeps to the same limit
+    if( !ts || ulChildCnt <= XB_REL_HASH_MAX_RECS )
+      dCostH = ulChildCnt * ( XB_PLAN_COST_SCAN + XB_PLAN_COST_HASH_BUILD ) + dLookups * XB_PLAN_COST_HASH_PROBE +
+               dMatched * XB_PLAN_COST_FETCH;
+    #endif  // XB_HSH_SUPPORT
+
+    if( dCostH >= 0 && ( dCostI < 0 || dCostH < dCostI )){
+      pStep->cAccess = 'H';
+      pStep->dCost   = dCostH;
+    } else if( dCostI >= 0 ){
+      pStep->cAccess = 'I';
+      pStep->dCost   = dCostI;
+    } else {
+      iErrorStop = 180;
+      iRc = XB_INVALID_TAG;
+      throw iRc;
+    }
+
+    #ifdef XB_INDEX_SUPPORT
+    if( pTj->pTag ){
+      pStep->pIx      = pTj->pTag->GetIx();
+      pStep->vpTag    = pTj->pTag->GetVpTag();
+      pStep->sTagName = pTj->pTag->GetTagName();
+    }
+    #endif  // XB_INDEX_SUPPORT
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbQryPlan::PlanJoin() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+xbInt16 xbQryPlan::PlanMaster( xbPlanStep *pStep, const xbString &sWhere ){
+
+  // full scan      - N * SCAN
+  // index range    - depth * NODE + keys in range * ( KEY + FETCH )
+  //
+  // A where clause that only references the master table goes to the master table filter,
+  // which can answer it from an index key range.  The filter only reads the range when it
+  // covers less than half the table, ranges past that are left out here as well.
+
+  xbInt16  iRc        = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbDbf    *d         = pStep->pTj->pDbf;
+  xbUInt32 ulRecCnt   = 0;
+  xbDouble dSel;
+
+  try{
+    if(( iRc = d->GetRecordCnt( ulRecCnt )) != XB_NO_ERROR ){
+      iErrorStop = 100;
+      throw iRc;
+    }
+    pStep->cAccess = 'S';
+    pStep->dRows   = ulRecCnt;
+    pStep->dCost   = ulRecCnt * XB_PLAN_COST_SCAN;
+    if( sWhere.Len() == 0 )
+      return XB_NO_ERROR;
+
+    xbExp eWhere( xbase );
+    if(( iRc = eWhere.ParseExpression( d, sWhere )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    xbExpNode *n = eWhere.GetTreeHandle() ? eWhere.GetTreeHandle()->GetFirstNode() : NULL;
+    bWherePushed = xbTrue;
+    while( n && bWherePushed ){
+      if( n->GetNodeType() == XB_EXP_FIELD && n->GetDbf() != d )
+        bWherePushed = xbFalse;
+      n = n->GetNextNode();
+    }
+    if( !bWherePushed || eWhere.GetReturnType() != XB_EXP_LOGICAL ){
+      bWherePushed = xbFalse;
+      return XB_NO_ERROR;
+    }
+
+    if(( iRc = GetSample( d, &eWhere, 'T', dSel )) != XB_NO_ERROR ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+    // nothing matched in the sample, keep the estimate above zero rows
+    if( dSel == 0 )
+      dSel = 0.5 / ( ulRecCnt < XB_PLAN_SAMPLE_RECS ? ulRecCnt : XB_PLAN_SAMPLE_RECS );
+    dWhereSel    = dSel < 0 ? XB_PLAN_DEFAULT_SEL : dSel;
+    pStep->dRows = ulRecCnt * dWhereSel;
+
+    #ifdef XB_INDEX_SUPPORT
+    xbFilter filt( d );
+    if(( iRc = filt.Set( sWhere )) != XB_NO_ERROR ){
+      iErrorStop = 130;
+      throw iRc;
+    }
+    xbFilterRange r;
+    xbPlanTagStats *ts;
+    xbDouble dFrac;
+    xbDouble dKeys;
+    xbDouble dRangeCost;
+    void     *vpTag;
+
+    for( xbIxList *ixl = d->GetIxList(); ixl; ixl = ixl->next ){
+      xbIx *ix = ixl->ix;
+      if( !ix )
+        continue;
+      for( xbInt16 i = 0; i < ix->GetTagCount(); i++ ){
+        vpTag = ix->GetTag( i );
+        if( !vpTag || !filt.GetIxRangeBounds( ix, vpTag, r ))
+          continue;
+
+        xbExp eKey( xbase );
+        if( eKey.ParseExpression( d, ix->GetKeyExpression( vpTag )) != XB_NO_ERROR )
+          continue;
+        if(( iRc = GetSample( d, &eKey, 'R', dFrac, &r )) != XB_NO_ERROR ){
+          iErrorStop = 140;
+          throw iRc;
+        }
+        if( dFrac < 0 )
+          continue;
+        dKeys = dFrac * ulRecCnt;
+        if( dKeys >= ulRecCnt / 2 + 1 )
+          continue;
+        if(( iRc = GetTagStats( d, ix, vpTag, &ts )) != XB_NO_ERROR ){
+          iErrorStop = 150;
+          throw iRc;
+        }
+        dRangeCost = ts->iDepth * XB_PLAN_COST_NODE + dKeys * ( XB_PLAN_COST_KEY + XB_PLAN_COST_FETCH );
+        if( dRangeCost < pStep->dCost ){
+          pStep->cAccess  = 'R';
+          pStep->dCost    = dRangeCost;
+          pStep->pIx      = ix;
+          pStep->vpTag    = vpTag;
+          pStep->sTagName = ix->GetTagName( vpTag );
+        }
+      }
+    }
+    #endif  // XB_INDEX_SUPPORT
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbQryPlan::PlanMaster() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+}              /* namespace       */
+#endif         /*  XB_SQL_SUPPORT */
@@ -1,4 +1,4 @@
-/* xbset.cpp
+/* xbselect.cpp
 
 XBase64 Software Library
 
@@ -21,65 +21,457 @@ namespace xb{
 
 
 /***********************************************************************/
-xbInt16 xbStmt::ExecuteQuery( const xbString &sCmdLine ){
+xbInt16 xbStmt::AddFld( char cType, xbDbf *d, xbInt16 iFldNo, xbExp *e, const xbString &sFldAlias, const xbString &sExp ){
 
-  std::cout << "xbStmt::ExecuteQuery() - SELECT [" << sCmdLine << "]\n";
-  // expected format:
-  //  SELECT 
+  // add a column to the end of the field list
+  xbSqlFld *f = new xbSqlFld;
+  f->cType     = cType;
+  f->dbf       = d;
+  f->iFldNo    = iFldNo;
+  f->pExp      = e;
+  f->sFldAlias = sFldAlias;
+  f->sExp      = sExp;
+  f->Next      = NULL;
 
-  xbInt16  iRc = 0;
+  if( !fl )
+    fl = f;
+  else {
+    xbSqlFld *p = fl;
+    while( p->Next )
+      p = p->Next;
+    p->Next = f;
+  }
+  iColCnt++;
+  return XB_NO_ERROR;
+}
+
+/***********************************************************************/
+#ifdef XB_SORT_SUPPORT
+xbInt16 xbStmt::AddSortCol( const xbString &sExp, xbBool bDescending ){
+
+  // add a column to the end of the sort key, the expression is parsed against the master table
+  xbInt16 iRc;
+  xbExp   *e = new xbExp( xbase );
+  if(( iRc = e->ParseExpression( pTblList->pDbf, sExp )) != XB_NO_ERROR ){
+    delete e;
+    return iRc;
+  }
+  xbSqlSortCol *c = new xbSqlSortCol;
+  c->pExp        = e;
+  c->bDescending = bDescending;
+  c->Next        = NULL;
+
+  if( !pSortCols )
+    pSortCols = c;
+  else {
+    xbSqlSortCol *p = pSortCols;
+    while( p->Next )
+      p = p->Next;
+    p->Next = c;
+  }
+  return XB_NO_ERROR;
+}
+#endif  // XB_SORT_SUPPORT
+
+/***********************************************************************/
+xbInt16 xbStmt::BuildFieldList(){
+
+  // build the column list from the fields part of the select statement
+  //   *               all fields from all tables, in FROM clause order
+  //   tbl.*           all fields from one table
+  //   [tbl.]field     a table field, read directly from the record buffer
+  //   expression      any other column, parsed as a dBASE expression against the master table
+  // each column can be followed by AS name
+
+  xbInt16  iRc        = XB_NO_ERROR;
   xbInt16  iErrorStop = 0;
-  // xbUInt32 ulPos;
+  xbInt16  iParenCnt  = 0;
+  xbInt16  iFldNo;
+  xbInt32  l;
+  xbUInt32 ul;
+  xbUInt32 ulStart    = 1;
+  xbUInt32 ulAsPos;
+  xbUInt32 ulDotPos;
+  xbUInt32 ulLen      = sFields.Len();
+  char     c;
+  char     cQuote     = 0;
+  xbBool   bColRef;
+  xbString sItem;
+  xbString sColAlias;
+  xbString sWork;
+  xbString sQual;
+  xbString sFld;
+  xbString sExp;
+  xbTblJoin *p;
+  xbExp    *e = NULL;
 
   try{
-
-    if(( iRc = ParseStmt( sCmdLine )) != XB_NO_ERROR ){
+    if( ulLen == 0 ){
       iErrorStop = 100;
+      iRc = XB_SYNTAX_ERROR;
       throw iRc;
     }
+    for( ul = 1; ul <= ulLen + 1; ul++ ){
+      c = ( ul <= ulLen ) ? sFields[ul] : ',';
+      if( cQuote ){
+        if( c == cQuote )
+          cQuote = 0;
+        continue;
+      }
+      if( c == '\'' || c == '"' )
+        cQuote = c;
+      else if( c == '(' )
+        iParenCnt++;
+      else if( c == ')' )
+        iParenCnt--;
+      if( c != ',' || iParenCnt != 0 )
+        continue;
 
-/*
-    xbString sCmd = sCmdLine;
-    sCmd.Trim();
-    sCmd.ZapTrailingChar( ';' );
-    sCmd.Trim();
+      // one column, from ulStart to ul - 1
+      sItem.Assign( sFields, ulStart, ul - ulStart );
+      sItem.Trim();
+      ulStart = ul + 1;
+      sColAlias = "";
 
-    // drop off the first node "SET"
-    ulPos = sCmd.Pos( ' ' );
-    sCmd.Ltrunc( ulPos );
-    sCmd.Ltrim();
+      sWork = sItem;
+      sWork.ToUpperCase();
+      ulAsPos = sWork.GetLastPos( " AS " );
+      if( ulAsPos > 0 && ulAsPos > sWork.GetLastPos( '\'' ) && ulAsPos > sWork.GetLastPos( ')' )){
+        sColAlias.Assign( sItem, ulAsPos + 4 );
+        sColAlias.Trim();
+        sItem.Resize( ulAsPos );
+        sItem.Trim();
+      }
+      if( sItem.Len() == 0 ){
+        iErrorStop = 110;
+        iRc = XB_SYNTAX_ERROR;
+        throw iRc;
+      }
+
+      if( sItem == "*" ){
+        for( p = pTblList; p; p = p->next ){
+          for( l = 0; l < p->pDbf->GetFieldCnt(); l++ ){
+            p->pDbf->GetFieldName( (xbInt16) l, sFld );
+            AddFld( 'F', p->pDbf, (xbInt16) l, NULL, sFld );
+          }
+        }
+        continue;
+      }
+
+      // [qualifier.]name, with only one period
+      bColRef  = isalpha( (unsigned char) sItem[1] ) || sItem[1] == '_';
+      ulDotPos = 0;
+      for( xbUInt32 i = 2; i <= sItem.Len() && bColRef; i++ ){
+        if( sItem[i] == '.' && ulDotPos == 0 && i < sItem.Len())
+          ulDotPos = i;
+        else if( sItem[i] == '*' && i == sItem.Len() && ulDotPos == i - 1 )
+          ;
+        else if( !isalnum( (unsigned char) sItem[i] ) && sItem[i] != '_' )
+          bColRef = xbFalse;
+      }
+
+      if( bColRef ){
+        if( ulDotPos > 0 ){
+          sQual.Assign( sItem, 1, ulDotPos - 1 );
+          sFld.Assign( sItem, ulDotPos + 1 );
+          if(( p = FindQryTbl( sQual )) == NULL ){
+            iErrorStop = 120;
+            iRc = XB_INVALID_TABLE_NAME;
+            throw iRc;
+          }
+          if( sFld == "*" ){
+            for( l = 0; l < p->pDbf->GetFieldCnt(); l++ ){
+              p->pDbf->GetFieldName( (xbInt16) l, sFld );
+              AddFld( 'F', p->pDbf, (xbInt16) l, NULL, sFld );
+            }
+            continue;
+          }
+          if(( iRc = p->pDbf->GetFieldNo( sFld, iFldNo )) != XB_NO_ERROR ){
+            iErrorStop = 130;
+            throw iRc;
+          }
+        } else {
+          // unqualified, take the first table in the list with the field
+          sFld = sItem;
+          for( p = pTblList; p && p->pDbf->GetFieldNo( sFld, iFldNo ) != XB_NO_ERROR; p = p->next )
+            ;
+          if( !p ){
+            iErrorStop = 140;
+            iRc = XB_INVALID_FIELD_NAME;
+            throw iRc;
+          }
+        }
+        if( sColAlias.Len() == 0 )
+          p->pDbf->GetFieldName( iFldNo, sColAlias );
+        AddFld( 'F', p->pDbf, iFldNo, NULL, sColAlias );
+
+      } else {
+        if(( iRc = CvtSqlExp2DbaseExp( sItem, sExp )) != XB_NO_ERROR ){
+          iErrorStop = 150;
+          throw iRc;
+        }
+        e = new xbExp( xbase );
+        if(( iRc = e->ParseExpression( pTblList->pDbf, sExp )) != XB_NO_ERROR ){
+          iErrorStop = 160;
+          throw iRc;
+        }
+        if( sColAlias.Len() == 0 )
+          sColAlias = sItem;
+        AddFld( 'E', pTblList->pDbf, -1, e, sColAlias, sExp );
+        e = NULL;
+      }
+    }
+  }
+  catch (xbInt16 iRc ){
+    if( e )
+      delete e;
+    xbString sMsg;
+    sMsg.Sprintf( "xbStmt::BuildFieldList() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
 
-    xbString sNode1 = sCmd;
-    sNode1.ToUpperCase();
+/***********************************************************************/
+#ifdef XB_SORT_SUPPORT
+xbInt16 xbStmt::BuildSortList(){
 
-    if( sNode1 == "SET" ) {
-        uda.DumpUda();
+  // build the sort key from the ORDER BY clause, followed by every column of the select list for DISTINCT
+  //   column alias or number    sorts on that column of the select list
+  //   expression                any other item, parsed as a dBASE expression against the master table
+  // each item can be followed by ASC or DESC
+  // with DISTINCT, the ORDER BY items must be columns of the select list
 
-    } else {
+  xbInt16  iRc        = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbInt16  iParenCnt  = 0;
+  xbInt16  iColNo;
+  xbUInt32 ul;
+  xbUInt32 ulStart    = 1;
+  xbUInt32 ulLen      = sOrderBy.Len();
+  char     c;
+  char     cQuote     = 0;
+  xbBool   bDescending;
+  xbBool   bNumber;
+  xbString sItem;
+  xbString sWork;
+  xbString sName;
+  xbString sExp;
+  xbSqlFld *f;
 
-      xbString sKey;
-      sKey.ExtractElement( sCmd, '=', 1, 0 );
-      sKey.Trim();
+  try{
+    for( ul = 1; ulLen > 0 && ul <= ulLen + 1; ul++ ){
+      c = ( ul <= ulLen ) ? sOrderBy[ul] : ',';
+      if( cQuote ){
+        if( c == cQuote )
+          cQuote = 0;
+        continue;
+      }
+      if( c == '\'' || c == '"' )
+        cQuote = c;
+      else if( c == '(' )
+        iParenCnt++;
+      else if( c == ')' )
+        iParenCnt--;
+      if( c != ',' || iParenCnt != 0 )
+        continue;
 
-      xbString sToken;
-      sToken.ExtractElement( sCmd, '=', 2, 0 );
-      sToken.Trim();
+      // one sort item, from ulStart to ul - 1
+      sItem.Assign( sOrderBy, ulStart, ul - ulStart );
+      sItem.Trim();
+      ulStart = ul + 1;
 
+      bDescending = xbFalse;
+      sWork = sItem;
+      sWork.ToUpperCase();
+      if( sWork.Len() > 5 && sWork.GetLastPos( " DESC" ) == sWork.Len() - 4 ){
+        bDescending = xbTrue;
+        sItem.Resize( sItem.Len() - 4 );
+      } else if( sWork.Len() > 4 && sWork.GetLastPos( " ASC" ) == sWork.Len() - 3 ){
+        sItem.Resize( sItem.Len() - 3 );
+      }
+      sItem.Trim();
+      if( sItem.Len() == 0 ){
+        iErrorStop = 100;
+        iRc = XB_SYNTAX_ERROR;
+        throw iRc;
+      }
 
-      if( sToken == '^' ){
-        if(( iRc = uda.DelTokenForKey( sKey )) != XB_NO_ERROR ){
-          iErrorStop = 100;
-          throw iRc;
+      // column number or column alias
+      bNumber = xbTrue;
+      for( xbUInt32 i = 1; i <= sItem.Len(); i++ )
+        if( !isdigit( (unsigned char) sItem[i] ))
+          bNumber = xbFalse;
+      sWork = sItem;
+      sWork.ToUpperCase();
+      iColNo = 1;
+      for( f = fl; f; f = f->Next, iColNo++ ){
+        if( bNumber ){
+          if( iColNo == atoi( sItem.Str()))
+            break;
+        } else {
+          sName = f->sFldAlias;
+          sName.ToUpperCase();
+          if( sName == sWork )
+            break;
         }
-      } else {
-        if(( iRc = uda.UpdTokenForKey( sKey, sToken )) != XB_NO_ERROR ){
-          iErrorStop = 110;
+      }
+
+      if( f ){
+        GetColExp( f, sExp );
+      } else if( bNumber ){
+        iErrorStop = 110;
+        iRc = XB_INVALID_FIELD_NO;
+        throw iRc;
+      } else if( bDistinct ){
+        iErrorStop = 120;
+        iRc = XB_INVALID_OPTION;
+        throw iRc;
+      } else if(( iRc = CvtSqlExp2DbaseExp( sItem, sExp )) != XB_NO_ERROR ){
+        iErrorStop = 130;
+        throw iRc;
+      }
+      if(( iRc = AddSortCol( sExp, bDescending )) != XB_NO_ERROR ){
+        iErrorStop = 140;
+        throw iRc;
+      }
+    }
+
+    if( bDistinct ){
+      for( f = fl; f; f = f->Next ){
+        GetColExp( f, sExp );
+        if(( iRc = AddSortCol( sExp, xbFalse )) != XB_NO_ERROR ){
+          iErrorStop = 150;
           throw iRc;
         }
       }
     }
-*/
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbStmt::BuildSortList() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+#endif  // XB_SORT_SUPPORT
+
+/***********************************************************************/
+xbInt16 xbStmt::ExecuteQuery( const xbString &sCmdLine ){
+
+  // expected format:
+  //  [EXPLAIN] SELECT [DISTINCT] fields FROM table [alias] [LEFT | INNER JOIN table [alias] ON exp = exp ...] [WHERE exp]
+  //      [ORDER BY item [ASC | DESC], ...]
+  //
+  // The statement is parsed, the access paths planned and the cursor opened, no rows are read
+  // until the first fetch.  EXPLAIN prints the plan to the console instead of opening the cursor.
+  // ORDER BY and DISTINCT read and sort all the rows when the cursor is opened.
+
+  xbInt16  iRc = 0;
+  xbInt16  iErrorStop = 0;
+  xbString sCmd;
+  xbString sToken;
+  xbString sWhereExp;
+  xbString sPlan;
+  xbBool   bExplain = xbFalse;
+
+  try{
+    Reset();
+
+    sCmd = sCmdLine;
+    sCmd.Trim();
+    sCmd.ZapTrailingChar( ';' );
+    sCmd.Trim();
+
+    GetNextToken( sCmd, sToken, 1 );
+    sToken.ToUpperCase();
+    if( sToken == "EXPLAIN" ){
+      bExplain = xbTrue;
+      sCmd.Ltrunc( sToken.Len());
+      sCmd.Ltrim();
+      GetNextToken( sCmd, sToken, 1 );
+      sToken.ToUpperCase();
+    }
+    if( sToken != "SELECT" ){
+      iErrorStop = 100;
+      iRc = XB_SYNTAX_ERROR;
+      throw iRc;
+    }
+
+    if(( iRc = ParseStmt( sCmd )) != XB_NO_ERROR ){
+      iErrorStop = 110;
+      throw iRc;
+    }
+    if( !pTblList ){
+      iErrorStop = 120;
+      iRc = XB_SYNTAX_ERROR;
+      throw iRc;
+    }
+
+    GetNextToken( sFields, sToken, 1 );
+    sToken.ToUpperCase();
+    if( sToken == "DISTINCT" ){
+      bDistinct = xbTrue;
+      sFields.Ltrunc( sToken.Len());
+      sFields.Ltrim();
+    }
+
+    // grouping is not supported yet
+    #ifdef XB_SORT_SUPPORT
+    if( sGroupBy.Len() > 0 || sHaving.Len() > 0 ){
+    #else
+    if( bDistinct || sOrderBy.Len() > 0 || sGroupBy.Len() > 0 || sHaving.Len() > 0 ){
+    #endif  // XB_SORT_SUPPORT
+      iErrorStop = 130;
+      iRc = XB_INVALID_OPTION;
+      throw iRc;
+    }
+
+    if(( iRc = BuildFieldList()) != XB_NO_ERROR ){
+      iErrorStop = 140;
+      throw iRc;
+    }
+    #ifdef XB_SORT_SUPPORT
+    if(( iRc = BuildSortList()) != XB_NO_ERROR ){
+      iErrorStop = 180;
+      throw iRc;
+    }
+    #endif  // XB_SORT_SUPPORT
+
+    if(( iRc = CvtSqlExp2DbaseExp( sWhere, sWhereExp )) != XB_NO_ERROR ){
+      iErrorStop = 150;
+      throw iRc;
+    }
+    if( !pPlan )
+      pPlan = new xbQryPlan( xbase );
+    if(( iRc = pPlan->Build( pTblList, sWhereExp )) != XB_NO_ERROR ){
+      iErrorStop = 160;
+      throw iRc;
+    }
+    if( bExplain ){
+      pPlan->GetPlanText( sPlan );
+      #ifdef XB_SORT_SUPPORT
+      if( pSortCols )
+        sPlan += bDistinct ? "Rows sorted for DISTINCT\n" : "Rows sorted for ORDER BY\n";
+      #endif  // XB_SORT_SUPPORT
+      std::cout << sPlan.Str();
+      return XB_NO_ERROR;
+    }
 
+    if( !pCursor )
+      pCursor = new xbCursor( xbase );
+    if(( iRc = pCursor->Open( pTblList, sWhereExp, pPlan )) != XB_NO_ERROR ){
+      iErrorStop = 170;
+      throw iRc;
+    }
+    #ifdef XB_SORT_SUPPORT
+    if( pSortCols && ( iRc = pCursor->SortRows( pSortCols, bDistinct )) != XB_NO_ERROR ){
+      iErrorStop = 190;
+      throw iRc;
+    }
+    #endif  // XB_SORT_SUPPORT
   }
   catch (xbInt16 iRc ){
     xbString sMsg;
@@ -91,6 +483,153 @@ xbInt16 xbStmt::ExecuteQuery( const xbString &sCmdLine ){
   return iRc;
 }
 
+/***********************************************************************/
+xbInt16 xbStmt::FetchFirst(){
+  if( !pCursor )
+    return XB_NOT_OPEN;
+  return pCursor->Fetch( 'F' );
+}
+/***********************************************************************/
+xbInt16 xbStmt::FetchLast(){
+  if( !pCursor )
+    return XB_NOT_OPEN;
+  return pCursor->Fetch( 'L' );
+}
+/***********************************************************************/
+xbInt16 xbStmt::FetchNext(){
+  if( !pCursor )
+    return XB_NOT_OPEN;
+  return pCursor->Fetch( 'N' );
+}
+/***********************************************************************/
+xbInt16 xbStmt::FetchPrev(){
+  if( !pCursor )
+    return XB_NOT_OPEN;
+  return pCursor->Fetch( 'P' );
+}
+/***********************************************************************/
+xbInt16 xbStmt::GetColCount() const {
+  return iColCnt;
+}
+/***********************************************************************/
+xbInt16 xbStmt::GetColName( xbInt16 iColNo, xbString &sColName ) const {
+
+  xbSqlFld *f = fl;
+  for( xbInt16 i = 0; f && i < iColNo; i++ )
+    f = f->Next;
+  if( iColNo < 0 || !f ){
+    sColName = "";
+    return XB_INVALID_FIELD_NO;
+  }
+  sColName = f->sFldAlias;
+  return XB_NO_ERROR;
+}
+/***********************************************************************/
+xbInt16 xbStmt::GetField( xbInt16 iColNo, xbString &sValue ){
+
+  // column values are taken from the current record of each table when asked for
+  // table fields are returned as stored, expressions are evaluated for the current row
+
+  xbInt16  iRc        = XB_NO_ERROR;
+  xbInt16  iErrorStop = 0;
+  xbSqlFld *f         = fl;
+
+  try{
+    for( xbInt16 i = 0; f && i < iColNo; i++ )
+      f = f->Next;
+    if( iColNo < 0 || !f ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_FIELD_NO;
+      throw iRc;
+    }
+
+    if( f->cType == 'F' ){
+      if(( iRc = f->dbf->GetField( f->iFldNo, sValue )) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+      return iRc;
+    }
+
+    if(( iRc = f->pExp->ProcessExpression()) != XB_NO_ERROR ){
+      iErrorStop = 120;
+      throw iRc;
+    }
+    switch( f->pExp->GetReturnType()){
+      case XB_EXP_CHAR:
+        iRc = f->pExp->GetStringResult( sValue );
+        break;
+
+      case XB_EXP_NUMERIC:{
+        xbDouble d;
+        if(( iRc = f->pExp->GetNumericResult( d )) == XB_NO_ERROR ){
+          sValue.Sprintf( "%f", d );
+          sValue.ZapTrailingChar( '0' );
+          sValue.ZapTrailingChar( '.' );
+        }
+        break;
+      }
+      case XB_EXP_DATE:{
+        xbDate dt;
+        if(( iRc = f->pExp->GetDateResult( dt )) == XB_NO_ERROR )
+          sValue = dt.Str();
+        break;
+      }
+      case XB_EXP_LOGICAL:{
+        xbBool b;
+        if(( iRc = f->pExp->GetBoolResult( b )) == XB_NO_ERROR )
+          sValue = b ? "T" : "F";
+        break;
+      }
+      default:
+        iRc = XB_INVALID_EXPRESSION;
+        break;
+    }
+    if( iRc != XB_NO_ERROR ){
+      iErrorStop = 130;
+      throw iRc;
+    }
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbStmt::GetField() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
+/***********************************************************************/
+xbInt16 xbStmt::GetField( const xbString &sColName, xbString &sValue ){
+
+  xbString sName;
+  xbString sTarget = sColName;
+  sTarget.ToUpperCase();
+
+  xbInt16  i = 0;
+  xbSqlFld *f = fl;
+  while( f ){
+    sName = f->sFldAlias;
+    sName.ToUpperCase();
+    if( sName == sTarget )
+      return GetField( i, sValue );
+    f = f->Next;
+    i++;
+  }
+  sValue = "";
+  return XB_INVALID_FIELD_NAME;
+}
+
+/***********************************************************************/
+xbInt16 xbStmt::GetPlan( xbString &sPlan ) const {
+
+  // text of the plan for the last query, same as printed by EXPLAIN
+  if( !pPlan || pPlan->GetStepCnt() == 0 ){
+    sPlan = "";
+    return XB_NOT_OPEN;
+  }
+  pPlan->GetPlanText( sPlan );
+  return XB_NO_ERROR;
+}
 /***********************************************************************/
 }              /* namespace       */
 #endif         /*  XB_SQL_SUPPORT */
@@ -152,7 +152,7 @@ void xbSql::SqlHelp() const {
   std::cout << "DROP INDEX [IF EXISTS] ixname.NDX ON tablename.DBF"                                             << std::endl;
   std::cout << "DROP TABLE [IF EXISTS] tablename.DBF"                                                           << std::endl;
   std::cout << "INSERT INTO tablename (field1, field2, field3,...) VALUES ( 'charval', numval, {MM/DD/YY})"     << std::endl;
-  std::cout << "SELECT FIELD1,FIELD2...  FROM TABLE.DBF [WHERE expression] [ORDER BY TAG TAGNAME"               << std::endl;
+  std::cout << "SELECT [DISTINCT] FIELD1,FIELD2...  FROM TABLE.DBF [WHERE expression] [ORDER BY item [ASC|DESC],...]" << std::endl;
   std::cout << "SET ATTRIBUTE = DATAVALUE"                                                                      << std::endl;
   std::cout << "SET ATTRIBUTE = ^    (to delete an entry)"                                                      << std::endl;
   std::cout << "USE /dir/to/dbf/tables"                                                                         << std::endl;
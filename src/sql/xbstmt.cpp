@@ -23,7 +23,14 @@ namespace xb{
 xbStmt::xbStmt( xbXBase *x ){
    xbase        = x;
    pTblList     = NULL;
+   pCursor      = NULL;
+   pPlan        = NULL;
    fl           = NULL;
+   iColCnt      = 0;
+   bDistinct    = xbFalse;
+   #ifdef XB_SORT_SUPPORT
+   pSortCols    = NULL;
+   #endif  // XB_SORT_SUPPORT
    ulFromPos    = 0;
    ulWherePos   = 0;
    ulOrderByPos = 0;
@@ -33,48 +40,83 @@ xbStmt::xbStmt( xbXBase *x ){
 
 /***********************************************************************/
 xbStmt::~xbStmt(){
-
-  std::cout << "xbStmt::~xbStmt()  - need to release all allocated structures and memory here\n";
-
+  Reset();
+  if( pCursor )
+    delete pCursor;
+  if( pPlan )
+    delete pPlan;
 }
 
 /***********************************************************************/
 xbInt16  xbStmt::CvtSqlExp2DbaseExp( const xbString &sExpIn, xbString &sExpOut ){
 
   // convert Ansi SQL expression to a dBASE compatible expression
+  //   qualifier.fieldname  to  tablealias->fieldname, where the qualifier is the
+  //                            table name or the alias given in the FROM clause
+  //   AND, OR, NOT         to  .AND., .OR., .NOT.
+  // quoted strings and numeric constants are copied as is
+
+  xbUInt32 ulLen   = sExpIn.Len();
+  xbUInt32 ulPos   = 1;
+  xbUInt32 ulStart;
+  char     c;
+  char     cQuote;
+  xbString sWord;
+  xbString sUpper;
+  xbTblJoin *pTj;
 
-  xbInt16  iRc        = 0;
-  xbInt16  iErrorStop = 0;
-
-  try{
-
-    // convert   tablename.fieldname   to   tablename->fieldname
-    sExpOut = sExpIn[1];
-    xbUInt32 ulPos = 2;
-    while( ulPos < sExpIn.Len() ){
-      if( sExpIn[ulPos] == '.' && sExpIn[ulPos-1] != ' ' && sExpIn[ulPos+1] != ' ' )
+  sExpOut = "";
+  while( ulPos <= ulLen ){
+    c = sExpIn[ulPos];
+    if( c == '\'' || c == '"' ){
+      cQuote = c;
+      do{
+        sExpOut += sExpIn[ulPos++];
+      } while( ulPos <= ulLen && sExpIn[ulPos] != cQuote );
+      if( ulPos <= ulLen )
+        sExpOut += sExpIn[ulPos++];
+
+    } else if( isdigit( (unsigned char) c )){
+      while( ulPos <= ulLen && ( isalnum( (unsigned char) sExpIn[ulPos] ) || sExpIn[ulPos] == '.' ))
+        sExpOut += sExpIn[ulPos++];
+
+    } else if( isalpha( (unsigned char) c ) || c == '_' ){
+      ulStart = ulPos;
+      while( ulPos <= ulLen && ( isalnum( (unsigned char) sExpIn[ulPos] ) || sExpIn[ulPos] == '_' ))
+        ulPos++;
+      sWord.Assign( sExpIn, ulStart, ulPos - ulStart );
+
+      // words directly after a period are dBASE operators (.AND.) or constants (.T.)
+      if( ulStart > 1 && sExpIn[ulStart-1] == '.' ){
+        sExpOut += sWord;
+
+      } else if( ulPos < ulLen && sExpIn[ulPos] == '.' &&
+                 ( isalpha( (unsigned char) sExpIn[ulPos+1] ) || sExpIn[ulPos+1] == '_' )){
+        if(( pTj = FindQryTbl( sWord )) != NULL )
+          GetTblRef( pTj, sWord );
+        sExpOut += sWord;
         sExpOut += "->";
-      else
-        sExpOut += sExpIn[ulPos];
+        ulPos++;
+
+      } else {
+        sUpper = sWord;
+        sUpper.ToUpperCase();
+        if( sUpper == "AND" || sUpper == "OR" || sUpper == "NOT" ){
+          sExpOut += '.';
+          sExpOut += sUpper;
+          sExpOut += '.';
+        } else {
+          sExpOut += sWord;
+        }
+      }
+    } else {
+      sExpOut += c;
       ulPos++;
     }
-    sExpOut += sExpIn[ulPos];
-
-    sExpOut.Replace( " AND ", " .AND. ", 0 );
-    sExpOut.Replace( " and ", " .AND. ", 0 );
-    sExpOut.Replace( " OR ",  " .OR. ",  0 );
-    sExpOut.Replace( " or ",  " .OR. ",  0 );
   }
-  catch (xbInt16 iRc ){
-    xbString sMsg;
-    sMsg.Sprintf( "xbStmt::CvtSqlExp2DbaseExp() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
-    xbase->WriteLogMessage( sMsg.Str() );
-    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
-  }
-  return iRc;
+  return XB_NO_ERROR;
 }
 
-
 /***********************************************************************/
 #ifdef XB_DEBUG_SUPPORT
 xbInt16 xbStmt::DumpStmtInternals(){
@@ -94,6 +136,12 @@ xbInt16 xbStmt::DumpStmtInternals(){
     std::cout << "Type,Name,Alias,Exp\n";
     while( p ){
       std::cout << p->cJoinType << "," << p->sTableName.Str() << "," << p->sAlias.Str() << "," << p->sJoinExp.Str() << "\n";
+      if( p->pMaster ){
+        std::cout << "  Parent [" << p->sParentExp.Str() << "] Child [" << p->sChildExp.Str() << "] Tag [";
+        if( p->pTag )
+          std::cout << p->pTag->GetTagName().Str();
+        std::cout << "]\n";
+      }
       p = p->next;
     }
   }
@@ -123,6 +171,57 @@ xbInt16 xbStmt::Test(){
 #endif  // XB_DEBUG_SUPPORT
 
 
+/***********************************************************************/
+xbTblJoin *xbStmt::FindQryTbl( const xbString &sQualifier ) const {
+
+  // find the table in the FROM clause for a column qualifier
+  // the qualifier can be the alias, or the table name with or without the .DBF extension
+  xbString sQual = sQualifier;
+  xbString sName;
+  sQual.ToUpperCase();
+
+  xbTblJoin *p = pTblList;
+  while( p ){
+    sName = p->sAlias;
+    sName.ToUpperCase();
+    if( sName.Len() > 0 && sName == sQual )
+      return p;
+    sName = p->sTableName;
+    sName.ToUpperCase();
+    if( sName == sQual )
+      return p;
+    if( sName.Len() > 4 && sName.Pos( ".DBF" ) == sName.Len() - 3 ){
+      sName.Resize( sName.Len() - 3 );
+      if( sName == sQual )
+        return p;
+    }
+    p = p->next;
+  }
+  return NULL;
+}
+
+/***********************************************************************/
+void xbStmt::GetColExp( const xbSqlFld *f, xbString &sExp ) const {
+
+  // dBASE expression for a column of the select list
+  // table fields are qualified with the table reference, so they can be parsed against the master table
+  if( f->cType == 'F' ){
+    const xbTblJoin *p = pTblList;
+    while( p && p->pDbf != f->dbf )
+      p = p->next;
+    xbString sFld;
+    f->dbf->GetFieldName( f->iFldNo, sFld );
+    if( p ){
+      GetTblRef( p, sExp );
+      sExp += "->";
+      sExp += sFld;
+    } else {
+      sExp = sFld;
+    }
+  } else {
+    sExp = f->sExp;
+  }
+}
 /***********************************************************************/
 xbInt16 xbStmt::GetNextFromSeg( const xbString &sLineIn, xbString &sFromSegOut ){
 
@@ -132,6 +231,8 @@ xbInt16 xbStmt::GetNextFromSeg( const xbString &sLineIn, xbString &sFromSegOut )
   xbUInt32 ulPos      = 1;
   xbUInt32 ulTsp      = 0;            // token start position
   xbBool   bDone      = xbFalse;
+  xbBool   bJoinWord;
+  xbBool   bPrevJoinWord = xbFalse;
   xbString sToken;
 
   try{
@@ -143,13 +244,16 @@ xbInt16 xbStmt::GetNextFromSeg( const xbString &sLineIn, xbString &sFromSegOut )
 
       } else {
         iParenCtr += GetParenCnt( sToken );
-        if( iParenCtr == 0 && ulPos > 1  ){
-          sToken.ToUpperCase();
-          if( sToken == "LEFT" || sToken == "RIGHT" || sToken == "FULL" ||
-              sToken == "INNER" || sToken == "OUTER" || sToken[1] == '(' ){
+        sToken.ToUpperCase();
+        bJoinWord = ( sToken == "LEFT" || sToken == "RIGHT" || sToken == "FULL" ||
+                      sToken == "INNER" || sToken == "OUTER" || sToken == "JOIN" );
+        // the first keyword of "LEFT OUTER JOIN" starts the segment, the rest belong to it
+        if( iParenCtr == 0 && ulPos > 1 && !bPrevJoinWord ){
+          if( bJoinWord || sToken[1] == '(' ){
             bDone = xbTrue;
           }
         }
+        bPrevJoinWord = bJoinWord;
       }
       ulPos += (sToken.Len() + 1);
     }
@@ -165,6 +269,25 @@ xbInt16 xbStmt::GetNextFromSeg( const xbString &sLineIn, xbString &sFromSegOut )
   return iRc;
 }
 
+/***********************************************************************/
+void xbStmt::GetTblRef( const xbTblJoin *pTj, xbString &sTblRef ) const {
+
+  // name used for the table in a dBASE expression, the table alias
+  // a table opened without an alias is known by its table name
+  sTblRef = pTj->pDbf->GetTblAlias();
+  if( sTblRef.Len() == 0 ){
+    sTblRef = pTj->sTableName;
+    sTblRef.SwapChars( '\\', '/' );
+    xbUInt32 ulPos = sTblRef.GetLastPos( '/' );
+    if( ulPos > 0 )
+      sTblRef.Ltrunc( ulPos );
+    xbString sWork = sTblRef;
+    sWork.ToUpperCase();
+    ulPos = sWork.Pos( ".DBF" );
+    if( ulPos > 0 )
+      sTblRef.Resize( ulPos );
+  }
+}
 /***********************************************************************/
 
 xbUInt32 xbStmt::GetNextToken( const xbString &sCmdLineIn, xbString &sTokenOut, xbUInt32 ulStartPos ){
@@ -214,8 +337,6 @@ xbInt16 xbStmt::ParseFromStmt( const xbString &sFromLine ){
   xbString sLine = sFromLine;
 
   try{
-    std::cout << "ParseFromSeg [" << sFromLine.Str() << "]\n";
-
     while( !bDone ){
       if(( iRc = GetNextFromSeg( sLine, sFromSeg)) != XB_NO_ERROR ){
         iErrorStop = 100;
@@ -266,8 +387,6 @@ xbInt16 xbStmt::ParseStmt( const xbString &sCmdLine ){
 
   try{
 
-    std::cout << "ParseStmt - [" << sStmt << "]\n";
-
     xbUInt32 ulPos = ulStartPos;
 
     while( !bFromFound && !bDone ){
@@ -321,6 +440,7 @@ xbInt16 xbStmt::ParseStmt( const xbString &sCmdLine ){
       ulPos = ulFromPos + 5;
     else
       ulPos = ulStartPos;
+    xbUInt32 ulClausePos = ulPos;     // group by and having are looked for from here too, they can come before order by
 
     bDone = xbFalse;
     while( !bOrderByFound && !bDone ){
@@ -350,6 +470,7 @@ xbInt16 xbStmt::ParseStmt( const xbString &sCmdLine ){
 
 
     bDone = xbFalse;
+    ulPos = ulClausePos;
     while( !bGroupByFound && !bDone ){
       ulPos = GetNextToken( sStmt, sToken, ulPos );
       if( sToken == "" ){
@@ -376,6 +497,7 @@ xbInt16 xbStmt::ParseStmt( const xbString &sCmdLine ){
     }
 
     bDone = xbFalse;
+    ulPos = ulClausePos;
     while( !bHavingFound && !bDone ){
       ulPos = GetNextToken( sStmt, sToken, ulPos );
       if( sToken == "" ){
@@ -421,9 +543,10 @@ xbInt16 xbStmt::ParseStmt( const xbString &sCmdLine ){
         ulLen = ulGroupByPos - ulFromPos;
       else if( bHavingFound )
         ulLen = ulHavingPos - ulFromPos;
-      else 
-        ulLen = sStmt.Len() - ulFromPos;
-      sFrom.Resize( ulLen );
+      else
+        ulLen = 0;             // FROM runs to the end of the statement
+      if( ulLen > 0 )
+        sFrom.Resize( ulLen );
       sFrom.Trim();
 
     }
@@ -447,13 +570,14 @@ xbInt16 xbStmt::ParseStmt( const xbString &sCmdLine ){
     // FIXME if there is more than one space between ORDER and BY then this doesn't work quite right
     // do the ORDER BY part
     if( bOrderByFound ){
-      if( bGroupByFound )
+      if( bGroupByFound && ulGroupByPos > ulOrderByPos )
         ulLen = ulGroupByPos - ulOrderByPos - 9;
-      else if( bHavingFound )
+      else if( bHavingFound && ulHavingPos > ulOrderByPos )
         ulLen = ulHavingPos - ulOrderByPos - 9;
-      else 
-        ulLen = sStmt.Len() - ulOrderByPos - 9;
-      sOrderBy.Resize( ulLen );
+      else
+        ulLen = 0;
+      if( ulLen > 0 )
+        sOrderBy.Resize( ulLen );
       sOrderBy.Trim();
     }
 
@@ -462,9 +586,10 @@ xbInt16 xbStmt::ParseStmt( const xbString &sCmdLine ){
     if( bGroupByFound ){
       if( bHavingFound )
         ulLen = ulHavingPos - ulGroupByPos - 9;
-      else 
-        ulLen = sStmt.Len() - ulGroupByPos - 9;
-      sGroupBy.Resize( ulLen );
+      else
+        ulLen = 0;
+      if( ulLen > 0 )
+        sGroupBy.Resize( ulLen );
       sGroupBy.Trim();
     }
 
@@ -497,20 +622,16 @@ xbInt16 xbStmt::ProcessFromSeg( const xbString &sFromSeg ){
   xbString sTable;
   xbString sAlias;
   xbString sWork;
-  xbString sExp;
+  xbString sOn;
   xbUInt32 iPos;
   xbBool   bDone;
-  xbExp    * pJoinExp = NULL;
+  xbTblJoin *pTj = NULL;
 
   try{
 
-    std::cout << "ProcessFromSeg for segment [" << sFromSeg.Str() << "]\n";
-
     GetNextToken( sFromSeg, sToken, 1 );
     sToken.ToUpperCase();
 
-    std::cout << "sToken1 = [" << sToken.Str() << "]\n";
-
     if( sToken == "FROM" ){
       // FROM has to be the first statement, and exist only once
       if( pTblList ){
@@ -523,123 +644,296 @@ xbInt16 xbStmt::ProcessFromSeg( const xbString &sFromSeg ){
       cType = 'L';
     else if( sToken == "RIGHT" )
       cType = 'R';
-    else if( sToken == "RIGHT" )
-      cType = 'R';
-    else if( sToken == "INNER" )
+    else if( sToken == "INNER" || sToken == "JOIN" )
       cType = 'I';
     else if( sToken == "OUTER" || sToken == "FULL" )
       cType = 'O';
     else if( sToken[1] == '(' )
       cType = 'Q';
     else{
-      iErrorStop = 100;
+      iErrorStop = 110;
+      iRc = XB_PARSE_ERROR;
+      throw iRc;
+    }
+
+    if( cType != 'M' && !pTblList ){
+      iErrorStop = 120;
       iRc = XB_PARSE_ERROR;
       throw iRc;
     }
 
+    // right and full outer joins and sub queries are not supported yet
+    if( cType == 'R' || cType == 'O' || cType == 'Q' ){
+      iErrorStop = 130;
+      iRc = XB_INVALID_OPTION;
+      throw iRc;
+    }
 
     if( cType == 'M' ){
       // expecting "FROM table"  or "FROM table alias"
       iPos = GetNextToken( sFromSeg, sToken, 5 );
       sTable = sToken;
+      GetNextToken( sFromSeg, sAlias, iPos + sToken.Len() + 1 );
 
-      iPos = GetNextToken( sFromSeg, sToken, iPos + sToken.Len() + 1 );
-      if( sToken.Len() > 0 )
-        sAlias = sToken;
-      else
-        sAlias = "";
-
-      sWork = sToken;
-      sWork.ToUpperCase();
-      iPos = sWork.Pos( ".DBF" );
-      if( iPos == 0 )
-        sTable += ".DBF";
-
-   //   std::cout << "table = [" << sTable.Str() << "] alias = [" << sAlias.Str() << "]\n";
-
-    } else if( cType != 'Q' ){
+    } else {
       sWork = sFromSeg;
       sWork.ToUpperCase();
       iPos = sWork.Pos( " ON " );
       if( iPos == 0 ){
-        iErrorStop = 110;
+        iErrorStop = 140;
         iRc = XB_PARSE_ERROR;
         throw iRc;
       }
-      bDone = xbFalse;
+      sOn.Assign( sFromSeg, iPos + 4 );
+      sOn.Trim();
 
-      sWork.Assign( sFromSeg, iPos + 4 );
-      CvtSqlExp2DbaseExp( sWork, sExp );
-      sExp.Trim();
-      std::cout << "ON = [" << sExp.Str() << "]\n";
-
-
-      // need to get past the keywords LEFT, FULL, OUTER, RIGHT, INNER and get the table name here
-      iPos = sToken.Len() + 1;
+      // need to get past the keywords LEFT, OUTER, INNER, JOIN and get the table name here
+      bDone = xbFalse;
+      iPos  = 1;
       while( !bDone ){
         iPos = GetNextToken( sFromSeg, sToken, iPos );
         sWork = sToken;
         sWork.ToUpperCase();
-        if( sWork != "LEFT" && sWork != "RIGHT" && sWork != "INNER" && sWork != "OUTER" && sWork != "FULL" && sWork != "JOIN" )
+        if( sWork != "LEFT" && sWork != "INNER" && sWork != "OUTER" && sWork != "JOIN" )
           bDone = xbTrue;
         else
           iPos += (sWork.Len() + 1);
       }
-
       sTable = sToken;
       GetNextToken( sFromSeg, sAlias, iPos + sTable.Len() + 1 );
-      sWork.ToUpperCase();
-      iPos = sWork.Pos( ".DBF" );
-      if( iPos == 0 )
-        sTable += ".DBF";
-      sWork = sAlias;
-      sWork.ToUpperCase();
-      if( sWork == "ON" )
-        sAlias = "";
     }
 
-
-    // open table
-    //std::cout << "attempting to open table " << sTable.Str() << "\n";
-    xbDbf *d = NULL;
-    //if(( iRc = xbase->OpenHighestVersion( sTable, sAlias, &d )) != XB_NO_ERROR ){
-    if(( iRc = xbase->Open( sTable, sAlias, &d )) != XB_NO_ERROR ){
-      iErrorStop = 120;
+    if( sTable.Len() == 0 ){
+      iErrorStop = 150;
+      iRc = XB_PARSE_ERROR;
       throw iRc;
     }
+    sWork = sTable;
+    sWork.ToUpperCase();
+    if( sWork.Pos( ".DBF" ) == 0 )
+      sTable += ".DBF";
+    sWork = sAlias;
+    sWork.ToUpperCase();
+    if( sWork == "ON" || sWork == "AS" )
+      sAlias = "";
+
+    // use the table if it is already open, otherwise open it
+    xbDbf *d = xbase->GetDbfPtr( sTable );
+    if( !d ){
+      if(( iRc = xbase->Open( sTable, sAlias, &d )) != XB_NO_ERROR ){
+        iErrorStop = 160;
+        throw iRc;
+      }
+    }
 
+    if(( iRc = UpdateJoinList( cType, sTable, sAlias, d, &pTj )) != XB_NO_ERROR ){
+      iErrorStop = 170;
+      throw iRc;
+    }
 
-
-    // build out table linkage expression
+    // the table is on the list now, so the ON clause can refer to it by its alias
     if( cType == 'M' )
-      sExp = "MASTER";
-    else if( cType == 'L' ){
-      pJoinExp = new xbExp( xbase );
-
-      //  std::cout << "Parsing expression [" << sExp.Str() << "]\n";
-      if(( iRc = pJoinExp->ParseExpression( d, sExp )) != XB_NO_ERROR ){
-        iErrorStop = 130;
+      pTj->sJoinExp = "MASTER";
+    else {
+      CvtSqlExp2DbaseExp( sOn, pTj->sJoinExp );
+      if(( iRc = SplitJoinExp( pTj )) != XB_NO_ERROR ){
+        iErrorStop = 180;
         throw iRc;
       }
-   }
+    }
+  }
+  catch (xbInt16 iRc ){
+    xbString sMsg;
+    sMsg.Sprintf( "xbStmt::ProcessFromSeg() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    xbase->WriteLogMessage( sMsg.Str() );
+    xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
+  }
+  return iRc;
+}
 
+/***********************************************************************/
+void xbStmt::Reset(){
+
+  // release everything built for the previous statement
+  // the tables are left open, same as the other sql commands
+
+  if( pCursor )
+    pCursor->Close();
+  if( pPlan )
+    pPlan->Clear();
+
+  xbSqlFld *f;
+  while( fl ){
+    f = fl->Next;
+    if( fl->pExp )
+      delete fl->pExp;
+    delete fl;
+    fl = f;
+  }
+  iColCnt   = 0;
+  bDistinct = xbFalse;
+
+  #ifdef XB_SORT_SUPPORT
+  xbSqlSortCol *c;
+  while( pSortCols ){
+    c = pSortCols->Next;
+    delete pSortCols->pExp;
+    delete pSortCols;
+    pSortCols = c;
+  }
+  #endif  // XB_SORT_SUPPORT
 
-    // attach to correct location in list
+  xbTblJoin *p;
+  while( pTblList ){
+    p = pTblList->next;
+    delete pTblList;
+    pTblList = p;
+  }
 
+  sStmt        = "";
+  sFields      = "";
+  sFrom        = "";
+  sWhere       = "";
+  sOrderBy     = "";
+  sGroupBy     = "";
+  sHaving      = "";
+  ulFromPos    = 0;
+  ulWherePos   = 0;
+  ulOrderByPos = 0;
+  ulGroupByPos = 0;
+  ulHavingPos  = 0;
+}
 
-    // update the UpdateJoinList routine as appropriate
-//    if(( iRc = UpdateJoinList( cType, sTable, sAlias, NULL, NULL, NULL, NULL )) != XB_NO_ERROR ){
+/***********************************************************************/
+xbInt16 xbStmt::SplitJoinExp( xbTblJoin *pTj ){
 
-    if(( iRc = UpdateJoinList( cType, sTable, sAlias, sExp, d, pJoinExp )) != XB_NO_ERROR ){
-      iErrorStop = 110;
+  // split a join expression "parent exp = child exp" into its two sides
+  // the child side can only reference the table being joined, the parent side can only
+  // reference one table already in the list
+  // then look for a child tag whose key matches the child side
+
+  xbInt16  iRc        = 0;
+  xbInt16  iErrorStop = 0;
+  xbInt16  iParenCnt  = 0;
+  xbUInt32 ulLen      = pTj->sJoinExp.Len();
+  xbUInt32 ulEqPos    = 0;
+  xbUInt32 ul;
+  char     c;
+  char     cQuote     = 0;
+  xbString sSide[2];
+  xbDbf    *dSide[2];
+  xbBool   bChildOnly[2];
+  xbExp    *e = NULL;
+  xbExpNode *n;
+  xbTblJoin *p;
+
+  try{
+    // find the top level equal sign
+    for( ul = 1; ul <= ulLen && ulEqPos == 0; ul++ ){
+      c = pTj->sJoinExp[ul];
+      if( cQuote ){
+        if( c == cQuote )
+          cQuote = 0;
+      } else if( c == '\'' || c == '"' )
+        cQuote = c;
+      else if( c == '(' )
+        iParenCnt++;
+      else if( c == ')' )
+        iParenCnt--;
+      else if( c == '=' && iParenCnt == 0 && ul > 1 && ul < ulLen &&
+               pTj->sJoinExp[ul-1] != '<' && pTj->sJoinExp[ul-1] != '>' &&
+               pTj->sJoinExp[ul-1] != '!' && pTj->sJoinExp[ul-1] != '=' && pTj->sJoinExp[ul+1] != '=' )
+        ulEqPos = ul;
+    }
+    if( ulEqPos == 0 ){
+      iErrorStop = 100;
+      iRc = XB_INVALID_EXPRESSION;
       throw iRc;
     }
+    sSide[0].Assign( pTj->sJoinExp, 1, ulEqPos - 1 );
+    sSide[1].Assign( pTj->sJoinExp, ulEqPos + 1 );
+
+    // note which table each side refers to
+    for( xbInt16 i = 0; i < 2; i++ ){
+      sSide[i].Trim();
+      dSide[i] = NULL;
+      bChildOnly[i] = xbTrue;
+      e = new xbExp( xbase );
+      if(( iRc = e->ParseExpression( pTj->pDbf, sSide[i] )) != XB_NO_ERROR ){
+        iErrorStop = 110;
+        throw iRc;
+      }
+      if( e->GetTreeHandle())
+        n = e->GetTreeHandle()->GetFirstNode();
+      else
+        n = NULL;
+      while( n ){
+        if( n->GetNodeType() == XB_EXP_FIELD ){
+          if( n->GetDbf() != pTj->pDbf ){
+            bChildOnly[i] = xbFalse;
+            if( dSide[i] && dSide[i] != n->GetDbf()){
+              iErrorStop = 120;
+              iRc = XB_INVALID_EXPRESSION;
+              throw iRc;
+            }
+            dSide[i] = n->GetDbf();
+          }
+        }
+        n = n->GetNextNode();
+      }
+      delete e;
+      e = NULL;
+    }
 
-
+    xbInt16 iChild;
+    if( bChildOnly[1] && dSide[0] )
+      iChild = 1;
+    else if( bChildOnly[0] && dSide[1] )
+      iChild = 0;
+    else {
+      iErrorStop = 130;
+      iRc = XB_INVALID_EXPRESSION;
+      throw iRc;
+    }
+    pTj->sChildExp  = sSide[iChild];
+    pTj->sParentExp = sSide[1-iChild];
+
+    for( p = pTblList; p && p != pTj && p->pDbf != dSide[1-iChild]; p = p->next )
+      ;
+    if( !p || p == pTj ){
+      iErrorStop = 140;
+      iRc = XB_INVALID_EXPRESSION;
+      throw iRc;
+    }
+    pTj->pMaster = p;
+
+    // look for an unfiltered tag built on the child side of the join
+    xbString sKey = pTj->sChildExp;
+    xbString sTagKey;
+    xbString sChildAlias;
+    GetTblRef( pTj, sChildAlias );
+    sChildAlias += "->";
+    sKey.Replace( sChildAlias, "", 0 );
+    sKey.ToUpperCase();
+    sKey.ZapChar( ' ' );
+
+    xbLinkListNode<xbTag *> *llN = pTj->pDbf->GetTagList();
+    while( llN && !pTj->pTag ){
+      xbTag *pTag = llN->GetKey();
+      sTagKey = pTag->GetExpression();
+      sTagKey.Replace( sChildAlias, "", 0 );
+      sTagKey.ToUpperCase();
+      sTagKey.ZapChar( ' ' );
+      if( sTagKey == sKey && pTag->GetFilter().Len() == 0 )
+        pTj->pTag = pTag;
+      llN = llN->GetNextNode();
+    }
   }
   catch (xbInt16 iRc ){
+    if( e )
+      delete e;
     xbString sMsg;
-    sMsg.Sprintf( "xbStmt::ProcessFromSeg() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
+    sMsg.Sprintf( "xbStmt::SplitJoinExp() Exception Caught. Error Stop = [%d] rc = [%d]", iErrorStop, iRc );
     xbase->WriteLogMessage( sMsg.Str() );
     xbase->WriteLogMessage( xbase->GetErrorMessage( iRc ));
   }
@@ -647,32 +941,29 @@ xbInt16 xbStmt::ProcessFromSeg( const xbString &sFromSeg ){
 }
 
 /***********************************************************************/
-xbInt16  xbStmt::UpdateJoinList( char cType, const xbString &sTableName, const xbString &sAlias, const xbString &sExp, xbDbf *d, xbExp *e ){
-//  xbTag *t ){
-
+xbInt16  xbStmt::UpdateJoinList( char cType, const xbString &sTableName, const xbString &sAlias, xbDbf *d, xbTblJoin **pTjOut ){
 
-  std::cout << "Update join list for table " << sTableName.Str() << "\n";
-
-  xbTblJoin *pTj;
-  if(( pTj = (xbTblJoin *) calloc( 1, sizeof( xbTblJoin ))) == NULL )
-    return XB_NO_MEMORY;
+  // add a table to the end of the query table list
 
+  xbTblJoin *pTj = new xbTblJoin;
   pTj->cJoinType = cType;
   pTj->sTableName.Set( sTableName );
   pTj->sAlias.Set( sAlias );
-  pTj->sJoinExp.Set( sExp );
-  pTj->pDbf = d;
-  pTj->pLinkExp = e;
-
-/*
-  
-  pTj->pTag = t;
-*/
+  pTj->pDbf    = d;
+  pTj->pTag    = NULL;
+  pTj->pMaster = NULL;
+  pTj->next    = NULL;
 
-  if( cType == 'M' )
+  if( !pTblList )
     pTblList = pTj;
-
-  return 0;
+  else {
+    xbTblJoin *p = pTblList;
+    while( p->next )
+      p = p->next;
+    p->next = pTj;
+  }
+  *pTjOut = pTj;
+  return XB_NO_ERROR;
 }
 /***********************************************************************/
 }              /* namespace       */
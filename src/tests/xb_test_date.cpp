@@ -89,6 +89,11 @@ int main( int argCnt, char **av )
 
   iRc += TestMethod( iPo, "d1.CalcRollingCenturyForYear(10)", d1.CalcRollingCenturyForYear( 10 ), 20 );
   iRc += TestMethod( iPo, "d1.JulianDays()", d1.JulianDays(), 2451912 );
+  iRc += TestMethod( iPo, "d1.JulianDays( '20010102' )", d1.JulianDays( "20010102" ), 2451912 );
+  iRc += TestMethod( iPo, "d1.JulianDays( '20120709' )", d1.JulianDays( "20120709" ), d3.JulianDays() );
+  iRc += TestMethod( iPo, "d1.JulianDays( '20000229' )", d1.JulianDays( "20000229" ), 2451604 );
+  iRc += TestMethod( iPo, "d1.JulianDays( '19000229' )", d1.JulianDays( "19000229" ), 0 );
+  iRc += TestMethod( iPo, "d1.JulianDays( '2001 102' )", d1.JulianDays( "2001 102" ), 0 );
   iRc += TestMethod( iPo, "d1.Set( '20140709' )", d1.Set( "20140709" ) , 0 );
 
   d1.CharDayOf( s );
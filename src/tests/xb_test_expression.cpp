@@ -32,6 +32,7 @@ class xbExpTest : public xbExp {
    xbInt16 GetNextTokenTest( xbExpToken &t );
    xbInt16 OperatorWeightTest( const xbString &sOperator );
    xbExpNode *GetNextNodeTest( xbExpNode * );
+   xbInt16 ProcessExpressionTreeTest();
 };
 
 /**************************************************************************/
@@ -42,6 +43,10 @@ xbExpNode *xbExpTest::GetNextNodeTest( xbExpNode *n ){
   return GetNextNode( n );
 }
 /**************************************************************************/
+xbInt16 xbExpTest::ProcessExpressionTreeTest(){
+  return ProcessExpressionTree( 0 );
+}
+/**************************************************************************/
 xbInt16 xbExpTest::GetNextTokenTest( xbExpToken &t ){
   return GetNextToken( t );
 }
@@ -88,6 +93,137 @@ xbInt16 DevTester( xbXBase * xb, xbDbf * dbf, const char * sExpIn ){
   }
 }
 
+/**************************************************************************/
+// evaluate an expression with both the tree walk and the compiled program, check they agree
+// and time each of them
+xbInt16 TestCompiled( xbXBase *xb, xbDbf *d, xbInt16 iPrintOption, const char * title, const char *sExpression, xbInt32 lLoopCnt );
+xbInt16 TestCompiled( xbXBase *xb, xbDbf *d, xbInt16 iPrintOption, const char * title, const char *sExpression, xbInt32 lLoopCnt ){
+
+  xbExpTest exp( xb );
+  xbString  sTree, sVm;
+  xbDouble  dTree = 0, dVm = 0;
+  xbInt16   iRc;
+
+  if(( iRc = exp.ParseExpression( d, sExpression )) != XB_NO_ERROR ){
+    std::cout << std::endl << "[FAIL 1] " << title << " Parse Return Code = [" << iRc << "]" << std::endl;
+    return -1;
+  }
+
+  clock_t tStart = clock();
+  for( xbInt32 l = 0; l < lLoopCnt && iRc == XB_NO_ERROR; l++ )
+    iRc = exp.ProcessExpressionTreeTest();
+  double dTreeTime = (double) (clock() - tStart) / CLOCKS_PER_SEC;
+  if( exp.GetReturnType() == XB_EXP_CHAR )
+    exp.GetStringResult( sTree );
+  else
+    exp.GetNumericResult( dTree );
+
+  tStart = clock();
+  for( xbInt32 l = 0; l < lLoopCnt && iRc == XB_NO_ERROR; l++ )
+    iRc = exp.ProcessExpression();
+  double dVmTime = (double) (clock() - tStart) / CLOCKS_PER_SEC;
+  if( exp.GetReturnType() == XB_EXP_CHAR )
+    exp.GetStringResult( sVm );
+  else
+    exp.GetNumericResult( dVm );
+
+  if( iRc != XB_NO_ERROR || sTree != sVm || dTree != dVm ){
+    std::cout << std::endl << "[FAIL 2] " << title << " Expression [" << sExpression << "] iRc = [" << iRc << "]" << std::endl;
+    std::cout << "  Tree Result = [" << sTree.Str() << "][" << dTree << "] Compiled Result = [" << sVm.Str() << "][" << dVm << "]" << std::endl;
+    return -1;
+  }
+
+  if( iPrintOption == 2 )
+    std::cout << "[PASS] " << title << " [" << sExpression << "] x " << lLoopCnt << " tree = " << dTreeTime << "s compiled = " << dVmTime << "s" << std::endl;
+  else if( iPrintOption == 1 )
+    std::cout << "[PASS] " << title << std::endl;
+  return 0;
+}
+/**************************************************************************/
+xbInt16 TestFolded( xbXBase *xb, xbDbf *d, xbInt16 iPrintOption, const char * title, const char *sExpression,
+                    char cExpectedNodeType, xbUInt32 ulExpectedChildCnt );
+xbInt16 TestFolded( xbXBase *xb, xbDbf *d, xbInt16 iPrintOption, const char * title, const char *sExpression,
+                    char cExpectedNodeType, xbUInt32 ulExpectedChildCnt ){
+
+  xbExp   exp( xb );
+  xbInt16 iRc;
+
+  if(( iRc = exp.ParseExpression( d, sExpression )) != XB_NO_ERROR ){
+    std::cout << std::endl << "[FAIL 1] " << title << " Parse Return Code = [" << iRc << "]" << std::endl;
+    return -1;
+  }
+  xbExpNode *n = exp.GetTreeHandle();
+  if( n->GetNodeType() != cExpectedNodeType || n->GetChildCnt() != ulExpectedChildCnt ){
+    std::cout << std::endl << "[FAIL 2] " << title << " Expression [" << sExpression << "]" << std::endl;
+    std::cout << "  Expected root node type [" << cExpectedNodeType << "] children [" << ulExpectedChildCnt << "] Actual ["
+              << n->GetNodeType() << "] children [" << n->GetChildCnt() << "]" << std::endl;
+    return -1;
+  }
+  if( iPrintOption > 0 )
+    std::cout << "[PASS] " << title << std::endl;
+  return 0;
+}
+/**************************************************************************/
+#ifdef XB_BLOCKREAD_SUPPORT
+xbInt16 TestBatch( xbXBase *xb, xbDbf *d, xbInt16 iPrintOption, const char * title, const char *sExpression, xbBool bExpectedSupport );
+xbInt16 TestBatch( xbXBase *xb, xbDbf *d, xbInt16 iPrintOption, const char * title, const char *sExpression, xbBool bExpectedSupport ){
+
+  xbExp   exp( xb );
+  xbInt16 iRc;
+
+  if(( iRc = exp.ParseExpression( d, sExpression )) != XB_NO_ERROR ){
+    std::cout << std::endl << "[FAIL 1] " << title << " Parse Return Code = [" << iRc << "]" << std::endl;
+    return -1;
+  }
+  if( exp.GetBatchSupport() != bExpectedSupport ){
+    std::cout << std::endl << "[FAIL 2] " << title << " Expression [" << sExpression << "] batch support = [" << exp.GetBatchSupport() << "]" << std::endl;
+    return -1;
+  }
+
+  if( bExpectedSupport ){
+    // the batch results must match evaluating each record on its own
+    xbBlockRead *pRb = d->GetBlockReadPtr();
+    if( !pRb || pRb->LoadBlockForRecNo( 1 ) != XB_NO_ERROR ){
+      std::cout << std::endl << "[FAIL 3] " << title << " Block read not available" << std::endl;
+      return -1;
+    }
+    xbUInt32 ulCnt = pRb->GetBlockRecCnt();
+    xbDouble *dpResults = new xbDouble[ulCnt];
+    xbDouble dResult = 0;
+    if(( iRc = exp.ProcessExpressionBatch( pRb->GetBlockBuf(), ulCnt, dpResults )) != XB_NO_ERROR ){
+      std::cout << std::endl << "[FAIL 4] " << title << " ProcessExpressionBatch Return Code = [" << iRc << "]" << std::endl;
+      delete[] dpResults;
+      return -1;
+    }
+    for( xbUInt32 l = 0; l < ulCnt && iRc == XB_NO_ERROR; l++ ){
+      if(( iRc = d->GetRecord( l + 1 )) == XB_NO_ERROR && ( iRc = exp.ProcessExpression()) == XB_NO_ERROR )
+        iRc = exp.GetNumericResult( dResult );
+      if( iRc != XB_NO_ERROR || dResult != dpResults[l] ){
+        std::cout << std::endl << "[FAIL 5] " << title << " Expression [" << sExpression << "] Record [" << l + 1 << "]" << std::endl;
+        std::cout << "  Record Result = [" << dResult << "] Batch Result = [" << dpResults[l] << "]" << std::endl;
+        delete[] dpResults;
+        return -1;
+      }
+    }
+    delete[] dpResults;
+  }
+  if( iPrintOption > 0 )
+    std::cout << "[PASS] " << title << std::endl;
+  return 0;
+}
+#endif  // XB_BLOCKREAD_SUPPORT
+/**************************************************************************/
+// application registered functions, used to test xbXBase::RegisterFunction()
+xbInt16 DoubleIt( xbXBase *, xbDbf *, xbExpNode *n, xbInt16 ){
+  n->SetResult( n->GetChild( 0 )->GetNumericResult() * 2 );
+  return XB_NO_ERROR;
+}
+xbInt16 Initial( xbXBase *, xbDbf *, xbExpNode *n, xbInt16 ){
+  xbString s( n->GetChild( 0 )->GetStringResult());
+  s.Left( 1 );
+  n->SetResult( s );
+  return XB_NO_ERROR;
+}
 /**************************************************************************/
 xbInt16 TestWeight( xbXBase * xb, xbInt16 iPrintOption, const char * title, const char *sOperator, xbInt16 iExpectedWeight );
 xbInt16 TestWeight( xbXBase * xb, xbInt16 iPrintOption, const char * title, const char *sOperator, xbInt16 iExpectedWeight ){
@@ -798,6 +934,159 @@ int main( int argCnt, char **av )
   iRc += TestMethod( &x, MyFile, iPo, "FuncTest65", "DELETED()", (xbBool) xbTrue );
   iRc += TestMethod( iPo, "UndeleteRecord()", MyFile->UndeleteRecord(),       XB_NO_ERROR );
 
+  // compiled program against the tree walk, timings printed in verbose mode
+  xbInt32 lLoopCnt = ( iPo == 2 ) ? 100000 : 1000;
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest1", "CHAR1 + CHAR2", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest2", "CHAR1 - \"ABC\" - CHAR2", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest3", "(NUM1 + 3) * 2 - NUM1 / 4", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest4", "DATE2 - DATE1", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest5", "NUM1 > 3 .AND. CHAR1 = \"TEST\" .OR. DATE1 < DATE2", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest6", "\"ES\" $ CHAR1 .AND. NUM1 # 4", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest7", "UPPER( CHAR1 ) + STR( NUM1, 5, 1 )", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest8", "DTOS( DATE1 ) + LEFT( CHAR2, 3 )", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest9", "IIF( NUM1 > 4, \"BIG  \", \"SMALL\" )", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest10", "ExpTest->NULLDATE1 < {07/06/2012}", lLoopCnt );
+  // character functions processed in the register buffers
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest11", "LOWER( CHAR1 ) + RIGHT( CHAR2, 4 ) + RIGHT( CHAR1, 9 )", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest12", "SUBSTR( CHAR2, 2, 3 ) + SUBSTR( CHAR2, 5, 6 ) + SUBSTR( CHAR1, 4, 9 )", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest13", "TRIM( CHAR1 ) + LTRIM( \"  A \" ) + ALLTRIM( \"  B  \" ) + RTRIM( CHAR2 )", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest14", "LEN( TRIM( CHAR1 )) + LEN( CHAR2 )", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest15", "IIF( CHAR1 = \"TEST\", CHAR1, UPPER( \"abcde\" ))", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest16", "CHAR1 < CHAR2 .AND. CHAR2 >= \"TEST\" .AND. CHAR1 <> \"TEST \"", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "CompiledTest17", "LEFT( CHAR1, 1 ) + LEFT( CHAR2, 20 ) - \"X\"", lLoopCnt );
+  xbExp expIif( &x );
+  iRc += TestMethod( iPo, "CompiledTest18", expIif.ParseExpression( MyFile, "IIF( NUM1 > 4, CHAR1, CHAR2 )" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CompiledTest19", expIif.ProcessExpression(), XB_INCONSISTENT_PARM_LENS );
+
+  // constant folding and short circuit
+  xbDate dtTest3( "20200131" );
+  iRc += TestMethod( &x, MyFile, iPo, "FoldTest1", "CTOD( \"01/01/20\" ) + 30", dtTest3 );
+  iRc += TestFolded( &x, MyFile, iPo, "FoldTest2", "CTOD( \"01/01/20\" ) + 30", XB_EXP_CONSTANT, 0 );
+  iRc += TestFolded( &x, MyFile, iPo, "FoldTest3", "UPPER( \"abc\" ) + CHAR1", XB_EXP_OPERATOR, 2 );
+  iRc += TestFolded( &x, MyFile, iPo, "FoldTest4", "IIF( 1 > 2, \"YES\", \"NO \" )", XB_EXP_CONSTANT, 0 );
+  iRc += TestMethod( &x, MyFile, iPo, "FoldTest5", "IIF( 1 > 2, \"YES\", \"NO \" )", "NO ", 3 );
+  iRc += TestFolded( &x, MyFile, iPo, "FoldTest6", "IIF( .T., UPPER( CHAR1 ), LOWER( CHAR1 ))", XB_EXP_FUNCTION, 1 );
+  iRc += TestFolded( &x, MyFile, iPo, "FoldTest7", ".T. .AND. NUM1 > 3", XB_EXP_OPERATOR, 2 );
+  iRc += TestFolded( &x, MyFile, iPo, "FoldTest8", ".F. .AND. NUM1 > 3", XB_EXP_CONSTANT, 0 );
+  iRc += TestFolded( &x, MyFile, iPo, "FoldTest9", "NUM1 > 3 .OR. .T.", XB_EXP_CONSTANT, 0 );
+  iRc += TestMethod( &x, MyFile, iPo, "FoldTest10", "NUM1 > 3 .OR. .T.", (xbBool) xbTrue );
+  iRc += TestFolded( &x, MyFile, iPo, "FoldTest11", "DATE() + 1", XB_EXP_OPERATOR, 2 );
+  iRc += TestFolded( &x, MyFile, iPo, "FoldTest12", "DELETED() .OR. .F.", XB_EXP_FUNCTION, 0 );
+  iRc += TestCompiled( &x, MyFile, iPo, "ShortCircuitTest1", "NUM1 > 100 .AND. CHAR1 = \"X\"", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "ShortCircuitTest2", "NUM1 < 100 .OR. UPPER( CHAR1 ) = \"X\"", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "ShortCircuitTest3", "( NUM1 > 100 .OR. DATE1 < DATE2 ) .AND. ( CHAR1 = \"X\" .OR. NUM1 > 0 )", lLoopCnt );
+  iRc += TestCompiled( &x, MyFile, iPo, "ShortCircuitTest4", "CTOD( \"01/01/20\" ) + 30 > DATE1 .AND. UPPER( \"abc\" ) $ UPPER( CHAR1 )", lLoopCnt );
+
+  iRc += TestMethod( iPo, "RegisterFunction()", x.RegisterFunction( "DOUBLEIT", 'N', 1, 10, DoubleIt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "RegisterFunction()", x.RegisterFunction( "Initial", 'C', 1, 1, Initial ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "RegisterFunction()", x.RegisterFunction( "UPPER", 'C', 2, 1, Initial ), XB_ALREADY_DEFINED );
+  iRc += TestMethod( iPo, "RegisterFunction()", x.RegisterFunction( "BADTYPE", 'X', 1, 1, Initial ), XB_INVALID_PARAMETER );
+  iRc += TestMethod( &x, MyFile, iPo, "UserFuncTest1", "DOUBLEIT( 21 )", (xbDouble) 42 );
+  iRc += TestMethod( &x, MyFile, iPo, "UserFuncTest2", "DOUBLEIT( 3 ) * 2 + 1", (xbDouble) 13 );
+  iRc += TestMethod( &x, MyFile, iPo, "UserFuncTest3", "INITIAL( \"XBASE\" ) + \"Y\"", "XY", 2 );
+  iRc += TestCompiled( &x, MyFile, iPo, "UserFuncTest4", "DOUBLEIT( NUM1 ) > NUM1 + 1", lLoopCnt );
+  iRc += TestMethod( iPo, "RegisterFunction()", x.RegisterFunction( "DOUBLEIT", 'N', 1, 10, DoubleIt ), XB_NO_ERROR );
+
+  // parsed expression cache
+  xbUInt32 ulHits = x.GetExpressionCacheHits();
+  iRc += TestMethod( &x, MyFile, iPo, "CacheTest1", "NUM1 * 3 + 1", (xbDouble) 16 );
+  iRc += TestMethod( &x, MyFile, iPo, "CacheTest2", "NUM1 * 3 + 1", (xbDouble) 16 );
+  iRc += TestMethod( &x, MyFile, iPo, "CacheTest3", "ExpTest->NUM1 * 3 + 1", (xbDouble) 16 );
+  iRc += TestMethod( iPo, "GetExpressionCacheHits()", (xbInt32) ( x.GetExpressionCacheHits() - ulHits ), 1 );
+  iRc += TestMethod( &x, MyFile, iPo, "CacheTest4", "DOUBLEIT( NUM1 ) + 1", (xbDouble) 11 );
+  iRc += TestMethod( iPo, "RegisterFunction()", x.RegisterFunction( "DOUBLEIT", 'N', 1, 10, Initial ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "RegisterFunction()", x.RegisterFunction( "DOUBLEIT", 'N', 1, 10, DoubleIt ), XB_NO_ERROR );
+  iRc += TestMethod( &x, MyFile, iPo, "CacheTest5", "DOUBLEIT( NUM1 ) + 1", (xbDouble) 11 );
+  iRc += TestMethod( iPo, "GetExpressionCacheHits()", (xbInt32) ( x.GetExpressionCacheHits() - ulHits ), 1 );
+  x.SetExpressionCacheSize( 0 );
+  iRc += TestMethod( &x, MyFile, iPo, "CacheTest6", "NUM1 * 3 + 1", (xbDouble) 16 );
+  iRc += TestMethod( &x, MyFile, iPo, "CacheTest7", "NUM1 * 3 + 1", (xbDouble) 16 );
+  iRc += TestMethod( iPo, "GetExpressionCacheHits()", (xbInt32) ( x.GetExpressionCacheHits() - ulHits ), 1 );
+  x.SetExpressionCacheSize( XB_EXP_CACHE_SIZE );
+  iRc += TestMethod( iPo, "GetExpressionCacheSize()", x.GetExpressionCacheSize(), XB_EXP_CACHE_SIZE );
+
+  // field dependency metadata
+  xbExp expDep( &x );
+  iRc += TestMethod( iPo, "DepTest1", expDep.ParseExpression( MyFile, "NUM1 + 1 > 3 .AND. CHAR2 = CHAR1 .AND. DATE2 > DATE1" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFieldDepCnt(1)", expDep.GetFieldDepCnt(), 5 );
+  iRc += TestMethod( iPo, "GetFieldDep(1)", expDep.GetFieldDep( 0 ), 0 );
+  iRc += TestMethod( iPo, "GetFieldDep(2)", expDep.GetFieldDep( 4 ), 6 );
+  iRc += TestMethod( iPo, "IsFieldDep(1)", expDep.IsFieldDep( 3 ), xbTrue );
+  iRc += TestMethod( iPo, "IsFieldDep(2)", expDep.IsFieldDep( 4 ), xbFalse );
+  iRc += TestMethod( iPo, "GetDepFlags(1)", expDep.GetDepFlags(), 0 );
+  iRc += TestMethod( iPo, "DepTest2", expDep.ParseExpression( MyFile, "RECNO() > 1 .AND. .NOT. DELETED() .AND. DATE1 < DATE()" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFieldDepCnt(2)", expDep.GetFieldDepCnt(), 1 );
+  iRc += TestMethod( iPo, "GetDepFlags(2)", expDep.GetDepFlags(), XB_EXP_DEP_RECNO | XB_EXP_DEP_DELETED | XB_EXP_DEP_DATE );
+  iRc += TestMethod( iPo, "DepTest3", expDep.ParseExpression( MyFile, "DOUBLEIT( NUM1 ) + NUM1" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFieldDepCnt(3)", expDep.GetFieldDepCnt(), 1 );
+  iRc += TestMethod( iPo, "GetDepFlags(3)", expDep.GetDepFlags(), XB_EXP_DEP_EXTERNAL );
+  iRc += TestMethod( iPo, "DepTest4", expDep.ParseExpression( MyFile, "RECCOUNT() > NUM1" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetDepFlags(4)", expDep.GetDepFlags(), XB_EXP_DEP_EXTERNAL );
+
+  // repeated subtrees are evaluated once per record
+  iRc += TestMethod( &x, MyFile, iPo, "CseTest1", "UPPER( CHAR1 ) = \"TEST\" .OR. UPPER( CHAR1 ) = \"ABC\"", (xbBool) xbTrue );
+  iRc += TestMethod( &x, MyFile, iPo, "CseTest2", "NUM1 > 10 .AND. UPPER( CHAR1 ) = \"X\" .OR. UPPER( CHAR1 ) = \"TEST\"", (xbBool) xbTrue );
+  iRc += TestMethod( &x, MyFile, iPo, "CseTest3", "UPPER( CHAR1 ) + UPPER( CHAR1 ) + DTOS( DATE1 )", "TEST TEST 19890303", 18 );
+  iRc += TestMethod( &x, MyFile, iPo, "CseTest4", "( NUM1 * 2 + 1 ) * ( NUM1 * 2 + 1 )", (xbDouble) 121 );
+  iRc += TestMethod( &x, MyFile, iPo, "CseTest5", "DOUBLEIT( NUM1 ) + DOUBLEIT( NUM1 )", (xbDouble) 20 );
+  xbExp expCse( &x );
+  iRc += TestMethod( iPo, "CseTest6", expCse.ParseExpression( MyFile, "UPPER( CHAR1 ) = \"TEST\" .OR. UPPER( CHAR1 ) = \"ABC\"" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetSharedNodeCnt(1)", expCse.GetSharedNodeCnt(), 1 );
+  iRc += TestMethod( iPo, "CseTest7", expCse.ParseExpression( MyFile, "NUM1 > 10 .AND. UPPER( CHAR1 ) = \"X\" .OR. UPPER( CHAR1 ) = \"TEST\"" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetSharedNodeCnt(2)", expCse.GetSharedNodeCnt(), 0 );
+  iRc += TestMethod( iPo, "CseTest8", expCse.ParseExpression( MyFile, "( NUM1 * 2 + 1 ) * ( NUM1 * 2 + 1 ) + NUM1" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetSharedNodeCnt(3)", expCse.GetSharedNodeCnt(), 2 );
+  iRc += TestMethod( iPo, "CseTest9", expCse.ParseExpression( MyFile, "DOUBLEIT( NUM1 ) + DOUBLEIT( NUM1 )" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetSharedNodeCnt(4)", expCse.GetSharedNodeCnt(), 1 );
+
+  #ifdef XB_DEBUG_SUPPORT
+  // the right operand of the inner .AND. starts with a repeated subtree, it is still skipped when NUM1 > 100 is false
+  // CHAR1, UPPER, LEN, >, jump, NUM1, >, jump, .AND.
+  xbBool bCseResult;
+  iRc += TestMethod( iPo, "CseTest10", expCse.ParseExpression( MyFile, "LEN( UPPER( CHAR1 )) > 0 .AND. ( NUM1 > 100 .AND. UPPER( CHAR1 ) = \"TEST\" )" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetSharedNodeCnt(5)", expCse.GetSharedNodeCnt(), 1 );
+  iRc += TestMethod( iPo, "CseTest11", expCse.ProcessExpression(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetInstrExecCnt(1)", (xbInt32) expCse.GetInstrExecCnt(), 9 );
+  iRc += TestMethod( iPo, "CseTest12", expCse.GetBoolResult( bCseResult ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CseTest13", (xbInt32) bCseResult, (xbInt32) xbFalse );
+  // one jump for the right operand, NUM1, >, jump
+  iRc += TestMethod( iPo, "CseTest14", expCse.ParseExpression( MyFile, "NUM1 > 100 .AND. UPPER( CHAR1 ) = \"TEST\"" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CseTest15", expCse.ProcessExpression(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetInstrExecCnt(2)", (xbInt32) expCse.GetInstrExecCnt(), 3 );
+  #endif  // XB_DEBUG_SUPPORT
+
+  #ifdef XB_BLOCKREAD_SUPPORT
+  // batch evaluation over a block of records
+  iRc += TestMethod( iPo, "BlankRecord(120)",  MyFile->BlankRecord(),                     XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutField(121)",     MyFile->PutField( "CHAR1", "ABC" ),      XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutField(122)",     MyFile->PutField( "CHAR2", "TESTING" ),  XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutField(123)",     MyFile->PutFloatField( "NUM1", 7 ),      XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutField(124)",     MyFile->PutField( "DATE1", "20120708" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "AppendRecord(125)", MyFile->AppendRecord(),                  XB_NO_ERROR );
+  iRc += TestMethod( iPo, "BlankRecord(126)",  MyFile->BlankRecord(),                     XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutField(127)",     MyFile->PutFloatField( "NUM1", -1.5 ),   XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutField(128)",     MyFile->PutField( "DATE2", "19991231" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutField(129)",     MyFile->PutField( "NULLDATE1", "20200101" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "AppendRecord(130)", MyFile->AppendRecord(),                  XB_NO_ERROR );
+  iRc += TestMethod( &x, MyFile, iPo, "FieldTest1", "NUM1 * 4", (xbDouble) -6 );
+  iRc += TestMethod( &x, MyFile, iPo, "FieldTest2", "DATE2 - {12/01/1999}", (xbDouble) 30 );
+  iRc += TestMethod( &x, MyFile, iPo, "FieldTest3", "NUM1 + 1.25", (xbDouble) -0.25 );
+  iRc += TestMethod( iPo, "PutField(131)",     MyFile->PutField( "NUM1", "1234.56" ),   XB_NO_ERROR );
+  iRc += TestMethod( &x, MyFile, iPo, "FieldTest4", "NUM1", (xbDouble) 1234.56 );
+  iRc += TestMethod( &x, MyFile, iPo, "FieldTest5", "NUM1 = 1234.56", (xbBool) xbTrue );
+  iRc += TestMethod( iPo, "EnableBlockReadProcessing()", MyFile->EnableBlockReadProcessing(), XB_NO_ERROR );
+  iRc += TestBatch( &x, MyFile, iPo, "BatchTest1", "NUM1 * 2 + 1 > 10 .AND. DATE1 < DATE2", xbTrue );
+  iRc += TestBatch( &x, MyFile, iPo, "BatchTest2", "CHAR1 = \"TEST\" .OR. NULLDATE1 < {07/06/2012}", xbTrue );
+  iRc += TestBatch( &x, MyFile, iPo, "BatchTest3", "LEFT( CHAR2, 4 ) = \"TEST\" .AND. NUM1 <> 7", xbTrue );
+  iRc += TestBatch( &x, MyFile, iPo, "BatchTest4", "DATE2 - DATE1 + ABS( NUM1 ) ^ 2", xbTrue );
+  iRc += TestBatch( &x, MyFile, iPo, "BatchTest5", "DATE1 + 30", xbTrue );
+  iRc += TestBatch( &x, MyFile, iPo, "BatchTest6", "\"ES\" $ CHAR2 .OR. CHAR1 - CHAR2 > \"ABC\"", (xbBool) xbTrue );
+  iRc += TestBatch( &x, MyFile, iPo, "BatchTest7", "DOUBLEIT( NUM1 ) > 3", xbFalse );
+  iRc += TestBatch( &x, MyFile, iPo, "BatchTest8", "RECNO() > 1", xbFalse );
+  iRc += TestBatch( &x, MyFile, iPo, "BatchTest9", "UPPER( CHAR1 )", xbFalse );
+  iRc += TestBatch( &x, MyFile, iPo, "BatchTest10", "NUM1 * 2 > 3 .OR. NUM1 * 2 < -1 .OR. ABS( NUM1 * 2 ) = 3", xbTrue );
+  iRc += TestMethod( iPo, "DisableBlockReadProcessing()", MyFile->DisableBlockReadProcessing(), XB_NO_ERROR );
+  #endif  // XB_BLOCKREAD_SUPPORT
 
   iRc += TestMethod( iPo, "Close()", MyFile->Close(), XB_NO_ERROR );
   delete MyFile;
@@ -67,6 +67,7 @@ int main( int argCnt, char **av )
   char c;
   xbString s;
   xbInt32 lRecCnt = 0;
+  xbUInt32 ulEstCnt = 0;
   iRc = 0;
 
   if( iPo > 0 )
@@ -144,6 +145,44 @@ int main( int argCnt, char **av )
   iRc += TestMethod( iPo, "GetPrev(29)", f1.GetPrevRecord(), XB_NO_ERROR );
   iRc += TestMethod( iPo, "GetCurRecNo(30)", (xbInt32) MyFile->GetCurRecNo(), 102 );
 
+  #ifdef XB_BLOCKREAD_SUPPORT
+  // with block reads on, the filter is evaluated a block at a time
+  xbInt32 lCnt = 0;
+  iRc += TestMethod( iPo, "GetRecord(131)", MyFile->GetRecord( 125 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "DeleteRecord(132)", MyFile->DeleteRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(133)", MyFile->Commit(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "EnableBlockReadProcessing(134)", MyFile->EnableBlockReadProcessing(), XB_NO_ERROR );
+
+  sMyFilterExpression = "LEFT( CFLD, 2 ) = 'YY'";
+  iRc += TestMethod( iPo, "Set(135)", f1.Set( sMyFilterExpression ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFirstRecord(136)", f1.GetFirstRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(137)", (xbInt32) MyFile->GetCurRecNo(), 28 );
+  iRc += TestMethod( iPo, "GetNextRecord(138)", f1.GetNextRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(139)", (xbInt32) MyFile->GetCurRecNo(), 54 );
+  iRc += TestMethod( iPo, "GetNextRecord(140)", f1.GetNextRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetNextRecord(141)", f1.GetNextRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(142)", (xbInt32) MyFile->GetCurRecNo(), 106 );
+  iRc += TestMethod( iPo, "GetNextRecord(143)", f1.GetNextRecord(), XB_EOF );
+
+  sMyFilterExpression = "NFLD > 120";
+  iRc += TestMethod( iPo, "Set(144)", f1.Set( sMyFilterExpression ), XB_NO_ERROR );
+  iRc2 = f1.GetFirstRecord();
+  while( iRc2 == XB_NO_ERROR ){
+    lCnt++;
+    iRc2 = f1.GetNextRecord();
+  }
+  iRc += TestMethod( iPo, "GetNextRecord(145)", (xbInt32) iRc2, XB_EOF );
+  iRc += TestMethod( iPo, "Count(146)", lCnt, 9 );
+  iRc += TestMethod( iPo, "GetFirstRecord(147)", f1.GetFirstRecord( XB_DELETED_RECS ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(148)", (xbInt32) MyFile->GetCurRecNo(), 125 );
+  iRc += TestMethod( iPo, "GetNextRecord(149)", f1.GetNextRecord( XB_DELETED_RECS ), XB_EOF );
+
+  iRc += TestMethod( iPo, "DisableBlockReadProcessing(150)", MyFile->DisableBlockReadProcessing(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetRecord(151)", MyFile->GetRecord( 125 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "UndeleteRecord(152)", MyFile->UndeleteRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(153)", MyFile->Commit(), XB_NO_ERROR );
+  #endif  // XB_BLOCKREAD_SUPPORT
+
 
   #ifdef XB_NDX_SUPPORT
   f1.SetLimit( 0 );
@@ -178,14 +217,415 @@ int main( int argCnt, char **av )
 
   iRc += TestMethod( iPo, "Set(70)", f1.Set( "ZFLD = 'A'", "TestFilt" ), XB_NO_ERROR );
 
+  // conditions on the CFLD key are resolved from an index key range, results stay in record order
+  iRc += TestMethod( iPo, "Set(160)", f1.Set( "LEFT( CFLD, 2 ) = 'YY'" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFirstRecord(161)", f1.GetFirstRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetIxRangeStatus(162)", (xbInt32) f1.GetIxRangeStatus(), (xbInt32) xbTrue );
+  iRc += TestMethod( iPo, "GetEstimatedRecCnt(364)", f1.GetEstimatedRecCnt( ulEstCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetEstimatedRecCnt(365)", (xbInt32) ulEstCnt, 4 );
+  iRc += TestMethod( iPo, "GetCurRecNo(163)", (xbInt32) MyFile->GetCurRecNo(), 28 );
+  iRc += TestMethod( iPo, "GetNextRecord(164)", f1.GetNextRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(165)", (xbInt32) MyFile->GetCurRecNo(), 54 );
+  iRc += TestMethod( iPo, "GetLastRecord(166)", f1.GetLastRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(167)", (xbInt32) MyFile->GetCurRecNo(), 106 );
+  iRc += TestMethod( iPo, "GetPrevRecord(168)", f1.GetPrevRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(169)", (xbInt32) MyFile->GetCurRecNo(), 80 );
+  iRc += TestMethod( iPo, "GetNextRecord(170)", f1.GetNextRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetNextRecord(171)", f1.GetNextRecord(), XB_EOF );
+
+  iRc += TestMethod( iPo, "Set(172)", f1.Set( "'W' < CFLD .AND. CFLD <= 'Y' .AND. NFLD < 60" ), XB_NO_ERROR );
+  lRecCnt = 0;
+  iRc2 = f1.GetFirstRecord();
+  iRc += TestMethod( iPo, "GetIxRangeStatus(173)", (xbInt32) f1.GetIxRangeStatus(), (xbInt32) xbTrue );
+  while( iRc2 == XB_NO_ERROR ){
+    lRecCnt++;
+    iRc2 = f1.GetNextRecord();
+  }
+  iRc += TestMethod( iPo, "GetNextRecord(174)", (xbInt32) iRc2, XB_EOF );
+  iRc += TestMethod( iPo, "Count(175)", lRecCnt, 6 );
+
+  iRc += TestMethod( iPo, "Set(176)", f1.Set( "CFLD = 'ZZZZZZ'" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFirstRecord(177)", f1.GetFirstRecord(), XB_EOF );
+  iRc += TestMethod( iPo, "GetIxRangeStatus(178)", (xbInt32) f1.GetIxRangeStatus(), (xbInt32) xbTrue );
+
+  iRc += TestMethod( iPo, "GetRecord(179)", MyFile->GetRecord( 54 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "DeleteRecord(180)", MyFile->DeleteRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(181)", MyFile->Commit(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Set(182)", f1.Set( "LEFT( CFLD, 2 ) = 'YY'" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFirstRecord(183)", f1.GetFirstRecord( XB_DELETED_RECS ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(184)", (xbInt32) MyFile->GetCurRecNo(), 54 );
+  iRc += TestMethod( iPo, "GetNextRecord(185)", f1.GetNextRecord( XB_DELETED_RECS ), XB_EOF );
+  iRc += TestMethod( iPo, "GetFirstRecord(186)", f1.GetFirstRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetNextRecord(187)", f1.GetNextRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(188)", (xbInt32) MyFile->GetCurRecNo(), 80 );
+  iRc += TestMethod( iPo, "GetRecord(189)", MyFile->GetRecord( 54 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "UndeleteRecord(190)", MyFile->UndeleteRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(191)", MyFile->Commit(), XB_NO_ERROR );
+
+  // no usable tag
+  iRc += TestMethod( iPo, "Set(192)", f1.Set( "NFLD > 120 .OR. CFLD = 'A'" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFirstRecord(193)", f1.GetFirstRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetIxRangeStatus(194)", (xbInt32) f1.GetIxRangeStatus(), (xbInt32) xbFalse );
+  iRc += TestMethod( iPo, "GetCurRecNo(195)", (xbInt32) MyFile->GetCurRecNo(), 26 );
+  xbUInt32 ulTblCnt = 0;
+  iRc += TestMethod( iPo, "GetEstimatedRecCnt(366)", f1.GetEstimatedRecCnt( ulEstCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetRecordCnt(367)", MyFile->GetRecordCnt( ulTblCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetEstimatedRecCnt(368)", (xbInt32) ulEstCnt, (xbInt32) ulTblCnt );
+
 
 
   #endif  // XB_NDX_SUPPORT
 
+  // compressed bitmap, one sparse chunk, one dense chunk and one chunk past 16 bits
+  xbBitmap bm;
+  xbUInt32 ulVal = 0;
+  for( xbUInt32 ul = 1; ul <= 10000; ul++ )
+    bm.Set( ul * 2 );
+  bm.Set( 3 );
+  bm.Set( 3 );
+  bm.Set( 100000 );
+  iRc += TestMethod( iPo, "xbBitmap::GetCount(196)", (xbInt32) bm.GetCount(), 10002 );
+  iRc += TestMethod( iPo, "xbBitmap::Contains(197)", (xbInt32) bm.Contains( 3 ), (xbInt32) xbTrue );
+  iRc += TestMethod( iPo, "xbBitmap::Contains(198)", (xbInt32) bm.Contains( 5 ), (xbInt32) xbFalse );
+  iRc += TestMethod( iPo, "xbBitmap::GetMemSize(199)", (xbInt32) ( bm.GetMemSize() < 20000 ), (xbInt32) xbTrue );
+  bm.GetNext( 19999, ulVal );
+  iRc += TestMethod( iPo, "xbBitmap::GetNext(200)", (xbInt32) ulVal, 20000 );
+  bm.GetNext( 20001, ulVal );
+  iRc += TestMethod( iPo, "xbBitmap::GetNext(201)", (xbInt32) ulVal, 100000 );
+  iRc += TestMethod( iPo, "xbBitmap::GetNext(202)", bm.GetNext( 100001, ulVal ), XB_NOT_FOUND );
+  bm.GetPrev( 99999, ulVal );
+  iRc += TestMethod( iPo, "xbBitmap::GetPrev(203)", (xbInt32) ulVal, 20000 );
+  bm.GetPrev( 3, ulVal );
+  iRc += TestMethod( iPo, "xbBitmap::GetPrev(204)", (xbInt32) ulVal, 3 );
+  iRc += TestMethod( iPo, "xbBitmap::GetPrev(205)", bm.GetPrev( 1, ulVal ), XB_NOT_FOUND );
+  for( xbUInt32 ul = 100; ul <= 10000; ul++ )
+    bm.Remove( ul * 2 );
+  bm.Remove( 3 );
+  iRc += TestMethod( iPo, "xbBitmap::GetCount(206)", (xbInt32) bm.GetCount(), 100 );
+  bm.GetNext( 197, ulVal );
+  iRc += TestMethod( iPo, "xbBitmap::GetNext(207)", (xbInt32) ulVal, 198 );
+  bm.GetNext( 199, ulVal );
+  iRc += TestMethod( iPo, "xbBitmap::GetNext(208)", (xbInt32) ulVal, 100000 );
+  bm.Clear();
+  iRc += TestMethod( iPo, "xbBitmap::GetNext(209)", bm.GetNext( 0, ulVal ), XB_NOT_FOUND );
+
+  // materialized filter, matches records 26 and 121 - 130
+  iRc += TestMethod( iPo, "Set(210)", f1.Set( "NFLD > 120 .OR. CFLD = 'A'" ), XB_NO_ERROR );
+  f1.SetMaterialize( xbTrue );
+  iRc += TestMethod( iPo, "GetFirstRecord(211)", f1.GetFirstRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetBitmapStatus(212)", (xbInt32) f1.GetBitmapStatus(), (xbInt32) xbTrue );
+  iRc += TestMethod( iPo, "GetEstimatedRecCnt(369)", f1.GetEstimatedRecCnt( ulEstCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetEstimatedRecCnt(370)", (xbInt32) ulEstCnt, 11 );
+  f1.SetLimit( 5 );
+  iRc += TestMethod( iPo, "GetEstimatedRecCnt(371)", f1.GetEstimatedRecCnt( ulEstCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetEstimatedRecCnt(372)", (xbInt32) ulEstCnt, 5 );
+  f1.SetLimit( 0 );
+  iRc += TestMethod( iPo, "GetCurRecNo(213)", (xbInt32) MyFile->GetCurRecNo(), 26 );
+  lRecCnt = 0;
+  iRc2 = f1.GetFirstRecord();
+  while( iRc2 == XB_NO_ERROR ){
+    lRecCnt++;
+    iRc2 = f1.GetNextRecord();
+  }
+  iRc += TestMethod( iPo, "GetNextRecord(214)", (xbInt32) iRc2, XB_EOF );
+  iRc += TestMethod( iPo, "Count(215)", lRecCnt, 11 );
+  iRc += TestMethod( iPo, "GetLastRecord(216)", f1.GetLastRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(217)", (xbInt32) MyFile->GetCurRecNo(), 130 );
+  iRc += TestMethod( iPo, "GetPrevRecord(218)", f1.GetPrevRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(219)", (xbInt32) MyFile->GetCurRecNo(), 129 );
+
+  // updates made through the table are picked up from the change log
+  iRc += TestMethod( iPo, "GetRecord(220)", MyFile->GetRecord( 5 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutLongField(221)", MyFile->PutLongField( "NFLD", 125 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(222)", MyFile->Commit(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetRecord(223)", MyFile->GetRecord( 26 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutField(224)", MyFile->PutField( "CFLD", "B" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(225)", MyFile->Commit(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFirstRecord(226)", f1.GetFirstRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(227)", (xbInt32) MyFile->GetCurRecNo(), 5 );
+  iRc += TestMethod( iPo, "GetNextRecord(228)", f1.GetNextRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(229)", (xbInt32) MyFile->GetCurRecNo(), 121 );
+
+  iRc += TestMethod( iPo, "DeleteRecord(230)", MyFile->DeleteRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(231)", MyFile->Commit(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFirstRecord(232)", f1.GetFirstRecord( XB_DELETED_RECS ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(233)", (xbInt32) MyFile->GetCurRecNo(), 121 );
+  iRc += TestMethod( iPo, "GetRecord(234)", MyFile->GetRecord( 5 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetNextRecord(235)", f1.GetNextRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(236)", (xbInt32) MyFile->GetCurRecNo(), 122 );
+
+  MyFile->BlankRecord();
+  MyFile->PutField( "CFLD", "A" );
+  MyFile->PutLongField( "NFLD", 131 );
+  iRc += TestMethod( iPo, "AppendRecord(237)", MyFile->AppendRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetLastRecord(238)", f1.GetLastRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(239)", (xbInt32) MyFile->GetCurRecNo(), 131 );
+  iRc += TestMethod( iPo, "GetBitmapStatus(240)", (xbInt32) f1.GetBitmapStatus(), (xbInt32) xbTrue );
+
+  // more changes than the change log holds, the bitmap is rebuilt
+  iRc2 = XB_NO_ERROR;
+  for( xbUInt32 ul = 1; ul <= XB_DBF_CHANGE_LOG_SIZE + 1 && iRc2 == XB_NO_ERROR; ul++ ){
+    MyFile->GetRecord( 1 );
+    iRc2 = MyFile->PutLongField( "NFLD", 1 );
+    if( iRc2 == XB_NO_ERROR )
+      iRc2 = MyFile->Commit();
+  }
+  iRc += TestMethod( iPo, "GetRecord(241)", MyFile->GetRecord( 2 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutLongField(242)", MyFile->PutLongField( "NFLD", 500 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(243)", MyFile->Commit(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFirstRecord(244)", f1.GetFirstRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(245)", (xbInt32) MyFile->GetCurRecNo(), 2 );
+  lRecCnt = 1;
+  while( f1.GetNextRecord() == XB_NO_ERROR )
+    lRecCnt++;
+  iRc += TestMethod( iPo, "Count(246)", lRecCnt, 12 );
+
+  // counts, served from the bitmap
+  xbUInt32 ulCnt = 0;
+  xbBool   bExists = xbFalse;
+  iRc += TestMethod( iPo, "GetRecord(247)", MyFile->GetRecord( 7 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(248)", f1.Count( ulCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(249)", (xbInt32) ulCnt, 12 );
+  iRc += TestMethod( iPo, "Count(250)", f1.Count( ulCnt, XB_ALL_RECS ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(251)", (xbInt32) ulCnt, 13 );
+  iRc += TestMethod( iPo, "Count(252)", f1.Count( ulCnt, XB_DELETED_RECS ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(253)", (xbInt32) ulCnt, 1 );
+  iRc += TestMethod( iPo, "GetCurRecNo(254)", (xbInt32) MyFile->GetCurRecNo(), 7 );
+
+  // index range, or the whole table if there is no usable tag
+  xbFilter f2( MyFile );
+  iRc += TestMethod( iPo, "Set(255)", f2.Set( "'W' < CFLD .AND. CFLD <= 'Y' .AND. NFLD < 60" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(256)", f2.Count( ulCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(257)", (xbInt32) ulCnt, 6 );
+
+  // deleted flag only
+  iRc += TestMethod( iPo, "Set(258)", f2.Set( "DELETED()" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(259)", f2.Count( ulCnt, XB_ALL_RECS ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(260)", (xbInt32) ulCnt, 1 );
+  iRc += TestMethod( iPo, "Count(261)", f2.Count( ulCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(262)", (xbInt32) ulCnt, 0 );
+  iRc += TestMethod( iPo, "Set(263)", f2.Set( ".NOT. DELETED()" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(264)", f2.Count( ulCnt, XB_ALL_RECS ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(265)", (xbInt32) ulCnt, 130 );
+  iRc += TestMethod( iPo, "Set(311)", f2.Set( "DEL() = '*'" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(312)", f2.Count( ulCnt, XB_ALL_RECS ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(313)", (xbInt32) ulCnt, 1 );
+  iRc += TestMethod( iPo, "Set(314)", f2.Set( "' ' = DEL()" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(315)", f2.Count( ulCnt, XB_ALL_RECS ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(316)", (xbInt32) ulCnt, 130 );
+  iRc += TestMethod( iPo, "Set(317)", f2.Set( "DEL() <> '*'" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(318)", f2.Count( ulCnt, XB_DELETED_RECS ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(319)", (xbInt32) ulCnt, 0 );
+
+  // block evaluation
+  iRc += TestMethod( iPo, "Set(266)", f2.Set( "NFLD > 125" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(267)", f2.Count( ulCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(268)", (xbInt32) ulCnt, 7 );
+  iRc += TestMethod( iPo, "Exists(269)", f2.Exists( bExists ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Exists(270)", (xbInt32) bExists, (xbInt32) xbTrue );
+  iRc += TestMethod( iPo, "Set(271)", f2.Set( "NFLD > 9999" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Exists(272)", f2.Exists( bExists ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Exists(273)", (xbInt32) bExists, (xbInt32) xbFalse );
+
+  // record at a time
+  iRc += TestMethod( iPo, "Set(274)", f2.Set( "LEFT( CFLD, 2 ) = 'YY'" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(275)", f2.Count( ulCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(276)", (xbInt32) ulCnt, 4 );
+  iRc += TestMethod( iPo, "GetCurRecNo(277)", (xbInt32) MyFile->GetCurRecNo(), 7 );
+
+  // pending updates are left alone
+  iRc += TestMethod( iPo, "PutLongField(320)", MyFile->PutLongField( "NFLD", 9999 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(321)", f2.Count( ulCnt ), XB_INVALID_RECORD );
+  iRc += TestMethod( iPo, "GetDbfStatus(322)", MyFile->GetDbfStatus(), XB_UPDATED );
+  iRc += TestMethod( iPo, "Abort(323)", MyFile->Abort(), XB_NO_ERROR );
+
+  #ifdef XB_NDX_SUPPORT
+  // an index range count leaves the tag on the caller's key
+  xbUInt32 ulKeyRecNo = 0;
+  xbUInt32 ulNextRecNo = 0;
+  ixPtr->GetFirstKey( ndx, 0 );
+  ixPtr->GetNextKey( ndx, 0 );
+  ixPtr->GetNextKey( ndx, 0 );
+  ixPtr->GetNextKey( ndx, 0 );
+  ixPtr->GetCurKeyRecNo( ndx, ulNextRecNo );
+  iRc += TestMethod( iPo, "GetFirstKey(324)", ixPtr->GetFirstKey( ndx, 0 ), XB_NO_ERROR );
+  ixPtr->GetNextKey( ndx, 0 );
+  ixPtr->GetNextKey( ndx, 0 );
+  iRc += TestMethod( iPo, "Set(325)", f2.Set( "CFLD >= 'YYYY'" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(326)", f2.Count( ulCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(327)", (xbInt32) ulCnt, 7 );
+  iRc += TestMethod( iPo, "GetCurRecNo(328)", (xbInt32) MyFile->GetCurRecNo(), 7 );
+  iRc += TestMethod( iPo, "GetNextKey(329)", ixPtr->GetNextKey( ndx, 0 ), XB_NO_ERROR );
+  ixPtr->GetCurKeyRecNo( ndx, ulKeyRecNo );
+  iRc += TestMethod( iPo, "GetCurKeyRecNo(347)", (xbInt32) ulKeyRecNo, (xbInt32) ulNextRecNo );
+
+  // an index range count read through the record buffer, with no current record
+  iRc += TestMethod( iPo, "BlankRecord(348)", MyFile->BlankRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Set(349)", f2.Set( "LEFT( CFLD, 2 ) = 'YY' .AND. RECNO() > 0" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(350)", f2.Count( ulCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(351)", (xbInt32) ulCnt, 4 );
+  iRc += TestMethod( iPo, "GetCurRecNo(352)", (xbInt32) MyFile->GetCurRecNo(), 0 );
+  #endif  // XB_NDX_SUPPORT
+
+  // a whole table count read through the record buffer, with no current record
+  iRc += TestMethod( iPo, "BlankRecord(353)", MyFile->BlankRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Set(354)", f2.Set( "LEFT( CFLD, 2 ) = 'YY' .OR. RECNO() = 2" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(355)", f2.Count( ulCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(356)", (xbInt32) ulCnt, 5 );
+  iRc += TestMethod( iPo, "GetCurRecNo(357)", (xbInt32) MyFile->GetCurRecNo(), 0 );
+  MyFile->GetField( "CFLD", s );
+  iRc += TestMethod( iPo, "GetField(358)", s.Trim().Str(), "", 0 );
+  iRc += TestMethod( iPo, "GetRecord(359)", MyFile->GetRecord( 7 ), XB_NO_ERROR );
+
+  #ifdef XB_PARALLEL_SUPPORT
+  // parallel scans, checked against a serial pass
+  xbFilter f3( MyFile );
+  xbInt32  lSerCnt = 0;
+  xbInt32  lSerSum = 0;
+  xbInt32  lRecSum;
+  xbUInt32 ulPrevRecNo;
+  xbBool   bInOrder;
+  iRc += TestMethod( iPo, "Set(278)", f3.Set( "NFLD > 100" ), XB_NO_ERROR );
+  iRc2 = f3.GetFirstRecord();
+  while( iRc2 == XB_NO_ERROR ){
+    lSerCnt++;
+    lSerSum += (xbInt32) MyFile->GetCurRecNo();
+    iRc2 = f3.GetNextRecord();
+  }
+  iRc += TestMethod( iPo, "Count(279)", lSerCnt, 32 );
+  iRc += TestMethod( iPo, "SetParallel(280)", f3.SetParallel( -1 ), XB_INVALID_OPTION );
+  iRc += TestMethod( iPo, "SetParallel(281)", f3.SetParallel( 4 ), XB_NO_ERROR );
+
+  iRc += TestMethod( iPo, "GetFirstRecord(282)", f3.GetFirstRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetParallelStatus(283)", (xbInt32) f3.GetParallelStatus(), (xbInt32) xbTrue );
+  iRc += TestMethod( iPo, "GetCurRecNo(284)", (xbInt32) MyFile->GetCurRecNo(), 2 );
+  lRecCnt = 1;
+  lRecSum = (xbInt32) MyFile->GetCurRecNo();
+  ulPrevRecNo = MyFile->GetCurRecNo();
+  bInOrder = xbTrue;
+  while( f3.GetNextRecord() == XB_NO_ERROR ){
+    if( MyFile->GetCurRecNo() <= ulPrevRecNo )
+      bInOrder = xbFalse;
+    ulPrevRecNo = MyFile->GetCurRecNo();
+    lRecCnt++;
+    lRecSum += (xbInt32) MyFile->GetCurRecNo();
+  }
+  iRc += TestMethod( iPo, "Count(285)", lRecCnt, lSerCnt );
+  iRc += TestMethod( iPo, "Sum(286)", lRecSum, lSerSum );
+  iRc += TestMethod( iPo, "InOrder(287)", (xbInt32) bInOrder, (xbInt32) xbTrue );
+
+  iRc += TestMethod( iPo, "GetLastRecord(288)", f3.GetLastRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(289)", (xbInt32) MyFile->GetCurRecNo(), 131 );
+  lRecCnt = 1;
+  ulPrevRecNo = MyFile->GetCurRecNo();
+  bInOrder = xbTrue;
+  while( f3.GetPrevRecord() == XB_NO_ERROR ){
+    if( MyFile->GetCurRecNo() >= ulPrevRecNo )
+      bInOrder = xbFalse;
+    ulPrevRecNo = MyFile->GetCurRecNo();
+    lRecCnt++;
+  }
+  iRc += TestMethod( iPo, "Count(290)", lRecCnt, lSerCnt );
+  iRc += TestMethod( iPo, "InOrder(291)", (xbInt32) bInOrder, (xbInt32) xbTrue );
+
+  // as found, same records in any order
+  iRc += TestMethod( iPo, "SetParallel(292)", f3.SetParallel( 4, xbFalse ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFirstRecord(293)", f3.GetFirstRecord(), XB_NO_ERROR );
+  lRecCnt = 1;
+  lRecSum = (xbInt32) MyFile->GetCurRecNo();
+  while( f3.GetNextRecord() == XB_NO_ERROR ){
+    lRecCnt++;
+    lRecSum += (xbInt32) MyFile->GetCurRecNo();
+  }
+  iRc += TestMethod( iPo, "Count(294)", lRecCnt, lSerCnt );
+  iRc += TestMethod( iPo, "Sum(295)", lRecSum, lSerSum );
+
+  // limit stops the workers early
+  f3.SetLimit( 3 );
+  iRc += TestMethod( iPo, "GetFirstRecord(296)", f3.GetFirstRecord(), XB_NO_ERROR );
+  lRecCnt = 1;
+  while( f3.GetNextRecord() == XB_NO_ERROR )
+    lRecCnt++;
+  iRc += TestMethod( iPo, "Count(297)", lRecCnt, 3 );
+  iRc += TestMethod( iPo, "SetParallel(298)", f3.SetParallel( 4 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFirstRecord(299)", f3.GetFirstRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetNextRecord(300)", f3.GetNextRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetNextRecord(301)", f3.GetNextRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(302)", (xbInt32) MyFile->GetCurRecNo(), 101 );
+  iRc += TestMethod( iPo, "GetNextRecord(303)", f3.GetNextRecord(), XB_LIMIT_REACHED );
+  f3.SetLimit( 0 );
+
+  // a record changed after the scan is checked again and skipped
+  iRc += TestMethod( iPo, "GetFirstRecord(304)", f3.GetFirstRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetRecord(305)", MyFile->GetRecord( 5 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutLongField(306)", MyFile->PutLongField( "NFLD", 5 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(307)", MyFile->Commit(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetRecord(308)", MyFile->GetRecord( 2 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetNextRecord(309)", f3.GetNextRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(310)", (xbInt32) MyFile->GetCurRecNo(), 101 );
+  #endif  // XB_PARALLEL_SUPPORT
+
 
   iRc += TestMethod( iPo, "Close(100)", MyFile->Close(), XB_NO_ERROR );
   delete MyFile;
 
+  #ifdef XB_MDX_SUPPORT
+  // index range on a unique tag with a bloom filter, the bounds are not keys in the tag
+  xbSchema MyBloomRecord[] =
+  {
+    { "CITY",       XB_CHAR_FLD,      3, 0 },
+    { "",0,0,0 }
+  };
+  #ifdef XB_DBF4_SUPPORT
+  xbDbf *MyFile2 = new xbDbf4( &x );
+  #else
+  xbDbf *MyFile2 = new xbDbf3( &x );
+  #endif
+  xbIx *pIxB;
+  void *pTagB;
+  x.SetDefaultIxTagMode( XB_IX_XBASE_MODE );
+  MyFile2->SetMultiUser( xbOff );
+  iRc += TestMethod( iPo, "CreateTable(330)", MyFile2->CreateTable( "TestFiltB.DBF", "TestFilterB", MyBloomRecord, XB_OVERLAY, XB_SINGLE_USER ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CreateTag(331)", MyFile2->CreateTag( "MDX", "CITY_TAG", "CITY", "", 0, xbTrue, XB_OVERLAY, &pIxB, &pTagB ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "SetBloomFilter(332)", pIxB->SetBloomFilter( pTagB, xbTrue ), XB_NO_ERROR );
+
+  // an empty table is counted without reading or positioning anything
+  xbFilter f4( MyFile2 );
+  iRc += TestMethod( iPo, "Set(360)", f4.Set( "CITY >= 'DDD'" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(361)", f4.Count( ulCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(362)", (xbInt32) ulCnt, 0 );
+  iRc += TestMethod( iPo, "GetCurRecNo(363)", (xbInt32) MyFile2->GetCurRecNo(), 0 );
+
+  iRc2 = XB_NO_ERROR;
+  for( char cCity = 'A'; cCity <= 'V' && iRc2 == XB_NO_ERROR; cCity++ ){
+    if( cCity == 'D' || cCity == 'F' )
+      continue;
+    s = cCity;
+    s.PadRight( cCity, 3 );
+    MyFile2->BlankRecord();
+    MyFile2->PutField( "CITY", s );
+    iRc2 = MyFile2->AppendRecord();
+  }
+  iRc += TestMethod( iPo, "AppendRecord(333)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(334)", MyFile2->Commit(), XB_NO_ERROR );
+
+  iRc += TestMethod( iPo, "GetLastKey(335)", pIxB->GetLastKey( pTagB, 0 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Set(336)", f4.Set( "CITY >= 'DDD' .AND. CITY <= 'FFF'" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetFirstRecord(337)", f4.GetFirstRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetIxRangeStatus(338)", (xbInt32) f4.GetIxRangeStatus(), (xbInt32) xbTrue );
+  MyFile2->GetField( "CITY", s );
+  iRc += TestMethod( iPo, "GetField(339)", s.Str(), "EEE", 3 );
+  iRc += TestMethod( iPo, "GetNextRecord(340)", f4.GetNextRecord(), XB_EOF );
+  iRc += TestMethod( iPo, "GetLastKey(341)", pIxB->GetLastKey( pTagB, 0 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(342)", f4.Count( ulCnt ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Count(343)", (xbInt32) ulCnt, 1 );
+  iRc += TestMethod( iPo, "Exists(344)", f4.Exists( bExists ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Exists(345)", (xbInt32) bExists, (xbInt32) xbTrue );
+
+  iRc += TestMethod( iPo, "Close(346)", MyFile2->Close(), XB_NO_ERROR );
+  delete MyFile2;
+  #endif  // XB_MDX_SUPPORT
+
   if( iPo > 0 || iRc < 0 )
     fprintf( stdout, "Total Errors = %d\n", iRc * -1 );
 
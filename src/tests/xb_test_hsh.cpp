@@ -0,0 +1,284 @@
+/* xb_test_hsh.cpp
+
+XBase64 Software Library
+
+Copyright (c) 1997,2003,2014,2022,2023,2024 Gary A Kunkel
+
+The xb64 software library is covered under the terms of the GPL Version 3, 2007 license.
+
+Email Contact:
+
+    XDB-devel@lists.sourceforge.net
+    XDB-users@lists.sourceforge.net
+
+*/
+
+// This program tests the class xbIxHsh
+
+// usage:   xb_test_hsh QUITE|NORMAL|VERBOSE
+
+
+#include "xbase.h"
+
+using namespace xb;
+
+#include "tstfuncs.cpp"
+
+int main( int argCnt, char **av )
+{
+  int iRc = 0;
+  int iRc2;
+  int iPo = 1;          /* print option */
+                       /* 0 - QUIET    */
+                       /* 1 - NORMAL   */
+                       /* 2 - VERBOSE  */
+
+  xbString sMsg;
+  char c;
+  xbString s;
+
+  if( argCnt > 1 ) {
+    if( av[1][0] == 'Q' )
+      iPo = 0;
+    else if( av[1][0] == 'V' )
+      iPo = 2;
+  }
+
+
+  xbSchema MyV4Record[] =
+  {
+    { "CITY",   XB_CHAR_FLD,    100, 0 },
+    { "STATE",  XB_CHAR_FLD,      2, 0 },
+    { "ZIP",    XB_NUMERIC_FLD,   9, 0 },
+    { "DATE1",  XB_DATE_FLD,      8, 0  },
+    { "",0,0,0 }
+  };
+
+
+  xbXBase x;
+
+  #ifdef XB_LOGGING_SUPPORT
+  x.SetLogDirectory( PROJECT_LOG_DIR );
+  x.EnableMsgLogging();
+  if( iPo ){
+    std::cout << "Logfile is [" << x.GetLogFqFileName().Str() << "]" << std::endl;
+  }
+  sMsg.Sprintf( "Program [%s] initializing...", av[0] );
+  x.WriteLogMessage( sMsg );
+  #endif
+
+  x.SetDataDirectory( PROJECT_DATA_DIR );
+  x.SetTempDirectory( PROJECT_TEMP_DIR );
+  x.SetMultiUser( xbFalse );
+  InitTime();
+
+  if( iPo > 0 )
+    std::cout << "Default Data Directory is [" << x.GetDataDirectory().Str() << "]" << std::endl;
+
+  xbIx *pIx;
+  void *pTag;
+  xbIx *pIxZip;
+  void *pTagZip;
+  xbIx *pIxDt;
+  void *pTagDt;
+  xbDate dt = "19890209";
+  xbString sKey;
+  xbUInt32 ulCnt;
+  xbInt32  lZip = 10000;
+
+  xbDbf *V4DbfX1 = new xbDbf4( &x );
+
+  iRc2 = V4DbfX1->CreateTable( "THSHDB01.DBF", "TestHsh", MyV4Record, XB_OVERLAY, XB_MULTI_USER );
+  iRc += TestMethod( iPo, "CreateTable(1)", iRc2, 0 );
+
+  // load some records before the tags are created, CreateTag should build the tag from the table
+  for( xbUInt16 i = 0; i < 5; i++ ){
+    for( xbUInt16 j = 0; j < 4; j++ ){
+      c = (char) (j + 65);
+      s = c;
+      s.PadRight( c, (xbUInt32) i + 1 );
+
+      iRc2 = V4DbfX1->BlankRecord();
+      if( iRc2 != XB_NO_ERROR )
+        iRc += TestMethod( iPo, "BlankRecord()", iRc2, XB_NO_ERROR );
+
+      iRc2 = V4DbfX1->PutField( "CITY", s );
+      if( iRc2 != XB_NO_ERROR )
+        iRc += TestMethod( iPo, "PutField()", iRc2, XB_NO_ERROR );
+
+      iRc2 = V4DbfX1->PutLongField( "ZIP", lZip++ );
+      if( iRc2 != XB_NO_ERROR )
+        iRc += TestMethod( iPo, "PutLongField()", iRc2, XB_NO_ERROR );
+
+      iRc2 = V4DbfX1->PutDateField( "DATE1", dt );
+      dt++;
+      if( iRc2 != XB_NO_ERROR )
+        iRc += TestMethod( iPo, "PutDateField()", iRc2, XB_NO_ERROR );
+
+      iRc2 = V4DbfX1->AppendRecord();
+      if( iRc2 != XB_NO_ERROR )
+        iRc += TestMethod( iPo, "AppendRecord()", iRc2, XB_NO_ERROR );
+
+      iRc2 = V4DbfX1->Commit();
+      if( iRc2 != XB_NO_ERROR )
+        iRc += TestMethod( iPo, "Commit()", iRc2, XB_NO_ERROR );
+    }
+  }
+
+  // xbase mode, duplicate keys on a unique tag are rejected rather than left out of the tag
+  x.SetDefaultIxTagMode( XB_IX_XBASE_MODE );
+
+  iRc2 = V4DbfX1->CreateTag( "HSH", "STATE_TAG", "LEFT( CITY, 1 )", "", 0, 0, XB_OVERLAY, &pIx, &pTag );
+  iRc += TestMethod( iPo, "CreateTag(1)", iRc2, 0 );
+
+  iRc2 = V4DbfX1->CreateTag( "HSH", "ZIP_TAG", "ZIP", "", 0, xbTrue, XB_OVERLAY, &pIxZip, &pTagZip );
+  iRc += TestMethod( iPo, "CreateTag(2)", iRc2, 0 );
+  iRc += TestMethod( iPo, "CreateTag(2) same ix", (xbInt32) (pIx == pIxZip), 1 );
+
+  iRc2 = V4DbfX1->CreateTag( "HSH", "DATE_TAG", "DATE1", "", 0, 0, XB_OVERLAY, &pIxDt, &pTagDt );
+  iRc += TestMethod( iPo, "CreateTag(3)", iRc2, 0 );
+
+  iRc2 = V4DbfX1->CreateTag( "HSH", "ZIP_TAG", "ZIP", "", 0, 0, XB_OVERLAY, &pIxDt, &pTagDt );
+  iRc += TestMethod( iPo, "CreateTag(4) dup name", iRc2, XB_INVALID_TAG );
+
+  iRc += TestMethod( iPo, "GetTagCount()", pIx->GetTagCount(), 3 );
+
+  iRc2 = pIx->GetKeyCnt( pTag, ulCnt );
+  iRc += TestMethod( iPo, "GetKeyCnt()", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetKeyCnt()", (xbInt32) ulCnt, 20 );
+
+  iRc2 = pIx->GetDistinctKeyCnt( pTag, ulCnt );
+  iRc += TestMethod( iPo, "GetDistinctKeyCnt()", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetDistinctKeyCnt()", (xbInt32) ulCnt, 4 );
+
+  // find the first of the duplicate keys, then walk the duplicates in record number order
+  iRc2 = V4DbfX1->Find( pIx, pTag, xbString( "C" ));
+  iRc += TestMethod( iPo, "Find(C)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Find(C) RecNo", (xbInt32) V4DbfX1->GetCurRecNo(), 3 );
+
+  xbInt16 iDupCnt = 1;
+  xbUInt32 ulPrevRec = V4DbfX1->GetCurRecNo();
+  xbBool bOrderOk = xbTrue;
+  while( V4DbfX1->GetNextKey( pIx, pTag ) == XB_NO_ERROR ){
+    pIx->GetCurKeyVal( pTag, sKey );
+    if( sKey != "C" )
+      break;
+    if( V4DbfX1->GetCurRecNo() <= ulPrevRec )
+      bOrderOk = xbFalse;
+    ulPrevRec = V4DbfX1->GetCurRecNo();
+    iDupCnt++;
+  }
+  iRc += TestMethod( iPo, "GetNextKey() dup count", iDupCnt, 5 );
+  iRc += TestMethod( iPo, "GetNextKey() dup order", (xbInt32) bOrderOk, 1 );
+
+  iRc2 = V4DbfX1->Find( pIx, pTag, xbString( "Z" ));
+  iRc += TestMethod( iPo, "Find(Z)", iRc2, XB_NOT_FOUND );
+
+  // a full traversal forward and backward visits every entry
+  xbInt16 iFwdCnt = 0;
+  iRc2 = pIx->GetFirstKey( pTag, 0 );
+  while( iRc2 == XB_NO_ERROR ){
+    iFwdCnt++;
+    iRc2 = pIx->GetNextKey( pTag, 0 );
+  }
+  iRc += TestMethod( iPo, "GetNextKey() EOF", iRc2, XB_EOF );
+  iRc += TestMethod( iPo, "GetNextKey() count", iFwdCnt, 20 );
+
+  xbInt16 iBwdCnt = 0;
+  iRc2 = pIx->GetLastKey( pTag, 0 );
+  while( iRc2 == XB_NO_ERROR ){
+    iBwdCnt++;
+    iRc2 = pIx->GetPrevKey( pTag, 0 );
+  }
+  iRc += TestMethod( iPo, "GetPrevKey() BOF", iRc2, XB_BOF );
+  iRc += TestMethod( iPo, "GetPrevKey() count", iBwdCnt, 20 );
+
+  // numeric and date keys
+  iRc2 = V4DbfX1->Find( pIxZip, pTagZip, (xbDouble) 10007 );
+  iRc += TestMethod( iPo, "Find(10007)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Find(10007) RecNo", (xbInt32) V4DbfX1->GetCurRecNo(), 8 );
+
+  xbDate dtFind = "19890211";
+  iRc2 = V4DbfX1->Find( pIxDt, pTagDt, dtFind );
+  iRc += TestMethod( iPo, "Find(19890211)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Find(19890211) RecNo", (xbInt32) V4DbfX1->GetCurRecNo(), 3 );
+
+  xbDate dtCur;
+  iRc2 = pIxDt->GetCurKeyVal( pTagDt, dtCur );
+  iRc += TestMethod( iPo, "GetCurKeyVal(date)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurKeyVal(date)", dtCur.Str(), "19890211", 8 );
+
+  // unique tag rejects a duplicate
+  iRc2 = V4DbfX1->BlankRecord();
+  iRc2 += V4DbfX1->PutField( "CITY", "EEE" );
+  iRc2 += V4DbfX1->PutLongField( "ZIP", 10003 );
+  iRc += TestMethod( iPo, "PutField()", iRc2, XB_NO_ERROR );
+  iRc2 = V4DbfX1->AppendRecord();
+  iRc += TestMethod( iPo, "AppendRecord() dup", iRc2, XB_KEY_NOT_UNIQUE );
+  V4DbfX1->Abort();
+
+  // append maintains the tags
+  iRc2 = V4DbfX1->BlankRecord();
+  iRc2 += V4DbfX1->PutField( "CITY", "EEE" );
+  iRc2 += V4DbfX1->PutLongField( "ZIP", 20000 );
+  iRc2 += V4DbfX1->PutDateField( "DATE1", dt );
+  iRc += TestMethod( iPo, "PutField()", iRc2, XB_NO_ERROR );
+  iRc2 = V4DbfX1->AppendRecord();
+  iRc += TestMethod( iPo, "AppendRecord()", iRc2, XB_NO_ERROR );
+  iRc2 = V4DbfX1->Commit();
+  iRc += TestMethod( iPo, "Commit()", iRc2, XB_NO_ERROR );
+
+  iRc2 = V4DbfX1->Find( pIx, pTag, xbString( "E" ));
+  iRc += TestMethod( iPo, "Find(E)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Find(E) RecNo", (xbInt32) V4DbfX1->GetCurRecNo(), 21 );
+
+  // update maintains the tags, record 21 is current
+  iRc2 = V4DbfX1->PutField( "CITY", "FFF" );
+  iRc += TestMethod( iPo, "PutField()", iRc2, XB_NO_ERROR );
+  iRc2 = V4DbfX1->PutRecord();
+  iRc += TestMethod( iPo, "PutRecord()", iRc2, XB_NO_ERROR );
+
+  iRc2 = V4DbfX1->Find( pIx, pTag, xbString( "E" ));
+  iRc += TestMethod( iPo, "Find(E) after update", iRc2, XB_NOT_FOUND );
+  iRc2 = V4DbfX1->Find( pIx, pTag, xbString( "F" ));
+  iRc += TestMethod( iPo, "Find(F) after update", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Find(F) RecNo", (xbInt32) V4DbfX1->GetCurRecNo(), 21 );
+
+  iRc2 = V4DbfX1->Find( pIxZip, pTagZip, (xbDouble) 20000 );
+  iRc += TestMethod( iPo, "Find(20000)", iRc2, XB_NO_ERROR );
+
+  iRc += TestMethod( iPo, "CheckTagIntegrity(1)", V4DbfX1->CheckTagIntegrity( 1, 2 ), XB_NO_ERROR );
+
+  // filter using the hash tag
+  #ifdef XB_FILTER_SUPPORT
+  xbFilter f1( V4DbfX1 );
+  iRc2 = f1.Set( "ZIP > 10005", pIx, pTag );
+  iRc += TestMethod( iPo, "xbFilter::Set()", iRc2, XB_NO_ERROR );
+  iRc2 = f1.Find( xbString( "B" ));
+  iRc += TestMethod( iPo, "xbFilter::Find(B)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "xbFilter::Find(B) RecNo", (xbInt32) V4DbfX1->GetCurRecNo(), 10 );
+  #endif
+
+  // delete the tags, the index is released with the last one
+  iRc2 = V4DbfX1->DeleteTag( "HSH", "STATE_TAG" );
+  iRc += TestMethod( iPo, "DeleteTag(1)", iRc2, XB_NO_ERROR );
+  iRc2 = V4DbfX1->DeleteTag( "HSH", "STATE_TAG" );
+  iRc += TestMethod( iPo, "DeleteTag(1) again", iRc2, XB_INVALID_TAG );
+  iRc2 = V4DbfX1->DeleteTag( "HSH", "ZIP_TAG" );
+  iRc += TestMethod( iPo, "DeleteTag(2)", iRc2, XB_NO_ERROR );
+  iRc2 = V4DbfX1->DeleteTag( "HSH", "DATE_TAG" );
+  iRc += TestMethod( iPo, "DeleteTag(3)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetIxList()", (xbInt32) (V4DbfX1->GetIxList() == NULL), 1 );
+
+  x.CloseAllTables();
+
+  if( iPo > 0 || iRc < 0 )
+    fprintf( stdout, "Total Errors = %d\n", iRc * -1 );
+
+#ifdef XB_LOGGING_SUPPORT
+  sMsg.Sprintf( "Program [%s] terminating with [%d] errors...", av[0], iRc * -1 );
+  x.WriteLogMessage( sMsg );
+#endif
+
+  return iRc;
+}
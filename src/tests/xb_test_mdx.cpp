@@ -178,6 +178,48 @@ int main( int argCnt, char **av )
 
   iRc += TestMethod( iPo, "CheckTagIntegrity(204)", V4DbfX1->CheckTagIntegrity( 1, 0 ), XB_NO_ERROR );
 
+  // index only key counts
+  xbUInt32 ulKeyCnt = 0;
+  iRc2 = pIx0->GetKeyCnt( pTag0, ulKeyCnt );
+  iRc += TestMethod( iPo, "GetKeyCnt(205)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetKeyCnt(206)", (xbInt32) ulKeyCnt, 490 );
+
+  iRc2 = pIx0->GetKeyCnt( pTag0, "A", ulKeyCnt );
+  iRc += TestMethod( iPo, "GetKeyCnt(207)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetKeyCnt(208)", (xbInt32) ulKeyCnt, 35 );
+
+  iRc2 = pIx0->GetKeyCnt( pTag0, "CCCC", ulKeyCnt );
+  iRc += TestMethod( iPo, "GetKeyCnt(209)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetKeyCnt(210)", (xbInt32) ulKeyCnt, 32 );
+
+  iRc2 = pIx0->GetKeyCnt( pTag0, "Z", ulKeyCnt );
+  iRc += TestMethod( iPo, "GetKeyCnt(211)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetKeyCnt(212)", (xbInt32) ulKeyCnt, 0 );
+
+  iRc2 = pIx2->GetDistinctKeyCnt( pTag2, ulKeyCnt );
+  iRc += TestMethod( iPo, "GetDistinctKeyCnt(213)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetDistinctKeyCnt(214)", (xbInt32) ulKeyCnt, 490 );
+
+  xbDate dtKey;
+  iRc2 = V4DbfX1->GetFirstKey( pIx2, pTag2, xbFalse );
+  iRc += TestMethod( iPo, "GetFirstKey(215)", iRc2, XB_NO_ERROR );
+  iRc2 = pIx2->GetCurKeyVal( pTag2, dtKey );
+  iRc += TestMethod( iPo, "GetCurKeyVal(216)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurKeyVal(217)", dtKey.Str(), "19890209", 8 );
+
+  // tag depth leaves the tag on its current key
+  xbInt16  iDepth = 0;
+  xbUInt32 ulKeyRecNo = 0;
+  xbUInt32 ulKeyRecNo2 = 0;
+  iRc += TestMethod( iPo, "FindKey(218)", pIx0->FindKey( pTag0, "CCCC", 4, 0 ), XB_NO_ERROR );
+  for( xbInt16 i = 0; i < 5; i++ )
+    pIx0->GetNextKey( pTag0, 0 );
+  pIx0->GetCurKeyRecNo( pTag0, ulKeyRecNo );
+  iRc += TestMethod( iPo, "GetTagDepth(219)", pIx0->GetTagDepth( pTag0, iDepth ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetTagDepth(221)", iDepth > 1 ? 1 : 0, 1 );
+  iRc += TestMethod( iPo, "GetCurKeyRecNo(222)", pIx0->GetCurKeyRecNo( pTag0, ulKeyRecNo2 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurKeyRecNo(223)", (xbInt32) ulKeyRecNo2, (xbInt32) ulKeyRecNo );
+
 
   // attempt to add a dup key 
   iRc2 = V4DbfX1->BlankRecord();
@@ -334,6 +376,172 @@ int main( int argCnt, char **av )
   x.CloseAllTables();
 
 
+  // test bloom filter on a unique tag
+  xbDbf *V4DbfX3 = new xbDbf4( &x );
+  iRc2 = V4DbfX3->CreateTable( "TMDXDB03.DBF", "TestMdxX4", MyV4Record, XB_OVERLAY, XB_MULTI_USER );
+  iRc += TestMethod( iPo, "CreateTable(600)", iRc2, 0 );
+
+  iRc2 = V4DbfX3->CreateTag( "MDX", "CITY_TAGU",  "CITY", "", 0, xbTrue, XB_OVERLAY, &pIx0, &pTag0 );
+  iRc += TestMethod( iPo, "CreateTag(601)", iRc2, 0 );
+
+  iRc2 = V4DbfX3->CreateTag( "MDX", "ZIP_TAG",   "ZIP", "",  0, xbTrue, XB_OVERLAY, &pIx1, &pTag1 );
+  iRc += TestMethod( iPo, "CreateTag(602)", iRc2, 0 );
+
+  iRc += TestMethod( iPo, "SetBloomFilter(603)", pIx1->SetBloomFilter( pTag1, xbTrue ), XB_INVALID_OPTION );
+  iRc += TestMethod( iPo, "SetBloomFilter(604)", pIx0->SetBloomFilter( pTag0, xbTrue ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetBloomFilter(605)", pIx0->GetBloomFilter( pTag0 ), xbTrue );
+
+  for( xbInt16 i = 0; i < 200; i++ ){
+    s.Sprintf( "CITY%04d", i );
+    iRc2 = V4DbfX3->BlankRecord();
+    if( iRc2 == XB_NO_ERROR )
+      iRc2 = V4DbfX3->PutField( "CITY", s );
+    if( iRc2 == XB_NO_ERROR )
+      iRc2 = V4DbfX3->PutLongField( "ZIP", uZip++ );
+    if( iRc2 == XB_NO_ERROR )
+      iRc2 = V4DbfX3->AppendRecord();
+    if( iRc2 == XB_NO_ERROR )
+      iRc2 = V4DbfX3->Commit();
+    if( iRc2 != XB_NO_ERROR )
+      iRc += TestMethod( iPo, "AppendRecord(606)", iRc2, XB_NO_ERROR );
+  }
+
+  iRc2 = V4DbfX3->BlankRecord();
+  V4DbfX3->PutField( "CITY", "CITY0123" );
+  V4DbfX3->PutLongField( "ZIP", uZip++ );
+  iRc += TestMethod( iPo, "AppendRecord(607)", V4DbfX3->AppendRecord(), XB_KEY_NOT_UNIQUE );
+  V4DbfX3->Abort();
+
+  s = "CITY0199";
+  s.PadRight( ' ', (xbUInt32) pIx0->GetKeyLen( pTag0 ));
+  iRc += TestMethod( iPo, "Find(608)", V4DbfX3->Find( pIx0, pTag0, s, xbFalse ), XB_NO_ERROR );
+  s = "CITY0200";
+  s.PadRight( ' ', (xbUInt32) pIx0->GetKeyLen( pTag0 ));
+  iRc += TestMethod( iPo, "Find(609)", V4DbfX3->Find( pIx0, pTag0, s, xbFalse ), XB_NOT_FOUND );
+  iRc += TestMethod( iPo, "Find(610)", V4DbfX3->Find( pIx0, pTag0, s, xbTrue ), XB_NOT_FOUND );
+
+  // a miss on an index only lookup positions the tag on the next key, same as without the filter
+  iRc += TestMethod( iPo, "GetLastKey(612)", pIx0->GetLastKey( pTag0, 0 ), XB_NO_ERROR );
+  s = "CITY0100X";
+  s.PadRight( ' ', (xbUInt32) pIx0->GetKeyLen( pTag0 ));
+  iRc += TestMethod( iPo, "FindKey(613)", pIx0->FindKey( pTag0, s.Str(), (xbInt32) s.Len(), 0 ), XB_NOT_FOUND );
+  pIx0->GetCurKeyVal( pTag0, s );
+  iRc += TestMethod( iPo, "GetCurKeyVal(614)", s.Rtrim().Str(), "CITY0101", 8 );
+
+  // existence check, a bloom filter miss is answered without reading index nodes and neither probe moves the tag
+  iRc += TestMethod( iPo, "GetFirstKey(615)", pIx0->GetFirstKey( pTag0, 0 ), XB_NO_ERROR );
+  xbUInt32 ulNodeReads = pIx0->GetNodeReadCnt();
+  s = "CITY0150X";
+  s.PadRight( ' ', (xbUInt32) pIx0->GetKeyLen( pTag0 ));
+  iRc += TestMethod( iPo, "ProbeKey(616)", V4DbfX3->ProbeKey( pIx0, pTag0, s ), XB_NOT_FOUND );
+  iRc += TestMethod( iPo, "GetNodeReadCnt(617)", (xbInt32) ( pIx0->GetNodeReadCnt() - ulNodeReads ), 0 );
+  s = "CITY0150";
+  s.PadRight( ' ', (xbUInt32) pIx0->GetKeyLen( pTag0 ));
+  iRc += TestMethod( iPo, "ProbeKey(618)", V4DbfX3->ProbeKey( pIx0, pTag0, s ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetNodeReadCnt(619)", pIx0->GetNodeReadCnt() > ulNodeReads, xbTrue );
+  pIx0->GetCurKeyVal( pTag0, s );
+  iRc += TestMethod( iPo, "GetCurKeyVal(632)", s.Rtrim().Str(), "CITY0000", 8 );
+  iRc += TestMethod( iPo, "CheckTagIntegrity(611)", V4DbfX3->CheckTagIntegrity( 1, 0 ), XB_NO_ERROR );
+  x.CloseAllTables();
+
+  // reopen, filter loaded from the sidecar file
+  V4DbfX3 = new xbDbf4( &x );
+  iRc += TestMethod( iPo, "Open(620)", V4DbfX3->Open( "TMDXDB03.DBF" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetTagPtrs(621)", V4DbfX3->GetTagPtrs( "CITY_TAGU", &pIx0, &pTag0 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetBloomFilter(622)", pIx0->GetBloomFilter( pTag0 ), xbTrue );
+
+  iRc2 = V4DbfX3->BlankRecord();
+  V4DbfX3->PutField( "CITY", "CITY0042" );
+  V4DbfX3->PutLongField( "ZIP", uZip++ );
+  iRc += TestMethod( iPo, "AppendRecord(623)", V4DbfX3->AppendRecord(), XB_KEY_NOT_UNIQUE );
+  V4DbfX3->Abort();
+
+  iRc2 = V4DbfX3->BlankRecord();
+  V4DbfX3->PutField( "CITY", "CITY0200" );
+  V4DbfX3->PutLongField( "ZIP", uZip++ );
+  iRc += TestMethod( iPo, "AppendRecord(624)", V4DbfX3->AppendRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(625)", V4DbfX3->Commit(), XB_NO_ERROR );
+  s = "CITY0200";
+  s.PadRight( ' ', (xbUInt32) pIx0->GetKeyLen( pTag0 ));
+  iRc += TestMethod( iPo, "Find(626)", V4DbfX3->Find( pIx0, pTag0, s, xbFalse ), XB_NO_ERROR );
+
+  iRc += TestMethod( iPo, "Reindex(627)", V4DbfX3->Reindex( 2, &pIx0, &pTag0 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Find(628)", V4DbfX3->Find( pIx0, pTag0, s, xbFalse ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckTagIntegrity(629)", V4DbfX3->CheckTagIntegrity( 1, 0 ), XB_NO_ERROR );
+
+  iRc += TestMethod( iPo, "SetBloomFilter(630)", pIx0->SetBloomFilter( pTag0, xbFalse ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetBloomFilter(631)", pIx0->GetBloomFilter( pTag0 ), xbFalse );
+  x.CloseAllTables();
+
+  // in block key search on a tag with long runs of duplicate keys, all sharing an eight byte prefix
+  xbDbf *V4DbfX4 = new xbDbf4( &x );
+  iRc += TestMethod( iPo, "CreateTable(640)", V4DbfX4->CreateTable( "TMDXDB04.DBF", "TestMdxDups", MyV4Record, XB_OVERLAY, XB_MULTI_USER ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CreateTag(641)", V4DbfX4->CreateTag( "MDX", "CITY_TAGD", "LEFT(CITY,20)", "", 0, 0, XB_OVERLAY, &pIx0, &pTag0 ), XB_NO_ERROR );
+
+  iRc2 = XB_NO_ERROR;
+  for( xbInt16 i = 0; i < 2000 && iRc2 == XB_NO_ERROR; i++ ){
+    s.Sprintf( "DUPLICATEKEY%02d", i % 8 );
+    V4DbfX4->BlankRecord();
+    V4DbfX4->PutField( "CITY", s );
+    V4DbfX4->PutLongField( "ZIP", i );
+    if(( iRc2 = V4DbfX4->AppendRecord()) == XB_NO_ERROR )
+      iRc2 = V4DbfX4->Commit();
+  }
+  iRc += TestMethod( iPo, "AppendRecord(642)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckTagIntegrity(643)", V4DbfX4->CheckTagIntegrity( 1, 0 ), XB_NO_ERROR );
+
+  // each find must land on the leftmost duplicate, the first record added for that key
+  xbInt32 lBadFinds = 0;
+  xbInt32 lZip;
+  for( xbInt16 i = 0; i < 8; i++ ){
+    s.Sprintf( "DUPLICATEKEY%02d", i );
+    s.PadRight( ' ', 20 );
+    if( V4DbfX4->Find( pIx0, pTag0, s ) != XB_NO_ERROR )
+      lBadFinds++;
+    else if( V4DbfX4->GetLongField( "ZIP", lZip ) != XB_NO_ERROR || lZip != i )
+      lBadFinds++;
+  }
+  iRc += TestMethod( iPo, "Find(644)", lBadFinds, 0 );
+
+  s = "DUPLICATEKEY08";
+  s.PadRight( ' ', 20 );
+  iRc += TestMethod( iPo, "Find(645)", V4DbfX4->Find( pIx0, pTag0, s, xbFalse ), XB_NOT_FOUND );
+
+  clock_t tStart = clock();
+  for( xbInt32 l = 0; l < 20000; l++ ){
+    s.Sprintf( "DUPLICATEKEY%02d", l % 8 );
+    s.PadRight( ' ', 20 );
+    V4DbfX4->Find( pIx0, pTag0, s, xbFalse );
+  }
+  if( iPo > 1 )
+    std::cout << "20000 duplicate key finds in " << (double) (clock() - tStart) / CLOCKS_PER_SEC << " seconds\n";
+  x.CloseAllTables();
+
+  // single digit numeric keys, an odd digit count leaves half of the last bcd byte to be filled in
+  xbDbf *V4DbfX5 = new xbDbf4( &x );
+  iRc += TestMethod( iPo, "CreateTable(650)", V4DbfX5->CreateTable( "TMDXDB05.DBF", "TestMdxNum", MyV4Record, XB_OVERLAY, XB_MULTI_USER ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CreateTag(651)", V4DbfX5->CreateTag( "MDX", "ZIP_TAGE", "ZIP", "", 0, 0, XB_OVERLAY, &pIx0, &pTag0 ), XB_NO_ERROR );
+
+  iRc2 = XB_NO_ERROR;
+  for( xbInt32 l = 20; l > 0 && iRc2 == XB_NO_ERROR; l-- ){
+    V4DbfX5->BlankRecord();
+    V4DbfX5->PutLongField( "ZIP", l );
+    if(( iRc2 = V4DbfX5->AppendRecord()) == XB_NO_ERROR )
+      iRc2 = V4DbfX5->Commit();
+  }
+  iRc += TestMethod( iPo, "AppendRecord(652)", iRc2, XB_NO_ERROR );
+
+  lBadFinds = 0;
+  for( xbInt32 l = 1; l <= 9; l++ ){
+    if( V4DbfX5->Find( pIx0, pTag0, (xbDouble) l ) != XB_NO_ERROR )
+      lBadFinds++;
+    else if( V4DbfX5->GetLongField( "ZIP", lZip ) != XB_NO_ERROR || lZip != l )
+      lBadFinds++;
+  }
+  iRc += TestMethod( iPo, "Find(653)", lBadFinds, 0 );
+  x.CloseAllTables();
+
+
 
 
 
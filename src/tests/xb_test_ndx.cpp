@@ -495,6 +495,18 @@ int main( int argCnt, char **av )
   iRc += TestMethod( iPo, "GetRecord(560)",      V3Dbf->GetRecord( 3 ),                    XB_NO_ERROR );
   iRc += TestMethod( iPo, "DeleteRecord(561)",   V3Dbf->DeleteRecord(),                    XB_NO_ERROR );
 
+  // update a non key field, the key is not regenerated, then update the key field
+  iRc += TestMethod( iPo, "GetRecord(562)",      V3Dbf->GetRecord( 1 ),                    XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutfieldDouble(563)", V3Dbf->PutDoubleField( "NFLD", 75 ),      XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutRecord(564)",      V3Dbf->PutRecord(),                       XB_NO_ERROR );
+  iRc += TestMethod( iPo, "FindKey(565)",        ixPtr->FindKey( ndx, "AAA", 3, 1 ),       XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(566)",    (xbInt32) V3Dbf->GetCurRecNo(),           1 );
+  iRc += TestMethod( iPo, "Putfield(567)",       V3Dbf->PutField( "CFLD", "EEE" ),         XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutRecord(568)",      V3Dbf->PutRecord(),                       XB_NO_ERROR );
+  iRc += TestMethod( iPo, "FindKey(569)",        ixPtr->FindKey( ndx, "AAA", 3, 0 ),       XB_NOT_FOUND );
+  iRc += TestMethod( iPo, "FindKey(570)",        ixPtr->FindKey( ndx, "EEE", 3, 1 ),       XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCurRecNo(571)",    (xbInt32) V3Dbf->GetCurRecNo(),           1 );
+
 
   ixl = V3Dbf->GetIxList();
   while( ixl ){
@@ -1281,6 +1281,625 @@ int main( int argCnt, char **av )
   delete pRel18;
   pRel18 = NULL;
 
+//***************************************************************************************
+// Test nineteen - master with one optional child having dup recs, forced hash and index joins
+
+  xbRelate * pRel19;
+  pRel19 = new xbRelate( &x );
+
+  iRc += TestMethod( iPo, "GetJoinMode(1900)", pRel19->GetJoinMode(), 'A' );
+  iRc += TestMethod( iPo, "SetJoinMode(1901)", pRel19->SetJoinMode( 'X' ), XB_INVALID_OPTION );
+
+  iRc2 = pRel19->SetMaster( dRel0 );
+  iRc += TestMethod( iPo, "SetMaster(1902)", iRc2, 0 );
+  iRc2 = pRel19->AddRelation( dRel0, "FORGN_KS3", dRel1DK, dRel1DK->GetCurIx(), dRel1DK->GetCurTag(), 'O' );
+  iRc += TestMethod( iPo, "AddRelation(1903)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetJoinType(1904)", pRel19->GetJoinType( dRel1DK ), (char) 0 );
+
+  // child table has more records than the parent, auto mode uses the index
+  iRc2 = pRel19->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(1905)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1906)", pRel19->CheckRecNo( iPo, 1, 1 ),  0 );
+  iRc += TestMethod( iPo, "GetJoinType(1907)", pRel19->GetJoinType( dRel1DK ), 'I' );
+  iRc += TestMethod( iPo, "GetJoinType(1908)", pRel19->GetJoinType( dRel0 ), (char) 0 );
+
+  #ifdef XB_HSH_SUPPORT
+  iRc += TestMethod( iPo, "SetJoinMode(1909)", pRel19->SetJoinMode( 'H' ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetJoinMode(1910)", pRel19->GetJoinMode(), 'H' );
+
+  iRc2 = pRel19->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(1911)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1912)", pRel19->CheckRecNo( iPo, 1, 1 ),  0 );
+  iRc += TestMethod( iPo, "GetJoinType(1913)", pRel19->GetJoinType( dRel1DK ), 'H' );
+
+  iRc2 = pRel19->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(1914)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1915)", pRel19->CheckRecNo( iPo, 2, 2 ),  0 );
+
+  iRc2 = pRel19->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(1916)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1917)", pRel19->CheckRecNo( iPo, 2, 3 ),  0 );
+
+  iRc2 = pRel19->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(1918)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1919)", pRel19->CheckRecNo( iPo, 3, 4 ),  0 );
+
+  iRc2 = pRel19->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(1920)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1921)", pRel19->CheckRecNo( iPo, 3, 5 ),  0 );
+
+  iRc2 = pRel19->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(1922)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1923)", pRel19->CheckRecNo( iPo, 3, 6 ),  0 );
+
+  iRc2 = pRel19->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(1924)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1925)", pRel19->CheckRecNo( iPo, 4, 7 ),  0 );
+
+  iRc2 = pRel19->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(1926)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1927)", pRel19->CheckRecNo( iPo, 5, 8 ),  0 );
+
+  iRc2 = pRel19->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(1928)", iRc2, XB_EOF );
+
+  iRc2 = pRel19->GetLastRelRecord();
+  iRc += TestMethod( iPo, "GetLastRelRecord(1929)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1930)", pRel19->CheckRecNo( iPo, 5, 8 ),  0 );
+
+  iRc2 = pRel19->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(1931)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1932)", pRel19->CheckRecNo( iPo, 4, 7 ),  0 );
+
+  iRc2 = pRel19->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(1933)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1934)", pRel19->CheckRecNo( iPo, 3, 6 ),  0 );
+
+  iRc2 = pRel19->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(1935)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1936)", pRel19->CheckRecNo( iPo, 3, 5 ),  0 );
+
+  iRc2 = pRel19->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(1937)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1938)", pRel19->CheckRecNo( iPo, 3, 4 ),  0 );
+
+  iRc2 = pRel19->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(1939)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1940)", pRel19->CheckRecNo( iPo, 2, 3 ),  0 );
+
+  iRc2 = pRel19->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(1941)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1942)", pRel19->CheckRecNo( iPo, 2, 2 ),  0 );
+
+  iRc2 = pRel19->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(1943)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1944)", pRel19->CheckRecNo( iPo, 1, 1 ),  0 );
+
+  iRc2 = pRel19->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(1945)", iRc2, XB_BOF );
+  #endif  // XB_HSH_SUPPORT
+
+  iRc += TestMethod( iPo, "SetJoinMode(1946)", pRel19->SetJoinMode( 'I' ), XB_NO_ERROR );
+  iRc2 = pRel19->GetLastRelRecord();
+  iRc += TestMethod( iPo, "GetLastRelRecord(1947)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(1948)", pRel19->CheckRecNo( iPo, 5, 8 ),  0 );
+  iRc += TestMethod( iPo, "GetJoinType(1949)", pRel19->GetJoinType( dRel1DK ), 'I' );
+
+  delete pRel19;
+  pRel19 = NULL;
+
+//***************************************************************************************
+// Test twenty - one optional child linked on a child key expression, no child index tag
+
+  #ifdef XB_HSH_SUPPORT
+  xbRelate * pRel20;
+  pRel20 = new xbRelate( &x );
+
+  iRc2 = pRel20->SetMaster( dRel0 );
+  iRc += TestMethod( iPo, "SetMaster(2000)", iRc2, 0 );
+
+  iRc2 = pRel20->AddRelationExp( dRel0, "FORGN_KS2N", dRel1DK, "PRIM_KS3", 'O' );
+  iRc += TestMethod( iPo, "AddRelationExp(2001)", iRc2, XB_INCOMPATIBLE_OPERANDS );
+
+  iRc2 = pRel20->AddRelationExp( dRel0, "FORGN_KS3", dRel1DK, "", 'O' );
+  iRc += TestMethod( iPo, "AddRelationExp(2002)", iRc2, XB_INVALID_OPTION );
+
+  iRc2 = pRel20->AddRelationExp( dRel0, "FORGN_KS3", dRel1DK, "PRIM_KS3", 'O' );
+  iRc += TestMethod( iPo, "AddRelationExp(2003)", iRc2, XB_NO_ERROR );
+
+  iRc2 = pRel20->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2004)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2005)", pRel20->CheckRecNo( iPo, 1, 1 ),  0 );
+  iRc += TestMethod( iPo, "GetJoinType(2006)", pRel20->GetJoinType( dRel1DK ), 'H' );
+
+  iRc2 = pRel20->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2007)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2008)", pRel20->CheckRecNo( iPo, 2, 2 ),  0 );
+
+  iRc2 = pRel20->GetLastRelRecord();
+  iRc += TestMethod( iPo, "GetLastRelRecord(2009)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2010)", pRel20->CheckRecNo( iPo, 5, 8 ),  0 );
+
+  iRc2 = pRel20->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(2011)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2012)", pRel20->CheckRecNo( iPo, 4, 7 ),  0 );
+
+  // add a second child for the first parent, the hash is rebuilt on the next lookup
+  iRc += TestMethod( iPo, "BlankRecord(2013)", dRel1DK->BlankRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutField(2014)", dRel1DK->PutField( "PRIM_KS3", "301" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "AppendRecord(2015)", dRel1DK->AppendRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(2016)", dRel1DK->Commit(), XB_NO_ERROR );
+
+  iRc2 = pRel20->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2017)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2018)", pRel20->CheckRecNo( iPo, 1, 1 ),  0 );
+
+  iRc2 = pRel20->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2019)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2020)", pRel20->CheckRecNo( iPo, 1, 9 ),  0 );
+
+  iRc2 = pRel20->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2021)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2022)", pRel20->CheckRecNo( iPo, 2, 2 ),  0 );
+
+  delete pRel20;
+  pRel20 = NULL;
+  #endif  // XB_HSH_SUPPORT
+
+//***************************************************************************************
+// Test twenty one - index joins, child tag stepped forward in parent key order
+
+  xbRelate * pRel21;
+  pRel21 = new xbRelate( &x );
+
+  // slave missing first, last and missing tuple
+  iRc2 = pRel21->SetMaster( dRel0 );
+  iRc += TestMethod( iPo, "SetMaster(2100)", iRc2, 0 );
+  iRc += TestMethod( iPo, "SetJoinMode(2101)", pRel21->SetJoinMode( 'I' ), XB_NO_ERROR );
+  iRc2 = pRel21->AddRelation( dRel0, "FORGN_KS1", dRel1Mfml, "PRIM_KS1", 'O' );
+  iRc += TestMethod( iPo, "AddRelation(2102)", iRc2, XB_NO_ERROR );
+
+  iRc2 = pRel21->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2104)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2105)", pRel21->CheckRecNo( iPo, 1, 0 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2106)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2107)", pRel21->CheckRecNo( iPo, 2, 1 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2108)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2109)", pRel21->CheckRecNo( iPo, 3, 0 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2110)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2111)", pRel21->CheckRecNo( iPo, 4, 2 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2112)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2113)", pRel21->CheckRecNo( iPo, 5, 0 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2114)", iRc2, XB_EOF );
+
+  delete pRel21;
+
+  // slave with a filter
+  pRel21 = new xbRelate( &x );
+  iRc2 = pRel21->SetMaster( dRel0 );
+  iRc += TestMethod( iPo, "SetMaster(2119)", iRc2, 0 );
+  iRc += TestMethod( iPo, "SetJoinMode(2120)", pRel21->SetJoinMode( 'I' ), XB_NO_ERROR );
+  iRc2 = pRel21->AddRelation( dRel0, "FORGN_KS2", dRel1Mtch, "PRIM_KS2", 'O', "NUM_KS2 = 202 OR NUM_KS2 = 204" );
+  iRc += TestMethod( iPo, "AddRelation(2121)", iRc2, XB_NO_ERROR );
+
+  iRc2 = pRel21->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2123)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2124)", pRel21->CheckRecNo( iPo, 1, 0 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2125)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2126)", pRel21->CheckRecNo( iPo, 2, 2 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2127)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2128)", pRel21->CheckRecNo( iPo, 3, 0 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2129)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2130)", pRel21->CheckRecNo( iPo, 4, 4 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2131)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2132)", pRel21->CheckRecNo( iPo, 5, 0 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2133)", iRc2, XB_EOF );
+
+  delete pRel21;
+
+  // parent keys in descending order, each lookup is a backward jump
+  pRel21 = new xbRelate( &x );
+  iRc2 = pRel21->SetMaster( dRel0 );
+  iRc += TestMethod( iPo, "SetMaster(2138)", iRc2, 0 );
+  iRc += TestMethod( iPo, "SetJoinMode(2139)", pRel21->SetJoinMode( 'I' ), XB_NO_ERROR );
+  iRc2 = pRel21->AddRelation( dRel0, "STR(406-FORGN_KS2N,3)", dRel1Mtch, "PRIM_KS2", 'O' );
+  iRc += TestMethod( iPo, "AddRelation(2140)", iRc2, XB_NO_ERROR );
+
+  iRc2 = pRel21->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2142)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2143)", pRel21->CheckRecNo( iPo, 1, 5 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2144)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2145)", pRel21->CheckRecNo( iPo, 2, 4 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2146)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2147)", pRel21->CheckRecNo( iPo, 3, 3 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2148)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2149)", pRel21->CheckRecNo( iPo, 4, 2 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2150)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2151)", pRel21->CheckRecNo( iPo, 5, 1 ),  0 );
+
+  iRc2 = pRel21->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2152)", iRc2, XB_EOF );
+
+  iRc2 = pRel21->GetLastRelRecord();
+  iRc += TestMethod( iPo, "GetLastRelRecord(2153)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2154)", pRel21->CheckRecNo( iPo, 5, 1 ),  0 );
+
+  iRc2 = pRel21->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(2155)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2156)", pRel21->CheckRecNo( iPo, 4, 2 ),  0 );
+
+  iRc2 = pRel21->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(2157)", iRc2, XB_NO_ERROR );
+
+  delete pRel21;
+  pRel21 = NULL;
+
+//***************************************************************************************
+// Test twenty two - child lookup cache, every master record has the same key
+
+  xbRelate * pRel22;
+  pRel22 = new xbRelate( &x );
+  xbUInt64 ullLookups;
+  xbUInt64 ullHits;
+
+  iRc += TestMethod( iPo, "GetCacheSize(2200)", (xbInt32) pRel22->GetCacheSize(), XB_REL_CACHE_SIZE );
+  iRc += TestMethod( iPo, "SetCacheSize(2201)", pRel22->SetCacheSize( -1 ), XB_INVALID_OPTION );
+
+  iRc2 = pRel22->SetMaster( dRel0 );
+  iRc += TestMethod( iPo, "SetMaster(2202)", iRc2, 0 );
+  iRc += TestMethod( iPo, "SetJoinMode(2203)", pRel22->SetJoinMode( 'I' ), XB_NO_ERROR );
+  iRc2 = pRel22->AddRelation( dRel0, "\"302\"", dRel1DK, "PRIM_KS3", 'O' );
+  iRc += TestMethod( iPo, "AddRelation(2204)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCacheStats(2205)", pRel22->GetCacheStats( dRel1Mtch, ullLookups, ullHits ), XB_NOT_FOUND );
+
+  iRc2 = pRel22->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2206)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2207)", pRel22->CheckRecNo( iPo, 1, 2 ),  0 );
+
+  iRc2 = pRel22->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2208)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2209)", pRel22->CheckRecNo( iPo, 1, 3 ),  0 );
+
+  iRc2 = pRel22->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2210)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2211)", pRel22->CheckRecNo( iPo, 2, 2 ),  0 );
+
+  iRc2 = pRel22->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2212)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2213)", pRel22->CheckRecNo( iPo, 2, 3 ),  0 );
+
+  iRc2 = pRel22->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2214)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2215)", pRel22->CheckRecNo( iPo, 3, 2 ),  0 );
+
+  iRc2 = pRel22->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2216)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2217)", pRel22->CheckRecNo( iPo, 3, 3 ),  0 );
+
+  iRc2 = pRel22->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2218)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2219)", pRel22->CheckRecNo( iPo, 4, 2 ),  0 );
+
+  iRc2 = pRel22->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2220)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2221)", pRel22->CheckRecNo( iPo, 4, 3 ),  0 );
+
+  iRc2 = pRel22->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2222)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2223)", pRel22->CheckRecNo( iPo, 5, 2 ),  0 );
+
+  iRc2 = pRel22->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2224)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2225)", pRel22->CheckRecNo( iPo, 5, 3 ),  0 );
+
+  iRc2 = pRel22->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2226)", iRc2, XB_EOF );
+
+  iRc += TestMethod( iPo, "GetCacheStats(2235)", pRel22->GetCacheStats( dRel1DK, ullLookups, ullHits ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCacheStats(2236)", ullLookups, (xbUInt64) 5 );
+  iRc += TestMethod( iPo, "GetCacheStats(2237)", ullHits, (xbUInt64) 4 );
+
+  iRc2 = pRel22->GetLastRelRecord();
+  iRc += TestMethod( iPo, "GetLastRelRecord(2227)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2228)", pRel22->CheckRecNo( iPo, 5, 3 ),  0 );
+
+  iRc2 = pRel22->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(2229)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2230)", pRel22->CheckRecNo( iPo, 5, 2 ),  0 );
+
+  iRc2 = pRel22->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(2231)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2232)", pRel22->CheckRecNo( iPo, 4, 3 ),  0 );
+
+  iRc2 = pRel22->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(2233)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2234)", pRel22->CheckRecNo( iPo, 4, 2 ),  0 );
+
+  // each query starts with an empty cache, the first lookup of the backward query misses
+  iRc += TestMethod( iPo, "GetCacheStats(2238)", pRel22->GetCacheStats( NULL, ullLookups, ullHits ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCacheStats(2239)", ullLookups, (xbUInt64) 7 );
+  iRc += TestMethod( iPo, "GetCacheStats(2240)", ullHits, (xbUInt64) 5 );
+
+  // cache off, same results
+  pRel22->ResetCacheStats();
+  iRc += TestMethod( iPo, "SetCacheSize(2241)", pRel22->SetCacheSize( 0 ), XB_NO_ERROR );
+  iRc2 = pRel22->GetLastRelRecord();
+  iRc += TestMethod( iPo, "GetLastRelRecord(2242)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2243)", pRel22->CheckRecNo( iPo, 5, 3 ),  0 );
+  iRc2 = pRel22->GetPrevRelRecord();
+  iRc2 = pRel22->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(2244)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2245)", pRel22->CheckRecNo( iPo, 4, 3 ),  0 );
+  iRc += TestMethod( iPo, "GetCacheStats(2246)", pRel22->GetCacheStats( NULL, ullLookups, ullHits ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCacheStats(2247)", ullLookups, (xbUInt64) 0 );
+
+  delete pRel22;
+  pRel22 = NULL;
+
+//***************************************************************************************
+// Test twenty three - child key prefetch, master read ahead and child records read in record number order
+
+  xbRelate * pRel23;
+  pRel23 = new xbRelate( &x );
+  xbString sFldVal;
+
+  iRc += TestMethod( iPo, "GetPrefetchWindow(2300)", (xbInt32) pRel23->GetPrefetchWindow(), XB_REL_PREFETCH_WINDOW );
+  iRc += TestMethod( iPo, "SetPrefetchWindow(2301)", pRel23->SetPrefetchWindow( -1 ), XB_INVALID_OPTION );
+
+  iRc2 = pRel23->SetMaster( dRel0 );
+  iRc += TestMethod( iPo, "SetMaster(2302)", iRc2, 0 );
+  iRc += TestMethod( iPo, "SetJoinMode(2303)", pRel23->SetJoinMode( 'I' ), XB_NO_ERROR );
+  iRc2 = pRel23->AddRelation( dRel0, "FORGN_KS3", dRel1DK, "PRIM_KS3", 'O' );
+  iRc += TestMethod( iPo, "AddRelation(2304)", iRc2, XB_NO_ERROR );
+
+  // the first lookup reads ahead the rest of the master table, the other four keys come from the cache
+  iRc2 = pRel23->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2305)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2306)", pRel23->CheckRecNo( iPo, 1, 1 ),  0 );
+
+  #ifdef XB_HSH_SUPPORT
+  // second child for the first parent, added in test twenty
+  iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2307)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2308)", pRel23->CheckRecNo( iPo, 1, 9 ),  0 );
+  #endif  // XB_HSH_SUPPORT
+
+  iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2309)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2310)", pRel23->CheckRecNo( iPo, 2, 2 ),  0 );
+
+  iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2311)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2312)", pRel23->CheckRecNo( iPo, 2, 3 ),  0 );
+
+  iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2313)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2314)", pRel23->CheckRecNo( iPo, 3, 4 ),  0 );
+
+  iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2315)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2316)", pRel23->CheckRecNo( iPo, 3, 5 ),  0 );
+
+  iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2317)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2318)", pRel23->CheckRecNo( iPo, 3, 6 ),  0 );
+  iRc += TestMethod( iPo, "GetField(2319)", dRel1DK->GetField( "PRIM_KS3", sFldVal ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetField(2320)", sFldVal, "303", 3 );
+
+  iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2321)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2322)", pRel23->CheckRecNo( iPo, 4, 7 ),  0 );
+
+  iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2323)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2324)", pRel23->CheckRecNo( iPo, 5, 8 ),  0 );
+
+  iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2325)", iRc2, XB_EOF );
+
+  iRc += TestMethod( iPo, "GetCacheStats(2326)", pRel23->GetCacheStats( dRel1DK, ullLookups, ullHits ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCacheStats(2327)", ullLookups, (xbUInt64) 5 );
+  iRc += TestMethod( iPo, "GetCacheStats(2328)", ullHits, (xbUInt64) 4 );
+
+  // backwards, the new query starts with an empty cache
+  iRc2 = pRel23->GetLastRelRecord();
+  iRc += TestMethod( iPo, "GetLastRelRecord(2329)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2330)", pRel23->CheckRecNo( iPo, 5, 8 ),  0 );
+
+  iRc2 = pRel23->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(2331)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2332)", pRel23->CheckRecNo( iPo, 4, 7 ),  0 );
+
+  iRc2 = pRel23->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(2333)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2334)", pRel23->CheckRecNo( iPo, 3, 6 ),  0 );
+
+  iRc2 = pRel23->GetPrevRelRecord();
+  iRc += TestMethod( iPo, "GetPrevRelRecord(2335)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2336)", pRel23->CheckRecNo( iPo, 3, 5 ),  0 );
+  iRc += TestMethod( iPo, "GetField(2337)", dRel1DK->GetField( "PRIM_KS3", sFldVal ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetField(2338)", sFldVal, "303", 3 );
+
+  // master records five, four and three missed on the backward query
+  iRc += TestMethod( iPo, "GetCacheStats(2339)", pRel23->GetCacheStats( dRel1DK, ullLookups, ullHits ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCacheStats(2340)", ullLookups, (xbUInt64) 8 );
+  iRc += TestMethod( iPo, "GetCacheStats(2341)", ullHits, (xbUInt64) 4 );
+
+  // two master records read ahead, masters one and four miss, the new cache size clears the cache
+  pRel23->ResetCacheStats();
+  iRc += TestMethod( iPo, "SetPrefetchWindow(2342)", pRel23->SetPrefetchWindow( 2 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "SetCacheSize(2343)", pRel23->SetCacheSize( 8 ), XB_NO_ERROR );
+
+  iRc2 = pRel23->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2344)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2345)", pRel23->CheckRecNo( iPo, 1, 1 ),  0 );
+  iRc2 = XB_NO_ERROR;
+  while( iRc2 == XB_NO_ERROR && dRel0->GetCurRecNo() < 4 )
+    iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2346)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2347)", pRel23->CheckRecNo( iPo, 4, 7 ),  0 );
+  iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2348)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2349)", pRel23->CheckRecNo( iPo, 5, 8 ),  0 );
+
+  iRc += TestMethod( iPo, "GetCacheStats(2350)", pRel23->GetCacheStats( dRel1DK, ullLookups, ullHits ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCacheStats(2351)", ullLookups, (xbUInt64) 5 );
+  iRc += TestMethod( iPo, "GetCacheStats(2352)", ullHits, (xbUInt64) 3 );
+
+  // prefetch off and a cleared cache, same results, no cache hits for distinct keys
+  pRel23->ResetCacheStats();
+  iRc += TestMethod( iPo, "SetPrefetchWindow(2353)", pRel23->SetPrefetchWindow( 0 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "SetCacheSize(2354)", pRel23->SetCacheSize( XB_REL_CACHE_SIZE ), XB_NO_ERROR );
+
+  iRc2 = pRel23->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2355)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2356)", pRel23->CheckRecNo( iPo, 1, 1 ),  0 );
+  iRc2 = XB_NO_ERROR;
+  while( iRc2 == XB_NO_ERROR && dRel0->GetCurRecNo() < 3 )
+    iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2357)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2358)", pRel23->CheckRecNo( iPo, 3, 4 ),  0 );
+  iRc2 = XB_NO_ERROR;
+  while( iRc2 == XB_NO_ERROR )
+    iRc2 = pRel23->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2359)", iRc2, XB_EOF );
+
+  iRc += TestMethod( iPo, "GetCacheStats(2360)", pRel23->GetCacheStats( dRel1DK, ullLookups, ullHits ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetCacheStats(2361)", ullLookups, (xbUInt64) 5 );
+  iRc += TestMethod( iPo, "GetCacheStats(2362)", ullHits, (xbUInt64) 0 );
+
+  delete pRel23;
+  pRel23 = NULL;
+
+// Test twenty four - child record changed through a second table object between two queries
+
+  xbRelate * pRel24;
+  pRel24 = new xbRelate( &x );
+  xbDbf * dRel1DK2 = new xbDbf4( &x );
+  iRc += TestMethod( iPo, "Open(2400)", dRel1DK2->Open( "RL1DK.DBF", "RL1DK2" ), XB_NO_ERROR );
+
+  iRc2 = pRel24->SetMaster( dRel0 );
+  iRc += TestMethod( iPo, "SetMaster(2401)", iRc2, 0 );
+  iRc += TestMethod( iPo, "SetJoinMode(2402)", pRel24->SetJoinMode( 'I' ), XB_NO_ERROR );
+  iRc2 = pRel24->AddRelation( dRel0, "FORGN_KS3", dRel1DK, "PRIM_KS3", 'O' );
+  iRc += TestMethod( iPo, "AddRelation(2403)", iRc2, XB_NO_ERROR );
+
+  // the first query caches the child records, with their images
+  iRc2 = pRel24->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2404)", iRc2, XB_NO_ERROR );
+  while( iRc2 == XB_NO_ERROR )
+    iRc2 = pRel24->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2405)", iRc2, XB_EOF );
+
+  // delete child record two through the second table object
+  iRc += TestMethod( iPo, "GetRecord(2406)", dRel1DK2->GetRecord( 2 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "DeleteRecord(2407)", dRel1DK2->DeleteRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(2408)", dRel1DK2->Commit(), XB_NO_ERROR );
+
+  // the second query reads child record two again and sees the delete
+  iRc2 = pRel24->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2409)", iRc2, XB_NO_ERROR );
+  while( iRc2 == XB_NO_ERROR && dRel0->GetCurRecNo() < 2 )
+    iRc2 = pRel24->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2410)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2411)", pRel24->CheckRecNo( iPo, 2, 2 ),  0 );
+  iRc += TestMethod( iPo, "RecordDeleted(2412)", dRel1DK->RecordDeleted(), xbTrue );
+
+  iRc += TestMethod( iPo, "GetRecord(2413)", dRel1DK2->GetRecord( 2 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "UndeleteRecord(2414)", dRel1DK2->UndeleteRecord(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(2415)", dRel1DK2->Commit(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Close(2416)", dRel1DK2->Close(), XB_NO_ERROR );
+
+  delete pRel24;
+  pRel24 = NULL;
+  delete dRel1DK2;
+
+// Test twenty five - hash join built again for each query, auto mode with a filtered master
+
+  #ifdef XB_HSH_SUPPORT
+  xbRelate * pRel25;
+  pRel25 = new xbRelate( &x );
+  xbDbf * dRel1Mfml2 = new xbDbf4( &x );
+  iRc += TestMethod( iPo, "Open(2500)", dRel1Mfml2->Open( "RL1MFML.DBF", "RL1MFML2" ), XB_NO_ERROR );
+
+  iRc2 = pRel25->SetMaster( dRel0 );
+  iRc += TestMethod( iPo, "SetMaster(2501)", iRc2, 0 );
+  iRc2 = pRel25->AddRelation( dRel0, "FORGN_KS1", dRel1Mfml, dRel1Mfml->GetCurIx(), dRel1Mfml->GetCurTag(), 'O' );
+  iRc += TestMethod( iPo, "AddRelation(2502)", iRc2, XB_NO_ERROR );
+
+  // two child records for five master records, auto mode uses the hash
+  iRc2 = pRel25->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2503)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2504)", pRel25->CheckRecNo( iPo, 1, 0 ),  0 );
+  iRc += TestMethod( iPo, "GetJoinType(2505)", pRel25->GetJoinType( dRel1Mfml ), 'H' );
+
+  // change the key of child record one from 102 to 103 through the second table object
+  iRc += TestMethod( iPo, "GetRecord(2506)", dRel1Mfml2->GetRecord( 1 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutField(2507)", dRel1Mfml2->PutField( "PRIM_KS1", "103" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(2508)", dRel1Mfml2->Commit(), XB_NO_ERROR );
+
+  // the next query builds the hash again and sees the new key
+  iRc2 = pRel25->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2509)", iRc2, XB_NO_ERROR );
+  iRc2 = pRel25->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2510)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2511)", pRel25->CheckRecNo( iPo, 2, 0 ),  0 );
+  iRc2 = pRel25->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2512)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2513)", pRel25->CheckRecNo( iPo, 3, 1 ),  0 );
+
+  iRc += TestMethod( iPo, "GetRecord(2514)", dRel1Mfml2->GetRecord( 1 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "PutField(2515)", dRel1Mfml2->PutField( "PRIM_KS1", "102" ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Commit(2516)", dRel1Mfml2->Commit(), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Close(2517)", dRel1Mfml2->Close(), XB_NO_ERROR );
+  delete dRel1Mfml2;
+  delete pRel25;
+
+  // the master filter selects one record, fewer than the child table has, auto mode uses the index
+  pRel25 = new xbRelate( &x );
+  iRc2 = pRel25->SetMaster( dRel0, "PRIM_KS0 = 2" );
+  iRc += TestMethod( iPo, "SetMaster(2518)", iRc2, 0 );
+  iRc2 = pRel25->AddRelation( dRel0, "FORGN_KS1", dRel1Mfml, dRel1Mfml->GetCurIx(), dRel1Mfml->GetCurTag(), 'O' );
+  iRc += TestMethod( iPo, "AddRelation(2519)", iRc2, XB_NO_ERROR );
+  iRc2 = pRel25->GetFirstRelRecord();
+  iRc += TestMethod( iPo, "GetFirstRelRecord(2520)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckRecNo(2521)", pRel25->CheckRecNo( iPo, 2, 1 ),  0 );
+  iRc += TestMethod( iPo, "GetJoinType(2522)", pRel25->GetJoinType( dRel1Mfml ), 'I' );
+  iRc2 = pRel25->GetNextRelRecord();
+  iRc += TestMethod( iPo, "GetNextRelRecord(2523)", iRc2, XB_EOF );
+
+  delete pRel25;
+  pRel25 = NULL;
+  #endif  // XB_HSH_SUPPORT
+
 
 
 // misc stuff that might be useful
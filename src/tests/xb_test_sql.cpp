@@ -261,6 +261,228 @@ int main( int argCnt, char **av )
 //  iRc2 = sql.ExecuteNonQuery( sSql );
 
 
+  // select tests
+  sSql = "DROP TABLE IF EXISTS States.DBF";
+  iRc += TestMethod( po, "DropTable(150)", sql.ExecuteNonQuery( sSql ), XB_NO_ERROR );
+
+  sSql = "CREATE TABLE States.DBF ( STATE CHAR(2), NAME CHAR(20) )";
+  iRc += TestMethod( po, "CreateTable(151)", sql.ExecuteNonQuery( sSql ), XB_NO_ERROR );
+
+  sSql = "INSERT INTO States.DBF ( STATE, NAME ) VALUES ( 'OH', 'Ohio' )";
+  iRc += TestMethod( po, "SqlInsert(152)", sql.ExecuteNonQuery( sSql ), XB_NO_ERROR );
+  sSql = "INSERT INTO States.DBF ( STATE, NAME ) VALUES ( 'TX', 'Texas' )";
+  iRc += TestMethod( po, "SqlInsert(153)", sql.ExecuteNonQuery( sSql ), XB_NO_ERROR );
+  sSql = "INSERT INTO States.DBF ( STATE, NAME ) VALUES ( 'WV', 'West Virginia' )";
+  iRc += TestMethod( po, "SqlInsert(154)", sql.ExecuteNonQuery( sSql ), XB_NO_ERROR );
+
+  #ifdef XB_MDX_SUPPORT
+  // joins to States use the tag, joins to ZipCode are done with a hash join
+  sSql = "CREATE INDEX StateTag ON States.DBF( STATE )";
+  iRc += TestMethod( po, "SqlCreateIndex(155)", sql.ExecuteNonQuery( sSql ), XB_NO_ERROR );
+  #endif // XB_MDX_SUPPORT
+
+  xbStmt   stmt( &x );
+  xbString sVal;
+  xbInt16  iRowCnt;
+
+  sSql = "SELECT CITY, STATE FROM ZipCode WHERE STATE = 'OH'";
+  iRc += TestMethod( po, "Select(160)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  iRc += TestMethod( po, "Select(161)", (xbInt32) stmt.GetColCount(), 2 );
+  stmt.GetColName( 1, sVal );
+  iRc += TestMethod( po, "Select(162)", sVal, "STATE", 5 );
+  iRc += TestMethod( po, "Select(163)", stmt.FetchFirst(), XB_NO_ERROR );
+  stmt.GetField( "CITY", sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "Select(164)", sVal, "Medina", 6 );
+  iRc += TestMethod( po, "Select(165)", stmt.FetchNext(), XB_NO_ERROR );
+  stmt.GetField( 0, sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "Select(166)", sVal, "Salem", 5 );
+  iRc += TestMethod( po, "Select(167)", stmt.FetchNext(), XB_EOF );
+  iRc += TestMethod( po, "Select(168)", stmt.FetchNext(), XB_EOF );
+  iRc += TestMethod( po, "Select(169)", stmt.FetchLast(), XB_NO_ERROR );
+  iRc += TestMethod( po, "Select(170)", stmt.FetchPrev(), XB_NO_ERROR );
+  stmt.GetField( 0, sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "Select(171)", sVal, "Medina", 6 );
+  iRc += TestMethod( po, "Select(172)", stmt.FetchPrev(), XB_BOF );
+
+  sSql = "SELECT ZIPCODE + 1 AS NEXTZIP, UPPER( z.CITY ) FROM ZipCode z WHERE z.CITY = 'Hugo'";
+  iRc += TestMethod( po, "Select(173)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  iRc += TestMethod( po, "Select(174)", stmt.FetchFirst(), XB_NO_ERROR );
+  stmt.GetField( "NEXTZIP", sVal );
+  iRc += TestMethod( po, "Select(175)", sVal, "74744", 5 );
+  stmt.GetField( 1, sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "Select(176)", sVal, "HUGO", 4 );
+  iRc += TestMethod( po, "Select(177)", stmt.FetchNext(), XB_EOF );
+
+  // the OK and SC zip codes have no matching state
+  sSql = "SELECT z.CITY, s.NAME FROM ZipCode z LEFT JOIN States s ON z.STATE = s.STATE";
+  iRc += TestMethod( po, "Select(178)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  iRowCnt = 0;
+  xbInt16 iBlankCnt = 0;
+  for( xbInt16 iRc3 = stmt.FetchFirst(); iRc3 == XB_NO_ERROR; iRc3 = stmt.FetchNext()){
+    iRowCnt++;
+    stmt.GetField( "NAME", sVal );
+    sVal.Trim();
+    if( sVal.Len() == 0 )
+      iBlankCnt++;
+  }
+  iRc += TestMethod( po, "Select(179)", (xbInt32) iRowCnt, 7 );
+  iRc += TestMethod( po, "Select(180)", (xbInt32) iBlankCnt, 2 );
+
+  sSql = "SELECT z.CITY, s.NAME FROM ZipCode z INNER JOIN States s ON z.STATE = s.STATE";
+  iRc += TestMethod( po, "Select(181)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  iRowCnt = 0;
+  for( xbInt16 iRc3 = stmt.FetchFirst(); iRc3 == XB_NO_ERROR; iRc3 = stmt.FetchNext())
+    iRowCnt++;
+  iRc += TestMethod( po, "Select(182)", (xbInt32) iRowCnt, 5 );
+
+  // where clause on the joined table is checked per row
+  sSql = "SELECT * FROM ZipCode z LEFT JOIN States s ON z.STATE = s.STATE WHERE s.NAME = 'Texas'";
+  iRc += TestMethod( po, "Select(183)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  iRc += TestMethod( po, "Select(184)", (xbInt32) stmt.GetColCount(), 5 );
+  iRowCnt = 0;
+  for( xbInt16 iRc3 = stmt.FetchFirst(); iRc3 == XB_NO_ERROR; iRc3 = stmt.FetchNext())
+    iRowCnt++;
+  iRc += TestMethod( po, "Select(185)", (xbInt32) iRowCnt, 2 );
+
+  sSql = "SELECT s.NAME, z.CITY FROM States s INNER JOIN ZipCode z ON s.STATE = z.STATE";
+  iRc += TestMethod( po, "Select(186)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  iRowCnt = 0;
+  for( xbInt16 iRc3 = stmt.FetchFirst(); iRc3 == XB_NO_ERROR; iRc3 = stmt.FetchNext())
+    iRowCnt++;
+  #ifdef XB_HSH_SUPPORT
+  iRc += TestMethod( po, "Select(187)", (xbInt32) iRowCnt, 5 );
+  #endif // XB_HSH_SUPPORT
+
+  // access paths chosen by the planner
+  sSql = "EXPLAIN SELECT z.CITY, s.NAME FROM ZipCode z INNER JOIN States s ON z.STATE = s.STATE";
+  iRc += TestMethod( po, "Explain(190)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  iRc += TestMethod( po, "Explain(191)", stmt.FetchFirst(), XB_NOT_OPEN );
+  stmt.GetPlan( sVal );
+  #ifdef XB_HSH_SUPPORT
+  iRc += TestMethod( po, "Explain(192)", (xbInt32) ( sVal.Pos( "HASH JOIN" ) > 0 ), 1 );
+  #endif // XB_HSH_SUPPORT
+
+  #ifdef XB_MDX_SUPPORT
+  // one parent row is cheaper to look up in the child tag than to hash the child table
+  sSql = "SELECT z.CITY, s.NAME FROM ZipCode z INNER JOIN States s ON z.STATE = s.STATE WHERE z.CITY = 'Medina'";
+  iRc += TestMethod( po, "Explain(193)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  stmt.GetPlan( sVal );
+  iRc += TestMethod( po, "Explain(194)", (xbInt32) ( sVal.Pos( "INDEX NESTED LOOP" ) > 0 ), 1 );
+  iRc += TestMethod( po, "Explain(195)", stmt.FetchFirst(), XB_NO_ERROR );
+  stmt.GetField( "NAME", sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "Explain(196)", sVal, "Ohio", 4 );
+  iRc += TestMethod( po, "Explain(197)", stmt.FetchNext(), XB_EOF );
+
+  sSql = "CREATE INDEX ZipTag ON ZipCode.DBF( ZIPCODE )";
+  iRc += TestMethod( po, "Explain(198)", sql.ExecuteNonQuery( sSql ), XB_NO_ERROR );
+
+  sSql = "SELECT CITY FROM ZipCode WHERE ZIPCODE = 44256";
+  iRc += TestMethod( po, "Explain(199)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  stmt.GetPlan( sVal );
+  iRc += TestMethod( po, "Explain(200)", (xbInt32) ( sVal.Pos( "INDEX RANGE SCAN" ) > 0 ), 1 );
+  iRc += TestMethod( po, "Explain(201)", stmt.FetchFirst(), XB_NO_ERROR );
+  stmt.GetField( 0, sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "Explain(202)", sVal, "Medina", 6 );
+  iRc += TestMethod( po, "Explain(203)", stmt.FetchNext(), XB_EOF );
+
+  // most of the table is cheaper to read in order
+  sSql = "SELECT CITY FROM ZipCode WHERE ZIPCODE > 10000";
+  iRc += TestMethod( po, "Explain(204)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  stmt.GetPlan( sVal );
+  iRc += TestMethod( po, "Explain(205)", (xbInt32) ( sVal.Pos( "FULL SCAN" ) > 0 ), 1 );
+  iRowCnt = 0;
+  for( xbInt16 iRc3 = stmt.FetchFirst(); iRc3 == XB_NO_ERROR; iRc3 = stmt.FetchNext())
+    iRowCnt++;
+  iRc += TestMethod( po, "Explain(206)", (xbInt32) iRowCnt, 7 );
+  #endif // XB_MDX_SUPPORT
+
+  sSql = "SELECT CITY FROM ZipCode GROUP BY CITY";
+  iRc += TestMethod( po, "Select(188)", stmt.ExecuteQuery( sSql ), XB_INVALID_OPTION );
+
+  sSql = "SELECT NOFIELD FROM ZipCode";
+  iRc += TestMethod( po, "Select(189)", stmt.ExecuteQuery( sSql ), XB_INVALID_FIELD_NAME );
+
+  #ifdef XB_SORT_SUPPORT
+  // sorted rows
+  sSql = "SELECT CITY, STATE FROM ZipCode ORDER BY STATE DESC, CITY";
+  iRc += TestMethod( po, "OrderBy(210)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  iRc += TestMethod( po, "OrderBy(211)", stmt.FetchFirst(), XB_NO_ERROR );
+  stmt.GetField( "CITY", sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "OrderBy(212)", sVal, "Fairmont", 8 );
+  iRc += TestMethod( po, "OrderBy(213)", stmt.FetchLast(), XB_NO_ERROR );
+  stmt.GetField( "CITY", sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "OrderBy(214)", sVal, "Salem", 5 );
+  iRc += TestMethod( po, "OrderBy(215)", stmt.FetchPrev(), XB_NO_ERROR );
+  stmt.GetField( "CITY", sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "OrderBy(216)", sVal, "Medina", 6 );
+  iRowCnt = 0;
+  for( xbInt16 iRc3 = stmt.FetchFirst(); iRc3 == XB_NO_ERROR; iRc3 = stmt.FetchNext())
+    iRowCnt++;
+  iRc += TestMethod( po, "OrderBy(217)", (xbInt32) iRowCnt, 7 );
+
+  // sort on a column not in the select list
+  sSql = "SELECT CITY FROM ZipCode WHERE STATE <> 'TX' ORDER BY ZIPCODE";
+  iRc += TestMethod( po, "OrderBy(218)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  iRc += TestMethod( po, "OrderBy(219)", stmt.FetchFirst(), XB_NO_ERROR );
+  stmt.GetField( 0, sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "OrderBy(220)", sVal, "Fairmont", 8 );
+  iRc += TestMethod( po, "OrderBy(221)", stmt.FetchNext(), XB_NO_ERROR );
+  stmt.GetField( 0, sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "OrderBy(222)", sVal, "Lexington", 9 );
+
+  // outer join rows without a match sort first, on a blank name
+  sSql = "SELECT z.CITY, s.NAME AS STNAME FROM ZipCode z LEFT JOIN States s ON z.STATE = s.STATE ORDER BY STNAME DESC, 1";
+  iRc += TestMethod( po, "OrderBy(223)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  iRc += TestMethod( po, "OrderBy(224)", stmt.FetchFirst(), XB_NO_ERROR );
+  stmt.GetField( "STNAME", sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "OrderBy(225)", sVal, "West Virginia", 13 );
+  iRc += TestMethod( po, "OrderBy(226)", stmt.FetchLast(), XB_NO_ERROR );
+  stmt.GetField( "CITY", sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "OrderBy(227)", sVal, "Lexington", 9 );
+  stmt.GetField( "STNAME", sVal );
+  sVal.Trim();
+  iRc += TestMethod( po, "OrderBy(228)", (xbInt32) sVal.Len(), 0 );
+
+  sSql = "SELECT DISTINCT STATE FROM ZipCode ORDER BY 1";
+  iRc += TestMethod( po, "Distinct(230)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  iRowCnt = 0;
+  for( xbInt16 iRc3 = stmt.FetchFirst(); iRc3 == XB_NO_ERROR; iRc3 = stmt.FetchNext())
+    iRowCnt++;
+  iRc += TestMethod( po, "Distinct(231)", (xbInt32) iRowCnt, 5 );
+  iRc += TestMethod( po, "Distinct(232)", stmt.FetchLast(), XB_NO_ERROR );
+  stmt.GetField( 0, sVal );
+  iRc += TestMethod( po, "Distinct(233)", sVal, "WV", 2 );
+  iRc += TestMethod( po, "Distinct(234)", stmt.FetchPrev(), XB_NO_ERROR );
+  stmt.GetField( 0, sVal );
+  iRc += TestMethod( po, "Distinct(235)", sVal, "TX", 2 );
+
+  sSql = "SELECT DISTINCT CITY, STATE FROM ZipCode";
+  iRc += TestMethod( po, "Distinct(236)", stmt.ExecuteQuery( sSql ), XB_NO_ERROR );
+  iRowCnt = 0;
+  for( xbInt16 iRc3 = stmt.FetchFirst(); iRc3 == XB_NO_ERROR; iRc3 = stmt.FetchNext())
+    iRowCnt++;
+  iRc += TestMethod( po, "Distinct(237)", (xbInt32) iRowCnt, 6 );
+
+  // with DISTINCT, the sort items must be in the select list
+  sSql = "SELECT DISTINCT STATE FROM ZipCode ORDER BY CITY";
+  iRc += TestMethod( po, "Distinct(238)", stmt.ExecuteQuery( sSql ), XB_INVALID_OPTION );
+  sSql = "SELECT CITY FROM ZipCode ORDER BY 3";
+  iRc += TestMethod( po, "OrderBy(239)", stmt.ExecuteQuery( sSql ), XB_INVALID_FIELD_NO );
+  #endif // XB_SORT_SUPPORT
+
   x.DisplayTableList();
 
 
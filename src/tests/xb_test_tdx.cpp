@@ -144,8 +144,85 @@ int main( int argCnt, char **av )
 
   iRc += TestMethod( iPo, "CheckTagIntegrity(1)", V4DbfX1->CheckTagIntegrity( 1, 2 ), XB_NO_ERROR );
 
+  // small index, should not have been written to disk
+  iRc += TestMethod( iPo, "GetMemoryResident(1)", pIx->GetMemoryResident(), xbTrue );
+  sFqFileName = pIx->GetFqFileName();
+  iRc += TestMethod( iPo, "FileExists(2)", pIx->FileExists( sFqFileName ), xbFalse );
+
+  // repeated lookups on the memory resident index, the node chain is kept between finds
+  iRc += TestMethod( iPo, "Find(2)", V4DbfX1->Find( pIx, pTag, (xbDouble) 10005 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Find(3)", V4DbfX1->Find( pIx, pTag, (xbDouble) 10017 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "Find(4)", V4DbfX1->Find( pIx, pTag, (xbDouble) 10011 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetMemoryResident(4)", pIx->GetMemoryResident(), xbTrue );
+
+  x.CloseAllTables();
+
+  // force the temp index past the memory limit so it spills to disk
+  x.SetTdxMemoryLimit( 4096 );
+  xbDbf *V4DbfX2 = new xbDbf4( &x );
+  iRc2 = V4DbfX2->CreateTable( "TTDXDB02.DBF", "TestTdxSpill", MyV4Record, XB_OVERLAY, XB_MULTI_USER );
+  iRc += TestMethod( iPo, "CreateTable(2)", iRc2, 0 );
+
+  iRc2 = V4DbfX2->CreateTag( "TDX", "CITY_TAGB", "CITY", "", 0, 0, XB_OVERLAY, &pIx, &pTag );
+  iRc += TestMethod( iPo, "CreateTag(3)", iRc2, 0 );
+  iRc += TestMethod( iPo, "GetMemoryResident(2)", pIx->GetMemoryResident(), xbTrue );
+
+  for( xbInt32 l = 0; l < 200 && iRc2 == XB_NO_ERROR; l++ ){
+    s.Sprintf( "CITY%05d", (l * 37) % 200 );
+    V4DbfX2->BlankRecord();
+    V4DbfX2->PutField( "CITY", s );
+    V4DbfX2->PutLongField( "ZIP", l );
+    if(( iRc2 = V4DbfX2->AppendRecord()) == XB_NO_ERROR )
+      iRc2 = V4DbfX2->Commit();
+  }
+  iRc += TestMethod( iPo, "AppendRecord(2)", iRc2, XB_NO_ERROR );
+  iRc += TestMethod( iPo, "GetMemoryResident(3)", pIx->GetMemoryResident(), xbFalse );
+  iRc += TestMethod( iPo, "CheckTagIntegrity(2)", V4DbfX2->CheckTagIntegrity( 1, 2 ), XB_NO_ERROR );
+
+  iRc2 = V4DbfX2->Find( pIx, pTag, xbString( "CITY00123" ));
+  iRc += TestMethod( iPo, "Find(1)", iRc2, XB_NO_ERROR );
+
+  sFqFileName = pIx->GetFqFileName();
+  x.CloseAllTables();
+  iRc += TestMethod( iPo, "FileExists(3)", f.FileExists( sFqFileName ), xbFalse );
+  x.SetTdxMemoryLimit( 16777216 );
+
+  #ifdef XB_SORT_SUPPORT
+  // reindexed temp tags are sorted and built bottom up, a small sort memory limit forces the sort to spill
+  x.SetSortMemoryLimit( 4096 );
+  xbDbf *V4DbfX3 = new xbDbf4( &x );
+  iRc2 = V4DbfX3->CreateTable( "TTDXDB03.DBF", "TestTdxSort", MyV4Record, XB_OVERLAY, XB_MULTI_USER );
+  iRc += TestMethod( iPo, "CreateTable(3)", iRc2, 0 );
+
+  for( xbInt32 l = 0; l < 3000 && iRc2 == XB_NO_ERROR; l++ ){
+    s.Sprintf( "CITY%05d", (l * 7919) % 1000 );
+    V4DbfX3->BlankRecord();
+    V4DbfX3->PutField( "CITY", s );
+    V4DbfX3->PutLongField( "ZIP", (l * 31) % 2000 );
+    if(( iRc2 = V4DbfX3->AppendRecord()) == XB_NO_ERROR )
+      iRc2 = V4DbfX3->Commit();
+  }
+  iRc += TestMethod( iPo, "AppendRecord(3)", iRc2, XB_NO_ERROR );
+
+  iRc2 = V4DbfX3->CreateTag( "TDX", "CITY_TAGC", "CITY", "", 0, 0, XB_OVERLAY, &pIx, &pTag );
+  iRc += TestMethod( iPo, "CreateTag(4)", iRc2, 0 );
+  iRc2 = V4DbfX3->CreateTag( "TDX", "ZIP_TAGC", "ZIP", "", xbTrue, 0, XB_OVERLAY, &pIx, &pTag );
+  iRc += TestMethod( iPo, "CreateTag(5)", iRc2, 0 );
+  iRc += TestMethod( iPo, "Reindex(1)", V4DbfX3->Reindex( 1 ), XB_NO_ERROR );
+  iRc += TestMethod( iPo, "CheckTagIntegrity(3)", V4DbfX3->CheckTagIntegrity( 1, 2 ), XB_NO_ERROR );
+
+  xbUInt32 ulKeyCnt = 0;
+  for( iRc2 = pIx->GetFirstKey( pTag, 0 ); iRc2 == XB_NO_ERROR; iRc2 = pIx->GetNextKey( pTag, 0 ))
+    ulKeyCnt++;
+  iRc += TestMethod( iPo, "GetNextKey(1)", (xbInt32) ulKeyCnt, 3000 );
+
+  sKey = "CITY_TAGC";
+  iRc2 = V4DbfX3->Find( pIx, pIx->GetTag( sKey ), xbString( "CITY00500" ));
+  iRc += TestMethod( iPo, "Find(2)", iRc2, XB_NO_ERROR );
 
   x.CloseAllTables();
+  x.SetSortMemoryLimit( 16777216 );
+  #endif  // XB_SORT_SUPPORT
 
 //  delete V4DbfX1;
 //  delete V4DbfX2;
@@ -218,6 +218,12 @@ int main( int argc, char *argv [] )
     fprintf( stdout, "XB_TDX_SUPPORT          = [OFF]\n" );
   #endif
 
+  #ifdef XB_HSH_SUPPORT
+    fprintf( stdout, "XB_HSH_SUPPORT          = [ON]\n" );
+  #else
+    fprintf( stdout, "XB_HSH_SUPPORT          = [OFF]\n" );
+  #endif
+
   #ifdef XB_UTILS_SUPPORT
     fprintf( stdout, "XB_UTILS_SUPPORT        = [ON]\n" );
   #else